@@ -66,6 +66,17 @@ function(vx_check_available_features TARGET_NAME)
         vx_check_symbol_exists(${TARGET_NAME} "posix_spawn_file_actions_addchdir"     "spawn.h"         PRIVATE HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR)
         vx_check_symbol_exists(${TARGET_NAME} "posix_spawn_file_actions_addchdir_np"  "spawn.h"         PRIVATE HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCHDIR_NP)
 
+        # fast file copies, the first two are gnu extensions
+        set(CMAKE_REQUIRED_DEFINITIONS -D_GNU_SOURCE)
+        vx_check_symbol_exists(${TARGET_NAME} "copy_file_range"                       "unistd.h"                    PRIVATE HAVE_COPY_FILE_RANGE)
+        vx_check_symbol_exists(${TARGET_NAME} "fallocate"                             "fcntl.h"                     PRIVATE HAVE_FALLOCATE)
+        unset(CMAKE_REQUIRED_DEFINITIONS)
+        vx_check_symbol_exists(${TARGET_NAME} "sendfile"                              "sys/sendfile.h"              PRIVATE HAVE_SENDFILE)
+
+        # memory mapping
+        vx_check_symbol_exists(${TARGET_NAME} "mmap"                                  "sys/mman.h"                  PRIVATE HAVE_MMAP)
+        vx_check_symbol_exists(${TARGET_NAME} "madvise"                               "sys/mman.h"                  PRIVATE HAVE_MADVISE)
+
         # other
         vx_check_symbol_exists(${TARGET_NAME} "getrandom"                             "sys/random.h"                PRIVATE HAVE_GETRANDOM)
         vx_check_symbol_exists(${TARGET_NAME} "sysctl"                                "sys/types.h;sys/sysctl.h"    PRIVATE HAVE_SYSCTL)
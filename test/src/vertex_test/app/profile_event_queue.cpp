@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/os/time.hpp"
+#include "vertex/app/app.hpp"
+#include "vertex/app/event/event.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// Multi producer stress benchmark for the app event queue. Several threads
+// push events as fast as they can while the main thread polls, which is the
+// pattern of raw mouse, pen, and touch input pushed from worker threads.
+//
+// stream polls while the producers push. Once the producers outrun the poller
+// the ring fills and events take the overflow path, and a full queue makes
+// push_event fail until the poller catches up, so the producers retry. burst
+// pushes every event before polling starts, so nearly all of them go through
+// the overflow path, and times only the drain.
+//
+// push_event stamps each event when it is first pushed, and the poller
+// measures how long every event waited in the queue. The p50 and p99 of
+// those latencies are recorded as results of their own.
+
+using namespace vx;
+
+static constexpr size_t RR = 5; // number of repetitions
+static constexpr size_t stream_per_producer = 100000;
+static constexpr size_t burst_total = 60000; // under the queue limit
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+static app::event::event_type_t s_event_type = app::event::invalid_event;
+
+// returns the given percentile of the latencies in nanoseconds, reorders them
+static int64_t percentile(std::vector<int64_t>& latencies, size_t pct)
+{
+    const size_t i = (latencies.size() - 1) * pct / 100;
+    std::nth_element(latencies.begin(), latencies.begin() + i, latencies.end());
+    return latencies[i];
+}
+
+//=========================================================================
+
+static void push_events(size_t producer, size_t count)
+{
+    app::event::event e;
+    e.type = s_event_type;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        // zero so push_event stamps it, the stamp is kept across retries
+        e.time = time::zero();
+        e.user_event.user_data = reinterpret_cast<void*>(producer);
+
+        while (!app::event::push_event(e))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static void poll_events(size_t total, std::vector<int64_t>& latencies)
+{
+    app::event::event e;
+    size_t polled = 0;
+
+    while (polled < total)
+    {
+        if (app::event::poll_event(&e) && e.type == s_event_type)
+        {
+            latencies.push_back((os::get_ticks() - e.time).as_nanoseconds());
+            ++polled;
+        }
+    }
+}
+
+static void record_latency(const std::string& name, const time::time_point& run_start, std::vector<int64_t>& latencies)
+{
+    profile::record({ name + " p50 latency", run_start, time::nanoseconds(percentile(latencies, 50)) });
+    profile::record({ name + " p99 latency", run_start, time::nanoseconds(percentile(latencies, 99)) });
+}
+
+//=========================================================================
+
+VX_NO_INLINE void profile_stream(const std::string& name, size_t producer_count)
+{
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> producers;
+
+    for (size_t p = 0; p < producer_count; ++p)
+    {
+        producers.emplace_back([&, p]()
+        {
+            while (!go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            push_events(p, stream_per_producer);
+        });
+    }
+
+    const size_t total = producer_count * stream_per_producer;
+    std::vector<int64_t> latencies;
+    latencies.reserve(total);
+
+    const time::time_point run_start = os::get_ticks();
+
+    start_timer(name);
+    go.store(true, std::memory_order_release);
+
+    poll_events(total, latencies);
+
+    os::do_not_optimize(latencies);
+    stop_timer();
+
+    for (auto& t : producers)
+    {
+        t.join();
+    }
+
+    record_latency(name, run_start, latencies);
+}
+
+VX_NO_INLINE void profile_burst(const std::string& name, size_t producer_count)
+{
+    const size_t per_producer = burst_total / producer_count;
+    const size_t total = producer_count * per_producer;
+
+    std::vector<std::thread> producers;
+
+    const time::time_point run_start = os::get_ticks();
+
+    for (size_t p = 0; p < producer_count; ++p)
+    {
+        producers.emplace_back([p, per_producer]()
+        {
+            push_events(p, per_producer);
+        });
+    }
+
+    for (auto& t : producers)
+    {
+        t.join();
+    }
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(total);
+
+    start_timer(name);
+    poll_events(total, latencies);
+    os::do_not_optimize(latencies);
+    stop_timer();
+
+    record_latency(name, run_start, latencies);
+}
+
+//=========================================================================
+
+static void run(size_t R)
+{
+    const size_t producer_counts[] = { 1, 2, 4, 8 };
+
+    for (const size_t producer_count : producer_counts)
+    {
+        const std::string suffix = " (" + std::to_string(producer_count) + " producers)";
+
+        for (size_t r = 0; r < R; ++r)
+        {
+            profile_stream("stream" + suffix, producer_count);
+            profile_burst("burst" + suffix, producer_count);
+        }
+    }
+}
+
+int main()
+{
+    if (!app::init_subsystem(app::init_flags::events))
+    {
+        return 1;
+    }
+
+    s_event_type = app::event::register_user_events(1);
+    if (s_event_type == app::event::invalid_event)
+    {
+        app::quit();
+        return 1;
+    }
+
+    // warmup
+    run(1);
+
+    VX_PROFILE_START_APPEND("profile_event_queue.csv");
+
+    run(RR);
+
+    VX_PROFILE_STOP();
+
+    app::quit();
+    return 0;
+}
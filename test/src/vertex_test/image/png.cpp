@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/image/load.hpp"
+#include "vertex/image/write.hpp"
+
+using namespace vx;
+using namespace vx::img;
+
+///////////////////////////////////////////////////////////////////////////////
+
+enum class content
+{
+    noise,
+    gradient,
+    flat,
+    photo
+};
+
+static image make_image(content c, size_t width, size_t height, pixel_format format)
+{
+    image img(width, height, format);
+    byte_type* data = img.data();
+    const size_t channels = img.channels();
+    uint32_t seed = 12345;
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            for (size_t i = 0; i < channels; ++i)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                int value = 0;
+
+                switch (c)
+                {
+                    case content::noise:    value = static_cast<int>(seed >> 24); break;
+                    case content::gradient: value = static_cast<int>(x * 255 / width + i * 40); break;
+                    case content::flat:     value = 77; break;
+                    case content::photo:    value = static_cast<int>(std::sin(x * 0.05 + i) * std::cos(y * 0.03) * 100.0 + 128.0) + static_cast<int>(seed >> 30); break;
+                }
+
+                data[(y * width + x) * channels + i] = static_cast<byte_type>(value);
+            }
+        }
+    }
+
+    return img;
+}
+
+static bool round_trip(const image& src, const png_write_options& options)
+{
+    std::vector<byte_type> png;
+    if (!write_png_to_memory(src, png, options))
+    {
+        return false;
+    }
+
+    image out;
+    if (!load_from_memory(span<const byte_type>(png.data(), png.size()), out))
+    {
+        return false;
+    }
+
+    return out.width() == src.width()
+        && out.height() == src.height()
+        && out.format() == src.format()
+        && std::memcmp(out.data(), src.data(), src.data_size()) == 0;
+}
+
+// Builds an 8 bit paletted png by hand, the encoder only writes direct color.
+// The image data is stored uncompressed.
+static std::vector<byte_type> make_palette_png(size_t width, size_t height, const byte_type (*palette)[3], size_t palette_size)
+{
+    const auto crc32 = [](const byte_type* data, size_t size, uint32_t crc)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            crc ^= data[i];
+            for (int k = 0; k < 8; ++k)
+            {
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+            }
+        }
+
+        return crc;
+    };
+
+    std::vector<byte_type> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    const auto put_u32 = [](std::vector<byte_type>& v, uint32_t x)
+    {
+        v.push_back(static_cast<byte_type>(x >> 24));
+        v.push_back(static_cast<byte_type>(x >> 16));
+        v.push_back(static_cast<byte_type>(x >> 8));
+        v.push_back(static_cast<byte_type>(x));
+    };
+
+    const auto put_chunk = [&](const char* type, const std::vector<byte_type>& body)
+    {
+        put_u32(out, static_cast<uint32_t>(body.size()));
+        const size_t start = out.size();
+        out.insert(out.end(), type, type + 4);
+        out.insert(out.end(), body.begin(), body.end());
+        put_u32(out, ~crc32(out.data() + start, out.size() - start, 0xFFFFFFFFu));
+    };
+
+    std::vector<byte_type> ihdr;
+    put_u32(ihdr, static_cast<uint32_t>(width));
+    put_u32(ihdr, static_cast<uint32_t>(height));
+    ihdr.insert(ihdr.end(), { 8, 3, 0, 0, 0 });
+    put_chunk("IHDR", ihdr);
+
+    std::vector<byte_type> plte;
+    for (size_t i = 0; i < palette_size; ++i)
+    {
+        plte.insert(plte.end(), palette[i], palette[i] + 3);
+    }
+    put_chunk("PLTE", plte);
+
+    // rows of filter type 0 followed by palette indices
+    std::vector<byte_type> raw;
+    for (size_t y = 0; y < height; ++y)
+    {
+        raw.push_back(0);
+        for (size_t x = 0; x < width; ++x)
+        {
+            raw.push_back(static_cast<byte_type>((x + y) % palette_size));
+        }
+    }
+
+    // zlib header, one stored block and the adler32 of the data
+    std::vector<byte_type> idat = { 0x78, 0x01, 0x01 };
+    const uint16_t len = static_cast<uint16_t>(raw.size());
+    idat.insert(idat.end(), { static_cast<byte_type>(len), static_cast<byte_type>(len >> 8), static_cast<byte_type>(~len), static_cast<byte_type>(~len >> 8) });
+    idat.insert(idat.end(), raw.begin(), raw.end());
+
+    uint32_t a = 1, b = 0;
+    for (const byte_type c : raw)
+    {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    put_u32(idat, (b << 16) | a);
+    put_chunk("IDAT", idat);
+
+    put_chunk("IEND", {});
+    return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_png_round_trip)
+{
+    const content contents[] = { content::noise, content::gradient, content::flat, content::photo };
+    // rg_8 files are loaded as rgb_8
+    const pixel_format formats[] = { pixel_format::r_8, pixel_format::rgb_8, pixel_format::rgba_8 };
+    const png_compression compressions[] = { png_compression::store, png_compression::fast, png_compression::normal, png_compression::max };
+    const png_filter filters[] = { png_filter::adaptive, png_filter::none, png_filter::sub, png_filter::up, png_filter::average, png_filter::paeth };
+
+    // the last size spans several compressed pieces
+    const math::vec2i sizes[] = { math::vec2i(1, 1), math::vec2i(3, 2), math::vec2i(37, 23), math::vec2i(400, 300) };
+
+    for (const content c : contents)
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            for (const pixel_format format : formats)
+            {
+                const image src = make_image(c, size.x, size.y, format);
+
+                for (const png_compression compression : compressions)
+                {
+                    for (const png_filter filter : filters)
+                    {
+                        png_write_options options;
+                        options.compression = compression;
+                        options.filter = filter;
+
+                        VX_CHECK(round_trip(src, options));
+                    }
+                }
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_png_parallel)
+{
+    os::thread_pool pool(3);
+    const image src = make_image(content::photo, 700, 500, pixel_format::rgba_8);
+
+    const png_compression compressions[] = { png_compression::fast, png_compression::normal };
+
+    for (const png_compression compression : compressions)
+    {
+        png_write_options options;
+        options.compression = compression;
+
+        std::vector<byte_type> sequential;
+        VX_CHECK(write_png_to_memory(src, sequential, options));
+
+        // the same bytes whatever the number of threads
+        options.policy = pixel::execution_policy::parallel(pool);
+        std::vector<byte_type> parallel;
+        VX_CHECK(write_png_to_memory(src, parallel, options));
+        VX_CHECK(parallel == sequential);
+
+        options.policy = pixel::execution_policy::parallel(pool, 2);
+        VX_CHECK(write_png_to_memory(src, parallel, options));
+        VX_CHECK(parallel == sequential);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_png_compression)
+{
+    const image src = make_image(content::gradient, 256, 256, pixel_format::rgb_8);
+    std::vector<byte_type> store, fast, normal, max;
+
+    png_write_options options;
+    options.compression = png_compression::store;
+    VX_CHECK(write_png_to_memory(src, store, options));
+    options.compression = png_compression::fast;
+    VX_CHECK(write_png_to_memory(src, fast, options));
+    options.compression = png_compression::normal;
+    VX_CHECK(write_png_to_memory(src, normal, options));
+    options.compression = png_compression::max;
+    VX_CHECK(write_png_to_memory(src, max, options));
+
+    VX_CHECK(store.size() > src.data_size());
+    VX_CHECK(fast.size() < store.size());
+    VX_CHECK(normal.size() < store.size());
+    VX_CHECK(max.size() <= normal.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_load_from_memory)
+{
+    const image src = make_image(content::photo, 61, 17, pixel_format::rgb_8);
+
+    std::vector<byte_type> png;
+    VX_CHECK(write_png_to_memory(src, png, png_write_options()));
+    const span<const byte_type> file(png.data(), png.size());
+
+    VX_SECTION("info")
+    {
+        image_info info{};
+        VX_CHECK(load_info_from_memory(file, info));
+        VX_CHECK(info.width == 61 && info.height == 17);
+        VX_CHECK(info.format == pixel_format::rgb_8);
+        VX_CHECK(info.data_size() == src.data_size());
+    }
+
+    VX_SECTION("caller storage")
+    {
+        image_info info{};
+        std::vector<byte_type> pixels(src.data_size());
+
+        VX_CHECK(load_from_memory(file, span<byte_type>(pixels.data(), pixels.size()), info));
+        VX_CHECK(std::memcmp(pixels.data(), src.data(), pixels.size()) == 0);
+
+        VX_CHECK_AND_EXPECT_ERROR(!load_from_memory(file, span<byte_type>(pixels.data(), pixels.size() - 1), info));
+    }
+
+    VX_SECTION("larger caller storage")
+    {
+        // only the start is written, whatever the decoder allocates on the way
+        image_info info{};
+        std::vector<byte_type> pixels(src.data_size() * 3, 0xAB);
+
+        VX_CHECK(load_from_memory(file, span<byte_type>(pixels.data(), pixels.size()), info));
+        VX_CHECK(info.data_size() == src.data_size());
+        VX_CHECK(std::memcmp(pixels.data(), src.data(), src.data_size()) == 0);
+        VX_CHECK(std::all_of(pixels.begin() + src.data_size(), pixels.end(), [](byte_type b) { return b == 0xAB; }));
+    }
+
+    VX_SECTION("palette")
+    {
+        // expanded from one index per pixel to rgb through an extra buffer
+        const byte_type palette[3][3] = { { 255, 0, 0 }, { 0, 255, 0 }, { 10, 20, 30 } };
+        const std::vector<byte_type> indexed = make_palette_png(13, 7, palette, 3);
+        const span<const byte_type> indexed_file(indexed.data(), indexed.size());
+
+        image_info info{};
+        VX_CHECK(load_info_from_memory(indexed_file, info));
+        VX_CHECK(info.width == 13 && info.height == 7);
+        VX_CHECK(info.format == pixel_format::rgb_8);
+
+        image expected;
+        VX_CHECK(load_from_memory(indexed_file, expected));
+        VX_CHECK(std::memcmp(expected.data(), palette[0], 3) == 0);
+        VX_CHECK(std::memcmp(expected.data() + (6 * 13 + 12) * 3, palette[(12 + 6) % 3], 3) == 0);
+
+        const size_t sizes[] = { info.data_size(), info.data_size() + 1, info.data_size() * 2, 4096 };
+        for (const size_t size : sizes)
+        {
+            std::vector<byte_type> pixels(size, 0xAB);
+            VX_CHECK(load_from_memory(indexed_file, span<byte_type>(pixels.data(), pixels.size()), info));
+            VX_CHECK(std::memcmp(pixels.data(), expected.data(), expected.data_size()) == 0);
+            VX_CHECK(std::all_of(pixels.begin() + expected.data_size(), pixels.end(), [](byte_type b) { return b == 0xAB; }));
+        }
+
+        std::vector<byte_type> small(info.data_size() - 1);
+        VX_CHECK_AND_EXPECT_ERROR(!load_from_memory(indexed_file, span<byte_type>(small.data(), small.size()), info));
+    }
+
+    VX_SECTION("bad data")
+    {
+        image out;
+        const byte_type junk[16] = {};
+        VX_CHECK_AND_EXPECT_ERROR(!load_from_memory(span<const byte_type>(junk, sizeof(junk)), out));
+        VX_CHECK(out.empty());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
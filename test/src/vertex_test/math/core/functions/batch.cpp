@@ -0,0 +1,300 @@
+#include <vector>
+
+#include "vertex_test/test.hpp"
+
+#include "vertex/math/core/functions/batch.hpp"
+
+using namespace vx::math;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// odd counts so both the kernels and the scalar tail are used
+static const size_t counts[] = { 0, 1, 3, 8, 37 };
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static f32 random_float(uint32_t& seed)
+{
+    return static_cast<f32>(next_random(seed) % 20001) / 10000.0f - 1.0f;
+}
+
+static vec4f random_vec4(uint32_t& seed)
+{
+    return vec4f(random_float(seed), random_float(seed), random_float(seed), random_float(seed));
+}
+
+static mat4f random_mat4(uint32_t& seed)
+{
+    return mat4f(random_vec4(seed), random_vec4(seed), random_vec4(seed), random_vec4(seed));
+}
+
+static quatf random_quat(uint32_t& seed)
+{
+    return normalize(quatf(random_float(seed), random_float(seed), random_float(seed), random_float(seed)));
+}
+
+// relative to the size of the values, since the kernels may fuse multiply-adds
+// where the scalar code does not
+static bool close(const f32* a, const f32* b, size_t n, f32 epsilon)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const f32 scale = max(1.0f, max(abs(a[i]), abs(b[i])));
+        if (!(abs(a[i] - b[i]) <= epsilon * scale))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+static bool close(const std::vector<T>& a, const std::vector<T>& b, f32 epsilon = 1e-6f)
+{
+    return a.size() == b.size() && close(reinterpret_cast<const f32*>(a.data()), reinterpret_cast<const f32*>(b.data()), a.size() * sizeof(T) / sizeof(f32), epsilon);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_transform)
+{
+    uint32_t seed = 1;
+    const mat4f m = random_mat4(seed);
+
+    for (const size_t count : counts)
+    {
+        std::vector<vec4f> v4(count);
+        std::vector<vec3f> v3(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            v4[i] = random_vec4(seed) * 10.0f;
+            v3[i] = vec3f(random_vec4(seed)) * 10.0f;
+        }
+
+        VX_SECTION("vec4")
+        {
+            std::vector<vec4f> expected(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                expected[i] = m * v4[i];
+            }
+
+            std::vector<vec4f> out(count);
+            batch::transform(m, v4.data(), out.data(), count);
+            VX_CHECK(close(out, expected));
+
+            std::vector<f32> x(count), y(count), z(count), w(count);
+            batch::transform(m, v4.data(), x.data(), y.data(), z.data(), w.data(), count);
+
+            bool same = true;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const f32 soa[4] = { x[i], y[i], z[i], w[i] };
+                same &= close(soa, &expected[i].x, 4, 1e-6f);
+            }
+            VX_CHECK(same);
+
+            // in place
+            batch::transform(m, v4.data(), v4.data(), count);
+            VX_CHECK(close(v4, expected));
+        }
+
+        VX_SECTION("points and directions")
+        {
+            std::vector<vec3f> points(count), directions(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                points[i] = vec3f(m * vec4f(v3[i], 1.0f));
+                directions[i] = vec3f(m * vec4f(v3[i], 0.0f));
+            }
+
+            std::vector<vec3f> out(count);
+            batch::transform_points(m, v3.data(), out.data(), count);
+            VX_CHECK(close(out, points));
+
+            batch::transform_directions(m, v3.data(), out.data(), count);
+            VX_CHECK(close(out, directions));
+
+            std::vector<f32> x(count), y(count), z(count);
+            batch::transform_points(m, v3.data(), x.data(), y.data(), z.data(), count);
+
+            bool same = true;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const f32 soa[3] = { x[i], y[i], z[i] };
+                same &= close(soa, &points[i].x, 3, 1e-6f);
+            }
+
+            batch::transform_directions(m, v3.data(), x.data(), y.data(), z.data(), count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const f32 soa[3] = { x[i], y[i], z[i] };
+                same &= close(soa, &directions[i].x, 3, 1e-6f);
+            }
+            VX_CHECK(same);
+
+            batch::transform_points(m, v3.data(), v3.data(), count);
+            VX_CHECK(close(v3, points));
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_mul)
+{
+    uint32_t seed = 2;
+    const mat4f parent = random_mat4(seed);
+
+    for (const size_t count : counts)
+    {
+        std::vector<mat4f> a(count), b(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            a[i] = random_mat4(seed);
+            b[i] = random_mat4(seed);
+        }
+
+        std::vector<mat4f> expected(count), out(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            expected[i] = a[i] * b[i];
+        }
+
+        batch::mul(a.data(), b.data(), out.data(), count);
+        VX_CHECK(close(out, expected));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            expected[i] = parent * b[i];
+        }
+
+        batch::mul(parent, b.data(), out.data(), count);
+        VX_CHECK(close(out, expected));
+
+        // in place, like updating a palette
+        batch::mul(parent, b.data(), b.data(), count);
+        VX_CHECK(close(b, expected));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_inverse)
+{
+    uint32_t seed = 3;
+
+    for (const size_t count : counts)
+    {
+        std::vector<mat4f> m(count), expected(count), out(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            m[i] = random_mat4(seed) + mat4f(2.0f);
+            expected[i] = inverse(m[i]);
+        }
+
+        batch::inverse(m.data(), out.data(), count);
+        VX_CHECK(close(out, expected, 1e-5f));
+
+        batch::inverse(m.data(), m.data(), count);
+        VX_CHECK(close(m, expected, 1e-5f));
+    }
+
+    VX_SECTION("singular")
+    {
+        std::vector<mat4f> m(5, mat4f(0.0f));
+        batch::inverse(m.data(), m.data(), m.size());
+
+        // the same non-finite values as the scalar inverse
+        const mat4f expected = inverse(mat4f(0.0f));
+        bool same = true;
+
+        for (const mat4f& i : m)
+        {
+            for (size_t c = 0; c < 16; ++c)
+            {
+                const f32 a = (&i.columns[0].x)[c];
+                const f32 b = (&expected.columns[0].x)[c];
+                same &= ((a == b) || (is_nan(a) && is_nan(b)));
+            }
+        }
+        VX_CHECK(same);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_rotation_cast)
+{
+    uint32_t seed = 4;
+
+    for (const size_t count : counts)
+    {
+        std::vector<quatf> q(count);
+        std::vector<mat4f> expected(count), out(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            q[i] = random_quat(seed);
+            expected[i] = rotation_cast<mat4f>(q[i]);
+        }
+
+        batch::rotation_cast(q.data(), out.data(), count);
+        VX_CHECK(close(out, expected));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_slerp)
+{
+    uint32_t seed = 5;
+
+    for (const size_t count : counts)
+    {
+        std::vector<quatf> x(count), y(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] = random_quat(seed);
+
+            // every branch of the scalar slerp: nearly equal, opposite, at
+            // right angles and anything else
+            switch (i % 4)
+            {
+                case 0: y[i] = x[i]; break;
+                case 1: y[i] = -x[i]; break;
+                case 2: y[i] = quatf(-x[i].x, x[i].w, -x[i].z, x[i].y); break;
+                default: y[i] = random_quat(seed); break;
+            }
+        }
+
+        for (const f32 t : { 0.0f, 0.25f, 0.5f, 1.0f })
+        {
+            std::vector<quatf> expected(count), out(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                expected[i] = slerp(x[i], y[i], t);
+            }
+
+            batch::slerp(x.data(), y.data(), t, out.data(), count);
+            VX_CHECK(close(out, expected));
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
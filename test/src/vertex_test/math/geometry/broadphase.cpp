@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <vector>
+
+#include "vertex_test/test.hpp"
+
+#include "vertex/math/geometry/2d/broadphase/aabb_tree.hpp"
+#include "vertex/math/geometry/2d/broadphase/spatial_hash.hpp"
+
+using namespace vx::math;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static f32 random_float(uint32_t& seed, f32 lo, f32 hi)
+{
+    return lo + (hi - lo) * static_cast<f32>(next_random(seed) % 100001) / 100000.0f;
+}
+
+static g2::rect random_rect(uint32_t& seed)
+{
+    return g2::rect(random_float(seed, -50.0f, 50.0f), random_float(seed, -50.0f, 50.0f), random_float(seed, 0.0f, 4.0f), random_float(seed, 0.0f, 4.0f));
+}
+
+using id_pair = std::pair<uint32_t, uint32_t>;
+using ray_type = g2::ray_t<f32>;
+
+// Checks a broadphase against testing every object, ids[i] is the id of
+// rects[i] or invalid_id when it was removed.
+template <typename Broadphase>
+static bool matches_brute_force(const Broadphase& bp, const std::vector<g2::rect>& rects, const std::vector<uint32_t>& ids, uint32_t& seed)
+{
+    bool same = true;
+
+    // pairs
+    {
+        std::vector<id_pair> expected, found;
+
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            for (size_t j = 0; j < rects.size(); ++j)
+            {
+                if (ids[i] != Broadphase::invalid_id && ids[j] != Broadphase::invalid_id && ids[i] < ids[j] && g2::overlaps(rects[i], rects[j]))
+                {
+                    expected.emplace_back(ids[i], ids[j]);
+                }
+            }
+        }
+
+        bp.query_pairs([&](uint32_t a, uint32_t b) { found.emplace_back(a, b); });
+
+        std::sort(expected.begin(), expected.end());
+        std::sort(found.begin(), found.end());
+        same &= (found == expected);
+    }
+
+    for (size_t q = 0; q < 50; ++q)
+    {
+        const g2::rect area(random_float(seed, -60.0f, 60.0f), random_float(seed, -60.0f, 60.0f), random_float(seed, 0.0f, 20.0f), random_float(seed, 0.0f, 20.0f));
+        const g2::point p(random_float(seed, -55.0f, 55.0f), random_float(seed, -55.0f, 55.0f));
+        const ray_type ray(p, normalize(vec2(random_float(seed, -1.0f, 1.0f), random_float(seed, -1.0f, 1.0f))));
+
+        std::vector<uint32_t> expected_area, expected_point, expected_ray, found;
+        f32 expected_closest = constants<f32>::infinity;
+
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            if (ids[i] == Broadphase::invalid_id)
+            {
+                continue;
+            }
+
+            f32 t;
+
+            if (g2::overlaps(area, rects[i])) expected_area.push_back(ids[i]);
+            if (g2::contains(rects[i], p)) expected_point.push_back(ids[i]);
+
+            if (g2::raycast(ray, rects[i], t) && t <= 30.0f)
+            {
+                expected_ray.push_back(ids[i]);
+                expected_closest = min(expected_closest, t);
+            }
+        }
+
+        std::sort(expected_area.begin(), expected_area.end());
+        std::sort(expected_point.begin(), expected_point.end());
+        std::sort(expected_ray.begin(), expected_ray.end());
+
+        found.clear();
+        bp.query(area, [&](uint32_t id) { found.push_back(id); });
+        std::sort(found.begin(), found.end());
+        same &= (found == expected_area);
+
+        found.clear();
+        bp.query(p, [&](uint32_t id) { found.push_back(id); });
+        std::sort(found.begin(), found.end());
+        same &= (found == expected_point);
+
+        found.clear();
+        bp.raycast(ray, 30.0f, [&](uint32_t id, f32) { found.push_back(id); return 30.0f; });
+        std::sort(found.begin(), found.end());
+        same &= (found == expected_ray);
+
+        f32 closest_t = constants<f32>::infinity;
+        bp.raycast(ray, 30.0f, [&](uint32_t, f32 t) { closest_t = min(closest_t, t); return t; });
+        same &= (closest_t == expected_closest);
+
+        // the k nearest, compared by distance since there may be ties
+        std::vector<f32> distances;
+        for (size_t i = 0; i < rects.size(); ++i)
+        {
+            if (ids[i] != Broadphase::invalid_id)
+            {
+                distances.push_back(distance_squared(g2::closest(rects[i], p), p));
+            }
+        }
+        std::sort(distances.begin(), distances.end());
+
+        uint32_t nearest[8];
+        const size_t count = bp.find_nearest(p, 8, nearest);
+        same &= (count == min(size_t(8), distances.size()));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            same &= (distance_squared(g2::closest(bp.get_bounds(nearest[i]), p), p) == distances[i]);
+        }
+    }
+
+    return same;
+}
+
+static void move(g2::aabb_tree<f32>& tree, uint32_t id, const g2::rect& r, const vec2& d)
+{
+    tree.move(id, r, d);
+}
+
+static void move(g2::spatial_hash<f32>& hash, uint32_t id, const g2::rect& r, const vec2&)
+{
+    hash.move(id, r);
+}
+
+template <typename Broadphase>
+static void check_broadphase(Broadphase& bp)
+{
+    uint32_t seed = 1;
+
+    std::vector<g2::rect> rects(400);
+    std::vector<uint32_t> ids(rects.size());
+
+    for (size_t i = 0; i < rects.size(); ++i)
+    {
+        rects[i] = random_rect(seed);
+        ids[i] = bp.insert(rects[i], i);
+    }
+
+    VX_CHECK(bp.size() == rects.size());
+    VX_CHECK(bp.get_user_data(ids[17]) == 17);
+    VX_CHECK(matches_brute_force(bp, rects, ids, seed));
+
+    VX_SECTION("remove")
+    {
+        for (size_t i = 0; i < rects.size(); i += 3)
+        {
+            bp.remove(ids[i]);
+            ids[i] = Broadphase::invalid_id;
+        }
+
+        VX_CHECK(bp.size() == rects.size() - (rects.size() + 2) / 3);
+        VX_CHECK(matches_brute_force(bp, rects, ids, seed));
+
+        // the free ids are used again
+        for (size_t i = 0; i < rects.size(); i += 3)
+        {
+            rects[i] = random_rect(seed);
+            ids[i] = bp.insert(rects[i], i);
+        }
+
+        VX_CHECK(matches_brute_force(bp, rects, ids, seed));
+    }
+
+    VX_SECTION("move")
+    {
+        bool same = true;
+
+        for (size_t step = 0; step < 10; ++step)
+        {
+            for (size_t i = 0; i < rects.size(); ++i)
+            {
+                // most objects move a little, some jump across the world
+                const vec2 d = (i % 10 == 0)
+                    ? vec2(random_float(seed, -40.0f, 40.0f), random_float(seed, -40.0f, 40.0f))
+                    : vec2(random_float(seed, -0.5f, 0.5f), random_float(seed, -0.5f, 0.5f));
+
+                rects[i] = g2::move(rects[i], d.x, d.y);
+                move(bp, ids[i], rects[i], d);
+            }
+
+            same &= matches_brute_force(bp, rects, ids, seed);
+        }
+
+        VX_CHECK(same);
+    }
+
+    VX_SECTION("clear")
+    {
+        bp.clear();
+        VX_CHECK(bp.empty());
+
+        uint32_t nearest[1];
+        VX_CHECK(bp.find_nearest(g2::point(0.0f, 0.0f), 1, nearest) == 0);
+
+        size_t calls = 0;
+        bp.query_pairs([&](uint32_t, uint32_t) { ++calls; });
+        bp.query(g2::rect(-100.0f, -100.0f, 200.0f, 200.0f), [&](uint32_t) { ++calls; });
+        VX_CHECK(calls == 0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_raycast)
+{
+    const g2::rect r(1.0f, 1.0f, 2.0f, 2.0f);
+    f32 t = -1.0f;
+
+    VX_CHECK(g2::raycast(ray_type(0.0f, 2.0f, 1.0f, 0.0f), r, t) && t == 1.0f);
+    VX_CHECK(g2::raycast(ray_type(0.0f, 0.0f, 2.0f, 2.0f), r, t) && t == 0.5f);
+    VX_CHECK(g2::raycast(ray_type(2.0f, 2.0f, 1.0f, 0.0f), r, t) && t == 0.0f);
+
+    // along an edge
+    VX_CHECK(g2::raycast(ray_type(0.0f, 1.0f, 1.0f, 0.0f), r, t) && t == 1.0f);
+
+    VX_CHECK(!g2::raycast(ray_type(0.0f, 2.0f, -1.0f, 0.0f), r, t));
+    VX_CHECK(!g2::raycast(ray_type(0.0f, 4.0f, 1.0f, 0.0f), r, t));
+    VX_CHECK(!g2::raycast(ray_type(0.0f, 0.0f, 1.0f, -0.1f), r, t));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_aabb_tree)
+{
+    g2::aabb_tree<f32> tree(0.25f);
+    check_broadphase(tree);
+
+    VX_SECTION("balance")
+    {
+        // inserted in order, the worst case for an unbalanced tree
+        g2::aabb_tree<f32> line;
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            line.insert(g2::rect(static_cast<f32>(i), 0.0f, 1.0f, 1.0f));
+        }
+
+        VX_CHECK(line.height() <= 20);
+    }
+
+    VX_SECTION("fat bounds")
+    {
+        g2::aabb_tree<f32> small(1.0f);
+        const uint32_t id = small.insert(g2::rect(0.0f, 0.0f, 1.0f, 1.0f));
+
+        VX_CHECK(small.get_fat_bounds(id) == g2::rect(-1.0f, -1.0f, 3.0f, 3.0f));
+        VX_CHECK(!small.move(id, g2::rect(0.5f, 0.0f, 1.0f, 1.0f), vec2(0.5f, 0.0f)));
+        VX_CHECK(small.move(id, g2::rect(2.0f, 0.0f, 1.0f, 1.0f), vec2(1.5f, 0.0f)));
+
+        // stretched in the direction of motion
+        VX_CHECK(small.get_fat_bounds(id).right() > 4.0f + 1.5f);
+        VX_CHECK(small.get_fat_bounds(id).left() == 1.0f);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_spatial_hash)
+{
+    g2::spatial_hash<f32> hash(4.0f);
+    check_broadphase(hash);
+
+    VX_SECTION("large objects")
+    {
+        // objects much larger than a cell are listed in many cells but still
+        // reported once
+        g2::spatial_hash<f32> fine(0.5f);
+        const uint32_t a = fine.insert(g2::rect(0.0f, 0.0f, 10.0f, 10.0f));
+        const uint32_t b = fine.insert(g2::rect(5.0f, 5.0f, 10.0f, 10.0f));
+        fine.insert(g2::rect(20.0f, 20.0f, 1.0f, 1.0f));
+
+        std::vector<id_pair> pairs;
+        fine.query_pairs([&](uint32_t i, uint32_t j) { pairs.emplace_back(i, j); });
+        VX_CHECK(pairs.size() == 1 && pairs[0] == id_pair(a, b));
+
+        size_t hits = 0;
+        fine.raycast(ray_type(-1.0f, 7.0f, 1.0f, 0.0f), 100.0f, [&](uint32_t, f32) { ++hits; return 100.0f; });
+        VX_CHECK(hits == 2);
+
+        VX_CHECK(!fine.move(b, g2::rect(5.1f, 5.1f, 10.0f, 10.0f)));
+        VX_CHECK(fine.move(b, g2::rect(50.0f, 50.0f, 10.0f, 10.0f)));
+
+        pairs.clear();
+        fine.query_pairs([&](uint32_t i, uint32_t j) { pairs.emplace_back(i, j); });
+        VX_CHECK(pairs.empty());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
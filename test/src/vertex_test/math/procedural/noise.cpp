@@ -0,0 +1,143 @@
+#include <vector>
+
+#include "vertex_test/test.hpp"
+
+#include "vertex/math/procedural/noise/noise_sampler.hpp"
+#include "vertex/pixel/execution_policy.hpp"
+
+using namespace vx;
+using namespace vx::math;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the tolerance documented by noise_sampler::fill_2d
+static constexpr f32 tolerance = 1e-4f;
+
+static f32 sample(const noise_sampler& sampler, noise_type type, const vec2& uv)
+{
+    return (type == noise_type::perlin) ? sampler.perlin_noise(uv) : sampler.simplex_noise(uv);
+}
+
+static f32 sample(const noise_sampler& sampler, noise_type type, const vec3& uv)
+{
+    return (type == noise_type::perlin) ? sampler.perlin_noise(uv) : sampler.simplex_noise(uv);
+}
+
+static noise_sampler make_sampler(size_t octaves, bool normalize)
+{
+    noise_sampler sampler;
+    sampler.frequency = 0.75f;
+    sampler.amplitude = 0.8f;
+    sampler.octaves = octaves;
+    sampler.seed = vec4(13.5f, -7.25f, 3.0f, 0.0f);
+    sampler.normalize = normalize;
+    return sampler;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_fill_2d)
+{
+    // an odd width leaves a partial batch at the end of each row
+    const size_t width = 37;
+    const size_t height = 29;
+    const vec2 origin(-5.3f, 11.7f);
+    const vec2 step(0.173f, 0.231f);
+
+    for (const noise_type type : { noise_type::perlin, noise_type::simplex })
+    {
+        for (const size_t octaves : { size_t(1), size_t(5) })
+        {
+            const noise_sampler sampler = make_sampler(octaves, octaves == 1);
+
+            std::vector<f32> values(width * height, -100.0f);
+            VX_CHECK(sampler.fill_2d(span<f32>(values.data(), values.size()), type, origin, step, width, height));
+
+            f32 max_error = 0.0f;
+            for (size_t y = 0; y < height; ++y)
+            {
+                for (size_t x = 0; x < width; ++x)
+                {
+                    const vec2 uv = origin + step * vec2(static_cast<f32>(x), static_cast<f32>(y));
+                    max_error = max(max_error, abs(values[y * width + x] - sample(sampler, type, uv)));
+                }
+            }
+
+            VX_CHECK(max_error <= tolerance);
+        }
+    }
+
+    VX_SECTION("small output")
+    {
+        std::vector<f32> values(10);
+        VX_CHECK(!noise_sampler().fill_2d(span<f32>(values.data(), values.size()), noise_type::perlin, vec2(0.0f), vec2(1.0f), 4, 3));
+        VX_CHECK(noise_sampler().fill_2d(span<f32>(), noise_type::perlin, vec2(0.0f), vec2(1.0f), 0, 0));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_fill_3d)
+{
+    const size_t width = 21;
+    const size_t height = 18;
+    const vec3 origin(2.1f, -3.4f, 0.37f);
+    const vec3 step_x(0.19f, 0.0f, 0.05f);
+    const vec3 step_y(0.0f, 0.23f, -0.11f);
+
+    for (const noise_type type : { noise_type::perlin, noise_type::simplex })
+    {
+        for (const size_t octaves : { size_t(1), size_t(4) })
+        {
+            const noise_sampler sampler = make_sampler(octaves, octaves == 1);
+
+            std::vector<f32> values(width * height);
+            VX_CHECK(sampler.fill_3d(span<f32>(values.data(), values.size()), type, origin, step_x, step_y, width, height));
+
+            f32 max_error = 0.0f;
+            for (size_t y = 0; y < height; ++y)
+            {
+                for (size_t x = 0; x < width; ++x)
+                {
+                    const vec3 uv = origin + step_x * static_cast<f32>(x) + step_y * static_cast<f32>(y);
+                    max_error = max(max_error, abs(values[y * width + x] - sample(sampler, type, uv)));
+                }
+            }
+
+            VX_CHECK(max_error <= tolerance);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_fill_parallel)
+{
+    os::thread_pool pool(3);
+
+    const size_t width = 300;
+    const size_t height = 250;
+    const noise_sampler sampler = make_sampler(3, true);
+
+    std::vector<f32> expected(width * height);
+    std::vector<f32> values(width * height);
+    const span<f32> out(values.data(), values.size());
+
+    VX_CHECK(sampler.fill_2d(span<f32>(expected.data(), expected.size()), noise_type::simplex, vec2(0.5f), vec2(0.01f), width, height));
+
+    // every row is computed the same way whichever thread runs it
+    VX_CHECK(sampler.fill_2d(out, noise_type::simplex, vec2(0.5f), vec2(0.01f), width, height, pixel::execution_policy::parallel(pool)));
+    VX_CHECK(values == expected);
+
+    VX_CHECK(sampler.fill_3d(span<f32>(expected.data(), expected.size()), noise_type::perlin, vec3(0.5f), vec3(0.01f, 0.0f, 0.0f), vec3(0.0f, 0.01f, 0.02f), width, height));
+    VX_CHECK(sampler.fill_3d(out, noise_type::perlin, vec3(0.5f), vec3(0.01f, 0.0f, 0.0f), vec3(0.0f, 0.01f, 0.02f), width, height, pixel::execution_policy::parallel(pool, 2)));
+    VX_CHECK(values == expected);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
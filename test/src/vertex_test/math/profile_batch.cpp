@@ -0,0 +1,153 @@
+#include <string>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/math/core/functions/batch.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// Times the math::batch functions compared to calling the scalar function on
+// each element, for arrays the size of a large mesh or a crowd of skinned
+// characters. The compiler often vectorizes the plain loops for transform,
+// mul and rotation_cast as well, and those are limited by memory rather than
+// arithmetic, so expect the most from the SoA outputs, inverse and slerp.
+
+using namespace vx;
+using namespace vx::math;
+
+static constexpr size_t RR = 20; // number of repetitions
+
+enum : size_t
+{
+    count = 100000
+};
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+//=========================================================================
+
+static f32 random_float(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<f32>((seed >> 8) % 20001) / 10000.0f - 1.0f;
+}
+
+struct batch_data
+{
+    std::vector<vec4f> v4, v4_out;
+    std::vector<vec3f> v3, v3_out;
+    std::vector<f32> x, y, z, w;
+    std::vector<mat4f> a, b, m_out;
+    std::vector<quatf> q0, q1, q_out;
+
+    batch_data()
+        : v4(count), v4_out(count)
+        , v3(count), v3_out(count)
+        , x(count), y(count), z(count), w(count)
+        , a(count), b(count), m_out(count)
+        , q0(count), q1(count), q_out(count)
+    {
+        uint32_t seed = 1;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            v4[i] = vec4f(random_float(seed), random_float(seed), random_float(seed), 1.0f);
+            v3[i] = vec3f(v4[i]);
+
+            for (size_t c = 0; c < 4; ++c)
+            {
+                a[i].columns[c] = vec4f(random_float(seed), random_float(seed), random_float(seed), random_float(seed));
+                b[i].columns[c] = vec4f(random_float(seed), random_float(seed), random_float(seed), random_float(seed));
+            }
+            a[i] += mat4f(2.0f);
+
+            q0[i] = normalize(quatf(random_float(seed), random_float(seed), random_float(seed), random_float(seed)));
+            q1[i] = normalize(quatf(random_float(seed), random_float(seed), random_float(seed), random_float(seed)));
+        }
+    }
+};
+
+//=========================================================================
+
+template <typename Loop, typename Batch>
+VX_NO_INLINE void profile_batch_op(const std::string& name, batch_data& d, Loop&& loop, Batch&& batched)
+{
+    {
+        start_timer(name + " (loop)");
+        loop();
+        vx::os::do_not_optimize(d);
+        stop_timer();
+    }
+
+    {
+        start_timer(name + " (batch)");
+        batched();
+        vx::os::do_not_optimize(d);
+        stop_timer();
+    }
+}
+
+//=========================================================================
+
+static void run(batch_data& d, size_t R)
+{
+    const mat4f m = d.a[0];
+    const f32 t = 0.3f;
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        profile_batch_op("transform vec4", d,
+            [&]() { for (size_t i = 0; i < count; ++i) d.v4_out[i] = m * d.v4[i]; },
+            [&]() { batch::transform(m, d.v4.data(), d.v4_out.data(), count); });
+
+        profile_batch_op("transform vec4 soa", d,
+            [&]() { for (size_t i = 0; i < count; ++i) { const vec4f v = m * d.v4[i]; d.x[i] = v.x; d.y[i] = v.y; d.z[i] = v.z; d.w[i] = v.w; } },
+            [&]() { batch::transform(m, d.v4.data(), d.x.data(), d.y.data(), d.z.data(), d.w.data(), count); });
+
+        profile_batch_op("transform_points", d,
+            [&]() { for (size_t i = 0; i < count; ++i) d.v3_out[i] = vec3f(m * vec4f(d.v3[i], 1.0f)); },
+            [&]() { batch::transform_points(m, d.v3.data(), d.v3_out.data(), count); });
+
+        profile_batch_op("transform_points soa", d,
+            [&]() { for (size_t i = 0; i < count; ++i) { const vec4f v = m * vec4f(d.v3[i], 1.0f); d.x[i] = v.x; d.y[i] = v.y; d.z[i] = v.z; } },
+            [&]() { batch::transform_points(m, d.v3.data(), d.x.data(), d.y.data(), d.z.data(), count); });
+
+        profile_batch_op("mul", d,
+            [&]() { for (size_t i = 0; i < count; ++i) d.m_out[i] = d.a[i] * d.b[i]; },
+            [&]() { batch::mul(d.a.data(), d.b.data(), d.m_out.data(), count); });
+
+        profile_batch_op("mul by one matrix", d,
+            [&]() { for (size_t i = 0; i < count; ++i) d.m_out[i] = m * d.b[i]; },
+            [&]() { batch::mul(m, d.b.data(), d.m_out.data(), count); });
+
+        profile_batch_op("inverse", d,
+            [&]() { for (size_t i = 0; i < count; ++i) d.m_out[i] = inverse(d.a[i]); },
+            [&]() { batch::inverse(d.a.data(), d.m_out.data(), count); });
+
+        profile_batch_op("rotation_cast", d,
+            [&]() { for (size_t i = 0; i < count; ++i) d.m_out[i] = rotation_cast<mat4f>(d.q0[i]); },
+            [&]() { batch::rotation_cast(d.q0.data(), d.m_out.data(), count); });
+
+        profile_batch_op("slerp", d,
+            [&]() { for (size_t i = 0; i < count; ++i) d.q_out[i] = slerp(d.q0[i], d.q1[i], t); },
+            [&]() { batch::slerp(d.q0.data(), d.q1.data(), t, d.q_out.data(), count); });
+    }
+}
+
+int main()
+{
+    batch_data d;
+
+    // warmup
+    run(d, 1);
+
+    VX_PROFILE_START_APPEND("profile_batch.csv");
+
+    run(d, RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
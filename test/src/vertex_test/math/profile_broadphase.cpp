@@ -0,0 +1,245 @@
+#include <string>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/math/geometry/2d/broadphase/aabb_tree.hpp"
+#include "vertex/math/geometry/2d/broadphase/spatial_hash.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// 100k small rects bouncing around a square world. Each frame every rect
+// moves and then all overlapping pairs are found, with g2::aabb_tree and
+// g2::spatial_hash, then point, area, ray and nearest queries are timed.
+// Testing every pair would take about 5e9 overlap tests per frame. For
+// objects of similar size spread evenly the hash is much faster; a tree
+// query visits ~140 nodes scattered through memory. The tree does not
+// depend on a cell size, so prefer it for mixed sizes or sparse worlds.
+
+using namespace vx;
+using namespace vx::math;
+
+static constexpr size_t RR = 3; // number of repetitions
+
+enum : size_t
+{
+    object_count = 100000,
+    frames = 10,
+    query_count = 10000
+};
+
+static constexpr f32 world_size = 2000.0f;
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+struct body
+{
+    g2::rect bounds;
+    vec2 velocity;
+};
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+static f32 random_float(uint32_t& seed, f32 lo, f32 hi)
+{
+    return lo + (hi - lo) * static_cast<f32>(next_random(seed) % 100001) / 100000.0f;
+}
+
+static std::vector<body> make_bodies()
+{
+    uint32_t seed = 1;
+    std::vector<body> bodies(object_count);
+
+    for (body& b : bodies)
+    {
+        const f32 size = random_float(seed, 1.0f, 4.0f);
+        b.bounds = g2::rect(random_float(seed, 0.0f, world_size - size), random_float(seed, 0.0f, world_size - size), size, size);
+        b.velocity = vec2(random_float(seed, -1.0f, 1.0f), random_float(seed, -1.0f, 1.0f));
+    }
+
+    return bodies;
+}
+
+static void step(body& b)
+{
+    b.bounds = g2::move(b.bounds, b.velocity.x, b.velocity.y);
+
+    if (b.bounds.left() < 0.0f || b.bounds.right() > world_size) b.velocity.x = -b.velocity.x;
+    if (b.bounds.top() < 0.0f || b.bounds.bottom() > world_size) b.velocity.y = -b.velocity.y;
+}
+
+template <typename Broadphase>
+VX_NO_INLINE void profile_build(const std::string& name, Broadphase& bp, const std::vector<body>& bodies, std::vector<uint32_t>& ids)
+{
+    start_timer(name + " build");
+
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        ids[i] = bp.insert(bodies[i].bounds, i);
+    }
+
+    vx::os::do_not_optimize(ids);
+    stop_timer();
+}
+
+template <typename Broadphase, typename Move>
+VX_NO_INLINE void profile_move(const std::string& name, Broadphase& bp, std::vector<body>& bodies, const std::vector<uint32_t>& ids, Move&& move)
+{
+    size_t moved = 0;
+
+    start_timer(name + " move");
+
+    for (size_t i = 0; i < bodies.size(); ++i)
+    {
+        step(bodies[i]);
+        moved += move(bp, ids[i], bodies[i]) ? 1 : 0;
+    }
+
+    vx::os::do_not_optimize(moved);
+    stop_timer();
+}
+
+template <typename Broadphase>
+VX_NO_INLINE void profile_pairs(const std::string& name, Broadphase& bp)
+{
+    size_t pair_count = 0;
+
+    start_timer(name + " pairs");
+    bp.query_pairs([&](uint32_t, uint32_t) { ++pair_count; });
+    vx::os::do_not_optimize(pair_count);
+    stop_timer();
+}
+
+template <typename Broadphase>
+VX_NO_INLINE void profile_point_queries(const std::string& name, const Broadphase& bp, uint32_t& seed)
+{
+    size_t hits = 0;
+
+    start_timer(name + " point");
+
+    for (size_t i = 0; i < query_count; ++i)
+    {
+        bp.query(g2::point(random_float(seed, 0.0f, world_size), random_float(seed, 0.0f, world_size)), [&](uint32_t) { ++hits; });
+    }
+
+    vx::os::do_not_optimize(hits);
+    stop_timer();
+}
+
+template <typename Broadphase>
+VX_NO_INLINE void profile_area_queries(const std::string& name, const Broadphase& bp, uint32_t& seed)
+{
+    size_t hits = 0;
+
+    start_timer(name + " area");
+
+    for (size_t i = 0; i < query_count; ++i)
+    {
+        bp.query(g2::rect(random_float(seed, 0.0f, world_size), random_float(seed, 0.0f, world_size), 20.0f, 20.0f), [&](uint32_t) { ++hits; });
+    }
+
+    vx::os::do_not_optimize(hits);
+    stop_timer();
+}
+
+template <typename Broadphase>
+VX_NO_INLINE void profile_ray_queries(const std::string& name, const Broadphase& bp, uint32_t& seed)
+{
+    size_t hits = 0;
+
+    start_timer(name + " ray");
+
+    for (size_t i = 0; i < query_count; ++i)
+    {
+        const g2::ray_t<f32> ray(g2::point(random_float(seed, 0.0f, world_size), random_float(seed, 0.0f, world_size)), normalize(vec2(random_float(seed, -1.0f, 1.0f), random_float(seed, -1.0f, 1.0f))));
+        bp.raycast(ray, 200.0f, [&](uint32_t, f32 t) { ++hits; return t; });
+    }
+
+    vx::os::do_not_optimize(hits);
+    stop_timer();
+}
+
+template <typename Broadphase>
+VX_NO_INLINE void profile_nearest_queries(const std::string& name, const Broadphase& bp, uint32_t& seed)
+{
+    size_t hits = 0;
+    uint32_t out[8];
+
+    start_timer(name + " 8 nearest");
+
+    for (size_t i = 0; i < query_count; ++i)
+    {
+        hits += bp.find_nearest(g2::point(random_float(seed, 0.0f, world_size), random_float(seed, 0.0f, world_size)), 8, out);
+    }
+
+    vx::os::do_not_optimize(hits);
+    stop_timer();
+}
+
+template <typename Broadphase, typename Move>
+static void profile_broadphase(const std::string& name, Broadphase& bp, Move&& move)
+{
+    std::vector<body> bodies = make_bodies();
+    std::vector<uint32_t> ids(bodies.size());
+
+    profile_build(name, bp, bodies, ids);
+
+    for (size_t f = 0; f < frames; ++f)
+    {
+        profile_move(name, bp, bodies, ids, move);
+        profile_pairs(name, bp);
+    }
+
+    uint32_t seed = 2;
+
+    profile_point_queries(name, bp, seed);
+    profile_area_queries(name, bp, seed);
+    profile_ray_queries(name, bp, seed);
+    profile_nearest_queries(name, bp, seed);
+}
+
+//=========================================================================
+
+static void run(size_t R)
+{
+    for (size_t r = 0; r < R; ++r)
+    {
+        g2::aabb_tree<f32> tree(0.5f);
+        tree.reserve(object_count);
+
+        profile_broadphase("aabb_tree", tree, [](g2::aabb_tree<f32>& t, uint32_t id, const body& b)
+        {
+            return t.move(id, b.bounds, b.velocity);
+        });
+    }
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        g2::spatial_hash<f32> hash(8.0f);
+        hash.reserve(object_count);
+
+        profile_broadphase("spatial_hash", hash, [](g2::spatial_hash<f32>& h, uint32_t id, const body& b)
+        {
+            return h.move(id, b.bounds);
+        });
+    }
+}
+
+int main()
+{
+    // warmup
+    run(1);
+
+    VX_PROFILE_START_APPEND("profile_broadphase.csv");
+
+    run(RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
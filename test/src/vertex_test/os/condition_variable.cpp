@@ -0,0 +1,136 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/condition_variable.hpp"
+#include "vertex/os/mutex.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/time.hpp"
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_condition_variable_notify_one)
+{
+    os::mutex mtx;
+    os::condition_variable cv;
+    bool ready = false;
+    bool woken = false;
+
+    os::thread t;
+    VX_CHECK(t.start([&]()
+    {
+        mtx.lock();
+        cv.wait(mtx, [&]() { return ready; });
+        woken = true;
+        mtx.unlock();
+    }));
+
+    os::sleep(time::milliseconds(10));
+
+    mtx.lock();
+    ready = true;
+    mtx.unlock();
+    cv.notify_one();
+
+    VX_CHECK(t.join());
+    VX_CHECK(woken);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_condition_variable_notify_all)
+{
+    constexpr size_t thread_count = 4;
+
+    os::mutex mtx;
+    os::condition_variable cv;
+    bool ready = false;
+    size_t woken = 0;
+
+    os::thread threads[thread_count];
+    for (auto& t : threads)
+    {
+        VX_CHECK(t.start([&]()
+        {
+            mtx.lock();
+            cv.wait(mtx, [&]() { return ready; });
+            ++woken;
+            mtx.unlock();
+        }));
+    }
+
+    os::sleep(time::milliseconds(10));
+
+    mtx.lock();
+    ready = true;
+    mtx.unlock();
+    cv.notify_all();
+
+    for (auto& t : threads)
+    {
+        VX_CHECK(t.join());
+    }
+
+    VX_CHECK(woken == thread_count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_condition_variable_timeout)
+{
+    os::mutex mtx;
+    os::condition_variable cv;
+
+    mtx.lock();
+
+    const time::time_point start = os::get_ticks();
+    VX_CHECK(!cv.wait_for(mtx, time::milliseconds(20), []() { return false; }));
+    VX_CHECK(os::get_ticks() - start >= time::milliseconds(20));
+
+    // the mutex is held again after the wait
+    VX_CHECK(!mtx.try_lock());
+    mtx.unlock();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_condition_variable_ping_pong)
+{
+    constexpr size_t rounds = 10000;
+
+    os::mutex mtx;
+    os::condition_variable cv;
+    size_t turn = 0;
+
+    os::thread t;
+    VX_CHECK(t.start([&]()
+    {
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            mtx.lock();
+            cv.wait(mtx, [&]() { return turn % 2 == 1; });
+            ++turn;
+            mtx.unlock();
+            cv.notify_one();
+        }
+    }));
+
+    for (size_t i = 0; i < rounds; ++i)
+    {
+        mtx.lock();
+        cv.wait(mtx, [&]() { return turn % 2 == 0; });
+        ++turn;
+        mtx.unlock();
+        cv.notify_one();
+    }
+
+    VX_CHECK(t.join());
+    VX_CHECK(turn == rounds * 2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/event.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/time.hpp"
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_event_set)
+{
+    os::event e;
+
+    VX_CHECK(!e.is_set());
+    VX_CHECK(!e.wait_for(time::zero()));
+
+    e.set();
+    VX_CHECK(e.is_set());
+    VX_CHECK(e.wait_for(time::zero()));
+
+    // stays set
+    e.set();
+    e.wait();
+    VX_CHECK(e.is_set());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_event_timeout)
+{
+    os::event e;
+
+    const time::time_point start = os::get_ticks();
+    VX_CHECK(!e.wait_for(time::milliseconds(20)));
+    VX_CHECK(os::get_ticks() - start >= time::milliseconds(20));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_event_wakes_all)
+{
+    constexpr size_t thread_count = 4;
+
+    os::event e;
+    int value = 0;
+    os::atomic<size_t> seen{ 0 };
+
+    os::thread threads[thread_count];
+    for (auto& t : threads)
+    {
+        VX_CHECK(t.start([&]()
+        {
+            e.wait();
+
+            // writes made before set are visible after wait
+            if (value == 42)
+            {
+                seen.fetch_add(1);
+            }
+        }));
+    }
+
+    os::sleep(time::milliseconds(10));
+
+    value = 42;
+    e.set();
+
+    for (auto& t : threads)
+    {
+        VX_CHECK(t.join());
+    }
+
+    VX_CHECK(seen.load() == thread_count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -496,6 +496,208 @@ VX_TEST_CASE(test_read_and_write_line)
 
 /////////////////////////////////////////////////////////////////////////////
 
+VX_TEST_CASE(test_buffered_read_line)
+{
+    // lines of every length around the buffer size, the last without a line ending
+    constexpr size_t buffer_size = 16;
+    constexpr size_t line_count = 40;
+
+    std::vector<std::string> lines;
+    std::string text;
+
+    for (size_t i = 0; i < line_count; ++i)
+    {
+        lines.emplace_back(i, static_cast<char>('a' + (i % 26)));
+        text += lines.back();
+
+        if (i + 1 < line_count)
+        {
+            text += '\n';
+        }
+    }
+
+    VX_CHECK(os::file::write_file(filename, reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+
+    os::file f;
+    VX_CHECK(!f.is_buffered());
+    VX_CHECK(f.set_buffer_size(buffer_size));
+    VX_CHECK(f.open(filename, os::file::mode::read));
+
+    VX_SECTION("string")
+    {
+        std::string line;
+        size_t i = 0;
+
+        while (f.read_line(line))
+        {
+            VX_CHECK(i < line_count && line == lines[i]);
+            ++i;
+        }
+
+        VX_CHECK(i == line_count);
+        VX_CHECK(f.eof());
+    }
+
+    VX_SECTION("view")
+    {
+        VX_CHECK(f.seek(0));
+        size_t i = 0;
+
+        for (const string_view line : f.lines())
+        {
+            VX_CHECK(i < line_count && line == string_view(lines[i].data(), lines[i].size()));
+            ++i;
+        }
+
+        VX_CHECK(i == line_count);
+        VX_CHECK(f.eof());
+    }
+
+    VX_SECTION("mixed with read")
+    {
+        VX_CHECK(f.seek(0));
+
+        string_view line;
+        VX_CHECK(f.read_line(line) && line.empty());
+        VX_CHECK(f.read_line(line) && line == "b");
+        VX_CHECK(f.tell() == 3);
+
+        char c{};
+        VX_CHECK(f.read(c) == 1 && c == 'c');
+        VX_CHECK(f.read_line(line) && line == "c");
+    }
+
+    VX_SECTION("unbuffered")
+    {
+        VX_CHECK(f.seek(0));
+        VX_CHECK(f.set_buffer_size(0));
+        VX_CHECK(!f.is_buffered());
+
+        std::string line;
+        VX_CHECK(f.read_line(line) && line.empty());
+        VX_CHECK(f.read_line(line) && line == "b");
+        VX_CHECK(f.tell() == 3);
+
+        string_view view;
+        VX_CHECK_AND_EXPECT_ERROR(!f.read_line(view));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_read_line_endings)
+{
+    // the last line has no line ending after its carriage return
+    const char text[] = "a\r\nb\r";
+    VX_CHECK(os::file::write_file(filename, reinterpret_cast<const uint8_t*>(text), sizeof(text) - 1));
+
+    // carriage returns are only part of the line ending on windows
+#if defined(VX_OS_WINDOWS)
+    const std::string expected[] = { "a", "b" };
+#else
+    const std::string expected[] = { "a\r", "b\r" };
+#endif
+
+    for (const size_t buffer_size : { size_t(0), size_t(4), size_t(os::file::default_buffer_size) })
+    {
+        os::file f;
+        VX_CHECK(f.set_buffer_size(buffer_size));
+        VX_CHECK(f.open(filename, os::file::mode::read));
+
+        std::string line;
+        VX_CHECK(f.read_line(line) && line == expected[0]);
+        VX_CHECK(f.read_line(line) && line == expected[1]);
+        VX_CHECK(!f.read_line(line));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+static bool open_buffered(os::file& f, size_t buffer_size)
+{
+    return f.set_buffer_size(buffer_size) && f.open(filename, os::file::mode::read_write_create);
+}
+
+VX_TEST_CASE(test_buffered_write)
+{
+    VX_SECTION("coalesce")
+    {
+        os::file f;
+        VX_CHECK(open_buffered(f, 64));
+
+        for (int i = 0; i < 10; ++i)
+        {
+            VX_CHECK(f.write(in_text, count) == count);
+        }
+
+        // the logical size and position include pending writes
+        VX_CHECK(f.size() == count * 10);
+        VX_CHECK(f.tell() == count * 10);
+
+        // a large write goes straight to the file after what is pending
+        std::string large(200, 'x');
+        VX_CHECK(f.write(large) == large.size());
+
+        VX_CHECK(f.write(in_text, count) == count);
+        VX_CHECK(f.flush());
+
+        std::string text;
+        VX_CHECK(os::file::read_file(filename, text));
+        VX_CHECK(text.size() == count * 11 + large.size());
+        VX_CHECK(text.compare(count * 10, large.size(), large) == 0);
+        VX_CHECK(text.compare(text.size() - count, count, in_text) == 0);
+    }
+
+    VX_SECTION("pending until flush")
+    {
+        os::file f;
+        VX_CHECK(open_buffered(f, 64));
+
+        VX_CHECK(f.write(in_text, count) == count);
+
+        // nothing has reached the file yet
+        os::file reader;
+        VX_CHECK(reader.open(filename, os::file::mode::read));
+        VX_CHECK(reader.size() == 0);
+
+        VX_CHECK(f.flush());
+        VX_CHECK(reader.size() == count);
+    }
+
+    VX_SECTION("write after read")
+    {
+        os::file f;
+        VX_CHECK(open_buffered(f, 64));
+
+        VX_CHECK(f.write(in_text, count) == count);
+        VX_CHECK(f.seek(0));
+
+        char out_text[5]{};
+        VX_CHECK(f.read(out_text, 5) == 5);
+
+        // lands at the logical position, not after the data read ahead
+        VX_CHECK(f.write("_") == 1);
+        VX_CHECK(f.tell() == 6);
+        f.close();
+
+        VX_CHECK(read_and_compare_text_file(filename, "Hello_World!"));
+    }
+
+    VX_SECTION("close flushes")
+    {
+        os::file f;
+        VX_CHECK(open_buffered(f, 64));
+
+        VX_CHECK(f.write_line("first"));
+        VX_CHECK(f.write_line("second"));
+        f.close();
+
+        VX_CHECK(read_and_compare_text_file(filename, "first" VX_LINE_END "second" VX_LINE_END));
+    }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 int main()
 {
     VX_PRINT_ERRORS(true);
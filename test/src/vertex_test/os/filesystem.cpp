@@ -1313,6 +1313,76 @@ VX_TEST_CASE(test_copy_file)
         VX_CHECK(os::filesystem::copy_file(file, success, false));
         VX_CHECK(compare_contents(success, std::string{}));
     }
+
+    // large enough to take several chunks when copied through a buffer
+    const os::path large = temp_dir.path / "large.bin";
+    std::string large_text(3 * 1024 * 1024 + 17, '\0');
+    for (size_t i = 0; i < large_text.size(); ++i)
+    {
+        large_text[i] = static_cast<char>((i * 31) & 0x7f);
+    }
+    VX_CHECK(os::file::write_file(large, reinterpret_cast<const uint8_t*>(large_text.data()), large_text.size()));
+
+    VX_SECTION("progress")
+    {
+        struct progress_state
+        {
+            size_t calls = 0;
+            size_t last = 0;
+            size_t total = 0;
+            bool increasing = true;
+        };
+
+        const auto on_progress = [](size_t copied, size_t total, void* user_data)
+        {
+            progress_state* state = static_cast<progress_state*>(user_data);
+            state->increasing &= (copied >= state->last);
+            state->last = copied;
+            state->total = total;
+            ++state->calls;
+            return true;
+        };
+
+        progress_state state;
+        const os::path to = temp_dir.path / "large_copy.bin";
+
+        VX_CHECK(os::filesystem::copy_file(large, to, true, on_progress, &state));
+        VX_CHECK(compare_contents(to, large_text));
+        VX_CHECK(state.calls != 0);
+        VX_CHECK(state.increasing);
+        VX_CHECK(state.last == large_text.size());
+        VX_CHECK(state.total == large_text.size());
+    }
+
+    VX_SECTION("cancel")
+    {
+        const auto on_progress = [](size_t, size_t, void*) { return false; };
+        VX_CHECK_AND_EXPECT_ERROR(!os::filesystem::copy_file(large, temp_dir.path / "cancelled.bin", true, on_progress, nullptr));
+    }
+
+    VX_SECTION("sparse")
+    {
+        // data, a hole, more data, then a trailing hole
+        const os::path sparse = temp_dir.path / "sparse.bin";
+        constexpr int hole_size = 4 * 1024 * 1024;
+
+        {
+            os::file f;
+            VX_CHECK(f.open(sparse, os::file::mode::write));
+            VX_CHECK(f.write(text) == text.size());
+            VX_CHECK(f.seek(hole_size));
+            VX_CHECK(f.write(text) == text.size());
+            VX_CHECK(f.resize(2 * hole_size));
+        }
+
+        std::string expected(2 * hole_size, '\0');
+        expected.replace(0, text.size(), text);
+        expected.replace(hole_size, text.size(), text);
+
+        const os::path to = temp_dir.path / "sparse_copy.bin";
+        VX_CHECK(os::filesystem::copy_file(sparse, to));
+        VX_CHECK(compare_contents(to, expected));
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,207 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/file.hpp"
+#include "vertex/os/filesystem.hpp" // only for temp path
+#include "vertex/os/mapped_file.hpp"
+
+using namespace vx;
+
+static std::string current_time_file()
+{
+    const time::time_point now = os::system_time();
+    std::string filename = std::to_string(now.as_nanoseconds());
+    filename.append(".bin");
+    return filename;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const os::path temp_path = os::filesystem::get_temp_path();
+static const os::path filename = temp_path / current_time_file();
+
+// larger than a page so windows can start past the first one
+static constexpr size_t file_size = 3 * 4096 + 123;
+
+static uint8_t byte_at(size_t i)
+{
+    return static_cast<uint8_t>((i * 7) ^ (i >> 8));
+}
+
+static bool write_test_file()
+{
+    std::vector<uint8_t> data(file_size);
+    for (size_t i = 0; i < file_size; ++i)
+    {
+        data[i] = byte_at(i);
+    }
+
+    return os::file::write_file(filename, data.data(), data.size());
+}
+
+static bool matches_file(const os::mapped_file& m)
+{
+    for (size_t i = 0; i < m.size(); ++i)
+    {
+        if (m.data()[i] != byte_at(m.offset() + i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_map_read_only)
+{
+    VX_CHECK(write_test_file());
+
+    VX_SECTION("whole file")
+    {
+        os::mapped_file m;
+        VX_CHECK(!m.is_mapped());
+        VX_CHECK(m.data() == nullptr);
+
+        VX_CHECK(m.map(filename));
+        VX_CHECK(m.is_mapped());
+        VX_CHECK(m.get_access() == os::mapped_file::access::read_only);
+        VX_CHECK(!m.can_write());
+        VX_CHECK(m.size() == file_size);
+        VX_CHECK(m.offset() == 0);
+        VX_CHECK(matches_file(m));
+
+        VX_CHECK(m.advise(os::mapped_file::advice::sequential));
+        VX_CHECK(m.flush());
+
+        // already mapped
+        VX_CHECK_AND_EXPECT_ERROR(!m.map(filename));
+
+        m.unmap();
+        VX_CHECK(!m.is_mapped());
+        VX_CHECK(m.size() == 0);
+    }
+
+    VX_SECTION("window")
+    {
+        // neither end is page aligned
+        os::mapped_file m;
+        VX_CHECK(m.map(filename, os::mapped_file::access::read_only, 4096 + 17, 5000));
+        VX_CHECK(m.size() == 5000);
+        VX_CHECK(m.offset() == 4096 + 17);
+        VX_CHECK(matches_file(m));
+
+        os::mapped_file tail;
+        VX_CHECK(tail.map(filename, os::mapped_file::access::read_only, file_size - 10));
+        VX_CHECK(tail.size() == 10);
+        VX_CHECK(matches_file(tail));
+
+        os::mapped_file empty;
+        VX_CHECK(empty.map(filename, os::mapped_file::access::read_only, file_size));
+        VX_CHECK(empty.is_mapped());
+        VX_CHECK(empty.empty());
+        VX_CHECK(empty.begin() == empty.end());
+    }
+
+    VX_SECTION("invalid")
+    {
+        os::mapped_file m;
+        VX_CHECK_AND_EXPECT_ERROR(!m.map(filename, os::mapped_file::access::none));
+        VX_CHECK_AND_EXPECT_ERROR(!m.map(filename, os::mapped_file::access::read_only, file_size + 1));
+        VX_CHECK_AND_EXPECT_ERROR(!m.map(filename, os::mapped_file::access::read_only, 10, file_size));
+        VX_CHECK_AND_EXPECT_ERROR(!m.map(temp_path / "this_file_does_not_exist.bin"));
+        VX_CHECK(!m.is_mapped());
+
+        VX_CHECK(!m.advise(os::mapped_file::advice::random));
+        VX_CHECK(!m.flush());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_map_read_write)
+{
+    VX_CHECK(write_test_file());
+
+    {
+        os::mapped_file m;
+        VX_CHECK(m.map(filename, os::mapped_file::access::read_write, 100, 50));
+        VX_CHECK(m.can_write());
+
+        for (uint8_t& b : m)
+        {
+            b = 0xAB;
+        }
+
+        VX_CHECK(m.flush());
+    }
+
+    std::vector<uint8_t> data;
+    VX_CHECK(os::file::read_file(filename, data));
+    VX_CHECK(data.size() == file_size);
+
+    bool ok = true;
+    for (size_t i = 0; i < file_size; ++i)
+    {
+        const uint8_t expected = (i >= 100 && i < 150) ? 0xAB : byte_at(i);
+        ok &= (data[i] == expected);
+    }
+    VX_CHECK(ok);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_map_copy_on_write)
+{
+    VX_CHECK(write_test_file());
+
+    {
+        os::mapped_file m;
+        VX_CHECK(m.map(filename, os::mapped_file::access::copy_on_write));
+        VX_CHECK(m.can_write());
+
+        m.data()[0] = static_cast<uint8_t>(~byte_at(0));
+        VX_CHECK(m.data()[0] != byte_at(0));
+
+        // other views still see the file
+        os::mapped_file other;
+        VX_CHECK(other.map(filename));
+        VX_CHECK(other.data()[0] == byte_at(0));
+    }
+
+    os::mapped_file m;
+    VX_CHECK(m.map(filename));
+    VX_CHECK(matches_file(m));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_map_move)
+{
+    VX_CHECK(write_test_file());
+
+    os::mapped_file a;
+    VX_CHECK(a.map(filename));
+    const uint8_t* data = a.data();
+
+    os::mapped_file b(std::move(a));
+    VX_CHECK(!a.is_mapped());
+    VX_CHECK(b.data() == data);
+
+    os::mapped_file c;
+    c = std::move(b);
+    VX_CHECK(!b.is_mapped());
+    VX_CHECK(c.data() == data);
+
+    c.swap(a);
+    VX_CHECK(!c.is_mapped());
+    VX_CHECK(a.data() == data);
+    VX_CHECK(matches_file(a));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
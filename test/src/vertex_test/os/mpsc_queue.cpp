@@ -0,0 +1,149 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/mpsc_queue.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_mpsc_queue_basic)
+{
+    VX_SECTION("capacity")
+    {
+        os::mpsc_queue<int> q0(0);
+        VX_CHECK(q0.capacity() == 2);
+
+        os::mpsc_queue<int> q1(100);
+        VX_CHECK(q1.capacity() == 128);
+
+        os::mpsc_queue<int> q2(64);
+        VX_CHECK(q2.capacity() == 64);
+    }
+
+    VX_SECTION("fifo")
+    {
+        os::mpsc_queue<int> q(8);
+        VX_CHECK(q.empty());
+
+        int value = -1;
+        VX_CHECK(!q.try_pop(value));
+
+        for (int i = 0; i < 8; ++i)
+        {
+            VX_CHECK(q.try_push(i));
+        }
+
+        // full
+        VX_CHECK(!q.try_push(8));
+        VX_CHECK(!q.empty());
+
+        for (int i = 0; i < 8; ++i)
+        {
+            VX_CHECK(q.try_pop(value));
+            VX_CHECK(value == i);
+        }
+
+        VX_CHECK(q.empty());
+        VX_CHECK(!q.try_pop(value));
+    }
+
+    VX_SECTION("wrap around")
+    {
+        os::mpsc_queue<int> q(4);
+        int expected = 0;
+        int next = 0;
+
+        // keep the queue partially full across many laps
+        for (int round = 0; round < 1000; ++round)
+        {
+            while (q.try_push(next))
+            {
+                ++next;
+            }
+
+            int value = -1;
+            for (int i = 0; i < 3; ++i)
+            {
+                VX_CHECK(q.try_pop(value));
+                VX_CHECK(value == expected);
+                ++expected;
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct tagged
+{
+    uint32_t producer;
+    uint32_t index;
+};
+
+VX_TEST_CASE(test_mpsc_queue_multi_producer)
+{
+    constexpr uint32_t producer_count = 4;
+    constexpr uint32_t per_producer = 100000;
+
+    os::mpsc_queue<tagged> q(256);
+    std::vector<std::thread> producers;
+
+    for (uint32_t p = 0; p < producer_count; ++p)
+    {
+        producers.emplace_back([&q, p]()
+        {
+            for (uint32_t i = 0; i < per_producer; ++i)
+            {
+                while (!q.try_push(tagged{ p, i }))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // each producer's items must arrive in order and none may be lost
+    uint32_t next[producer_count] = {};
+    size_t received = 0;
+    bool ordered = true;
+
+    while (received < producer_count * per_producer)
+    {
+        tagged t;
+        if (!q.try_pop(t))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ordered &= (t.producer < producer_count) && (t.index == next[t.producer]);
+        if (t.producer < producer_count)
+        {
+            next[t.producer] = t.index + 1;
+        }
+        ++received;
+    }
+
+    for (auto& t : producers)
+    {
+        t.join();
+    }
+
+    VX_CHECK(ordered);
+    VX_CHECK(q.empty());
+
+    for (uint32_t p = 0; p < producer_count; ++p)
+    {
+        VX_CHECK(next[p] == per_producer);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
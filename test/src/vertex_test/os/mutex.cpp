@@ -20,6 +20,9 @@ VX_TEST_CASE(test_mutex_basic_lock_unlock)
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#if VX_DEBUG
+
+// ownership is only tracked in debug builds
 VX_TEST_CASE(test_mutex_deadlock)
 {
     os::mutex mtx;
@@ -30,6 +33,8 @@ VX_TEST_CASE(test_mutex_deadlock)
     mtx.unlock();
 }
 
+#endif // VX_DEBUG
+
 ///////////////////////////////////////////////////////////////////////////////
 
 VX_TEST_CASE(test_mutex_multiple_threads)
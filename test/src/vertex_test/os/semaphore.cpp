@@ -0,0 +1,85 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/semaphore.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/time.hpp"
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_semaphore_count)
+{
+    os::semaphore sem(2);
+
+    VX_CHECK(sem.count() == 2);
+    VX_CHECK(sem.try_acquire());
+    VX_CHECK(sem.try_acquire());
+    VX_CHECK(!sem.try_acquire());
+
+    sem.release(3);
+    VX_CHECK(sem.count() == 3);
+
+    sem.acquire();
+    VX_CHECK(sem.count() == 2);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_semaphore_timeout)
+{
+    os::semaphore sem;
+
+    VX_CHECK(!sem.try_acquire_for(time::zero()));
+
+    const time::time_point start = os::get_ticks();
+    VX_CHECK(!sem.try_acquire_for(time::milliseconds(20)));
+    VX_CHECK(os::get_ticks() - start >= time::milliseconds(20));
+
+    sem.release();
+    VX_CHECK(sem.try_acquire_for(time::milliseconds(20)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_semaphore_producer_consumer)
+{
+    constexpr size_t thread_count = 4;
+    constexpr size_t items_per_thread = 10000;
+
+    os::semaphore items;
+    os::atomic<size_t> consumed{ 0 };
+
+    os::thread consumers[thread_count];
+    for (auto& t : consumers)
+    {
+        VX_CHECK(t.start([&]()
+        {
+            for (size_t i = 0; i < items_per_thread; ++i)
+            {
+                items.acquire();
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }));
+    }
+
+    for (size_t i = 0; i < thread_count * items_per_thread; ++i)
+    {
+        items.release();
+    }
+
+    for (auto& t : consumers)
+    {
+        VX_CHECK(t.join());
+    }
+
+    VX_CHECK(consumed.load() == thread_count * items_per_thread);
+    VX_CHECK(items.count() == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/mutex.hpp"
+#include "vertex/os/shared_mutex.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/time.hpp"
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_shared_mutex_basic)
+{
+    os::shared_mutex mtx;
+
+    VX_CHECK(mtx.lock_shared());
+    VX_CHECK(mtx.try_lock_shared());
+    VX_CHECK(!mtx.try_lock());
+    mtx.unlock_shared();
+    mtx.unlock_shared();
+
+    VX_CHECK(mtx.try_lock());
+    VX_CHECK(!mtx.try_lock_shared());
+    VX_CHECK(!mtx.try_lock());
+    mtx.unlock();
+
+    VX_CHECK(mtx.try_lock_shared());
+    mtx.unlock_shared();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_shared_mutex_readers_and_writers)
+{
+    constexpr size_t reader_count = 4;
+    constexpr size_t writer_count = 2;
+    constexpr size_t iterations = 5000;
+
+    os::shared_mutex mtx;
+
+    // writers keep both values equal, readers check that they never see them
+    // out of step
+    size_t a = 0;
+    size_t b = 0;
+    os::atomic<bool> torn{ false };
+
+    os::thread readers[reader_count];
+    os::thread writers[writer_count];
+
+    for (auto& t : readers)
+    {
+        VX_CHECK(t.start([&]()
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                os::shared_lock_guard<os::shared_mutex> lock(mtx);
+                if (a != b)
+                {
+                    torn.store(true);
+                }
+            }
+        }));
+    }
+
+    for (auto& t : writers)
+    {
+        VX_CHECK(t.start([&]()
+        {
+            for (size_t i = 0; i < iterations; ++i)
+            {
+                os::lock_guard<os::shared_mutex> lock(mtx);
+                ++a;
+                ++b;
+            }
+        }));
+    }
+
+    for (auto& t : readers)
+    {
+        VX_CHECK(t.join());
+    }
+
+    for (auto& t : writers)
+    {
+        VX_CHECK(t.join());
+    }
+
+    VX_CHECK(!torn.load());
+    VX_CHECK(a == writer_count * iterations);
+    VX_CHECK(b == writer_count * iterations);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_shared_mutex_waiting_writer_blocks_readers)
+{
+    os::shared_mutex mtx;
+    os::atomic<bool> writer_done{ false };
+
+    VX_CHECK(mtx.lock_shared());
+
+    os::thread writer;
+    VX_CHECK(writer.start([&]()
+    {
+        mtx.lock();
+        writer_done.store(true);
+        mtx.unlock();
+    }));
+
+    // once the writer is waiting new readers are turned away
+    os::sleep(time::milliseconds(20));
+    VX_CHECK(!mtx.try_lock_shared());
+    VX_CHECK(!writer_done.load());
+
+    mtx.unlock_shared();
+    VX_CHECK(writer.join());
+    VX_CHECK(writer_done.load());
+
+    VX_CHECK(mtx.try_lock_shared());
+    mtx.unlock_shared();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/thread_pool.hpp"
+#include "vertex/os/time.hpp"
+
+#include <atomic>
+#include <vector>
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static uint64_t fib(os::thread_pool& pool, uint64_t n)
+{
+    if (n < 12)
+    {
+        return (n < 2) ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    }
+
+    // the waiting task runs other tasks until its child is done
+    auto child = pool.submit([&pool, n]() { return fib(pool, n - 1); });
+    const uint64_t other = fib(pool, n - 2);
+    return child.get() + other;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_thread_pool_submit)
+{
+    os::thread_pool pool(3);
+    VX_CHECK(pool.worker_count() == 3);
+
+    VX_SECTION("values")
+    {
+        auto a = pool.submit([]() { return 40; });
+        auto b = pool.submit([]() { return std::string("result"); });
+
+        VX_CHECK(a.valid());
+        VX_CHECK(a.get() == 40);
+        VX_CHECK(!a.valid());
+        VX_CHECK(b.get() == "result");
+    }
+
+    VX_SECTION("void")
+    {
+        std::atomic<int> value{ 0 };
+        auto f = pool.submit([&value]() { value = 7; });
+        f.wait();
+        VX_CHECK(f.is_ready());
+        VX_CHECK(value == 7);
+        f.get();
+        VX_CHECK(!f.valid());
+    }
+
+    VX_SECTION("discarded future")
+    {
+        std::atomic<int> value{ 0 };
+        os::wait_group wg;
+        wg.add();
+
+        pool.submit([&]() { value = 1; wg.done(); });
+        pool.wait(wg);
+        VX_CHECK(value == 1);
+    }
+
+    VX_SECTION("nested")
+    {
+        VX_CHECK(fib(pool, 25) == 75025);
+    }
+
+    VX_SECTION("move")
+    {
+        os::future<int> f = pool.submit([]() { return 3; });
+        os::future<int> g(std::move(f));
+        VX_CHECK(!f.valid());
+
+        os::future<int> h;
+        h = std::move(g);
+        VX_CHECK(h.get() == 3);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_thread_pool_wait_group)
+{
+    os::thread_pool pool(4);
+
+    constexpr size_t task_count = 10000;
+    std::atomic<size_t> sum{ 0 };
+    os::wait_group wg;
+
+    for (size_t i = 0; i < task_count; ++i)
+    {
+        VX_CHECK(pool.submit(wg, [&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); }));
+    }
+
+    pool.wait(wg);
+    VX_CHECK(wg.is_done());
+    VX_CHECK(sum == task_count * (task_count - 1) / 2);
+
+    // tasks that spawn more tasks into the same group
+    sum = 0;
+    for (size_t i = 0; i < 100; ++i)
+    {
+        pool.submit(wg, [&]()
+        {
+            for (size_t j = 0; j < 100; ++j)
+            {
+                pool.submit(wg, [&sum]() { sum.fetch_add(1, std::memory_order_relaxed); });
+            }
+        });
+    }
+
+    pool.wait(wg);
+    VX_CHECK(sum == 100 * 100);
+
+    // done from a thread outside the pool wakes the parked waiter
+    wg.add();
+    os::thread t;
+    VX_CHECK(t.start([&wg]()
+    {
+        os::sleep(time::milliseconds(20));
+        wg.done();
+    }));
+
+    pool.wait(wg);
+    VX_CHECK(wg.is_done());
+    t.join();
+}
+
+VX_TEST_CASE(test_thread_pool_wait_runs_late_tasks)
+{
+    os::thread_pool pool(1);
+    os::wait_group wg;
+    wg.add();
+
+    // the only worker is busy until the task it queues has run, so the
+    // waiting thread must wake up and run it
+    std::atomic<bool> ran{ false };
+    pool.submit([&]()
+    {
+        os::sleep(time::milliseconds(20));
+        pool.submit([&]()
+        {
+            ran = true;
+            wg.done();
+        });
+
+        while (!ran)
+        {
+            os::cpu_pause();
+        }
+    });
+
+    pool.wait(wg);
+    VX_CHECK(ran);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_thread_pool_parallel_for)
+{
+    os::thread_pool pool(4);
+
+    constexpr size_t size = 100003;
+    std::vector<int> hits(size);
+
+    const auto check_range = [&](size_t begin, size_t end, size_t grain)
+    {
+        std::fill(hits.begin(), hits.end(), 0);
+
+        pool.parallel_for(begin, end, grain, [&](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                ++hits[i];
+            }
+        });
+
+        // every index in the range exactly once, nothing outside it
+        bool ok = true;
+        for (size_t i = 0; i < size; ++i)
+        {
+            ok &= (hits[i] == ((i >= begin && i < end) ? 1 : 0));
+        }
+        return ok;
+    };
+
+    VX_CHECK(check_range(0, size, 0));
+    VX_CHECK(check_range(0, size, 1000));
+    VX_CHECK(check_range(17, size - 5, 7));
+    VX_CHECK(check_range(0, size, size * 2));
+    VX_CHECK(check_range(10, 10, 0));
+    VX_CHECK(check_range(0, 1, 0));
+
+    // nested loops share the workers
+    std::atomic<size_t> count{ 0 };
+    pool.parallel_for(0, 64, 1, [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            pool.parallel_for(0, 1000, 100, [&](size_t a, size_t b)
+            {
+                count.fetch_add(b - a, std::memory_order_relaxed);
+            });
+        }
+    });
+    VX_CHECK(count == 64 * 1000);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_thread_pool_run_pending)
+{
+    os::thread_pool pool(2);
+    const os::thread_id main_id = os::this_thread::get_id();
+
+    std::atomic<int> ran{ 0 };
+    std::atomic<bool> on_main{ true };
+
+    auto f = pool.submit_main([&]()
+    {
+        on_main = on_main && (os::this_thread::get_id() == main_id);
+        ++ran;
+        return 5;
+    });
+
+    // main tasks can also come from workers
+    os::wait_group wg;
+    pool.submit(wg, [&]()
+    {
+        pool.submit_main([&]()
+        {
+            on_main = on_main && (os::this_thread::get_id() == main_id);
+            ++ran;
+        });
+    });
+    pool.wait(wg);
+
+    VX_CHECK(ran == 0);
+    VX_CHECK(!f.is_ready());
+
+    VX_CHECK(pool.run_pending() == 2);
+    VX_CHECK(ran == 2);
+    VX_CHECK(on_main);
+    VX_CHECK(f.get() == 5);
+
+    VX_CHECK(pool.run_pending() == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_thread_pool_lifetime)
+{
+    VX_SECTION("default size")
+    {
+        os::thread_pool pool;
+        VX_CHECK(pool.worker_count() >= 1);
+    }
+
+    VX_SECTION("destructor runs pending tasks")
+    {
+        std::atomic<size_t> count{ 0 };
+
+        {
+            os::thread_pool pool(2);
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                pool.submit([&count]() { ++count; });
+            }
+
+            pool.submit_main([&count]() { ++count; });
+        }
+
+        VX_CHECK(count == 1001);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
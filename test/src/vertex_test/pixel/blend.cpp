@@ -0,0 +1,173 @@
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/pixel/blit.hpp"
+
+using namespace vx;
+using namespace vx::pixel;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static int channel_error(byte_type a, byte_type b)
+{
+    return (a > b) ? a - b : b - a;
+}
+
+// Blends every combination of source channel, source alpha and destination
+// channel with the integer kernel and with the float blend function from
+// math/color/blend.hpp, and returns the largest difference.
+template <typename MODE>
+static int max_blend_error()
+{
+    constexpr pixel_format F = pixel_format::rgba_8888;
+    const math::blend_func_separate reference = MODE::function();
+
+    std::vector<byte_type> src(256 * 256 * 4);
+    std::vector<byte_type> dst(src.size());
+    int error = 0;
+
+    for (uint32_t sa = 0; sa < 256; ++sa)
+    {
+        // premultiplied sources never have color above alpha
+        const uint32_t max_color = MODE::premultiplied_alpha ? sa : 255;
+
+        for (uint32_t i = 0; i < 256 * 256; ++i)
+        {
+            const uint32_t sc = (i & 0xff) * max_color / 255;
+            const uint32_t dc = i >> 8;
+
+            byte_type* s = &src[i * 4];
+            byte_type* d = &dst[i * 4];
+
+            s[0] = static_cast<byte_type>(sc);
+            s[1] = static_cast<byte_type>(max_color - sc);
+            s[2] = static_cast<byte_type>(sc / 2);
+            s[3] = static_cast<byte_type>(sa);
+
+            d[0] = static_cast<byte_type>(dc);
+            d[1] = static_cast<byte_type>(255 - dc);
+            d[2] = static_cast<byte_type>(dc ^ 0x5a);
+            d[3] = static_cast<byte_type>(255 - (dc / 3));
+        }
+
+        std::vector<byte_type> expected(dst);
+        raw::blend_row<MODE, F>(src.data(), dst.data(), 256 * 256);
+
+        for (uint32_t i = 0; i < 256 * 256; ++i)
+        {
+            const math::color sc = static_cast<math::color>(reinterpret_cast<const raw_pixel<F>*>(src.data())[i]);
+            const math::color dc = static_cast<math::color>(reinterpret_cast<const raw_pixel<F>*>(expected.data())[i]);
+
+            const math::color s = MODE::premultiplied_alpha ? sc : math::color(sc.r * sc.a, sc.g * sc.a, sc.b * sc.a, sc.a);
+            reinterpret_cast<raw_pixel<F>*>(expected.data())[i] = raw_pixel<F>(reference.blend(s, dc));
+        }
+
+        for (size_t i = 0; i < dst.size(); ++i)
+        {
+            const int e = channel_error(dst[i], expected[i]);
+            error = (e > error) ? e : error;
+        }
+    }
+
+    return error;
+}
+
+VX_TEST_CASE(test_blend_accuracy)
+{
+    VX_SECTION("straight alpha")
+    {
+        VX_CHECK(max_blend_error<blend::src_over>() <= 1);
+        VX_CHECK(max_blend_error<blend::additive>() <= 1);
+        VX_CHECK(max_blend_error<blend::multiply>() <= 1);
+        VX_CHECK(max_blend_error<blend::screen>() <= 1);
+    }
+
+    VX_SECTION("premultiplied alpha")
+    {
+        VX_CHECK(max_blend_error<blend::src_over_premultiplied>() <= 1);
+        VX_CHECK(max_blend_error<blend::additive_premultiplied>() <= 1);
+        VX_CHECK(max_blend_error<blend::multiply_premultiplied>() <= 1);
+        VX_CHECK(max_blend_error<blend::screen_premultiplied>() <= 1);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static std::vector<byte_type> make_pixels(size_t size)
+{
+    std::vector<byte_type> data(size);
+
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<byte_type>(i * 2654435761u >> 11);
+    }
+
+    return data;
+}
+
+// blits with a built in mode and compares against calling the mode per pixel
+template <typename MODE, pixel_format SRC, pixel_format DST>
+static int max_blit_error(const math::recti& src_area, const math::vec2i& dst_position)
+{
+    const std::vector<byte_type> src_data = make_pixels(41 * 19 * get_pixel_size(SRC));
+    const surface<SRC> src(src_data.data(), 41, 19);
+
+    const std::vector<byte_type> dst_data = make_pixels(23 * 29 * get_pixel_size(DST));
+    surface<DST> dst(dst_data.data(), 23, 29);
+    surface<DST> expected(dst_data.data(), 23, 29);
+
+    VX_CHECK(blit(src, src_area, dst, dst_position, MODE{}));
+
+    const math::vec2i shift = dst_position - src_area.position;
+    for (int y = src_area.position.y; y < src_area.bottom(); ++y)
+    {
+        for (int x = src_area.position.x; x < src_area.right(); ++x)
+        {
+            if (x >= 0 && y >= 0 && x < 41 && y < 19)
+            {
+                const math::vec2i p(x + shift.x, y + shift.y);
+                expected.set_pixel(p, MODE{}(src.get_pixel(x, y), expected.get_pixel(p)));
+            }
+        }
+    }
+
+    int error = 0;
+    for (size_t i = 0; i < dst.data_size(); ++i)
+    {
+        const int e = channel_error(dst.data()[i], expected.data()[i]);
+        error = (e > error) ? e : error;
+    }
+
+    return error;
+}
+
+VX_TEST_CASE(test_blend_blit)
+{
+    VX_SECTION("same format")
+    {
+        VX_CHECK((max_blit_error<blend::src_over, pixel_format::rgba_8888, pixel_format::rgba_8888>(math::recti(0, 0, 41, 19), math::vec2i(-5, 3)) <= 1));
+        VX_CHECK((max_blit_error<blend::screen, pixel_format::argb_8888, pixel_format::argb_8888>(math::recti(3, 2, 30, 30), math::vec2i(0, -4)) <= 1));
+    }
+
+    VX_SECTION("converted source")
+    {
+        VX_CHECK((max_blit_error<blend::src_over, pixel_format::bgra_8888, pixel_format::rgba_8888>(math::recti(-2, -2, 50, 50), math::vec2i(1, 1)) <= 1));
+        VX_CHECK((max_blit_error<blend::multiply, pixel_format::rgb_8, pixel_format::bgra_8888>(math::recti(0, 0, 41, 19), math::vec2i(7, 20)) <= 1));
+        VX_CHECK((max_blit_error<blend::additive_premultiplied, pixel_format::rgba_4444, pixel_format::abgr_8888>(math::recti(0, 0, 41, 19), math::vec2i(-30, 0)) <= 1));
+    }
+
+    VX_SECTION("functor fallback")
+    {
+        // formats without an integer kernel call the mode per pixel
+        VX_CHECK((max_blit_error<blend::src_over, pixel_format::rgba_8888, pixel_format::rgba_4444>(math::recti(0, 0, 41, 19), math::vec2i(2, 2)) == 0));
+        VX_CHECK((max_blit_error<blend::screen, pixel_format::rgba_8888, pixel_format::rgb_8>(math::recti(0, 0, 41, 19), math::vec2i(2, 2)) == 0));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/pixel/blit.hpp"
+
+using namespace vx;
+using namespace vx::pixel;
+
+///////////////////////////////////////////////////////////////////////////////
+
+// converts every pixel the slow way, through a color
+template <pixel_format SRC, pixel_format DST>
+static std::vector<byte_type> reference_row(const std::vector<byte_type>& src)
+{
+    const size_t count = src.size() / get_pixel_size(SRC);
+    std::vector<byte_type> dst(count * get_pixel_size(DST));
+
+    const raw_pixel<SRC>* s = reinterpret_cast<const raw_pixel<SRC>*>(src.data());
+    raw_pixel<DST>* d = reinterpret_cast<raw_pixel<DST>*>(dst.data());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        d[i] = raw_pixel<DST>(static_cast<math::color>(s[i]));
+    }
+
+    return dst;
+}
+
+// a row holding every value of every byte, with a length that leaves a
+// tail for each vector width
+static std::vector<byte_type> make_row(size_t pixel_size, size_t count)
+{
+    std::vector<byte_type> row(count * pixel_size);
+
+    for (size_t i = 0; i < row.size(); ++i)
+    {
+        const size_t p = i / pixel_size;
+        const size_t c = i % pixel_size;
+        row[i] = static_cast<byte_type>((p >> (c * 2)) + p * (c * 2 + 1) + c * 37);
+    }
+
+    return row;
+}
+
+template <pixel_format SRC, pixel_format DST>
+static bool check_convert_row()
+{
+    // 65536 + 7 pixels covers every 16 bit pixel and leaves odd tails
+    const std::vector<byte_type> src = make_row(get_pixel_size(SRC), 65543);
+    const std::vector<byte_type> expected = reference_row<SRC, DST>(src);
+
+    // check every row length up to a few vector widths, so each loop and
+    // tail is used on its own
+    for (size_t count = 0; count < 40; ++count)
+    {
+        std::vector<byte_type> dst(count * get_pixel_size(DST));
+        raw::convert_row<SRC, DST>(src.data(), dst.data(), count);
+
+        if (!std::equal(dst.begin(), dst.end(), expected.begin()))
+        {
+            return false;
+        }
+    }
+
+    std::vector<byte_type> dst(expected.size());
+    raw::convert_row<SRC, DST>(src.data(), dst.data(), dst.size() / get_pixel_size(DST));
+    return dst == expected;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_convert_row)
+{
+    VX_SECTION("8888 swizzle")
+    {
+        VX_CHECK((check_convert_row<pixel_format::rgba_8888, pixel_format::bgra_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::bgra_8888, pixel_format::rgba_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgba_8888, pixel_format::argb_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::argb_8888, pixel_format::rgba_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::argb_8888, pixel_format::bgra_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::bgra_8888, pixel_format::argb_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgba_8888, pixel_format::abgr_8888>()));
+    }
+
+    VX_SECTION("8888 padding")
+    {
+        VX_CHECK((check_convert_row<pixel_format::rgbx_8888, pixel_format::rgba_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::xrgb_8888, pixel_format::bgra_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgba_8888, pixel_format::bgrx_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::argb_8888, pixel_format::xbgr_8888>()));
+    }
+
+    VX_SECTION("888 to 8888")
+    {
+        VX_CHECK((check_convert_row<pixel_format::rgb_8, pixel_format::rgba_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgb_8, pixel_format::bgra_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::bgr_8, pixel_format::argb_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgb_8, pixel_format::rgbx_8888>()));
+    }
+
+    VX_SECTION("565 to 8888")
+    {
+        VX_CHECK((check_convert_row<pixel_format::rgb_565, pixel_format::rgba_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgb_565, pixel_format::bgra_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::bgr_565, pixel_format::argb_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgb_565, pixel_format::xrgb_8888>()));
+    }
+
+    VX_SECTION("8888 to 565")
+    {
+        VX_CHECK((check_convert_row<pixel_format::rgba_8888, pixel_format::rgb_565>()));
+        VX_CHECK((check_convert_row<pixel_format::bgra_8888, pixel_format::rgb_565>()));
+        VX_CHECK((check_convert_row<pixel_format::argb_8888, pixel_format::bgr_565>()));
+        VX_CHECK((check_convert_row<pixel_format::rgbx_8888, pixel_format::rgb_565>()));
+    }
+
+    VX_SECTION("generic")
+    {
+        VX_CHECK((check_convert_row<pixel_format::rgba_4444, pixel_format::rgba_8888>()));
+        VX_CHECK((check_convert_row<pixel_format::rgba_8888, pixel_format::rgb_8>()));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// the blit as it was written before rows were converted at once
+template <pixel_format SRC, pixel_format DST>
+static void reference_blit(const surface<SRC>& src, const math::recti& src_area, surface<DST>& dst, const math::vec2i& dst_position)
+{
+    const math::vec2i shift = dst_position - src_area.position;
+
+    for (int y = src_area.position.y; y < src_area.bottom(); ++y)
+    {
+        for (int x = src_area.position.x; x < src_area.right(); ++x)
+        {
+            if (x >= 0 && y >= 0 && x < static_cast<int>(src.width()) && y < static_cast<int>(src.height()))
+            {
+                dst.set_pixel(x + shift.x, y + shift.y, src.get_pixel(x, y));
+            }
+        }
+    }
+}
+
+template <pixel_format SRC, pixel_format DST>
+static bool check_blit(const math::recti& src_area, const math::vec2i& dst_position)
+{
+    const std::vector<byte_type> data = make_row(get_pixel_size(SRC), 37 * 23);
+    const surface<SRC> src(data.data(), 37, 23);
+
+    const std::vector<byte_type> background = make_row(get_pixel_size(DST), 29 * 31);
+    surface<DST> expected(background.data(), 29, 31);
+    surface<DST> dst(background.data(), 29, 31);
+
+    reference_blit(src, src_area, expected, dst_position);
+
+    if (!blit(src, src_area, dst, dst_position))
+    {
+        return false;
+    }
+
+    return std::memcmp(dst.data(), expected.data(), dst.data_size()) == 0;
+}
+
+template <pixel_format SRC, pixel_format DST>
+static bool check_blit_clipping()
+{
+    const math::recti areas[] = {
+        math::recti(0, 0, 37, 23),
+        math::recti(3, 5, 11, 7),
+        math::recti(-4, -6, 20, 40),
+        math::recti(30, 20, 40, 40),
+        math::recti(40, 0, 5, 5)
+    };
+
+    const math::vec2i positions[] = {
+        math::vec2i(0, 0),
+        math::vec2i(5, 3),
+        math::vec2i(-7, -2),
+        math::vec2i(20, 25),
+        math::vec2i(-40, 0),
+        math::vec2i(29, 31)
+    };
+
+    for (const auto& area : areas)
+    {
+        for (const auto& position : positions)
+        {
+            if (!check_blit<SRC, DST>(area, position))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+VX_TEST_CASE(test_blit)
+{
+    VX_SECTION("same format")
+    {
+        VX_CHECK((check_blit_clipping<pixel_format::rgba_8888, pixel_format::rgba_8888>()));
+        VX_CHECK((check_blit_clipping<pixel_format::rgb_8, pixel_format::rgb_8>()));
+    }
+
+    VX_SECTION("converted")
+    {
+        VX_CHECK((check_blit_clipping<pixel_format::bgra_8888, pixel_format::rgba_8888>()));
+        VX_CHECK((check_blit_clipping<pixel_format::rgb_8, pixel_format::argb_8888>()));
+        VX_CHECK((check_blit_clipping<pixel_format::rgb_565, pixel_format::rgba_8888>()));
+        VX_CHECK((check_blit_clipping<pixel_format::rgba_8888, pixel_format::rgb_565>()));
+        VX_CHECK((check_blit_clipping<pixel_format::rgba_4444, pixel_format::rgb_8>()));
+    }
+
+    VX_SECTION("blend")
+    {
+        const std::vector<byte_type> data = make_row(4, 16 * 16);
+        const surface<pixel_format::rgba_8888> src(data.data(), 16, 16);
+        surface<pixel_format::rgba_8888> dst(8, 8);
+
+        const auto add = [](const math::color& s, const math::color& d) { return s + d; };
+        VX_CHECK(blit(src, math::recti(4, 4, 16, 16), dst, math::vec2i(-2, -2), add));
+
+        bool match = true;
+        for (size_t y = 0; y < 8; ++y)
+        {
+            for (size_t x = 0; x < 8; ++x)
+            {
+                match &= (dst.get_pixel(x, y) == src.get_pixel(x + 6, y + 6));
+            }
+        }
+
+        VX_CHECK(match);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
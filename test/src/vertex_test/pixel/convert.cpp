@@ -0,0 +1,210 @@
+#include <limits>
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/pixel/convert.hpp"
+#include "vertex/pixel/surface.hpp"
+#include "vertex/system/error.hpp"
+
+using namespace vx;
+using namespace vx::pixel;
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define _PIXEL_FORMATS(X) \
+    X(rgb_332) \
+    X(rgba_4444) X(bgra_4444) X(xrgb_4444) X(xbgr_4444) \
+    X(rgb_565) X(bgr_565) \
+    X(rgba_5551) X(bgra_5551) X(argb_1555) X(xrgb_1555) X(xbgr_1555) \
+    X(r_8) X(rg_8) X(rgb_8) X(bgr_8) \
+    X(rgba_8888) X(bgra_8888) X(argb_8888) X(abgr_8888) \
+    X(rgbx_8888) X(bgrx_8888) X(xrgb_8888) X(xbgr_8888) \
+    X(argb_2101010) X(abgr_2101010) X(xrgb_2101010) X(xbgr_2101010) \
+    X(rgba_8) X(bgra_8) X(abgr_8) \
+    X(r_16f) X(rg_16f) X(rgb_16f) X(rgba_16f) \
+    X(r_32f) X(rg_32f) X(rgb_32f) X(rgba_32f)
+
+static const pixel_format formats[] = {
+#define _ENTRY(F) pixel_format::F,
+    _PIXEL_FORMATS(_ENTRY)
+#undef _ENTRY
+};
+
+// converts every pixel the slow way, through a color
+template <pixel_format SRC, pixel_format DST>
+static void reference_convert(const byte_type* src, byte_type* dst, size_t count)
+{
+    const raw_pixel<SRC>* s = reinterpret_cast<const raw_pixel<SRC>*>(src);
+    raw_pixel<DST>* d = reinterpret_cast<raw_pixel<DST>*>(dst);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        d[i] = raw_pixel<DST>(static_cast<math::color>(s[i]));
+    }
+}
+
+using convert_fn = void(*)(const byte_type*, byte_type*, size_t);
+
+template <pixel_format SRC>
+static convert_fn get_reference(pixel_format dst_format)
+{
+    switch (dst_format)
+    {
+#define _CASE(F) case pixel_format::F: return reference_convert<SRC, pixel_format::F>;
+        _PIXEL_FORMATS(_CASE)
+#undef _CASE
+        default: return nullptr;
+    }
+}
+
+static convert_fn get_reference(pixel_format src_format, pixel_format dst_format)
+{
+    switch (src_format)
+    {
+#define _CASE(F) case pixel_format::F: return get_reference<pixel_format::F>(dst_format);
+        _PIXEL_FORMATS(_CASE)
+#undef _CASE
+        default: return nullptr;
+    }
+}
+
+#undef _PIXEL_FORMATS
+
+// Integer formats get every bit pattern of their first 16 bits. Float formats
+// get colors converted from such a row, so they hold values in [0, 1] rather
+// than nan or inf.
+static std::vector<byte_type> make_row(pixel_format format, size_t count)
+{
+    std::vector<byte_type> bytes(count * 4);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        const size_t p = i / 4;
+        bytes[i] = static_cast<byte_type>((i & 1) ? (p >> 8) * 7 + (i & 2) * 19 : p + (i & 2) * 11);
+    }
+
+    if (get_pixel_type(format) != pixel_type::float_array)
+    {
+        bytes.resize(count * get_pixel_size(format));
+        return bytes;
+    }
+
+    std::vector<byte_type> row(count * get_pixel_size(format));
+    get_reference(pixel_format::rgba_8888, format)(bytes.data(), row.data(), count);
+    return row;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_convert_pixels)
+{
+    // every 16 bit pattern, plus a tail for each vector width
+    const size_t count = 65536 + 13;
+    size_t failures = 0;
+
+    for (const pixel_format src_format : formats)
+    {
+        const std::vector<byte_type> src = make_row(src_format, count);
+
+        for (const pixel_format dst_format : formats)
+        {
+            std::vector<byte_type> expected(count * get_pixel_size(dst_format));
+            get_reference(src_format, dst_format)(src.data(), expected.data(), count);
+
+            // rows of the same format are copied, padding bits included
+            if (src_format == dst_format)
+            {
+                expected = src;
+            }
+
+            // short rows use only the scalar tails
+            for (size_t n : { count, size_t(1), size_t(7), size_t(21) })
+            {
+                std::vector<byte_type> dst(n * get_pixel_size(dst_format));
+                const span<const byte_type> s(src.data(), n * get_pixel_size(src_format));
+
+                if (!convert_pixels(src_format, dst_format, s, span<byte_type>(dst.data(), dst.size()))
+                    || !std::equal(dst.begin(), dst.end(), expected.begin()))
+                {
+                    ++failures;
+                    break;
+                }
+            }
+        }
+    }
+
+    VX_CHECK(failures == 0);
+}
+
+VX_TEST_CASE(test_convert_pixels_errors)
+{
+    byte_type src[16] = {};
+    byte_type dst[8] = {};
+
+    VX_CHECK_AND_EXPECT_ERROR(!convert_pixels(pixel_format::unknown, pixel_format::rgba_8888, span<const byte_type>(src, 16), span<byte_type>(dst, 8)));
+    VX_CHECK_AND_EXPECT_ERROR(!convert_pixels(pixel_format::rgba_8888, pixel_format::rgba_16f, span<const byte_type>(src, 16), span<byte_type>(dst, 8)));
+
+    VX_CHECK(convert_pixels(pixel_format::rgba_8888, pixel_format::rgb_565, span<const byte_type>(src, 16), span<byte_type>(dst, 8)));
+}
+
+VX_TEST_CASE(test_convert_half)
+{
+    // values that hit each branch of the half conversions
+    const float values[] = {
+        0.0f, -0.0f, 1.0f, -2.5f, 0.1f, 6.0e-5f, 1.0e-8f, -3.0e-6f,
+        65504.0f, 65519.0f, 65520.0f, 1.0e10f, -1.0e10f,
+        std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::quiet_NaN()
+    };
+
+    enum : size_t { count = sizeof(values) / sizeof(values[0]) / 4 };
+
+    math::half_t halfs[count * 4];
+    VX_CHECK(convert_pixels(pixel_format::rgba_32f, pixel_format::rgba_16f, span<const byte_type>(reinterpret_cast<const byte_type*>(values), sizeof(values)), span<byte_type>(reinterpret_cast<byte_type*>(halfs), sizeof(halfs))));
+
+    float floats[count * 4];
+    VX_CHECK(convert_pixels(pixel_format::rgba_16f, pixel_format::rgba_32f, span<const byte_type>(reinterpret_cast<const byte_type*>(halfs), sizeof(halfs)), span<byte_type>(reinterpret_cast<byte_type*>(floats), sizeof(floats))));
+
+    bool match = true;
+    for (size_t i = 0; i < count * 4; ++i)
+    {
+        const math::half_t h = math::half_from_float(values[i]);
+        const float f = math::half_to_float(h);
+
+        match &= (halfs[i] == h);
+        match &= (std::memcmp(&floats[i], &f, sizeof(float)) == 0);
+    }
+
+    VX_CHECK(match);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_surface_convert)
+{
+    const std::vector<byte_type> data = make_row(pixel_format::rgba_8888, 61 * 17);
+    const surface<pixel_format::rgba_8888> surf(data.data(), 61, 17);
+
+    const auto argb = surf.convert<pixel_format::argb_8888>();
+    const auto half = surf.convert<pixel_format::rgba_16f>();
+    const auto back = half.convert<pixel_format::rgba_8888>();
+
+    bool match = true;
+    for (size_t y = 0; y < 17; ++y)
+    {
+        for (size_t x = 0; x < 61; ++x)
+        {
+            match &= (argb.get_pixel(x, y) == surf.get_pixel(x, y));
+            match &= (std::memcmp(&back.at(x, y), &surf.at(x, y), 4) == 0);
+        }
+    }
+
+    VX_CHECK(match);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
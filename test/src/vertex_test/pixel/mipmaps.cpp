@@ -0,0 +1,238 @@
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/pixel/mipmaps.hpp"
+
+using namespace vx;
+using namespace vx::pixel;
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format F>
+static surface<F> make_surface(size_t width, size_t height)
+{
+    std::vector<byte_type> data(width * height * get_pixel_size(F));
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<byte_type>((i * 2654435761u) >> 11);
+    }
+
+    return surface<F>(data.data(), width, height);
+}
+
+// source pixels [first, last) covered by destination pixel i
+static void covered(size_t src_size, size_t i, size_t& first, size_t& last)
+{
+    first = i * 2;
+    last = (src_size == 1) ? 1 : (i == src_size / 2 - 1) ? src_size : first + 2;
+}
+
+// Reduces a level of a byte format one pixel at a time, averaging each byte
+// of the covered source pixels with rounding.
+static std::vector<byte_type> reference_reduce(const mipmap_level<pixel_format::rgba_8888>& level)
+{
+    const size_t w = raw::reduced_size(level.width());
+    const size_t h = raw::reduced_size(level.height());
+    std::vector<byte_type> out(w * h * 4);
+
+    for (size_t y = 0; y < h; ++y)
+    {
+        for (size_t x = 0; x < w; ++x)
+        {
+            size_t x0, x1, y0, y1;
+            covered(level.width(), x, x0, x1);
+            covered(level.height(), y, y0, y1);
+
+            const uint32_t n = static_cast<uint32_t>((x1 - x0) * (y1 - y0));
+
+            for (size_t b = 0; b < 4; ++b)
+            {
+                uint32_t sum = 0;
+
+                for (size_t sy = y0; sy < y1; ++sy)
+                {
+                    for (size_t sx = x0; sx < x1; ++sx)
+                    {
+                        sum += level.data()[(sy * level.width() + sx) * 4 + b];
+                    }
+                }
+
+                out[(y * w + x) * 4 + b] = static_cast<byte_type>((sum + n / 2) / n);
+            }
+        }
+    }
+
+    return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_mipmap_chain_layout)
+{
+    const auto surf = make_surface<pixel_format::rgba_8888>(13, 6);
+
+    VX_SECTION("full chain")
+    {
+        const auto chain = generate_mipmaps(surf);
+
+        VX_CHECK(chain.levels() == 4);
+        VX_CHECK(chain.level(0).size() == math::vec2i(13, 6));
+        VX_CHECK(chain.level(1).size() == math::vec2i(6, 3));
+        VX_CHECK(chain.level(2).size() == math::vec2i(3, 1));
+        VX_CHECK(chain.level(3).size() == math::vec2i(1, 1));
+
+        // one allocation with the levels back to back
+        size_t offset = 0;
+        for (size_t i = 0; i < chain.levels(); ++i)
+        {
+            VX_CHECK(chain.level_offset(i) == offset);
+            VX_CHECK(chain.level(i).data() == chain.data() + offset);
+            offset += chain.level(i).data_size();
+        }
+
+        VX_CHECK(chain.data_size() == offset);
+        VX_CHECK(chain.level(0).to_surface() == surf);
+    }
+
+    VX_SECTION("depth")
+    {
+        VX_CHECK(generate_mipmaps(surf, 0).levels() == 1);
+        VX_CHECK(generate_mipmaps(surf, 2).levels() == 3);
+        VX_CHECK(generate_mipmaps(surf, 100).levels() == 4);
+    }
+
+    VX_SECTION("empty")
+    {
+        VX_CHECK(generate_mipmaps(surface<pixel_format::rgba_8888>()).empty());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_mipmap_byte_formats)
+{
+    const math::vec2i sizes[] = {
+        math::vec2i(64, 64), math::vec2i(37, 23), math::vec2i(1, 9), math::vec2i(9, 1), math::vec2i(3, 3), math::vec2i(100, 7)
+    };
+
+    VX_SECTION("rgba_8888")
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            const auto chain = generate_mipmaps(make_surface<pixel_format::rgba_8888>(size.x, size.y));
+
+            bool match = true;
+            for (size_t i = 1; i < chain.levels(); ++i)
+            {
+                const std::vector<byte_type> expected = reference_reduce(chain.level(i - 1));
+                match &= (std::memcmp(chain.level(i).data(), expected.data(), expected.size()) == 0);
+            }
+
+            VX_CHECK(match);
+        }
+    }
+
+    // other byte formats use the same kernel for every byte, so they match
+    // rgba_8888 with the bytes regrouped
+    VX_SECTION("r_8")
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            const auto surf = make_surface<pixel_format::r_8>(size.x, size.y);
+            const auto chain = generate_mipmaps(surf);
+
+            bool match = true;
+            for (size_t i = 1; i < chain.levels(); ++i)
+            {
+                const mipmap_level<pixel_format::r_8> prev = chain.level(i - 1);
+
+                std::vector<byte_type> widened(prev.pixel_count() * 4);
+                for (size_t p = 0; p < prev.pixel_count(); ++p)
+                {
+                    widened[p * 4] = prev.data()[p];
+                }
+
+                const std::vector<byte_type> expected = reference_reduce(mipmap_level<pixel_format::rgba_8888>(
+                    reinterpret_cast<const raw_pixel<pixel_format::rgba_8888>*>(widened.data()), prev.width(), prev.height()));
+
+                for (size_t p = 0; p < chain.level(i).pixel_count(); ++p)
+                {
+                    match &= (chain.level(i).data()[p] == expected[p * 4]);
+                }
+            }
+
+            VX_CHECK(match);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_mipmap_color_formats)
+{
+    // a 2x2 average of exactly representable values is exact in float
+    surface<pixel_format::rgba_32f> surf(4, 2);
+    surf.set_pixel(0, 0, math::color(0.0f, 0.5f, 1.0f, 1.0f));
+    surf.set_pixel(1, 0, math::color(1.0f, 0.5f, 0.0f, 0.5f));
+    surf.set_pixel(0, 1, math::color(0.5f, 0.5f, 0.5f, 0.0f));
+    surf.set_pixel(1, 1, math::color(0.5f, 0.5f, 0.5f, 0.5f));
+
+    const auto chain = generate_mipmaps(surf);
+
+    VX_CHECK(chain.levels() == 3);
+    VX_CHECK(chain.level(1).get_pixel(0, 0) == math::color(0.5f, 0.5f, 0.5f, 0.5f));
+
+    // packed formats average decoded colors
+    const auto surf565 = make_surface<pixel_format::rgb_565>(6, 4);
+    const auto chain565 = generate_mipmaps(surf565);
+
+    const math::color expected = (
+        surf565.get_pixel(2, 2) + surf565.get_pixel(3, 2) +
+        surf565.get_pixel(2, 3) + surf565.get_pixel(3, 3)
+    ) / 4.0f;
+
+    VX_CHECK(chain565.level(1).at(1, 1).data == raw_pixel<pixel_format::rgb_565>(expected).data);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_mipmap_srgb)
+{
+    surface<pixel_format::rgba_8888> surf(2, 1);
+    surf.at(0, 0).data = 0x80000000;
+    surf.at(1, 0).data = 0xffffffff;
+
+    // black and white average to half the light, not half the value
+    const auto chain = generate_mipmaps(surf, -1, true);
+    VX_CHECK(chain.level(1).at(0, 0).data == 0xc0bcbcbc);
+
+    const auto plain = generate_mipmaps(surf);
+    VX_CHECK(plain.level(1).at(0, 0).data == 0xc0808080);
+
+    VX_SECTION("matches the float path")
+    {
+        const auto src = make_surface<pixel_format::rgba_8888>(32, 32);
+        const auto bytes = generate_mipmaps(src, 1, true);
+        const auto floats = generate_mipmaps(src.convert<pixel_format::rgba_32f>(), 1, true);
+
+        bool match = true;
+        for (size_t y = 0; y < 16; ++y)
+        {
+            for (size_t x = 0; x < 16; ++x)
+            {
+                const raw_pixel<pixel_format::rgba_8888> expected(floats.level(1).get_pixel(x, y));
+                match &= (bytes.level(1).at(x, y).data == expected.data);
+            }
+        }
+
+        VX_CHECK(match);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <string>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/pixel/blit.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// Times pixel::blit on a 4K surface, for a same format copy, for the format
+// pairs that have integer row converters, and for the built in blend modes.
+//
+// The baseline is the previous blit, which went through get_pixel and
+// set_pixel for every pixel, so each pixel was bounds checked, decoded to a
+// float color and encoded again even when both formats were the same. Blend
+// modes are compared against calling the same mode through a lambda, which
+// is how every blend function was run before.
+
+using namespace vx;
+using namespace vx::pixel;
+
+static constexpr size_t RR = 5; // number of repetitions
+
+enum : size_t
+{
+    width = 3840,
+    height = 2160
+};
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+//=========================================================================
+
+static std::vector<byte_type> make_pixels(size_t pixel_size)
+{
+    std::vector<byte_type> data(width * height * pixel_size);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<byte_type>(i * 2654435761u >> 13);
+    }
+
+    return data;
+}
+
+//=========================================================================
+// format conversion
+//=========================================================================
+
+template <pixel_format SRC, pixel_format DST>
+VX_NO_INLINE void profile_per_pixel_blit(const std::string& name, const surface<SRC>& src, surface<DST>& dst)
+{
+    start_timer("blit " + name + " (per pixel)");
+
+    for (size_t y = 0; y < src.height(); ++y)
+    {
+        for (size_t x = 0; x < src.width(); ++x)
+        {
+            dst.set_pixel(x, y, src.get_pixel(x, y));
+        }
+    }
+
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <pixel_format SRC, pixel_format DST>
+VX_NO_INLINE void profile_row_blit(const std::string& name, const surface<SRC>& src, surface<DST>& dst)
+{
+    start_timer("blit " + name + " (row)");
+    blit(src, dst, math::vec2i(0, 0));
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <pixel_format SRC, pixel_format DST>
+static void profile_blit(const char* name, size_t R)
+{
+    const std::vector<byte_type> data = make_pixels(get_pixel_size(SRC));
+    const surface<SRC> src(data.data(), width, height);
+    surface<DST> dst(width, height);
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        profile_per_pixel_blit(name, src, dst);
+        profile_row_blit(name, src, dst);
+    }
+}
+
+//=========================================================================
+// blend modes
+//=========================================================================
+
+template <typename MODE, pixel_format SRC, pixel_format DST>
+VX_NO_INLINE void profile_functor_blend(const std::string& name, const surface<SRC>& src, surface<DST>& dst)
+{
+    // the same mode through a lambda takes the per pixel functor path
+    const auto functor = [](const math::color& s, const math::color& d) { return MODE{}(s, d); };
+
+    start_timer("blend " + name + " (functor)");
+    blit(src, src.get_rect(), dst, math::vec2i(0, 0), functor);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <typename MODE, pixel_format SRC, pixel_format DST>
+VX_NO_INLINE void profile_mode_blend(const std::string& name, const surface<SRC>& src, surface<DST>& dst)
+{
+    start_timer("blend " + name + " (mode)");
+    blit(src, src.get_rect(), dst, math::vec2i(0, 0), MODE{});
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <typename MODE, pixel_format SRC, pixel_format DST>
+static void profile_blend(const char* name, size_t R)
+{
+    const std::vector<byte_type> data = make_pixels(get_pixel_size(SRC));
+    const surface<SRC> src(data.data(), width, height);
+    surface<DST> dst(width, height);
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        profile_functor_blend<MODE>(name, src, dst);
+        profile_mode_blend<MODE>(name, src, dst);
+    }
+}
+
+//=========================================================================
+
+static void run(size_t R)
+{
+    profile_blit<pixel_format::rgba_8888, pixel_format::rgba_8888>("rgba_8888 -> rgba_8888", R);
+    profile_blit<pixel_format::rgba_8888, pixel_format::bgra_8888>("rgba_8888 -> bgra_8888", R);
+    profile_blit<pixel_format::argb_8888, pixel_format::rgba_8888>("argb_8888 -> rgba_8888", R);
+    profile_blit<pixel_format::bgra_8888, pixel_format::argb_8888>("bgra_8888 -> argb_8888", R);
+    profile_blit<pixel_format::rgb_8, pixel_format::rgba_8888>("rgb_8 -> rgba_8888", R);
+    profile_blit<pixel_format::rgb_565, pixel_format::rgba_8888>("rgb_565 -> rgba_8888", R);
+    profile_blit<pixel_format::rgba_8888, pixel_format::rgb_565>("rgba_8888 -> rgb_565", R);
+    profile_blit<pixel_format::rgba_4444, pixel_format::rgba_8888>("rgba_4444 -> rgba_8888", R);
+
+    profile_blend<blend::src_over, pixel_format::rgba_8888, pixel_format::rgba_8888>("src_over", R);
+    profile_blend<blend::src_over_premultiplied, pixel_format::rgba_8888, pixel_format::rgba_8888>("src_over premultiplied", R);
+    profile_blend<blend::additive, pixel_format::rgba_8888, pixel_format::rgba_8888>("additive", R);
+    profile_blend<blend::multiply, pixel_format::rgba_8888, pixel_format::rgba_8888>("multiply", R);
+    profile_blend<blend::screen, pixel_format::rgba_8888, pixel_format::rgba_8888>("screen", R);
+    profile_blend<blend::src_over, pixel_format::bgra_8888, pixel_format::rgba_8888>("src_over bgra -> rgba", R);
+}
+
+int main()
+{
+    // warmup
+    run(1);
+
+    VX_PROFILE_START_APPEND("profile_blit.csv");
+
+    run(RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
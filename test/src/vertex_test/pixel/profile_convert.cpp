@@ -0,0 +1,109 @@
+#include <string>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/pixel/surface.hpp"
+#include "vertex/pixel/raw_convert.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// Times the row converters behind surface::convert on a 4K surface, for a
+// spread of format pairs covering each kind of row kernel. Both sides write
+// into the same destination so allocation is not measured.
+//
+// The baseline is the previous convert, which decoded every pixel to a float
+// color and encoded it again in the destination format.
+
+using namespace vx;
+using namespace vx::pixel;
+
+static constexpr size_t RR = 5; // number of repetitions
+
+enum : size_t
+{
+    width = 3840,
+    height = 2160
+};
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+//=========================================================================
+
+template <pixel_format SRC, pixel_format DST>
+VX_NO_INLINE void profile_per_pixel_convert(const std::string& name, const surface<SRC>& src, surface<DST>& dst)
+{
+    const raw_pixel<SRC>* s = reinterpret_cast<const raw_pixel<SRC>*>(src.data());
+    raw_pixel<DST>* d = reinterpret_cast<raw_pixel<DST>*>(dst.data());
+
+    start_timer("convert " + name + " (per pixel)");
+
+    for (size_t i = 0; i < src.pixel_count(); ++i)
+    {
+        d[i] = raw_pixel<DST>(static_cast<math::color>(s[i]));
+    }
+
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <pixel_format SRC, pixel_format DST>
+VX_NO_INLINE void profile_row_convert(const std::string& name, const surface<SRC>& src, surface<DST>& dst)
+{
+    start_timer("convert " + name + " (row)");
+    raw::convert_row<SRC, DST>(src.data(), dst.data(), src.pixel_count());
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <pixel_format SRC, pixel_format DST>
+static void profile_convert(const char* name, size_t R)
+{
+    // float sources are converted from bytes so they hold valid values
+    std::vector<byte_type> data(width * height * 4);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<byte_type>(i * 2654435761u >> 13);
+    }
+
+    const surface<SRC> src = surface<pixel_format::rgba_8888>(data.data(), width, height).convert<SRC>();
+    surface<DST> dst(width, height);
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        profile_per_pixel_convert(name, src, dst);
+        profile_row_convert(name, src, dst);
+    }
+}
+
+//=========================================================================
+
+static void run(size_t R)
+{
+    profile_convert<pixel_format::rgba_8888, pixel_format::bgra_8888>("rgba_8888 -> bgra_8888", R);
+    profile_convert<pixel_format::rgb_8, pixel_format::bgra_8888>("rgb_8 -> bgra_8888", R);
+    profile_convert<pixel_format::rgba_8888, pixel_format::rgb_8>("rgba_8888 -> rgb_8", R);
+    profile_convert<pixel_format::rgba_8, pixel_format::r_8>("rgba_8 -> r_8", R);
+    profile_convert<pixel_format::rgb_565, pixel_format::rgba_8888>("rgb_565 -> rgba_8888", R);
+    profile_convert<pixel_format::bgra_8888, pixel_format::rgb_565>("bgra_8888 -> rgb_565", R);
+    profile_convert<pixel_format::rgba_4444, pixel_format::argb_1555>("rgba_4444 -> argb_1555", R);
+    profile_convert<pixel_format::rgba_8888, pixel_format::argb_2101010>("rgba_8888 -> argb_2101010", R);
+    profile_convert<pixel_format::rgba_8888, pixel_format::rgba_32f>("rgba_8888 -> rgba_32f", R);
+    profile_convert<pixel_format::rgba_16f, pixel_format::rgba_8888>("rgba_16f -> rgba_8888", R);
+    profile_convert<pixel_format::rgba_32f, pixel_format::rgba_16f>("rgba_32f -> rgba_16f", R);
+}
+
+int main()
+{
+    // warmup
+    run(1);
+
+    VX_PROFILE_START_APPEND("profile_convert.csv");
+
+    run(RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
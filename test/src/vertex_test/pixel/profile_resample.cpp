@@ -0,0 +1,90 @@
+#include <string>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/pixel/surface_transform.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// Times downscaling an 8K surface to 1K with each resampling kernel, and
+// upscaling 1K to 4K. The whole 8K image is read for every kernel since
+// downscales stretch the kernel over all the source pixels.
+
+using namespace vx;
+using namespace vx::pixel;
+
+static constexpr size_t RR = 3; // number of repetitions
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+//=========================================================================
+
+template <pixel_format F>
+VX_NO_INLINE void profile_resize(const std::string& name, const surface<F>& src, const math::vec2i& size, filter_mode filter)
+{
+    start_timer(name);
+    auto dst = transform::resize(src, size, filter);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <pixel_format F>
+static void profile_filters(const char* format_name, size_t src_width, size_t src_height, size_t dst_width, size_t dst_height, size_t R)
+{
+    std::vector<byte_type> data(src_width * src_height * get_pixel_size(F));
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<byte_type>(i * 2654435761u >> 13);
+    }
+
+    const surface<F> src(data.data(), src_width, src_height);
+    const math::vec2i size(dst_width, dst_height);
+
+    const struct { filter_mode filter; const char* name; } filters[] = {
+        { filter_mode::box, "box" },
+        { filter_mode::linear, "linear" },
+        { filter_mode::cubic, "cubic" },
+        { filter_mode::mitchell, "mitchell" },
+        { filter_mode::lanczos3, "lanczos3" }
+    };
+
+    const std::string prefix = std::string("resize ") + format_name + ' '
+        + std::to_string(src_width) + 'x' + std::to_string(src_height) + " -> "
+        + std::to_string(dst_width) + 'x' + std::to_string(dst_height) + ' ';
+
+    for (const auto& f : filters)
+    {
+        const std::string name = prefix + f.name;
+
+        for (size_t r = 0; r < R; ++r)
+        {
+            profile_resize(name, src, size, f.filter);
+        }
+    }
+}
+
+//=========================================================================
+
+static void run(size_t R)
+{
+    profile_filters<pixel_format::rgba_8888>("rgba_8888", 7680, 4320, 1024, 576, R);
+    profile_filters<pixel_format::rgb_8>("rgb_8", 7680, 4320, 1024, 576, R);
+    profile_filters<pixel_format::rgba_8888>("rgba_8888", 1024, 576, 3840, 2160, R);
+    profile_filters<pixel_format::rgba_32f>("rgba_32f", 1920, 1080, 480, 270, R);
+}
+
+int main()
+{
+    // warmup
+    run(1);
+
+    VX_PROFILE_START_APPEND("profile_resample.csv");
+
+    run(RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/pixel/surface_transform.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// Times rotating an 8K surface with tiles compared to writing each source
+// row down a destination column, and a few operations with 1, 2, 4 and all
+// threads of a pool.
+
+using namespace vx;
+using namespace vx::pixel;
+
+static constexpr size_t RR = 3; // number of repetitions
+
+enum : size_t
+{
+    width = 7680,
+    height = 4320
+};
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+//=========================================================================
+
+static std::vector<byte_type> make_pixels(size_t pixel_size)
+{
+    std::vector<byte_type> data(width * height * pixel_size);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<byte_type>(i * 2654435761u >> 13);
+    }
+
+    return data;
+}
+
+//=========================================================================
+// rotate
+//=========================================================================
+
+// one source row at a time, every pixel written to a different row
+VX_NO_INLINE void profile_rotate_strided(const std::string& name, const byte_type* src, byte_type* dst, size_t pixel_size)
+{
+    start_timer("rotate_90_cw " + name + " (strided)");
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        const byte_type* srcrow = &src[width * y * pixel_size];
+        byte_type* dstcol = &dst[(height - y - 1) * pixel_size];
+
+        for (size_t x = 0; x < width; ++x)
+        {
+            std::memcpy(&dstcol[x * height * pixel_size], &srcrow[x * pixel_size], pixel_size);
+        }
+    }
+
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+VX_NO_INLINE void profile_rotate_tiled(const std::string& name, const byte_type* src, byte_type* dst, size_t pixel_size)
+{
+    start_timer("rotate_90_cw " + name + " (tiled)");
+    raw::rotate_90_cw(src, width, height, dst, pixel_size);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+template <pixel_format F>
+static void profile_rotate(const char* name, size_t R)
+{
+    const size_t pixel_size = get_pixel_size(F);
+
+    const std::vector<byte_type> src = make_pixels(pixel_size);
+    std::vector<byte_type> dst(src.size());
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        profile_rotate_strided(name, src.data(), dst.data(), pixel_size);
+        profile_rotate_tiled(name, src.data(), dst.data(), pixel_size);
+    }
+}
+
+//=========================================================================
+// threads
+//=========================================================================
+
+VX_NO_INLINE void profile_parallel_rotate(const std::string& name, const surface<pixel_format::rgba_8888>& src, const execution_policy& policy)
+{
+    start_timer("rotate_90_cw " + name);
+    auto dst = transform::rotate_90_cw(src, policy);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+VX_NO_INLINE void profile_parallel_flip(const std::string& name, const surface<pixel_format::rgba_8888>& src, const execution_policy& policy)
+{
+    start_timer("flip_x " + name);
+    auto dst = transform::flip_x(src, policy);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+VX_NO_INLINE void profile_parallel_downscale(const std::string& name, const surface<pixel_format::rgba_8888>& src, const execution_policy& policy)
+{
+    start_timer("lanczos3 down " + name);
+    auto dst = transform::resize(src, math::vec2i(1024, 576), filter_mode::lanczos3, policy);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+VX_NO_INLINE void profile_parallel_upscale(const std::string& name, const surface<pixel_format::rgba_8888>& src, const execution_policy& policy)
+{
+    start_timer("linear up " + name);
+    auto dst = transform::resize(src, math::vec2i(width + width / 2, height + height / 2), filter_mode::linear, policy);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+static void profile_threads(os::thread_pool& pool, size_t R)
+{
+    const std::vector<byte_type> data = make_pixels(4);
+    const surface<pixel_format::rgba_8888> src(data.data(), width, height);
+
+    const size_t thread_counts[] = { 1, 2, 4, 0 };
+
+    for (const size_t threads : thread_counts)
+    {
+        const execution_policy policy = execution_policy::parallel(pool, threads);
+        const std::string name = threads ? "(" + std::to_string(threads) + " threads)" : std::string("(all threads)");
+
+        for (size_t r = 0; r < R; ++r)
+        {
+            profile_parallel_rotate(name, src, policy);
+            profile_parallel_flip(name, src, policy);
+            profile_parallel_downscale(name, src, policy);
+            profile_parallel_upscale(name, src, policy);
+        }
+    }
+}
+
+//=========================================================================
+
+static void run(os::thread_pool& pool, size_t R)
+{
+    profile_rotate<pixel_format::r_8>("r_8", R);
+    profile_rotate<pixel_format::rgba_8888>("rgba_8888", R);
+    profile_rotate<pixel_format::rgba_32f>("rgba_32f", R);
+
+    profile_threads(pool, R);
+}
+
+int main()
+{
+    os::thread_pool pool;
+
+    // warmup
+    run(pool, 1);
+
+    VX_PROFILE_START_APPEND("profile_transform.csv");
+
+    run(pool, RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
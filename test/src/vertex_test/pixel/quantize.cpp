@@ -0,0 +1,284 @@
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/pixel/quantize.hpp"
+
+using namespace vx;
+using namespace vx::pixel;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t next_random(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+}
+
+// smooth color gradients with some noise, far more colors than a palette
+static surface<pixel_format::rgba_8> make_photo(size_t width, size_t height)
+{
+    surface<pixel_format::rgba_8> surf(width, height);
+    uint32_t seed = 7;
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            uint8_t* px = surf.at(x, y).data;
+            px[0] = static_cast<uint8_t>(x * 255 / width);
+            px[1] = static_cast<uint8_t>(y * 255 / height);
+            px[2] = static_cast<uint8_t>(((x + y) * 2 + next_random(seed) % 8) & 0xff);
+            px[3] = 255;
+        }
+    }
+
+    return surf;
+}
+
+static size_t linear_closest(const std::vector<uint8_t>& colors, const int32_t* q)
+{
+    size_t best = 0;
+    int32_t best_distance = INT32_MAX;
+
+    for (size_t i = 0; i < colors.size() / 4; ++i)
+    {
+        int32_t d = 0;
+        for (size_t c = 0; c < 4; ++c)
+        {
+            const int32_t e = q[c] - colors[i * 4 + c];
+            d += e * e;
+        }
+
+        if (d < best_distance)
+        {
+            best_distance = d;
+            best = i;
+        }
+    }
+
+    return best;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_palette_tree)
+{
+    uint32_t seed = 1;
+
+    for (const size_t count : { size_t(1), size_t(2), size_t(9), size_t(64), size_t(256) })
+    {
+        std::vector<uint8_t> colors(count * 4);
+        for (uint8_t& c : colors)
+        {
+            // few distinct values, so there are duplicates and ties
+            c = static_cast<uint8_t>((next_random(seed) % 6) * 51);
+        }
+
+        const raw::palette_tree tree(colors.data(), count);
+        VX_CHECK(tree.size() == count);
+
+        bool same = true;
+
+        for (size_t i = 0; i < 2000; ++i)
+        {
+            const int32_t q[4] = {
+                static_cast<int32_t>(next_random(seed) % 256),
+                static_cast<int32_t>(next_random(seed) % 256),
+                static_cast<int32_t>(next_random(seed) % 256),
+                static_cast<int32_t>(next_random(seed) % 256)
+            };
+
+            same &= (tree.find_closest(q) == linear_closest(colors, q));
+        }
+
+        VX_CHECK(same);
+    }
+
+    VX_SECTION("lookup")
+    {
+        const palette pal = { math::color(0, 0, 0, 1), math::color(1, 1, 1, 1), math::color(1, 0, 0, 1) };
+        const quantize::palette_lookup lookup(pal);
+
+        size_t index = 99;
+        VX_CHECK(lookup.find_closest(math::color(0.9f, 0.1f, 0.2f, 1.0f), &index) && index == 2);
+        VX_CHECK(lookup.find_closest(math::color(0.8f, 0.8f, 0.7f, 1.0f), &index) && index == 1);
+        VX_CHECK(!quantize::palette_lookup().find_closest(math::color(), &index));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_generate_palette)
+{
+    VX_SECTION("few colors")
+    {
+        surface<pixel_format::rgba_8> surf(16, 16);
+        for (size_t y = 0; y < 16; ++y)
+        {
+            for (size_t x = 0; x < 16; ++x)
+            {
+                surf.set_pixel(x, y, ((x / 4 + y / 4) % 3 == 0) ? math::color(1, 0, 0, 1) : math::color(0, 0, 1, 0.5f));
+            }
+        }
+
+        const palette pal = quantize::generate_palette(surf, 16);
+        VX_CHECK(pal.size() == 2);
+        VX_CHECK(pal.has_color(surf.get_pixel(0, 0)));
+        VX_CHECK(pal.has_color(surf.get_pixel(4, 0)));
+    }
+
+    VX_SECTION("median cut")
+    {
+        const auto surf = make_photo(300, 200);
+        double last_error = 1.0;
+
+        for (const size_t count : { size_t(2), size_t(16), size_t(256) })
+        {
+            const palette pal = quantize::generate_palette(surf, count);
+            VX_CHECK(pal.size() == count);
+
+            // more entries fit the image more closely
+            const auto out = quantize::remap<palette_format::index_8>(surf, pal);
+            double error = 0.0;
+
+            for (size_t y = 0; y < surf.height(); ++y)
+            {
+                for (size_t x = 0; x < surf.width(); ++x)
+                {
+                    error += math::distance_squared(surf.get_pixel(x, y), out.get_pixel(x, y));
+                }
+            }
+
+            error /= static_cast<double>(surf.pixel_count());
+            VX_CHECK(error < last_error);
+            last_error = error;
+        }
+
+        // a uniform 6x6x6 cube would be about 0.01
+        VX_CHECK(last_error < 0.005);
+    }
+
+    VX_CHECK(quantize::generate_palette(make_photo(4, 4), 0).empty());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_remap)
+{
+    const auto surf = make_photo(123, 45);
+    const palette pal = quantize::generate_palette(surf, 40);
+
+    VX_SECTION("closest")
+    {
+        const auto out = quantize::remap<palette_format::index_8>(surf, pal);
+        VX_CHECK(out.get_palette().size() == pal.size());
+
+        bool same = true;
+        for (size_t y = 0; y < surf.height(); ++y)
+        {
+            for (size_t x = 0; x < surf.width(); ++x)
+            {
+                // the linear search compares floats, so ties may go either way
+                size_t index = 0;
+                const math::color c = surf.get_pixel(x, y);
+                pal.find_closest(c, &index);
+                same &= (math::distance_squared(c, out.get_pixel(x, y)) <= math::distance_squared(c, pal[index]) + 1e-6f);
+            }
+        }
+
+        VX_CHECK(same);
+    }
+
+    VX_SECTION("packed indices")
+    {
+        const palette bw = { math::color(0, 0, 0, 1), math::color(1, 1, 1, 1), math::color(1, 0, 0, 1) };
+        const auto out8 = quantize::remap<palette_format::index_8>(surf, bw, dither_mode::floyd_steinberg);
+        const auto out1 = quantize::remap<palette_format::index_1_lsb>(surf, bw, dither_mode::floyd_steinberg);
+        const auto out2 = quantize::remap<palette_format::index_2_lsb>(surf, bw, dither_mode::floyd_steinberg);
+
+        // only two entries fit in 1 bit
+        VX_CHECK(out1.get_palette().size() == 2);
+        VX_CHECK(out2.get_palette().size() == 3);
+
+        bool same = true;
+        for (size_t y = 0; y < surf.height(); ++y)
+        {
+            for (size_t x = 0; x < surf.width(); ++x)
+            {
+                same &= (out2.get_pixel_index(x, y) == out8.get_pixel_index(x, y));
+                same &= (out1.get_pixel_index(x, y) < 2);
+            }
+        }
+
+        VX_CHECK(same);
+    }
+
+    VX_SECTION("dithering keeps the mean")
+    {
+        surface<pixel_format::rgba_8> gray(64, 64);
+        for (size_t i = 0; i < gray.pixel_count(); ++i)
+        {
+            const uint8_t px[4] = { 64, 64, 64, 255 };
+            std::memcpy(gray.data() + i * 4, px, 4);
+        }
+
+        const palette bw = { math::color(0, 0, 0, 1), math::color(1, 1, 1, 1) };
+
+        for (const dither_mode dither : { dither_mode::ordered, dither_mode::floyd_steinberg })
+        {
+            const auto out = quantize::remap<palette_format::index_8>(gray, bw, dither);
+
+            size_t white = 0;
+            for (size_t i = 0; i < out.data_size(); ++i)
+            {
+                white += out.data()[i];
+            }
+
+            // a quarter of the pixels are white
+            VX_CHECK(white > 900 && white < 1150);
+        }
+
+        VX_CHECK(quantize::remap<palette_format::index_8>(gray, bw).data()[0] == 0);
+    }
+
+    VX_SECTION("empty palette")
+    {
+        const auto out = quantize::remap<palette_format::index_8>(surf, palette());
+        VX_CHECK(out.width() == surf.width() && out.data()[0] == 0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_remap_parallel)
+{
+    os::thread_pool pool(3);
+
+    // big enough to be split into several bands
+    const auto surf = make_photo(700, 300);
+    const palette pal = quantize::generate_palette(surf, 64);
+
+    const execution_policy policies[] = {
+        execution_policy::parallel(pool),
+        execution_policy::parallel(pool, 2)
+    };
+
+    for (const dither_mode dither : { dither_mode::none, dither_mode::ordered, dither_mode::floyd_steinberg })
+    {
+        const auto expected = quantize::remap<palette_format::index_8>(surf, pal, dither);
+
+        for (const execution_policy& policy : policies)
+        {
+            const auto out = quantize::remap<palette_format::index_8>(surf, pal, dither, policy);
+            VX_CHECK(std::memcmp(out.data(), expected.data(), out.data_size()) == 0);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,235 @@
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/pixel/surface_transform.hpp"
+#include "vertex/pixel/sampler.hpp"
+#include "vertex/pixel/raw_mipmap.hpp"
+
+using namespace vx;
+using namespace vx::pixel;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const filter_mode kernels[] = {
+    filter_mode::linear,
+    filter_mode::box,
+    filter_mode::cubic,
+    filter_mode::mitchell,
+    filter_mode::lanczos3
+};
+
+static const math::vec2i sizes[] = {
+    math::vec2i(37, 23),    // down
+    math::vec2i(211, 97),   // up
+    math::vec2i(64, 200),   // down and up
+    math::vec2i(1, 1)
+};
+
+// smooth content with some detail, so kernels with negative lobes ring a
+// little but stay in range most of the time
+static surface<pixel_format::rgba_8888> make_surface(size_t width, size_t height)
+{
+    surface<pixel_format::rgba_8888> surf(width, height);
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        for (size_t x = 0; x < width; ++x)
+        {
+            surf.at(x, y).data = static_cast<uint32_t>(
+                ((x * 255 / width) << 0) |
+                ((y * 255 / height) << 8) |
+                (((x * 7 + y * 3) & 0xff) << 16) |
+                (((x ^ y) & 1) ? 0xc0000000u : 0xff000000u)
+            );
+        }
+    }
+
+    return surf;
+}
+
+static int max_error(const surface<pixel_format::rgba_8888>& a, const surface<pixel_format::rgba_8888>& b)
+{
+    int error = 0;
+
+    for (size_t i = 0; i < a.data_size(); ++i)
+    {
+        const int d = static_cast<int>(a.data()[i]) - static_cast<int>(b.data()[i]);
+        error = math::max(error, (d < 0) ? -d : d);
+    }
+
+    return error;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_contribution_table)
+{
+    for (const filter_mode filter : kernels)
+    {
+        for (const size_t src_size : { size_t(1), size_t(7), size_t(64), size_t(1000) })
+        {
+            for (const size_t dst_size : { size_t(1), size_t(5), size_t(64), size_t(333) })
+            {
+                const filter::contribution_table table(src_size, dst_size, filter::get_resample_kernel(filter));
+
+                bool valid = (table.size() == dst_size);
+
+                for (size_t i = 0; i < table.size(); ++i)
+                {
+                    float sum = 0.0f;
+                    int32_t fixed_sum = 0;
+
+                    for (size_t k = 0; k < table.count(i); ++k)
+                    {
+                        sum += table.weights(i)[k];
+                        fixed_sum += table.fixed_weights(i)[k];
+                    }
+
+                    valid &= (table.count(i) >= 1 && table.count(i) <= table.max_count());
+                    valid &= (table.first(i) + table.count(i) <= src_size);
+                    valid &= (math::abs(sum - 1.0f) < 1e-4f);
+                    valid &= (fixed_sum == (1 << filter::contribution_table::precision_bits));
+                }
+
+                VX_CHECK(valid);
+            }
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_resample_constant)
+{
+    // weights sum to one, so a flat image stays flat for every kernel
+    surface<pixel_format::rgba_8888> bytes(50, 30);
+    bytes.fill(math::color(0.2f, 0.4f, 0.6f, 0.8f));
+
+    surface<pixel_format::rgb_565> packed(50, 30);
+    packed.fill(math::color(0.2f, 0.4f, 0.6f));
+
+    for (const filter_mode filter : kernels)
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            const auto a = transform::resize(bytes, size, filter);
+            const auto b = transform::resize(packed, size, filter);
+
+            bool flat = true;
+            for (size_t y = 0; y < a.height(); ++y)
+            {
+                for (size_t x = 0; x < a.width(); ++x)
+                {
+                    flat &= (a.at(x, y).data == bytes.at(0, 0).data);
+                    flat &= (b.at(x, y).data == packed.at(0, 0).data);
+                }
+            }
+
+            VX_CHECK(flat);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_resample_fixed_point)
+{
+    // the 8 bit kernels round twice, the float path once
+    const auto surf = make_surface(120, 80);
+    const auto floats = surf.convert<pixel_format::rgba_32f>();
+
+    for (const filter_mode filter : kernels)
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            const auto a = transform::resize(surf, size, filter);
+            const auto b = transform::resize(floats, size, filter).convert<pixel_format::rgba_8888>();
+
+            VX_CHECK(max_error(a, b) <= 1);
+        }
+    }
+}
+
+VX_TEST_CASE(test_resample_box)
+{
+    const auto surf = make_surface(64, 48);
+
+    VX_SECTION("halving matches the 2x2 reduction")
+    {
+        surface<pixel_format::rgba_8888> expected(32, 24);
+        raw::reduce_2x2<pixel_format::rgba_8888>(surf.data(), 64, 48, expected.data());
+
+        VX_CHECK(max_error(transform::resize(surf, math::vec2i(32, 24), filter_mode::box), expected) <= 1);
+    }
+
+    VX_SECTION("downscales are prefiltered")
+    {
+        // a one pixel checkerboard averages to gray instead of aliasing
+        surface<pixel_format::r_8> checker(64, 64);
+        for (size_t y = 0; y < 64; ++y)
+        {
+            for (size_t x = 0; x < 64; ++x)
+            {
+                checker.at(x, y).data[0] = ((x ^ y) & 1) ? 255 : 0;
+            }
+        }
+
+        const auto small = transform::resize(checker, math::vec2i(16, 16));
+
+        bool gray = true;
+        for (size_t i = 0; i < small.data_size(); ++i)
+        {
+            gray &= (small.data()[i] == 127 || small.data()[i] == 128);
+        }
+
+        VX_CHECK(gray);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_sampler_kernels)
+{
+    const auto surf = make_surface(16, 16);
+
+    sampler s;
+    s.xwrap = wrap_mode::clamp_to_edge;
+    s.ywrap = wrap_mode::clamp_to_edge;
+
+    // interpolating kernels give back the pixel at its center
+    for (const filter_mode filter : { filter_mode::linear, filter_mode::cubic, filter_mode::lanczos3 })
+    {
+        s.mag_filter = filter;
+
+        bool match = true;
+        for (size_t y = 0; y < 16; ++y)
+        {
+            for (size_t x = 0; x < 16; ++x)
+            {
+                const math::color c = s.sample(surf, (x + 0.5f) / 16.0f, (y + 0.5f) / 16.0f);
+                match &= (raw_pixel<pixel_format::rgba_8888>(c).data == surf.at(x, y).data);
+            }
+        }
+
+        VX_CHECK(match);
+    }
+
+    // At half resolution each sample covers 2x2 pixels, which the box kernel
+    // averages. Coordinates are scaled by the resolution too, so this sample
+    // is centered on pixel corner (2, 2).
+    s.resolution = math::vec2(0.5f);
+    s.min_filter = filter_mode::box;
+
+    const math::color c = s.sample(surf, 1.0f / 16.0f, 1.0f / 16.0f);
+    const math::color expected = (surf.get_pixel(1, 1) + surf.get_pixel(2, 1) + surf.get_pixel(1, 2) + surf.get_pixel(2, 2)) / 4.0f;
+
+    VX_CHECK(raw_pixel<pixel_format::rgba_8888>(c).data == raw_pixel<pixel_format::rgba_8888>(expected).data);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
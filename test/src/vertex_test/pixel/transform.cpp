@@ -0,0 +1,267 @@
+#include <vector>
+
+#include "vertex_test/test.hpp"
+#include "vertex/pixel/surface_transform.hpp"
+#include "vertex/pixel/filter/filter_bilinear.hpp"
+#include "vertex/pixel/filter/filter_bicubic.hpp"
+#include "vertex/pixel/filter/filter_box.hpp"
+
+using namespace vx;
+using namespace vx::pixel;
+
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format F>
+static surface<F> make_surface(size_t width, size_t height)
+{
+    std::vector<byte_type> data(width * height * get_pixel_size(F));
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<byte_type>((i * 2654435761u) >> 11);
+    }
+
+    return surface<F>(data.data(), width, height);
+}
+
+// compares the raw pixels, so no format conversion can hide a difference
+template <pixel_format F>
+static bool same_pixel(const surface<F>& a, size_t ax, size_t ay, const surface<F>& b, size_t bx, size_t by)
+{
+    return std::memcmp(&a.at(ax, ay), &b.at(bx, by), get_pixel_size(F)) == 0;
+}
+
+// Checks every transform against its definition one pixel at a time.
+template <pixel_format F>
+static bool check_transforms(size_t w, size_t h)
+{
+    const surface<F> surf = make_surface<F>(w, h);
+    bool match = true;
+
+    const surface<F> fx = transform::flip_x(surf);
+    const surface<F> fy = transform::flip_y(surf);
+    const surface<F> cw = transform::rotate_90_cw(surf);
+    const surface<F> ccw = transform::rotate_90_ccw(surf);
+    const surface<F> r180 = transform::rotate_180(surf);
+
+    match &= (cw.width() == h && cw.height() == w);
+    match &= (ccw.width() == h && ccw.height() == w);
+    match &= (transform::copy(surf) == surf);
+
+    for (size_t y = 0; y < h; ++y)
+    {
+        for (size_t x = 0; x < w; ++x)
+        {
+            match &= same_pixel(fx, w - x - 1, y, surf, x, y);
+            match &= same_pixel(fy, x, h - y - 1, surf, x, y);
+            match &= same_pixel(cw, h - y - 1, x, surf, x, y);
+            match &= same_pixel(ccw, y, w - x - 1, surf, x, y);
+            match &= same_pixel(r180, w - x - 1, h - y - 1, surf, x, y);
+        }
+    }
+
+    return match;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_transform_reference)
+{
+    // sizes around the rotation tiles, which are 32 pixels for 4 byte
+    // pixels, 64 for 1 byte and 8 for 16 byte pixels
+    const math::vec2i sizes[] = {
+        math::vec2i(1, 1), math::vec2i(7, 5), math::vec2i(32, 32), math::vec2i(33, 65),
+        math::vec2i(100, 3), math::vec2i(3, 100), math::vec2i(129, 70)
+    };
+
+    VX_SECTION("rgba_8888")
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            VX_CHECK(check_transforms<pixel_format::rgba_8888>(size.x, size.y));
+        }
+    }
+
+    VX_SECTION("r_8")
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            VX_CHECK(check_transforms<pixel_format::r_8>(size.x, size.y));
+        }
+    }
+
+    VX_SECTION("rgb_8")
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            VX_CHECK(check_transforms<pixel_format::rgb_8>(size.x, size.y));
+        }
+    }
+
+    VX_SECTION("rgba_32f")
+    {
+        for (const math::vec2i& size : sizes)
+        {
+            VX_CHECK(check_transforms<pixel_format::rgba_32f>(size.x, size.y));
+        }
+    }
+
+    VX_SECTION("in place")
+    {
+        const auto surf = make_surface<pixel_format::rgb_8>(45, 31);
+
+        auto data = surf;
+        VX_CHECK(raw::flip_x(data.data(), data.width(), data.height(), data.pixel_size()));
+        VX_CHECK(data == transform::flip_x(surf));
+
+        data = surf;
+        VX_CHECK(raw::flip_y(data.data(), data.width(), data.height(), data.pixel_size()));
+        VX_CHECK(data == transform::flip_y(surf));
+
+        data = surf;
+        VX_CHECK(raw::rotate_180(data.data(), data.width(), data.height(), data.pixel_size()));
+        VX_CHECK(data == transform::rotate_180(surf));
+
+        data = surf;
+        VX_CHECK(raw::rotate_90_cw(data.data(), data.width(), data.height(), data.pixel_size()));
+        VX_CHECK(std::memcmp(data.data(), transform::rotate_90_cw(surf).data(), data.data_size()) == 0);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_transform_crop_and_canvas)
+{
+    const auto surf = make_surface<pixel_format::rgba_8888>(20, 10);
+
+    VX_SECTION("crop")
+    {
+        const auto out = transform::crop(surf, math::recti(15, 4, 10, 3));
+        VX_CHECK(out.width() == 5 && out.height() == 3);
+
+        bool match = true;
+        for (size_t y = 0; y < out.height(); ++y)
+        {
+            for (size_t x = 0; x < out.width(); ++x)
+            {
+                match &= same_pixel(out, x, y, surf, x + 15, y + 4);
+            }
+        }
+
+        VX_CHECK(match);
+    }
+
+    VX_SECTION("resize canvas")
+    {
+        const math::color fill(1.0f, 0.0f, 0.0f, 1.0f);
+        const math::vec2i offsets[] = {
+            math::vec2i(0, 0), math::vec2i(5, 3), math::vec2i(-4, -2), math::vec2i(30, 0), math::vec2i(-3, 20)
+        };
+
+        for (const math::vec2i& offset : offsets)
+        {
+            const auto out = transform::resize_canvas(surf, math::vec2i(24, 12), offset, fill);
+
+            bool match = true;
+            for (int y = 0; y < 12; ++y)
+            {
+                for (int x = 0; x < 24; ++x)
+                {
+                    const int sx = x - offset.x;
+                    const int sy = y - offset.y;
+
+                    if (sx >= 0 && sy >= 0 && sx < 20 && sy < 10)
+                    {
+                        match &= same_pixel(out, x, y, surf, sx, sy);
+                    }
+                    else
+                    {
+                        match &= (out.get_pixel(x, y) == fill);
+                    }
+                }
+            }
+
+            VX_CHECK(match);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_transform_parallel)
+{
+    os::thread_pool pool(3);
+
+    // big enough to be split into several bands
+    const auto surf = make_surface<pixel_format::rgba_8888>(1024, 300);
+    const auto floats = make_surface<pixel_format::rgba_32f>(300, 200);
+
+    const execution_policy policies[] = {
+        execution_policy::parallel(pool),
+        execution_policy::parallel(pool, 2)
+    };
+
+    VX_CHECK(execution_policy().mode() == execution_mode::sequential);
+    VX_CHECK(execution_policy::parallel(pool, 1).mode() == execution_mode::sequential);
+    VX_CHECK(policies[0].thread_count() == pool.worker_count() + 1);
+    VX_CHECK(policies[1].thread_count() == 2);
+
+    for (const execution_policy& policy : policies)
+    {
+        VX_SECTION("transforms")
+        {
+            VX_CHECK(transform::copy(surf, policy) == surf);
+            VX_CHECK(transform::flip_x(surf, policy) == transform::flip_x(surf));
+            VX_CHECK(transform::flip_y(surf, policy) == transform::flip_y(surf));
+            VX_CHECK(transform::rotate_90_cw(surf, policy) == transform::rotate_90_cw(surf));
+            VX_CHECK(transform::rotate_90_ccw(surf, policy) == transform::rotate_90_ccw(surf));
+            VX_CHECK(transform::rotate_180(surf, policy) == transform::rotate_180(surf));
+            VX_CHECK(transform::crop(surf, math::recti(100, 7, 900, 250), policy) == transform::crop(surf, math::recti(100, 7, 900, 250)));
+
+            const math::vec2i size(1100, 320);
+            const math::vec2i offset(-13, 9);
+            VX_CHECK(transform::resize_canvas(surf, size, offset, math::color(0.5f), policy) == transform::resize_canvas(surf, size, offset, math::color(0.5f)));
+        }
+
+        VX_SECTION("resize")
+        {
+            const filter_mode filters[] = {
+                filter_mode::nearest, filter_mode::linear, filter_mode::box,
+                filter_mode::cubic, filter_mode::mitchell, filter_mode::lanczos3
+            };
+
+            for (const filter_mode filter : filters)
+            {
+                VX_CHECK(transform::resize(surf, math::vec2i(333, 97), filter, policy) == transform::resize(surf, math::vec2i(333, 97), filter));
+                VX_CHECK(transform::resize(surf, math::vec2i(1500, 700), filter, policy) == transform::resize(surf, math::vec2i(1500, 700), filter));
+                VX_CHECK(transform::resize(floats, math::vec2i(700, 450), filter, policy) == transform::resize(floats, math::vec2i(700, 450), filter));
+            }
+        }
+
+        VX_SECTION("filters")
+        {
+            const size_t w = 1500;
+            const size_t h = 700;
+            std::vector<byte_type> a(w * h * 4), b(w * h * 4);
+
+            filter::filter_bilinear<uint8_t>(surf.data(), surf.width(), surf.height(), a.data(), w, h, 4);
+            filter::filter_bilinear<uint8_t>(surf.data(), surf.width(), surf.height(), b.data(), w, h, 4, policy);
+            VX_CHECK(a == b);
+
+            filter::filter_bicubic<uint8_t>(surf.data(), surf.width(), surf.height(), a.data(), w, h, 4);
+            filter::filter_bicubic<uint8_t>(surf.data(), surf.width(), surf.height(), b.data(), w, h, 4, policy);
+            VX_CHECK(a == b);
+
+            filter::filter_box<uint8_t>(surf.data(), surf.width(), surf.height(), a.data(), w, h, 4);
+            filter::filter_box<uint8_t>(surf.data(), surf.width(), surf.height(), b.data(), w, h, 4, policy);
+            VX_CHECK(a == b);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
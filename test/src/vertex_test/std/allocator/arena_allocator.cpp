@@ -0,0 +1,247 @@
+#include "vertex/std/memory.hpp"
+#include "vertex/std/packed_string_array.hpp"
+#include "vertex/std/string.hpp"
+#include "vertex/std/vector.hpp"
+#include "vertex_test/test.hpp"
+
+using namespace vx;
+
+//=============================================================================
+
+static bool is_aligned(const void* ptr, size_t alignment)
+{
+    return (reinterpret_cast<uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
+
+//=============================================================================
+
+VX_TEST_CASE(arena_basics)
+{
+    mem::arena a(256);
+
+    VX_SECTION("empty")
+    {
+        VX_CHECK(a.stats().bytes_in_use == 0);
+        VX_CHECK(a.stats().bytes_reserved == 0);
+        VX_CHECK(a.allocate(0) == nullptr);
+    }
+
+    VX_SECTION("alignment")
+    {
+        const size_t alignments[] = { 1, 2, 4, 8, 16, 32, 64 };
+
+        for (const size_t alignment : alignments)
+        {
+            void* p = a.allocate(3, alignment);
+            VX_CHECK(p != nullptr);
+            VX_CHECK(is_aligned(p, alignment));
+        }
+
+        VX_CHECK(a.stats().bytes_in_use == 3 * 7);
+        a.reset();
+    }
+
+    VX_SECTION("bump")
+    {
+        unsigned char* p1 = static_cast<unsigned char*>(a.allocate(16, 8));
+        unsigned char* p2 = static_cast<unsigned char*>(a.allocate(16, 8));
+        VX_CHECK(p2 > p1);
+        VX_CHECK(p2 - p1 < 64);
+
+        // freeing the most recent allocation hands its memory back
+        a.deallocate(p2, 16);
+        unsigned char* p3 = static_cast<unsigned char*>(a.allocate(16, 8));
+        VX_CHECK(p3 == p2);
+
+        a.reset();
+        VX_CHECK(a.stats().bytes_in_use == 0);
+    }
+
+    VX_SECTION("blocks")
+    {
+        const size_t reserved = a.stats().bytes_reserved;
+
+        // fill past the first block
+        for (int i = 0; i < 64; ++i)
+        {
+            VX_CHECK(a.allocate(32, 8) != nullptr);
+        }
+
+        const size_t grown = a.stats().bytes_reserved;
+        VX_CHECK(grown > reserved);
+        VX_CHECK(a.stats().bytes_in_use == 64 * 32);
+        VX_CHECK(a.stats().high_water_mark >= 64 * 32);
+
+        // after a reset the same blocks are reused
+        a.reset();
+        for (int i = 0; i < 64; ++i)
+        {
+            VX_CHECK(a.allocate(32, 8) != nullptr);
+        }
+        VX_CHECK(a.stats().bytes_reserved == grown);
+
+        // oversized requests get a dedicated block
+        void* big = a.allocate(4096, 16);
+        VX_CHECK(big != nullptr);
+        VX_CHECK(is_aligned(big, 16));
+        std::memset(big, 0xAB, 4096);
+
+        a.release();
+        VX_CHECK(a.stats().bytes_reserved == 0);
+        VX_CHECK(a.stats().bytes_in_use == 0);
+        VX_CHECK(a.stats().high_water_mark >= 64 * 32 + 4096);
+    }
+
+    VX_SECTION("reallocate")
+    {
+        char* p = static_cast<char*>(a.allocate(8, 1));
+        std::memcpy(p, "abcdefg", 8);
+
+        // the most recent allocation grows in place
+        char* p2 = static_cast<char*>(a.reallocate(p, 32, 1));
+        VX_CHECK(p2 == p);
+        VX_CHECK(std::strcmp(p2, "abcdefg") == 0);
+        VX_CHECK(a.stats().bytes_in_use == 32);
+
+        void* other = a.allocate(8, 1);
+        VX_CHECK(other != nullptr);
+
+        // otherwise the contents are copied to a new allocation
+        char* p3 = static_cast<char*>(a.reallocate(p2, 64, 1));
+        VX_CHECK(p3 != p2);
+        VX_CHECK(std::strcmp(p3, "abcdefg") == 0);
+        VX_CHECK(a.stats().bytes_in_use == 64 + 8);
+
+        // larger than a block
+        char* p4 = static_cast<char*>(a.reallocate(p3, 1024, 1));
+        VX_CHECK(std::strcmp(p4, "abcdefg") == 0);
+
+        a.reset();
+    }
+
+    VX_SECTION("mark and rewind")
+    {
+        void* p1 = a.allocate(16);
+        const mem::arena::marker m = a.mark();
+
+        for (int i = 0; i < 32; ++i)
+        {
+            VX_CHECK(a.allocate(64) != nullptr);
+        }
+
+        a.rewind(m);
+        VX_CHECK(a.stats().bytes_in_use == 16);
+
+        void* p2 = a.allocate(16);
+        VX_CHECK(p2 > p1);
+        VX_CHECK(static_cast<unsigned char*>(p2) - static_cast<unsigned char*>(p1) < 64);
+    }
+}
+
+//=============================================================================
+
+VX_TEST_CASE(arena_containers)
+{
+    mem::arena a(1024);
+
+    VX_SECTION("vector")
+    {
+        using alloc_type = mem::arena_allocator<int>;
+        vector<int, alloc_type> v{ alloc_type(a) };
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            VX_CHECK(v.push_back(i));
+        }
+
+        bool ok = true;
+        for (int i = 0; i < 1000; ++i)
+        {
+            ok &= (v[i] == i);
+        }
+        VX_CHECK(ok);
+        VX_CHECK(a.stats().bytes_in_use >= 1000 * sizeof(int));
+
+        vector<int, alloc_type> v2(v);
+        VX_CHECK(v2 == v);
+        VX_CHECK(v2.get_allocator() == v.get_allocator());
+    }
+
+    VX_SECTION("string")
+    {
+        using string = str::basic_string<char, mem::arena_allocator<char>>;
+        const mem::arena_allocator<char> alloc(a);
+
+        string s(alloc);
+        for (int i = 0; i < 100; ++i)
+        {
+            s.append("abc");
+        }
+        VX_CHECK(s.size() == 300);
+        VX_CHECK(s.get_allocator().resource() == &a);
+
+        string s2(s);
+        VX_CHECK(s2 == s);
+    }
+
+    VX_SECTION("packed_string_array")
+    {
+        using psa = str::packed_string_array<char, mem::arena_allocator<unsigned char>>;
+
+        const char* src[] = { "hello", "world" };
+        const size_t in_use = a.stats().bytes_in_use;
+
+        {
+            psa strings = psa::create(src, 2, mem::arena_allocator<unsigned char>(a));
+            VX_CHECK(strings.size() == 2);
+            VX_CHECK(std::strcmp(strings[1], "world") == 0);
+            VX_CHECK(a.stats().bytes_in_use > in_use);
+        }
+
+        VX_CHECK(a.stats().bytes_in_use == in_use);
+    }
+
+    VX_SECTION("rebind")
+    {
+        const mem::arena_allocator<int> a1(a);
+        const mem::arena_allocator<double> a2(a1);
+        VX_CHECK(a2.resource() == &a);
+
+        using rebound = mem::rebind_allocator<mem::arena_allocator<int>, char>::type;
+        VX_CHECK((std::is_same<rebound, mem::arena_allocator<char>>::value));
+    }
+}
+
+//=============================================================================
+
+VX_TEST_CASE(scratch_arena)
+{
+    mem::arena& scratch = mem::scratch_arena();
+    const size_t in_use = scratch.stats().bytes_in_use;
+
+    {
+        mem::scratch_scope scope;
+
+        vector<int, mem::scratch_allocator<int>> v;
+        for (int i = 0; i < 256; ++i)
+        {
+            v.push_back(i);
+        }
+        VX_CHECK(v[255] == 255);
+
+        str::basic_string<char, mem::scratch_allocator<char>> s(64, 'x');
+        VX_CHECK(s.size() == 64);
+
+        VX_CHECK(scratch.stats().bytes_in_use > in_use);
+    }
+
+    VX_CHECK(scratch.stats().bytes_in_use == in_use);
+}
+
+//=============================================================================
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
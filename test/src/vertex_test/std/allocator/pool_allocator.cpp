@@ -0,0 +1,196 @@
+#include "vertex/std/memory.hpp"
+#include "vertex/std/vector.hpp"
+#include "vertex_test/test.hpp"
+
+using namespace vx;
+
+//=============================================================================
+
+struct node
+{
+    node* next;
+    double value;
+};
+
+struct alignas(64) over_aligned
+{
+    char data[64];
+};
+
+//=============================================================================
+
+VX_TEST_CASE(fixed_pool)
+{
+    VX_SECTION("explicit block size")
+    {
+        mem::fixed_pool pool(24, 4);
+        VX_CHECK(pool.block_size() == 24);
+        VX_CHECK(pool.accepts(24, 8));
+        VX_CHECK(!pool.accepts(25, 8));
+
+        void* blocks[9];
+        for (void*& b : blocks)
+        {
+            b = pool.allocate();
+            VX_CHECK(b != nullptr);
+            VX_CHECK(pool.owns(b));
+            std::memset(b, 0xCD, 24);
+        }
+
+        VX_CHECK(pool.stats().bytes_in_use == 9 * 24);
+        VX_CHECK(pool.stats().high_water_mark == 9 * 24);
+        // three slabs of four blocks
+        VX_CHECK(pool.stats().bytes_reserved >= 12 * 24);
+
+        // blocks are recycled most recent first
+        pool.deallocate(blocks[3]);
+        VX_CHECK(pool.allocate() == blocks[3]);
+
+        for (void* b : blocks)
+        {
+            pool.deallocate(b);
+        }
+
+        VX_CHECK(pool.stats().bytes_in_use == 0);
+        VX_CHECK(pool.stats().high_water_mark == 9 * 24);
+
+        int local = 0;
+        VX_CHECK(!pool.owns(&local));
+
+        pool.release();
+        VX_CHECK(pool.stats().bytes_reserved == 0);
+    }
+
+    VX_SECTION("lazy block size")
+    {
+        mem::fixed_pool pool;
+        VX_CHECK(pool.block_size() == 0);
+
+        // over aligned types cannot be pooled
+        VX_CHECK(!pool.accepts(sizeof(over_aligned), alignof(over_aligned)));
+        VX_CHECK(pool.block_size() == 0);
+
+        VX_CHECK(pool.accepts(sizeof(node), alignof(node)));
+        VX_CHECK(pool.block_size() == sizeof(node));
+        VX_CHECK(pool.accepts(sizeof(int), alignof(int)));
+        VX_CHECK(!pool.accepts(sizeof(node) + 1, 1));
+    }
+}
+
+//=============================================================================
+
+VX_TEST_CASE(pool_allocator)
+{
+    mem::fixed_pool pool;
+
+    VX_SECTION("nodes")
+    {
+        mem::pool_allocator<node> alloc(pool);
+
+        node* head = nullptr;
+        for (int i = 0; i < 200; ++i)
+        {
+            node* n = alloc.allocate(1);
+            VX_CHECK(pool.owns(n));
+            mem::construct_in_place(n, node{ head, static_cast<double>(i) });
+            head = n;
+        }
+
+        VX_CHECK(pool.stats().bytes_in_use == 200 * sizeof(node));
+
+        double sum = 0.0;
+        while (head)
+        {
+            node* next = head->next;
+            sum += head->value;
+            alloc.deallocate(head, 1);
+            head = next;
+        }
+
+        VX_CHECK(sum == 199.0 * 200.0 / 2.0);
+        VX_CHECK(pool.stats().bytes_in_use == 0);
+    }
+
+    VX_SECTION("arrays fall through")
+    {
+        mem::pool_allocator<node> alloc(pool);
+
+        node* arr = alloc.allocate(16);
+        VX_CHECK(arr != nullptr);
+        VX_CHECK(!pool.owns(arr));
+        VX_CHECK(pool.stats().bytes_in_use == 0);
+        alloc.deallocate(arr, 16);
+    }
+
+    VX_SECTION("rebind")
+    {
+        const mem::pool_allocator<node> a1(pool);
+        const mem::pool_allocator<int> a2(a1);
+        VX_CHECK(a2.resource() == &pool);
+
+        using rebound = mem::rebind_allocator<mem::pool_allocator<node>, char>::type;
+        VX_CHECK((std::is_same<rebound, mem::pool_allocator<char>>::value));
+    }
+
+    VX_SECTION("vector")
+    {
+        // a vector's first allocation holds a single element, so it starts in the
+        // pool and has to be moved out as it grows
+        using alloc_type = mem::pool_allocator<int>;
+        vector<int, alloc_type> v{ alloc_type(pool) };
+
+        for (int i = 0; i < 100; ++i)
+        {
+            VX_CHECK(v.push_back(i));
+        }
+
+        bool ok = true;
+        for (int i = 0; i < 100; ++i)
+        {
+            ok &= (v[i] == i);
+        }
+        VX_CHECK(ok);
+
+        VX_CHECK(v.shrink_to_fit());
+        VX_CHECK(v.size() == 100);
+
+        // back down to a single element, which moves it into the pool again
+        v.resize(1);
+        VX_CHECK(v.shrink_to_fit());
+        VX_CHECK(pool.owns(v.data()));
+        VX_CHECK(v[0] == 0);
+    }
+
+    VX_SECTION("reallocate")
+    {
+        mem::pool_allocator<node> alloc(pool);
+
+        node* n = alloc.allocate(1);
+        n->value = 42.0;
+
+        VX_CHECK(alloc.reallocate(n, 1, 1) == n);
+
+        node* arr = alloc.reallocate(n, 1, 4);
+        VX_CHECK(!pool.owns(arr));
+        VX_CHECK(arr[0].value == 42.0);
+
+        node* bigger = alloc.reallocate(arr, 4, 8);
+        VX_CHECK(!pool.owns(bigger));
+        VX_CHECK(bigger[0].value == 42.0);
+
+        node* back = alloc.reallocate(bigger, 8, 1);
+        VX_CHECK(pool.owns(back));
+        VX_CHECK(back->value == 42.0);
+
+        alloc.deallocate(back, 1);
+        VX_CHECK(pool.stats().bytes_in_use == 0);
+    }
+}
+
+//=============================================================================
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
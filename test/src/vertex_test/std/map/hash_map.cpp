@@ -0,0 +1,293 @@
+#include <string>
+#include <unordered_map>
+
+#include "vertex/std/map.hpp"
+#include "vertex/std/string.hpp"
+#include "vertex/util/random/rng.hpp"
+#include "vertex_test/test.hpp"
+
+//=========================================================================
+// constructors
+//=========================================================================
+
+VX_TEST_CASE(constructors)
+{
+    using map = vx::hash_map<int, int>;
+
+    map m0;
+    VX_CHECK(m0.empty());
+    VX_CHECK(m0.size() == 0);
+    VX_CHECK(m0.capacity() == 0);
+    VX_CHECK(m0.begin() == m0.end());
+    VX_CHECK(m0.find(1) == m0.end());
+
+    map m1(100);
+    VX_CHECK(m1.empty());
+    VX_CHECK(m1.capacity() >= 100);
+
+    map m2 = { { 1, 10 }, { 2, 20 }, { 3, 30 }, { 1, 40 } };
+    VX_CHECK(m2.size() == 3);
+    VX_CHECK(m2.at(1).value() == 10);
+    VX_CHECK(m2.at(3).value() == 30);
+
+    map m3(m2);
+    VX_CHECK(m3.size() == 3);
+    VX_CHECK(m3 == m2);
+
+    map m4(std::move(m3));
+    VX_CHECK(m4.size() == 3);
+    VX_CHECK(m4 == m2);
+
+    map m5;
+    m5 = m4;
+    VX_CHECK(m5 == m4);
+
+    map m6;
+    m6 = std::move(m5);
+    VX_CHECK(m6 == m4);
+
+    map m7(m2.begin(), m2.end());
+    VX_CHECK(m7 == m2);
+}
+
+//=========================================================================
+// insert and lookup
+//=========================================================================
+
+VX_TEST_CASE(insert_and_lookup)
+{
+    vx::hash_map<int, std::string> m;
+
+    VX_SECTION("insert")
+    {
+        const auto res = m.insert({ 1, "one" });
+        VX_CHECK(res);
+        VX_CHECK(res.value().second);
+        VX_CHECK(res.value().first->second == "one");
+
+        const auto dup = m.insert({ 1, "uno" });
+        VX_CHECK(!dup.value().second);
+        VX_CHECK(dup.value().first->second == "one");
+    }
+
+    VX_SECTION("try_emplace")
+    {
+        VX_CHECK(m.try_emplace(2, "two").value().second);
+        VX_CHECK(!m.try_emplace(2, "dos").value().second);
+        VX_CHECK(m.at(2).value() == "two");
+    }
+
+    VX_SECTION("insert_or_assign")
+    {
+        VX_CHECK(m.insert_or_assign(3, "three").value().second);
+        VX_CHECK(!m.insert_or_assign(3, "tres").value().second);
+        VX_CHECK(m.at(3).value() == "tres");
+    }
+
+    VX_SECTION("emplace")
+    {
+        VX_CHECK(m.emplace(4, "four").value().second);
+        VX_CHECK(!m.emplace(4, "cuatro").value().second);
+        VX_CHECK(m.at(4).value() == "four");
+    }
+
+    VX_SECTION("subscript")
+    {
+        m[5] = "five";
+        VX_CHECK(m[5] == "five");
+        VX_CHECK(m[6].empty());
+        VX_CHECK(m.size() == 6);
+    }
+
+    VX_SECTION("lookup")
+    {
+        VX_CHECK(m.contains(1));
+        VX_CHECK(!m.contains(100));
+        VX_CHECK(m.count(2) == 1);
+        VX_CHECK(m.count(200) == 0);
+        VX_CHECK(!m.at(100));
+    }
+}
+
+//=========================================================================
+// erase
+//=========================================================================
+
+VX_TEST_CASE(erase)
+{
+    vx::hash_map<int, int> m;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        m[i] = i * 2;
+    }
+    VX_CHECK(m.size() == 1000);
+
+    VX_SECTION("erase by key")
+    {
+        for (int i = 0; i < 1000; i += 2)
+        {
+            VX_CHECK(m.erase(i) == 1);
+        }
+        VX_CHECK(m.erase(0) == 0);
+        VX_CHECK(m.size() == 500);
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            VX_CHECK(m.contains(i) == (i % 2 == 1));
+        }
+    }
+
+    VX_SECTION("erase by iterator")
+    {
+        size_t count = 0;
+        for (auto it = m.begin(); it != m.end();)
+        {
+            it = m.erase(it);
+            ++count;
+        }
+        VX_CHECK(count == 500);
+        VX_CHECK(m.empty());
+    }
+
+    VX_SECTION("erase_if")
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            m[i] = i;
+        }
+        VX_CHECK(m.erase_if([](const std::pair<const int, int>& v) { return v.second >= 50; }) == 50);
+        VX_CHECK(m.size() == 50);
+    }
+
+    VX_SECTION("clear")
+    {
+        const size_t capacity = m.capacity();
+        m.clear();
+        VX_CHECK(m.empty());
+        VX_CHECK(m.capacity() == capacity);
+        VX_CHECK(m.begin() == m.end());
+
+        m.rehash(0);
+        VX_CHECK(m.capacity() == 0);
+    }
+}
+
+//=========================================================================
+// capacity
+//=========================================================================
+
+VX_TEST_CASE(capacity)
+{
+    vx::hash_map<int, int> m;
+
+    VX_CHECK(m.reserve(1000));
+    const size_t capacity = m.capacity();
+    VX_CHECK(capacity >= 1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        m[i] = i;
+    }
+
+    // reserve guarantees no rehash for the requested count
+    VX_CHECK(m.capacity() == capacity);
+    VX_CHECK(m.load_factor() <= m.max_load_factor());
+
+    VX_CHECK(m.rehash(m.capacity() * 4));
+    VX_CHECK(m.capacity() > capacity);
+    VX_CHECK(m.size() == 1000);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        VX_CHECK(m.at(i).value() == i);
+    }
+}
+
+//=========================================================================
+// heterogeneous lookup
+//=========================================================================
+
+VX_TEST_CASE(heterogeneous_lookup)
+{
+    vx::hash_map<vx::string, int> m;
+
+    m[vx::string("alpha")] = 1;
+    m[vx::string("beta")] = 2;
+
+    const vx::string_view key = "alpha";
+    VX_CHECK(m.contains(key));
+    VX_CHECK(m.find(key)->second == 1);
+    VX_CHECK(m.at(vx::string_view("beta")).value() == 2);
+    VX_CHECK(!m.contains(vx::string_view("gamma")));
+    VX_CHECK(m.erase(vx::string_view("beta")) == 1);
+    VX_CHECK(m.size() == 1);
+
+    // string literals and c strings
+    VX_CHECK(m.contains("alpha"));
+    VX_CHECK(m.find("alpha")->second == 1);
+    VX_CHECK(m.find("beta") == m.end());
+
+    const char* cstr = "alpha";
+    VX_CHECK(m.contains(cstr));
+    VX_CHECK(m.at(cstr).value() == 1);
+    VX_CHECK(m.erase("alpha") == 1);
+    VX_CHECK(m.empty());
+}
+
+//=========================================================================
+// randomized against std::unordered_map
+//=========================================================================
+
+VX_TEST_CASE(randomized)
+{
+    vx::random::gen rng(12345);
+    vx::hash_map<int, int> m;
+    std::unordered_map<int, int> ref;
+
+    for (int i = 0; i < 200000; ++i)
+    {
+        const int key = rng.randi_range(0, 5000);
+
+        switch (rng.randi_range(0, 2))
+        {
+            case 0:
+            {
+                m[key] = i;
+                ref[key] = i;
+                break;
+            }
+            case 1:
+            {
+                VX_CHECK(m.erase(key) == ref.erase(key));
+                break;
+            }
+            default:
+            {
+                const auto it = m.find(key);
+                const auto rit = ref.find(key);
+                VX_CHECK((it == m.end()) == (rit == ref.end()));
+                VX_CHECK(it == m.end() || it->second == rit->second);
+                break;
+            }
+        }
+
+        VX_CHECK(m.size() == ref.size());
+    }
+
+    size_t count = 0;
+    for (const auto& v : m)
+    {
+        VX_CHECK(ref.at(v.first) == v.second);
+        ++count;
+    }
+    VX_CHECK(count == ref.size());
+}
+
+//=========================================================================
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
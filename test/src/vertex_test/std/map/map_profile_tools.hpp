@@ -0,0 +1,225 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/std/map.hpp"
+#include "vertex/util/random.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+template <typename K, typename T>
+using map1 = std::unordered_map<K, T>;
+
+template <typename K, typename T>
+using map2 = vx::hash_map<K, T>;
+
+//=========================================================================
+
+static constexpr size_t RR = 200;   // number of repetitions
+static constexpr size_t NN = 10000; // number of elements
+
+//=========================================================================
+
+template <typename Map>
+std::string function_name(const char* fn)
+{
+    VX_IF_CONSTEXPR ((std::is_same<Map, map1<uint64_t, uint64_t>>::value))
+    {
+        return std::string(fn) + " (int std)";
+    }
+    else VX_IF_CONSTEXPR ((std::is_same<Map, map1<std::string, uint64_t>>::value))
+    {
+        return std::string(fn) + " (string std)";
+    }
+    else VX_IF_CONSTEXPR ((std::is_same<Map, map2<uint64_t, uint64_t>>::value))
+    {
+        return std::string(fn) + " (int vx)";
+    }
+    else // VX_IF_CONSTEXPR((std::is_same<Map, map2<std::string, uint64_t>>::value))
+    {
+        VX_STATIC_ASSERT_MSG((std::is_same<Map, map2<std::string, uint64_t>>::value), "invalid type");
+        return std::string(fn) + " (string vx)";
+    }
+}
+
+#define function_str(str) (function_name<Map>(str))
+#define start_timer(str)  ::vx::profile::_priv::profile_timer timer(function_str(str))
+#define stop_timer()      timer.stop()
+
+//=========================================================================
+// keys
+//=========================================================================
+
+template <typename K>
+struct key_generator;
+
+template <>
+struct key_generator<uint64_t>
+{
+    static uint64_t make(uint64_t i) noexcept { return i * 0x9E3779B97F4A7C15ULL; }
+};
+
+template <>
+struct key_generator<std::string>
+{
+    static std::string make(uint64_t i) { return "key_" + std::to_string(i); }
+};
+
+template <typename Map>
+Map make_map(size_t N)
+{
+    using key_type = typename Map::key_type;
+
+    Map m;
+    for (size_t i = 0; i < N; ++i)
+    {
+        m[key_generator<key_type>::make(i)] = i;
+    }
+    return m;
+}
+
+//=========================================================================
+// insert
+//=========================================================================
+
+template <typename Map>
+VX_NO_INLINE void profile_insert(size_t N)
+{
+    using key_type = typename Map::key_type;
+
+    start_timer("insert");
+    Map m;
+    for (size_t i = 0; i < N; ++i)
+    {
+        m[key_generator<key_type>::make(i)] = i;
+    }
+    stop_timer();
+}
+
+template <typename Map>
+VX_NO_INLINE void profile_reserve_insert(size_t N)
+{
+    using key_type = typename Map::key_type;
+
+    start_timer("reserve insert");
+    Map m;
+    m.reserve(N);
+    for (size_t i = 0; i < N; ++i)
+    {
+        m[key_generator<key_type>::make(i)] = i;
+    }
+    stop_timer();
+}
+
+//=========================================================================
+// lookup
+//=========================================================================
+
+template <typename Map>
+VX_NO_INLINE void profile_find_hit(size_t N)
+{
+    using key_type = typename Map::key_type;
+
+    const Map m = make_map<Map>(N);
+    size_t found = 0;
+
+    start_timer("find hit");
+    for (size_t i = 0; i < N; ++i)
+    {
+        found += (m.find(key_generator<key_type>::make(i)) != m.end());
+    }
+    stop_timer();
+
+    VX_ASSERT(found == N);
+}
+
+template <typename Map>
+VX_NO_INLINE void profile_find_miss(size_t N)
+{
+    using key_type = typename Map::key_type;
+
+    const Map m = make_map<Map>(N);
+    size_t found = 0;
+
+    start_timer("find miss");
+    for (size_t i = N; i < N * 2; ++i)
+    {
+        found += (m.find(key_generator<key_type>::make(i)) != m.end());
+    }
+    stop_timer();
+
+    VX_ASSERT(found == 0);
+}
+
+template <typename Map>
+VX_NO_INLINE void profile_iterate(size_t N)
+{
+    const Map m = make_map<Map>(N);
+    uint64_t sum = 0;
+
+    start_timer("iterate");
+    for (const auto& v : m)
+    {
+        sum += v.second;
+    }
+    stop_timer();
+
+    VX_ASSERT(sum == (N * (N - 1)) / 2);
+}
+
+//=========================================================================
+// erase
+//=========================================================================
+
+template <typename Map>
+VX_NO_INLINE void profile_erase(size_t N)
+{
+    using key_type = typename Map::key_type;
+
+    Map m = make_map<Map>(N);
+
+    start_timer("erase");
+    for (size_t i = 0; i < N; ++i)
+    {
+        m.erase(key_generator<key_type>::make(i));
+    }
+    stop_timer();
+
+    VX_ASSERT(m.empty());
+}
+
+//=========================================================================
+
+template <typename Map>
+void run(size_t N, size_t R)
+{
+    using test_fn = void (*)(size_t);
+
+    test_fn tests[] = {
+        profile_insert<Map>,
+        profile_reserve_insert<Map>,
+        profile_find_hit<Map>,
+        profile_find_miss<Map>,
+        profile_iterate<Map>,
+        profile_erase<Map>
+    };
+
+    vx::random::gen rng;
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        constexpr size_t count = vx::mem::array_size(tests);
+        test_fn selected_tests[count] = {};
+
+        vx::random::sample(std::begin(tests), std::end(tests), selected_tests, count, rng);
+
+        for (auto test : selected_tests)
+        {
+            test(N);
+        }
+    }
+}
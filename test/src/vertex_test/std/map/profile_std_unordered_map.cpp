@@ -0,0 +1,17 @@
+#include "vertex_test/std/map/map_profile_tools.hpp"
+
+//=========================================================================
+
+int main()
+{
+    // warmup
+    run<map1<uint64_t, uint64_t>>(NN, static_cast<size_t>(RR * 0.1f));
+
+    VX_PROFILE_START("profile_map.csv");
+
+    run<map1<uint64_t, uint64_t>>(NN, RR);
+    run<map1<std::string, uint64_t>>(NN, RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
@@ -0,0 +1,20 @@
+#include "vertex_test/std/map/map_profile_tools.hpp"
+
+//=========================================================================
+
+// Run after profile_std_unordered_map, results are appended to the same file
+// so both implementations can be compared side by side.
+
+int main()
+{
+    // warmup
+    run<map2<uint64_t, uint64_t>>(NN, static_cast<size_t>(RR * 0.1f));
+
+    VX_PROFILE_START_APPEND("profile_map.csv");
+
+    run<map2<uint64_t, uint64_t>>(NN, RR);
+    run<map2<std::string, uint64_t>>(NN, RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <string_view>
+
+#include "vertex/std/set.hpp"
+#include "vertex/util/random/rng.hpp"
+#include "vertex_test/test.hpp"
+
+//=========================================================================
+
+template <typename Set>
+static bool is_sorted_unique(const Set& s)
+{
+    const auto comp = s.key_comp();
+    for (auto it = s.begin(); it != s.end() && it + 1 != s.end(); ++it)
+    {
+        if (!comp(*it, *(it + 1)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// reports a small max_size so a container runs out of room after a few
+// elements, which makes its append fail like an allocation failure would
+template <typename T>
+class limited_allocator
+{
+public:
+
+    using value_type = T;
+
+    static size_t limit;
+
+    limited_allocator() noexcept = default;
+
+    template <typename U>
+    limited_allocator(const limited_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(std::malloc(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) noexcept
+    {
+        std::free(p);
+    }
+
+    size_t max_size() const noexcept
+    {
+        return limit;
+    }
+
+    friend bool operator==(const limited_allocator&, const limited_allocator&) noexcept { return true; }
+    friend bool operator!=(const limited_allocator&, const limited_allocator&) noexcept { return false; }
+};
+
+template <typename T>
+size_t limited_allocator<T>::limit = static_cast<size_t>(-1);
+
+//=========================================================================
+// constructors
+//=========================================================================
+
+VX_TEST_CASE(constructors)
+{
+    using set = vx::flat_set<int>;
+
+    set s0;
+    VX_CHECK(s0.empty());
+    VX_CHECK(s0.begin() == s0.end());
+
+    set s1 = { 5, 3, 1, 3, 4, 5 };
+    VX_CHECK(s1.size() == 4);
+    VX_CHECK(is_sorted_unique(s1));
+    VX_CHECK(*s1.begin() == 1);
+    VX_CHECK(*s1.rbegin() == 5);
+
+    set s2(s1);
+    VX_CHECK(s2 == s1);
+
+    set s3(std::move(s2));
+    VX_CHECK(s3 == s1);
+
+    vx::vector<int> values = { 9, 7, 7, 8 };
+    set s4(std::move(values));
+    VX_CHECK(s4.size() == 3);
+    VX_CHECK(is_sorted_unique(s4));
+
+    VX_CHECK(s1 < s4);
+    VX_CHECK(s1 != s4);
+
+    const auto extracted = s4.extract();
+    VX_CHECK(s4.empty());
+    VX_CHECK(extracted.size() == 3);
+}
+
+//=========================================================================
+// insert
+//=========================================================================
+
+VX_TEST_CASE(insert)
+{
+    vx::flat_set<int> s;
+
+    VX_SECTION("single")
+    {
+        VX_CHECK(s.insert(2).value().second);
+        VX_CHECK(s.insert(0).value().second);
+        VX_CHECK(s.insert(1).value().second);
+
+        const auto res = s.insert(1);
+        VX_CHECK(!res.value().second);
+        VX_CHECK(*res.value().first == 1);
+
+        VX_CHECK(s.emplace(3).value().second);
+        VX_CHECK(s.size() == 4);
+        VX_CHECK(is_sorted_unique(s));
+    }
+
+    VX_SECTION("range")
+    {
+        const int values[] = { 10, 4, 4, 2, -1, 7, 10, 3 };
+        VX_CHECK(s.insert(std::begin(values), std::end(values)));
+        VX_CHECK(s.size() == 8);
+        VX_CHECK(is_sorted_unique(s));
+
+        // values that all sort after the existing ones
+        VX_CHECK(s.insert({ 20, 30, 30, 25 }));
+        VX_CHECK(s.size() == 11);
+        VX_CHECK(is_sorted_unique(s));
+    }
+
+    VX_SECTION("range out of memory")
+    {
+        vx::flat_set<int, std::less<int>, limited_allocator<int>> fs;
+        VX_CHECK(fs.insert({ 1, 3, 5 }));
+
+        // fails partway through with the appended values out of order
+        limited_allocator<int>::limit = 16;
+        const int values[] = { 9, 2, 8, 3, 7, 4, 6, 0, 12, 10, 11 };
+
+        VX_CHECK(!fs.insert(std::begin(values), std::end(values)));
+        VX_CHECK(fs.size() == 3);
+        VX_CHECK(is_sorted_unique(fs));
+        VX_CHECK(fs.contains(1) && fs.contains(3) && fs.contains(5));
+        VX_CHECK(!fs.contains(9));
+
+        limited_allocator<int>::limit = static_cast<size_t>(-1);
+        VX_CHECK(fs.insert(std::begin(values), std::end(values)));
+        VX_CHECK(fs.size() == 13);
+        VX_CHECK(is_sorted_unique(fs));
+    }
+}
+
+//=========================================================================
+// lookup
+//=========================================================================
+
+VX_TEST_CASE(lookup)
+{
+    const vx::flat_set<int> s = { 1, 3, 5, 7 };
+
+    VX_CHECK(s.contains(3));
+    VX_CHECK(!s.contains(4));
+    VX_CHECK(s.count(5) == 1);
+    VX_CHECK(s.find(4) == s.end());
+    VX_CHECK(*s.find(7) == 7);
+
+    VX_CHECK(*s.lower_bound(4) == 5);
+    VX_CHECK(*s.upper_bound(5) == 7);
+    VX_CHECK(s.lower_bound(8) == s.end());
+
+    const auto range = s.equal_range(3);
+    VX_CHECK(range.second - range.first == 1);
+
+    // transparent comparison
+    vx::flat_set<std::string, std::less<>> strings = { "b", "a" };
+    VX_CHECK(strings.contains(std::string_view("a")));
+    VX_CHECK(!strings.contains(std::string_view("c")));
+}
+
+//=========================================================================
+// erase
+//=========================================================================
+
+VX_TEST_CASE(erase)
+{
+    vx::flat_set<int> s = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    VX_CHECK(s.erase(5) == 1);
+    VX_CHECK(s.erase(5) == 0);
+    VX_CHECK(!s.contains(5));
+
+    const auto it = s.erase(s.begin());
+    VX_CHECK(*it == 1);
+
+    s.erase(s.begin(), s.begin() + 2);
+    VX_CHECK(*s.begin() == 3);
+
+    VX_CHECK(s.erase_if([](int x) { return x % 2 == 0; }) == 3);
+    VX_CHECK(s.size() == 3);
+    VX_CHECK(is_sorted_unique(s));
+
+    s.clear();
+    VX_CHECK(s.empty());
+}
+
+//=========================================================================
+// randomized against std::set
+//=========================================================================
+
+VX_TEST_CASE(randomized)
+{
+    vx::random::gen rng(12345);
+    vx::flat_set<int> s;
+    std::set<int> ref;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        switch (rng.randi_range(0, 2))
+        {
+            case 0:
+            {
+                const int key = rng.randi_range(0, 1000);
+                VX_CHECK(s.insert(key).value().second == ref.insert(key).second);
+                break;
+            }
+            case 1:
+            {
+                const int key = rng.randi_range(0, 1000);
+                VX_CHECK(s.erase(key) == ref.erase(key));
+                break;
+            }
+            default:
+            {
+                int batch[16];
+                for (int& x : batch)
+                {
+                    x = rng.randi_range(0, 1000);
+                }
+                VX_CHECK(s.insert(std::begin(batch), std::end(batch)));
+                ref.insert(std::begin(batch), std::end(batch));
+                break;
+            }
+        }
+
+        VX_CHECK(s.size() == ref.size());
+    }
+
+    VX_CHECK(std::equal(s.begin(), s.end(), ref.begin(), ref.end()));
+}
+
+//=========================================================================
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <unordered_set>
+
+#include "vertex/std/set.hpp"
+#include "vertex/std/string.hpp"
+#include "vertex/util/random/rng.hpp"
+#include "vertex_test/test.hpp"
+
+//=========================================================================
+// constructors
+//=========================================================================
+
+VX_TEST_CASE(constructors)
+{
+    using set = vx::hash_set<int>;
+
+    set s0;
+    VX_CHECK(s0.empty());
+    VX_CHECK(s0.begin() == s0.end());
+    VX_CHECK(!s0.contains(1));
+
+    set s1 = { 1, 2, 3, 2, 1 };
+    VX_CHECK(s1.size() == 3);
+    VX_CHECK(s1.contains(1) && s1.contains(2) && s1.contains(3));
+
+    set s2(s1);
+    VX_CHECK(s2 == s1);
+
+    set s3(std::move(s2));
+    VX_CHECK(s3 == s1);
+
+    set s4;
+    s4 = s3;
+    VX_CHECK(s4 == s1);
+
+    s4 = { 4, 5 };
+    VX_CHECK(s4 != s1);
+    VX_CHECK(s4.size() == 2);
+}
+
+//=========================================================================
+// modifiers
+//=========================================================================
+
+VX_TEST_CASE(modifiers)
+{
+    vx::hash_set<vx::string> s;
+
+    VX_CHECK(s.insert(vx::string("a")).value().second);
+    VX_CHECK(!s.insert(vx::string("a")).value().second);
+    VX_CHECK(s.emplace("b").value().second);
+    VX_CHECK(s.size() == 2);
+
+    // iterators never allow modifying a key in place
+    VX_CHECK((std::is_const<std::remove_reference<decltype(*s.begin())>::type>::value));
+
+    // string_view lookup does not need a temporary string
+    VX_CHECK(s.contains(vx::string_view("a")));
+    VX_CHECK(s.erase(vx::string_view("a")) == 1);
+    VX_CHECK(!s.contains(vx::string_view("a")));
+
+    const auto it = s.find(vx::string_view("b"));
+    VX_CHECK(it != s.end());
+    VX_CHECK(s.erase(it) == s.end());
+    VX_CHECK(s.empty());
+}
+
+//=========================================================================
+// randomized against std::unordered_set
+//=========================================================================
+
+VX_TEST_CASE(randomized)
+{
+    vx::random::gen rng(12345);
+    vx::hash_set<uint32_t> s;
+    std::unordered_set<uint32_t> ref;
+
+    for (int i = 0; i < 200000; ++i)
+    {
+        const uint32_t key = rng.randi_range<uint32_t>(0, 5000);
+
+        if (rng.randi_range(0, 1))
+        {
+            VX_CHECK(s.insert(key).value().second == ref.insert(key).second);
+        }
+        else
+        {
+            VX_CHECK(s.erase(key) == ref.erase(key));
+        }
+
+        VX_CHECK(s.size() == ref.size());
+    }
+
+    for (const uint32_t key : s)
+    {
+        VX_CHECK(ref.count(key) == 1);
+    }
+}
+
+//=========================================================================
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
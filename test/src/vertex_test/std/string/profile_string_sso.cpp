@@ -0,0 +1,101 @@
+#include "vertex_test/std/string/string_profile_tools.hpp"
+
+//=========================================================================
+
+// Compares small string construction, append, and copy against std::string
+// across the inline/heap boundary of both implementations.
+
+static const size_t sso_sizes[] = { 0, 1, 8, 15, 16, 22, 23, 32, 48, 64 };
+
+static std::string sized_name(const char* fn, size_t N)
+{
+    return std::string(fn) + " " + std::to_string(N);
+}
+
+//=========================================================================
+
+template <typename Str>
+VX_NO_INLINE void profile_sso_construct(size_t N)
+{
+    const std::string name = function_name<Str>(sized_name("sso construct", N).c_str());
+
+    ::vx::profile::_priv::profile_timer timer(name);
+    Str s(N, char_type{ 'a' });
+    vx::os::do_not_optimize(s);
+    stop_timer();
+}
+
+template <typename Str>
+VX_NO_INLINE void profile_sso_append(size_t N)
+{
+    const std::string name = function_name<Str>(sized_name("sso append", N).c_str());
+
+    ::vx::profile::_priv::profile_timer timer(name);
+    Str s;
+    for (size_t i = 0; i < N; ++i)
+    {
+        s.push_back(char_type{ 'a' });
+    }
+    vx::os::do_not_optimize(s);
+    stop_timer();
+}
+
+template <typename Str>
+VX_NO_INLINE void profile_sso_copy(size_t N)
+{
+    const std::string name = function_name<Str>(sized_name("sso copy", N).c_str());
+    Str src(N, char_type{ 'a' });
+    vx::os::do_not_optimize(src);
+
+    ::vx::profile::_priv::profile_timer timer(name);
+    Str dst(src);
+    vx::os::do_not_optimize(dst);
+    stop_timer();
+}
+
+//=========================================================================
+
+static void run_sso(size_t R)
+{
+    using test_fn = void (*)(size_t);
+
+    test_fn tests[] = {
+        profile_sso_construct<str1>,
+        profile_sso_append<str1>,
+        profile_sso_copy<str1>,
+        profile_sso_construct<str2>,
+        profile_sso_append<str2>,
+        profile_sso_copy<str2>
+    };
+
+    vx::random::gen rng;
+
+    for (size_t r = 0; r < R; ++r)
+    {
+        constexpr size_t count = vx::mem::array_size(tests);
+        test_fn selected_tests[count] = {};
+
+        vx::random::sample(std::begin(tests), std::end(tests), selected_tests, count, rng);
+
+        for (const size_t N : sso_sizes)
+        {
+            for (auto test : selected_tests)
+            {
+                test(N);
+            }
+        }
+    }
+}
+
+int main()
+{
+    // warmup
+    run_sso(static_cast<size_t>(RR * 0.1f));
+
+    VX_PROFILE_START("profile_string_sso.csv");
+
+    run_sso(RR);
+
+    VX_PROFILE_STOP();
+    return 0;
+}
@@ -183,24 +183,24 @@ static void test_container()
 
         string v5(20, T('x'));
         string v6(std::move(v5));
-        VX_CHECK(!v5.is_valid());
+        VX_CHECK(v5.is_valid() && v5.empty());
         VX_CHECK(v6.size() == 20);
 
-        VX_DISABLE_WARNING_POP();
-
         string v7;
         v7.assign(std::move(v6));
-        VX_CHECK(!v5.is_valid());
+        VX_CHECK(v6.is_valid() && v6.empty());
         VX_CHECK(v7.size() == 20);
 
         string v8;
         v8 = std::move(v7);
-        VX_CHECK(!v5.is_valid());
+        VX_CHECK(v7.is_valid() && v7.empty());
         VX_CHECK(v8.size() == 20);
 
         string v8a(std::move(v8));
-        VX_CHECK(!v5.is_valid());
+        VX_CHECK(v8.is_valid() && v8.empty());
         VX_CHECK(v8a.size() == 20);
+
+        VX_DISABLE_WARNING_POP();
     }
 
     {
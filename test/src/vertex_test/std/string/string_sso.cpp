@@ -0,0 +1,293 @@
+#include "vertex/std/string.hpp"
+#include "vertex_test/test.hpp"
+
+//=============================================================================
+
+#define LIT(x) VX_LIT(T, x)
+
+template <typename String>
+static bool is_inline(const String& s)
+{
+    const auto* const first = reinterpret_cast<const unsigned char*>(&s);
+    const auto* const data = reinterpret_cast<const unsigned char*>(s.data());
+    return data >= first && data < first + sizeof(String);
+}
+
+template <typename String>
+static bool has_value(const String& s, size_t count, typename String::value_type c)
+{
+    if (s.size() != count || s.data()[count] != typename String::value_type())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (s[i] != c)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//=============================================================================
+
+template <typename T>
+static void test_sso()
+{
+    using string = vx::str::basic_string<T>;
+
+    const string empty;
+    const size_t short_capacity = empty.capacity();
+
+    VX_SECTION("layout")
+    {
+        VX_CHECK(sizeof(string) == 3 * sizeof(void*));
+        VX_CHECK(short_capacity == sizeof(string) / sizeof(T) - 2);
+        VX_CHECK(is_inline(empty));
+        VX_CHECK(empty.empty());
+        VX_CHECK(empty.c_str()[0] == T());
+    }
+
+    VX_SECTION("construct")
+    {
+        const string s1(short_capacity, T('a'));
+        VX_CHECK(is_inline(s1));
+        VX_CHECK(has_value(s1, short_capacity, T('a')));
+
+        const string s2(short_capacity + 1, T('b'));
+        VX_CHECK(!is_inline(s2));
+        VX_CHECK(has_value(s2, short_capacity + 1, T('b')));
+
+        const string s3(s1);
+        VX_CHECK(is_inline(s3));
+        VX_CHECK(s3 == s1);
+
+        const string s4(s2);
+        VX_CHECK(!is_inline(s4));
+        VX_CHECK(s4 == s2);
+    }
+
+    VX_SECTION("assign")
+    {
+        string s(short_capacity + 1, T('a'));
+        const size_t capacity = s.capacity();
+
+        // shrinking assignment keeps the heap buffer
+        s = LIT("abc");
+        VX_CHECK(!is_inline(s));
+        VX_CHECK(s.capacity() == capacity);
+        VX_CHECK(s == LIT("abc"));
+
+        string s2;
+        s2.assign(short_capacity + 1, T('b'));
+        VX_CHECK(!is_inline(s2));
+        VX_CHECK(has_value(s2, short_capacity + 1, T('b')));
+    }
+
+    VX_SECTION("append")
+    {
+        string s;
+
+        for (size_t i = 0; i < short_capacity; ++i)
+        {
+            s.push_back(T('a'));
+            VX_CHECK(is_inline(s));
+        }
+
+        s.push_back(T('a'));
+        VX_CHECK(!is_inline(s));
+        VX_CHECK(has_value(s, short_capacity + 1, T('a')));
+
+        string s2(short_capacity - 1, T('b'));
+        s2.append(2, T('b'));
+        VX_CHECK(!is_inline(s2));
+        VX_CHECK(has_value(s2, short_capacity + 1, T('b')));
+
+        // appending from a view into the inline buffer itself
+        string s3(short_capacity, T('c'));
+        s3.append(s3);
+        VX_CHECK(has_value(s3, short_capacity * 2, T('c')));
+    }
+
+    VX_SECTION("insert")
+    {
+        string s(short_capacity - 1, T('a'));
+        s.insert(s.begin(), T('b'));
+        VX_CHECK(is_inline(s));
+        VX_CHECK(s.size() == short_capacity);
+        VX_CHECK(s.front() == T('b'));
+        VX_CHECK(s.back() == T('a'));
+
+        s.insert(size_t(1), 2, T('c'));
+        VX_CHECK(!is_inline(s));
+        VX_CHECK(s.size() == short_capacity + 2);
+        VX_CHECK(s[0] == T('b'));
+        VX_CHECK(s[1] == T('c'));
+        VX_CHECK(s[2] == T('c'));
+        VX_CHECK(s[3] == T('a'));
+        VX_CHECK(s.back() == T('a'));
+        VX_CHECK(s.c_str()[s.size()] == T());
+    }
+
+    VX_SECTION("reserve and shrink_to_fit")
+    {
+        string s(LIT("abc"));
+
+        VX_CHECK(s.reserve(short_capacity));
+        VX_CHECK(is_inline(s));
+
+        VX_CHECK(s.reserve(short_capacity + 1));
+        VX_CHECK(!is_inline(s));
+        VX_CHECK(s.capacity() == short_capacity + 1);
+        VX_CHECK(s == LIT("abc"));
+
+        VX_CHECK(s.shrink_to_fit());
+        VX_CHECK(is_inline(s));
+        VX_CHECK(s.capacity() == short_capacity);
+        VX_CHECK(s == LIT("abc"));
+
+        string s2(short_capacity + 1, T('a'));
+        s2.reserve(short_capacity * 4);
+        VX_CHECK(s2.shrink_to_fit());
+        VX_CHECK(!is_inline(s2));
+        VX_CHECK(s2.capacity() == short_capacity + 1);
+        VX_CHECK(has_value(s2, short_capacity + 1, T('a')));
+
+        s2.clear_and_deallocate();
+        VX_CHECK(is_inline(s2));
+        VX_CHECK(s2.empty());
+    }
+
+    VX_SECTION("erase and resize")
+    {
+        string s(short_capacity + 4, T('a'));
+
+        s.erase(0, 4);
+        VX_CHECK(has_value(s, short_capacity, T('a')));
+
+        s.resize(2);
+        VX_CHECK(has_value(s, 2, T('a')));
+        VX_CHECK(s.shrink_to_fit());
+        VX_CHECK(is_inline(s));
+
+        s.resize(short_capacity + 1, T('a'));
+        VX_CHECK(!is_inline(s));
+        VX_CHECK(has_value(s, short_capacity + 1, T('a')));
+
+        s.pop_back();
+        VX_CHECK(has_value(s, short_capacity, T('a')));
+
+        s.clear();
+        VX_CHECK(s.empty());
+        VX_CHECK(s.c_str()[0] == T());
+    }
+
+    VX_SECTION("replace")
+    {
+        string s(LIT("abcdef"));
+
+        // growing past the inline buffer
+        s.replace(1, 1, short_capacity, T('x'));
+        VX_CHECK(!is_inline(s));
+        VX_CHECK(s.size() == short_capacity + 5);
+        VX_CHECK(s[0] == T('a'));
+        VX_CHECK(s[1] == T('x'));
+        VX_CHECK(s[short_capacity + 1] == T('c'));
+
+        // shrinking stays in the current buffer
+        const auto* const ptr = s.data();
+        s.replace(1, short_capacity, LIT("b"));
+        VX_CHECK(s.data() == ptr);
+        VX_CHECK(s == LIT("abcdef"));
+
+        string s2(LIT("abc"));
+        s2.replace(0, 3, LIT("xy"));
+        VX_CHECK(is_inline(s2));
+        VX_CHECK(s2 == LIT("xy"));
+    }
+
+    VX_SECTION("move and swap")
+    {
+        VX_DISABLE_USE_AFTER_MOVE_WARNING();
+
+        string s1(LIT("abc"));
+        string s2(std::move(s1));
+        VX_CHECK(is_inline(s2));
+        VX_CHECK(s2 == LIT("abc"));
+        VX_CHECK(s1.empty());
+        VX_CHECK(s1.c_str()[0] == T());
+
+        string s3(short_capacity + 1, T('a'));
+        const auto* const ptr = s3.data();
+        string s4(std::move(s3));
+        VX_CHECK(s4.data() == ptr);
+        VX_CHECK(s3.empty());
+        VX_CHECK(is_inline(s3));
+
+        s3 = std::move(s2);
+        VX_CHECK(is_inline(s3));
+        VX_CHECK(s3 == LIT("abc"));
+
+        s3.swap(s4);
+        VX_CHECK(s3.data() == ptr);
+        VX_CHECK(has_value(s3, short_capacity + 1, T('a')));
+        VX_CHECK(is_inline(s4));
+        VX_CHECK(s4 == LIT("abc"));
+
+        swap(s3, s4);
+        VX_CHECK(is_inline(s3));
+        VX_CHECK(s3 == LIT("abc"));
+        VX_CHECK(s4.data() == ptr);
+
+        VX_DISABLE_WARNING_POP();
+    }
+
+    VX_SECTION("release and acquire")
+    {
+        string s(LIT("abc"));
+        T* ptr = s.release();
+        VX_CHECK(ptr != nullptr);
+        VX_CHECK(s.empty());
+        VX_CHECK(std::char_traits<T>::compare(ptr, LIT("abc"), 4) == 0);
+
+        // acquired buffers are always kept on the heap
+        string s2;
+        VX_CHECK(s2.acquire(ptr));
+        VX_CHECK(s2.data() == ptr);
+        VX_CHECK(s2 == LIT("abc"));
+
+        s2.push_back(T('d'));
+        VX_CHECK(s2 == LIT("abcd"));
+    }
+}
+
+VX_TEST_CASE(sso)
+{
+    VX_MESSAGE("  char");
+    test_sso<char>();
+
+    VX_MESSAGE("  wchar_t");
+    test_sso<wchar_t>();
+
+#if defined(__cpp_lib_char8_t)
+    VX_MESSAGE("  char8_t");
+    test_sso<char8_t>();
+#endif
+
+    VX_MESSAGE("  char16_t");
+    test_sso<char16_t>();
+
+    VX_MESSAGE("  char32_t");
+    test_sso<char32_t>();
+}
+
+//=============================================================================
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,278 @@
+#include "vertex/std/small_vector.hpp"
+#include "vertex/std/vector.hpp"
+#include "vertex_test/test.hpp"
+
+using namespace vx;
+
+//=========================================================================
+
+// non trivial element that counts live instances
+struct tracked
+{
+    static int live;
+
+    int value;
+
+    tracked(int v = 0) : value(v) { ++live; }
+    tracked(const tracked& other) : value(other.value) { ++live; }
+    tracked(tracked&& other) noexcept : value(other.value) { other.value = -1; ++live; }
+    ~tracked() { --live; }
+
+    tracked& operator=(const tracked&) = default;
+    tracked& operator=(tracked&&) noexcept = default;
+
+    friend bool operator==(const tracked& lhs, const tracked& rhs) { return lhs.value == rhs.value; }
+    friend bool operator!=(const tracked& lhs, const tracked& rhs) { return lhs.value != rhs.value; }
+    friend bool operator<(const tracked& lhs, const tracked& rhs) { return lhs.value < rhs.value; }
+};
+
+int tracked::live = 0;
+
+template <typename V>
+static bool is_sequence(const V& v, int first, size_t count)
+{
+    if (v.size() != count)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!(v[i] == static_cast<int>(first + static_cast<int>(i))))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//=========================================================================
+
+template <typename T>
+static void test_small_vector()
+{
+    using vec = small_vector<T, 4>;
+
+    VX_SECTION("construct")
+    {
+        vec v0;
+        VX_CHECK(v0.empty());
+        VX_CHECK(v0.is_inline());
+        VX_CHECK(v0.capacity() == vec::inline_capacity);
+
+        vec v1(3, T(7));
+        VX_CHECK(v1.size() == 3);
+        VX_CHECK(v1.is_inline());
+        VX_CHECK(v1[2] == T(7));
+
+        vec v2(10, T(8));
+        VX_CHECK(v2.size() == 10);
+        VX_CHECK(!v2.is_inline());
+        VX_CHECK(v2.back().value() == T(8));
+
+        vec v3{ T(0), T(1), T(2), T(3), T(4) };
+        VX_CHECK(!v3.is_inline());
+        VX_CHECK(is_sequence(v3, 0, 5));
+
+        vec v4(v3.begin() + 1, v3.end());
+        VX_CHECK(v4.is_inline());
+        VX_CHECK(is_sequence(v4, 1, 4));
+
+        const vector<T> heap{ T(0), T(1) };
+        vec v5(heap);
+        VX_CHECK(v5 == (vec{ T(0), T(1) }));
+
+        auto v6 = vec::construct(6, T(2));
+        VX_CHECK(v6.has_value());
+        VX_CHECK(v6.value().size() == 6);
+    }
+
+    VX_SECTION("push back")
+    {
+        vec v;
+        for (int i = 0; i < 4; ++i)
+        {
+            VX_CHECK(v.push_back(T(i)));
+        }
+        VX_CHECK(v.is_inline());
+        VX_CHECK(v.capacity() == 4);
+
+        // the fifth element spills to the heap
+        VX_CHECK(v.push_back(T(4)));
+        VX_CHECK(!v.is_inline());
+        VX_CHECK(v.capacity() > 4);
+
+        for (int i = 5; i < 100; ++i)
+        {
+            VX_CHECK(v.emplace_back(i));
+        }
+        VX_CHECK(is_sequence(v, 0, 100));
+    }
+
+    VX_SECTION("push back self reference")
+    {
+        vec v{ T(1), T(2), T(3), T(4) };
+        VX_CHECK(v.push_back(v[0]));
+        VX_CHECK(v[4] == T(1));
+    }
+
+    VX_SECTION("insert")
+    {
+        vec v{ T(0), T(3) };
+        VX_CHECK(v.insert(1, { T(1), T(2) }));
+        VX_CHECK(v.is_inline());
+        VX_CHECK(is_sequence(v, 0, 4));
+
+        // spill in the middle of an insert
+        auto it = v.insert(v.begin() + 2, 3, T(9));
+        VX_CHECK(!v.is_inline());
+        VX_CHECK(*it == T(9));
+        VX_CHECK(v.size() == 7);
+        VX_CHECK(v[1] == T(1) && v[5] == T(2) && v[6] == T(3));
+
+        VX_CHECK(!v.insert(100, T(0)));
+    }
+
+    VX_SECTION("erase")
+    {
+        vec v{ T(0), T(1), T(2), T(3), T(4), T(5) };
+        VX_CHECK(v.erase(0));
+        VX_CHECK(is_sequence(v, 1, 5));
+
+        auto it = v.erase(v.begin() + 1, v.begin() + 3);
+        VX_CHECK(*it == T(4));
+        VX_CHECK(v.size() == 3);
+
+        VX_CHECK(v.pop_back());
+        VX_CHECK(v.size() == 2);
+        VX_CHECK(!v.erase(5));
+    }
+
+    VX_SECTION("reserve and shrink")
+    {
+        vec v{ T(0), T(1) };
+        VX_CHECK(v.reserve(4));
+        VX_CHECK(v.is_inline());
+
+        VX_CHECK(v.reserve(32));
+        VX_CHECK(!v.is_inline());
+        VX_CHECK(v.capacity() == 32);
+        VX_CHECK(is_sequence(v, 0, 2));
+
+        // fits inline again
+        VX_CHECK(v.shrink_to_fit());
+        VX_CHECK(v.is_inline());
+        VX_CHECK(v.capacity() == 4);
+        VX_CHECK(is_sequence(v, 0, 2));
+
+        VX_CHECK(v.resize(8, T(5)));
+        VX_CHECK(v.reserve(16));
+        VX_CHECK(v.shrink_to_fit());
+        VX_CHECK(!v.is_inline());
+        VX_CHECK(v.capacity() == 8);
+
+        VX_CHECK(v.resize(3));
+        VX_CHECK(v.size() == 3);
+
+        v.clear_and_deallocate();
+        VX_CHECK(v.empty());
+        VX_CHECK(v.is_inline());
+    }
+
+    VX_SECTION("assign")
+    {
+        vec v{ T(9), T(9), T(9) };
+        VX_CHECK(v.assign({ T(0), T(1), T(2), T(3), T(4), T(5) }));
+        VX_CHECK(is_sequence(v, 0, 6));
+
+        VX_CHECK(v.assign(2, T(1)));
+        VX_CHECK(v.size() == 2);
+
+        const vec big{ T(0), T(1), T(2), T(3), T(4), T(5), T(6) };
+        v = big;
+        VX_CHECK(v == big);
+
+        const vec small{ T(0) };
+        v = small;
+        VX_CHECK(v == small);
+    }
+
+    VX_SECTION("move")
+    {
+        vec inl{ T(0), T(1), T(2) };
+        vec a(std::move(inl));
+        VX_CHECK(a.is_inline());
+        VX_CHECK(is_sequence(a, 0, 3));
+        VX_CHECK(inl.empty());
+        VX_CHECK(inl.is_inline());
+
+        vec heap{ T(0), T(1), T(2), T(3), T(4), T(5) };
+        const T* heap_ptr = heap.data();
+        vec b(std::move(heap));
+        VX_CHECK(b.data() == heap_ptr);
+        VX_CHECK(heap.empty());
+        VX_CHECK(heap.is_inline());
+
+        a = std::move(b);
+        VX_CHECK(a.data() == heap_ptr);
+        VX_CHECK(is_sequence(a, 0, 6));
+
+        b = std::move(a);
+        a = vec{ T(7) };
+        VX_CHECK(a.size() == 1 && a.is_inline());
+        VX_CHECK(is_sequence(b, 0, 6));
+    }
+
+    VX_SECTION("swap")
+    {
+        vec a{ T(0), T(1) };
+        vec b{ T(0), T(1), T(2), T(3), T(4), T(5) };
+        vec c{ T(5), T(6), T(7), T(8), T(9), T(10) };
+
+        swap(a, b);
+        VX_CHECK(is_sequence(a, 0, 6));
+        VX_CHECK(is_sequence(b, 0, 2));
+
+        const T* a_ptr = a.data();
+        a.swap(c);
+        VX_CHECK(c.data() == a_ptr);
+        VX_CHECK(is_sequence(a, 5, 6));
+
+        vec d{ T(3) };
+        b.swap(d);
+        VX_CHECK(is_sequence(b, 3, 1));
+        VX_CHECK(is_sequence(d, 0, 2));
+    }
+
+    VX_SECTION("compare")
+    {
+        const vec a{ T(0), T(1) };
+        const vec b{ T(0), T(2) };
+        VX_CHECK(a != b);
+        VX_CHECK(a < b);
+        VX_CHECK(b >= a);
+        VX_CHECK(a == (vec{ T(0), T(1) }));
+    }
+}
+
+//=========================================================================
+
+VX_TEST_CASE(small_vector_trivial)
+{
+    test_small_vector<int>();
+}
+
+VX_TEST_CASE(small_vector_non_trivial)
+{
+    test_small_vector<tracked>();
+    VX_CHECK(tracked::live == 0);
+}
+
+//=========================================================================
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -0,0 +1,197 @@
+#define VX_ENABLE_LOGGING 1
+
+#include "vertex_test/test.hpp"
+#include "vertex/os/file.hpp"
+#include "vertex/os/filesystem.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/system/log.hpp"
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const os::path temp_path = os::filesystem::get_temp_path();
+static const os::path log_file = temp_path / "vx_log_test.log";
+static const std::string log_name = log_file.string();
+
+static std::vector<std::string> read_lines()
+{
+    std::vector<std::string> lines;
+
+    os::file f;
+    if (f.open(log_file, os::file::mode::read))
+    {
+        std::string line;
+        while (f.read_line(line))
+        {
+            lines.push_back(line);
+        }
+    }
+
+    return lines;
+}
+
+static size_t count_lines_containing(const std::vector<std::string>& lines, const char* text)
+{
+    size_t count = 0;
+    for (const auto& line : lines)
+    {
+        count += (line.find(text) != std::string::npos);
+    }
+    return count;
+}
+
+struct counted
+{
+    int* count;
+};
+
+static std::ostream& operator<<(std::ostream& os, const counted& c)
+{
+    ++*c.count;
+    return os << "counted";
+}
+
+struct nested
+{
+};
+
+static std::ostream& operator<<(std::ostream& os, const nested&)
+{
+    VX_LOG_INFO("inner message");
+    return os << "outer message";
+}
+
+static void log_messages(size_t thread_index, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        VX_LOG_INFO("thread ", thread_index, " message ", i);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_log_level)
+{
+    VX_CHECK(log::start(log_name.c_str()));
+
+    log::set_level(log::level::warning);
+    VX_CHECK(log::get_level() == log::level::warning);
+    VX_CHECK(!log::should_log(log::level::info));
+    VX_CHECK(log::should_log(log::level::error));
+
+    // arguments below the level are never formatted
+    int formatted = 0;
+    VX_LOG_INFO(counted{ &formatted });
+    VX_CHECK(formatted == 0);
+
+    VX_LOG_ERROR(counted{ &formatted });
+    VX_CHECK(formatted == 1);
+
+    log::set_level(log::level::trace);
+    log::stop();
+
+    const auto lines = read_lines();
+    VX_CHECK(lines.size() == 1);
+    VX_CHECK(count_lines_containing(lines, "[ERROR] counted") == 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_log_sync)
+{
+    VX_CHECK(log::start(log_name.c_str()));
+    VX_CHECK(log::is_enabled());
+
+    VX_LOG_INFO("first ", 1);
+    VX_LOG_WARNING("second ", 2.5);
+
+    // formatting state does not leak into the next message
+    VX_LOG_DEBUG(std::hex, 255);
+    VX_LOG_DEBUG(255);
+
+    // a message formatted while formatting another one
+    VX_LOG_INFO(nested{});
+
+    log::flush();
+
+    const auto lines = read_lines();
+    VX_CHECK(lines.size() == 6);
+    VX_CHECK(lines[0] == "[INFO] first 1");
+    VX_CHECK(lines[1] == "[WARNING] second 2.5");
+    VX_CHECK(lines[2] == "[DEBUG] ff");
+    VX_CHECK(lines[3] == "[DEBUG] 255");
+    VX_CHECK(lines[4] == "[INFO] inner message");
+    VX_CHECK(lines[5] == "[INFO] outer message");
+
+    log::stop();
+    VX_CHECK(!log::is_enabled());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_log_async)
+{
+    constexpr size_t thread_count = 4;
+    constexpr size_t per_thread = 5000;
+
+    VX_CHECK(log::start(log_name.c_str(), true));
+    VX_CHECK(log::is_enabled());
+
+    VX_SECTION("many threads")
+    {
+        os::thread threads[thread_count];
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            VX_CHECK(threads[t].start(log_messages, t, per_thread));
+        }
+
+        for (auto& t : threads)
+        {
+            VX_CHECK(t.join());
+        }
+
+        // everything is in the file once flush returns
+        log::flush();
+
+        const auto lines = read_lines();
+        VX_CHECK(lines.size() == thread_count * per_thread);
+
+        for (size_t t = 0; t < thread_count; ++t)
+        {
+            const std::string last = "[INFO] thread " + std::to_string(t) + " message " + std::to_string(per_thread - 1);
+            VX_CHECK(count_lines_containing(lines, last.c_str()) == 1);
+        }
+    }
+
+    VX_SECTION("long message")
+    {
+        const std::string text(5000, 'x');
+        VX_LOG_INFO(text);
+        log::flush();
+
+        const auto lines = read_lines();
+        VX_CHECK(lines.back() == "[INFO] " + text);
+    }
+
+    VX_SECTION("stop")
+    {
+        VX_LOG_INFO("last message");
+        log::stop();
+        VX_CHECK(!log::is_enabled());
+
+        const auto lines = read_lines();
+        VX_CHECK(lines.back() == "[INFO] last message");
+    }
+
+    os::filesystem::remove(log_file);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
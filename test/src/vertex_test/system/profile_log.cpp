@@ -0,0 +1,134 @@
+#define VX_ENABLE_LOGGING 1
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "vertex/os/compiler.hpp"
+#include "vertex/os/filesystem.hpp"
+#include "vertex/os/time.hpp"
+#include "vertex/system/log.hpp"
+#define VX_ENABLE_PROFILING
+#include "vertex/system/profiler.hpp"
+
+//=========================================================================
+
+// Times the logger with several threads logging as fast as they can to a
+// file.
+//
+// sync is the original behavior: every message is written and flushed under
+// a mutex shared by all threads. async formats on the calling thread and
+// hands the message to the background writer. Each run is timed until every
+// message has reached the file, including the final flush. Every call is timed
+// on the logging thread as well, and the p50 and p99 of those caller side
+// latencies are recorded as results of their own.
+
+static constexpr size_t RR = 5; // number of repetitions
+static constexpr size_t total = 200000;
+
+#define start_timer(str) ::vx::profile::_priv::profile_timer timer(str)
+#define stop_timer()     timer.stop()
+
+// returns the given percentile of the latencies in nanoseconds, reorders them
+static int64_t percentile(std::vector<int64_t>& latencies, size_t pct)
+{
+    const size_t i = (latencies.size() - 1) * pct / 100;
+    std::nth_element(latencies.begin(), latencies.begin() + i, latencies.end());
+    return latencies[i];
+}
+
+//=========================================================================
+
+VX_NO_INLINE void profile_log(const std::string& name, const std::string& filename, bool async, size_t thread_count)
+{
+    const size_t per_thread = total / thread_count;
+
+    vx::log::start(filename.c_str(), async);
+
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    std::vector<std::vector<int64_t>> latencies(thread_count);
+
+    for (size_t t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            auto& lat = latencies[t];
+            lat.reserve(per_thread);
+
+            while (!go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+
+            for (size_t i = 0; i < per_thread; ++i)
+            {
+                const vx::time::time_point call_start = vx::os::get_ticks();
+                VX_LOG_INFO("thread ", t, " message ", i, " value ", 0.5 * static_cast<double>(i));
+                lat.push_back((vx::os::get_ticks() - call_start).as_nanoseconds());
+            }
+        });
+    }
+
+    const vx::time::time_point run_start = vx::os::get_ticks();
+
+    start_timer(name);
+    go.store(true, std::memory_order_release);
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    vx::log::flush();
+    stop_timer();
+
+    vx::log::stop();
+
+    std::vector<int64_t> all;
+    all.reserve(thread_count * per_thread);
+    for (const auto& lat : latencies)
+    {
+        all.insert(all.end(), lat.begin(), lat.end());
+    }
+
+    vx::profile::record({ name + " p50 call", run_start, vx::time::nanoseconds(percentile(all, 50)) });
+    vx::profile::record({ name + " p99 call", run_start, vx::time::nanoseconds(percentile(all, 99)) });
+}
+
+//=========================================================================
+
+static void run(const std::string& filename, size_t R)
+{
+    const size_t thread_counts[] = { 1, 4, 16 };
+
+    for (const size_t thread_count : thread_counts)
+    {
+        const std::string suffix = " (" + std::to_string(thread_count) + " threads)";
+
+        for (size_t r = 0; r < R; ++r)
+        {
+            profile_log("sync" + suffix, filename, false, thread_count);
+            profile_log("async" + suffix, filename, true, thread_count);
+        }
+    }
+}
+
+int main()
+{
+    const std::string filename = (vx::os::filesystem::get_temp_path() / "vx_profile_log.log").string();
+
+    // warmup
+    run(filename, 1);
+
+    VX_PROFILE_START_APPEND("profile_log.csv");
+
+    run(filename, RR);
+
+    VX_PROFILE_STOP();
+
+    vx::os::filesystem::remove(filename);
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "vertex_test/test.hpp"
+#include "vertex/os/file.hpp"
+#include "vertex/os/filesystem.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/time.hpp"
+#include "vertex/system/profiler.hpp"
+
+using namespace vx;
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const os::path temp_path = os::filesystem::get_temp_path();
+static const os::path csv_file = temp_path / "vx_profiler_test.csv";
+static const os::path trace_file = temp_path / "vx_profiler_test.trace.json";
+static const std::string csv_name = csv_file.string();
+
+static size_t count_lines(const os::path& p)
+{
+    // lines() yields views into the file buffer
+    os::file f;
+    if (!f.set_buffer_size(os::file::default_buffer_size) || !f.open(p, os::file::mode::read))
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (const auto& line : f.lines())
+    {
+        (void)line;
+        ++count;
+    }
+
+    return count;
+}
+
+static size_t count_occurrences(const std::string& text, const char* pattern)
+{
+    const std::string p = pattern;
+    size_t count = 0;
+
+    for (size_t pos = text.find(p); pos != std::string::npos; pos = text.find(p, pos + p.size()))
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+static std::string read_text(const os::path& p)
+{
+    std::string text;
+    os::file::read_file(p, text);
+    return text;
+}
+
+static bool is_closed_array(const std::string& text)
+{
+    return text.size() >= 4 && text.front() == '[' && text.compare(text.size() - 3, 3, "\n]\n") == 0;
+}
+
+static void nested_scopes(size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        profile::_priv::profile_timer outer("outer");
+        profile::_priv::profile_timer inner("inner");
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+VX_TEST_CASE(test_profiler)
+{
+    constexpr size_t thread_count = 4;
+    constexpr size_t scopes_per_thread = 1000;
+
+    VX_SECTION("record")
+    {
+        VX_CHECK(!profile::is_enabled());
+        VX_CHECK(profile::start(csv_name.c_str()));
+        VX_CHECK(profile::is_enabled());
+
+        os::thread threads[thread_count];
+        for (auto& t : threads)
+        {
+            VX_CHECK(t.start(nested_scopes, scopes_per_thread));
+        }
+
+        nested_scopes(scopes_per_thread);
+
+        // dynamic names are copied once
+        const std::string name = "dynamic, \"quoted\" name";
+        {
+            profile::_priv::profile_timer timer(name);
+        }
+
+        profile::record({ "result", os::get_ticks(), time::microseconds(5) });
+
+        for (auto& t : threads)
+        {
+            VX_CHECK(t.join());
+        }
+
+        profile::stop();
+        VX_CHECK(!profile::is_enabled());
+
+        const size_t scopes = (thread_count + 1) * scopes_per_thread * 2 + 2;
+
+        // header + one line per scope
+        VX_CHECK(count_lines(csv_file) == scopes + 1);
+
+        const std::string trace = read_text(trace_file);
+        VX_CHECK(is_closed_array(trace));
+        VX_CHECK(count_occurrences(trace, "\"ph\":\"X\"") == scopes);
+        VX_CHECK(count_occurrences(trace, "\"name\":\"outer\"") == (thread_count + 1) * scopes_per_thread);
+        VX_CHECK(count_occurrences(trace, "\"name\":\"dynamic, \\\"quoted\\\" name\"") == 1);
+
+        const std::string csv = read_text(csv_file);
+        VX_CHECK(count_occurrences(csv, "\"dynamic, \"\"quoted\"\" name\",") == 1);
+    }
+
+    VX_SECTION("more than one buffer")
+    {
+        // each batch fills a quarter of the thread's buffer, which wakes the
+        // writer, so it drains the events before the buffer can overflow
+        constexpr size_t batches = 5;
+        constexpr size_t scopes_per_batch = 8 * 1024;
+
+        const std::string name = "batch";
+
+        VX_CHECK(profile::start(csv_name.c_str()));
+
+        for (size_t b = 0; b < batches; ++b)
+        {
+            for (size_t i = 0; i < scopes_per_batch; ++i)
+            {
+                profile::_priv::profile_timer outer(name);
+                profile::_priv::profile_timer inner("inner");
+            }
+
+            os::sleep(time::milliseconds(200));
+        }
+
+        profile::stop();
+
+        VX_CHECK(count_lines(csv_file) == batches * scopes_per_batch * 2 + 1);
+
+        const std::string trace = read_text(trace_file);
+        VX_CHECK(is_closed_array(trace));
+        VX_CHECK(count_occurrences(trace, "dropped") == 0);
+    }
+
+    VX_SECTION("disabled")
+    {
+        nested_scopes(10);
+
+        VX_CHECK(profile::start(csv_name.c_str()));
+        profile::stop();
+
+        VX_CHECK(count_lines(csv_file) == 1);
+        VX_CHECK(read_text(trace_file) == "[\n]\n");
+    }
+
+    VX_SECTION("append")
+    {
+        VX_CHECK(profile::start(csv_name.c_str()));
+        nested_scopes(1);
+        profile::stop();
+
+        VX_CHECK(profile::start(csv_name.c_str(), false));
+        nested_scopes(2);
+        profile::stop();
+
+        VX_CHECK(count_lines(csv_file) == 1 + 2 + 4);
+
+        const std::string trace = read_text(trace_file);
+        VX_CHECK(is_closed_array(trace));
+        VX_CHECK(count_occurrences(trace, "\"ph\":\"X\"") == 6);
+        VX_CHECK(count_occurrences(trace, "]") == 1);
+    }
+
+    VX_SECTION("append to a file that is not a trace")
+    {
+        const char text[] = "not a trace";
+        VX_CHECK(os::file::write_file(trace_file, reinterpret_cast<const uint8_t*>(text), sizeof(text) - 1));
+
+        // the file is left as it is
+        VX_CHECK_AND_EXPECT_ERROR(!profile::start(csv_name.c_str(), false));
+        VX_CHECK(!profile::is_enabled());
+        VX_CHECK(read_text(trace_file) == text);
+    }
+
+    os::filesystem::remove(csv_file);
+    os::filesystem::remove(trace_file);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+int main()
+{
+    VX_RUN_TESTS();
+    return 0;
+}
@@ -1138,6 +1138,7 @@ inline void clear_event_filter()
  *
  * @param callback Function pointer to the event watch callback.
  * @param user_data User-defined data pointer passed to the callback.
+ * @return true if the watch was added, false if it could not be stored.
  *
  * @note The watch callback **may be called from a different thread** than the main event thread,
  *       so users must ensure thread safety when accessing shared resources.
@@ -1151,7 +1152,7 @@ inline void clear_event_filter()
  * @note The main event filter runs first and can block events; events filtered out
  *       will not be sent to the watch callbacks.
  */
-VX_API void add_event_watch(event_filter callback, void* user_data);
+VX_API bool add_event_watch(event_filter callback, void* user_data);
 
 /**
  * @brief Removes a previously added event watch callback.
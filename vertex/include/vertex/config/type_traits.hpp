@@ -461,7 +461,7 @@ private:
 public:
 
     // For is_invocable_r
-    using type = decltype(_S_test<Ret, /* Nothrow = */ true>(1));
+    using type = decltype(test<Ret, /* Nothrow = */ true>(1));
 
     // For is_nothrow_invocable_r
     using nothrow_conv = decltype(test<Ret>(1));
@@ -34,6 +34,28 @@ enum : size_t
     max_bytes = (max_dimensions * max_dimensions * max_channels)
 };
 
+struct image_info
+{
+    size_t width, height;
+    pixel_format format;
+
+    size_t channels() const noexcept
+    {
+        return pixel::get_pixel_channel_count(static_cast<pixel::pixel_format>(format));
+    }
+
+    size_t pixel_size() const noexcept
+    {
+        return pixel::get_pixel_size(static_cast<pixel::pixel_format>(format));
+    }
+
+    // number of bytes needed to hold the decoded pixels
+    size_t data_size() const noexcept
+    {
+        return width * height * pixel_size();
+    }
+};
+
 class image;
 
 using byte_type = pixel::byte_type;
@@ -245,6 +245,18 @@ public:
         }
     }
 
+    byte_type* data()
+    {
+        switch (m_format)
+        {
+            case pixel_format::r_8:     return m_r.data();
+            case pixel_format::rg_8:    return m_rg.data();
+            case pixel_format::rgb_8:   return m_rgb.data();
+            case pixel_format::rgba_8:  return m_rgba.data();
+            default:                    return nullptr;
+        }
+    }
+
     size_t data_size() const
     {
         switch (m_format)
@@ -3,11 +3,73 @@
 #include <string>
 
 #include "vertex/image/image.hpp"
+#include "vertex/std/span.hpp"
 
 namespace vx {
 namespace img {
 
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Reads the size and format of an image file without decoding it.
+///
+/// The file is mapped and only the pages holding the header are read.
+///
+/// @param filename The file to read.
+/// @param info Receives the size and format of the image.
+///
+/// @return True if the header was read, false otherwise.
+///////////////////////////////////////////////////////////////////////////////
+VX_API bool load_info(const std::string& filename, image_info& info);
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Reads the size and format of an encoded image in memory.
+///
+/// @param data The encoded file.
+/// @param info Receives the size and format of the image.
+///
+/// @return True if the header was read, false otherwise.
+///////////////////////////////////////////////////////////////////////////////
+VX_API bool load_info_from_memory(span<const byte_type> data, image_info& info);
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Loads an image file.
+///
+/// The file is mapped and read once. The pixels are decoded straight into
+/// the storage of the image.
+///
+/// @param filename The file to read.
+/// @param img Receives the image.
+///
+/// @return True if the image was loaded, false otherwise.
+///////////////////////////////////////////////////////////////////////////////
 VX_API bool load(const std::string& filename, image& img);
 
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Loads an image from an encoded file in memory.
+///
+/// @param data The encoded file.
+/// @param img Receives the image.
+///
+/// @return True if the image was loaded, false otherwise.
+///////////////////////////////////////////////////////////////////////////////
+VX_API bool load_from_memory(span<const byte_type> data, image& img);
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Decodes an encoded file in memory into caller owned storage.
+///
+/// Use load_info_from_memory to find the size of the pixels first. pixels
+/// must hold at least `info.data_size()` bytes, the image is written to the
+/// start and the rest is left untouched. Decoders whose output buffer has
+/// exactly the size of the image (PNG, BMP) write into pixels directly, the
+/// others (JPEG) decode into a temporary buffer that is copied.
+///
+/// @param data The encoded file.
+/// @param pixels Receives the decoded pixels, tightly packed.
+/// @param info Receives the size and format of the image.
+///
+/// @return True if the image was decoded, false if it could not be decoded
+/// or pixels is too small.
+///////////////////////////////////////////////////////////////////////////////
+VX_API bool load_from_memory(span<const byte_type> data, span<byte_type> pixels, image_info& info);
+
 } // namespace img
-} // namespace vx
\ No newline at end of file
+} // namespace vx
@@ -1,15 +1,66 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "vertex/image/image.hpp"
+#include "vertex/pixel/execution_policy.hpp"
 
 namespace vx {
 namespace img {
 
+///////////////////////////////////////////////////////////////////////////////
+// png options
+///////////////////////////////////////////////////////////////////////////////
+
+enum class png_compression
+{
+    store,      // no compression, the fastest
+    fast,       // runs of repeated bytes only
+    normal,     // short match searches, the default
+    max         // long match searches, the smallest files
+};
+
+// The filter applied to each row before compression.
+enum class png_filter
+{
+    adaptive,   // per row, the filter giving the smallest sum of differences
+    none,
+    sub,
+    up,
+    average,
+    paeth
+};
+
+struct png_write_options
+{
+    png_compression compression = png_compression::normal;
+    png_filter filter = png_filter::adaptive;
+
+    // Filtering and compression run in bands on the pool of a parallel
+    // policy. The image is compressed in fixed size pieces whatever the
+    // policy, so the output does not depend on the number of threads.
+    pixel::execution_policy policy;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// write
+///////////////////////////////////////////////////////////////////////////////
+
 VX_API bool write_bmp(const std::string& filename, const image& img);
 VX_API bool write_jpg(const std::string& filename, const image& img, int quality = 75);
-VX_API bool write_png(const std::string& filename, const image& img);
+VX_API bool write_png(const std::string& filename, const image& img, const png_write_options& options = png_write_options());
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Encodes an image as a png file in memory.
+///
+/// @param img The image to encode.
+/// @param data Receives the file, replacing its contents.
+/// @param options The compression settings.
+///
+/// @return True if the image was encoded, false otherwise.
+///////////////////////////////////////////////////////////////////////////////
+VX_API bool write_png_to_memory(const image& img, std::vector<byte_type>& data, const png_write_options& options = png_write_options());
 
 } // namespace img
-} // namespace vx
\ No newline at end of file
+} // namespace vx
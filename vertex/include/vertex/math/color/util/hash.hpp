@@ -16,10 +16,10 @@ struct hash<vx::math::color_t<T>>
     {
         size_t seed = 0;
 
-        hash_combine(seed, c.r);
-        hash_combine(seed, c.g);
-        hash_combine(seed, c.b);
-        hash_combine(seed, c.a);
+        vx::hash_combine(seed, c.r);
+        vx::hash_combine(seed, c.g);
+        vx::hash_combine(seed, c.b);
+        vx::hash_combine(seed, c.a);
 
         return seed;
     }
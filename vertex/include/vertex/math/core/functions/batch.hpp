@@ -0,0 +1,353 @@
+#pragma once
+
+#include "vertex/math/core/functions/matrix.hpp"
+#include "vertex/math/core/functions/rotation_cast.hpp"
+#include "vertex/math/simd/batch.hpp"
+
+// Functions over arrays, for work like transforming a mesh or a skinning
+// palette. Where simd::batch_t has a kernel the elements go through it
+// several at a time, the rest use the scalar functions. The results are the
+// same as calling the scalar function on every element, except slerp which
+// approximates acos and sin and is within 1e-6 of it.
+//
+// The output may be the same array as an input of the same type.
+
+namespace vx {
+namespace math {
+namespace batch {
+namespace _priv {
+
+///////////////////////////////////////////////////////////////////////////////
+// kernels
+///////////////////////////////////////////////////////////////////////////////
+
+// Each returns the number of elements done, 0 without a kernel.
+
+template <size_t In, size_t Out, bool Soa, typename T, VX_MATH_REQ(!(simd::batch_t<T>::HAVE_TRANSFORM))>
+VX_FORCE_INLINE size_t transform(const mat<4, 4, T>&, const T*, T, T* const*, size_t) noexcept
+{
+    return 0;
+}
+
+template <size_t In, size_t Out, bool Soa, typename T, VX_MATH_REQ((simd::batch_t<T>::HAVE_TRANSFORM))>
+VX_FORCE_INLINE size_t transform(const mat<4, 4, T>& m, const T* in, T w, T* const* out, size_t count) noexcept
+{
+    return simd::batch_t<T>::template transform<In, Out, Soa>(&m.columns[0].x, in, w, out, count);
+}
+
+template <typename T, VX_MATH_REQ(!(simd::batch_t<T>::HAVE_MUL))>
+VX_FORCE_INLINE size_t mul(const T*, size_t, const T*, T*, size_t) noexcept
+{
+    return 0;
+}
+
+template <typename T, VX_MATH_REQ((simd::batch_t<T>::HAVE_MUL))>
+VX_FORCE_INLINE size_t mul(const T* a, size_t a_stride, const T* b, T* out, size_t count) noexcept
+{
+    return simd::batch_t<T>::mul(a, a_stride, b, out, count);
+}
+
+template <typename T, VX_MATH_REQ(!(simd::batch_t<T>::HAVE_INVERSE))>
+VX_FORCE_INLINE size_t inverse(const T*, T*, size_t) noexcept
+{
+    return 0;
+}
+
+template <typename T, VX_MATH_REQ((simd::batch_t<T>::HAVE_INVERSE))>
+VX_FORCE_INLINE size_t inverse(const T* in, T* out, size_t count) noexcept
+{
+    return simd::batch_t<T>::inverse(in, out, count);
+}
+
+template <typename T, VX_MATH_REQ(!(simd::batch_t<T>::HAVE_ROTATION_CAST))>
+VX_FORCE_INLINE size_t rotation_cast(const T*, T*, size_t) noexcept
+{
+    return 0;
+}
+
+template <typename T, VX_MATH_REQ((simd::batch_t<T>::HAVE_ROTATION_CAST))>
+VX_FORCE_INLINE size_t rotation_cast(const T* in, T* out, size_t count) noexcept
+{
+    return simd::batch_t<T>::rotation_cast(in, out, count);
+}
+
+template <typename T, VX_MATH_REQ(!(simd::batch_t<T>::HAVE_SLERP))>
+VX_FORCE_INLINE size_t slerp(const T*, const T*, T, T*, size_t) noexcept
+{
+    return 0;
+}
+
+template <typename T, VX_MATH_REQ((simd::batch_t<T>::HAVE_SLERP))>
+VX_FORCE_INLINE size_t slerp(const T* x, const T* y, T t, T* out, size_t count) noexcept
+{
+    return simd::batch_t<T>::slerp(x, y, t, out, count);
+}
+
+template <size_t In, typename T>
+VX_FORCE_INLINE vec<4, T> extend(const T* v, T w) noexcept
+{
+    return vec<4, T>(v[0], v[1], v[2], (In == 4) ? v[3] : w);
+}
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+// transform
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Multiplies every vector of an array by a matrix.
+///
+/// @param m The matrix.
+/// @param in The vectors.
+/// @param out The results, out[i] = m * in[i].
+/// @param count The number of vectors.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void transform(const mat<4, 4, T>& m, const vec<4, T>* in, vec<4, T>* out, size_t count) noexcept
+{
+    T* const dst[1] = { reinterpret_cast<T*>(out) };
+    size_t i = _priv::transform<4, 4, false>(m, reinterpret_cast<const T*>(in), static_cast<T>(0), dst, count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = m * in[i];
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Multiplies every vector of an array by a matrix, writing each
+/// component of the results to its own array.
+///
+/// @param m The matrix.
+/// @param in The vectors.
+/// @param x, y, z, w The components of m * in[i] go to x[i], y[i], z[i] and
+/// w[i].
+/// @param count The number of vectors.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void transform(const mat<4, 4, T>& m, const vec<4, T>* in, T* x, T* y, T* z, T* w, size_t count) noexcept
+{
+    T* const dst[4] = { x, y, z, w };
+    size_t i = _priv::transform<4, 4, true>(m, reinterpret_cast<const T*>(in), static_cast<T>(0), dst, count);
+
+    for (; i < count; ++i)
+    {
+        const vec<4, T> v = m * in[i];
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+        w[i] = v.w;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Transforms an array of points by a matrix.
+///
+/// There is no perspective divide, out[i] is the x, y and z of
+/// m * vec4(in[i], 1).
+///
+/// @param m The matrix.
+/// @param in The points.
+/// @param out The transformed points.
+/// @param count The number of points.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void transform_points(const mat<4, 4, T>& m, const vec<3, T>* in, vec<3, T>* out, size_t count) noexcept
+{
+    T* const dst[1] = { reinterpret_cast<T*>(out) };
+    size_t i = _priv::transform<3, 3, false>(m, reinterpret_cast<const T*>(in), static_cast<T>(1), dst, count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = vec<3, T>(m * vec<4, T>(in[i], static_cast<T>(1)));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Transforms an array of points by a matrix, writing each component
+/// of the results to its own array.
+///
+/// @param m The matrix.
+/// @param in The points.
+/// @param x, y, z The components of m * vec4(in[i], 1) go to x[i], y[i] and
+/// z[i].
+/// @param count The number of points.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void transform_points(const mat<4, 4, T>& m, const vec<3, T>* in, T* x, T* y, T* z, size_t count) noexcept
+{
+    T* const dst[3] = { x, y, z };
+    size_t i = _priv::transform<3, 3, true>(m, reinterpret_cast<const T*>(in), static_cast<T>(1), dst, count);
+
+    for (; i < count; ++i)
+    {
+        const vec<4, T> v = m * vec<4, T>(in[i], static_cast<T>(1));
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Transforms an array of directions by a matrix.
+///
+/// The translation of the matrix is ignored, out[i] is the x, y and z of
+/// m * vec4(in[i], 0).
+///
+/// @param m The matrix.
+/// @param in The directions.
+/// @param out The transformed directions.
+/// @param count The number of directions.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void transform_directions(const mat<4, 4, T>& m, const vec<3, T>* in, vec<3, T>* out, size_t count) noexcept
+{
+    T* const dst[1] = { reinterpret_cast<T*>(out) };
+    size_t i = _priv::transform<3, 3, false>(m, reinterpret_cast<const T*>(in), static_cast<T>(0), dst, count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = vec<3, T>(m * vec<4, T>(in[i], static_cast<T>(0)));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Transforms an array of directions by a matrix, writing each
+/// component of the results to its own array.
+///
+/// @param m The matrix.
+/// @param in The directions.
+/// @param x, y, z The components of m * vec4(in[i], 0) go to x[i], y[i] and
+/// z[i].
+/// @param count The number of directions.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void transform_directions(const mat<4, 4, T>& m, const vec<3, T>* in, T* x, T* y, T* z, size_t count) noexcept
+{
+    T* const dst[3] = { x, y, z };
+    size_t i = _priv::transform<3, 3, true>(m, reinterpret_cast<const T*>(in), static_cast<T>(0), dst, count);
+
+    for (; i < count; ++i)
+    {
+        const vec<4, T> v = m * vec<4, T>(in[i], static_cast<T>(0));
+        x[i] = v.x;
+        y[i] = v.y;
+        z[i] = v.z;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// mul
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Multiplies two arrays of matrices element by element.
+///
+/// @param a The left matrices.
+/// @param b The right matrices.
+/// @param out The products, out[i] = a[i] * b[i].
+/// @param count The number of matrices.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void mul(const mat<4, 4, T>* a, const mat<4, 4, T>* b, mat<4, 4, T>* out, size_t count) noexcept
+{
+    size_t i = _priv::mul(reinterpret_cast<const T*>(a), 16, reinterpret_cast<const T*>(b), reinterpret_cast<T*>(out), count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = a[i] * b[i];
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Multiplies one matrix by every matrix of an array, like a parent
+/// transform applied to a skinning palette.
+///
+/// @param a The left matrix.
+/// @param b The right matrices.
+/// @param out The products, out[i] = a * b[i].
+/// @param count The number of matrices.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void mul(const mat<4, 4, T>& a, const mat<4, 4, T>* b, mat<4, 4, T>* out, size_t count) noexcept
+{
+    size_t i = _priv::mul(&a.columns[0].x, 0, reinterpret_cast<const T*>(b), reinterpret_cast<T*>(out), count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = a * b[i];
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// inverse
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Inverts every matrix of an array.
+///
+/// @param in The matrices.
+/// @param out The inverses, out[i] = inverse(in[i]).
+/// @param count The number of matrices.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void inverse(const mat<4, 4, T>* in, mat<4, 4, T>* out, size_t count) noexcept
+{
+    size_t i = _priv::inverse(reinterpret_cast<const T*>(in), reinterpret_cast<T*>(out), count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = math::inverse(in[i]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// rotation cast
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Converts an array of quaternions to rotation matrices.
+///
+/// @param in The quaternions.
+/// @param out The matrices, out[i] = rotation_cast<mat4>(in[i]).
+/// @param count The number of quaternions.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void rotation_cast(const quat_t<T>* in, mat<4, 4, T>* out, size_t count) noexcept
+{
+    size_t i = _priv::rotation_cast(reinterpret_cast<const T*>(in), reinterpret_cast<T*>(out), count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = math::rotation_cast<mat<4, 4, T>>(in[i]);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// slerp
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Spherically interpolates between two arrays of quaternions.
+///
+/// @param x The quaternions at t = 0.
+/// @param y The quaternions at t = 1.
+/// @param t The interpolation factor, the same for every pair.
+/// @param out The results, out[i] = slerp(x[i], y[i], t) within 1e-6.
+/// @param count The number of quaternions.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, VX_MATH_REQ_FLOAT(T)>
+inline void slerp(const quat_t<T>* x, const quat_t<T>* y, T t, quat_t<T>* out, size_t count) noexcept
+{
+    size_t i = _priv::slerp(reinterpret_cast<const T*>(x), reinterpret_cast<const T*>(y), t, reinterpret_cast<T*>(out), count);
+
+    for (; i < count; ++i)
+    {
+        out[i] = math::slerp(x[i], y[i], t);
+    }
+}
+
+} // namespace batch
+} // namespace math
+} // namespace vx
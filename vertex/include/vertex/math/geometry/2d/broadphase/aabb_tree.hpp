@@ -0,0 +1,784 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "vertex/math/geometry/2d/functions/collision.hpp"
+
+namespace vx {
+namespace math {
+namespace g2 {
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief A dynamic bounding volume hierarchy of rects, for finding which of
+/// many moving objects touch without testing every pair.
+///
+/// Each object is kept in the tree with its bounds grown by a margin, so an
+/// object that moves a little does not have to be reinserted. The grown
+/// bounds only prune the search, the queries test the bounds given to
+/// insert and move with the functions of collision.hpp. The tree is kept
+/// balanced by rotations, and its nodes live in one array so walking it
+/// stays in cache.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class aabb_tree
+{
+    static_assert(is_float<T>::value, "aabb_tree needs a floating point type");
+
+public:
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // meta
+    ///////////////////////////////////////////////////////////////////////////////
+
+    using scalar_type = T;
+    using rect_type = rect_t<T>;
+    using point_type = point_t<T>;
+    using ray_type = ray_t<T>;
+    using id_type = uint32_t;
+
+    enum : id_type { invalid_id = 0xFFFFFFFF };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // construction
+    ///////////////////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Creates an empty tree.
+    ///
+    /// @param margin How far the bounds of each object are grown on every
+    /// side. Larger margins mean fewer reinsertions when objects move, but
+    /// looser pruning.
+    ///////////////////////////////////////////////////////////////////////////////
+    explicit aabb_tree(scalar_type margin = static_cast<scalar_type>(0.1)) noexcept
+        : m_margin(margin) {}
+
+    size_t size() const noexcept { return m_count; }
+    bool empty() const noexcept { return m_count == 0; }
+    scalar_type margin() const noexcept { return m_margin; }
+
+    // The number of levels below the root, 0 for a single object.
+    size_t height() const noexcept
+    {
+        return (m_root == invalid_id) ? 0 : static_cast<size_t>(m_nodes[m_root].height);
+    }
+
+    // The grown bounds of every object.
+    rect_type bounds() const noexcept
+    {
+        return (m_root == invalid_id) ? rect_type() : m_nodes[m_root].bounds;
+    }
+
+    void reserve(size_t count)
+    {
+        // every object is a leaf with a parent, except the root
+        m_nodes.reserve(count * 2);
+    }
+
+    void clear() noexcept
+    {
+        m_nodes.clear();
+        m_root = invalid_id;
+        m_free = invalid_id;
+        m_count = 0;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // objects
+    ///////////////////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Adds an object.
+    ///
+    /// @param bounds The bounds of the object.
+    /// @param user_data A value to keep with the object.
+    ///
+    /// @return The id of the object, valid until it is removed.
+    ///////////////////////////////////////////////////////////////////////////////
+    id_type insert(const rect_type& bounds, size_t user_data = 0)
+    {
+        const id_type leaf = allocate_node();
+
+        node& n = m_nodes[leaf];
+        n.bounds = inflate(bounds, m_margin, m_margin);
+        n.object = bounds;
+        n.user_data = user_data;
+        n.height = 0;
+
+        insert_leaf(leaf);
+        ++m_count;
+
+        return leaf;
+    }
+
+    void remove(id_type id)
+    {
+        VX_ASSERT(is_object(id));
+
+        remove_leaf(id);
+        free_node(id);
+        --m_count;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Updates the bounds of an object.
+    ///
+    /// The object is only moved in the tree when its new bounds leave its
+    /// grown bounds. The grown bounds are then stretched in the direction of
+    /// displacement, so an object moving steadily is reinserted less often.
+    ///
+    /// @param id The object.
+    /// @param bounds The new bounds of the object.
+    /// @param displacement How far the object moved since the last update.
+    ///
+    /// @return true if the object was moved in the tree.
+    ///////////////////////////////////////////////////////////////////////////////
+    bool move(id_type id, const rect_type& bounds, const vec<2, scalar_type>& displacement = vec<2, scalar_type>(0))
+    {
+        VX_ASSERT(is_object(id));
+
+        m_nodes[id].object = bounds;
+
+        const vec<2, scalar_type> d = displacement * displacement_scale;
+        const scalar_type zero = static_cast<scalar_type>(0);
+
+        const rect_type fat = grow_sides(
+            inflate(bounds, m_margin, m_margin),
+            max(-d.x, zero), max(d.x, zero),
+            max(-d.y, zero), max(d.y, zero)
+        );
+
+        const rect_type& current = m_nodes[id].bounds;
+        if (contains(current, bounds))
+        {
+            // still inside, unless the grown bounds have become too large
+            const scalar_type limit = static_cast<scalar_type>(4) * m_margin;
+
+            if (contains(inflate(fat, limit, limit), current))
+            {
+                return false;
+            }
+        }
+
+        remove_leaf(id);
+        m_nodes[id].bounds = fat;
+        insert_leaf(id);
+        return true;
+    }
+
+    const rect_type& get_bounds(id_type id) const noexcept
+    {
+        VX_ASSERT(is_object(id));
+        return m_nodes[id].object;
+    }
+
+    const rect_type& get_fat_bounds(id_type id) const noexcept
+    {
+        VX_ASSERT(is_object(id));
+        return m_nodes[id].bounds;
+    }
+
+    size_t get_user_data(id_type id) const noexcept
+    {
+        VX_ASSERT(is_object(id));
+        return m_nodes[id].user_data;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // queries
+    ///////////////////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Calls fn(id) for every object whose bounds b satisfy
+    /// overlaps(area, b).
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void query(const rect_type& area, F&& fn) const
+    {
+        id_type stack[max_stack];
+        size_t top = 0;
+
+        if (m_root != invalid_id)
+        {
+            stack[top++] = m_root;
+        }
+
+        while (top != 0)
+        {
+            const node& n = m_nodes[stack[--top]];
+
+            if (!touches(n.bounds, area))
+            {
+                continue;
+            }
+
+            if (n.is_leaf())
+            {
+                if (overlaps(area, n.object))
+                {
+                    fn(static_cast<id_type>(&n - m_nodes.data()));
+                }
+            }
+            else
+            {
+                VX_ASSERT(top + 2 <= max_stack);
+                stack[top++] = n.child1;
+                stack[top++] = n.child2;
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Calls fn(id) for every object whose bounds b satisfy
+    /// contains(b, p).
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void query(const point_type& p, F&& fn) const
+    {
+        id_type stack[max_stack];
+        size_t top = 0;
+
+        if (m_root != invalid_id)
+        {
+            stack[top++] = m_root;
+        }
+
+        while (top != 0)
+        {
+            const node& n = m_nodes[stack[--top]];
+
+            if (!touches(n.bounds, rect_type(p, vec<2, scalar_type>(0))))
+            {
+                continue;
+            }
+
+            if (n.is_leaf())
+            {
+                if (contains(n.object, p))
+                {
+                    fn(static_cast<id_type>(&n - m_nodes.data()));
+                }
+            }
+            else
+            {
+                VX_ASSERT(top + 2 <= max_stack);
+                stack[top++] = n.child1;
+                stack[top++] = n.child2;
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Casts a ray through the objects.
+    ///
+    /// fn(id, t) is called for every object the ray hits no further than
+    /// max_t, with t from raycast(ray, bounds, t), in no particular order.
+    /// It returns the new max_t: max_t to see every hit, t to only see
+    /// closer hits, or a negative value to stop.
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void raycast(const ray_type& ray, scalar_type max_t, F&& fn) const
+    {
+        id_type stack[max_stack];
+        size_t top = 0;
+
+        if (m_root != invalid_id)
+        {
+            stack[top++] = m_root;
+        }
+
+        while (top != 0)
+        {
+            const node& n = m_nodes[stack[--top]];
+
+            scalar_type t;
+            if (!g2::raycast(ray, n.bounds, t) || t > max_t)
+            {
+                continue;
+            }
+
+            if (n.is_leaf())
+            {
+                if (g2::raycast(ray, n.object, t) && t <= max_t)
+                {
+                    max_t = fn(static_cast<id_type>(&n - m_nodes.data()), t);
+
+                    if (max_t < static_cast<scalar_type>(0))
+                    {
+                        return;
+                    }
+                }
+            }
+            else
+            {
+                VX_ASSERT(top + 2 <= max_stack);
+                stack[top++] = n.child1;
+                stack[top++] = n.child2;
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Calls fn(a, b) once for every pair of objects a < b whose bounds
+    /// satisfy overlaps(bounds of a, bounds of b).
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void query_pairs(F&& fn) const
+    {
+        if (m_root == invalid_id)
+        {
+            return;
+        }
+
+        // (n, n) stands for the pairs within n, otherwise the pairs across
+        std::vector<std::pair<id_type, id_type>> stack;
+        stack.reserve(max_stack);
+        stack.emplace_back(m_root, m_root);
+
+        while (!stack.empty())
+        {
+            const id_type ia = stack.back().first;
+            const id_type ib = stack.back().second;
+            stack.pop_back();
+
+            const node& a = m_nodes[ia];
+            const node& b = m_nodes[ib];
+
+            if (ia == ib)
+            {
+                if (!a.is_leaf())
+                {
+                    stack.emplace_back(a.child1, a.child1);
+                    stack.emplace_back(a.child2, a.child2);
+                    stack.emplace_back(a.child1, a.child2);
+                }
+
+                continue;
+            }
+
+            if (!touches(a.bounds, b.bounds))
+            {
+                continue;
+            }
+
+            if (a.is_leaf() && b.is_leaf())
+            {
+                const id_type lo = min(ia, ib);
+                const id_type hi = max(ia, ib);
+
+                if (overlaps(m_nodes[lo].object, m_nodes[hi].object))
+                {
+                    fn(lo, hi);
+                }
+            }
+            else if (b.is_leaf() || (!a.is_leaf() && a.bounds.perimeter() > b.bounds.perimeter()))
+            {
+                // split the larger node
+                stack.emplace_back(a.child1, ib);
+                stack.emplace_back(a.child2, ib);
+            }
+            else
+            {
+                stack.emplace_back(ia, b.child1);
+                stack.emplace_back(ia, b.child2);
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Finds the objects closest to a point.
+    ///
+    /// The distance to an object is the distance to the closest point of its
+    /// bounds, 0 when p is inside.
+    ///
+    /// @param p The point.
+    /// @param k The most objects to find.
+    /// @param out Receives up to k ids, closest first.
+    ///
+    /// @return The number of ids written to out.
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t find_nearest(const point_type& p, size_t k, id_type* out) const
+    {
+        if (m_root == invalid_id || k == 0)
+        {
+            return 0;
+        }
+
+        // nodes to visit closest first, and the best objects so far with the
+        // furthest first
+        std::vector<candidate> open;
+        std::vector<candidate> best;
+        best.reserve(k + 1);
+
+        open.push_back({ distance_squared(closest(m_nodes[m_root].bounds, p), p), m_root });
+
+        while (!open.empty())
+        {
+            std::pop_heap(open.begin(), open.end(), further);
+            const candidate c = open.back();
+            open.pop_back();
+
+            if (best.size() == k && c.distance > best.front().distance)
+            {
+                break;
+            }
+
+            const node& n = m_nodes[c.id];
+
+            if (n.is_leaf())
+            {
+                const candidate object{ distance_squared(closest(n.object, p), p), c.id };
+
+                if (best.size() < k || object.distance < best.front().distance)
+                {
+                    best.push_back(object);
+                    std::push_heap(best.begin(), best.end(), closer);
+
+                    if (best.size() > k)
+                    {
+                        std::pop_heap(best.begin(), best.end(), closer);
+                        best.pop_back();
+                    }
+                }
+            }
+            else
+            {
+                for (const id_type child : { n.child1, n.child2 })
+                {
+                    open.push_back({ distance_squared(closest(m_nodes[child].bounds, p), p), child });
+                    std::push_heap(open.begin(), open.end(), further);
+                }
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end(), closer);
+
+        for (size_t i = 0; i < best.size(); ++i)
+        {
+            out[i] = best[i].id;
+        }
+
+        return best.size();
+    }
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // nodes
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // deep enough for any balanced tree of 2^32 objects
+    enum : size_t { max_stack = 128 };
+
+    static constexpr scalar_type displacement_scale = static_cast<scalar_type>(4);
+
+    struct node
+    {
+        // the grown bounds of a leaf, otherwise the bounds of both children
+        rect_type bounds;
+        rect_type object;
+        size_t user_data;
+
+        // the next free node when the node is free
+        id_type parent;
+        id_type child1;
+        id_type child2;
+
+        // 0 for leaves, -1 for free nodes
+        int32_t height;
+
+        bool is_leaf() const noexcept { return child1 == invalid_id; }
+    };
+
+    struct candidate
+    {
+        scalar_type distance;
+        id_type id;
+    };
+
+    static bool closer(const candidate& a, const candidate& b) noexcept { return a.distance < b.distance; }
+    static bool further(const candidate& a, const candidate& b) noexcept { return a.distance > b.distance; }
+
+    // overlaps with the edges included on both sides, so it is true whenever
+    // overlaps is true in either order
+    static bool touches(const rect_type& a, const rect_type& b) noexcept
+    {
+        return a.left() <= b.right() && b.left() <= a.right()
+            && a.top() <= b.bottom() && b.top() <= a.bottom();
+    }
+
+    bool is_object(id_type id) const noexcept
+    {
+        return id < m_nodes.size() && m_nodes[id].height == 0;
+    }
+
+    id_type allocate_node()
+    {
+        id_type i;
+
+        if (m_free != invalid_id)
+        {
+            i = m_free;
+            m_free = m_nodes[i].parent;
+        }
+        else
+        {
+            i = static_cast<id_type>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        node& n = m_nodes[i];
+        n.parent = invalid_id;
+        n.child1 = invalid_id;
+        n.child2 = invalid_id;
+        n.user_data = 0;
+        n.height = 0;
+
+        return i;
+    }
+
+    void free_node(id_type i) noexcept
+    {
+        m_nodes[i].parent = m_free;
+        m_nodes[i].height = -1;
+        m_free = i;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // insert and remove
+    ///////////////////////////////////////////////////////////////////////////////
+
+    void insert_leaf(id_type leaf)
+    {
+        if (m_root == invalid_id)
+        {
+            m_root = leaf;
+            m_nodes[leaf].parent = invalid_id;
+            return;
+        }
+
+        // find the sibling that grows the perimeters of the tree the least
+        const rect_type leaf_bounds = m_nodes[leaf].bounds;
+        id_type index = m_root;
+
+        while (!m_nodes[index].is_leaf())
+        {
+            const node& n = m_nodes[index];
+
+            const scalar_type perimeter = n.bounds.perimeter();
+            const scalar_type combined = bounding_box(n.bounds, leaf_bounds).perimeter();
+
+            // cost of a new parent for this node and the leaf, and the cost
+            // pushed down to the children
+            const scalar_type cost = static_cast<scalar_type>(2) * combined;
+            const scalar_type inherited = static_cast<scalar_type>(2) * (combined - perimeter);
+
+            const scalar_type cost1 = descend_cost(n.child1, leaf_bounds) + inherited;
+            const scalar_type cost2 = descend_cost(n.child2, leaf_bounds) + inherited;
+
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+
+            index = (cost1 < cost2) ? n.child1 : n.child2;
+        }
+
+        const id_type sibling = index;
+        const id_type parent = allocate_node();
+
+        node& s = m_nodes[sibling];
+        node& p = m_nodes[parent];
+        const id_type old_parent = s.parent;
+
+        p.parent = old_parent;
+        p.bounds = bounding_box(leaf_bounds, s.bounds);
+        p.height = s.height + 1;
+        p.child1 = sibling;
+        p.child2 = leaf;
+        s.parent = parent;
+        m_nodes[leaf].parent = parent;
+
+        if (old_parent != invalid_id)
+        {
+            replace_child(old_parent, sibling, parent);
+        }
+        else
+        {
+            m_root = parent;
+        }
+
+        refit(m_nodes[leaf].parent);
+    }
+
+    scalar_type descend_cost(id_type child, const rect_type& leaf_bounds) const noexcept
+    {
+        const node& c = m_nodes[child];
+        const scalar_type combined = bounding_box(leaf_bounds, c.bounds).perimeter();
+        return c.is_leaf() ? combined : (combined - c.bounds.perimeter());
+    }
+
+    void remove_leaf(id_type leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = invalid_id;
+            return;
+        }
+
+        const id_type parent = m_nodes[leaf].parent;
+        const id_type grandparent = m_nodes[parent].parent;
+        const id_type sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+        m_nodes[sibling].parent = grandparent;
+
+        if (grandparent != invalid_id)
+        {
+            replace_child(grandparent, parent, sibling);
+            free_node(parent);
+            refit(grandparent);
+        }
+        else
+        {
+            m_root = sibling;
+            free_node(parent);
+        }
+
+        m_nodes[leaf].parent = invalid_id;
+    }
+
+    void replace_child(id_type parent, id_type old_child, id_type new_child) noexcept
+    {
+        node& p = m_nodes[parent];
+
+        if (p.child1 == old_child)
+        {
+            p.child1 = new_child;
+        }
+        else
+        {
+            p.child2 = new_child;
+        }
+    }
+
+    // rebalances and fixes the bounds and heights from index to the root
+    void refit(id_type index) noexcept
+    {
+        while (index != invalid_id)
+        {
+            index = balance(index);
+
+            node& n = m_nodes[index];
+            const node& c1 = m_nodes[n.child1];
+            const node& c2 = m_nodes[n.child2];
+
+            n.height = 1 + max(c1.height, c2.height);
+            n.bounds = bounding_box(c1.bounds, c2.bounds);
+
+            index = n.parent;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // balance
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // If the heights of the children of a differ by more than 1, the taller
+    // child takes the place of a. Returns the node now in the place of a.
+    id_type balance(id_type ia) noexcept
+    {
+        node& a = m_nodes[ia];
+
+        if (a.is_leaf() || a.height < 2)
+        {
+            return ia;
+        }
+
+        const id_type ib = a.child1;
+        const id_type ic = a.child2;
+
+        const int32_t difference = m_nodes[ic].height - m_nodes[ib].height;
+
+        if (difference > 1)
+        {
+            return rotate(ia, ic, ib, false);
+        }
+
+        if (difference < -1)
+        {
+            return rotate(ia, ib, ic, true);
+        }
+
+        return ia;
+    }
+
+    // Moves the child iup of ia into the place of ia, ia keeps its other
+    // child ikeep and the shorter child of iup.
+    id_type rotate(id_type ia, id_type iup, id_type ikeep, bool up_is_child1) noexcept
+    {
+        node& a = m_nodes[ia];
+        node& up = m_nodes[iup];
+
+        const id_type if_ = up.child1;
+        const id_type ig = up.child2;
+        node& f = m_nodes[if_];
+        node& g = m_nodes[ig];
+        const node& keep = m_nodes[ikeep];
+
+        up.child1 = ia;
+        up.parent = a.parent;
+        a.parent = iup;
+
+        if (up.parent != invalid_id)
+        {
+            replace_child(up.parent, ia, iup);
+        }
+        else
+        {
+            m_root = iup;
+        }
+
+        // the taller grandchild stays with up
+        const bool f_taller = f.height > g.height;
+        const id_type itall = f_taller ? if_ : ig;
+        const id_type ishort = f_taller ? ig : if_;
+        node& tall = m_nodes[itall];
+        node& short_ = m_nodes[ishort];
+
+        up.child2 = itall;
+
+        if (up_is_child1)
+        {
+            a.child1 = ishort;
+        }
+        else
+        {
+            a.child2 = ishort;
+        }
+
+        short_.parent = ia;
+
+        a.bounds = bounding_box(keep.bounds, short_.bounds);
+        up.bounds = bounding_box(a.bounds, tall.bounds);
+
+        a.height = 1 + max(keep.height, short_.height);
+        up.height = 1 + max(a.height, tall.height);
+
+        return iup;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // data
+    ///////////////////////////////////////////////////////////////////////////////
+
+    std::vector<node> m_nodes;
+    id_type m_root = invalid_id;
+    id_type m_free = invalid_id;
+    size_t m_count = 0;
+    scalar_type m_margin;
+};
+
+} // namespace g2
+} // namespace math
+} // namespace vx
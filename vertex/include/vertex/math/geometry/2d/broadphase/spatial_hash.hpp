@@ -0,0 +1,719 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "vertex/math/geometry/2d/functions/collision.hpp"
+
+namespace vx {
+namespace math {
+namespace g2 {
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief A uniform grid of rects stored in a hash table, for many objects of
+/// about the same size.
+///
+/// The plane is split into square cells and every object is listed in each
+/// cell it touches. Only the occupied cells take memory, so the objects may
+/// be spread anywhere. It works best when the cell size is a little larger
+/// than the typical object: smaller cells list objects many times, larger
+/// cells hold objects that do not touch. Cell lists are linked through one
+/// array of entries, and the queries test the bounds of the objects with the
+/// functions of collision.hpp.
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class spatial_hash
+{
+    static_assert(is_float<T>::value, "spatial_hash needs a floating point type");
+
+public:
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // meta
+    ///////////////////////////////////////////////////////////////////////////////
+
+    using scalar_type = T;
+    using rect_type = rect_t<T>;
+    using point_type = point_t<T>;
+    using ray_type = ray_t<T>;
+    using id_type = uint32_t;
+
+    enum : id_type { invalid_id = 0xFFFFFFFF };
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // construction
+    ///////////////////////////////////////////////////////////////////////////////
+
+    explicit spatial_hash(scalar_type cell_size = static_cast<scalar_type>(1))
+        : m_cell_size(cell_size)
+        , m_inv_cell_size(static_cast<scalar_type>(1) / cell_size)
+    {
+        VX_ASSERT(cell_size > static_cast<scalar_type>(0));
+        m_buckets.assign(min_buckets, invalid_id);
+    }
+
+    size_t size() const noexcept { return m_count; }
+    bool empty() const noexcept { return m_count == 0; }
+    scalar_type cell_size() const noexcept { return m_cell_size; }
+
+    void reserve(size_t count)
+    {
+        m_objects.reserve(count);
+        m_entries.reserve(count * 4);
+    }
+
+    void clear() noexcept
+    {
+        m_objects.clear();
+        m_entries.clear();
+        std::fill(m_buckets.begin(), m_buckets.end(), invalid_id);
+
+        m_free_object = invalid_id;
+        m_free_entry = invalid_id;
+        m_count = 0;
+        m_entry_count = 0;
+        m_occupied = cell_range();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // objects
+    ///////////////////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Adds an object.
+    ///
+    /// @param bounds The bounds of the object.
+    /// @param user_data A value to keep with the object.
+    ///
+    /// @return The id of the object, valid until it is removed.
+    ///////////////////////////////////////////////////////////////////////////////
+    id_type insert(const rect_type& bounds, size_t user_data = 0)
+    {
+        id_type id;
+
+        if (m_free_object != invalid_id)
+        {
+            id = m_free_object;
+            m_free_object = m_objects[id].next_free;
+        }
+        else
+        {
+            id = static_cast<id_type>(m_objects.size());
+            m_objects.emplace_back();
+        }
+
+        object& o = m_objects[id];
+        o.bounds = bounds;
+        o.user_data = user_data;
+        o.cells = get_cells(bounds);
+        o.next_free = invalid_id;
+        o.alive = true;
+
+        link(id);
+        ++m_count;
+
+        return id;
+    }
+
+    void remove(id_type id)
+    {
+        VX_ASSERT(is_object(id));
+
+        unlink(id);
+
+        object& o = m_objects[id];
+        o.alive = false;
+        o.next_free = m_free_object;
+        m_free_object = id;
+
+        --m_count;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Updates the bounds of an object.
+    ///
+    /// @return true if the object moved to different cells.
+    ///////////////////////////////////////////////////////////////////////////////
+    bool move(id_type id, const rect_type& bounds)
+    {
+        VX_ASSERT(is_object(id));
+
+        object& o = m_objects[id];
+        o.bounds = bounds;
+
+        const cell_range cells = get_cells(bounds);
+        if (cells == o.cells)
+        {
+            return false;
+        }
+
+        unlink(id);
+        m_objects[id].cells = cells;
+        link(id);
+
+        return true;
+    }
+
+    const rect_type& get_bounds(id_type id) const noexcept
+    {
+        VX_ASSERT(is_object(id));
+        return m_objects[id].bounds;
+    }
+
+    size_t get_user_data(id_type id) const noexcept
+    {
+        VX_ASSERT(is_object(id));
+        return m_objects[id].user_data;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // queries
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // An object listed in several cells is only tested in one of them: the
+    // first cell it shares with the query, so nothing is reported twice.
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Calls fn(id) for every object whose bounds b satisfy
+    /// overlaps(area, b).
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void query(const rect_type& area, F&& fn) const
+    {
+        if (m_count == 0)
+        {
+            return;
+        }
+
+        const cell_range cells = get_cells(area).clipped(m_occupied);
+
+        for (int32_t y = cells.y0; y <= cells.y1; ++y)
+        {
+            for (int32_t x = cells.x0; x <= cells.x1; ++x)
+            {
+                for_each_in_cell(x, y, [&](id_type id, const object& o)
+                {
+                    if (x == max(cells.x0, o.cells.x0) && y == max(cells.y0, o.cells.y0) && overlaps(area, o.bounds))
+                    {
+                        fn(id);
+                    }
+                });
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Calls fn(id) for every object whose bounds b satisfy
+    /// contains(b, p).
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void query(const point_type& p, F&& fn) const
+    {
+        if (m_count == 0)
+        {
+            return;
+        }
+
+        for_each_in_cell(get_cell(p.x), get_cell(p.y), [&](id_type id, const object& o)
+        {
+            if (contains(o.bounds, p))
+            {
+                fn(id);
+            }
+        });
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Casts a ray through the objects.
+    ///
+    /// fn(id, t) is called for every object the ray hits no further than
+    /// max_t, with t from raycast(ray, bounds, t), roughly from near to far.
+    /// It returns the new max_t: max_t to see every hit, t to only see
+    /// closer hits, or a negative value to stop.
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void raycast(const ray_type& ray, scalar_type max_t, F&& fn) const
+    {
+        if (m_count == 0)
+        {
+            return;
+        }
+
+        // start where the ray enters the occupied cells
+        const rect_type occupied(
+            static_cast<scalar_type>(m_occupied.x0) * m_cell_size,
+            static_cast<scalar_type>(m_occupied.y0) * m_cell_size,
+            static_cast<scalar_type>(m_occupied.x1 - m_occupied.x0 + 1) * m_cell_size,
+            static_cast<scalar_type>(m_occupied.y1 - m_occupied.y0 + 1) * m_cell_size
+        );
+
+        scalar_type t;
+        if (!g2::raycast(ray, occupied, t) || t > max_t)
+        {
+            return;
+        }
+
+        const point_type start = ray.origin + ray.direction * t;
+        int32_t cell[2] = {
+            clamp(get_cell(start.x), m_occupied.x0, m_occupied.x1),
+            clamp(get_cell(start.y), m_occupied.y0, m_occupied.y1)
+        };
+
+        // walk the cells along the ray, next[i] is where the ray crosses
+        // into the next cell along axis i
+        int32_t step[2];
+        scalar_type next[2];
+        scalar_type delta[2];
+
+        for (size_t i = 0; i < 2; ++i)
+        {
+            const scalar_type d = ray.direction[i];
+
+            if (d > static_cast<scalar_type>(0))
+            {
+                step[i] = 1;
+                next[i] = (static_cast<scalar_type>(cell[i] + 1) * m_cell_size - ray.origin[i]) / d;
+                delta[i] = m_cell_size / d;
+            }
+            else if (d < static_cast<scalar_type>(0))
+            {
+                step[i] = -1;
+                next[i] = (static_cast<scalar_type>(cell[i]) * m_cell_size - ray.origin[i]) / d;
+                delta[i] = -m_cell_size / d;
+            }
+            else
+            {
+                step[i] = 0;
+                next[i] = constants<scalar_type>::infinity;
+                delta[i] = constants<scalar_type>::infinity;
+            }
+        }
+
+        // The cells form a path that enters the cells of an object at most
+        // once, so an object is tested in the first of its cells on the path.
+        bool first = true;
+        int32_t previous[2] = {};
+
+        while (true)
+        {
+            bool stop = false;
+
+            for_each_in_cell(cell[0], cell[1], [&](id_type id, const object& o)
+            {
+                if (stop || (!first && o.cells.contains(previous[0], previous[1])))
+                {
+                    return;
+                }
+
+                scalar_type hit;
+                if (g2::raycast(ray, o.bounds, hit) && hit <= max_t)
+                {
+                    max_t = fn(id, hit);
+                    stop = (max_t < static_cast<scalar_type>(0));
+                }
+            });
+
+            const size_t axis = (next[0] < next[1]) ? 0 : 1;
+
+            if (stop || next[axis] > max_t || next[axis] == constants<scalar_type>::infinity)
+            {
+                return;
+            }
+
+            first = false;
+            previous[0] = cell[0];
+            previous[1] = cell[1];
+
+            cell[axis] += step[axis];
+            next[axis] += delta[axis];
+
+            if (!m_occupied.contains(cell[0], cell[1]))
+            {
+                return;
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Calls fn(a, b) once for every pair of objects a < b whose bounds
+    /// satisfy overlaps(bounds of a, bounds of b).
+    ///////////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void query_pairs(F&& fn) const
+    {
+        for (const id_type head : m_buckets)
+        {
+            for (id_type ea = head; ea != invalid_id; ea = m_entries[ea].next)
+            {
+                const entry& a = m_entries[ea];
+
+                for (id_type eb = a.next; eb != invalid_id; eb = m_entries[eb].next)
+                {
+                    const entry& b = m_entries[eb];
+
+                    if (a.x != b.x || a.y != b.y)
+                    {
+                        continue;
+                    }
+
+                    const id_type lo = min(a.object, b.object);
+                    const id_type hi = max(a.object, b.object);
+                    const object& olo = m_objects[lo];
+                    const object& ohi = m_objects[hi];
+
+                    // the first cell the two share
+                    if (a.x == max(olo.cells.x0, ohi.cells.x0) && a.y == max(olo.cells.y0, ohi.cells.y0) && overlaps(olo.bounds, ohi.bounds))
+                    {
+                        fn(lo, hi);
+                    }
+                }
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Finds the objects closest to a point.
+    ///
+    /// The distance to an object is the distance to the closest point of its
+    /// bounds, 0 when p is inside. Rings of cells are searched outward from
+    /// p until no closer object can be found.
+    ///
+    /// @param p The point.
+    /// @param k The most objects to find.
+    /// @param out Receives up to k ids, closest first.
+    ///
+    /// @return The number of ids written to out.
+    ///////////////////////////////////////////////////////////////////////////////
+    size_t find_nearest(const point_type& p, size_t k, id_type* out) const
+    {
+        if (m_count == 0 || k == 0)
+        {
+            return 0;
+        }
+
+        // the best objects so far, the furthest first
+        std::vector<candidate> best;
+        best.reserve(k + 1);
+
+        const int32_t px = get_cell(p.x);
+        const int32_t py = get_cell(p.y);
+
+        const auto visit = [&](int32_t x, int32_t y)
+        {
+            for_each_in_cell(x, y, [&](id_type id, const object& o)
+            {
+                // each object is tested in its cell closest to p
+                if (x != clamp(px, o.cells.x0, o.cells.x1) || y != clamp(py, o.cells.y0, o.cells.y1))
+                {
+                    return;
+                }
+
+                const candidate c{ distance_squared(closest(o.bounds, p), p), id };
+
+                if (best.size() < k || c.distance < best.front().distance)
+                {
+                    best.push_back(c);
+                    std::push_heap(best.begin(), best.end(), closer);
+
+                    if (best.size() > k)
+                    {
+                        std::pop_heap(best.begin(), best.end(), closer);
+                        best.pop_back();
+                    }
+                }
+            });
+        };
+
+        // skip the rings that do not reach the occupied cells
+        const int32_t first_ring = max(
+            max(m_occupied.x0 - px, px - m_occupied.x1),
+            max(max(m_occupied.y0 - py, py - m_occupied.y1), 0)
+        );
+
+        for (int32_t r = first_ring; ; ++r)
+        {
+            const cell_range ring(px - r, py - r, px + r, py + r);
+            const cell_range visible = ring.clipped(m_occupied);
+
+            if (r == 0)
+            {
+                visit(px, py);
+            }
+            else
+            {
+                // top and bottom rows, then the left and right columns
+                for (const int32_t y : { ring.y0, ring.y1 })
+                {
+                    if (y >= m_occupied.y0 && y <= m_occupied.y1)
+                    {
+                        for (int32_t x = visible.x0; x <= visible.x1; ++x)
+                        {
+                            visit(x, y);
+                        }
+                    }
+                }
+
+                for (const int32_t x : { ring.x0, ring.x1 })
+                {
+                    if (x >= m_occupied.x0 && x <= m_occupied.x1)
+                    {
+                        for (int32_t y = max(visible.y0, ring.y0 + 1); y <= min(visible.y1, ring.y1 - 1); ++y)
+                        {
+                            visit(x, y);
+                        }
+                    }
+                }
+            }
+
+            if (ring.x0 <= m_occupied.x0 && ring.x1 >= m_occupied.x1 && ring.y0 <= m_occupied.y0 && ring.y1 >= m_occupied.y1)
+            {
+                break;
+            }
+
+            if (best.size() == k)
+            {
+                // anything not seen yet is outside the cells searched so far
+                const scalar_type reach = min(
+                    min(p.x - static_cast<scalar_type>(ring.x0) * m_cell_size, static_cast<scalar_type>(ring.x1 + 1) * m_cell_size - p.x),
+                    min(p.y - static_cast<scalar_type>(ring.y0) * m_cell_size, static_cast<scalar_type>(ring.y1 + 1) * m_cell_size - p.y)
+                );
+
+                if (best.front().distance <= reach * reach)
+                {
+                    break;
+                }
+            }
+        }
+
+        std::sort_heap(best.begin(), best.end(), closer);
+
+        for (size_t i = 0; i < best.size(); ++i)
+        {
+            out[i] = best[i].id;
+        }
+
+        return best.size();
+    }
+
+private:
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // cells
+    ///////////////////////////////////////////////////////////////////////////////
+
+    enum : size_t { min_buckets = 64 };
+
+    // inclusive
+    struct cell_range
+    {
+        int32_t x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+
+        cell_range() = default;
+        cell_range(int32_t ax0, int32_t ay0, int32_t ax1, int32_t ay1) noexcept
+            : x0(ax0), y0(ay0), x1(ax1), y1(ay1) {}
+
+        bool empty() const noexcept { return x1 < x0 || y1 < y0; }
+        bool contains(int32_t x, int32_t y) const noexcept { return x >= x0 && x <= x1 && y >= y0 && y <= y1; }
+
+        cell_range clipped(const cell_range& r) const noexcept
+        {
+            return cell_range(max(x0, r.x0), max(y0, r.y0), min(x1, r.x1), min(y1, r.y1));
+        }
+
+        friend bool operator==(const cell_range& a, const cell_range& b) noexcept
+        {
+            return a.x0 == b.x0 && a.y0 == b.y0 && a.x1 == b.x1 && a.y1 == b.y1;
+        }
+    };
+
+    struct object
+    {
+        rect_type bounds;
+        size_t user_data = 0;
+        cell_range cells;
+        id_type next_free = invalid_id;
+        bool alive = false;
+    };
+
+    // one cell of an object, in the list of its bucket
+    struct entry
+    {
+        int32_t x, y;
+        id_type object;
+        id_type next;
+    };
+
+    struct candidate
+    {
+        scalar_type distance;
+        id_type id;
+    };
+
+    static bool closer(const candidate& a, const candidate& b) noexcept { return a.distance < b.distance; }
+
+    bool is_object(id_type id) const noexcept
+    {
+        return id < m_objects.size() && m_objects[id].alive;
+    }
+
+    int32_t get_cell(scalar_type v) const noexcept
+    {
+        return static_cast<int32_t>(floor(v * m_inv_cell_size));
+    }
+
+    cell_range get_cells(const rect_type& r) const noexcept
+    {
+        return cell_range(get_cell(r.left()), get_cell(r.top()), get_cell(r.right()), get_cell(r.bottom()));
+    }
+
+    size_t bucket(int32_t x, int32_t y) const noexcept
+    {
+        const uint32_t h = (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u);
+        return h & (m_buckets.size() - 1);
+    }
+
+    // calls fn(id, object) for every object listed in cell (x, y)
+    template <typename F>
+    void for_each_in_cell(int32_t x, int32_t y, F&& fn) const
+    {
+        for (id_type e = m_buckets[bucket(x, y)]; e != invalid_id; e = m_entries[e].next)
+        {
+            const entry& en = m_entries[e];
+
+            if (en.x == x && en.y == y)
+            {
+                fn(en.object, m_objects[en.object]);
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // lists
+    ///////////////////////////////////////////////////////////////////////////////
+
+    void link(id_type id)
+    {
+        const cell_range cells = m_objects[id].cells;
+        const size_t added = static_cast<size_t>(cells.x1 - cells.x0 + 1) * static_cast<size_t>(cells.y1 - cells.y0 + 1);
+
+        if (m_entry_count + added > m_buckets.size())
+        {
+            rehash(m_entry_count + added);
+        }
+
+        for (int32_t y = cells.y0; y <= cells.y1; ++y)
+        {
+            for (int32_t x = cells.x0; x <= cells.x1; ++x)
+            {
+                id_type e;
+
+                if (m_free_entry != invalid_id)
+                {
+                    e = m_free_entry;
+                    m_free_entry = m_entries[e].next;
+                }
+                else
+                {
+                    e = static_cast<id_type>(m_entries.size());
+                    m_entries.emplace_back();
+                }
+
+                const size_t b = bucket(x, y);
+                m_entries[e] = entry{ x, y, id, m_buckets[b] };
+                m_buckets[b] = e;
+            }
+        }
+
+        m_entry_count += added;
+
+        if (m_count == 0)
+        {
+            m_occupied = cells;
+        }
+        else
+        {
+            // only grows until the hash is empty again
+            m_occupied = cell_range(min(m_occupied.x0, cells.x0), min(m_occupied.y0, cells.y0), max(m_occupied.x1, cells.x1), max(m_occupied.y1, cells.y1));
+        }
+    }
+
+    void unlink(id_type id) noexcept
+    {
+        const cell_range cells = m_objects[id].cells;
+
+        for (int32_t y = cells.y0; y <= cells.y1; ++y)
+        {
+            for (int32_t x = cells.x0; x <= cells.x1; ++x)
+            {
+                id_type* link = &m_buckets[bucket(x, y)];
+
+                while (*link != invalid_id)
+                {
+                    entry& en = m_entries[*link];
+
+                    if (en.object == id && en.x == x && en.y == y)
+                    {
+                        const id_type e = *link;
+                        *link = en.next;
+
+                        en.object = invalid_id;
+                        en.next = m_free_entry;
+                        m_free_entry = e;
+
+                        --m_entry_count;
+                        break;
+                    }
+
+                    link = &en.next;
+                }
+            }
+        }
+    }
+
+    // keeps about one entry per bucket
+    void rehash(size_t entry_count)
+    {
+        size_t count = m_buckets.size();
+        while (count < entry_count)
+        {
+            count *= 2;
+        }
+
+        m_buckets.assign(count, invalid_id);
+
+        for (size_t e = 0; e < m_entries.size(); ++e)
+        {
+            entry& en = m_entries[e];
+
+            if (en.object != invalid_id)
+            {
+                const size_t b = bucket(en.x, en.y);
+                en.next = m_buckets[b];
+                m_buckets[b] = static_cast<id_type>(e);
+            }
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // data
+    ///////////////////////////////////////////////////////////////////////////////
+
+    std::vector<object> m_objects;
+    std::vector<entry> m_entries;
+    std::vector<id_type> m_buckets;
+
+    id_type m_free_object = invalid_id;
+    id_type m_free_entry = invalid_id;
+    size_t m_count = 0;
+    size_t m_entry_count = 0;
+
+    // the cells that have held objects
+    cell_range m_occupied;
+
+    scalar_type m_cell_size;
+    scalar_type m_inv_cell_size;
+};
+
+} // namespace g2
+} // namespace math
+} // namespace vx
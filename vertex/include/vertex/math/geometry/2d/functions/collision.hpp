@@ -237,6 +237,57 @@ VX_FORCE_INLINE constexpr point_t<T> closest(const rect_t<T>& r, const point_t<T
     );
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// raycast
+///////////////////////////////////////////////////////////////////////////////
+
+// t is where the ray enters the rect, in lengths of the ray direction, or 0
+// when the origin is inside. Edges count as part of the rect.
+template <typename T>
+VX_FORCE_INLINE constexpr bool raycast(const ray_t<T>& r, const rect_t<T>& rect, T& t) noexcept
+{
+    T tmin = static_cast<T>(0);
+    T tmax = constants<T>::infinity;
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        const T lo = rect.position[i];
+        const T hi = rect.position[i] + rect.size[i];
+
+        if (r.direction[i] == static_cast<T>(0))
+        {
+            if (r.origin[i] < lo || r.origin[i] > hi)
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        const T inv = static_cast<T>(1) / r.direction[i];
+        T t1 = (lo - r.origin[i]) * inv;
+        T t2 = (hi - r.origin[i]) * inv;
+
+        if (t1 > t2)
+        {
+            const T tmp = t1;
+            t1 = t2;
+            t2 = tmp;
+        }
+
+        tmin = max(tmin, t1);
+        tmax = min(tmax, t2);
+
+        if (tmin > tmax)
+        {
+            return false;
+        }
+    }
+
+    t = tmin;
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // intersects
 ///////////////////////////////////////////////////////////////////////////////
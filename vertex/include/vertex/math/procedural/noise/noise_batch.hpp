@@ -0,0 +1,508 @@
+#pragma once
+
+#include "vertex/config/simd.hpp"
+#include "vertex/math/procedural/noise/noise_helpers.hpp"
+
+#if defined(VX_SIMD_X86) && (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+#   define VX_NOISE_SIMD_AVX2
+#   include <immintrin.h>
+#elif defined(VX_SIMD_X86) && (VX_SIMD_X86 >= VX_SIMD_X86_SSE2_VERSION)
+#   define VX_NOISE_SIMD_SSE2
+#   include <emmintrin.h>
+#   if (VX_SIMD_X86 >= VX_SIMD_X86_SSE4_1_VERSION)
+#       define VX_NOISE_SIMD_SSE4_1
+#       include <smmintrin.h>
+#   endif
+#endif
+
+// Noise over several points at once. The kernels repeat the scalar ones in
+// perlin_noise.hpp and simplex_noise.hpp operation for operation with one
+// point per lane, so each lane rounds the same way as the scalar version.
+
+namespace vx {
+namespace math {
+namespace _priv {
+
+////////////////////////////////////////////////////////////////////////////////
+// noise_batch
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(VX_NOISE_SIMD_AVX2)
+
+struct noise_batch
+{
+    static constexpr size_t size = 8;
+
+    __m256 v;
+
+    noise_batch() noexcept = default;
+    VX_FORCE_INLINE noise_batch(__m256 x) noexcept : v(x) {}
+    VX_FORCE_INLINE noise_batch(f32 x) noexcept : v(_mm256_set1_ps(x)) {}
+
+    static VX_FORCE_INLINE noise_batch load(const f32* p) noexcept { return _mm256_loadu_ps(p); }
+    VX_FORCE_INLINE void store(f32* p) const noexcept { _mm256_storeu_ps(p, v); }
+
+    // 0, 1, 2... in each lane
+    static VX_FORCE_INLINE noise_batch lane_index() noexcept { return _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7); }
+};
+
+VX_FORCE_INLINE noise_batch operator+(const noise_batch& a, const noise_batch& b) noexcept { return _mm256_add_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator-(const noise_batch& a, const noise_batch& b) noexcept { return _mm256_sub_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator*(const noise_batch& a, const noise_batch& b) noexcept { return _mm256_mul_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator/(const noise_batch& a, const noise_batch& b) noexcept { return _mm256_div_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator-(const noise_batch& a) noexcept { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+VX_FORCE_INLINE noise_batch floor(const noise_batch& a) noexcept { return _mm256_floor_ps(a.v); }
+VX_FORCE_INLINE noise_batch abs(const noise_batch& a) noexcept { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+
+// std::min and std::max return the first argument on ties
+VX_FORCE_INLINE noise_batch min(const noise_batch& a, const noise_batch& b) noexcept { return _mm256_blendv_ps(a.v, b.v, _mm256_cmp_ps(b.v, a.v, _CMP_LT_OQ)); }
+VX_FORCE_INLINE noise_batch max(const noise_batch& a, const noise_batch& b) noexcept { return _mm256_blendv_ps(a.v, b.v, _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)); }
+
+// 1 where a > b, 0 elsewhere
+VX_FORCE_INLINE noise_batch greater(const noise_batch& a, const noise_batch& b) noexcept { return _mm256_and_ps(_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ), _mm256_set1_ps(1.0f)); }
+// 1 where x >= edge, 0 elsewhere
+VX_FORCE_INLINE noise_batch step(const noise_batch& edge, const noise_batch& x) noexcept { return _mm256_and_ps(_mm256_cmp_ps(x.v, edge.v, _CMP_GE_OQ), _mm256_set1_ps(1.0f)); }
+
+#elif defined(VX_NOISE_SIMD_SSE2)
+
+struct noise_batch
+{
+    static constexpr size_t size = 4;
+
+    __m128 v;
+
+    noise_batch() noexcept = default;
+    VX_FORCE_INLINE noise_batch(__m128 x) noexcept : v(x) {}
+    VX_FORCE_INLINE noise_batch(f32 x) noexcept : v(_mm_set1_ps(x)) {}
+
+    static VX_FORCE_INLINE noise_batch load(const f32* p) noexcept { return _mm_loadu_ps(p); }
+    VX_FORCE_INLINE void store(f32* p) const noexcept { _mm_storeu_ps(p, v); }
+
+    // 0, 1, 2... in each lane
+    static VX_FORCE_INLINE noise_batch lane_index() noexcept { return _mm_setr_ps(0, 1, 2, 3); }
+};
+
+VX_FORCE_INLINE noise_batch operator+(const noise_batch& a, const noise_batch& b) noexcept { return _mm_add_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator-(const noise_batch& a, const noise_batch& b) noexcept { return _mm_sub_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator*(const noise_batch& a, const noise_batch& b) noexcept { return _mm_mul_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator/(const noise_batch& a, const noise_batch& b) noexcept { return _mm_div_ps(a.v, b.v); }
+VX_FORCE_INLINE noise_batch operator-(const noise_batch& a) noexcept { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+VX_FORCE_INLINE noise_batch abs(const noise_batch& a) noexcept { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+
+VX_FORCE_INLINE noise_batch floor(const noise_batch& a) noexcept
+{
+#if defined(VX_NOISE_SIMD_SSE4_1)
+    return _mm_floor_ps(a.v);
+#else
+    // Truncate and step down where that rounded up. Noise coordinates stay
+    // well inside the int32 range, larger values are already integers.
+    const __m128 big = _mm_cmpge_ps(abs(a).v, _mm_set1_ps(8388608.0f));
+    const __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    const __m128 f = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)));
+    return _mm_or_ps(_mm_and_ps(big, a.v), _mm_andnot_ps(big, f));
+#endif
+}
+
+// std::min and std::max return the first argument on ties
+VX_FORCE_INLINE noise_batch min(const noise_batch& a, const noise_batch& b) noexcept { return _mm_min_ps(b.v, a.v); }
+VX_FORCE_INLINE noise_batch max(const noise_batch& a, const noise_batch& b) noexcept { return _mm_max_ps(b.v, a.v); }
+
+// 1 where a > b, 0 elsewhere
+VX_FORCE_INLINE noise_batch greater(const noise_batch& a, const noise_batch& b) noexcept { return _mm_and_ps(_mm_cmpgt_ps(a.v, b.v), _mm_set1_ps(1.0f)); }
+// 1 where x >= edge, 0 elsewhere
+VX_FORCE_INLINE noise_batch step(const noise_batch& edge, const noise_batch& x) noexcept { return _mm_and_ps(_mm_cmpge_ps(x.v, edge.v), _mm_set1_ps(1.0f)); }
+
+#else
+
+// plain loops the compiler can vectorize
+struct noise_batch
+{
+    static constexpr size_t size = 4;
+
+    f32 v[size];
+
+    noise_batch() noexcept = default;
+
+    VX_FORCE_INLINE noise_batch(f32 x) noexcept
+    {
+        for (size_t i = 0; i < size; ++i) v[i] = x;
+    }
+
+    static VX_FORCE_INLINE noise_batch load(const f32* p) noexcept
+    {
+        noise_batch r;
+        for (size_t i = 0; i < size; ++i) r.v[i] = p[i];
+        return r;
+    }
+
+    VX_FORCE_INLINE void store(f32* p) const noexcept
+    {
+        for (size_t i = 0; i < size; ++i) p[i] = v[i];
+    }
+
+    // 0, 1, 2... in each lane
+    static VX_FORCE_INLINE noise_batch lane_index() noexcept
+    {
+        noise_batch r;
+        for (size_t i = 0; i < size; ++i) r.v[i] = static_cast<f32>(i);
+        return r;
+    }
+};
+
+#define _NOISE_BATCH_OP(EXPR) \
+    noise_batch r; \
+    for (size_t i = 0; i < noise_batch::size; ++i) r.v[i] = (EXPR); \
+    return r
+
+VX_FORCE_INLINE noise_batch operator+(const noise_batch& a, const noise_batch& b) noexcept { _NOISE_BATCH_OP(a.v[i] + b.v[i]); }
+VX_FORCE_INLINE noise_batch operator-(const noise_batch& a, const noise_batch& b) noexcept { _NOISE_BATCH_OP(a.v[i] - b.v[i]); }
+VX_FORCE_INLINE noise_batch operator*(const noise_batch& a, const noise_batch& b) noexcept { _NOISE_BATCH_OP(a.v[i] * b.v[i]); }
+VX_FORCE_INLINE noise_batch operator/(const noise_batch& a, const noise_batch& b) noexcept { _NOISE_BATCH_OP(a.v[i] / b.v[i]); }
+VX_FORCE_INLINE noise_batch operator-(const noise_batch& a) noexcept { _NOISE_BATCH_OP(-a.v[i]); }
+
+VX_FORCE_INLINE noise_batch floor(const noise_batch& a) noexcept { _NOISE_BATCH_OP(math::floor(a.v[i])); }
+VX_FORCE_INLINE noise_batch abs(const noise_batch& a) noexcept { _NOISE_BATCH_OP(math::abs(a.v[i])); }
+VX_FORCE_INLINE noise_batch min(const noise_batch& a, const noise_batch& b) noexcept { _NOISE_BATCH_OP(math::min(a.v[i], b.v[i])); }
+VX_FORCE_INLINE noise_batch max(const noise_batch& a, const noise_batch& b) noexcept { _NOISE_BATCH_OP(math::max(a.v[i], b.v[i])); }
+
+// 1 where a > b, 0 elsewhere
+VX_FORCE_INLINE noise_batch greater(const noise_batch& a, const noise_batch& b) noexcept { _NOISE_BATCH_OP((a.v[i] > b.v[i]) ? 1.0f : 0.0f); }
+// 1 where x >= edge, 0 elsewhere
+VX_FORCE_INLINE noise_batch step(const noise_batch& edge, const noise_batch& x) noexcept { _NOISE_BATCH_OP((x.v[i] >= edge.v[i]) ? 1.0f : 0.0f); }
+
+#undef _NOISE_BATCH_OP
+
+#endif
+
+VX_FORCE_INLINE noise_batch fract(const noise_batch& a) noexcept { return a - floor(a); }
+
+VX_FORCE_INLINE noise_batch mix(const noise_batch& x, const noise_batch& y, const noise_batch& t) noexcept
+{
+    return x * (1.0f - t) + y * t;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// helpers
+////////////////////////////////////////////////////////////////////////////////
+
+VX_FORCE_INLINE noise_batch mod289(const noise_batch& x) noexcept
+{
+    return x - floor(x * (1.0f / 289.0f)) * 289.0f;
+}
+
+VX_FORCE_INLINE noise_batch permute(const noise_batch& x) noexcept
+{
+    return mod289(((x * 34.0f) + 1.0f) * x);
+}
+
+VX_FORCE_INLINE noise_batch taylor_inv_sqrt(const noise_batch& r) noexcept
+{
+    return static_cast<f32>(1.79284291400159) - static_cast<f32>(0.85373472095314) * r;
+}
+
+VX_FORCE_INLINE noise_batch fade(const noise_batch& t) noexcept
+{
+    return (t * t * t) * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// perlin
+////////////////////////////////////////////////////////////////////////////////
+
+// math::mod with a divisor of 289
+VX_FORCE_INLINE noise_batch mod_289_div(const noise_batch& x) noexcept
+{
+    return x - 289.0f * floor(x / 289.0f);
+}
+
+inline noise_batch perlin_noise(const noise_batch& px, const noise_batch& py) noexcept
+{
+    const noise_batch fx0 = floor(px);
+    const noise_batch fy0 = floor(py);
+
+    const noise_batch pi_x = mod_289_div(fx0 + 0.0f);
+    const noise_batch pi_y = mod_289_div(fy0 + 0.0f);
+    const noise_batch pi_z = mod_289_div(fx0 + 1.0f);
+    const noise_batch pi_w = mod_289_div(fy0 + 1.0f);
+
+    const noise_batch pf_x = fract(px) - 0.0f;
+    const noise_batch pf_y = fract(py) - 0.0f;
+    const noise_batch pf_z = fract(px) - 1.0f;
+    const noise_batch pf_w = fract(py) - 1.0f;
+
+    // the corners (x, y), (x + 1, y), (x, y + 1), (x + 1, y + 1)
+    const noise_batch perm_x = permute(pi_x);
+    const noise_batch perm_z = permute(pi_z);
+
+    const noise_batch i[4] = {
+        permute(perm_x + pi_y),
+        permute(perm_z + pi_y),
+        permute(perm_x + pi_w),
+        permute(perm_z + pi_w)
+    };
+
+    noise_batch gx[4], gy[4];
+
+    for (size_t c = 0; c < 4; ++c)
+    {
+        gx[c] = 2.0f * fract(i[c] * (1.0f / 41.0f)) - 1.0f;
+        gy[c] = abs(gx[c]) - 0.5f;
+        const noise_batch tx = floor(gx[c] + 0.5f);
+        gx[c] = gx[c] - tx;
+
+        const noise_batch norm = taylor_inv_sqrt((gx[c] * gx[c]) + (gy[c] * gy[c]));
+        gx[c] = gx[c] * norm;
+        gy[c] = gy[c] * norm;
+    }
+
+    const noise_batch n00 = (gx[0] * pf_x) + (gy[0] * pf_y);
+    const noise_batch n10 = (gx[1] * pf_z) + (gy[1] * pf_y);
+    const noise_batch n01 = (gx[2] * pf_x) + (gy[2] * pf_w);
+    const noise_batch n11 = (gx[3] * pf_z) + (gy[3] * pf_w);
+
+    const noise_batch fade_x = fade(pf_x);
+    const noise_batch fade_y = fade(pf_y);
+
+    const noise_batch n_x0 = mix(n00, n10, fade_x);
+    const noise_batch n_x1 = mix(n01, n11, fade_x);
+    return 2.3f * mix(n_x0, n_x1, fade_y);
+}
+
+inline noise_batch perlin_noise(const noise_batch& px, const noise_batch& py, const noise_batch& pz) noexcept
+{
+    const noise_batch p[3] = { px, py, pz };
+    noise_batch pi0[3], pi1[3], pf0[3], pf1[3];
+
+    for (size_t a = 0; a < 3; ++a)
+    {
+        const noise_batch f = floor(p[a]);
+        pi0[a] = mod289(f);
+        pi1[a] = mod289(f + 1.0f);
+        pf0[a] = fract(p[a]);
+        pf1[a] = pf0[a] - 1.0f;
+    }
+
+    // the corners in x, then y: (0, 0), (1, 0), (0, 1), (1, 1)
+    const noise_batch perm_x0 = permute(pi0[0]);
+    const noise_batch perm_x1 = permute(pi1[0]);
+
+    const noise_batch ixy[4] = {
+        permute(perm_x0 + pi0[1]),
+        permute(perm_x1 + pi0[1]),
+        permute(perm_x0 + pi1[1]),
+        permute(perm_x1 + pi1[1])
+    };
+
+    // the dot products of the gradients with the offsets to each corner, z
+    // is 0 for the first four and 1 for the rest
+    noise_batch n[8];
+
+    for (size_t z = 0; z < 2; ++z)
+    {
+        const noise_batch& iz = (z == 0) ? pi0[2] : pi1[2];
+        const noise_batch& fz = (z == 0) ? pf0[2] : pf1[2];
+
+        for (size_t c = 0; c < 4; ++c)
+        {
+            const noise_batch ixyz = permute(ixy[c] + iz);
+
+            noise_batch gx = ixyz * (1.0f / 7.0f);
+            noise_batch gy = fract(floor(gx) * (1.0f / 7.0f)) - 0.5f;
+            gx = fract(gx);
+            noise_batch gz = 0.5f - abs(gx) - abs(gy);
+            const noise_batch sz = step(gz, 0.0f);
+            gx = gx - sz * (step(0.0f, gx) - 0.5f);
+            gy = gy - sz * (step(0.0f, gy) - 0.5f);
+
+            const noise_batch norm = taylor_inv_sqrt((gx * gx) + (gy * gy) + (gz * gz));
+            gx = gx * norm;
+            gy = gy * norm;
+            gz = gz * norm;
+
+            const noise_batch& fx = (c & 1) ? pf1[0] : pf0[0];
+            const noise_batch& fy = (c & 2) ? pf1[1] : pf0[1];
+            n[z * 4 + c] = (gx * fx) + (gy * fy) + (gz * fz);
+        }
+    }
+
+    const noise_batch fade_x = fade(pf0[0]);
+    const noise_batch fade_y = fade(pf0[1]);
+    const noise_batch fade_z = fade(pf0[2]);
+
+    noise_batch n_z[4];
+    for (size_t c = 0; c < 4; ++c)
+    {
+        n_z[c] = mix(n[c], n[4 + c], fade_z);
+    }
+
+    const noise_batch n_yz0 = mix(n_z[0], n_z[2], fade_y);
+    const noise_batch n_yz1 = mix(n_z[1], n_z[3], fade_y);
+    return 2.2f * mix(n_yz0, n_yz1, fade_x);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// simplex
+////////////////////////////////////////////////////////////////////////////////
+
+inline noise_batch simplex_noise(const noise_batch& vx, const noise_batch& vy) noexcept
+{
+    const f32 cx = static_cast<f32>(+0.211324865405187);
+    const f32 cy = static_cast<f32>(+0.366025403784439);
+    const f32 cz = static_cast<f32>(-0.577350269189626);
+    const f32 cw = static_cast<f32>(+0.024390243902439);
+
+    // First corner
+    const noise_batch d = (vx * cy) + (vy * cy);
+    noise_batch ix = floor(vx + d);
+    noise_batch iy = floor(vy + d);
+
+    const noise_batch di = (ix * cx) + (iy * cx);
+    const noise_batch x0x = vx - ix + di;
+    const noise_batch x0y = vy - iy + di;
+
+    // Choose step offset for simplex triangle
+    const noise_batch i1x = greater(x0x, x0y);
+    const noise_batch i1y = 1.0f - i1x;
+
+    // Compute offsets for second and third corners
+    const noise_batch x12x = x0x + cx - i1x;
+    const noise_batch x12y = x0y + cx - i1y;
+    const noise_batch x12z = x0x + cz;
+    const noise_batch x12w = x0y + cz;
+
+    // Permutations
+    ix = mod289(ix);
+    iy = mod289(iy);
+
+    const noise_batch p[3] = {
+        permute(permute(iy + 0.0f) + ix + 0.0f),
+        permute(permute(iy + i1y) + ix + i1x),
+        permute(permute(iy + 1.0f) + ix + 1.0f)
+    };
+
+    const noise_batch dx[3] = { x0x, x12x, x12z };
+    const noise_batch dy[3] = { x0y, x12y, x12w };
+
+    noise_batch result;
+
+    for (size_t c = 0; c < 3; ++c)
+    {
+        noise_batch m = max(0.5f - ((dx[c] * dx[c]) + (dy[c] * dy[c])), 0.0f);
+        m = m * m;
+        m = m * m;
+
+        const noise_batch x = 2.0f * fract(p[c] * cw) - 1.0f;
+        const noise_batch h = abs(x) - 0.5f;
+        const noise_batch ox = floor(x + 0.5f);
+        const noise_batch a0 = x - ox;
+
+        m = m * (static_cast<f32>(1.79284291400159) - static_cast<f32>(0.85373472095314) * (a0 * a0 + h * h));
+
+        const noise_batch g = a0 * dx[c] + h * dy[c];
+        result = (c == 0) ? (m * g) : (result + (m * g));
+    }
+
+    return 130.0f * result;
+}
+
+inline noise_batch simplex_noise(const noise_batch& vx, const noise_batch& vy, const noise_batch& vz) noexcept
+{
+    const f32 cx = 1.0f / 6.0f;
+    const f32 cy = 1.0f / 3.0f;
+
+    const noise_batch v[3] = { vx, vy, vz };
+
+    // First corner
+    const noise_batch d = (vx * cy) + (vy * cy) + (vz * cy);
+    noise_batch i[3];
+    for (size_t a = 0; a < 3; ++a)
+    {
+        i[a] = floor(v[a] + d);
+    }
+
+    const noise_batch di = (i[0] * cx) + (i[1] * cx) + (i[2] * cx);
+    noise_batch x0[3];
+    for (size_t a = 0; a < 3; ++a)
+    {
+        x0[a] = v[a] - i[a] + di;
+    }
+
+    // Other corners
+    const noise_batch g[3] = { step(x0[1], x0[0]), step(x0[2], x0[1]), step(x0[0], x0[2]) };
+    const noise_batch l[3] = { 1.0f - g[0], 1.0f - g[1], 1.0f - g[2] };
+    const noise_batch l_zxy[3] = { l[2], l[0], l[1] };
+
+    noise_batch i1[3], i2[3];
+    noise_batch x[4][3];
+
+    for (size_t a = 0; a < 3; ++a)
+    {
+        i1[a] = min(g[a], l_zxy[a]);
+        i2[a] = max(g[a], l_zxy[a]);
+
+        x[0][a] = x0[a];
+        x[1][a] = x0[a] - i1[a] + cx;
+        x[2][a] = x0[a] - i2[a] + cy;
+        x[3][a] = x0[a] - 0.5f;
+    }
+
+    // Permutations
+    for (size_t a = 0; a < 3; ++a)
+    {
+        i[a] = mod289(i[a]);
+    }
+
+    const noise_batch zero(0.0f);
+    const noise_batch one(1.0f);
+
+    const noise_batch oz[4] = { zero, i1[2], i2[2], one };
+    const noise_batch oy[4] = { zero, i1[1], i2[1], one };
+    const noise_batch ox[4] = { zero, i1[0], i2[0], one };
+
+    // Gradients
+    const f32 n_ = static_cast<f32>(0.142857142857); // 1 / 7
+    const f32 ns_x = n_ * 2.0f - 0.0f;
+    const f32 ns_y = n_ * 0.5f - 1.0f;
+    const f32 ns_z = n_ * 1.0f - 0.0f;
+
+    noise_batch result;
+
+    for (size_t c = 0; c < 4; ++c)
+    {
+        const noise_batch p = permute(permute(permute(i[2] + oz[c]) + i[1] + oy[c]) + i[0] + ox[c]);
+
+        const noise_batch j = p - 49.0f * floor(p * ns_z * ns_z);
+        const noise_batch x_ = floor(j * ns_z);
+        const noise_batch y_ = floor(j - 7.0f * x_);
+
+        const noise_batch gx = x_ * ns_x + ns_y;
+        const noise_batch gy = y_ * ns_x + ns_y;
+        const noise_batch h = 1.0f - abs(gx) - abs(gy);
+
+        const noise_batch sh = -step(h, 0.0f);
+        noise_batch px = gx + (floor(gx) * 2.0f + 1.0f) * sh;
+        noise_batch py = gy + (floor(gy) * 2.0f + 1.0f) * sh;
+        noise_batch pz = h;
+
+        // Normalize gradients
+        const noise_batch norm = taylor_inv_sqrt((px * px) + (py * py) + (pz * pz));
+        px = px * norm;
+        py = py * norm;
+        pz = pz * norm;
+
+        // Final noise value
+        noise_batch m = max(0.5f - ((x[c][0] * x[c][0]) + (x[c][1] * x[c][1]) + (x[c][2] * x[c][2])), 0.0f);
+        m = m * m;
+
+        const noise_batch contribution = (m * m) * ((px * x[c][0]) + (py * x[c][1]) + (pz * x[c][2]));
+        result = (c == 0) ? contribution : (result + contribution);
+    }
+
+    return 105.0f * result;
+}
+
+} // namespace _priv
+} // namespace math
+} // namespace vx
@@ -3,10 +3,18 @@
 #include "vertex/math/procedural/noise/perlin_noise.hpp"
 #include "vertex/math/procedural/noise/simplex_noise.hpp"
 #include "vertex/math/procedural/noise/cellular_noise.hpp"
+#include "vertex/math/procedural/noise/noise_batch.hpp"
+#include "vertex/std/span.hpp"
 
 namespace vx {
 namespace math {
 
+enum class noise_type
+{
+    perlin,
+    simplex
+};
+
 struct noise_sampler
 {
     ///////////////////////////////////////////////////////////////////////////////
@@ -61,8 +69,207 @@ struct noise_sampler
         return sample_internal<T, R>(uv, static_cast<R(*)(T)>(&::vx::math::cellular_noise));
     }
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // fill
+    ///////////////////////////////////////////////////////////////////////////////
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Samples a grid of 2D noise.
+    ///
+    /// Value x, y of the grid goes to out[y * width + x] and matches
+    /// perlin_noise or simplex_noise at origin + step * vec2(x, y). Several
+    /// points are evaluated at once with every octave done in the same pass,
+    /// which is several times faster than sampling one point at a time. The
+    /// kernels round the same way as the single point functions, so values
+    /// only differ when the compiler fuses multiply-adds in one and not the
+    /// other, and then by less than 1e-4 with amplitudes summing to 2.
+    ///
+    /// @param out The values, at least width * height of them.
+    /// @param type The noise to sample.
+    /// @param origin The point of the first value.
+    /// @param step The distance between neighboring values.
+    /// @param width The number of values in a row.
+    /// @param height The number of rows.
+    /// @param policy Optional. Has a for_each_band(rows, row_size, fn)
+    /// function that calls fn(begin, end) over every band of rows, like
+    /// pixel::execution_policy.
+    ///
+    /// @return True if out is large enough, otherwise false.
+    ///////////////////////////////////////////////////////////////////////////////
+    bool fill_2d(span<f32> out, noise_type type, const vec2& origin, const vec2& step, size_t width, size_t height) const noexcept
+    {
+        return fill_internal(out, type, origin, vec2(step.x, 0.0f), vec2(0.0f, step.y), width, height, sequential_bands{});
+    }
+
+    template <typename Policy>
+    bool fill_2d(span<f32> out, noise_type type, const vec2& origin, const vec2& step, size_t width, size_t height, const Policy& policy) const
+    {
+        return fill_internal(out, type, origin, vec2(step.x, 0.0f), vec2(0.0f, step.y), width, height, policy);
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    /// @brief Samples a planar slice of 3D noise.
+    ///
+    /// Like fill_2d, value x, y matches the single point sample at
+    /// origin + step_x * x + step_y * y within the same tolerance. Slices of
+    /// a volume or animated 2D noise use the third axis as depth or time.
+    ///
+    /// @param out The values, at least width * height of them.
+    /// @param type The noise to sample.
+    /// @param origin The point of the first value.
+    /// @param step_x The distance between neighboring values in a row.
+    /// @param step_y The distance between neighboring rows.
+    /// @param width The number of values in a row.
+    /// @param height The number of rows.
+    /// @param policy Optional. Runs bands of rows, see fill_2d.
+    ///
+    /// @return True if out is large enough, otherwise false.
+    ///////////////////////////////////////////////////////////////////////////////
+    bool fill_3d(span<f32> out, noise_type type, const vec3& origin, const vec3& step_x, const vec3& step_y, size_t width, size_t height) const noexcept
+    {
+        return fill_internal(out, type, origin, step_x, step_y, width, height, sequential_bands{});
+    }
+
+    template <typename Policy>
+    bool fill_3d(span<f32> out, noise_type type, const vec3& origin, const vec3& step_x, const vec3& step_y, size_t width, size_t height, const Policy& policy) const
+    {
+        return fill_internal(out, type, origin, step_x, step_y, width, height, policy);
+    }
+
 private:
 
+    struct sequential_bands
+    {
+        template <typename F>
+        void for_each_band(size_t rows, size_t, F&& fn) const
+        {
+            fn(static_cast<size_t>(0), rows);
+        }
+    };
+
+    template <size_t L, typename Policy>
+    bool fill_internal(
+        span<f32> out,
+        noise_type type,
+        const vec<L, f32>& origin,
+        const vec<L, f32>& step_x,
+        const vec<L, f32>& step_y,
+        size_t width,
+        size_t height,
+        const Policy& policy
+    ) const
+    {
+        if (out.size() / (width ? width : 1) < height)
+        {
+            return false;
+        }
+
+        f32* data = out.data();
+
+        policy.for_each_band(height, width * sizeof(f32), [&](size_t begin, size_t end)
+        {
+            switch (type)
+            {
+                case noise_type::perlin:
+                {
+                    fill_rows<L>(data, origin, step_x, step_y, width, begin, end, [](const _priv::noise_batch* p)
+                    {
+                        VX_IF_CONSTEXPR (L == 2) return _priv::perlin_noise(p[0], p[1]);
+                        else return _priv::perlin_noise(p[0], p[1], p[2]);
+                    });
+                    break;
+                }
+                case noise_type::simplex:
+                {
+                    fill_rows<L>(data, origin, step_x, step_y, width, begin, end, [](const _priv::noise_batch* p)
+                    {
+                        VX_IF_CONSTEXPR (L == 2) return _priv::simplex_noise(p[0], p[1]);
+                        else return _priv::simplex_noise(p[0], p[1], p[2]);
+                    });
+                    break;
+                }
+            }
+        });
+
+        return true;
+    }
+
+    // The same steps as sample_internal on a batch of points.
+    template <size_t L, typename F>
+    VX_FORCE_INLINE void fill_rows(
+        f32* out,
+        const vec<L, f32>& origin,
+        const vec<L, f32>& step_x,
+        const vec<L, f32>& step_y,
+        size_t width,
+        size_t begin,
+        size_t end,
+        F noise_func
+    ) const noexcept
+    {
+        using batch = _priv::noise_batch;
+        constexpr size_t n = batch::size;
+
+        for (size_t y = begin; y < end; ++y)
+        {
+            f32* row = out + y * width;
+
+            f32 row_start[L];
+            for (size_t c = 0; c < L; ++c)
+            {
+                row_start[c] = step_y[c] * static_cast<f32>(y);
+            }
+
+            for (size_t x = 0; x < width; x += n)
+            {
+                const batch bx = batch(static_cast<f32>(x)) + batch::lane_index();
+
+                batch uvs[L];
+                for (size_t c = 0; c < L; ++c)
+                {
+                    uvs[c] = ((origin[c] + step_x[c] * bx) + row_start[c]) + seed[c];
+                }
+
+                f32 v_frequency = frequency;
+                f32 v_amplitude = amplitude;
+                batch value(0.0f);
+
+                for (size_t i = 0; i < octaves; ++i)
+                {
+                    batch p[L];
+                    for (size_t c = 0; c < L; ++c)
+                    {
+                        p[c] = uvs[c] * v_frequency;
+                    }
+
+                    value = value + noise_func(p) * v_amplitude;
+
+                    v_frequency *= lacunarity;
+                    v_amplitude *= persistence;
+                }
+
+                if (normalize)
+                {
+                    value = (value + 1.0f) * 0.5f;
+                }
+
+                if (x + n <= width)
+                {
+                    value.store(row + x);
+                }
+                else
+                {
+                    f32 tail[n];
+                    value.store(tail);
+                    for (size_t i = 0; i < width - x; ++i)
+                    {
+                        row[x + i] = tail[i];
+                    }
+                }
+            }
+        }
+    }
+
     template <typename T, typename R>
     VX_FORCE_INLINE R sample_internal(const T& uv, R(*noise_func)(T)) const noexcept
     {
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "vertex/math/simd/arch/config.hpp"
+
+namespace vx {
+namespace math {
+namespace simd {
+
+// Kernels that run over arrays of vectors, matrices and quaternions several
+// elements at a time. Without them math::batch loops over the elements with
+// the scalar functions.
+
+template <typename T>
+struct batch_t
+{
+    using scalar_type = T;
+
+    static constexpr size_t size = 1;
+
+    static constexpr int HAVE_TRANSFORM = 0;
+    static constexpr int HAVE_MUL = 0;
+    static constexpr int HAVE_INVERSE = 0;
+    static constexpr int HAVE_ROTATION_CAST = 0;
+    static constexpr int HAVE_SLERP = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// batch types
+///////////////////////////////////////////////////////////////////////////////
+
+// float
+using batchf = batch_t<f32>;
+
+} // namespace simd
+} // namespace math
+} // namespace vx
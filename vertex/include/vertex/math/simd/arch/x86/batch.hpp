@@ -0,0 +1,718 @@
+#pragma once
+
+#include "vertex/math/simd/arch/config.hpp"
+#include "vertex/math/simd/arch/batch_default.hpp"
+
+namespace vx {
+namespace math {
+namespace simd {
+
+#if defined(VX_SIMD_X86) && (VX_SIMD_X86 >= VX_SIMD_X86_SSE2_VERSION)
+
+// Most kernels work on a structure of arrays: register k holds float k of
+// size elements, 8 with AVX2 and 4 otherwise. Each one does the operations
+// of the scalar function it replaces in the same order. They return how
+// many elements they did, the caller finishes the rest with the scalar
+// function.
+
+template <>
+struct batch_t<f32>
+{
+    ///////////////////////////////////////////////////////////////////////////////
+    // meta
+    ///////////////////////////////////////////////////////////////////////////////
+
+    using scalar_type = f32;
+
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+
+    using data_type = __m256;
+    using int_type = __m256i;
+    static constexpr size_t size = 8;
+
+#else
+
+    using data_type = __m128;
+    using int_type = __m128i;
+    static constexpr size_t size = 4;
+
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // lanes
+    ///////////////////////////////////////////////////////////////////////////////
+
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+
+    static VX_FORCE_INLINE data_type set1(scalar_type x) noexcept { return _mm256_set1_ps(x); }
+    static VX_FORCE_INLINE data_type load(const scalar_type* p) noexcept { return _mm256_loadu_ps(p); }
+    static VX_FORCE_INLINE void store(scalar_type* p, data_type v) noexcept { _mm256_storeu_ps(p, v); }
+
+    static VX_FORCE_INLINE data_type add(data_type a, data_type b) noexcept { return _mm256_add_ps(a, b); }
+    static VX_FORCE_INLINE data_type sub(data_type a, data_type b) noexcept { return _mm256_sub_ps(a, b); }
+    static VX_FORCE_INLINE data_type mul(data_type a, data_type b) noexcept { return _mm256_mul_ps(a, b); }
+    static VX_FORCE_INLINE data_type div(data_type a, data_type b) noexcept { return _mm256_div_ps(a, b); }
+    static VX_FORCE_INLINE data_type sqrt(data_type a) noexcept { return _mm256_sqrt_ps(a); }
+
+    static VX_FORCE_INLINE data_type bit_and(data_type a, data_type b) noexcept { return _mm256_and_ps(a, b); }
+    static VX_FORCE_INLINE data_type bit_xor(data_type a, data_type b) noexcept { return _mm256_xor_ps(a, b); }
+    static VX_FORCE_INLINE data_type bit_andnot(data_type a, data_type b) noexcept { return _mm256_andnot_ps(a, b); }
+
+    static VX_FORCE_INLINE data_type cmp_lt(data_type a, data_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static VX_FORCE_INLINE data_type cmp_le(data_type a, data_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static VX_FORCE_INLINE data_type cmp_gt(data_type a, data_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static VX_FORCE_INLINE data_type cmp_ge(data_type a, data_type b) noexcept { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+
+    // a where mask is set, otherwise b
+    static VX_FORCE_INLINE data_type select(data_type mask, data_type a, data_type b) noexcept { return _mm256_blendv_ps(b, a, mask); }
+
+    // within each 128 bit half, like _mm_shuffle_ps
+    template <int I>
+    static VX_FORCE_INLINE data_type shuffle(data_type a, data_type b) noexcept { return _mm256_shuffle_ps(a, b, I); }
+
+    static VX_FORCE_INLINE int_type to_int(data_type a) noexcept { return _mm256_cvttps_epi32(a); }
+    static VX_FORCE_INLINE data_type to_float(int_type a) noexcept { return _mm256_cvtepi32_ps(a); }
+    static VX_FORCE_INLINE int_type set1_int(int32_t x) noexcept { return _mm256_set1_epi32(x); }
+    static VX_FORCE_INLINE int_type add_int(int_type a, int_type b) noexcept { return _mm256_add_epi32(a, b); }
+    static VX_FORCE_INLINE int_type and_int(int_type a, int_type b) noexcept { return _mm256_and_si256(a, b); }
+    static VX_FORCE_INLINE data_type cmp_eq_int(int_type a, int_type b) noexcept { return _mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)); }
+    static VX_FORCE_INLINE data_type sign_from_int(int_type a) noexcept { return _mm256_castsi256_ps(_mm256_slli_epi32(a, 29)); }
+
+#else
+
+    static VX_FORCE_INLINE data_type set1(scalar_type x) noexcept { return _mm_set1_ps(x); }
+    static VX_FORCE_INLINE data_type load(const scalar_type* p) noexcept { return _mm_loadu_ps(p); }
+    static VX_FORCE_INLINE void store(scalar_type* p, data_type v) noexcept { _mm_storeu_ps(p, v); }
+
+    static VX_FORCE_INLINE data_type add(data_type a, data_type b) noexcept { return _mm_add_ps(a, b); }
+    static VX_FORCE_INLINE data_type sub(data_type a, data_type b) noexcept { return _mm_sub_ps(a, b); }
+    static VX_FORCE_INLINE data_type mul(data_type a, data_type b) noexcept { return _mm_mul_ps(a, b); }
+    static VX_FORCE_INLINE data_type div(data_type a, data_type b) noexcept { return _mm_div_ps(a, b); }
+    static VX_FORCE_INLINE data_type sqrt(data_type a) noexcept { return _mm_sqrt_ps(a); }
+
+    static VX_FORCE_INLINE data_type bit_and(data_type a, data_type b) noexcept { return _mm_and_ps(a, b); }
+    static VX_FORCE_INLINE data_type bit_xor(data_type a, data_type b) noexcept { return _mm_xor_ps(a, b); }
+    static VX_FORCE_INLINE data_type bit_andnot(data_type a, data_type b) noexcept { return _mm_andnot_ps(a, b); }
+
+    static VX_FORCE_INLINE data_type cmp_lt(data_type a, data_type b) noexcept { return _mm_cmplt_ps(a, b); }
+    static VX_FORCE_INLINE data_type cmp_le(data_type a, data_type b) noexcept { return _mm_cmple_ps(a, b); }
+    static VX_FORCE_INLINE data_type cmp_gt(data_type a, data_type b) noexcept { return _mm_cmpgt_ps(a, b); }
+    static VX_FORCE_INLINE data_type cmp_ge(data_type a, data_type b) noexcept { return _mm_cmpge_ps(a, b); }
+
+    // a where mask is set, otherwise b
+    static VX_FORCE_INLINE data_type select(data_type mask, data_type a, data_type b) noexcept { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+    template <int I>
+    static VX_FORCE_INLINE data_type shuffle(data_type a, data_type b) noexcept { return _mm_shuffle_ps(a, b, I); }
+
+    static VX_FORCE_INLINE int_type to_int(data_type a) noexcept { return _mm_cvttps_epi32(a); }
+    static VX_FORCE_INLINE data_type to_float(int_type a) noexcept { return _mm_cvtepi32_ps(a); }
+    static VX_FORCE_INLINE int_type set1_int(int32_t x) noexcept { return _mm_set1_epi32(x); }
+    static VX_FORCE_INLINE int_type add_int(int_type a, int_type b) noexcept { return _mm_add_epi32(a, b); }
+    static VX_FORCE_INLINE int_type and_int(int_type a, int_type b) noexcept { return _mm_and_si128(a, b); }
+    static VX_FORCE_INLINE data_type cmp_eq_int(int_type a, int_type b) noexcept { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+    static VX_FORCE_INLINE data_type sign_from_int(int_type a) noexcept { return _mm_castsi128_ps(_mm_slli_epi32(a, 29)); }
+
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // structure of arrays
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // K is 3 or 4, the 4th float of a 3 float element is 0
+    template <size_t K>
+    static VX_FORCE_INLINE __m128 load_element(const scalar_type* p) noexcept
+    {
+        VX_IF_CONSTEXPR (K == 4)
+        {
+            return _mm_loadu_ps(p);
+        }
+        else
+        {
+            const __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+            return _mm_movelh_ps(xy, _mm_load_ss(p + 2));
+        }
+    }
+
+    template <size_t K>
+    static VX_FORCE_INLINE void store_element(scalar_type* p, __m128 v) noexcept
+    {
+        VX_IF_CONSTEXPR (K == 4)
+        {
+            _mm_storeu_ps(p, v);
+        }
+        else
+        {
+            _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+            _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+        }
+    }
+
+    // Reads the first K floats of size elements that are stride floats apart,
+    // out[k] gets float k of every element.
+    template <size_t K>
+    static VX_FORCE_INLINE void load_soa(const scalar_type* src, size_t stride, data_type* out) noexcept
+    {
+        __m128 r[size];
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            r[i] = load_element<K>(src + i * stride);
+        }
+
+        for (size_t i = 0; i < size; i += 4)
+        {
+            _MM_TRANSPOSE4_PS(r[i + 0], r[i + 1], r[i + 2], r[i + 3]);
+        }
+
+        for (size_t k = 0; k < K; ++k)
+        {
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+            out[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(r[k]), r[4 + k], 1);
+#else
+            out[k] = r[k];
+#endif
+        }
+    }
+
+    // The reverse of load_soa.
+    template <size_t K>
+    static VX_FORCE_INLINE void store_aos(const data_type* in, scalar_type* dst, size_t stride) noexcept
+    {
+        __m128 r[size];
+
+        for (size_t k = 0; k < 4; ++k)
+        {
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+            r[k] = (k < K) ? _mm256_castps256_ps128(in[k]) : _mm_setzero_ps();
+            r[4 + k] = (k < K) ? _mm256_extractf128_ps(in[k], 1) : _mm_setzero_ps();
+#else
+            r[k] = (k < K) ? in[k] : _mm_setzero_ps();
+#endif
+        }
+
+        for (size_t i = 0; i < size; i += 4)
+        {
+            _MM_TRANSPOSE4_PS(r[i + 0], r[i + 1], r[i + 2], r[i + 3]);
+        }
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            store_element<K>(dst + i * stride, r[i]);
+        }
+    }
+
+    // Packed 3 float elements, the common case of load_soa<3> and
+    // store_aos<3>. Each 128 bit half of the 3 registers holds 4 elements
+    // that are split with shuffles instead of being loaded one at a time.
+    static VX_FORCE_INLINE void load_soa3(const scalar_type* src, data_type* out) noexcept
+    {
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+        const data_type a = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 0)), _mm_loadu_ps(src + 12), 1);
+        const data_type b = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 4)), _mm_loadu_ps(src + 16), 1);
+        const data_type c = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(src + 8)), _mm_loadu_ps(src + 20), 1);
+#else
+        const data_type a = load(src + 0);
+        const data_type b = load(src + 4);
+        const data_type c = load(src + 8);
+#endif
+
+        // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+        out[0] = shuffle<_MM_SHUFFLE(2, 0, 3, 0)>(a, shuffle<_MM_SHUFFLE(1, 1, 2, 2)>(b, c));
+        out[1] = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(shuffle<_MM_SHUFFLE(0, 0, 1, 1)>(a, b), shuffle<_MM_SHUFFLE(2, 2, 3, 3)>(b, c));
+        out[2] = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(shuffle<_MM_SHUFFLE(1, 1, 2, 2)>(a, b), shuffle<_MM_SHUFFLE(3, 3, 0, 0)>(c, c));
+    }
+
+    static VX_FORCE_INLINE void store_aos3(const data_type* in, scalar_type* dst) noexcept
+    {
+        const data_type x = in[0], y = in[1], z = in[2];
+
+        const data_type a = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(shuffle<_MM_SHUFFLE(0, 0, 0, 0)>(x, y), shuffle<_MM_SHUFFLE(1, 1, 0, 0)>(z, x));
+        const data_type b = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(y, z), shuffle<_MM_SHUFFLE(2, 2, 2, 2)>(x, y));
+        const data_type c = shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(shuffle<_MM_SHUFFLE(3, 3, 2, 2)>(z, x), shuffle<_MM_SHUFFLE(3, 3, 3, 3)>(y, z));
+
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+        _mm_storeu_ps(dst + 0, _mm256_castps256_ps128(a));
+        _mm_storeu_ps(dst + 4, _mm256_castps256_ps128(b));
+        _mm_storeu_ps(dst + 8, _mm256_castps256_ps128(c));
+        _mm_storeu_ps(dst + 12, _mm256_extractf128_ps(a, 1));
+        _mm_storeu_ps(dst + 16, _mm256_extractf128_ps(b, 1));
+        _mm_storeu_ps(dst + 20, _mm256_extractf128_ps(c, 1));
+#else
+        store(dst + 0, a);
+        store(dst + 4, b);
+        store(dst + 8, c);
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // transform
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // m * vec4(v, w) for vectors of In floats, 3 or 4, keeping the first Out
+    // floats of the result. With Soa the results go to the arrays out[0] to
+    // out[Out - 1], otherwise to out[0] as vectors of Out floats.
+    template <size_t In, size_t Out, bool Soa>
+    static VX_FORCE_INLINE size_t transform(const scalar_type* m, const scalar_type* in, scalar_type w, scalar_type* const* out, size_t count) noexcept
+    {
+        // vec4 results are faster without a transpose
+        VX_IF_CONSTEXPR (!Soa && Out == 4)
+        {
+            return transform_aos<In, Out>(m, in, w, out[0], count);
+        }
+
+        data_type mc[4][Out];
+
+        for (size_t k = 0; k < 4; ++k)
+        {
+            for (size_t c = 0; c < Out; ++c)
+            {
+                mc[k][c] = set1(m[k * 4 + c]);
+            }
+        }
+
+        const data_type wv = set1(w);
+        size_t i = 0;
+
+        for (; i + size <= count; i += size)
+        {
+            data_type v[4];
+
+            VX_IF_CONSTEXPR (In == 3)
+            {
+                load_soa3(in + i * In, v);
+                v[3] = wv;
+            }
+            else
+            {
+                load_soa<In>(in + i * In, In, v);
+            }
+
+            data_type r[Out];
+
+            for (size_t c = 0; c < Out; ++c)
+            {
+                r[c] = add(add(add(mul(mc[0][c], v[0]), mul(mc[1][c], v[1])), mul(mc[2][c], v[2])), mul(mc[3][c], v[3]));
+            }
+
+            VX_IF_CONSTEXPR (Soa)
+            {
+                for (size_t c = 0; c < Out; ++c)
+                {
+                    store(out[c] + i, r[c]);
+                }
+            }
+            else
+            {
+                store_aos3(r, out[0] + i * Out);
+            }
+        }
+
+        return i;
+    }
+
+    // Without a transpose: each result is a sum of the columns of m scaled by
+    // the components of the vector, with AVX2 each half of a register works on
+    // a different vector.
+    template <size_t In, size_t Out>
+    static VX_FORCE_INLINE size_t transform_aos(const scalar_type* m, const scalar_type* in, scalar_type w, scalar_type* out, size_t count) noexcept
+    {
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+
+        const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+        const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+        const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+        const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+        const __m256 c3w = mul(c3, set1(w));
+
+        constexpr size_t step = 2;
+        size_t i = 0;
+
+        for (; i + step <= count; i += step)
+        {
+            const __m256 v = _mm256_insertf128_ps(_mm256_castps128_ps256(load_element<In>(in + i * In)), load_element<In>(in + i * In + In), 1);
+
+            const __m256 e0 = _mm256_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m256 e1 = _mm256_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m256 e2 = _mm256_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+
+            __m256 r = add(add(mul(c0, e0), mul(c1, e1)), mul(c2, e2));
+
+            VX_IF_CONSTEXPR (In == 4)
+            {
+                r = add(r, mul(c3, _mm256_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+            }
+            else
+            {
+                r = add(r, c3w);
+            }
+
+            // in and out may be the same array
+            store_element<Out>(out + i * Out, _mm256_castps256_ps128(r));
+            store_element<Out>(out + i * Out + Out, _mm256_extractf128_ps(r, 1));
+        }
+
+        return i;
+
+#else
+
+        const __m128 c0 = _mm_loadu_ps(m);
+        const __m128 c1 = _mm_loadu_ps(m + 4);
+        const __m128 c2 = _mm_loadu_ps(m + 8);
+        const __m128 c3 = _mm_loadu_ps(m + 12);
+        const __m128 c3w = mul(c3, set1(w));
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const __m128 v = load_element<In>(in + i * In);
+
+            const __m128 e0 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 e1 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 e2 = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+
+            __m128 r = add(add(mul(c0, e0), mul(c1, e1)), mul(c2, e2));
+
+            VX_IF_CONSTEXPR (In == 4)
+            {
+                r = add(r, mul(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+            }
+            else
+            {
+                r = add(r, c3w);
+            }
+
+            store_element<Out>(out + i * Out, r);
+        }
+
+        return count;
+
+#endif
+    }
+
+    static constexpr int HAVE_TRANSFORM = 1;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // mul
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // out[i] = a[i] * b[i] for column major 4x4 matrices, with an a_stride of
+    // 0 every b[i] is multiplied by the same a. A matrix product needs no
+    // transpose: every column of the result is a sum of the columns of a, so
+    // with AVX2 each half of a register works on a different matrix.
+    static VX_FORCE_INLINE size_t mul(const scalar_type* a, size_t a_stride, const scalar_type* b, scalar_type* out, size_t count) noexcept
+    {
+#if (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+
+        constexpr size_t step = 2;
+        size_t i = 0;
+
+        for (; i + step <= count; i += step)
+        {
+            const scalar_type* a0 = a + i * a_stride;
+            const scalar_type* a1 = a0 + a_stride;
+            const scalar_type* b0 = b + i * 16;
+
+            __m256 ac[4];
+            for (size_t k = 0; k < 4; ++k)
+            {
+                ac[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(a0 + k * 4)), _mm_loadu_ps(a1 + k * 4), 1);
+            }
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                const __m256 bj = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(b0 + j * 4)), _mm_loadu_ps(b0 + 16 + j * 4), 1);
+
+                const __m256 e0 = _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0));
+                const __m256 e1 = _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1));
+                const __m256 e2 = _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2));
+                const __m256 e3 = _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3));
+
+                const __m256 r = add(add(add(mul(ac[0], e0), mul(ac[1], e1)), mul(ac[2], e2)), mul(ac[3], e3));
+
+                _mm_storeu_ps(out + i * 16 + j * 4, _mm256_castps256_ps128(r));
+                _mm_storeu_ps(out + i * 16 + 16 + j * 4, _mm256_extractf128_ps(r, 1));
+            }
+        }
+
+        return i;
+
+#else
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const scalar_type* a0 = a + i * a_stride;
+            const scalar_type* b0 = b + i * 16;
+
+            const __m128 ac[4] = { _mm_loadu_ps(a0), _mm_loadu_ps(a0 + 4), _mm_loadu_ps(a0 + 8), _mm_loadu_ps(a0 + 12) };
+            __m128 r[4];
+
+            for (size_t j = 0; j < 4; ++j)
+            {
+                const __m128 bj = _mm_loadu_ps(b0 + j * 4);
+
+                const __m128 e0 = _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0));
+                const __m128 e1 = _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1));
+                const __m128 e2 = _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2));
+                const __m128 e3 = _mm_shuffle_ps(bj, bj, _MM_SHUFFLE(3, 3, 3, 3));
+
+                r[j] = add(add(add(mul(ac[0], e0), mul(ac[1], e1)), mul(ac[2], e2)), mul(ac[3], e3));
+            }
+
+            // b and out may be the same matrix
+            for (size_t j = 0; j < 4; ++j)
+            {
+                _mm_storeu_ps(out + i * 16 + j * 4, r[j]);
+            }
+        }
+
+        return count;
+
+#endif
+    }
+
+    static constexpr int HAVE_MUL = 1;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // inverse
+    ///////////////////////////////////////////////////////////////////////////////
+
+    static VX_FORCE_INLINE size_t inverse(const scalar_type* in, scalar_type* out, size_t count) noexcept
+    {
+        size_t i = 0;
+
+        for (; i + size <= count; i += size)
+        {
+            data_type a[16];
+            for (size_t c = 0; c < 4; ++c)
+            {
+                load_soa<4>(in + i * 16 + c * 4, 16, a + c * 4);
+            }
+
+            const data_type a00 = a[0], a01 = a[1], a02 = a[2], a03 = a[3];
+            const data_type a10 = a[4], a11 = a[5], a12 = a[6], a13 = a[7];
+            const data_type a20 = a[8], a21 = a[9], a22 = a[10], a23 = a[11];
+            const data_type a30 = a[12], a31 = a[13], a32 = a[14], a33 = a[15];
+
+            const data_type b00 = sub(mul(a00, a11), mul(a01, a10));
+            const data_type b01 = sub(mul(a00, a12), mul(a02, a10));
+            const data_type b02 = sub(mul(a00, a13), mul(a03, a10));
+            const data_type b03 = sub(mul(a01, a12), mul(a02, a11));
+            const data_type b04 = sub(mul(a01, a13), mul(a03, a11));
+            const data_type b05 = sub(mul(a02, a13), mul(a03, a12));
+            const data_type b06 = sub(mul(a20, a31), mul(a21, a30));
+            const data_type b07 = sub(mul(a20, a32), mul(a22, a30));
+            const data_type b08 = sub(mul(a20, a33), mul(a23, a30));
+            const data_type b09 = sub(mul(a21, a32), mul(a22, a31));
+            const data_type b10 = sub(mul(a21, a33), mul(a23, a31));
+            const data_type b11 = sub(mul(a22, a33), mul(a23, a32));
+
+            const data_type det = add(sub(add(add(sub(mul(b00, b11), mul(b01, b10)), mul(b02, b09)), mul(b03, b08)), mul(b04, b07)), mul(b05, b06));
+            const data_type idet = div(set1(1.0f), det);
+
+            data_type r[16];
+
+            r[0]  = mul(add(sub(mul(a11, b11), mul(a12, b10)), mul(a13, b09)), idet);
+            r[1]  = mul(sub(sub(mul(a02, b10), mul(a01, b11)), mul(a03, b09)), idet);
+            r[2]  = mul(add(sub(mul(a31, b05), mul(a32, b04)), mul(a33, b03)), idet);
+            r[3]  = mul(sub(sub(mul(a22, b04), mul(a21, b05)), mul(a23, b03)), idet);
+            r[4]  = mul(sub(sub(mul(a12, b08), mul(a10, b11)), mul(a13, b07)), idet);
+            r[5]  = mul(add(sub(mul(a00, b11), mul(a02, b08)), mul(a03, b07)), idet);
+            r[6]  = mul(sub(sub(mul(a32, b02), mul(a30, b05)), mul(a33, b01)), idet);
+            r[7]  = mul(add(sub(mul(a20, b05), mul(a22, b02)), mul(a23, b01)), idet);
+            r[8]  = mul(add(sub(mul(a10, b10), mul(a11, b08)), mul(a13, b06)), idet);
+            r[9]  = mul(sub(sub(mul(a01, b08), mul(a00, b10)), mul(a03, b06)), idet);
+            r[10] = mul(add(sub(mul(a30, b04), mul(a31, b02)), mul(a33, b00)), idet);
+            r[11] = mul(sub(sub(mul(a21, b02), mul(a20, b04)), mul(a23, b00)), idet);
+            r[12] = mul(sub(sub(mul(a11, b07), mul(a10, b09)), mul(a12, b06)), idet);
+            r[13] = mul(add(sub(mul(a00, b09), mul(a01, b07)), mul(a02, b06)), idet);
+            r[14] = mul(sub(sub(mul(a31, b01), mul(a30, b03)), mul(a32, b00)), idet);
+            r[15] = mul(add(sub(mul(a20, b03), mul(a21, b01)), mul(a22, b00)), idet);
+
+            for (size_t c = 0; c < 4; ++c)
+            {
+                store_aos<4>(r + c * 4, out + i * 16 + c * 4, 16);
+            }
+        }
+
+        return i;
+    }
+
+    static constexpr int HAVE_INVERSE = 1;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // rotation cast
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // quaternions stored w, x, y, z to column major 4x4 matrices
+    static VX_FORCE_INLINE size_t rotation_cast(const scalar_type* in, scalar_type* out, size_t count) noexcept
+    {
+        const data_type one = set1(1.0f);
+        const data_type two = set1(2.0f);
+        const data_type zero = set1(0.0f);
+        const __m128 last_column = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+        size_t i = 0;
+
+        for (; i + size <= count; i += size)
+        {
+            data_type q[4];
+            load_soa<4>(in + i * 4, 4, q);
+
+            const data_type qw = q[0], qx = q[1], qy = q[2], qz = q[3];
+
+            const data_type qxx = mul(qx, qx);
+            const data_type qyy = mul(qy, qy);
+            const data_type qzz = mul(qz, qz);
+            const data_type qxz = mul(qx, qz);
+            const data_type qxy = mul(qx, qy);
+            const data_type qyz = mul(qy, qz);
+            const data_type qwx = mul(qw, qx);
+            const data_type qwy = mul(qw, qy);
+            const data_type qwz = mul(qw, qz);
+
+            // the 4th row is 0
+            const data_type c0[4] = { sub(one, mul(two, add(qyy, qzz))), mul(two, add(qxy, qwz)), mul(two, sub(qxz, qwy)), zero };
+            const data_type c1[4] = { mul(two, sub(qxy, qwz)), sub(one, mul(two, add(qxx, qzz))), mul(two, add(qyz, qwx)), zero };
+            const data_type c2[4] = { mul(two, add(qxz, qwy)), mul(two, sub(qyz, qwx)), sub(one, mul(two, add(qxx, qyy))), zero };
+
+            store_aos<4>(c0, out + i * 16 + 0, 16);
+            store_aos<4>(c1, out + i * 16 + 4, 16);
+            store_aos<4>(c2, out + i * 16 + 8, 16);
+
+            for (size_t j = 0; j < size; ++j)
+            {
+                _mm_storeu_ps(out + (i + j) * 16 + 12, last_column);
+            }
+        }
+
+        return i;
+    }
+
+    static constexpr int HAVE_ROTATION_CAST = 1;
+
+    ///////////////////////////////////////////////////////////////////////////////
+    // slerp
+    ///////////////////////////////////////////////////////////////////////////////
+
+    // acos of x in [0, 1] within a few ulp, from asin in the cephes library
+    static VX_FORCE_INLINE data_type acos_unit(data_type x) noexcept
+    {
+        const data_type big = cmp_gt(x, set1(0.5f));
+
+        const data_type z_big = mul(set1(0.5f), sub(set1(1.0f), x));
+        const data_type z = select(big, z_big, mul(x, x));
+        const data_type a = select(big, sqrt(z_big), x);
+
+        data_type p = set1(4.2163199048e-2f);
+        p = add(mul(p, z), set1(2.4181311049e-2f));
+        p = add(mul(p, z), set1(4.5470025998e-2f));
+        p = add(mul(p, z), set1(7.4953002686e-2f));
+        p = add(mul(p, z), set1(1.6666752422e-1f));
+        const data_type asin_a = add(mul(mul(p, z), a), a);
+
+        return select(big, add(asin_a, asin_a), sub(set1(1.57079632679489661923f), asin_a));
+    }
+
+    // sin within a few ulp for |x| below 8192, from sinf in the cephes library
+    static VX_FORCE_INLINE data_type sin(data_type x) noexcept
+    {
+        const data_type sign_mask = set1(-0.0f);
+        const data_type sign = bit_and(x, sign_mask);
+        const data_type ax = bit_andnot(sign_mask, x);
+
+        // the octant rounded up to even
+        int_type j = to_int(mul(ax, set1(1.27323954473516f)));
+        j = and_int(add_int(j, set1_int(1)), set1_int(~1));
+        const data_type y = to_float(j);
+
+        const data_type use_cos = cmp_eq_int(and_int(j, set1_int(2)), set1_int(2));
+        const data_type flip = sign_from_int(and_int(j, set1_int(4)));
+
+        const data_type xr = sub(sub(sub(ax, mul(y, set1(0.78515625f))), mul(y, set1(2.4187564849853515625e-4f))), mul(y, set1(3.77489497744594108e-8f)));
+        const data_type z = mul(xr, xr);
+
+        data_type pc = set1(2.443315711809948e-5f);
+        pc = add(mul(pc, z), set1(-1.388731625493765e-3f));
+        pc = add(mul(pc, z), set1(4.166664568298827e-2f));
+        pc = add(sub(mul(mul(pc, z), z), mul(set1(0.5f), z)), set1(1.0f));
+
+        data_type ps = set1(-1.9515295891e-4f);
+        ps = add(mul(ps, z), set1(8.3321608736e-3f));
+        ps = add(mul(ps, z), set1(-1.6666654611e-1f));
+        ps = add(mul(mul(ps, z), xr), xr);
+
+        return bit_xor(select(use_cos, pc, ps), bit_xor(sign, flip));
+    }
+
+    // quaternions stored w, x, y, z
+    static VX_FORCE_INLINE size_t slerp(const scalar_type* x, const scalar_type* y, scalar_type t, scalar_type* out, size_t count) noexcept
+    {
+        // constants<f32>::epsilon
+        const scalar_type epsilon = static_cast<scalar_type>(1e-6);
+
+        const data_type zero = set1(0.0f);
+        const data_type one = set1(1.0f);
+        const data_type tv = set1(t);
+        const data_type one_minus_t = set1(1.0f - t);
+
+        size_t i = 0;
+
+        for (; i + size <= count; i += size)
+        {
+            data_type qx[4], qy[4];
+            load_soa<4>(x + i * 4, 4, qx);
+            load_soa<4>(y + i * 4, 4, qy);
+
+            const data_type d = add(add(add(mul(qx[0], qy[0]), mul(qx[1], qy[1])), mul(qx[2], qy[2])), mul(qx[3], qy[3]));
+
+            const data_type negative = cmp_lt(d, zero);
+            const data_type xsign = select(negative, set1(-1.0f), one);
+            const data_type cos_half_theta = select(negative, sub(zero, d), d);
+
+            const data_type near_one = cmp_ge(cos_half_theta, set1(1.0f - epsilon));
+            const data_type near_zero = cmp_le(cos_half_theta, set1(epsilon));
+
+            const data_type half_theta = acos_unit(cos_half_theta);
+            const data_type sin_half_theta = sqrt(sub(one, mul(cos_half_theta, cos_half_theta)));
+            const data_type inv_sin_half_theta = div(one, sin_half_theta);
+
+            const data_type t1 = sin(mul(one_minus_t, half_theta));
+            const data_type t2 = sin(mul(tv, half_theta));
+
+            data_type q[4];
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                const data_type sx = mul(xsign, qx[k]);
+
+                const data_type lerp = add(mul(sx, one_minus_t), mul(qy[k], tv));
+                const data_type mid = mul(add(qx[k], qy[k]), set1(0.5f));
+                const data_type arc = mul(add(mul(sx, t1), mul(qy[k], t2)), inv_sin_half_theta);
+
+                q[k] = select(near_one, lerp, select(near_zero, mid, arc));
+            }
+
+            // normalize
+            const data_type magsq = add(add(add(mul(q[0], q[0]), mul(q[1], q[1])), mul(q[2], q[2])), mul(q[3], q[3]));
+            const data_type degenerate = cmp_le(magsq, set1(epsilon));
+            const data_type inv_length = div(one, sqrt(magsq));
+
+            for (size_t k = 0; k < 4; ++k)
+            {
+                q[k] = select(degenerate, (k == 0) ? one : zero, mul(q[k], inv_length));
+            }
+
+            store_aos<4>(q, out + i * 4, 4);
+        }
+
+        return i;
+    }
+
+    static constexpr int HAVE_SLERP = 1;
+};
+
+#endif // VX_SIMD_X86_SSE2_VERSION
+
+} // namespace simd
+} // namespace math
+} // namespace vx
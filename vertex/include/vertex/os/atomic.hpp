@@ -14,6 +14,10 @@ namespace os {
 template <typename T>
 using atomic = std::atomic<T>;
 
+// assumed size of a cache line, used to keep independently written atomics
+// from sharing one
+constexpr size_t cache_line_size = 64;
+
 //==============================================================================
 // helpers
 //==============================================================================
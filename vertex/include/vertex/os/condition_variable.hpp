@@ -0,0 +1,165 @@
+#pragma once
+
+#include "vertex/config/language_config.hpp"
+#include "vertex/os/atomic.hpp"
+#include "vertex/os/time.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Condition Variable
+//=============================================================================
+
+/**
+ * @brief Blocks threads until another thread notifies them.
+ *
+ * Works with any mutex type that has `lock` and `unlock`. As with any condition
+ * variable, waits may return without a notification, so the waited for condition
+ * must be checked again in a loop or through the predicate overloads.
+ */
+class condition_variable
+{
+public:
+
+    condition_variable() noexcept = default;
+    ~condition_variable() noexcept = default;
+
+    condition_variable(const condition_variable&) = delete;
+    condition_variable& operator=(const condition_variable&) = delete;
+
+public:
+
+    /**
+     * @brief Unlocks the mutex, waits for a notification, then locks it again.
+     *
+     * @param m A mutex locked by the calling thread.
+     */
+    template <typename mutex_t>
+    void wait(mutex_t& m)
+    {
+        const uint32_t seq = begin_wait();
+        m.unlock();
+        wait_impl(seq, -1);
+        m.lock();
+        end_wait();
+    }
+
+    /**
+     * @brief Waits until the predicate returns true.
+     *
+     * @param m A mutex locked by the calling thread.
+     * @param pred A callable returning true once the wait should end, called with
+     * the mutex locked.
+     */
+    template <typename mutex_t, typename P>
+    void wait(mutex_t& m, P pred)
+    {
+        while (!pred())
+        {
+            wait(m);
+        }
+    }
+
+    /**
+     * @brief Waits for a notification for at most the given time.
+     *
+     * @param m A mutex locked by the calling thread.
+     * @param timeout The longest time to wait.
+     * @return False if the timeout expired, true otherwise.
+     */
+    template <typename mutex_t>
+    bool wait_for(mutex_t& m, const time::time_point& timeout)
+    {
+        const uint32_t seq = begin_wait();
+        m.unlock();
+        const bool woken = wait_impl(seq, clamp_timeout(timeout));
+        m.lock();
+        end_wait();
+        return woken;
+    }
+
+    /**
+     * @brief Waits until the predicate returns true for at most the given time.
+     *
+     * @param m A mutex locked by the calling thread.
+     * @param timeout The longest time to wait.
+     * @param pred A callable returning true once the wait should end, called with
+     * the mutex locked.
+     * @return The last result of the predicate.
+     */
+    template <typename mutex_t, typename P>
+    bool wait_for(mutex_t& m, const time::time_point& timeout, P pred)
+    {
+        const time::time_point end = get_ticks() + timeout;
+
+        while (!pred())
+        {
+            const time::time_point now = get_ticks();
+            if (now >= end)
+            {
+                return pred();
+            }
+
+            wait_for(m, end - now);
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Wakes one waiting thread, if any.
+     */
+    void notify_one() noexcept
+    {
+        m_seq.fetch_add(1, std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            wake_impl(false);
+        }
+    }
+
+    /**
+     * @brief Wakes every waiting thread.
+     */
+    void notify_all() noexcept
+    {
+        m_seq.fetch_add(1, std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            wake_impl(true);
+        }
+    }
+
+private:
+
+    uint32_t begin_wait() noexcept
+    {
+        // registered before the sequence is read, so a notifier that bumps the
+        // sequence after this either sees the waiter or the waiter sees the bump
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        return m_seq.load(std::memory_order_seq_cst);
+    }
+
+    void end_wait() noexcept
+    {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    static int64_t clamp_timeout(const time::time_point& timeout) noexcept
+    {
+        const int64_t ns = timeout.as_nanoseconds();
+        return (ns > 0) ? ns : 0;
+    }
+
+    VX_API bool wait_impl(uint32_t seq, int64_t timeout_ns) noexcept;
+    VX_API void wake_impl(bool all) noexcept;
+
+private:
+
+    atomic<uint32_t> m_seq{ 0 };
+    atomic<uint32_t> m_waiters{ 0 };
+};
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "vertex/config/language_config.hpp"
+#include "vertex/os/atomic.hpp"
+#include "vertex/util/time/time.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Event
+//=============================================================================
+
+/**
+ * @brief A one-shot signal that threads can wait for.
+ *
+ * Once `set` is called the event stays set. Every current waiter is released
+ * and later waits return immediately.
+ */
+class event
+{
+public:
+
+    event() noexcept = default;
+    ~event() noexcept = default;
+
+    event(const event&) = delete;
+    event& operator=(const event&) = delete;
+
+public:
+
+    /**
+     * @brief Sets the event and wakes every waiting thread.
+     */
+    void set() noexcept
+    {
+        if (m_state.exchange(1, std::memory_order_seq_cst) == 0 && m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            wake_impl();
+        }
+    }
+
+    /**
+     * @brief Checks if the event was set.
+     */
+    bool is_set() const noexcept
+    {
+        return m_state.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief Waits until the event is set.
+     */
+    void wait() noexcept
+    {
+        if (!is_set())
+        {
+            wait_impl(-1);
+        }
+    }
+
+    /**
+     * @brief Waits at most the given time for the event to be set.
+     *
+     * @param timeout The longest time to wait.
+     * @return True if the event is set, false if the timeout expired.
+     */
+    bool wait_for(const time::time_point& timeout) noexcept
+    {
+        if (is_set())
+        {
+            return true;
+        }
+
+        const int64_t ns = timeout.as_nanoseconds();
+        return wait_impl((ns > 0) ? ns : 0);
+    }
+
+private:
+
+    VX_API bool wait_impl(int64_t timeout_ns) noexcept;
+    VX_API void wake_impl() noexcept;
+
+private:
+
+    atomic<uint32_t> m_state{ 0 };
+    atomic<uint32_t> m_waiters{ 0 };
+};
+
+} // namespace os
+} // namespace vx
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <cstring>
+#include <iterator>
 #include <vector>
 
 #include "vertex/os/handle.hpp"
 #include "vertex/os/path.hpp"
+#include "vertex/std/string_view.hpp"
 
 namespace vx {
 namespace os {
@@ -34,6 +36,11 @@ enum class stream_position
  * The `file` class provides methods for reading, writing, opening, closing, and manipulating files.
  * It supports a variety of file modes, including reading, writing, and appending, and includes
  * functionality to query file sizes, seek within files, and flush data.
+ *
+ * By default every read and write goes straight to the operating system. Calling
+ * `set_buffer_size` with a non zero size makes reads fetch a whole block at a time and
+ * collects small writes until the buffer fills, `flush` is called, or the file is
+ * closed. Buffered writes are not visible to other handles on the same file until then.
  */
 class file
 {
@@ -60,9 +67,13 @@ public:
     enum : size_t
     {
         invalid_size        = std::numeric_limits<size_t>::max(),
-        invalid_position    = invalid_size
+        invalid_position    = invalid_size,
+        default_buffer_size = 64 * 1024
     };
 
+    class line_iterator;
+    class line_range;
+
 public:
 
     VX_API file() noexcept;
@@ -184,7 +195,7 @@ public:
      * @param from The position from which to seek (e.g., begin, current, end).
      * @return True if the seek was successful, false otherwise.
      */
-    VX_API bool seek(int off, stream_position from = stream_position::begin);
+    VX_API bool seek(int64_t off, stream_position from = stream_position::begin);
 
     /**
      * @brief Gets the current file position.
@@ -203,12 +214,44 @@ public:
     /**
      * @brief Flushes the file buffer_type.
      *
-     * Ensures that all buffered data is written to the file.
+     * Writes any data held in the internal buffer to the file, then asks the operating
+     * system to commit it to disk.
      *
      * @return True if the flush was successful, false otherwise.
      */
     VX_API bool flush();
 
+    ///////////////////////////////////////////////////////////////////////////////
+    // buffering
+    ///////////////////////////////////////////////////////////////////////////////
+
+    /**
+     * @brief Sets the size of the internal read and write buffer.
+     *
+     * Pending writes are flushed and any data read ahead is discarded before the size
+     * changes. Files start unbuffered (size 0), which is what callers that share the
+     * underlying file or need every write to reach the operating system immediately
+     * should keep. `default_buffer_size` suits reading or writing a file sequentially.
+     *
+     * @param size The new buffer size in bytes.
+     * @return True if the buffer was synchronized and resized, false otherwise.
+     */
+    VX_API bool set_buffer_size(size_t size);
+
+    /**
+     * @brief Gets the size of the internal read and write buffer.
+     *
+     * @return The buffer size in bytes, 0 if the file is unbuffered.
+     */
+    size_t get_buffer_size() const noexcept { return m_buffer_size; }
+
+    /**
+     * @brief Checks if reads and writes go through the internal buffer.
+     *
+     * @return True if the file is buffered, false otherwise.
+     */
+    bool is_buffered() const noexcept { return m_buffer_size != 0; }
+
 public:
 
     ///////////////////////////////////////////////////////////////////////////////
@@ -353,12 +396,35 @@ public:
      *
      * This function reads a line from the file and correctly handles different newline conventions across platforms. On Windows,
      * lines ending with `\r\n` are handled properly, while on other platforms, lines ending with `\n` are expected.
+     * The last line of the file does not need a line ending.
      *
      * @param line A reference to a string to store the read line.
      * @return `true` if a line was successfully read, `false` if an error occurred or end of file was reached.
      */
     VX_API bool read_line(std::string& line);
 
+    /**
+     * @brief Reads a single line from the file without copying it.
+     *
+     * Behaves like the `std::string` overload but returns a view into the internal
+     * buffer. The view is only valid until the next operation on the file. Lines longer
+     * than the buffer grow it as needed. This overload requires a buffered file.
+     *
+     * @param line A reference to a view to point at the line.
+     * @return `true` if a line was successfully read, `false` if an error occurred or end of file was reached.
+     */
+    VX_API bool read_line(string_view& line);
+
+    /**
+     * @brief Returns a range over the remaining lines of the file.
+     *
+     * Each line is yielded as a view into the internal buffer, see `read_line(string_view&)`.
+     * The range reads from the current position and requires a buffered file.
+     *
+     * @return A range whose iterators read the file one line at a time.
+     */
+    line_range lines() noexcept;
+
     /**
      * @brief Writes a single line to the file with the appropriate platform-specific line ending.
      *
@@ -508,13 +574,102 @@ private:
     static file from_native_handle(typename handle::native_handle h, mode m);
     typename handle::native_handle get_native_handle() const { return m_handle.get(); }
 
+    enum class buffer_state
+    {
+        none,
+        read,
+        write
+    };
+
+    bool flush_buffer();
+    bool sync_buffer();
+    size_t fill_buffer();
+
 private:
 
     friend _priv::file_impl;
 
     mode m_mode = mode::none;
     handle m_handle;
+
+    // read: [m_buffer_pos, m_buffer_end) is data read ahead of the logical position
+    // write: [0, m_buffer_end) is data not yet written to the file
+    buffer_state m_buffer_state = buffer_state::none;
+    size_t m_buffer_size = 0;
+    size_t m_buffer_pos = 0;
+    size_t m_buffer_end = 0;
+    std::vector<uint8_t> m_buffer;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// line iterator
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief Input iterator that reads a file one line at a time.
+ *
+ * Dereferencing yields a view into the file's buffer which is invalidated when the
+ * iterator is advanced. Iterators compare equal to the end iterator once the file
+ * runs out of lines.
+ */
+class file::line_iterator
+{
+public:
+
+    using iterator_category = std::input_iterator_tag;
+    using value_type = string_view;
+    using difference_type = ptrdiff_t;
+    using pointer = const string_view*;
+    using reference = const string_view&;
+
+    line_iterator() noexcept = default;
+
+    explicit line_iterator(file* f) : m_file(f)
+    {
+        ++(*this);
+    }
+
+    reference operator*() const noexcept { return m_line; }
+    pointer operator->() const noexcept { return &m_line; }
+
+    line_iterator& operator++()
+    {
+        if (m_file && !m_file->read_line(m_line))
+        {
+            m_file = nullptr;
+            m_line = string_view();
+        }
+
+        return *this;
+    }
+
+    friend bool operator==(const line_iterator& lhs, const line_iterator& rhs) noexcept { return lhs.m_file == rhs.m_file; }
+    friend bool operator!=(const line_iterator& lhs, const line_iterator& rhs) noexcept { return lhs.m_file != rhs.m_file; }
+
+private:
+
+    file* m_file = nullptr;
+    string_view m_line;
+};
+
+class file::line_range
+{
+public:
+
+    explicit line_range(file* f) noexcept : m_file(f) {}
+
+    line_iterator begin() const { return line_iterator(m_file); }
+    line_iterator end() const noexcept { return line_iterator(); }
+
+private:
+
+    file* m_file;
 };
 
+inline file::line_range file::lines() noexcept
+{
+    return line_range(this);
+}
+
 } // namespace os
 } // namespace vx
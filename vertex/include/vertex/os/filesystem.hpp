@@ -445,20 +445,44 @@ VX_FLAGS_UT_DECLARE_BEGIN(copy_options, uint32_t)
 }
 VX_FLAGS_DECLARE_END(copy_options)
 
+/**
+ * @brief Callback reporting the progress of a file copy.
+ *
+ * Called after each chunk of the file has been copied.
+ *
+ * @param copied The number of bytes of the file copied so far.
+ * @param total The size of the file in bytes.
+ * @param user_data The user data passed to the copy function.
+ * @return True to continue copying, false to cancel the copy.
+ */
+using copy_progress_callback = bool (*)(size_t copied, size_t total, void* user_data);
+
 /**
  * @brief Copies a regular file to a new location.
  *
  * If the destination file exists, it will be overwritten if the `overwrite_existing` option is set.
  *
+ * The data is copied by the operating system where possible without passing through user
+ * space. Holes in sparse files are preserved.
+ *
  * @param from The source file path to copy from.
  * @param to The destination file path to copy to.
  * @param overwrite_existing Flag indicating whether to overwrite an existing file at the destination.
+ * @param progress Optional callback reporting progress, which can cancel the copy.
+ * @param user_data User data passed to the progress callback.
  * @return True on success; false on failure.
  *
  * @note If the source file does not exist, or if the source is not a regular file, the operation will fail.
  * @note If the destination file exists and `overwrite_existing` is false, no operation will occur.
- */
-VX_API bool copy_file(const path& from, const path& to, bool overwrite_existing = true);
+ * @note If the copy is cancelled the destination file is left partially written.
+ */
+VX_API bool copy_file(
+    const path& from,
+    const path& to,
+    bool overwrite_existing = true,
+    copy_progress_callback progress = nullptr,
+    void* user_data = nullptr
+);
 
 /**
  * @brief Copies a symbolic link to a new location.
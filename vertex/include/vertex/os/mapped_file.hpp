@@ -0,0 +1,246 @@
+#pragma once
+
+#include <limits>
+#include <utility> // std::swap
+
+#include "vertex/config/language_config.hpp"
+#include "vertex/os/path.hpp"
+
+namespace vx {
+namespace os {
+
+///////////////////////////////////////////////////////////////////////////////
+// mapped_file
+///////////////////////////////////////////////////////////////////////////////
+
+namespace _priv {
+
+struct mapped_file_impl;
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @brief A view of a file's contents mapped into memory.
+ *
+ * The `mapped_file` class maps a window of a file into the address space so its bytes
+ * can be used in place without copying them through `file::read`. The window can cover
+ * the whole file or a range given by an offset and a length, which does not need to be
+ * page aligned.
+ *
+ * On platforms without memory mapping the window is read into memory instead. Read-write
+ * views are then written back on `flush` and when the view is unmapped.
+ */
+class mapped_file
+{
+public:
+
+    /**
+     * @brief Enumerates how the mapped bytes may be accessed.
+     */
+    enum class access
+    {
+        none,
+        read_only,      // file must exist, writing to the view is not allowed
+        read_write,     // file must exist, writes to the view change the file
+        copy_on_write   // file must exist, writes to the view stay private to it
+    };
+
+    /**
+     * @brief Enumerates hints about how the view will be accessed.
+     */
+    enum class advice
+    {
+        normal,         // no particular pattern
+        sequential,     // read ahead aggressively, pages behind may be dropped early
+        random,         // avoid reading ahead
+        will_need       // start loading the pages now
+    };
+
+    enum : size_t
+    {
+        whole_file = std::numeric_limits<size_t>::max()
+    };
+
+public:
+
+    mapped_file() noexcept = default;
+    ~mapped_file() { unmap(); }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) noexcept
+        : m_access(other.m_access)
+        , m_data(other.m_data)
+        , m_size(other.m_size)
+        , m_offset(other.m_offset)
+        , m_base(other.m_base)
+        , m_mapped_size(other.m_mapped_size)
+    {
+        other.release();
+    }
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+
+            m_access = other.m_access;
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_offset = other.m_offset;
+            m_base = other.m_base;
+            m_mapped_size = other.m_mapped_size;
+
+            other.release();
+        }
+
+        return *this;
+    }
+
+    void swap(mapped_file& other) noexcept
+    {
+        std::swap(m_access, other.m_access);
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_offset, other.m_offset);
+        std::swap(m_base, other.m_base);
+        std::swap(m_mapped_size, other.m_mapped_size);
+    }
+
+public:
+
+    /**
+     * @brief Maps a window of a file into memory.
+     *
+     * The window starts `offset` bytes into the file and covers `length` bytes, or the
+     * rest of the file when `length` is `whole_file`. The window must lie within the
+     * file, mapping does not grow it. An empty window is valid and maps nothing.
+     *
+     * @param p The path to the file.
+     * @param mode How the mapped bytes may be accessed.
+     * @param offset The offset of the first byte of the window in the file.
+     * @param length The number of bytes in the window.
+     * @return True if the file was successfully mapped, false otherwise.
+     */
+    VX_API bool map(const path& p, access mode = access::read_only, size_t offset = 0, size_t length = whole_file);
+
+    /**
+     * @brief Unmaps the view.
+     *
+     * Changes made through a read-write view remain in the file. Changes made through a
+     * copy-on-write view are discarded.
+     */
+    VX_API void unmap();
+
+    /**
+     * @brief Checks if a file is currently mapped.
+     *
+     * @return True if the view is mapped, false otherwise.
+     */
+    bool is_mapped() const noexcept { return m_access != access::none; }
+
+    /**
+     * @brief Gets the access mode of the view.
+     *
+     * @return The mode the view was mapped with.
+     */
+    access get_access() const noexcept { return m_access; }
+
+    /**
+     * @brief Checks if the view may be written to.
+     *
+     * @return True if the view is read-write or copy-on-write, false otherwise.
+     */
+    bool can_write() const noexcept { return (m_access == access::read_write || m_access == access::copy_on_write); }
+
+    /**
+     * @brief Passes a hint about the upcoming access pattern to the operating system.
+     *
+     * Hints only affect performance. Platforms that do not support them ignore them.
+     *
+     * @param hint The expected access pattern.
+     * @return True if the hint was accepted, false otherwise.
+     */
+    VX_API bool advise(advice hint);
+
+    /**
+     * @brief Writes changes made through a read-write view back to the file.
+     *
+     * Returns once the data has been written. Does nothing for other access modes.
+     *
+     * @return True if the flush was successful, false otherwise.
+     */
+    VX_API bool flush();
+
+public:
+
+    /**
+     * @brief Gets a pointer to the first byte of the window.
+     *
+     * Writing through the pointer is only allowed if `can_write` returns true.
+     *
+     * @return A pointer to the mapped bytes, or null if nothing is mapped.
+     */
+    uint8_t* data() noexcept { return m_data; }
+    const uint8_t* data() const noexcept { return m_data; }
+
+    /**
+     * @brief Gets the number of bytes in the window.
+     *
+     * @return The size of the window in bytes.
+     */
+    size_t size() const noexcept { return m_size; }
+
+    /**
+     * @brief Checks if the window contains no bytes.
+     *
+     * @return True if the window is empty, false otherwise.
+     */
+    bool empty() const noexcept { return m_size == 0; }
+
+    /**
+     * @brief Gets the position of the window in the file.
+     *
+     * @return The offset of the first byte of the window in the file.
+     */
+    size_t offset() const noexcept { return m_offset; }
+
+    uint8_t* begin() noexcept { return m_data; }
+    const uint8_t* begin() const noexcept { return m_data; }
+    uint8_t* end() noexcept { return m_data + m_size; }
+    const uint8_t* end() const noexcept { return m_data + m_size; }
+
+private:
+
+    void release() noexcept
+    {
+        m_access = access::none;
+        m_data = nullptr;
+        m_size = 0;
+        m_offset = 0;
+        m_base = nullptr;
+        m_mapped_size = 0;
+    }
+
+private:
+
+    friend _priv::mapped_file_impl;
+
+    access m_access = access::none;
+
+    // the window requested by the caller
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_offset = 0;
+
+    // the platform mapping that contains the window
+    void* m_base = nullptr;
+    size_t m_mapped_size = 0;
+};
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "vertex/os/atomic.hpp"
+#include "vertex/std/memory.hpp"
+
+namespace vx {
+namespace os {
+
+//==============================================================================
+// mpsc_queue
+//==============================================================================
+
+// Bounded lock free queue for many producers and a single consumer.
+//
+// The capacity is rounded up to a power of two. Each slot carries a sequence
+// number that tells producers whether it is free and the consumer whether it
+// has been published, so producers only contend on the tail index and the
+// consumer never touches it. head and tail live on separate cache lines.
+//
+// Any thread may call try_push. try_pop must only be called by one thread at
+// a time, callers that pop from several threads have to serialize them.
+template <typename T>
+class mpsc_queue
+{
+public:
+
+    using value_type = T;
+    using size_type = size_t;
+
+    explicit mpsc_queue(size_type capacity) noexcept
+    {
+        capacity = (capacity < 2) ? 2 : capacity;
+        capacity = mem::_mem_priv::is_pow_2(capacity) ? capacity : round_up_pow_2(capacity);
+
+        m_slots = allocator_type::allocate(capacity);
+
+        VX_UNLIKELY_COLD_PATH(!m_slots,
+            {
+                return;
+            });
+
+        for (size_type i = 0; i < capacity; ++i)
+        {
+            mem::construct_in_place(&m_slots[i]);
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        m_mask = capacity - 1;
+    }
+
+    ~mpsc_queue()
+    {
+        if (m_slots)
+        {
+            mem::destroy_range(m_slots, capacity());
+            allocator_type::deallocate(m_slots, capacity());
+        }
+    }
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+public:
+
+    // 0 if the slots could not be allocated, every push fails in that case
+    size_type capacity() const noexcept
+    {
+        return m_slots ? m_mask + 1 : 0;
+    }
+
+    // approximate when called from a producer
+    bool empty() const noexcept
+    {
+        if (!m_slots)
+        {
+            return true;
+        }
+
+        const size_type pos = m_head.value.load(std::memory_order_relaxed);
+        return m_slots[pos & m_mask].sequence.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    //==============================================================================
+    // producer
+    //==============================================================================
+
+    // returns false if the queue is full
+    bool try_push(const T& value) noexcept
+    {
+        slot* s = claim();
+        if (!s)
+        {
+            return false;
+        }
+
+        s->value = value;
+        publish(s);
+        return true;
+    }
+
+    bool try_push(T&& value) noexcept
+    {
+        slot* s = claim();
+        if (!s)
+        {
+            return false;
+        }
+
+        s->value = std::move(value);
+        publish(s);
+        return true;
+    }
+
+    //==============================================================================
+    // consumer
+    //==============================================================================
+
+    // returns false if there is nothing published at the head
+    bool try_pop(T& value) noexcept
+    {
+        if (!m_slots)
+        {
+            return false;
+        }
+
+        const size_type pos = m_head.value.load(std::memory_order_relaxed);
+        slot& s = m_slots[pos & m_mask];
+
+        if (s.sequence.load(std::memory_order_acquire) != pos + 1)
+        {
+            return false;
+        }
+
+        value = std::move(s.value);
+
+        // hand the slot back to producers one lap ahead
+        s.sequence.store(pos + m_mask + 1, std::memory_order_release);
+        m_head.value.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+
+    struct slot
+    {
+        atomic<size_type> sequence;
+        T value;
+    };
+
+    struct alignas(cache_line_size) padded_index
+    {
+        atomic<size_type> value{ 0 };
+    };
+
+    using allocator_type = mem::default_allocator<slot>;
+
+    static size_type round_up_pow_2(size_type x) noexcept
+    {
+        size_type p = 1;
+        while (p < x)
+        {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // reserves the slot at the tail, or returns null if the queue is full
+    slot* claim() noexcept
+    {
+        if (!m_slots)
+        {
+            return nullptr;
+        }
+
+        size_type pos = m_tail.value.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            slot& s = m_slots[pos & m_mask];
+            const size_type seq = s.sequence.load(std::memory_order_acquire);
+            const ptrdiff_t diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+
+            if (diff == 0)
+            {
+                // the slot is free for this lap, try to take it
+                if (m_tail.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    return &s;
+                }
+            }
+            else if (diff < 0)
+            {
+                // the consumer has not freed this slot yet
+                return nullptr;
+            }
+            else
+            {
+                // another producer took it, catch up
+                pos = m_tail.value.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void publish(slot* s) noexcept
+    {
+        // the sequence of a claimed slot still holds the position it was
+        // claimed at, which is the value the consumer waits for minus one
+        const size_type pos = s->sequence.load(std::memory_order_relaxed);
+        s->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+private:
+
+    padded_index m_head;
+    padded_index m_tail;
+
+    slot* m_slots = nullptr;
+    size_type m_mask = 0;
+};
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "vertex/config/language_config.hpp"
+#include "vertex/os/atomic.hpp"
+#include "vertex/util/time/time.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Semaphore
+//=============================================================================
+
+/**
+ * @brief A counting semaphore.
+ *
+ * `acquire` takes one unit from the count, waiting while it is zero, and `release`
+ * adds units back. Neither touches the kernel while the count stays positive or
+ * no thread is waiting.
+ */
+class semaphore
+{
+public:
+
+    explicit semaphore(uint32_t initial_count = 0) noexcept
+        : m_count(initial_count)
+    {}
+
+    ~semaphore() noexcept = default;
+
+    semaphore(const semaphore&) = delete;
+    semaphore& operator=(const semaphore&) = delete;
+
+public:
+
+    /**
+     * @brief Takes one unit, waiting until one is available.
+     */
+    void acquire() noexcept
+    {
+        if (!try_acquire())
+        {
+            acquire_impl(-1);
+        }
+    }
+
+    /**
+     * @brief Takes one unit if one is available without waiting.
+     *
+     * @return True if a unit was taken.
+     */
+    bool try_acquire() noexcept
+    {
+        uint32_t count = m_count.load(std::memory_order_relaxed);
+
+        while (count != 0)
+        {
+            if (m_count.compare_exchange_weak(count, count - 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Takes one unit, waiting at most the given time for one.
+     *
+     * @param timeout The longest time to wait.
+     * @return True if a unit was taken, false if the timeout expired.
+     */
+    bool try_acquire_for(const time::time_point& timeout) noexcept
+    {
+        if (try_acquire())
+        {
+            return true;
+        }
+
+        const int64_t ns = timeout.as_nanoseconds();
+        return acquire_impl((ns > 0) ? ns : 0);
+    }
+
+    /**
+     * @brief Adds units to the count, waking waiting threads.
+     *
+     * @param count The number of units to add.
+     */
+    void release(uint32_t count = 1) noexcept
+    {
+        m_count.fetch_add(count, std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            wake_impl(count);
+        }
+    }
+
+    /**
+     * @brief Gets the number of units currently available.
+     */
+    uint32_t count() const noexcept
+    {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    VX_API bool acquire_impl(int64_t timeout_ns) noexcept;
+    VX_API void wake_impl(uint32_t count) noexcept;
+
+private:
+
+    atomic<uint32_t> m_count;
+    atomic<uint32_t> m_waiters{ 0 };
+};
+
+} // namespace os
+} // namespace vx
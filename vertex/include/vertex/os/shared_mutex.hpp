@@ -0,0 +1,150 @@
+#pragma once
+
+#include "vertex/config/language_config.hpp"
+#include "vertex/os/atomic.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Shared Mutex
+//=============================================================================
+
+/**
+ * @brief A reader-writer lock.
+ *
+ * Any number of threads may hold the lock shared, or a single thread may hold it
+ * exclusively. A writer that is waiting blocks new readers, so a steady stream
+ * of readers cannot starve writers. The lock is not recursive in either mode.
+ */
+class shared_mutex
+{
+public:
+
+    shared_mutex() noexcept = default;
+    ~shared_mutex() noexcept = default;
+
+    shared_mutex(const shared_mutex&) = delete;
+    shared_mutex& operator=(const shared_mutex&) = delete;
+
+public:
+
+    //=============================================================================
+    // exclusive
+    //=============================================================================
+
+    bool lock() noexcept
+    {
+        if (!try_lock())
+        {
+            lock_impl();
+        }
+
+        return true;
+    }
+
+    bool try_lock() noexcept
+    {
+        // a waiting writer does not keep another writer out
+        uint32_t state = m_state.load(std::memory_order_relaxed);
+        return ((state & ~writer_waiting) == 0)
+            && m_state.compare_exchange_strong(state, writer, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        m_state.fetch_and(~writer, std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            wake_impl();
+        }
+    }
+
+    //=============================================================================
+    // shared
+    //=============================================================================
+
+    bool lock_shared() noexcept
+    {
+        if (!try_lock_shared())
+        {
+            lock_shared_impl();
+        }
+
+        return true;
+    }
+
+    bool try_lock_shared() noexcept
+    {
+        uint32_t state = m_state.load(std::memory_order_relaxed);
+
+        while ((state & (writer | writer_waiting)) == 0 && (state & reader_mask) != reader_mask)
+        {
+            if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void unlock_shared() noexcept
+    {
+        const uint32_t previous = m_state.fetch_sub(1, std::memory_order_seq_cst);
+
+        // the last reader out lets a waiting writer in
+        if ((previous & reader_mask) == 1 && (previous & writer_waiting) && m_waiters.load(std::memory_order_seq_cst) != 0)
+        {
+            wake_impl();
+        }
+    }
+
+private:
+
+    VX_API void lock_impl() noexcept;
+    VX_API void lock_shared_impl() noexcept;
+    VX_API void wake_impl() noexcept;
+
+private:
+
+    static constexpr uint32_t writer = 1u << 31;
+    static constexpr uint32_t writer_waiting = 1u << 30;
+    static constexpr uint32_t reader_mask = writer_waiting - 1;
+
+    // writer and writer_waiting bits, and the number of readers below them
+    atomic<uint32_t> m_state{ 0 };
+    atomic<uint32_t> m_waiters{ 0 };
+};
+
+//=============================================================================
+// Shared Lock Guard
+//=============================================================================
+
+template <typename mutex_t>
+class shared_lock_guard
+{
+public:
+
+    using mutex_type = mutex_t;
+
+    explicit shared_lock_guard(mutex_type& mutex) noexcept
+        : m_mutex(mutex)
+    {
+        m_mutex.lock_shared();
+    }
+    ~shared_lock_guard() noexcept
+    {
+        m_mutex.unlock_shared();
+    }
+
+    shared_lock_guard(const shared_lock_guard&) = delete;
+    shared_lock_guard& operator=(const shared_lock_guard&) = delete;
+
+private:
+
+    mutex_type& m_mutex;
+};
+
+} // namespace os
+} // namespace vx
@@ -107,6 +107,7 @@ private:
         {
             callable_wrapper* task = static_cast<callable_wrapper*>(arg);
             (*task)(); // Invoke the callable
+            mem::destroy(task);
             return nullptr;
         }
 
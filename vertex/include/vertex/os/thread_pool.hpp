@@ -0,0 +1,568 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "vertex/os/atomic.hpp"
+#include "vertex/std/memory.hpp"
+
+namespace vx {
+namespace os {
+
+class thread_pool;
+
+//=============================================================================
+// wait_group
+//=============================================================================
+
+/**
+ * @brief Counts outstanding tasks so a thread can wait for all of them.
+ *
+ * `add` is called before a task is started and `done` when it finishes. Tasks
+ * submitted with `thread_pool::submit(wait_group&, fn)` do both automatically.
+ * At most 2^30 - 1 tasks may be outstanding at once.
+ */
+class wait_group
+{
+public:
+
+    wait_group() noexcept = default;
+
+    explicit wait_group(size_t count) noexcept
+        : m_state(static_cast<uint32_t>(count) << count_shift)
+    {}
+
+    wait_group(const wait_group&) = delete;
+    wait_group& operator=(const wait_group&) = delete;
+
+    void add(size_t count = 1) noexcept
+    {
+        m_state.fetch_add(static_cast<uint32_t>(count) << count_shift, std::memory_order_relaxed);
+    }
+
+    void done() noexcept
+    {
+        const uint32_t prev = m_state.fetch_sub(count_one, std::memory_order_seq_cst);
+
+        // the group may be destroyed as soon as the count is zero, so the
+        // waiter flag is taken from the value we replaced
+        if ((prev >> count_shift) == 1 && (prev & waiter_bit))
+        {
+            wake_impl();
+        }
+    }
+
+    size_t count() const noexcept
+    {
+        return static_cast<size_t>(m_state.load(std::memory_order_acquire) >> count_shift);
+    }
+
+    bool is_done() const noexcept
+    {
+        return count() == 0;
+    }
+
+private:
+
+    friend thread_pool;
+
+    // the count lives in the upper bits of the word waiters park on, so the
+    // last done() changes the word and wakes them in one step
+    enum : uint32_t
+    {
+        waiter_bit = 1u << 0,  // set once a thread parked on the group
+        poke_bit = 1u << 1,    // flipped by the pool to wake parked threads
+        count_shift = 2,
+        count_one = 1u << count_shift
+    };
+
+    VX_API void wake_impl() const noexcept;
+
+private:
+
+    mutable atomic<uint32_t> m_state{ 0 };
+};
+
+namespace _priv {
+
+//=============================================================================
+// task
+//=============================================================================
+
+// type erased unit of work, run invokes the callable and releases the task
+struct task
+{
+    using run_fn = void (*)(task*);
+    run_fn run;
+};
+
+//=============================================================================
+// future state
+//=============================================================================
+
+// shared between a task and its future, freed when both have let go of it
+struct future_state_base
+{
+    using destroy_fn = void (*)(future_state_base*);
+
+    wait_group ready{ 1 };
+    atomic<uint32_t> refs{ 2 };
+    destroy_fn destroy = nullptr;
+
+    void release() noexcept
+    {
+        if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            destroy(this);
+        }
+    }
+};
+
+template <typename T>
+struct future_state : future_state_base
+{
+    future_state() noexcept {}
+
+    ~future_state()
+    {
+        if (ready.is_done())
+        {
+            value.~T();
+        }
+    }
+
+    template <typename F>
+    void set(F& fn)
+    {
+        ::new (static_cast<void*>(&value)) T(fn());
+        ready.done();
+    }
+
+    union
+    {
+        T value;
+    };
+};
+
+template <>
+struct future_state<void> : future_state_base
+{
+    template <typename F>
+    void set(F& fn)
+    {
+        fn();
+        ready.done();
+    }
+};
+
+// task and future state in a single allocation
+template <typename F, typename T>
+struct future_task : task, future_state<T>
+{
+    explicit future_task(F&& f)
+        : fn(std::move(f))
+    {
+        task::run = run_impl;
+        future_state_base::destroy = destroy_impl;
+    }
+
+    static void run_impl(task* t)
+    {
+        future_task* self = static_cast<future_task*>(t);
+        self->set(self->fn);
+        self->release();
+    }
+
+    static void destroy_impl(future_state_base* s)
+    {
+        mem::destroy(static_cast<future_task*>(s));
+    }
+
+    F fn;
+};
+
+// task without a result
+template <typename F>
+struct simple_task : task
+{
+    explicit simple_task(F&& f)
+        : fn(std::move(f))
+    {
+        task::run = run_impl;
+    }
+
+    static void run_impl(task* t)
+    {
+        simple_task* self = static_cast<simple_task*>(t);
+        self->fn();
+        mem::destroy(self);
+    }
+
+    F fn;
+};
+
+struct thread_pool_impl;
+
+} // namespace _priv
+
+//=============================================================================
+// future
+//=============================================================================
+
+/**
+ * @brief The result of a task submitted to a `thread_pool`.
+ *
+ * Waiting on a future runs other pending tasks on the waiting thread and only
+ * blocks once there are none, so tasks may wait on futures of tasks they submit.
+ *
+ * @tparam T The type returned by the task.
+ */
+template <typename T>
+class future
+{
+public:
+
+    future() noexcept = default;
+    ~future() { reset(); }
+
+    future(const future&) = delete;
+    future& operator=(const future&) = delete;
+
+    future(future&& other) noexcept
+        : m_state(other.m_state)
+        , m_pool(other.m_pool)
+    {
+        other.m_state = nullptr;
+        other.m_pool = nullptr;
+    }
+
+    future& operator=(future&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            std::swap(m_state, other.m_state);
+            std::swap(m_pool, other.m_pool);
+        }
+
+        return *this;
+    }
+
+public:
+
+    /**
+     * @brief Checks if the future refers to a task.
+     *
+     * @return True if the future has a task whose result was not taken yet.
+     */
+    bool valid() const noexcept { return m_state != nullptr; }
+
+    /**
+     * @brief Checks if the task has finished.
+     *
+     * @return True if the result is available, false otherwise.
+     */
+    bool is_ready() const noexcept
+    {
+        return m_state && m_state->ready.is_done();
+    }
+
+    /**
+     * @brief Waits for the task to finish.
+     */
+    void wait() const;
+
+    /**
+     * @brief Waits for the task to finish and takes its result.
+     *
+     * The future is no longer valid afterwards.
+     *
+     * @return The value returned by the task.
+     */
+    T get()
+    {
+        wait();
+        return take(std::is_void<T>{});
+    }
+
+private:
+
+    T take(std::false_type)
+    {
+        T value = std::move(m_state->value);
+        reset();
+        return value;
+    }
+
+    void take(std::true_type)
+    {
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        if (m_state)
+        {
+            m_state->release();
+            m_state = nullptr;
+            m_pool = nullptr;
+        }
+    }
+
+private:
+
+    friend thread_pool;
+
+    future(_priv::future_state<T>* state, thread_pool* pool) noexcept
+        : m_state(state)
+        , m_pool(pool)
+    {}
+
+    _priv::future_state<T>* m_state = nullptr;
+    thread_pool* m_pool = nullptr;
+};
+
+//=============================================================================
+// thread_pool
+//=============================================================================
+
+/**
+ * @brief A pool of worker threads that run tasks.
+ *
+ * Each worker owns a double ended queue of tasks. Tasks submitted from a worker go
+ * to the back of its own queue and are taken from there first, which keeps related
+ * work on one thread. Idle workers steal from the front of other workers' queues.
+ * Tasks submitted from other threads go to a shared queue that all workers check.
+ *
+ * Threads that wait on a future, a wait group or a `parallel_for` run pending
+ * tasks while they wait, so waiting from inside a task does not deadlock.
+ *
+ * Tasks submitted with `submit_main` are never run by workers. They wait until
+ * the owning thread, usually the application main loop, calls `run_pending`.
+ */
+class thread_pool
+{
+public:
+
+    /**
+     * @brief Creates the pool and starts its workers.
+     *
+     * @param worker_count The number of worker threads. 0 uses one fewer than the
+     * processor count, since the thread that waits on the pool runs tasks too. If
+     * no worker could be started, tasks run on the thread that submits them.
+     */
+    VX_API explicit thread_pool(size_t worker_count = 0);
+
+    /**
+     * @brief Runs every task that is still pending and stops the workers.
+     */
+    VX_API ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+public:
+
+    /**
+     * @brief Gets the number of worker threads.
+     *
+     * @return The number of workers that were started.
+     */
+    VX_API size_t worker_count() const noexcept;
+
+    /**
+     * @brief Submits a task to the pool.
+     *
+     * @param fn A callable taking no arguments.
+     * @return A future for the value returned by `fn`, or an invalid future if the
+     * task could not be allocated.
+     */
+    template <typename F, typename R = typename std::decay<decltype(std::declval<typename std::decay<F>::type&>()())>::type>
+    future<R> submit(F&& fn)
+    {
+        auto t = make_future_task<R>(std::forward<F>(fn));
+        if (!t)
+        {
+            return future<R>{};
+        }
+
+        push(t);
+        return future<R>(t, this);
+    }
+
+    /**
+     * @brief Submits a task that marks a wait group as done when it finishes.
+     *
+     * @param wg The wait group, `add` is called on it before the task is queued.
+     * @param fn A callable taking no arguments.
+     * @return True if the task was queued, false if it could not be allocated.
+     */
+    template <typename F>
+    bool submit(wait_group& wg, F&& fn)
+    {
+        wg.add();
+
+        auto wrapper = [&wg, f = typename std::decay<F>::type(std::forward<F>(fn))]() mutable
+        {
+            f();
+            wg.done();
+        };
+
+        using task_type = _priv::simple_task<decltype(wrapper)>;
+        task_type* t = mem::construct<task_type>(std::move(wrapper));
+
+        if (!t)
+        {
+            wg.done();
+            return false;
+        }
+
+        push(t);
+        return true;
+    }
+
+    /**
+     * @brief Submits a task that only runs when `run_pending` is called.
+     *
+     * Use this for work that must happen on the thread that drives the pool,
+     * such as calls into windowing or graphics APIs.
+     *
+     * @param fn A callable taking no arguments.
+     * @return A future for the value returned by `fn`. Waiting on it from the thread
+     * that calls `run_pending` deadlocks unless `run_pending` is called first.
+     */
+    template <typename F, typename R = typename std::decay<decltype(std::declval<typename std::decay<F>::type&>()())>::type>
+    future<R> submit_main(F&& fn)
+    {
+        auto t = make_future_task<R>(std::forward<F>(fn));
+        if (!t)
+        {
+            return future<R>{};
+        }
+
+        push_main(t);
+        return future<R>(t, this);
+    }
+
+    /**
+     * @brief Runs every task submitted with `submit_main` so far.
+     *
+     * @return The number of tasks that were run.
+     */
+    VX_API size_t run_pending();
+
+    /**
+     * @brief Splits a range into chunks and runs them in parallel.
+     *
+     * `fn(first, last)` is called for consecutive chunks of at most `grain` indices
+     * until the range `[begin, end)` is covered. The calling thread takes part and
+     * the function returns once every chunk has finished.
+     *
+     * @param begin The first index of the range.
+     * @param end One past the last index of the range.
+     * @param grain The number of indices per chunk, 0 picks a size that gives each
+     * thread a few chunks.
+     * @param fn A callable taking the first and one past the last index of a chunk.
+     */
+    template <typename F>
+    void parallel_for(size_t begin, size_t end, size_t grain, F&& fn)
+    {
+        if (begin >= end)
+        {
+            return;
+        }
+
+        const size_t size = end - begin;
+        const size_t threads = worker_count() + 1;
+
+        if (grain == 0)
+        {
+            grain = size / (threads * 4);
+            grain = (grain == 0) ? 1 : grain;
+        }
+
+        const size_t chunk_count = (size + grain - 1) / grain;
+        if (chunk_count == 1 || threads == 1)
+        {
+            fn(begin, end);
+            return;
+        }
+
+        // every thread claims chunks from a shared counter until none are left
+        atomic<size_t> next_chunk{ 0 };
+        auto body = [&]()
+        {
+            for (size_t c = next_chunk.fetch_add(1, std::memory_order_relaxed); c < chunk_count; c = next_chunk.fetch_add(1, std::memory_order_relaxed))
+            {
+                const size_t first = begin + c * grain;
+                const size_t last = (size - c * grain > grain) ? first + grain : end;
+                fn(first, last);
+            }
+        };
+
+        wait_group wg;
+        const size_t helpers = (chunk_count - 1 < threads - 1) ? chunk_count - 1 : threads - 1;
+
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            submit(wg, body);
+        }
+
+        body();
+        wait(wg);
+    }
+
+    /**
+     * @brief Waits until a wait group is done, running pending tasks meanwhile.
+     *
+     * @param wg The wait group to wait for.
+     */
+    VX_API void wait(const wait_group& wg);
+
+    /**
+     * @brief Runs one pending task on the calling thread.
+     *
+     * @return True if a task was run, false if none was pending.
+     */
+    VX_API bool run_one();
+
+private:
+
+    template <typename R, typename F>
+    _priv::future_task<typename std::decay<F>::type, R>* make_future_task(F&& fn)
+    {
+        using fn_type = typename std::decay<F>::type;
+        return mem::construct<_priv::future_task<fn_type, R>>(fn_type(std::forward<F>(fn)));
+    }
+
+    template <typename T>
+    friend class future;
+
+    VX_API void push(_priv::task* t);
+    VX_API void push_main(_priv::task* t);
+
+    _priv::task* park_waiter(const wait_group& wg);
+    void wake_waiters();
+
+private:
+
+    std::unique_ptr<_priv::thread_pool_impl> m_impl;
+};
+
+//=============================================================================
+// future implementation
+//=============================================================================
+
+template <typename T>
+void future<T>::wait() const
+{
+    if (m_state && !m_state->ready.is_done())
+    {
+        m_pool->wait(m_state->ready);
+    }
+}
+
+} // namespace os
+} // namespace vx
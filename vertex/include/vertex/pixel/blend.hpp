@@ -0,0 +1,106 @@
+#pragma once
+
+#include <type_traits>
+
+#include "vertex/math/color/blend.hpp"
+
+namespace vx {
+namespace pixel {
+namespace blend {
+
+///////////////////////////////////////////////////////////////////////////////
+// blend modes
+//
+// Built in modes that blit recognizes at compile time. Surfaces with 8 bit
+// channels and alpha are blended with integer kernels, other formats call the
+// mode like any other blend function.
+//
+// Straight alpha modes multiply the source color by its alpha before blending,
+// premultiplied modes expect surfaces that already hold premultiplied color,
+// see premultiply_alpha. In both cases the destination color is used as is.
+///////////////////////////////////////////////////////////////////////////////
+
+enum class mode_type
+{
+    src_over,
+    additive,
+    multiply,
+    screen
+};
+
+template <mode_type M, bool PREMULTIPLIED>
+struct mode
+{
+    static constexpr mode_type type = M;
+    static constexpr bool premultiplied_alpha = PREMULTIPLIED;
+
+    // the blend function applied to the premultiplied source color
+    static math::blend_func_separate function() noexcept
+    {
+        math::blend_func_separate f;
+
+        f.src_alpha_blend = math::blend_mode::one;
+        f.dst_alpha_blend = math::blend_mode::one_minus_src_alpha;
+
+        switch (M)
+        {
+            case mode_type::src_over:
+            {
+                f.src_color_blend = math::blend_mode::one;
+                f.dst_color_blend = math::blend_mode::one_minus_src_alpha;
+                break;
+            }
+            case mode_type::additive:
+            {
+                f.src_color_blend = math::blend_mode::one;
+                f.dst_color_blend = math::blend_mode::one;
+                f.dst_alpha_blend = math::blend_mode::one;
+                break;
+            }
+            case mode_type::multiply:
+            {
+                f.src_color_blend = math::blend_mode::dst_color;
+                f.dst_color_blend = math::blend_mode::one_minus_src_alpha;
+                break;
+            }
+            case mode_type::screen:
+            {
+                f.src_color_blend = math::blend_mode::one;
+                f.dst_color_blend = math::blend_mode::one_minus_src_color;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+
+        return f;
+    }
+
+    math::color operator()(const math::color& src, const math::color& dst) const noexcept
+    {
+        const math::color s = PREMULTIPLIED ? src : math::color(src.r * src.a, src.g * src.a, src.b * src.a, src.a);
+        return function().blend(s, dst);
+    }
+};
+
+using src_over = mode<mode_type::src_over, false>;
+using additive = mode<mode_type::additive, false>;
+using multiply = mode<mode_type::multiply, false>;
+using screen = mode<mode_type::screen, false>;
+
+using src_over_premultiplied = mode<mode_type::src_over, true>;
+using additive_premultiplied = mode<mode_type::additive, true>;
+using multiply_premultiplied = mode<mode_type::multiply, true>;
+using screen_premultiplied = mode<mode_type::screen, true>;
+
+template <typename T>
+struct is_mode : std::false_type {};
+
+template <mode_type M, bool PREMULTIPLIED>
+struct is_mode<mode<M, PREMULTIPLIED>> : std::true_type {};
+
+} // namespace blend
+} // namespace pixel
+} // namespace vx
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "vertex/pixel/surface.hpp"
+#include "vertex/pixel/raw_convert.hpp"
+#include "vertex/pixel/raw_blend.hpp"
 #include "vertex/math/geometry/2d/functions/collision.hpp"
 
 namespace vx {
@@ -12,11 +14,6 @@ inline bool blit(
     surface<DST_FMT>& dst, const math::vec2i& dst_position
 )
 {
-    if (src.unknown_format() || dst.unknown_format())
-    {
-        return false;
-    }
-
     // Crop the area within the bounds of the src surface.
     math::recti area = math::g2::crop(src.get_rect(), src_area);
     if (area.empty())
@@ -38,12 +35,18 @@ inline bool blit(
         return true;
     }
 
+    // The area is inside both surfaces, so whole rows can be converted at
+    // once. Rows of the same format are copied directly.
+    const size_t count = static_cast<size_t>(area.size.x);
+    const size_t src_x = static_cast<size_t>(area.position.x - shift.x);
+    const size_t dst_x = static_cast<size_t>(area.position.x);
+
     for (size_t y = area.position.y; y < static_cast<size_t>(area.bottom()); ++y)
     {
-        for (size_t x = area.position.x; x < static_cast<size_t>(area.right()); ++x)
-        {
-            dst.set_pixel(x, y, src.get_pixel(x - shift.x, y - shift.y));
-        }
+        const byte_type* src_row = reinterpret_cast<const byte_type*>(&src.at(src_x, y - shift.y));
+        byte_type* dst_row = reinterpret_cast<byte_type*>(&dst.at(dst_x, y));
+
+        raw::convert_row<SRC_FMT, DST_FMT>(src_row, dst_row, count);
     }
 
     return true;
@@ -62,11 +65,6 @@ inline bool blit(
     const blend_func& blend
 )
 {
-    if (src.unknown_format() || dst.unknown_format())
-    {
-        return false;
-    }
-
     // Crop the area within the bounds of the src surface.
     math::recti area = math::g2::crop(src.get_rect(), src_area);
     if (area.empty())
@@ -88,14 +86,50 @@ inline bool blit(
         return true;
     }
 
-    for (size_t y = area.position.y; y < static_cast<size_t>(area.bottom()); ++y)
+    // Built in modes blend whole rows with integer kernels. The source is
+    // converted to the destination format first, a chunk at a time.
+    VX_IF_CONSTEXPR (pixel::blend::is_mode<blend_func>::value && raw::can_blend_row(DST_FMT))
+    {
+        enum : size_t { chunk_size = 256 };
+        byte_type buffer[chunk_size * get_pixel_size(DST_FMT)];
+
+        const size_t count = static_cast<size_t>(area.size.x);
+        const size_t src_x = static_cast<size_t>(area.position.x - shift.x);
+        const size_t dst_x = static_cast<size_t>(area.position.x);
+
+        for (size_t y = area.position.y; y < static_cast<size_t>(area.bottom()); ++y)
+        {
+            const byte_type* src_row = reinterpret_cast<const byte_type*>(&src.at(src_x, y - shift.y));
+            byte_type* dst_row = reinterpret_cast<byte_type*>(&dst.at(dst_x, y));
+
+            VX_IF_CONSTEXPR (SRC_FMT == DST_FMT)
+            {
+                raw::blend_row<blend_func, DST_FMT>(src_row, dst_row, count);
+            }
+            else
+            {
+                for (size_t i = 0; i < count; i += chunk_size)
+                {
+                    const size_t n = (count - i < chunk_size) ? count - i : chunk_size;
+                    raw::convert_row<SRC_FMT, DST_FMT>(src_row + i * get_pixel_size(SRC_FMT), buffer, n);
+                    raw::blend_row<blend_func, DST_FMT>(buffer, dst_row + i * get_pixel_size(DST_FMT), n);
+                }
+            }
+        }
+    }
+    else
     {
-        for (size_t x = area.position.x; x < static_cast<size_t>(area.right()); ++x)
+        for (size_t y = area.position.y; y < static_cast<size_t>(area.bottom()); ++y)
         {
-            dst.set_pixel(
-                x, y,
-                blend(src.get_pixel(x - shift.x, y - shift.y), dst.get_pixel(x, y))
-            );
+            for (size_t x = area.position.x; x < static_cast<size_t>(area.right()); ++x)
+            {
+                // the area is inside both surfaces, no need for bounds checks
+                auto& d = dst.at(x, y);
+                d = raw_pixel<DST_FMT>(blend(
+                    static_cast<math::color>(src.at(x - shift.x, y - shift.y)),
+                    static_cast<math::color>(d)
+                ));
+            }
         }
     }
 
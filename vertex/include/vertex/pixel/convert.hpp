@@ -0,0 +1,31 @@
+#pragma once
+
+#include "vertex/pixel/pixel_format.hpp"
+#include "vertex/std/span.hpp"
+
+namespace vx {
+namespace pixel {
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Converts a buffer of pixels between two formats chosen at run time.
+///
+/// Uses the same kernels as surface::convert. The buffers must not overlap
+/// unless the formats are the same.
+///
+/// @param src_format The format of the source pixels.
+/// @param dst_format The format to convert to.
+/// @param src The source pixels, the pixel count is taken from its size.
+/// @param dst The destination, at least as many pixels as src.
+///
+/// @return True if the pixels were converted, false if a format is unknown
+/// or dst is too small.
+///////////////////////////////////////////////////////////////////////////////
+VX_API bool convert_pixels(
+    pixel_format src_format,
+    pixel_format dst_format,
+    span<const byte_type> src,
+    span<byte_type> dst
+);
+
+} // namespace pixel
+} // namespace vx
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "vertex/os/thread_pool.hpp"
+
+namespace vx {
+namespace pixel {
+
+///////////////////////////////////////////////////////////////////////////////
+// execution policy
+///////////////////////////////////////////////////////////////////////////////
+
+enum class execution_mode
+{
+    sequential,
+    parallel
+};
+
+// Chooses how an image operation runs. Parallel operations split their
+// output into bands of rows run on a thread pool. Every row is computed the
+// same way whichever band it falls in, so the result is bit identical to the
+// sequential one.
+class execution_policy
+{
+public:
+
+    // Bands smaller than this cost more to hand off than they save.
+    enum : size_t { min_band_size = 64 * 1024 };
+
+    execution_policy() noexcept = default;
+
+    static execution_policy sequential() noexcept
+    {
+        return execution_policy();
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Creates a policy that runs on a thread pool.
+    ///
+    /// @param pool The pool to run on, it must outlive every operation using
+    /// the policy.
+    /// @param thread_count The maximum number of threads working at once,
+    /// including the calling thread. 0 uses every worker of the pool.
+    ///////////////////////////////////////////////////////////////////////////
+    static execution_policy parallel(os::thread_pool& pool, size_t thread_count = 0) noexcept
+    {
+        return execution_policy(&pool, thread_count);
+    }
+
+    execution_mode mode() const noexcept
+    {
+        return (m_pool && m_thread_count != 1) ? execution_mode::parallel : execution_mode::sequential;
+    }
+
+    os::thread_pool* pool() const noexcept { return m_pool; }
+
+    size_t thread_count() const noexcept
+    {
+        if (!m_pool)
+        {
+            return 1;
+        }
+
+        const size_t available = m_pool->worker_count() + 1;
+        return (m_thread_count == 0 || m_thread_count > available) ? available : m_thread_count;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Splits rows into bands and runs them.
+    ///
+    /// `fn(first, last)` is called for consecutive bands covering `[0, rows)`
+    /// and the function returns once all of them have finished. Bands may run
+    /// in any order and at the same time, so they must not write to the same
+    /// memory.
+    ///
+    /// @param rows The number of rows.
+    /// @param row_size The bytes written per row, used to keep bands from
+    /// getting too small to be worth running on another thread.
+    /// @param fn A callable taking the first and one past the last row of a
+    /// band.
+    ///////////////////////////////////////////////////////////////////////////
+    template <typename F>
+    void for_each_band(size_t rows, size_t row_size, F&& fn) const
+    {
+        const size_t threads = thread_count();
+
+        if (threads == 1 || rows < 2)
+        {
+            fn(static_cast<size_t>(0), rows);
+            return;
+        }
+
+        // A few bands per thread balance rows that take longer than others.
+        // With a thread limit there is one band per thread, since the pool
+        // never runs more bands at once than there are bands.
+        size_t band = (m_thread_count == 0)
+            ? rows / (threads * 4)
+            : (rows + threads - 1) / threads;
+
+        const size_t min_rows = (row_size == 0) ? 1 : (min_band_size + row_size - 1) / row_size;
+        band = (band < min_rows) ? min_rows : band;
+
+        if (band >= rows)
+        {
+            fn(static_cast<size_t>(0), rows);
+            return;
+        }
+
+        m_pool->parallel_for(0, rows, band, fn);
+    }
+
+private:
+
+    execution_policy(os::thread_pool* pool, size_t thread_count) noexcept
+        : m_pool(pool), m_thread_count(thread_count) {}
+
+    os::thread_pool* m_pool = nullptr;
+    size_t m_thread_count = 0;
+};
+
+} // namespace pixel
+} // namespace vx
@@ -2,6 +2,8 @@
 
 #include <vector>
 
+#include "vertex/pixel/execution_policy.hpp"
+
 namespace vx {
 namespace pixel {
 namespace filter {
@@ -32,7 +34,7 @@ template <typename channel_type, typename float_type = float>
 inline void filter_bicubic(
     const uint8_t* src, size_t src_width, size_t src_height,
     uint8_t* dst, size_t dst_width, size_t dst_height,
-    size_t channels
+    size_t channels, const execution_policy& policy = execution_policy()
 )
 {
     static_assert(std::is_arithmetic<channel_type>::value, "channel_type must be arithmatic type");
@@ -101,58 +103,61 @@ inline void filter_bicubic(
         y_weights[(y * 4) + 3] = static_cast<float_type>(0.5) * (ttty - tty);
     }
 
-    const channel_type* pixels[4][4]{};
-    float_type qx[4]{};
-    float_type qy[4]{};
-
-    for (size_t y = 0; y < dst_height; ++y)
+    policy.for_each_band(dst_height, dst_row_size, [&](size_t first, size_t last)
     {
-        const int srcy = static_cast<int>(y * yscale - static_cast<float_type>(0.5));
+        const channel_type* pixels[4][4]{};
+        float_type qx[4]{};
+        float_type qy[4]{};
 
-        uint8_t* dstpx = &dst[dst_row_size * y];
-        qy[0] = y_weights[(y * 4) + 0];
-        qy[1] = y_weights[(y * 4) + 1];
-        qy[2] = y_weights[(y * 4) + 2];
-        qy[3] = y_weights[(y * 4) + 3];
-
-        for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
+        for (size_t y = first; y < last; ++y)
         {
-            const int srcx = static_cast<int>(x * xscale - static_cast<float_type>(0.5));
+            const int srcy = static_cast<int>(y * yscale - static_cast<float_type>(0.5));
 
-            qx[0] = x_weights[(x * 4) + 0];
-            qx[1] = x_weights[(x * 4) + 1];
-            qx[2] = x_weights[(x * 4) + 2];
-            qx[3] = x_weights[(x * 4) + 3];
+            uint8_t* dstpx = &dst[dst_row_size * y];
+            qy[0] = y_weights[(y * 4) + 0];
+            qy[1] = y_weights[(y * 4) + 1];
+            qy[2] = y_weights[(y * 4) + 2];
+            qy[3] = y_weights[(y * 4) + 3];
 
-            // Populate the pixels array with neighboring pixels for interpolation
-            for (int i = 0; i < 4; ++i)
+            for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
             {
-                int sy = std::clamp(srcy + i - 1, 0, srcymax);
-                const uint8_t* srcrow = &src[src_row_size * sy];
+                const int srcx = static_cast<int>(x * xscale - static_cast<float_type>(0.5));
+
+                qx[0] = x_weights[(x * 4) + 0];
+                qx[1] = x_weights[(x * 4) + 1];
+                qx[2] = x_weights[(x * 4) + 2];
+                qx[3] = x_weights[(x * 4) + 3];
 
-                for (int j = 0; j < 4; ++j)
+                // Populate the pixels array with neighboring pixels for interpolation
+                for (int i = 0; i < 4; ++i)
                 {
-                    int sx = std::clamp(srcx + j - 1, 0, srcxmax);
-                    pixels[i][j] = reinterpret_cast<const channel_type*>(&srcrow[sx * pixel_size]);
+                    int sy = std::clamp(srcy + i - 1, 0, srcymax);
+                    const uint8_t* srcrow = &src[src_row_size * sy];
+
+                    for (int j = 0; j < 4; ++j)
+                    {
+                        int sx = std::clamp(srcx + j - 1, 0, srcxmax);
+                        pixels[i][j] = reinterpret_cast<const channel_type*>(&srcrow[sx * pixel_size]);
+                    }
                 }
-            }
 
-            channel_type* dst_pixel = reinterpret_cast<channel_type*>(dstpx);
+                channel_type* dst_pixel = reinterpret_cast<channel_type*>(dstpx);
 
-            for (size_t c = 0; c < channels; ++c)
-            {
-                // Perform bicubic interpolation using the sixteen neighboring pixels and weights
-                const float_type px = (
-                    (pixels[0][0][c] * qx[0] + pixels[0][1][c] * qx[1] + pixels[0][2][c] * qx[2] + pixels[0][3][c] * qx[3]) * qy[0] +
-                    (pixels[1][0][c] * qx[0] + pixels[1][1][c] * qx[1] + pixels[1][2][c] * qx[2] + pixels[1][3][c] * qx[3]) * qy[1] +
-                    (pixels[2][0][c] * qx[0] + pixels[2][1][c] * qx[1] + pixels[2][2][c] * qx[2] + pixels[2][3][c] * qx[3]) * qy[2] +
-                    (pixels[3][0][c] * qx[0] + pixels[3][1][c] * qx[1] + pixels[3][2][c] * qx[2] + pixels[3][3][c] * qx[3]) * qy[3]
-                    );
-
-                dst_pixel[c] = static_cast<channel_type>(std::clamp(px, min, max));
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    // Perform bicubic interpolation using the sixteen neighboring pixels and weights
+                    const float_type px = (
+                        (pixels[0][0][c] * qx[0] + pixels[0][1][c] * qx[1] + pixels[0][2][c] * qx[2] + pixels[0][3][c] * qx[3]) * qy[0] +
+                        (pixels[1][0][c] * qx[0] + pixels[1][1][c] * qx[1] + pixels[1][2][c] * qx[2] + pixels[1][3][c] * qx[3]) * qy[1] +
+                        (pixels[2][0][c] * qx[0] + pixels[2][1][c] * qx[1] + pixels[2][2][c] * qx[2] + pixels[2][3][c] * qx[3]) * qy[2] +
+                        (pixels[3][0][c] * qx[0] + pixels[3][1][c] * qx[1] + pixels[3][2][c] * qx[2] + pixels[3][3][c] * qx[3]) * qy[3]
+                        );
+
+                    dst_pixel[c] = static_cast<channel_type>(std::clamp(px, min, max));
+                }
             }
         }
-    }
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -181,7 +186,8 @@ template <typename pixel_type, typename float_type = float>
 inline void filter_bicubic(
     const uint8_t* src, size_t src_width, size_t src_height,
     uint8_t* dst, size_t dst_width, size_t dst_height,
-    size_t channels, const uint32_t* channel_masks, const uint32_t* channel_shifts
+    size_t channels, const uint32_t* channel_masks, const uint32_t* channel_shifts,
+    const execution_policy& policy = execution_policy()
 )
 {
     static_assert(std::is_arithmetic<pixel_type>::value, "pixel_type must be arithmatic type");
@@ -252,77 +258,80 @@ inline void filter_bicubic(
         y_weights[(y * 4) + 3] = static_cast<float_type>(0.5) * (ttty - tty);
     }
 
-    const pixel_type* pixels[4][4]{};
-    float_type qx[4]{};
-    float_type qy[4]{};
-
-    for (size_t y = 0; y < dst_height; ++y)
+    policy.for_each_band(dst_height, dst_row_size, [&](size_t first, size_t last)
     {
-        const int srcy = static_cast<int>(y * yscale - static_cast<float_type>(0.5));
-
-        uint8_t* dstpx = &dst[dst_row_size * y];
-        qy[0] = y_weights[(y * 4) + 0];
-        qy[1] = y_weights[(y * 4) + 1];
-        qy[2] = y_weights[(y * 4) + 2];
-        qy[3] = y_weights[(y * 4) + 3];
+        const pixel_type* pixels[4][4]{};
+        float_type qx[4]{};
+        float_type qy[4]{};
 
-        for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
+        for (size_t y = first; y < last; ++y)
         {
-            const int srcx = static_cast<int>(x * xscale - static_cast<float_type>(0.5));
+            const int srcy = static_cast<int>(y * yscale - static_cast<float_type>(0.5));
 
-            qx[0] = x_weights[(x * 4) + 0];
-            qx[1] = x_weights[(x * 4) + 1];
-            qx[2] = x_weights[(x * 4) + 2];
-            qx[3] = x_weights[(x * 4) + 3];
+            uint8_t* dstpx = &dst[dst_row_size * y];
+            qy[0] = y_weights[(y * 4) + 0];
+            qy[1] = y_weights[(y * 4) + 1];
+            qy[2] = y_weights[(y * 4) + 2];
+            qy[3] = y_weights[(y * 4) + 3];
 
-            // Populate the pixels array with neighboring pixels for interpolation
-            for (int i = 0; i < 4; ++i)
+            for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
             {
-                int sy = std::clamp(srcy + i - 1, 0, srcymax);
-                const uint8_t* srcrow = &src[src_row_size * sy];
+                const int srcx = static_cast<int>(x * xscale - static_cast<float_type>(0.5));
 
-                for (int j = 0; j < 4; ++j)
+                qx[0] = x_weights[(x * 4) + 0];
+                qx[1] = x_weights[(x * 4) + 1];
+                qx[2] = x_weights[(x * 4) + 2];
+                qx[3] = x_weights[(x * 4) + 3];
+
+                // Populate the pixels array with neighboring pixels for interpolation
+                for (int i = 0; i < 4; ++i)
                 {
-                    int sx = std::clamp(srcx + j - 1, 0, srcxmax);
-                    pixels[i][j] = reinterpret_cast<const pixel_type*>(&srcrow[sx * pixel_size]);
+                    int sy = std::clamp(srcy + i - 1, 0, srcymax);
+                    const uint8_t* srcrow = &src[src_row_size * sy];
+
+                    for (int j = 0; j < 4; ++j)
+                    {
+                        int sx = std::clamp(srcx + j - 1, 0, srcxmax);
+                        pixels[i][j] = reinterpret_cast<const pixel_type*>(&srcrow[sx * pixel_size]);
+                    }
                 }
-            }
 
-            pixel_type* dst_pixel = reinterpret_cast<pixel_type*>(dstpx);
+                pixel_type* dst_pixel = reinterpret_cast<pixel_type*>(dstpx);
 
-            for (size_t c = 0; c < channels; ++c)
-            {
-                // Perform bicubic interpolation using the sixteen neighboring pixels and weights
-                const float_type px = (
-                    (((*pixels[0][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
-                     ((*pixels[0][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
-                     ((*pixels[0][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
-                     ((*pixels[0][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[0] +
-
-                    (((*pixels[1][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
-                     ((*pixels[1][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
-                     ((*pixels[1][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
-                     ((*pixels[1][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[1] +
-
-                    (((*pixels[2][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
-                     ((*pixels[2][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
-                     ((*pixels[2][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
-                     ((*pixels[2][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[2] +
-
-                    (((*pixels[3][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
-                     ((*pixels[3][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
-                     ((*pixels[3][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
-                     ((*pixels[3][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[3]
-                );
-
-                *dst_pixel |= (static_cast<pixel_type>(std::clamp(
-                    px,
-                    static_cast<float_type>(0),
-                    static_cast<float_type>(channel_masks[c] >> channel_shifts[c])
-                )) << channel_shifts[c]);
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    // Perform bicubic interpolation using the sixteen neighboring pixels and weights
+                    const float_type px = (
+                        (((*pixels[0][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
+                         ((*pixels[0][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
+                         ((*pixels[0][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
+                         ((*pixels[0][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[0] +
+
+                        (((*pixels[1][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
+                         ((*pixels[1][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
+                         ((*pixels[1][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
+                         ((*pixels[1][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[1] +
+
+                        (((*pixels[2][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
+                         ((*pixels[2][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
+                         ((*pixels[2][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
+                         ((*pixels[2][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[2] +
+
+                        (((*pixels[3][0] & channel_masks[c]) >> channel_shifts[c]) * qx[0] +
+                         ((*pixels[3][1] & channel_masks[c]) >> channel_shifts[c]) * qx[1] +
+                         ((*pixels[3][2] & channel_masks[c]) >> channel_shifts[c]) * qx[2] +
+                         ((*pixels[3][3] & channel_masks[c]) >> channel_shifts[c]) * qx[3]) * qy[3]
+                    );
+
+                    *dst_pixel |= (static_cast<pixel_type>(std::clamp(
+                        px,
+                        static_cast<float_type>(0),
+                        static_cast<float_type>(channel_masks[c] >> channel_shifts[c])
+                    )) << channel_shifts[c]);
+                }
             }
         }
-    }
+    });
 }
 
 } // namespace filter
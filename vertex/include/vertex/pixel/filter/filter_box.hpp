@@ -3,6 +3,8 @@
 #include <cstring>
 #include <type_traits>
 
+#include "vertex/pixel/execution_policy.hpp"
+
 namespace vx {
 namespace pixel {
 namespace filter {
@@ -36,7 +38,7 @@ template <typename channel_type, typename float_type = float>
 inline void filter_box(
     const uint8_t* src, size_t src_width, size_t src_height,
     uint8_t* dst, size_t dst_width, size_t dst_height,
-    size_t channels
+    size_t channels, const execution_policy& policy = execution_policy()
 )
 {
     static_assert(std::is_arithmetic<channel_type>::value, "channel_type must be arithmatic type");
@@ -72,45 +74,49 @@ inline void filter_box(
     const float_type xscale = static_cast<float_type>(src_width) / dst_width;
     const float_type yscale = static_cast<float_type>(src_height) / dst_height;
 
-    const channel_type* pixels[4]{};
     constexpr float_type weight = static_cast<float_type>(0.25);
 
-    for (size_t y = 0; y < dst_height; ++y)
+    policy.for_each_band(dst_height, dst_row_size, [&](size_t first, size_t last)
     {
-        size_t srcy = static_cast<size_t>(y * yscale - static_cast<float_type>(0.5));
-        const uint8_t* srcrow = &src[src_row_size * srcy];
-        const size_t dy = static_cast<size_t>(srcy < srcymax) * src_row_size;
-
-        uint8_t* dstpx = &dst[dst_row_size * y];
+        const channel_type* pixels[4]{};
 
-        for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
+        for (size_t y = first; y < last; ++y)
         {
-            const size_t srcx = static_cast<size_t>(x * xscale - static_cast<float_type>(0.5));
-            const uint8_t* srcpx = &srcrow[srcx * pixel_size];
-            const size_t dx = static_cast<size_t>(srcx < srcxmax) * pixel_size;
+            size_t srcy = static_cast<size_t>(y * yscale - static_cast<float_type>(0.5));
+            const uint8_t* srcrow = &src[src_row_size * srcy];
+            const size_t dy = static_cast<size_t>(srcy < srcymax) * src_row_size;
 
-            // Array of pointers to the four neighboring pixels used in interpolation
-            pixels[0] = reinterpret_cast<const channel_type*>(srcpx);
-            pixels[1] = reinterpret_cast<const channel_type*>(srcpx + dx);
-            pixels[2] = reinterpret_cast<const channel_type*>(srcpx + dy);
-            pixels[3] = reinterpret_cast<const channel_type*>(srcpx + dx + dy);
+            uint8_t* dstpx = &dst[dst_row_size * y];
 
-            channel_type* dst_pixel = reinterpret_cast<channel_type*>(dstpx);
-
-            for (size_t c = 0; c < channels; ++c)
+            for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
             {
-                // Perform box interpolation using the four neighboring pixels
-                const float_type px = (
-                    pixels[0][c] * weight +
-                    pixels[1][c] * weight +
-                    pixels[2][c] * weight +
-                    pixels[3][c] * weight
-                );
-
-                dst_pixel[c] = static_cast<channel_type>(std::clamp(px, min, max));
+                const size_t srcx = static_cast<size_t>(x * xscale - static_cast<float_type>(0.5));
+                const uint8_t* srcpx = &srcrow[srcx * pixel_size];
+                const size_t dx = static_cast<size_t>(srcx < srcxmax) * pixel_size;
+
+                // Array of pointers to the four neighboring pixels used in interpolation
+                pixels[0] = reinterpret_cast<const channel_type*>(srcpx);
+                pixels[1] = reinterpret_cast<const channel_type*>(srcpx + dx);
+                pixels[2] = reinterpret_cast<const channel_type*>(srcpx + dy);
+                pixels[3] = reinterpret_cast<const channel_type*>(srcpx + dx + dy);
+
+                channel_type* dst_pixel = reinterpret_cast<channel_type*>(dstpx);
+
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    // Perform box interpolation using the four neighboring pixels
+                    const float_type px = (
+                        pixels[0][c] * weight +
+                        pixels[1][c] * weight +
+                        pixels[2][c] * weight +
+                        pixels[3][c] * weight
+                    );
+
+                    dst_pixel[c] = static_cast<channel_type>(std::clamp(px, min, max));
+                }
             }
         }
-    }
+    });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -139,7 +145,8 @@ template <typename pixel_type, typename float_type = float>
 inline void filter_box(
     const uint8_t* src, size_t src_width, size_t src_height,
     uint8_t* dst, size_t dst_width, size_t dst_height,
-    size_t channels, const uint32_t* channel_masks, const uint32_t* channel_shifts
+    size_t channels, const uint32_t* channel_masks, const uint32_t* channel_shifts,
+    const execution_policy& policy = execution_policy()
 )
 {
     static_assert(std::is_arithmetic<pixel_type>::value, "pixel_type must be arithmatic type");
@@ -177,50 +184,54 @@ inline void filter_box(
     const float_type xscale = static_cast<float_type>(src_width) / dst_width;
     const float_type yscale = static_cast<float_type>(src_height) / dst_height;
 
-    const pixel_type* pixels[4]{};
     constexpr float_type weight = static_cast<float_type>(0.25);
 
-    // Loop over each row in the destination image
-    for (size_t y = 0; y < dst_height; ++y)
+    policy.for_each_band(dst_height, dst_row_size, [&](size_t first, size_t last)
     {
-        size_t srcy = static_cast<size_t>(y * yscale - static_cast<float_type>(0.5));
-        const uint8_t* srcrow = &src[src_row_size * srcy];
-        const size_t dy = static_cast<size_t>(srcy < srcymax) * src_row_size;
+        const pixel_type* pixels[4]{};
 
-        uint8_t* dstpx = &dst[dst_row_size * y];
-
-        for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
+        // Loop over each row in the destination image
+        for (size_t y = first; y < last; ++y)
         {
-            const size_t srcx = static_cast<size_t>(x * xscale - static_cast<float_type>(0.5));
-            const uint8_t* srcpx = &srcrow[srcx * pixel_size];
-            const size_t dx = static_cast<size_t>(srcx < srcxmax) * pixel_size;
-
-            // Array of pointers to the four neighboring pixels used in interpolation
-            pixels[0] = reinterpret_cast<const pixel_type*>(srcpx);
-            pixels[1] = reinterpret_cast<const pixel_type*>(srcpx + dx);
-            pixels[2] = reinterpret_cast<const pixel_type*>(srcpx + dy);
-            pixels[3] = reinterpret_cast<const pixel_type*>(srcpx + dx + dy);
+            size_t srcy = static_cast<size_t>(y * yscale - static_cast<float_type>(0.5));
+            const uint8_t* srcrow = &src[src_row_size * srcy];
+            const size_t dy = static_cast<size_t>(srcy < srcymax) * src_row_size;
 
-            pixel_type* dst_pixel = reinterpret_cast<pixel_type*>(dstpx);
+            uint8_t* dstpx = &dst[dst_row_size * y];
 
-            for (size_t c = 0; c < channels; ++c)
+            for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
             {
-                // Perform box interpolation using the four neighboring pixels
-                const float_type px = (
-                    ((*pixels[0] & channel_masks[c]) >> channel_shifts[c]) * weight +
-                    ((*pixels[1] & channel_masks[c]) >> channel_shifts[c]) * weight +
-                    ((*pixels[2] & channel_masks[c]) >> channel_shifts[c]) * weight +
-                    ((*pixels[3] & channel_masks[c]) >> channel_shifts[c]) * weight
-                );
-
-                *dst_pixel |= (static_cast<pixel_type>(std::clamp(
-                    px,
-                    static_cast<float_type>(0),
-                    static_cast<float_type>(channel_masks[c] >> channel_shifts[c])
-                )) << channel_shifts[c]);
+                const size_t srcx = static_cast<size_t>(x * xscale - static_cast<float_type>(0.5));
+                const uint8_t* srcpx = &srcrow[srcx * pixel_size];
+                const size_t dx = static_cast<size_t>(srcx < srcxmax) * pixel_size;
+
+                // Array of pointers to the four neighboring pixels used in interpolation
+                pixels[0] = reinterpret_cast<const pixel_type*>(srcpx);
+                pixels[1] = reinterpret_cast<const pixel_type*>(srcpx + dx);
+                pixels[2] = reinterpret_cast<const pixel_type*>(srcpx + dy);
+                pixels[3] = reinterpret_cast<const pixel_type*>(srcpx + dx + dy);
+
+                pixel_type* dst_pixel = reinterpret_cast<pixel_type*>(dstpx);
+
+                for (size_t c = 0; c < channels; ++c)
+                {
+                    // Perform box interpolation using the four neighboring pixels
+                    const float_type px = (
+                        ((*pixels[0] & channel_masks[c]) >> channel_shifts[c]) * weight +
+                        ((*pixels[1] & channel_masks[c]) >> channel_shifts[c]) * weight +
+                        ((*pixels[2] & channel_masks[c]) >> channel_shifts[c]) * weight +
+                        ((*pixels[3] & channel_masks[c]) >> channel_shifts[c]) * weight
+                    );
+
+                    *dst_pixel |= (static_cast<pixel_type>(std::clamp(
+                        px,
+                        static_cast<float_type>(0),
+                        static_cast<float_type>(channel_masks[c] >> channel_shifts[c])
+                    )) << channel_shifts[c]);
+                }
             }
         }
-    }
+    });
 }
 
 } // namespace filter
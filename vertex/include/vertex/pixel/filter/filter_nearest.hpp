@@ -3,6 +3,8 @@
 #include <cstring>
 #include <type_traits>
 
+#include "vertex/pixel/execution_policy.hpp"
+
 namespace vx {
 namespace pixel {
 namespace filter {
@@ -29,7 +31,7 @@ namespace filter {
 inline void filter_nearest(
     const uint8_t* src, size_t src_width, size_t src_height,
     uint8_t* dst, size_t dst_width, size_t dst_height,
-    size_t pixel_size
+    size_t pixel_size, const execution_policy& policy = execution_policy()
 )
 {
     if (!src || !dst)
@@ -50,18 +52,21 @@ inline void filter_nearest(
     const size_t src_row_size = src_width * pixel_size;
     const size_t dst_row_size = dst_width * pixel_size;
 
-    for (size_t y = 0; y < dst_height; ++y)
+    policy.for_each_band(dst_height, dst_row_size, [&](size_t first, size_t last)
     {
-        // Calculate the corresponding row in the source image
-        const uint8_t* srcrow = &src[src_row_size * (y * src_height / dst_height)];
-        uint8_t* dstpx = &dst[dst_row_size * y];
-
-        for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
+        for (size_t y = first; y < last; ++y)
         {
-            const uint8_t* srcpx = &srcrow[x * src_width / dst_width * pixel_size];
-            std::memcpy(dstpx, srcpx, pixel_size);
+            // Calculate the corresponding row in the source image
+            const uint8_t* srcrow = &src[src_row_size * (y * src_height / dst_height)];
+            uint8_t* dstpx = &dst[dst_row_size * y];
+
+            for (size_t x = 0; x < dst_width; ++x, dstpx += pixel_size)
+            {
+                const uint8_t* srcpx = &srcrow[x * src_width / dst_width * pixel_size];
+                std::memcpy(dstpx, srcpx, pixel_size);
+            }
         }
-    }
+    });
 }
 
 } // namespace filter
@@ -0,0 +1,578 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "vertex/pixel/raw_convert.hpp"
+#include "vertex/pixel/execution_policy.hpp"
+#include "vertex/math/core/constants.hpp"
+#include "vertex/math/core/functions/common.hpp"
+#include "vertex/math/core/functions/trigonometric.hpp"
+
+namespace vx {
+namespace pixel {
+namespace filter {
+
+// https://entropymine.com/imageworsener/resample/
+// https://www.cs.utexas.edu/~fussell/courses/cs384g-fall2013/lectures/mitchell/Mitchell.pdf
+
+///////////////////////////////////////////////////////////////////////////////
+// kernels
+///////////////////////////////////////////////////////////////////////////////
+
+inline float box_kernel(float x) noexcept
+{
+    return (x >= -0.5f && x < 0.5f) ? 1.0f : 0.0f;
+}
+
+inline float triangle_kernel(float x) noexcept
+{
+    x = math::abs(x);
+    return (x < 1.0f) ? 1.0f - x : 0.0f;
+}
+
+// Mitchell-Netravali cubics, b and c pick the member of the family
+inline float cubic_kernel(float x, float b, float c) noexcept
+{
+    x = math::abs(x);
+
+    if (x < 1.0f)
+    {
+        return ((12.0f - 9.0f * b - 6.0f * c) * x * x * x
+            + (-18.0f + 12.0f * b + 6.0f * c) * x * x
+            + (6.0f - 2.0f * b)) / 6.0f;
+    }
+    if (x < 2.0f)
+    {
+        return ((-b - 6.0f * c) * x * x * x
+            + (6.0f * b + 30.0f * c) * x * x
+            + (-12.0f * b - 48.0f * c) * x
+            + (8.0f * b + 24.0f * c)) / 6.0f;
+    }
+
+    return 0.0f;
+}
+
+inline float catmull_rom_kernel(float x) noexcept
+{
+    return cubic_kernel(x, 0.0f, 0.5f);
+}
+
+inline float mitchell_kernel(float x) noexcept
+{
+    return cubic_kernel(x, 1.0f / 3.0f, 1.0f / 3.0f);
+}
+
+inline float lanczos3_kernel(float x) noexcept
+{
+    x = math::abs(x);
+
+    if (x < 1e-6f)
+    {
+        return 1.0f;
+    }
+    if (x >= 3.0f)
+    {
+        return 0.0f;
+    }
+
+    const float px = math::constants<float>::pi * x;
+    return 3.0f * math::sin(px) * math::sin(px / 3.0f) / (px * px);
+}
+
+struct resample_kernel
+{
+    // the kernel is zero outside of [-support, support]
+    float support;
+    float (*function)(float);
+};
+
+inline resample_kernel get_resample_kernel(filter_mode filter) noexcept
+{
+    switch (filter)
+    {
+        case filter_mode::linear:   return resample_kernel{ 1.0f, triangle_kernel };
+        case filter_mode::cubic:    return resample_kernel{ 2.0f, catmull_rom_kernel };
+        case filter_mode::mitchell: return resample_kernel{ 2.0f, mitchell_kernel };
+        case filter_mode::lanczos3: return resample_kernel{ 3.0f, lanczos3_kernel };
+        default:                    return resample_kernel{ 0.5f, box_kernel };
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// contribution tables
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief The source pixels and weights of each destination pixel along one
+/// axis.
+///
+/// When downscaling the kernel is stretched to cover every source pixel, so
+/// the result is prefiltered. Taps past the edges are folded into the edge
+/// pixels. Weights are normalized and also stored as 14 bit fixed point
+/// values that sum to exactly 1 for the 8 bit kernels.
+///////////////////////////////////////////////////////////////////////////////
+class contribution_table
+{
+public:
+
+    enum : int32_t { precision_bits = 14 };
+
+    contribution_table(size_t src_size, size_t dst_size, const resample_kernel& kernel)
+    {
+        const float scale = static_cast<float>(src_size) / static_cast<float>(dst_size);
+        const float filter_scale = math::max(scale, 1.0f);
+        const float support = kernel.support * filter_scale;
+
+        m_stride = static_cast<size_t>(math::ceil(support)) * 2 + 2;
+        m_first.resize(dst_size);
+        m_count.resize(dst_size);
+        m_weights.assign(dst_size * m_stride, 0.0f);
+        m_fixed_weights.assign(dst_size * m_stride, 0);
+
+        const int32_t last = static_cast<int32_t>(src_size) - 1;
+
+        for (size_t i = 0; i < dst_size; ++i)
+        {
+            // pixel j covers [j, j + 1)
+            const float center = (static_cast<float>(i) + 0.5f) * scale;
+            const int32_t left = static_cast<int32_t>(math::floor(center - support));
+            const int32_t right = static_cast<int32_t>(math::ceil(center + support));
+
+            const int32_t lo = math::clamp(left, 0, last);
+            const int32_t hi = math::clamp(right, 0, last);
+
+            float* w = &m_weights[i * m_stride];
+            float sum = 0.0f;
+
+            for (int32_t j = left; j <= right; ++j)
+            {
+                const float weight = kernel.function((static_cast<float>(j) + 0.5f - center) / filter_scale);
+                w[math::clamp(j, 0, last) - lo] += weight;
+                sum += weight;
+            }
+
+            size_t first = 0;
+            size_t count = static_cast<size_t>(hi - lo) + 1;
+
+            if (sum == 0.0f)
+            {
+                // only possible with a degenerate kernel, fall back to nearest
+                const size_t nearest = static_cast<size_t>(math::clamp(static_cast<int32_t>(center), 0, last) - lo);
+                w[nearest] = 1.0f;
+                sum = 1.0f;
+            }
+
+            // drop taps with no meaningful weight from both ends
+            while (count > 1 && math::abs(w[first] / sum) < 1e-5f) { ++first; --count; }
+            while (count > 1 && math::abs(w[first + count - 1] / sum) < 1e-5f) { --count; }
+
+            sum = 0.0f;
+            for (size_t k = 0; k < count; ++k)
+            {
+                w[k] = w[first + k];
+                sum += w[k];
+            }
+            for (size_t k = count; k < m_stride; ++k)
+            {
+                w[k] = 0.0f;
+            }
+
+            m_first[i] = static_cast<size_t>(lo) + first;
+            m_count[i] = count;
+            m_max_count = math::max(m_max_count, count);
+
+            // normalize, then give the rounding error to the largest weight
+            int16_t* fw = &m_fixed_weights[i * m_stride];
+            int32_t fixed_sum = 0;
+            size_t largest = 0;
+
+            for (size_t k = 0; k < count; ++k)
+            {
+                w[k] /= sum;
+                fw[k] = static_cast<int16_t>(math::round(w[k] * (1 << precision_bits)));
+                fixed_sum += fw[k];
+                largest = (math::abs(w[k]) > math::abs(w[largest])) ? k : largest;
+            }
+
+            fw[largest] = static_cast<int16_t>(fw[largest] + ((1 << precision_bits) - fixed_sum));
+        }
+    }
+
+    size_t size() const noexcept { return m_first.size(); }
+    size_t max_count() const noexcept { return m_max_count; }
+
+    size_t first(size_t i) const noexcept { return m_first[i]; }
+    size_t count(size_t i) const noexcept { return m_count[i]; }
+
+    // weights of a destination pixel, padded with zeros to an even count
+    const float* weights(size_t i) const noexcept { return &m_weights[i * m_stride]; }
+    const int16_t* fixed_weights(size_t i) const noexcept { return &m_fixed_weights[i * m_stride]; }
+
+private:
+
+    size_t m_stride = 0;
+    size_t m_max_count = 0;
+    std::vector<size_t> m_first;
+    std::vector<size_t> m_count;
+    std::vector<float> m_weights;
+    std::vector<int16_t> m_fixed_weights;
+};
+
+namespace _priv {
+
+// Keeps the source rows of the vertical window filtered horizontally. The
+// windows of consecutive destination rows only move down, so a ring of
+// max_count rows is enough and each source row is filtered once.
+template <typename T>
+class row_cache
+{
+public:
+
+    row_cache(size_t row_size, size_t capacity)
+        : m_row_size(row_size)
+        , m_data(row_size * capacity)
+        , m_rows(capacity, static_cast<size_t>(-1)) {}
+
+    // returns the cached row and whether it still has to be filled
+    T* get(size_t row, bool& fill) noexcept
+    {
+        const size_t slot = row % m_rows.size();
+        fill = (m_rows[slot] != row);
+        m_rows[slot] = row;
+        return &m_data[slot * m_row_size];
+    }
+
+private:
+
+    size_t m_row_size;
+    std::vector<T> m_data;
+    std::vector<size_t> m_rows;
+};
+
+VX_FORCE_INLINE int32_t load_weight_pair(const int16_t* w) noexcept
+{
+    int32_t v;
+    std::memcpy(&v, w, sizeof(v));
+    return v;
+}
+
+// The horizontal pass keeps fraction_bits of precision and is not clamped,
+// so only the vertical pass rounds and clamps to 8 bits. Values stay below
+// 2^15 even with the negative lobes of lanczos3.
+enum : int32_t
+{
+    fraction_bits = 6,
+    x_shift = contribution_table::precision_bits - fraction_bits,
+    y_shift = contribution_table::precision_bits + fraction_bits
+};
+
+VX_FORCE_INLINE int16_t round_x(int32_t v) noexcept
+{
+    v = (v + (1 << (x_shift - 1))) >> x_shift;
+    return static_cast<int16_t>((v < -32768) ? -32768 : (v > 32767) ? 32767 : v);
+}
+
+VX_FORCE_INLINE byte_type round_y(int32_t v) noexcept
+{
+    v = (v + (1 << (y_shift - 1))) >> y_shift;
+    return static_cast<byte_type>((v < 0) ? 0 : (v > 255) ? 255 : v);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// 8 bit channels
+///////////////////////////////////////////////////////////////////////////////
+
+template <size_t PIXEL_SIZE>
+inline void resample_row_x(const byte_type* src, int16_t* dst, const contribution_table& table) noexcept
+{
+    for (size_t x = 0; x < table.size(); ++x)
+    {
+        const byte_type* s = src + table.first(x) * PIXEL_SIZE;
+        const int16_t* w = table.fixed_weights(x);
+        const size_t n = table.count(x);
+
+        int16_t* d = dst + x * PIXEL_SIZE;
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+        // Pixels are widened to 4 lanes of 16 bits and two pixels are
+        // interleaved so madd applies one weight to each. Narrower pixels
+        // need unaligned partial loads and stores that cost more than the
+        // scalar loop saves, so they stay scalar.
+        VX_IF_CONSTEXPR (PIXEL_SIZE == 4)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i acc = zero;
+            size_t k = 0;
+
+            for (; k + 2 <= n; k += 2)
+            {
+                __m128i p = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(s + k * 4));
+                p = _mm_unpacklo_epi8(p, zero);
+                p = _mm_unpacklo_epi16(p, _mm_srli_si128(p, 8));
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(p, _mm_set1_epi32(load_weight_pair(w + k))));
+            }
+
+            if (k < n)
+            {
+                uint32_t v;
+                std::memcpy(&v, s + k * 4, 4);
+
+                __m128i p = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(v)), zero);
+                p = _mm_unpacklo_epi16(p, zero);
+                acc = _mm_add_epi32(acc, _mm_madd_epi16(p, _mm_set1_epi32(static_cast<uint16_t>(w[k]))));
+            }
+
+            acc = _mm_srai_epi32(_mm_add_epi32(acc, _mm_set1_epi32(1 << (x_shift - 1))), x_shift);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(d), _mm_packs_epi32(acc, acc));
+
+            continue;
+        }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+        int32_t acc[PIXEL_SIZE] = {};
+
+        for (size_t k = 0; k < n; ++k)
+        {
+            for (size_t c = 0; c < PIXEL_SIZE; ++c)
+            {
+                acc[c] += s[k * PIXEL_SIZE + c] * w[k];
+            }
+        }
+
+        for (size_t c = 0; c < PIXEL_SIZE; ++c)
+        {
+            d[c] = round_x(acc[c]);
+        }
+    }
+}
+
+// Every channel of a row is filtered the same way vertically, so this works
+// for any pixel size.
+inline void resample_row_y(const int16_t* const* rows, const int16_t* w, size_t n, byte_type* dst, size_t row_size) noexcept
+{
+    size_t i = 0;
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(1 << (y_shift - 1));
+
+    for (; i + 16 <= row_size; i += 16)
+    {
+        __m128i acc[4] = { zero, zero, zero, zero };
+
+        // two rows at a time, the values of the rows interleaved for madd
+        for (size_t k = 0; k < n; k += 2)
+        {
+            const __m128i wk = _mm_set1_epi32(load_weight_pair(w + k));
+
+            for (int j = 0; j < 2; ++j)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + i + j * 8));
+                const __m128i b = (k + 1 < n) ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k + 1] + i + j * 8)) : zero;
+
+                acc[j * 2 + 0] = _mm_add_epi32(acc[j * 2 + 0], _mm_madd_epi16(_mm_unpacklo_epi16(a, b), wk));
+                acc[j * 2 + 1] = _mm_add_epi32(acc[j * 2 + 1], _mm_madd_epi16(_mm_unpackhi_epi16(a, b), wk));
+            }
+        }
+
+        for (int j = 0; j < 4; ++j)
+        {
+            acc[j] = _mm_srai_epi32(_mm_add_epi32(acc[j], round), y_shift);
+        }
+
+        const __m128i out = _mm_packus_epi16(_mm_packs_epi32(acc[0], acc[1]), _mm_packs_epi32(acc[2], acc[3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), out);
+    }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+    for (; i < row_size; ++i)
+    {
+        int32_t acc = 0;
+
+        for (size_t k = 0; k < n; ++k)
+        {
+            acc += rows[k][i] * w[k];
+        }
+
+        dst[i] = round_y(acc);
+    }
+}
+
+template <pixel_format F>
+inline void resample_bytes(
+    const byte_type* src, size_t src_width,
+    byte_type* dst, size_t dst_width,
+    const contribution_table& xtable, const contribution_table& ytable,
+    size_t row_begin, size_t row_end
+)
+{
+    constexpr size_t pixel_size = get_pixel_size(F);
+
+    const size_t src_row_size = src_width * pixel_size;
+    const size_t dst_row_size = dst_width * pixel_size;
+
+    row_cache<int16_t> cache(dst_row_size, ytable.max_count());
+    std::vector<const int16_t*> rows(ytable.max_count());
+
+    for (size_t y = row_begin; y < row_end; ++y)
+    {
+        const size_t first = ytable.first(y);
+        const size_t n = ytable.count(y);
+
+        for (size_t k = 0; k < n; ++k)
+        {
+            bool fill = false;
+            int16_t* row = cache.get(first + k, fill);
+
+            if (fill)
+            {
+                resample_row_x<pixel_size>(src + (first + k) * src_row_size, row, xtable);
+            }
+
+            rows[k] = row;
+        }
+
+        resample_row_y(rows.data(), ytable.fixed_weights(y), n, dst + y * dst_row_size, dst_row_size);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// other formats
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format F>
+inline void resample_colors(
+    const byte_type* src, size_t src_width,
+    byte_type* dst, size_t dst_width,
+    const contribution_table& xtable, const contribution_table& ytable,
+    size_t row_begin, size_t row_end
+)
+{
+    constexpr size_t pixel_size = get_pixel_size(F);
+
+    std::vector<math::color> decoded(src_width);
+    std::vector<math::color> out(dst_width);
+    row_cache<math::color> cache(dst_width, ytable.max_count());
+    std::vector<const math::color*> rows(ytable.max_count());
+
+    for (size_t y = row_begin; y < row_end; ++y)
+    {
+        const size_t first = ytable.first(y);
+        const size_t n = ytable.count(y);
+
+        for (size_t k = 0; k < n; ++k)
+        {
+            bool fill = false;
+            math::color* row = cache.get(first + k, fill);
+
+            if (fill)
+            {
+                raw::_priv::color_codec<F>::decode(src + (first + k) * src_width * pixel_size, decoded.data(), src_width);
+
+                for (size_t x = 0; x < dst_width; ++x)
+                {
+                    const math::color* s = &decoded[xtable.first(x)];
+                    const float* w = xtable.weights(x);
+
+                    math::color sum(0.0f, 0.0f, 0.0f, 0.0f);
+                    for (size_t i = 0; i < xtable.count(x); ++i)
+                    {
+                        sum += s[i] * w[i];
+                    }
+
+                    row[x] = sum;
+                }
+            }
+
+            rows[k] = row;
+        }
+
+        const float* w = ytable.weights(y);
+
+        for (size_t x = 0; x < dst_width; ++x)
+        {
+            math::color sum(0.0f, 0.0f, 0.0f, 0.0f);
+            for (size_t k = 0; k < n; ++k)
+            {
+                sum += rows[k][x] * w[k];
+            }
+
+            out[x] = sum;
+        }
+
+        raw::_priv::color_codec<F>::encode(out.data(), dst + y * dst_width * pixel_size, dst_width);
+    }
+}
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Resample an image with a separable filter.
+///
+/// Each destination row is built from source rows filtered horizontally,
+/// which are kept in a row cache, and then filtered vertically. Formats with
+/// 8 bit channels use fixed point weights, other formats are filtered as
+/// colors.
+///
+/// In parallel, each band of destination rows keeps its own row cache. The
+/// source rows shared by neighbouring bands are filtered by both, the same
+/// way, so the result does not depend on the policy.
+///
+/// @tparam F The format of both images.
+///
+/// @param src Pointer to the source image data.
+/// @param src_width Width of the source image.
+/// @param src_height Height of the source image.
+/// @param dst Pointer to the destination image data.
+/// @param dst_width Width of the destination image.
+/// @param dst_height Height of the destination image.
+/// @param filter The kernel to filter with, nearest filters like box.
+/// @param policy How to split the work between threads.
+///////////////////////////////////////////////////////////////////////////////
+template <pixel_format F>
+inline void filter_resample(
+    const uint8_t* src, size_t src_width, size_t src_height,
+    uint8_t* dst, size_t dst_width, size_t dst_height,
+    filter_mode filter, const execution_policy& policy = execution_policy()
+)
+{
+    if (!src || !dst)
+    {
+        return;
+    }
+
+    if (dst_width == 0 || dst_height == 0)
+    {
+        return;
+    }
+    if (src_width == 0 || src_height == 0)
+    {
+        std::memset(dst, 0, dst_width * dst_height * get_pixel_size(F));
+        return;
+    }
+
+    const resample_kernel kernel = get_resample_kernel(filter);
+    const contribution_table xtable(src_width, dst_width, kernel);
+    const contribution_table ytable(src_height, dst_height, kernel);
+
+    policy.for_each_band(dst_height, dst_width * get_pixel_size(F), [&](size_t first, size_t last)
+    {
+        VX_IF_CONSTEXPR (raw::_priv::is_byte_format(F))
+        {
+            _priv::resample_bytes<F>(src, src_width, dst, dst_width, xtable, ytable, first, last);
+        }
+        else
+        {
+            _priv::resample_colors<F>(src, src_width, dst, dst_width, xtable, ytable, first, last);
+        }
+    });
+}
+
+} // namespace filter
+} // namespace pixel
+} // namespace vx
@@ -3,76 +3,186 @@
 #include <vector>
 
 #include "vertex/pixel/surface.hpp"
-#include "vertex/pixel/filter/filter_box.hpp"
-#include "vertex/math/core/functions/common.hpp"
-#include "vertex/math/core/functions/exponential.hpp"
+#include "vertex/pixel/raw_mipmap.hpp"
 
 namespace vx {
 namespace pixel {
 
+///////////////////////////////////////////////////////////////////////////////
+// mipmap level
+///////////////////////////////////////////////////////////////////////////////
+
+// A view of one level of a mipmap_chain, valid while the chain is alive.
 template <pixel_format F>
-inline std::vector<surface<F>> generate_mipmaps(const surface<F>& surf, size_t depth = -1)
+class mipmap_level
 {
-    using surf_type = surface<F>;
+public:
 
-    if (surf.empty())
+    static constexpr pixel_format format = F;
+    static VX_FORCE_INLINE constexpr size_t pixel_size() noexcept { return get_pixel_size(format); }
+
+    using raw_pixel_type = raw_pixel<format>;
+    using color_type = math::color;
+
+    mipmap_level() = default;
+
+    mipmap_level(const raw_pixel_type* data, size_t width, size_t height) noexcept
+        : m_width(width), m_height(height), m_data(data) {}
+
+    size_t width() const noexcept { return m_width; }
+    size_t height() const noexcept { return m_height; }
+    size_t stride() const noexcept { return m_width * pixel_size(); }
+
+    size_t pixel_count() const noexcept { return m_width * m_height; }
+    math::vec2i size() const noexcept { return math::vec2i(m_width, m_height); }
+
+    const byte_type* data() const noexcept { return reinterpret_cast<const byte_type*>(m_data); }
+    size_t data_size() const noexcept { return m_width * m_height * pixel_size(); }
+
+    const raw_pixel_type& at(size_t x, size_t y) const noexcept
+    {
+        return m_data[y * m_width + x];
+    }
+
+    color_type get_pixel(size_t x, size_t y, const color_type& default_color = color_type()) const noexcept
     {
-        return std::vector<surf_type>();
+        if (x >= m_width || y >= m_height)
+        {
+            return default_color;
+        }
+
+        return static_cast<color_type>(at(x, y));
+    }
+
+    surface<F> to_surface() const
+    {
+        return surface<F>(data(), m_width, m_height);
     }
 
-    size_t w = surf.width();
-    size_t h = surf.height();
+private:
+
+    size_t m_width = 0;
+    size_t m_height = 0;
+    const raw_pixel_type* m_data = nullptr;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// mipmap chain
+///////////////////////////////////////////////////////////////////////////////
+
+// A full resolution image followed by each of its mipmaps in one contiguous
+// allocation. Level 0 is the image itself and each level after it is half
+// the size of the one before, so the whole chain can be uploaded at once.
+template <pixel_format F>
+class mipmap_chain
+{
+public:
+
+    static constexpr pixel_format format = F;
+    static VX_FORCE_INLINE constexpr size_t pixel_size() noexcept { return get_pixel_size(format); }
 
-    size_t count = static_cast<size_t>(math::floor(math::log2(static_cast<float>(math::max(w, h)))));
-    count = math::min(depth, count);
+    using raw_pixel_type = raw_pixel<format>;
+    using level_type = mipmap_level<format>;
 
-    std::vector<surf_type> mipmaps(count);
-    constexpr pixel_format format = surf.format;
+    mipmap_chain() = default;
 
-    VX_IF_CONSTEXPR(is_packed_format(format))
+    mipmap_chain(size_t width, size_t height, size_t levels)
     {
-        constexpr const auto masks = build_mask_array(F);
-        constexpr const auto shifts = build_shift_array(F);
+        size_t offset = 0;
 
-        for (size_t i = 0; i < count; ++i)
+        for (size_t i = 0; i < levels; ++i)
         {
-            w /= 2;
-            h /= 2;
+            m_levels.push_back(level_desc{ offset, width, height });
+            offset += width * height;
 
-            surf_type map(w, h);
+            if (width == 1 && height == 1)
+            {
+                break;
+            }
 
-            using pixel_type = typename surf_type::pixel_type;
-            filter::filter_box<pixel_type>(
-                surf.data(), surf.width(), surf.height(),
-                map.data(), map.width(), map.height(),
-                surf.channels(), masks, shifts
-            );
-
-            mipmaps[i] = map;
+            width = raw::reduced_size(width);
+            height = raw::reduced_size(height);
         }
+
+        m_pixel_count = offset;
+        m_data = std::make_unique<raw_pixel_type[]>(m_pixel_count);
     }
-    else
+
+    mipmap_chain(mipmap_chain&&) noexcept = default;
+    mipmap_chain& operator=(mipmap_chain&&) noexcept = default;
+
+    size_t levels() const noexcept { return m_levels.size(); }
+    bool empty() const noexcept { return m_levels.empty(); }
+
+    level_type level(size_t i) const noexcept
     {
-        for (size_t i = 0; i < count; ++i)
-        {
-            w /= 2;
-            h /= 2;
+        const level_desc& l = m_levels[i];
+        return level_type(m_data.get() + l.offset, l.width, l.height);
+    }
+
+    level_type operator[](size_t i) const noexcept
+    {
+        return level(i);
+    }
 
-            surf_type map(w, h);
+    // byte offset of a level from the start of the chain
+    size_t level_offset(size_t i) const noexcept { return m_levels[i].offset * pixel_size(); }
 
-            using channel_type = typename surf_type::channel_type;
-            filter::filter_box<channel_type>(
-                surf.data(), surf.width(), surf.height(),
-                map.data(), map.width(), map.height(),
-                surf.channels()
-            );
+    byte_type* level_data(size_t i) noexcept { return reinterpret_cast<byte_type*>(m_data.get() + m_levels[i].offset); }
+    const byte_type* level_data(size_t i) const noexcept { return reinterpret_cast<const byte_type*>(m_data.get() + m_levels[i].offset); }
 
-            mipmaps[i] = map;
-        }
+    const byte_type* data() const noexcept { return reinterpret_cast<const byte_type*>(m_data.get()); }
+    size_t data_size() const noexcept { return m_pixel_count * pixel_size(); }
+
+private:
+
+    struct level_desc
+    {
+        size_t offset;
+        size_t width;
+        size_t height;
+    };
+
+    std::vector<level_desc> m_levels;
+    size_t m_pixel_count = 0;
+    std::unique_ptr<raw_pixel_type[]> m_data;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Builds the mipmap chain of a surface.
+///
+/// Each level is reduced from the one before it with a 2x2 box filter, so
+/// the work is about a third of the source image on top of copying it.
+///
+/// @param surf The full resolution image, copied to level 0.
+/// @param depth The maximum number of levels below level 0, by default the
+/// chain goes down to 1x1.
+/// @param srgb True if the surface holds sRGB color, the color channels are
+/// then filtered in linear space.
+///
+/// @return The chain, empty if the surface is.
+///////////////////////////////////////////////////////////////////////////////
+template <pixel_format F>
+inline mipmap_chain<F> generate_mipmaps(const surface<F>& surf, size_t depth = -1, bool srgb = false)
+{
+    if (surf.empty())
+    {
+        return mipmap_chain<F>();
+    }
+
+    const size_t levels = (depth < static_cast<size_t>(-1)) ? depth + 1 : depth;
+    mipmap_chain<F> chain(surf.width(), surf.height(), levels);
+
+    std::memcpy(chain.level_data(0), surf.data(), surf.data_size());
+
+    for (size_t i = 1; i < chain.levels(); ++i)
+    {
+        const mipmap_level<F> prev = chain.level(i - 1);
+        raw::reduce_2x2<F>(prev.data(), prev.width(), prev.height(), chain.level_data(i), srgb);
     }
 
-    return mipmaps;
+    return chain;
 }
 
 } // namespace pixel
-} // namespace vx
\ No newline at end of file
+} // namespace vx
@@ -91,7 +91,7 @@ public:
     size_t height() const noexcept { return m_height; }
     size_t stride() const noexcept { return m_width * block_size(); }
 
-    size_t block_count() const noexcept { return m_width * m_height / get_sub_index_count(format); }
+    size_t block_count() const noexcept { return (m_width * m_height + get_sub_index_count(format) - 1) / get_sub_index_count(format); }
     math::vec2i size() const noexcept { return math::vec2i(m_width, m_height); }
     math::recti get_rect() const noexcept { return math::recti(0, 0, m_width, m_height); }
 
@@ -230,10 +230,10 @@ public:
     // conversion
     ///////////////////////////////////////////////////////////////////////////////
 
-    template <pixel_format F>
-    surface<F> to_surface() const
+    template <pixel_format F2>
+    surface<F2> to_surface() const
     {
-        surface<F> surf(m_width, m_height);
+        surface<F2> surf(m_width, m_height);
 
         for (size_t y = 0; y < m_height; ++y)
         {
@@ -492,17 +492,17 @@ inline constexpr channel_info get_channel_info(pixel_format format) noexcept
         }
         case pixel_format::xrgb_4444:
         {
-            info.r = { 1, 4, 0x000f,  4 };
-            info.g = { 2, 4, 0x00f0,  8 };
-            info.b = { 3, 4, 0x0f00, 12 };
+            info.r = { 1, 4, 0x00f0,  4 };
+            info.g = { 2, 4, 0x0f00,  8 };
+            info.b = { 3, 4, 0xf000, 12 };
             info.a = { 0, 0, 0x0000,  0 };
             break;
         }
         case pixel_format::xbgr_4444:
         {
-            info.r = { 3, 4, 0xf800, 12 };
-            info.g = { 2, 4, 0x07c0,  8 };
-            info.b = { 1, 4, 0x003e,  4 };
+            info.r = { 3, 4, 0xf000, 12 };
+            info.g = { 2, 4, 0x0f00,  8 };
+            info.b = { 1, 4, 0x00f0,  4 };
             info.a = { 0, 0, 0x0000,  0 };
             break;
         }
@@ -580,10 +580,10 @@ inline constexpr channel_info get_channel_info(pixel_format format) noexcept
         }
         case pixel_format::argb_8888:
         {
-            info.r = { 1, 8, 0x00ff0000,  8 };
-            info.g = { 2, 8, 0x0000ff00, 16 };
-            info.b = { 3, 8, 0x000000ff, 24 };
-            info.a = { 0, 8, 0xff000000,  0 };
+            info.r = { 1, 8, 0x0000ff00,  8 };
+            info.g = { 2, 8, 0x00ff0000, 16 };
+            info.b = { 3, 8, 0xff000000, 24 };
+            info.a = { 0, 8, 0x000000ff,  0 };
             break;
         }
         case pixel_format::abgr_8888:
@@ -612,9 +612,9 @@ inline constexpr channel_info get_channel_info(pixel_format format) noexcept
         }
         case pixel_format::xrgb_8888:
         {
-            info.r = { 1, 8, 0x00ff0000,  8 };
-            info.g = { 2, 8, 0x0000ff00, 16 };
-            info.b = { 3, 8, 0x000000ff, 24 };
+            info.r = { 1, 8, 0x0000ff00,  8 };
+            info.g = { 2, 8, 0x00ff0000, 16 };
+            info.b = { 3, 8, 0xff000000, 24 };
             info.a = { 0, 0, 0x00000000,  0 };
             break;
         }
@@ -687,9 +687,9 @@ inline constexpr channel_info get_channel_info(pixel_format format) noexcept
         case pixel_format::bgr_8:
         {
             info.r = { 2, 8, 0, 0 };
-            info.g = { 0, 8, 0, 0 };
+            info.g = { 1, 8, 0, 0 };
             info.b = { 0, 8, 0, 0 };
-            info.a = { 3, 8, 0, 0 };
+            info.a = { 3, 0, 0, 0 };
             break;
         }
         case pixel_format::rgba_8:
@@ -814,7 +814,11 @@ inline constexpr std::array<uint32_t, 4> build_shift_array(pixel_format format)
 enum class filter_mode
 {
     nearest,
-    linear
+    linear,
+    box,        // area average when downscaling
+    cubic,      // Catmull-Rom
+    mitchell,   // Mitchell-Netravali, b = c = 1/3
+    lanczos3
 };
 
 enum class wrap_mode
@@ -920,7 +924,7 @@ VX_FORCE_INLINE constexpr size_t get_bits_per_sub_index(palette_format format) n
 
 VX_FORCE_INLINE constexpr size_t get_max_palette_size(palette_format format) noexcept
 {
-    return get_sub_index_count(format) * (1ull << get_bits_per_sub_index(format));
+    return static_cast<size_t>(1) << get_bits_per_sub_index(format);
 }
 
 } // namespace pixel
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "vertex/pixel/surface.hpp"
+#include "vertex/pixel/palette_surface.hpp"
+#include "vertex/pixel/execution_policy.hpp"
+#include "vertex/pixel/raw_quantize.hpp"
+
+namespace vx {
+namespace pixel {
+namespace quantize {
+
+///////////////////////////////////////////////////////////////////////////////
+// palette lookup
+///////////////////////////////////////////////////////////////////////////////
+
+// Finds the closest palette entry to a color with a k-d tree instead of the
+// linear search of palette::find_closest. Colors are compared at 8 bits per
+// channel.
+class palette_lookup
+{
+public:
+
+    palette_lookup() = default;
+
+    // Only the first max_size entries of the palette are used.
+    explicit palette_lookup(const palette& pal, size_t max_size = SIZE_MAX)
+    {
+        const size_t count = std::min(pal.size(), max_size);
+        std::vector<uint8_t> colors(count * 4);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const raw_pixel<pixel_format::rgba_8> px(pal[i]);
+            std::memcpy(&colors[i * 4], px.data, 4);
+        }
+
+        m_tree = raw::palette_tree(colors.data(), count);
+    }
+
+    size_t size() const noexcept { return m_tree.size(); }
+    bool empty() const noexcept { return m_tree.empty(); }
+
+    bool find_closest(const math::color& c, size_t* index) const noexcept
+    {
+        if (m_tree.empty())
+        {
+            return false;
+        }
+
+        const raw_pixel<pixel_format::rgba_8> px(c);
+        const int32_t q[4] = { px.data[0], px.data[1], px.data[2], px.data[3] };
+        const size_t i = m_tree.find_closest(q);
+
+        if (index)
+        {
+            *index = i;
+        }
+
+        return true;
+    }
+
+    const raw::palette_tree& tree() const noexcept { return m_tree; }
+
+private:
+
+    raw::palette_tree m_tree;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// palette generation
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Chooses a palette of up to max_colors entries for a surface.
+///
+/// A surface with no more than max_colors distinct colors gets exactly
+/// those, like surface::generate_palette. Otherwise the colors are reduced
+/// by median cut, see raw::median_cut.
+///
+/// @param surf The surface.
+/// @param max_colors The largest number of entries.
+///
+/// @return The palette.
+///////////////////////////////////////////////////////////////////////////////
+template <pixel_format F>
+inline palette generate_palette(const surface<F>& surf, size_t max_colors)
+{
+    std::vector<uint8_t> colors;
+    const size_t count = raw::median_cut(
+        surf.data(), surf.width(), surf.height(), surf.pixel_size(),
+        &raw::convert_row<F, pixel_format::rgba_8>,
+        max_colors, colors
+    );
+
+    palette pal(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        raw_pixel<pixel_format::rgba_8> px;
+        std::memcpy(px.data, &colors[i * 4], 4);
+        pal[i] = static_cast<math::color>(px);
+    }
+
+    return pal;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// remap
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Converts a surface to a palette surface.
+///
+/// Every pixel gets the index of its closest palette entry, after dithering.
+/// The result is the same for every execution policy.
+///
+/// @tparam PF The format of the palette surface.
+/// @param surf The surface.
+/// @param pal The palette, only the entries that fit in PF are used.
+/// @param dither The dithering to apply.
+/// @param policy How to run the rows.
+///
+/// @return The palette surface, with every index 0 if the palette is empty.
+///////////////////////////////////////////////////////////////////////////////
+template <palette_format PF, pixel_format F>
+inline palette_surface<PF> remap(
+    const surface<F>& surf,
+    const palette& pal,
+    dither_mode dither = dither_mode::none,
+    const execution_policy& policy = execution_policy()
+)
+{
+    using out_type = palette_surface<PF>;
+    constexpr size_t sub_count = get_sub_index_count(PF);
+
+    const size_t used = std::min(pal.size(), out_type::palette_size());
+    palette out_palette(pal);
+    if (out_palette.size() > used)
+    {
+        out_palette.resize(used);
+    }
+
+    out_type out(surf.width(), surf.height(), out_palette);
+    if (surf.empty() || used == 0)
+    {
+        return out;
+    }
+
+    const palette_lookup lookup(out_palette);
+    const raw::rgba_row_reader read = &raw::convert_row<F, pixel_format::rgba_8>;
+
+    VX_IF_CONSTEXPR (sub_count == 1)
+    {
+        // one byte per pixel, the indices go straight into the surface
+        raw::remap(surf.data(), surf.width(), surf.height(), surf.pixel_size(), read, lookup.tree(), dither, out.data(), policy);
+    }
+    else
+    {
+        // Rows can share blocks, so the indices are packed once every row is
+        // done.
+        std::vector<uint8_t> indices(surf.pixel_count());
+        raw::remap(surf.data(), surf.width(), surf.height(), surf.pixel_size(), read, lookup.tree(), dither, indices.data(), policy);
+
+        using block_type = typename out_type::block_type;
+        block_type* blocks = reinterpret_cast<block_type*>(out.data());
+
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            blocks[i / sub_count].set_index(i % sub_count, indices[i]);
+        }
+    }
+
+    return out;
+}
+
+} // namespace quantize
+} // namespace pixel
+} // namespace vx
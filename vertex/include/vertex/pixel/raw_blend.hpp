@@ -0,0 +1,229 @@
+#pragma once
+
+#include "vertex/pixel/blend.hpp"
+#include "vertex/pixel/raw_convert.hpp"
+
+namespace vx {
+namespace pixel {
+namespace raw {
+
+///////////////////////////////////////////////////////////////////////////////
+// row blending
+//
+// Blends a row of 8888 pixels onto another row of the same format with one
+// of the built in blend modes. Channels are widened to 16 bits and products
+// are divided by 255 with rounding, so results are within 1 of the float
+// path.
+///////////////////////////////////////////////////////////////////////////////
+
+VX_FORCE_INLINE constexpr bool can_blend_row(pixel_format f) noexcept
+{
+    return _priv::is_8888(f) && pixel_has_alpha(f);
+}
+
+namespace _priv {
+
+// round(a * b / 255) for a, b <= 255
+VX_FORCE_INLINE constexpr uint32_t mul_255(uint32_t a, uint32_t b) noexcept
+{
+    return ((a * b + 128) + ((a * b + 128) >> 8)) >> 8;
+}
+
+template <blend::mode_type M, bool PREMULTIPLIED>
+VX_FORCE_INLINE uint32_t blend_channel(uint32_t s, uint32_t d, uint32_t sa, bool alpha) noexcept
+{
+    if (!PREMULTIPLIED && !alpha)
+    {
+        s = mul_255(s, sa);
+    }
+
+    uint32_t out = 0;
+
+    switch (M)
+    {
+        case blend::mode_type::src_over:    out = s + mul_255(d, 255 - sa); break;
+        case blend::mode_type::additive:    out = s + d; break;
+        case blend::mode_type::multiply:    out = mul_255(s, alpha ? 255 : d) + mul_255(d, 255 - sa); break;
+        case blend::mode_type::screen:      out = s + mul_255(d, 255 - s); break;
+        default:                            break;
+    }
+
+    return (out > 255) ? 255 : out;
+}
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+// 16 bit lane operations, so the kernel below is written once for SSE2 and
+// AVX2. Each pixel takes 4 lanes and the alpha lane is A.
+
+struct blend_vec128
+{
+    using type = __m128i;
+
+    static VX_FORCE_INLINE type zero() noexcept { return _mm_setzero_si128(); }
+    static VX_FORCE_INLINE type set1(short v) noexcept { return _mm_set1_epi16(v); }
+    static VX_FORCE_INLINE type add(type a, type b) noexcept { return _mm_add_epi16(a, b); }
+    static VX_FORCE_INLINE type sub(type a, type b) noexcept { return _mm_sub_epi16(a, b); }
+    static VX_FORCE_INLINE type or_(type a, type b) noexcept { return _mm_or_si128(a, b); }
+
+    static VX_FORCE_INLINE type mul_255(type a, type b) noexcept
+    {
+        const type t = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+    }
+
+    template <int A>
+    static VX_FORCE_INLINE type broadcast(type v) noexcept
+    {
+        return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, A * 0x55), A * 0x55);
+    }
+
+    template <int A>
+    static VX_FORCE_INLINE type alpha_lanes() noexcept
+    {
+        return _mm_setr_epi16(
+            (A == 0) ? 255 : 0, (A == 1) ? 255 : 0, (A == 2) ? 255 : 0, (A == 3) ? 255 : 0,
+            (A == 0) ? 255 : 0, (A == 1) ? 255 : 0, (A == 2) ? 255 : 0, (A == 3) ? 255 : 0
+        );
+    }
+};
+
+#if defined(VX_PIXEL_SIMD_AVX2)
+
+struct blend_vec256
+{
+    using type = __m256i;
+
+    static VX_FORCE_INLINE type zero() noexcept { return _mm256_setzero_si256(); }
+    static VX_FORCE_INLINE type set1(short v) noexcept { return _mm256_set1_epi16(v); }
+    static VX_FORCE_INLINE type add(type a, type b) noexcept { return _mm256_add_epi16(a, b); }
+    static VX_FORCE_INLINE type sub(type a, type b) noexcept { return _mm256_sub_epi16(a, b); }
+    static VX_FORCE_INLINE type or_(type a, type b) noexcept { return _mm256_or_si256(a, b); }
+
+    static VX_FORCE_INLINE type mul_255(type a, type b) noexcept
+    {
+        const type t = _mm256_add_epi16(_mm256_mullo_epi16(a, b), _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+    }
+
+    template <int A>
+    static VX_FORCE_INLINE type broadcast(type v) noexcept
+    {
+        return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, A * 0x55), A * 0x55);
+    }
+
+    template <int A>
+    static VX_FORCE_INLINE type alpha_lanes() noexcept
+    {
+        return _mm256_broadcastsi128_si256(blend_vec128::alpha_lanes<A>());
+    }
+};
+
+#endif // VX_PIXEL_SIMD_AVX2
+
+// Blends pixels widened to 16 bit lanes. Lanes can exceed 255 and are
+// saturated when packed back to bytes.
+template <typename V, blend::mode_type M, bool PREMULTIPLIED, int A>
+VX_FORCE_INLINE typename V::type blend_lanes(typename V::type s, typename V::type d) noexcept
+{
+    using type = typename V::type;
+
+    const type k255 = V::set1(255);
+    const type alpha = V::template alpha_lanes<A>();
+    const type sa = V::template broadcast<A>(s);
+
+    if (!PREMULTIPLIED)
+    {
+        // alpha lanes are multiplied by 255, which leaves them as they are
+        s = V::mul_255(s, V::or_(sa, alpha));
+    }
+
+    const type inv_sa = V::sub(k255, sa);
+
+    switch (M)
+    {
+        case blend::mode_type::src_over:    return V::add(s, V::mul_255(d, inv_sa));
+        case blend::mode_type::additive:    return V::add(s, d);
+        case blend::mode_type::multiply:    return V::add(V::mul_255(s, V::or_(d, alpha)), V::mul_255(d, inv_sa));
+        case blend::mode_type::screen:      return V::add(s, V::mul_255(d, V::sub(k255, s)));
+        default:                            return d;
+    }
+}
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Blends a row of pixels onto another row of the same format.
+///
+/// @tparam MODE One of the modes in pixel::blend.
+/// @tparam F An 8888 format with alpha.
+/// @param src The first source pixel.
+/// @param dst The first destination pixel, blended in place.
+/// @param count The number of pixels to blend.
+///////////////////////////////////////////////////////////////////////////////
+template <typename MODE, pixel_format F>
+inline void blend_row(const byte_type* src, byte_type* dst, size_t count) noexcept
+{
+    VX_STATIC_ASSERT_MSG(blend::is_mode<MODE>::value, "blend_row requires a built in blend mode");
+    VX_STATIC_ASSERT_MSG(can_blend_row(F), "blend_row requires an 8888 format with alpha");
+
+    constexpr blend::mode_type M = MODE::type;
+    constexpr bool P = MODE::premultiplied_alpha;
+    constexpr int A = static_cast<int>(get_channel_info(F).a.shift / 8);
+
+    size_t i = 0;
+
+#if defined(VX_PIXEL_SIMD_AVX2)
+
+    for (; i + 8 <= count; i += 8)
+    {
+        using V = _priv::blend_vec256;
+
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i * 4));
+
+        // unpacking and packing stay within 128 bit lanes, so the pixel
+        // order is kept
+        const __m256i lo = _priv::blend_lanes<V, M, P, A>(_mm256_unpacklo_epi8(s, V::zero()), _mm256_unpacklo_epi8(d, V::zero()));
+        const __m256i hi = _priv::blend_lanes<V, M, P, A>(_mm256_unpackhi_epi8(s, V::zero()), _mm256_unpackhi_epi8(d, V::zero()));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_packus_epi16(lo, hi));
+    }
+
+#endif // VX_PIXEL_SIMD_AVX2
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+    for (; i + 4 <= count; i += 4)
+    {
+        using V = _priv::blend_vec128;
+
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i * 4));
+
+        const __m128i lo = _priv::blend_lanes<V, M, P, A>(_mm_unpacklo_epi8(s, V::zero()), _mm_unpacklo_epi8(d, V::zero()));
+        const __m128i hi = _priv::blend_lanes<V, M, P, A>(_mm_unpackhi_epi8(s, V::zero()), _mm_unpackhi_epi8(d, V::zero()));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_packus_epi16(lo, hi));
+    }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+    for (; i < count; ++i)
+    {
+        const byte_type* s = src + i * 4;
+        byte_type* d = dst + i * 4;
+        const uint32_t sa = s[A];
+
+        for (int c = 0; c < 4; ++c)
+        {
+            d[c] = static_cast<byte_type>(_priv::blend_channel<M, P>(s[c], d[c], sa, c == A));
+        }
+    }
+}
+
+} // namespace raw
+} // namespace pixel
+} // namespace vx
@@ -0,0 +1,1002 @@
+#pragma once
+
+#include <cstring>
+
+#include "vertex/pixel/raw_pixel.hpp"
+#include "vertex/pixel/simd.hpp"
+
+namespace vx {
+namespace pixel {
+namespace raw {
+
+///////////////////////////////////////////////////////////////////////////////
+// row conversion
+//
+// Converts a row of pixels from one format to another. Each format pair gets
+// a kernel chosen at compile time from the channel layouts of the two
+// formats: byte shuffles, 565 packing, integer rescaling, or batches of
+// colors for float and half formats. All of them give the same result as
+// decoding each pixel to a color and encoding it again.
+///////////////////////////////////////////////////////////////////////////////
+
+namespace _priv {
+
+enum class row_kernel
+{
+    batch,
+    copy,
+    shuffle_8,
+    unpack_565,
+    pack_565,
+    rescale
+};
+
+VX_FORCE_INLINE constexpr bool is_8888(pixel_format f) noexcept
+{
+    return get_pixel_type(f) == pixel_type::packed_32
+        && get_channel_info(f).r.bits == 8;
+}
+
+VX_FORCE_INLINE constexpr bool is_565(pixel_format f) noexcept
+{
+    return f == pixel_format::rgb_565 || f == pixel_format::bgr_565;
+}
+
+// formats where every channel is a whole byte
+VX_FORCE_INLINE constexpr bool is_byte_format(pixel_format f) noexcept
+{
+    return is_8888(f) || get_pixel_type(f) == pixel_type::uint_array;
+}
+
+VX_FORCE_INLINE constexpr bool is_byte_4(pixel_format f) noexcept
+{
+    return is_byte_format(f) && get_pixel_size(f) == 4;
+}
+
+// formats with unsigned normalized integer channels
+VX_FORCE_INLINE constexpr bool is_integer_format(pixel_format f) noexcept
+{
+    return get_pixel_type(f) == pixel_type::packed_8
+        || get_pixel_type(f) == pixel_type::packed_16
+        || get_pixel_type(f) == pixel_type::packed_32
+        || get_pixel_type(f) == pixel_type::uint_array;
+}
+
+template <pixel_format SRC, pixel_format DST>
+VX_FORCE_INLINE constexpr row_kernel select_row_kernel() noexcept
+{
+    return (SRC == DST)                                         ? row_kernel::copy
+        : (is_byte_format(SRC) && is_byte_format(DST))          ? row_kernel::shuffle_8
+        : (is_565(SRC) && is_byte_4(DST))                       ? row_kernel::unpack_565
+        : (is_byte_4(SRC) && is_565(DST))                       ? row_kernel::pack_565
+        : (is_integer_format(SRC) && is_integer_format(DST))    ? row_kernel::rescale
+        : row_kernel::batch;
+}
+
+// byte of a channel within a pixel of a byte format, -1 if the format does
+// not store the channel
+VX_FORCE_INLINE constexpr int channel_byte(pixel_format f, const channel_info::channel_data& c) noexcept
+{
+    return (c.bits == 0) ? -1
+        : (get_pixel_type(f) == pixel_type::uint_array) ? static_cast<int>(c.index)
+        : static_cast<int>(c.shift / 8);
+}
+
+// which channel (0 r, 1 g, 2 b, 3 a) is stored at a byte of a pixel, -1 for
+// a padding byte or a byte past the end of the pixel
+VX_FORCE_INLINE constexpr int channel_at_byte(pixel_format f, int byte) noexcept
+{
+    return (channel_byte(f, get_channel_info(f).r) == byte) ? 0
+        : (channel_byte(f, get_channel_info(f).g) == byte) ? 1
+        : (channel_byte(f, get_channel_info(f).b) == byte) ? 2
+        : (channel_byte(f, get_channel_info(f).a) == byte) ? 3
+        : -1;
+}
+
+VX_FORCE_INLINE constexpr int source_byte(pixel_format f, int channel) noexcept
+{
+    return (channel == 0) ? channel_byte(f, get_channel_info(f).r)
+        : (channel == 1) ? channel_byte(f, get_channel_info(f).g)
+        : (channel == 2) ? channel_byte(f, get_channel_info(f).b)
+        : (channel == 3) ? channel_byte(f, get_channel_info(f).a)
+        : -1;
+}
+
+// Decoding a format without alpha gives an opaque color, so a destination
+// with alpha gets 0xff in its alpha byte. This is the destination pixel with
+// only those bits set.
+template <pixel_format SRC, pixel_format DST>
+VX_FORCE_INLINE constexpr uint32_t opaque_alpha_bits() noexcept
+{
+    return (get_channel_info(SRC).a.bits == 0 && channel_byte(DST, get_channel_info(DST).a) >= 0)
+        ? (0xffu << (channel_byte(DST, get_channel_info(DST).a) * 8))
+        : 0;
+}
+
+// source byte copied to a byte of a destination pixel, -1 if the
+// destination byte is padding or filled with opaque alpha
+template <pixel_format SRC, pixel_format DST>
+VX_FORCE_INLINE constexpr int byte_source(int byte) noexcept
+{
+    return (channel_at_byte(DST, byte) < 0 || (channel_at_byte(DST, byte) == 3 && opaque_alpha_bits<SRC, DST>() != 0))
+        ? -1
+        : source_byte(SRC, channel_at_byte(DST, byte));
+}
+
+// Byte shuffles work on blocks of 4 pixels, so destination byte i belongs to
+// pixel i / DST_SIZE. Bytes past the 4th pixel are left zero, they are
+// written again by the next block.
+template <pixel_format SRC, pixel_format DST>
+VX_FORCE_INLINE constexpr char shuffle_index(int i) noexcept
+{
+    return (i / static_cast<int>(get_pixel_size(DST)) >= 4 || byte_source<SRC, DST>(i % static_cast<int>(get_pixel_size(DST))) < 0)
+        ? static_cast<char>(0x80)
+        : static_cast<char>((i / static_cast<int>(get_pixel_size(DST))) * static_cast<int>(get_pixel_size(SRC))
+            + byte_source<SRC, DST>(i % static_cast<int>(get_pixel_size(DST))));
+}
+
+template <pixel_format SRC, pixel_format DST>
+VX_FORCE_INLINE constexpr char shuffle_fill(int i) noexcept
+{
+    return (i / static_cast<int>(get_pixel_size(DST)) < 4
+        && ((opaque_alpha_bits<SRC, DST>() >> ((i % static_cast<int>(get_pixel_size(DST))) * 8)) & 0xff) != 0)
+        ? static_cast<char>(0xff)
+        : 0;
+}
+
+// moves byte FROM of a value to byte TO, the byte positions are template
+// arguments so the scalar paths compile to fixed shifts
+template <int FROM, int TO>
+VX_FORCE_INLINE constexpr uint32_t move_byte(uint32_t v) noexcept
+{
+    return (FROM < 0) ? 0 : ((v >> ((FROM & 3) * 8)) & 0xff) << (TO * 8);
+}
+
+VX_FORCE_INLINE uint32_t load_u32(const byte_type* p) noexcept
+{
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+VX_FORCE_INLINE void store_u32(byte_type* p, uint32_t v) noexcept
+{
+    std::memcpy(p, &v, sizeof(v));
+}
+
+VX_FORCE_INLINE uint16_t load_u16(const byte_type* p) noexcept
+{
+    uint16_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+VX_FORCE_INLINE void store_u16(byte_type* p, uint16_t v) noexcept
+{
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// exact floor(x / 255) for x < 2^16 without a division
+VX_FORCE_INLINE constexpr uint32_t div_255(uint32_t x) noexcept
+{
+    return (x * 0x8081u) >> 23;
+}
+
+// n bit channel to 8 bits, rounded like the float path
+VX_FORCE_INLINE constexpr uint32_t expand_5(uint32_t v) noexcept { return (v * 527 + 23) >> 6; }
+VX_FORCE_INLINE constexpr uint32_t expand_6(uint32_t v) noexcept { return (v * 259 + 33) >> 6; }
+
+// 8 bit channel to n bits, rounded like the float path
+VX_FORCE_INLINE constexpr uint32_t reduce_5(uint32_t v) noexcept { return div_255(v * 31 + 127); }
+VX_FORCE_INLINE constexpr uint32_t reduce_6(uint32_t v) noexcept { return div_255(v * 63 + 127); }
+
+template <pixel_format SRC, pixel_format DST, row_kernel K = select_row_kernel<SRC, DST>()>
+struct row_converter;
+
+///////////////////////////////////////////////////////////////////////////////
+// copy
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format SRC, pixel_format DST>
+struct row_converter<SRC, DST, row_kernel::copy>
+{
+    static void convert(const byte_type* src, byte_type* dst, size_t count) noexcept
+    {
+        std::memmove(dst, src, count * get_pixel_size(SRC));
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// byte formats
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format SRC, pixel_format DST>
+struct row_converter<SRC, DST, row_kernel::shuffle_8>
+{
+    enum : size_t
+    {
+        src_size = get_pixel_size(SRC),
+        dst_size = get_pixel_size(DST),
+
+        // pixels left in the row for a 16 byte load and store to stay inside it
+        src_block_min = (16 + src_size - 1) / src_size,
+        dst_block_min = (16 + dst_size - 1) / dst_size,
+        block_min = (src_block_min > dst_block_min) ? src_block_min : dst_block_min,
+
+        // two 4 pixel loads for a 32 byte store
+        wide_block_min = (4 + src_block_min > 8) ? 4 + src_block_min : 8
+    };
+
+    static VX_FORCE_INLINE uint32_t convert_pixel(const byte_type* p) noexcept
+    {
+        uint32_t v = 0;
+        std::memcpy(&v, p, src_size);
+
+        return opaque_alpha_bits<SRC, DST>()
+            | move_byte<byte_source<SRC, DST>(0), 0>(v)
+            | move_byte<byte_source<SRC, DST>(1), 1>(v)
+            | move_byte<byte_source<SRC, DST>(2), 2>(v)
+            | move_byte<byte_source<SRC, DST>(3), 3>(v);
+    }
+
+    static void convert(const byte_type* src, byte_type* dst, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#define _SHUFFLE_BYTES(f) \
+    f(0), f(1), f(2), f(3), f(4), f(5), f(6), f(7), \
+    f(8), f(9), f(10), f(11), f(12), f(13), f(14), f(15)
+
+#if defined(VX_PIXEL_SIMD_SSSE3)
+
+#   define _INDEX(i) shuffle_index<SRC, DST>(i)
+#   define _FILL(i) shuffle_fill<SRC, DST>(i)
+
+        const __m128i mask = _mm_setr_epi8(_SHUFFLE_BYTES(_INDEX));
+        const __m128i fill = _mm_setr_epi8(_SHUFFLE_BYTES(_FILL));
+
+#   undef _INDEX
+#   undef _FILL
+
+#   if defined(VX_PIXEL_SIMD_AVX2)
+
+        VX_IF_CONSTEXPR (dst_size == 4)
+        {
+            const __m256i mask8 = _mm256_broadcastsi128_si256(mask);
+            const __m256i fill8 = _mm256_broadcastsi128_si256(fill);
+
+            for (; i + wide_block_min <= count; i += 8)
+            {
+                __m256i p;
+
+                VX_IF_CONSTEXPR (src_size == 4)
+                {
+                    p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+                }
+                else
+                {
+                    // each 128 bit lane shuffles its own 4 pixels
+                    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * src_size));
+                    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i + 4) * src_size));
+                    p = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+                }
+
+                const __m256i q = _mm256_or_si256(_mm256_shuffle_epi8(p, mask8), fill8);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), q);
+            }
+        }
+
+#   endif // VX_PIXEL_SIMD_AVX2
+
+        for (; i + block_min <= count; i += 4)
+        {
+            const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * src_size));
+            const __m128i q = _mm_or_si128(_mm_shuffle_epi8(p, mask), fill);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * dst_size), q);
+        }
+
+#elif defined(VX_PIXEL_SIMD_NEON)
+
+#   define _INDEX(i) static_cast<uint8_t>(shuffle_index<SRC, DST>(i))
+#   define _FILL(i) static_cast<uint8_t>(shuffle_fill<SRC, DST>(i))
+
+        // table lookups give zero for indices past the end like pshufb
+        static constexpr uint8_t mask_bytes[16] = { _SHUFFLE_BYTES(_INDEX) };
+        static constexpr uint8_t fill_bytes[16] = { _SHUFFLE_BYTES(_FILL) };
+
+#   undef _INDEX
+#   undef _FILL
+
+        const uint8x16_t mask = vld1q_u8(mask_bytes);
+        const uint8x16_t fill = vld1q_u8(fill_bytes);
+
+        for (; i + block_min <= count; i += 4)
+        {
+            const uint8x16_t p = vld1q_u8(src + i * src_size);
+            vst1q_u8(dst + i * dst_size, vorrq_u8(vqtbl1q_u8(p, mask), fill));
+        }
+
+#endif
+
+#undef _SHUFFLE_BYTES
+
+        for (; i < count; ++i)
+        {
+            const uint32_t out = convert_pixel(src + i * src_size);
+            std::memcpy(dst + i * dst_size, &out, dst_size);
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// 565 -> 8888
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format SRC, pixel_format DST>
+struct row_converter<SRC, DST, row_kernel::unpack_565>
+{
+    static constexpr channel_info s = get_channel_info(SRC);
+
+    static VX_FORCE_INLINE uint32_t convert_pixel(uint32_t p) noexcept
+    {
+        // expanded channels in rgb_8 order, then placed like an rgb_8 pixel
+        const uint32_t v =
+            expand_5((p & s.r.mask) >> s.r.shift) |
+            (expand_6((p & s.g.mask) >> s.g.shift) << 8) |
+            (expand_5((p & s.b.mask) >> s.b.shift) << 16);
+
+        return opaque_alpha_bits<SRC, DST>()
+            | move_byte<byte_source<pixel_format::rgb_8, DST>(0), 0>(v)
+            | move_byte<byte_source<pixel_format::rgb_8, DST>(1), 1>(v)
+            | move_byte<byte_source<pixel_format::rgb_8, DST>(2), 2>(v)
+            | move_byte<byte_source<pixel_format::rgb_8, DST>(3), 3>(v);
+    }
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+    // the channel stored at a destination byte, as 16 bit lanes
+    template <int BYTE, typename V>
+    static VX_FORCE_INLINE V pick(const V& r, const V& g, const V& b, const V& a) noexcept
+    {
+        return (channel_at_byte(DST, BYTE) == 0) ? r
+            : (channel_at_byte(DST, BYTE) == 1) ? g
+            : (channel_at_byte(DST, BYTE) == 2) ? b
+            : a;
+    }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+    static void convert(const byte_type* src, byte_type* dst, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#if defined(VX_PIXEL_SIMD_AVX2)
+
+        {
+            const __m256i m5 = _mm256_set1_epi16(0x1f);
+            const __m256i m6 = _mm256_set1_epi16(0x3f);
+            const __m256i k5 = _mm256_set1_epi16(527);
+            const __m256i k6 = _mm256_set1_epi16(259);
+            const __m256i bias5 = _mm256_set1_epi16(23);
+            const __m256i bias6 = _mm256_set1_epi16(33);
+            const __m256i a = _mm256_set1_epi16(opaque_alpha_bits<SRC, DST>() ? 0xff : 0);
+
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 2));
+
+                __m256i r = _mm256_and_si256(_mm256_srli_epi16(v, s.r.shift), m5);
+                __m256i g = _mm256_and_si256(_mm256_srli_epi16(v, s.g.shift), m6);
+                __m256i b = _mm256_and_si256(_mm256_srli_epi16(v, s.b.shift), m5);
+
+                r = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(r, k5), bias5), 6);
+                g = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(g, k6), bias6), 6);
+                b = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(b, k5), bias5), 6);
+
+                const __m256i lo = _mm256_or_si256(pick<0>(r, g, b, a), _mm256_slli_epi16(pick<1>(r, g, b, a), 8));
+                const __m256i hi = _mm256_or_si256(pick<2>(r, g, b, a), _mm256_slli_epi16(pick<3>(r, g, b, a), 8));
+
+                // unpacking works within 128 bit lanes, put the pixels back in order
+                const __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+                const __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_permute2x128_si256(p0, p1, 0x20));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4 + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+            }
+        }
+
+#endif // VX_PIXEL_SIMD_AVX2
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+        {
+            const __m128i m5 = _mm_set1_epi16(0x1f);
+            const __m128i m6 = _mm_set1_epi16(0x3f);
+            const __m128i k5 = _mm_set1_epi16(527);
+            const __m128i k6 = _mm_set1_epi16(259);
+            const __m128i bias5 = _mm_set1_epi16(23);
+            const __m128i bias6 = _mm_set1_epi16(33);
+            const __m128i a = _mm_set1_epi16(opaque_alpha_bits<SRC, DST>() ? 0xff : 0);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+
+                __m128i r = _mm_and_si128(_mm_srli_epi16(v, s.r.shift), m5);
+                __m128i g = _mm_and_si128(_mm_srli_epi16(v, s.g.shift), m6);
+                __m128i b = _mm_and_si128(_mm_srli_epi16(v, s.b.shift), m5);
+
+                r = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(r, k5), bias5), 6);
+                g = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(g, k6), bias6), 6);
+                b = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(b, k5), bias5), 6);
+
+                const __m128i lo = _mm_or_si128(pick<0>(r, g, b, a), _mm_slli_epi16(pick<1>(r, g, b, a), 8));
+                const __m128i hi = _mm_or_si128(pick<2>(r, g, b, a), _mm_slli_epi16(pick<3>(r, g, b, a), 8));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_unpacklo_epi16(lo, hi));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 16), _mm_unpackhi_epi16(lo, hi));
+            }
+        }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+        for (; i < count; ++i)
+        {
+            store_u32(dst + i * 4, convert_pixel(load_u16(src + i * 2)));
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// 8888 -> 565
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format SRC, pixel_format DST>
+struct row_converter<SRC, DST, row_kernel::pack_565>
+{
+    static constexpr channel_info d = get_channel_info(DST);
+
+    static constexpr int r_byte = source_byte(SRC, 0);
+    static constexpr int g_byte = source_byte(SRC, 1);
+    static constexpr int b_byte = source_byte(SRC, 2);
+
+    static VX_FORCE_INLINE uint16_t convert_pixel(uint32_t p) noexcept
+    {
+        const uint32_t r = (p >> (r_byte * 8)) & 0xff;
+        const uint32_t g = (p >> (g_byte * 8)) & 0xff;
+        const uint32_t b = (p >> (b_byte * 8)) & 0xff;
+
+        return static_cast<uint16_t>(
+            (reduce_5(r) << d.r.shift) |
+            (reduce_6(g) << d.g.shift) |
+            (reduce_5(b) << d.b.shift)
+        );
+    }
+
+    static void convert(const byte_type* src, byte_type* dst, size_t count) noexcept
+    {
+        size_t i = 0;
+
+#if defined(VX_PIXEL_SIMD_AVX2)
+
+        {
+            const __m256i mff = _mm256_set1_epi32(0xff);
+            const __m256i bias = _mm256_set1_epi16(127);
+            const __m256i magic = _mm256_set1_epi16(static_cast<short>(0x8081));
+            const __m256i k31 = _mm256_set1_epi16(31);
+            const __m256i k63 = _mm256_set1_epi16(63);
+
+            for (; i + 16 <= count; i += 16)
+            {
+                const __m256i p0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+                const __m256i p1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4 + 32));
+
+                // channels as 16 bit lanes, packing interleaves the 128 bit
+                // lanes which is undone once at the end
+                const __m256i r = _mm256_packs_epi32(
+                    _mm256_and_si256(_mm256_srli_epi32(p0, r_byte * 8), mff),
+                    _mm256_and_si256(_mm256_srli_epi32(p1, r_byte * 8), mff));
+                const __m256i g = _mm256_packs_epi32(
+                    _mm256_and_si256(_mm256_srli_epi32(p0, g_byte * 8), mff),
+                    _mm256_and_si256(_mm256_srli_epi32(p1, g_byte * 8), mff));
+                const __m256i b = _mm256_packs_epi32(
+                    _mm256_and_si256(_mm256_srli_epi32(p0, b_byte * 8), mff),
+                    _mm256_and_si256(_mm256_srli_epi32(p1, b_byte * 8), mff));
+
+                const __m256i r5 = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_add_epi16(_mm256_mullo_epi16(r, k31), bias), magic), 7);
+                const __m256i g6 = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_add_epi16(_mm256_mullo_epi16(g, k63), bias), magic), 7);
+                const __m256i b5 = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_add_epi16(_mm256_mullo_epi16(b, k31), bias), magic), 7);
+
+                const __m256i out = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_slli_epi16(r5, d.r.shift), _mm256_slli_epi16(g6, d.g.shift)),
+                    _mm256_slli_epi16(b5, d.b.shift));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 2), _mm256_permute4x64_epi64(out, 0xD8));
+            }
+        }
+
+#endif // VX_PIXEL_SIMD_AVX2
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+        {
+            const __m128i mff = _mm_set1_epi32(0xff);
+            const __m128i bias = _mm_set1_epi16(127);
+            const __m128i magic = _mm_set1_epi16(static_cast<short>(0x8081));
+            const __m128i k31 = _mm_set1_epi16(31);
+            const __m128i k63 = _mm_set1_epi16(63);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+                const __m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4 + 16));
+
+                const __m128i r = _mm_packs_epi32(
+                    _mm_and_si128(_mm_srli_epi32(p0, r_byte * 8), mff),
+                    _mm_and_si128(_mm_srli_epi32(p1, r_byte * 8), mff));
+                const __m128i g = _mm_packs_epi32(
+                    _mm_and_si128(_mm_srli_epi32(p0, g_byte * 8), mff),
+                    _mm_and_si128(_mm_srli_epi32(p1, g_byte * 8), mff));
+                const __m128i b = _mm_packs_epi32(
+                    _mm_and_si128(_mm_srli_epi32(p0, b_byte * 8), mff),
+                    _mm_and_si128(_mm_srli_epi32(p1, b_byte * 8), mff));
+
+                // div_255 on 16 bit lanes, (x * 0x8081) >> 23
+                const __m128i r5 = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(r, k31), bias), magic), 7);
+                const __m128i g6 = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(g, k63), bias), magic), 7);
+                const __m128i b5 = _mm_srli_epi16(_mm_mulhi_epu16(_mm_add_epi16(_mm_mullo_epi16(b, k31), bias), magic), 7);
+
+                const __m128i out = _mm_or_si128(
+                    _mm_or_si128(_mm_slli_epi16(r5, d.r.shift), _mm_slli_epi16(g6, d.g.shift)),
+                    _mm_slli_epi16(b5, d.b.shift));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), out);
+            }
+        }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+        for (; i < count; ++i)
+        {
+            store_u16(dst + i * 2, convert_pixel(load_u32(src + i * 4)));
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// integer formats
+///////////////////////////////////////////////////////////////////////////////
+
+// A channel of any integer format, read with the masks and shifts of packed
+// formats or the byte index of array formats.
+template <pixel_format F, size_t C>
+struct integer_channel
+{
+    static constexpr bool packed = get_pixel_type(F) != pixel_type::uint_array;
+
+    static constexpr uint32_t mask = packed ? build_mask_array(F)[C] : 0xff;
+    static constexpr uint32_t shift = packed ? build_shift_array(F)[C] : 0;
+    static constexpr uint32_t max = mask >> shift;
+};
+
+template <pixel_format SRC, pixel_format DST>
+struct row_converter<SRC, DST, row_kernel::rescale>
+{
+    using src_pixel = typename raw_pixel<SRC>::pixel_type;
+    using dst_pixel = typename raw_pixel<DST>::pixel_type;
+
+    static constexpr bool src_packed = get_pixel_type(SRC) != pixel_type::uint_array;
+    static constexpr bool dst_packed = get_pixel_type(DST) != pixel_type::uint_array;
+
+    // index into the build_*_array tables of a channel (0 r, 1 g, 2 b, 3 a)
+    static constexpr uint32_t table_index(pixel_format f, int channel) noexcept
+    {
+        return (channel == 0) ? get_channel_info(f).r.index
+            : (channel == 1) ? get_channel_info(f).g.index
+            : (channel == 2) ? get_channel_info(f).b.index
+            : get_channel_info(f).a.index;
+    }
+
+    static constexpr uint32_t channel_bits(pixel_format f, int channel) noexcept
+    {
+        return (channel == 0) ? get_channel_info(f).r.bits
+            : (channel == 1) ? get_channel_info(f).g.bits
+            : (channel == 2) ? get_channel_info(f).b.bits
+            : get_channel_info(f).a.bits;
+    }
+
+    // reads a channel as an integer in [0, max]
+    template <int CHANNEL>
+    static VX_FORCE_INLINE uint32_t read(const byte_type* p) noexcept
+    {
+        using channel = integer_channel<SRC, table_index(SRC, CHANNEL)>;
+
+        VX_IF_CONSTEXPR (src_packed)
+        {
+            src_pixel v;
+            std::memcpy(&v, p, sizeof(v));
+            return (static_cast<uint32_t>(v) & channel::mask) >> channel::shift;
+        }
+        else
+        {
+            return p[table_index(SRC, CHANNEL)];
+        }
+    }
+
+    // Rescales a channel to the destination range, rounding to nearest like
+    // the float path. Missing source channels decode as 0, missing alpha as 1.
+    template <int CHANNEL>
+    static VX_FORCE_INLINE uint32_t rescale(const byte_type* p) noexcept
+    {
+        constexpr uint32_t src_max = integer_channel<SRC, table_index(SRC, CHANNEL)>::max;
+        constexpr uint32_t dst_max = integer_channel<DST, table_index(DST, CHANNEL)>::max;
+
+        VX_IF_CONSTEXPR (channel_bits(SRC, CHANNEL) == 0)
+        {
+            return (CHANNEL == 3) ? dst_max : 0;
+        }
+        else VX_IF_CONSTEXPR (src_max == dst_max)
+        {
+            return read<CHANNEL>(p);
+        }
+        else
+        {
+            return (read<CHANNEL>(p) * (2 * dst_max) + src_max) / (2 * src_max);
+        }
+    }
+
+    static void convert(const byte_type* src, byte_type* dst, size_t count) noexcept
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const byte_type* s = src + i * get_pixel_size(SRC);
+            byte_type* d = dst + i * get_pixel_size(DST);
+
+            uint32_t channels[4] = {
+                rescale<0>(s),
+                rescale<1>(s),
+                rescale<2>(s),
+                rescale<3>(s)
+            };
+
+            VX_IF_CONSTEXPR (dst_packed)
+            {
+                uint32_t v = 0;
+
+#define _PACK(c) \
+    VX_IF_CONSTEXPR (channel_bits(DST, c) != 0) { v |= channels[c] << integer_channel<DST, table_index(DST, c)>::shift; }
+
+                _PACK(0) _PACK(1) _PACK(2) _PACK(3)
+
+#undef _PACK
+
+                const dst_pixel out = static_cast<dst_pixel>(v);
+                std::memcpy(d, &out, sizeof(out));
+            }
+            else
+            {
+#define _STORE(c) \
+    VX_IF_CONSTEXPR (channel_bits(DST, c) != 0) { d[table_index(DST, c)] = static_cast<byte_type>(channels[c]); }
+
+                _STORE(0) _STORE(1) _STORE(2) _STORE(3)
+
+#undef _STORE
+            }
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// float formats
+///////////////////////////////////////////////////////////////////////////////
+
+// How a format is decoded to and encoded from colors in the batch kernel.
+// Byte formats are shuffled to and from rgba_8 so one vector loop handles
+// all of them and rgba_16f has vector half conversions. Every other format
+// converts one pixel at a time.
+enum class color_codec_kind
+{
+    pixel,
+    bytes,
+    float_16
+};
+
+template <pixel_format F>
+VX_FORCE_INLINE constexpr color_codec_kind select_color_codec() noexcept
+{
+    return is_byte_format(F)                ? color_codec_kind::bytes
+        : (F == pixel_format::rgba_16f)     ? color_codec_kind::float_16
+        : color_codec_kind::pixel;
+}
+
+VX_STATIC_ASSERT_MSG(sizeof(math::color) == sizeof(float) * 4, "colors must be 4 packed floats");
+
+template <pixel_format F, color_codec_kind K = select_color_codec<F>()>
+struct color_codec
+{
+    static VX_FORCE_INLINE void decode(const byte_type* src, math::color* colors, size_t count) noexcept
+    {
+        const raw_pixel<F>* s = reinterpret_cast<const raw_pixel<F>*>(src);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            colors[i] = static_cast<math::color>(s[i]);
+        }
+    }
+
+    static VX_FORCE_INLINE void encode(const math::color* colors, byte_type* dst, size_t count) noexcept
+    {
+        raw_pixel<F>* d = reinterpret_cast<raw_pixel<F>*>(dst);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            d[i] = raw_pixel<F>(colors[i]);
+        }
+    }
+};
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+VX_FORCE_INLINE __m128i select_epi32(__m128i mask, __m128i a, __m128i b) noexcept
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// math::half_to_float_ui on 4 lanes
+VX_FORCE_INLINE __m128 half_to_float_4(__m128i h) noexcept
+{
+    const __m128i s = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+    const __m128i em = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+
+    __m128i r = _mm_slli_epi32(_mm_add_epi32(em, _mm_set1_epi32(112 << 10)), 13);
+    r = _mm_andnot_si128(_mm_cmplt_epi32(em, _mm_set1_epi32(1 << 10)), r);
+    r = _mm_add_epi32(r, _mm_andnot_si128(_mm_cmplt_epi32(em, _mm_set1_epi32(31 << 10)), _mm_set1_epi32(112 << 23)));
+
+    return _mm_castsi128_ps(_mm_or_si128(s, r));
+}
+
+// math::half_from_float_ui on 4 lanes, the results are in the low 16 bits
+VX_FORCE_INLINE __m128i float_to_half_4(__m128 f) noexcept
+{
+    const __m128i ui = _mm_castps_si128(f);
+    const __m128i s = _mm_and_si128(_mm_srli_epi32(ui, 16), _mm_set1_epi32(0x8000));
+    const __m128i em = _mm_and_si128(ui, _mm_set1_epi32(0x7fffffff));
+
+    __m128i h = _mm_srai_epi32(_mm_add_epi32(em, _mm_set1_epi32(-(112 << 23) + (1 << 12))), 13);
+    h = _mm_andnot_si128(_mm_cmplt_epi32(em, _mm_set1_epi32(113 << 23)), h);
+    h = select_epi32(_mm_cmpgt_epi32(em, _mm_set1_epi32((143 << 23) - 1)), _mm_set1_epi32(0x7c00), h);
+    h = select_epi32(_mm_cmpgt_epi32(em, _mm_set1_epi32(255 << 23)), _mm_set1_epi32(0x7e00), h);
+
+    return _mm_or_si128(s, h);
+}
+
+// 8 lanes of 32 bits to 16 bits, the values fit in 16 bits unsigned
+VX_FORCE_INLINE __m128i pack_u16(__m128i lo, __m128i hi) noexcept
+{
+    lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+    hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+    return _mm_packs_epi32(lo, hi);
+}
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+template <pixel_format F>
+struct color_codec<F, color_codec_kind::bytes>
+{
+    enum : size_t { chunk_size = 64 };
+
+    // uint arrays decode with a multiply by the inverse range and packed
+    // formats with a division, so each is matched exactly
+    static constexpr bool array = get_pixel_type(F) == pixel_type::uint_array;
+    static constexpr bool has_alpha = get_channel_info(F).a.bits != 0;
+
+    static VX_FORCE_INLINE void decode(const byte_type* src, math::color* colors, size_t count) noexcept
+    {
+        byte_type bytes[chunk_size * 4];
+
+        for (size_t i = 0; i < count; i += chunk_size)
+        {
+            const size_t n = (count - i < chunk_size) ? count - i : chunk_size;
+            row_converter<F, pixel_format::rgba_8>::convert(src + i * get_pixel_size(F), bytes, n);
+
+            float* out = reinterpret_cast<float*>(colors + i);
+            size_t j = 0;
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+            const __m128i zero = _mm_setzero_si128();
+            const __m128 range = _mm_set1_ps(255.0f);
+            const __m128 inv_range = _mm_set1_ps(1.0f / 255.0f);
+
+            // formats without alpha decode as opaque
+            const __m128 rgb_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+            const __m128 opaque = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+            for (; j + 4 <= n; j += 4)
+            {
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + j * 4));
+                const __m128i lo = _mm_unpacklo_epi8(b, zero);
+                const __m128i hi = _mm_unpackhi_epi8(b, zero);
+
+                __m128 c[4] = {
+                    _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)),
+                    _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)),
+                    _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)),
+                    _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero))
+                };
+
+                for (int k = 0; k < 4; ++k)
+                {
+                    c[k] = array ? _mm_mul_ps(c[k], inv_range) : _mm_div_ps(c[k], range);
+
+                    VX_IF_CONSTEXPR (!has_alpha)
+                    {
+                        c[k] = _mm_or_ps(_mm_and_ps(c[k], rgb_mask), opaque);
+                    }
+
+                    _mm_storeu_ps(out + (j + k) * 4, c[k]);
+                }
+            }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+            const raw_pixel<F>* s = reinterpret_cast<const raw_pixel<F>*>(src) + i;
+
+            for (; j < n; ++j)
+            {
+                colors[i + j] = static_cast<math::color>(s[j]);
+            }
+        }
+    }
+
+    static VX_FORCE_INLINE void encode(const math::color* colors, byte_type* dst, size_t count) noexcept
+    {
+        byte_type bytes[chunk_size * 4];
+        raw_pixel<pixel_format::rgba_8>* b = reinterpret_cast<raw_pixel<pixel_format::rgba_8>*>(bytes);
+
+        for (size_t i = 0; i < count; i += chunk_size)
+        {
+            const size_t n = (count - i < chunk_size) ? count - i : chunk_size;
+            const float* in = reinterpret_cast<const float*>(colors + i);
+            size_t j = 0;
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 range = _mm_set1_ps(255.0f);
+
+            for (; j + 4 <= n; j += 4)
+            {
+                __m128i q[4];
+
+                for (int k = 0; k < 4; ++k)
+                {
+                    // same steps as encoding one channel: scale, round, clamp
+                    const __m128 scaled = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + (j + k) * 4), range), half);
+                    q[k] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(scaled, zero), range));
+                }
+
+                const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(q[0], q[1]), _mm_packs_epi32(q[2], q[3]));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + j * 4), packed);
+            }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+            for (; j < n; ++j)
+            {
+                b[j] = raw_pixel<pixel_format::rgba_8>(colors[i + j]);
+            }
+
+            row_converter<pixel_format::rgba_8, F>::convert(bytes, dst + i * get_pixel_size(F), n);
+        }
+    }
+};
+
+template <pixel_format F>
+struct color_codec<F, color_codec_kind::float_16>
+{
+    static VX_FORCE_INLINE void decode(const byte_type* src, math::color* colors, size_t count) noexcept
+    {
+        float* out = reinterpret_cast<float*>(colors);
+        size_t i = 0;
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+        const __m128i zero = _mm_setzero_si128();
+
+        for (; i + 2 <= count; i += 2)
+        {
+            const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8));
+            _mm_storeu_ps(out + i * 4, half_to_float_4(_mm_unpacklo_epi16(h, zero)));
+            _mm_storeu_ps(out + i * 4 + 4, half_to_float_4(_mm_unpackhi_epi16(h, zero)));
+        }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+        const raw_pixel<F>* s = reinterpret_cast<const raw_pixel<F>*>(src);
+
+        for (; i < count; ++i)
+        {
+            colors[i] = static_cast<math::color>(s[i]);
+        }
+    }
+
+    static VX_FORCE_INLINE void encode(const math::color* colors, byte_type* dst, size_t count) noexcept
+    {
+        const float* in = reinterpret_cast<const float*>(colors);
+        size_t i = 0;
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+        for (; i + 2 <= count; i += 2)
+        {
+            const __m128i lo = float_to_half_4(_mm_loadu_ps(in + i * 4));
+            const __m128i hi = float_to_half_4(_mm_loadu_ps(in + i * 4 + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 8), pack_u16(lo, hi));
+        }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+        raw_pixel<F>* d = reinterpret_cast<raw_pixel<F>*>(dst);
+
+        for (; i < count; ++i)
+        {
+            d[i] = raw_pixel<F>(colors[i]);
+        }
+    }
+};
+
+// Pairs with a float or half format go through colors, a batch of pixels at
+// a time so the decode and encode loops are separate and can be vectorized.
+template <pixel_format SRC, pixel_format DST>
+struct row_converter<SRC, DST, row_kernel::batch>
+{
+    enum : size_t { batch_size = 256 };
+
+    static void convert(const byte_type* src, byte_type* dst, size_t count) noexcept
+    {
+        // a row of rgba_32f is already a row of colors
+        VX_IF_CONSTEXPR (DST == pixel_format::rgba_32f)
+        {
+            color_codec<SRC>::decode(src, reinterpret_cast<math::color*>(dst), count);
+            return;
+        }
+        else VX_IF_CONSTEXPR (SRC == pixel_format::rgba_32f)
+        {
+            color_codec<DST>::encode(reinterpret_cast<const math::color*>(src), dst, count);
+            return;
+        }
+
+        math::color colors[batch_size];
+
+        for (size_t i = 0; i < count; i += batch_size)
+        {
+            const size_t n = (count - i < batch_size) ? count - i : batch_size;
+
+            color_codec<SRC>::decode(src + i * get_pixel_size(SRC), colors, n);
+            color_codec<DST>::encode(colors, dst + i * get_pixel_size(DST), n);
+        }
+    }
+};
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Converts a row of pixels between two formats.
+///
+/// The rows must not overlap unless the formats are the same.
+///
+/// @param src The first source pixel.
+/// @param dst The first destination pixel.
+/// @param count The number of pixels to convert.
+///////////////////////////////////////////////////////////////////////////////
+template <pixel_format SRC, pixel_format DST>
+inline void convert_row(const byte_type* src, byte_type* dst, size_t count) noexcept
+{
+    _priv::row_converter<SRC, DST>::convert(src, dst, count);
+}
+
+} // namespace raw
+} // namespace pixel
+} // namespace vx
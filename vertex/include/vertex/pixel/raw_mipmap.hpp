@@ -0,0 +1,321 @@
+#pragma once
+
+#include "vertex/pixel/raw_convert.hpp"
+#include "vertex/math/color/space/srgb.hpp"
+
+namespace vx {
+namespace pixel {
+namespace raw {
+
+///////////////////////////////////////////////////////////////////////////////
+// 2x2 box reduction
+//
+// Halves an image in both directions, each destination pixel is the average
+// of the 2x2 block of source pixels under it. A dimension of 1 stays 1. When
+// a dimension is odd the last destination pixel also covers the last source
+// pixel, so every source pixel contributes to the result.
+//
+// Byte formats are averaged as integers with rounding. Other formats are
+// averaged as colors. With sRGB enabled the color channels are averaged in
+// linear space, alpha is always averaged as is.
+///////////////////////////////////////////////////////////////////////////////
+
+VX_FORCE_INLINE constexpr size_t reduced_size(size_t size) noexcept
+{
+    return (size > 1) ? size / 2 : 1;
+}
+
+namespace _priv {
+
+// The source pixels covered by destination pixel i along one dimension: 2
+// pixels, 3 for the last pixel of an odd size and 1 for a size of 1.
+VX_FORCE_INLINE constexpr size_t reduce_taps(size_t src_size, size_t i) noexcept
+{
+    return (src_size == 1) ? 1
+        : ((src_size & 1) && i == src_size / 2 - 1) ? 3
+        : 2;
+}
+
+class srgb_table
+{
+public:
+
+    // linear value of each 8 bit sRGB value
+    float to_linear[256];
+
+    // Linear values halfway between neighbouring 8 bit sRGB values. The 8 bit
+    // sRGB value of a linear value is the number of thresholds below it,
+    // which is the same as rounding the result of linear_to_srgb.
+    float thresholds[255];
+
+    static const srgb_table& get() noexcept
+    {
+        static const srgb_table table;
+        return table;
+    }
+
+    uint32_t to_srgb(float linear) const noexcept
+    {
+        uint32_t lo = 0;
+        uint32_t hi = 255;
+
+        while (lo < hi)
+        {
+            const uint32_t mid = (lo + hi) / 2;
+
+            if (thresholds[mid] < linear)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+
+        return lo;
+    }
+
+private:
+
+    srgb_table() noexcept
+    {
+        for (size_t i = 0; i < 256; ++i)
+        {
+            const float v = static_cast<float>(i) / 255.0f;
+            to_linear[i] = math::srgb_to_linear(math::color(v, v, v)).r;
+        }
+
+        for (size_t i = 0; i < 255; ++i)
+        {
+            const float v = (static_cast<float>(i) + 0.5f) / 255.0f;
+            thresholds[i] = math::srgb_to_linear(math::color(v, v, v)).r;
+        }
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// byte formats
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format F, bool SRGB>
+struct byte_reducer
+{
+    static constexpr size_t pixel_size = get_pixel_size(F);
+    static constexpr int alpha_byte = channel_byte(F, get_channel_info(F).a);
+
+    // Averages the source pixels of one destination pixel. The rows and
+    // columns hold the first byte of each source pixel.
+    static VX_FORCE_INLINE void reduce_pixel(
+        const byte_type* const* rows, size_t row_count,
+        size_t x, size_t column_count,
+        byte_type* dst
+    ) noexcept
+    {
+        const uint32_t n = static_cast<uint32_t>(row_count * column_count);
+
+        for (size_t b = 0; b < pixel_size; ++b)
+        {
+            VX_IF_CONSTEXPR (SRGB)
+            {
+                if (static_cast<int>(b) != alpha_byte)
+                {
+                    const srgb_table& table = srgb_table::get();
+                    float sum = 0.0f;
+
+                    for (size_t r = 0; r < row_count; ++r)
+                    {
+                        for (size_t c = 0; c < column_count; ++c)
+                        {
+                            sum += table.to_linear[rows[r][(x + c) * pixel_size + b]];
+                        }
+                    }
+
+                    dst[b] = static_cast<byte_type>(table.to_srgb(sum / static_cast<float>(n)));
+                    continue;
+                }
+            }
+
+            uint32_t sum = 0;
+
+            for (size_t r = 0; r < row_count; ++r)
+            {
+                for (size_t c = 0; c < column_count; ++c)
+                {
+                    sum += rows[r][(x + c) * pixel_size + b];
+                }
+            }
+
+            dst[b] = static_cast<byte_type>((sum + n / 2) / n);
+        }
+    }
+
+    // Reduces count 2x2 blocks from two source rows, returns how many were
+    // done with vector instructions.
+    static VX_FORCE_INLINE size_t reduce_blocks(const byte_type* r0, const byte_type* r1, byte_type* dst, size_t count) noexcept
+    {
+        size_t x = 0;
+
+#if defined(VX_PIXEL_SIMD_SSE2)
+
+        VX_IF_CONSTEXPR (!SRGB && pixel_size == 4)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i round = _mm_set1_epi16(2);
+
+            // 8 source pixels to 4 destination pixels
+            for (; x + 4 <= count; x += 4)
+            {
+                __m128i sums[2];
+
+                for (int k = 0; k < 2; ++k)
+                {
+                    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + x * 8 + k * 16));
+                    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + x * 8 + k * 16));
+
+                    // vertical sums of pixels 0 1 and 2 3
+                    const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                    const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                    // horizontal sums of 0 + 1 and 2 + 3
+                    const __m128i s = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+                    sums[k] = _mm_srli_epi16(_mm_add_epi16(s, round), 2);
+                }
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(sums[0], sums[1]));
+            }
+        }
+        else VX_IF_CONSTEXPR (!SRGB && pixel_size == 1)
+        {
+            const __m128i low_bytes = _mm_set1_epi16(0x00ff);
+            const __m128i round = _mm_set1_epi16(2);
+
+            // 16 source pixels to 8 destination pixels
+            for (; x + 8 <= count; x += 8)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r0 + x * 2));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r1 + x * 2));
+
+                const __m128i sa = _mm_add_epi16(_mm_and_si128(a, low_bytes), _mm_srli_epi16(a, 8));
+                const __m128i sb = _mm_add_epi16(_mm_and_si128(b, low_bytes), _mm_srli_epi16(b, 8));
+                const __m128i s = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sa, sb), round), 2);
+
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(s, s));
+            }
+        }
+
+#endif // VX_PIXEL_SIMD_SSE2
+
+        return x;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// other formats
+///////////////////////////////////////////////////////////////////////////////
+
+template <pixel_format F, bool SRGB>
+struct color_reducer
+{
+    static constexpr size_t pixel_size = get_pixel_size(F);
+
+    static VX_FORCE_INLINE math::color decode(const byte_type* p) noexcept
+    {
+        const math::color c = static_cast<math::color>(*reinterpret_cast<const raw_pixel<F>*>(p));
+        return SRGB ? math::srgb_to_linear(c) : c;
+    }
+
+    static VX_FORCE_INLINE void reduce_pixel(
+        const byte_type* const* rows, size_t row_count,
+        size_t x, size_t column_count,
+        byte_type* dst
+    ) noexcept
+    {
+        math::color sum(0.0f, 0.0f, 0.0f, 0.0f);
+
+        for (size_t r = 0; r < row_count; ++r)
+        {
+            for (size_t c = 0; c < column_count; ++c)
+            {
+                sum += decode(rows[r] + (x + c) * pixel_size);
+            }
+        }
+
+        sum /= static_cast<float>(row_count * column_count);
+        *reinterpret_cast<raw_pixel<F>*>(dst) = raw_pixel<F>(SRGB ? math::linear_to_srgb(sum) : sum);
+    }
+
+    static VX_FORCE_INLINE size_t reduce_blocks(const byte_type*, const byte_type*, byte_type*, size_t) noexcept
+    {
+        return 0;
+    }
+};
+
+template <pixel_format F, bool SRGB>
+inline void reduce_2x2(const byte_type* src, size_t src_width, size_t src_height, byte_type* dst) noexcept
+{
+    using reducer = typename std::conditional<is_byte_format(F), byte_reducer<F, SRGB>, color_reducer<F, SRGB>>::type;
+
+    constexpr size_t pixel_size = get_pixel_size(F);
+    const size_t src_stride = src_width * pixel_size;
+
+    const size_t dst_width = reduced_size(src_width);
+    const size_t dst_height = reduced_size(src_height);
+
+    // destination pixels covered by exactly 2 source columns
+    const size_t blocks = (src_width == 1) ? 0 : (src_width / 2) - (src_width & 1);
+
+    for (size_t y = 0; y < dst_height; ++y)
+    {
+        const size_t row_count = reduce_taps(src_height, y);
+        const byte_type* rows[3];
+
+        for (size_t r = 0; r < row_count; ++r)
+        {
+            rows[r] = src + (y * 2 + r) * src_stride;
+        }
+
+        byte_type* dst_row = dst + y * dst_width * pixel_size;
+        size_t x = 0;
+
+        if (row_count == 2)
+        {
+            x = reducer::reduce_blocks(rows[0], rows[1], dst_row, blocks);
+        }
+
+        for (; x < dst_width; ++x)
+        {
+            reducer::reduce_pixel(rows, row_count, x * 2, reduce_taps(src_width, x), dst_row + x * pixel_size);
+        }
+    }
+}
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Halves an image with a 2x2 box filter.
+///
+/// @tparam F The format of both images.
+/// @param src The source pixels, tightly packed.
+/// @param src_width The width of the source image.
+/// @param src_height The height of the source image.
+/// @param dst The destination, reduced_size(src_width) by
+/// reduced_size(src_height) pixels.
+/// @param srgb True to average the color channels in linear space.
+///////////////////////////////////////////////////////////////////////////////
+template <pixel_format F>
+inline void reduce_2x2(const byte_type* src, size_t src_width, size_t src_height, byte_type* dst, bool srgb = false) noexcept
+{
+    if (srgb)
+    {
+        _priv::reduce_2x2<F, true>(src, src_width, src_height, dst);
+    }
+    else
+    {
+        _priv::reduce_2x2<F, false>(src, src_width, src_height, dst);
+    }
+}
+
+} // namespace raw
+} // namespace pixel
+} // namespace vx
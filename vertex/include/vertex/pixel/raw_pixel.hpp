@@ -14,7 +14,7 @@ namespace pixel {
 
 template <pixel_format f> struct raw_pixel;
 
-#define _STATIC_CHECK_SIZE(F, FS)         VX_STATIC_ASSERT_MSG(sizeof(raw_pixel<F>) == sizeof(typename raw_pixel<F>::pixel_type), "invalid pixel size for format " FS)
+#define _STATIC_CHECK_SIZE(F, FS)         VX_STATIC_ASSERT_MSG(sizeof(raw_pixel<F>) == sizeof(typename raw_pixel<F>::pixel_type) && sizeof(raw_pixel<F>) == get_pixel_size(F), "invalid pixel size for format " FS)
 #define _STATIC_CHECK_ALIGNMENT(F, FS)    VX_STATIC_ASSERT_MSG(alignof(raw_pixel<F>) == alignof(typename raw_pixel<F>::pixel_type), "invalid pixel alignment for format " FS)
 #define _STATIC_FORMAT_CHECK(F)           _STATIC_CHECK_SIZE(pixel_format::F, #F); _STATIC_CHECK_ALIGNMENT(pixel_format::F, #F)
 
@@ -311,7 +311,7 @@ struct alignas(alignof(uint16_t)) raw_pixel<pixel_format::bgr_565>
     using pixel_type = uint16_t;
     using float_type = float;
 
-    static constexpr pixel_format format = pixel_format::rgb_565;
+    static constexpr pixel_format format = pixel_format::bgr_565;
     static constexpr channel_info info = get_channel_info(format);
     pixel_type data;
 
@@ -1262,10 +1262,10 @@ _STATIC_FORMAT_CHECK(r_16f);
 ///////////////////////////////////////////////////////////////////////////////
 
 template <>
-struct alignas(alignof(math::half_t[1])) raw_pixel<pixel_format::rg_16f>
+struct alignas(alignof(math::half_t[2])) raw_pixel<pixel_format::rg_16f>
 {
     using channel_type = math::half_t;
-    using pixel_type = channel_type[1];
+    using pixel_type = channel_type[2];
     using float_type = float;
 
     static constexpr pixel_format format = pixel_format::rg_16f;
@@ -1297,10 +1297,10 @@ _STATIC_FORMAT_CHECK(rg_16f);
 ///////////////////////////////////////////////////////////////////////////////
 
 template <>
-struct alignas(alignof(math::half_t[1])) raw_pixel<pixel_format::rgb_16f>
+struct alignas(alignof(math::half_t[3])) raw_pixel<pixel_format::rgb_16f>
 {
     using channel_type = math::half_t;
-    using pixel_type = channel_type[1];
+    using pixel_type = channel_type[3];
     using float_type = float;
 
     static constexpr pixel_format format = pixel_format::rgb_16f;
@@ -1333,10 +1333,10 @@ _STATIC_FORMAT_CHECK(rgb_16f);
 ///////////////////////////////////////////////////////////////////////////////
 
 template <>
-struct alignas(alignof(math::half_t[1])) raw_pixel<pixel_format::rgba_16f>
+struct alignas(alignof(math::half_t[4])) raw_pixel<pixel_format::rgba_16f>
 {
     using channel_type = math::half_t;
-    using pixel_type = channel_type[1];
+    using pixel_type = channel_type[4];
     using float_type = float;
 
     static constexpr pixel_format format = pixel_format::rgba_16f;
@@ -0,0 +1,849 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "vertex/pixel/execution_policy.hpp"
+#include "vertex/std/set.hpp"
+
+namespace vx {
+namespace pixel {
+
+enum class dither_mode
+{
+    none,
+    ordered,            // 8x8 Bayer threshold map
+    floyd_steinberg     // error diffusion
+};
+
+namespace raw {
+
+// Quantization works on 8 bit rgba. Sources are read one row at a time
+// through a reader that converts count pixels to rgba_8, such as
+// convert_row<F, pixel_format::rgba_8>.
+using rgba_row_reader = void(*)(const uint8_t* src, uint8_t* dst, size_t count);
+
+///////////////////////////////////////////////////////////////////////////////
+// palette tree
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief A k-d tree over the colors of a palette for nearest color lookups.
+///
+/// Lookups return the same index as a linear search over the palette: the
+/// entry with the smallest squared distance over all four channels, the
+/// lowest index on ties.
+///////////////////////////////////////////////////////////////////////////////
+class palette_tree
+{
+public:
+
+    palette_tree() = default;
+
+    ///////////////////////////////////////////////////////////////////////////
+    /// @brief Builds the tree.
+    ///
+    /// @param colors count colors as rgba bytes.
+    /// @param count The number of colors.
+    ///////////////////////////////////////////////////////////////////////////
+    palette_tree(const uint8_t* colors, size_t count)
+        : m_colors(colors, colors + count * 4)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        m_points.resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (size_t c = 0; c < 4; ++c)
+            {
+                m_points[i].c[c] = colors[i * 4 + c];
+            }
+
+            m_points[i].index = static_cast<uint32_t>(i);
+        }
+
+        m_nodes.reserve(2 * (count / leaf_size + 1));
+        build(0, static_cast<uint32_t>(count));
+    }
+
+    size_t size() const noexcept { return m_points.size(); }
+    bool empty() const noexcept { return m_points.empty(); }
+
+    // The rgba bytes of entry i.
+    const uint8_t* color(size_t i) const noexcept { return &m_colors[i * 4]; }
+
+    // The index of the entry closest to rgba, the tree must not be empty.
+    size_t find_closest(const int32_t* rgba) const noexcept
+    {
+        int32_t best_distance = INT32_MAX;
+        uint32_t best = 0;
+        int32_t offsets[4] = {};
+        search(0, rgba, 0, offsets, best_distance, best);
+        return best;
+    }
+
+private:
+
+    enum : uint32_t { leaf_size = 4 };
+
+    struct point
+    {
+        int32_t c[4];
+        uint32_t index;
+    };
+
+    struct node
+    {
+        uint32_t begin, end;        // the points of a leaf
+        uint32_t left, right;       // 0 for leaves, the root is never a child
+        int32_t split;
+        uint32_t axis;
+    };
+
+    uint32_t build(uint32_t begin, uint32_t end)
+    {
+        const uint32_t n = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.push_back(node{ begin, end, 0, 0, 0, 0 });
+
+        if (end - begin <= leaf_size)
+        {
+            return n;
+        }
+
+        // split the widest channel at the median
+        int32_t lo[4] = { 255, 255, 255, 255 };
+        int32_t hi[4] = { 0, 0, 0, 0 };
+
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            for (size_t c = 0; c < 4; ++c)
+            {
+                lo[c] = std::min(lo[c], m_points[i].c[c]);
+                hi[c] = std::max(hi[c], m_points[i].c[c]);
+            }
+        }
+
+        uint32_t axis = 0;
+        for (uint32_t c = 1; c < 4; ++c)
+        {
+            if (hi[c] - lo[c] > hi[axis] - lo[axis])
+            {
+                axis = c;
+            }
+        }
+
+        if (hi[axis] == lo[axis])
+        {
+            // every point is the same color
+            return n;
+        }
+
+        const uint32_t mid = begin + (end - begin) / 2;
+        std::nth_element(m_points.begin() + begin, m_points.begin() + mid, m_points.begin() + end,
+            [axis](const point& a, const point& b) { return a.c[axis] < b.c[axis]; });
+
+        const int32_t split = m_points[mid].c[axis];
+        const uint32_t left = build(begin, mid);
+        const uint32_t right = build(mid, end);
+
+        node& nd = m_nodes[n];
+        nd.left = left;
+        nd.right = right;
+        nd.split = split;
+        nd.axis = axis;
+        return n;
+    }
+
+    // bound is the squared distance from q to the region of the node, made
+    // of the per channel offsets to the splits crossed on the way down
+    void search(uint32_t n, const int32_t* q, int32_t bound, int32_t* offsets, int32_t& best_distance, uint32_t& best) const noexcept
+    {
+        const node& nd = m_nodes[n];
+
+        if (nd.left == 0)
+        {
+            for (uint32_t i = nd.begin; i < nd.end; ++i)
+            {
+                const point& p = m_points[i];
+                const int32_t d0 = q[0] - p.c[0];
+                const int32_t d1 = q[1] - p.c[1];
+                const int32_t d2 = q[2] - p.c[2];
+                const int32_t d3 = q[3] - p.c[3];
+                const int32_t d = d0 * d0 + d1 * d1 + d2 * d2 + d3 * d3;
+
+                if (d < best_distance || (d == best_distance && p.index < best))
+                {
+                    best_distance = d;
+                    best = p.index;
+                }
+            }
+
+            return;
+        }
+
+        // Points left of the split are <= split and points right of it are
+        // >= split. The far side is searched on equal distance as well, it
+        // may hold an entry with a lower index.
+        const uint32_t axis = nd.axis;
+        const int32_t diff = q[axis] - nd.split;
+        const uint32_t near_side = (diff < 0) ? nd.left : nd.right;
+        const uint32_t far_side = (diff < 0) ? nd.right : nd.left;
+
+        search(near_side, q, bound, offsets, best_distance, best);
+
+        const int32_t old_offset = offsets[axis];
+        const int32_t far_bound = bound - old_offset * old_offset + diff * diff;
+
+        if (far_bound <= best_distance)
+        {
+            offsets[axis] = diff;
+            search(far_side, q, far_bound, offsets, best_distance, best);
+            offsets[axis] = old_offset;
+        }
+    }
+
+    std::vector<point> m_points;
+    std::vector<node> m_nodes;
+    std::vector<uint8_t> m_colors;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// median cut
+///////////////////////////////////////////////////////////////////////////////
+
+namespace _priv {
+
+// colors are binned at 5 bits per channel while boxes are cut
+enum : uint32_t
+{
+    bin_bits = 5,
+    bin_count = 1u << (bin_bits * 4)
+};
+
+VX_FORCE_INLINE uint32_t bin_key(const uint8_t* px) noexcept
+{
+    return (static_cast<uint32_t>(px[0] >> (8 - bin_bits)) << (bin_bits * 3))
+         | (static_cast<uint32_t>(px[1] >> (8 - bin_bits)) << (bin_bits * 2))
+         | (static_cast<uint32_t>(px[2] >> (8 - bin_bits)) << (bin_bits * 1))
+         | (static_cast<uint32_t>(px[3] >> (8 - bin_bits)));
+}
+
+VX_FORCE_INLINE uint32_t bin_channel(uint32_t key, uint32_t c) noexcept
+{
+    return (key >> (bin_bits * (3 - c))) & ((1u << bin_bits) - 1);
+}
+
+struct color_bin
+{
+    uint32_t key;
+    uint32_t count;
+};
+
+struct color_box
+{
+    uint32_t begin, end;    // bins
+    double error;           // summed squared distance of the bins to the mean
+    uint32_t axis;          // the channel with the most error
+};
+
+inline color_box make_box(const color_bin* bins, uint32_t begin, uint32_t end) noexcept
+{
+    double count = 0.0;
+    double sum[4] = {};
+    double sum_sq[4] = {};
+
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const double w = bins[i].count;
+        count += w;
+
+        for (uint32_t c = 0; c < 4; ++c)
+        {
+            const double v = bin_channel(bins[i].key, c);
+            sum[c] += w * v;
+            sum_sq[c] += w * v * v;
+        }
+    }
+
+    color_box box{ begin, end, 0.0, 0 };
+    double axis_error = -1.0;
+
+    for (uint32_t c = 0; c < 4; ++c)
+    {
+        const double e = sum_sq[c] - sum[c] * sum[c] / count;
+        box.error += e;
+
+        if (e > axis_error)
+        {
+            axis_error = e;
+            box.axis = c;
+        }
+    }
+
+    return box;
+}
+
+// Sorts the bins of a box along its axis and returns the first bin of the
+// second half. The cut falls between two values of the axis where the
+// squared error of the two halves along it is the smallest.
+inline uint32_t find_cut(color_bin* bins, const color_box& box) noexcept
+{
+    const uint32_t axis = box.axis;
+
+    std::sort(bins + box.begin, bins + box.end, [axis](const color_bin& a, const color_bin& b)
+    {
+        return bin_channel(a.key, axis) < bin_channel(b.key, axis);
+    });
+
+    double total_count = 0.0, total_sum = 0.0, total_sq = 0.0;
+    for (uint32_t i = box.begin; i < box.end; ++i)
+    {
+        const double w = bins[i].count;
+        const double v = bin_channel(bins[i].key, axis);
+        total_count += w;
+        total_sum += w * v;
+        total_sq += w * v * v;
+    }
+
+    double count = 0.0, sum = 0.0, sq = 0.0;
+    double best_error = -1.0;
+    uint32_t best = box.begin + 1;
+
+    for (uint32_t i = box.begin; i + 1 < box.end; ++i)
+    {
+        const double w = bins[i].count;
+        const double v = bin_channel(bins[i].key, axis);
+        count += w;
+        sum += w * v;
+        sq += w * v * v;
+
+        if (bin_channel(bins[i + 1].key, axis) == bin_channel(bins[i].key, axis))
+        {
+            continue;
+        }
+
+        const double rest = total_count - count;
+        const double error = (sq - sum * sum / count) + ((total_sq - sq) - (total_sum - sum) * (total_sum - sum) / rest);
+
+        if (best_error < 0.0 || error < best_error)
+        {
+            best_error = error;
+            best = i + 1;
+        }
+    }
+
+    return best;
+}
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Chooses a palette for an image.
+///
+/// When the image has no more than max_colors distinct colors the palette
+/// holds exactly those, sorted. Otherwise the colors are counted in bins of
+/// 5 bits per channel and the bins are cut into max_colors boxes, each time
+/// cutting the box with the largest squared error across its channel with
+/// the most error, where the two halves have the least error. Each entry is
+/// the mean of the pixels that fall in its box.
+///
+/// @param src The source pixels, tightly packed.
+/// @param width The width of the image.
+/// @param height The height of the image.
+/// @param pixel_size The size of a source pixel in bytes.
+/// @param read Converts source rows to rgba_8.
+/// @param max_colors The largest number of entries.
+/// @param colors Receives the entries as rgba bytes.
+///
+/// @return The number of entries.
+///////////////////////////////////////////////////////////////////////////////
+inline size_t median_cut(
+    const uint8_t* src, size_t width, size_t height, size_t pixel_size, rgba_row_reader read,
+    size_t max_colors, std::vector<uint8_t>& colors
+)
+{
+    colors.clear();
+
+    if (!src || width == 0 || height == 0 || max_colors == 0)
+    {
+        return 0;
+    }
+
+    const size_t row_size = width * pixel_size;
+    std::vector<uint8_t> row(width * 4);
+
+    // count the bins, and the exact colors for as long as there are few
+    // enough of them
+    std::vector<uint32_t> bins(_priv::bin_count, 0);
+    hash_set<uint32_t> exact;
+    bool few_colors = true;
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        read(&src[y * row_size], row.data(), width);
+
+        uint32_t last = 0;
+        for (size_t x = 0; x < width; ++x)
+        {
+            const uint8_t* px = &row[x * 4];
+            ++bins[_priv::bin_key(px)];
+
+            if (few_colors)
+            {
+                uint32_t bits;
+                std::memcpy(&bits, px, 4);
+
+                if (x == 0 || bits != last)
+                {
+                    exact.insert(bits);
+                    few_colors = (exact.size() <= max_colors);
+                    last = bits;
+                }
+            }
+        }
+    }
+
+    if (few_colors)
+    {
+        std::vector<uint32_t> sorted(exact.begin(), exact.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        colors.resize(sorted.size() * 4);
+        std::memcpy(colors.data(), sorted.data(), colors.size());
+        return sorted.size();
+    }
+
+    std::vector<_priv::color_bin> used;
+    for (uint32_t key = 0; key < _priv::bin_count; ++key)
+    {
+        if (bins[key])
+        {
+            used.push_back(_priv::color_bin{ key, bins[key] });
+        }
+    }
+
+    std::vector<_priv::color_box> boxes;
+    boxes.reserve(max_colors);
+    boxes.push_back(_priv::make_box(used.data(), 0, static_cast<uint32_t>(used.size())));
+
+    while (boxes.size() < max_colors)
+    {
+        size_t worst = boxes.size();
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            if (boxes[i].end - boxes[i].begin > 1 && boxes[i].error > 0.0
+                && (worst == boxes.size() || boxes[i].error > boxes[worst].error))
+            {
+                worst = i;
+            }
+        }
+
+        if (worst == boxes.size())
+        {
+            // every box holds a single bin
+            break;
+        }
+
+        const _priv::color_box box = boxes[worst];
+        const uint32_t cut = _priv::find_cut(used.data(), box);
+
+        boxes[worst] = _priv::make_box(used.data(), box.begin, cut);
+        boxes.push_back(_priv::make_box(used.data(), cut, box.end));
+    }
+
+    // the counts are done with, reuse them to map each bin to its box
+    for (size_t b = 0; b < boxes.size(); ++b)
+    {
+        for (uint32_t i = boxes[b].begin; i < boxes[b].end; ++i)
+        {
+            bins[used[i].key] = static_cast<uint32_t>(b);
+        }
+    }
+
+    // average the exact colors of the pixels in each box
+    std::vector<uint64_t> sums(boxes.size() * 5, 0);
+
+    for (size_t y = 0; y < height; ++y)
+    {
+        read(&src[y * row_size], row.data(), width);
+
+        for (size_t x = 0; x < width; ++x)
+        {
+            const uint8_t* px = &row[x * 4];
+            uint64_t* sum = &sums[bins[_priv::bin_key(px)] * 5];
+
+            sum[0] += px[0];
+            sum[1] += px[1];
+            sum[2] += px[2];
+            sum[3] += px[3];
+            sum[4] += 1;
+        }
+    }
+
+    colors.resize(boxes.size() * 4);
+
+    for (size_t b = 0; b < boxes.size(); ++b)
+    {
+        const uint64_t* sum = &sums[b * 5];
+
+        for (size_t c = 0; c < 4; ++c)
+        {
+            colors[b * 4 + c] = static_cast<uint8_t>((sum[c] + sum[4] / 2) / sum[4]);
+        }
+    }
+
+    return boxes.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// remap
+///////////////////////////////////////////////////////////////////////////////
+
+namespace _priv {
+
+constexpr uint8_t bayer_8x8[8][8] = {
+    {  0, 32,  8, 40,  2, 34, 10, 42 },
+    { 48, 16, 56, 24, 50, 18, 58, 26 },
+    { 12, 44,  4, 36, 14, 46,  6, 38 },
+    { 60, 28, 52, 20, 62, 30, 54, 22 },
+    {  3, 35, 11, 43,  1, 33,  9, 41 },
+    { 51, 19, 59, 27, 49, 17, 57, 25 },
+    { 15, 47,  7, 39, 13, 45,  5, 37 },
+    { 63, 31, 55, 23, 61, 29, 53, 21 }
+};
+
+VX_FORCE_INLINE int32_t clamp_channel(int32_t v) noexcept
+{
+    return (v < 0) ? 0 : ((v > 255) ? 255 : v);
+}
+
+// The amplitude of ordered dithering: the mean distance between the rgb of
+// each entry and the entry closest to it, so the threshold map spans about
+// one step of the palette.
+inline int32_t ordered_spread(const palette_tree& tree) noexcept
+{
+    const size_t n = tree.size();
+    if (n < 2)
+    {
+        return 0;
+    }
+
+    double total = 0.0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint8_t* a = tree.color(i);
+        int32_t best = INT32_MAX;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            const uint8_t* b = tree.color(j);
+            const int32_t d0 = a[0] - b[0];
+            const int32_t d1 = a[1] - b[1];
+            const int32_t d2 = a[2] - b[2];
+            const int32_t d = d0 * d0 + d1 * d1 + d2 * d2;
+
+            if (j != i && d != 0 && d < best)
+            {
+                best = d;
+            }
+        }
+
+        total += (best == INT32_MAX) ? 0.0 : std::sqrt(static_cast<double>(best));
+    }
+
+    const int32_t spread = static_cast<int32_t>(total / static_cast<double>(n) + 0.5);
+    return (spread > 255) ? 255 : spread;
+}
+
+// Remembers recent lookups in a small direct mapped table, images repeat
+// the same colors a lot.
+class lookup_cache
+{
+public:
+
+    explicit lookup_cache(const palette_tree& tree)
+        : m_tree(tree), m_entries(static_cast<size_t>(1) << cache_bits, 0) {}
+
+    uint8_t find_closest(const int32_t* q) noexcept
+    {
+        const uint32_t key = static_cast<uint32_t>(q[0])
+            | (static_cast<uint32_t>(q[1]) << 8)
+            | (static_cast<uint32_t>(q[2]) << 16)
+            | (static_cast<uint32_t>(q[3]) << 24);
+
+        // an entry holds the index + 1 above the color, 0 when empty
+        uint64_t& entry = m_entries[(key * 2654435761u) >> (32 - cache_bits)];
+
+        if ((entry >> 32) != 0 && static_cast<uint32_t>(entry) == key)
+        {
+            return static_cast<uint8_t>((entry >> 32) - 1);
+        }
+
+        const size_t index = m_tree.find_closest(q);
+        entry = (static_cast<uint64_t>(index + 1) << 32) | key;
+        return static_cast<uint8_t>(index);
+    }
+
+private:
+
+    enum : uint32_t { cache_bits = 12 };
+
+    const palette_tree& m_tree;
+    std::vector<uint64_t> m_entries;
+};
+
+inline void remap_rows(
+    const uint8_t* src, size_t width, size_t pixel_size, rgba_row_reader read,
+    const palette_tree& tree, int32_t spread, uint8_t* indices,
+    size_t first, size_t last
+)
+{
+    std::vector<uint8_t> row(width * 4);
+    lookup_cache cache(tree);
+
+    for (size_t y = first; y < last; ++y)
+    {
+        read(&src[y * width * pixel_size], row.data(), width);
+        uint8_t* out = &indices[y * width];
+        const uint8_t* thresholds = bayer_8x8[y & 7];
+
+        for (size_t x = 0; x < width; ++x)
+        {
+            // a threshold in (-spread / 2, spread / 2) on the color
+            // channels, alpha is matched as is
+            const int32_t offset = (2 * thresholds[x & 7] + 1 - 64) * spread / 128;
+            const uint8_t* px = &row[x * 4];
+            const int32_t q[4] = {
+                clamp_channel(px[0] + offset),
+                clamp_channel(px[1] + offset),
+                clamp_channel(px[2] + offset),
+                px[3]
+            };
+
+            out[x] = cache.find_closest(q);
+        }
+    }
+}
+
+// Floyd-Steinberg with the errors kept in 1/16ths. The color channels are
+// diffused, alpha is matched as is.
+//
+// Row y needs the errors of row y - 1 up to pixel x + 1 before it can place
+// pixel x, so the rows can run as a wavefront: each thread claims the next
+// row and follows the row before it, which was claimed earlier and is
+// already running. Every pixel sees the same errors as in a sequential pass.
+//
+// Two rows of errors are enough. Row y reads and clears its errors at x
+// before row y + 1 gets past x - 1, which is the first time row y + 1 adds
+// to that slot again.
+class error_diffusion
+{
+public:
+
+    error_diffusion(
+        const uint8_t* src, size_t width, size_t height, size_t pixel_size, rgba_row_reader read,
+        const palette_tree& tree, uint8_t* indices, bool parallel
+    )
+        : m_src(src), m_width(width), m_height(height), m_pixel_size(pixel_size), m_read(read)
+        , m_tree(tree), m_indices(indices)
+        , m_errors(2 * width * 3, 0)
+        , m_progress(parallel ? std::make_unique<os::atomic<size_t>[]>(height) : nullptr)
+    {
+    }
+
+    void run()
+    {
+        std::vector<uint8_t> row(m_width * 4);
+        lookup_cache cache(m_tree);
+
+        for (size_t y = m_next_row.fetch_add(1, std::memory_order_relaxed); y < m_height; y = m_next_row.fetch_add(1, std::memory_order_relaxed))
+        {
+            run_row(y, row.data(), cache);
+        }
+    }
+
+private:
+
+    enum : size_t { progress_step = 32 };
+
+    int32_t* errors(size_t y) noexcept
+    {
+        return &m_errors[(y & 1) * m_width * 3];
+    }
+
+    static VX_FORCE_INLINE int32_t round_sixteenths(int32_t v) noexcept
+    {
+        return (v >= 0) ? (v + 8) / 16 : -((8 - v) / 16);
+    }
+
+    void wait_for(size_t y, size_t count) const noexcept
+    {
+        uint32_t spins = 0;
+
+        while (m_progress[y].load(std::memory_order_acquire) < count)
+        {
+            if (++spins < 64)
+            {
+                os::cpu_pause();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void run_row(size_t y, uint8_t* row, lookup_cache& cache) noexcept
+    {
+        m_read(&m_src[y * m_width * m_pixel_size], row, m_width);
+
+        int32_t* in = errors(y);
+        int32_t* out = errors(y + 1);
+
+        uint8_t* indices = &m_indices[y * m_width];
+        int32_t carry[3] = {};
+
+        for (size_t x = 0; x < m_width; ++x)
+        {
+            // pixel x needs row y - 1 done up to x + 1
+            if (m_progress && y > 0 && (x % progress_step) == 0)
+            {
+                wait_for(y - 1, std::min(x + progress_step + 1, m_width));
+            }
+
+            const uint8_t* px = &row[x * 4];
+            int32_t q[4];
+
+            for (size_t c = 0; c < 3; ++c)
+            {
+                q[c] = clamp_channel(px[c] + round_sixteenths(in[x * 3 + c] + carry[c]));
+                in[x * 3 + c] = 0;
+            }
+
+            q[3] = px[3];
+
+            const uint8_t index = cache.find_closest(q);
+            indices[x] = index;
+
+            const uint8_t* pc = m_tree.color(index);
+
+            for (size_t c = 0; c < 3; ++c)
+            {
+                const int32_t e = q[c] - pc[c];
+                carry[c] = 7 * e;
+                out[x * 3 + c] += 5 * e;
+
+                if (x > 0)
+                {
+                    out[(x - 1) * 3 + c] += 3 * e;
+                }
+
+                if (x + 1 < m_width)
+                {
+                    out[(x + 1) * 3 + c] += e;
+                }
+            }
+
+            if (m_progress && ((x + 1) % progress_step) == 0)
+            {
+                m_progress[y].store(x + 1, std::memory_order_release);
+            }
+        }
+
+        if (m_progress)
+        {
+            m_progress[y].store(m_width, std::memory_order_release);
+        }
+    }
+
+    const uint8_t* m_src;
+    size_t m_width;
+    size_t m_height;
+    size_t m_pixel_size;
+    rgba_row_reader m_read;
+    const palette_tree& m_tree;
+    uint8_t* m_indices;
+
+    std::vector<int32_t> m_errors;
+    std::unique_ptr<os::atomic<size_t>[]> m_progress;
+    os::atomic<size_t> m_next_row{ 0 };
+};
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Maps every pixel of an image to a palette entry.
+///
+/// The result is the same for every execution policy. Without dithering
+/// and with ordered dithering the rows run in bands. Floyd-Steinberg runs
+/// the rows as a wavefront, each row a little behind the one above it.
+///
+/// @param src The source pixels, tightly packed.
+/// @param width The width of the image.
+/// @param height The height of the image.
+/// @param pixel_size The size of a source pixel in bytes.
+/// @param read Converts source rows to rgba_8.
+/// @param tree The palette, at most 256 entries.
+/// @param dither The dithering to apply.
+/// @param indices Receives width * height palette indices.
+/// @param policy How to run the rows.
+///
+/// @return True on success, false if an argument was invalid.
+///////////////////////////////////////////////////////////////////////////////
+inline bool remap(
+    const uint8_t* src, size_t width, size_t height, size_t pixel_size, rgba_row_reader read,
+    const palette_tree& tree, dither_mode dither, uint8_t* indices,
+    const execution_policy& policy = execution_policy()
+)
+{
+    if (!src || !indices || tree.empty() || tree.size() > 256)
+    {
+        return false;
+    }
+
+    if (dither == dither_mode::floyd_steinberg)
+    {
+        const size_t threads = std::min(policy.thread_count(), height);
+        _priv::error_diffusion diffusion(src, width, height, pixel_size, read, tree, indices, threads > 1);
+
+        if (threads <= 1)
+        {
+            diffusion.run();
+            return true;
+        }
+
+        // one band per thread, each claiming rows until none are left
+        policy.for_each_band(threads, 0, [&diffusion](size_t first, size_t last)
+        {
+            for (size_t i = first; i < last; ++i)
+            {
+                diffusion.run();
+            }
+        });
+
+        return true;
+    }
+
+    const int32_t spread = (dither == dither_mode::ordered) ? _priv::ordered_spread(tree) : 0;
+
+    policy.for_each_band(height, width * 4, [&](size_t first, size_t last)
+    {
+        _priv::remap_rows(src, width, pixel_size, read, tree, spread, indices, first, last);
+    });
+
+    return true;
+}
+
+} // namespace raw
+} // namespace pixel
+} // namespace vx
@@ -4,17 +4,23 @@
 #include <cstring>
 #include <vector>
 
+#include "vertex/pixel/execution_policy.hpp"
+
 namespace vx {
 namespace pixel {
 namespace raw {
 
+// Every transform writes each destination row from its own band of rows, so
+// the result is the same for every execution policy.
+
 ///////////////////////////////////////////////////////////////////////////////
 // copy
 ///////////////////////////////////////////////////////////////////////////////
 
 inline bool copy(
     const uint8_t* src, size_t src_width, size_t src_height,
-    uint8_t* dst, size_t pixel_size
+    uint8_t* dst, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
 )
 {
     if (!src || !dst)
@@ -22,7 +28,13 @@ inline bool copy(
         return false;
     }
 
-    std::memcpy(dst, src, src_width * src_height * pixel_size);
+    const size_t rowsz = src_width * pixel_size;
+
+    policy.for_each_band(src_height, rowsz, [&](size_t first, size_t last)
+    {
+        std::memcpy(&dst[first * rowsz], &src[first * rowsz], (last - first) * rowsz);
+    });
+
     return true;
 }
 
@@ -30,37 +42,44 @@ inline bool copy(
 // flip_x
 ///////////////////////////////////////////////////////////////////////////////
 
-inline bool flip_x(uint8_t* data, size_t width, size_t height, size_t pixel_size)
+inline bool flip_x(
+    uint8_t* data, size_t width, size_t height, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
+)
 {
     if (!data)
     {
         return false;
     }
 
-    for (size_t y = 0; y < height; ++y)
+    policy.for_each_band(height, width * pixel_size, [&](size_t first, size_t last)
     {
-        uint8_t* row = &data[width * y * pixel_size];
-
-        for (size_t x = 0; x < width / 2; ++x)
+        for (size_t y = first; y < last; ++y)
         {
-            uint8_t* srcpx = &row[x * pixel_size];
-            uint8_t* dstpx = &row[(width - x - 1) * pixel_size];
+            uint8_t* row = &data[width * y * pixel_size];
 
-            for (size_t z = 0; z < pixel_size; ++z)
+            for (size_t x = 0; x < width / 2; ++x)
             {
-                const uint8_t tmp = srcpx[z];
-                srcpx[z] = dstpx[z];
-                dstpx[z] = tmp;
+                uint8_t* srcpx = &row[x * pixel_size];
+                uint8_t* dstpx = &row[(width - x - 1) * pixel_size];
+
+                for (size_t z = 0; z < pixel_size; ++z)
+                {
+                    const uint8_t tmp = srcpx[z];
+                    srcpx[z] = dstpx[z];
+                    dstpx[z] = tmp;
+                }
             }
         }
-    }
+    });
 
     return true;
 }
 
 inline bool flip_x(
     const uint8_t* src, size_t src_width, size_t src_height,
-    uint8_t* dst, size_t pixel_size
+    uint8_t* dst, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
 )
 {
     if (!src || !dst)
@@ -68,18 +87,21 @@ inline bool flip_x(
         return false;
     }
 
-    for (size_t y = 0; y < src_height; ++y)
+    policy.for_each_band(src_height, src_width * pixel_size, [&](size_t first, size_t last)
     {
-        const uint8_t* srcrow = &src[src_width * y * pixel_size];
-        uint8_t* dstrow = &dst[src_width * y * pixel_size];
-
-        for (size_t x = 0; x < src_width; ++x)
+        for (size_t y = first; y < last; ++y)
         {
-            const uint8_t* srcpx = &srcrow[x * pixel_size];
-            uint8_t* dstpx = &dstrow[(src_width - x - 1) * pixel_size];
-            std::memcpy(dstpx, srcpx, pixel_size);
+            const uint8_t* srcrow = &src[src_width * y * pixel_size];
+            uint8_t* dstrow = &dst[src_width * y * pixel_size];
+
+            for (size_t x = 0; x < src_width; ++x)
+            {
+                const uint8_t* srcpx = &srcrow[x * pixel_size];
+                uint8_t* dstpx = &dstrow[(src_width - x - 1) * pixel_size];
+                std::memcpy(dstpx, srcpx, pixel_size);
+            }
         }
-    }
+    });
 
     return true;
 }
@@ -88,7 +110,10 @@ inline bool flip_x(
 // flip_y
 ///////////////////////////////////////////////////////////////////////////////
 
-inline bool flip_y(uint8_t* data, size_t width, size_t height, size_t pixel_size)
+inline bool flip_y(
+    uint8_t* data, size_t width, size_t height, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
+)
 {
     if (!data)
     {
@@ -96,24 +121,30 @@ inline bool flip_y(uint8_t* data, size_t width, size_t height, size_t pixel_size
     }
 
     const size_t rowsz = width * pixel_size;
-    std::vector<uint8_t> tmp_row(rowsz);
 
-    for (size_t y = 0; y < height / 2; ++y)
+    // each band swaps its rows in the top half with their mirrors
+    policy.for_each_band(height / 2, rowsz * 2, [&](size_t first, size_t last)
     {
-        uint8_t* row1 = &data[y * rowsz];
-        uint8_t* row2 = &data[(height - y - 1) * rowsz];
+        std::vector<uint8_t> tmp_row(rowsz);
 
-        std::memcpy(tmp_row.data(), row1, rowsz);
-        std::memcpy(row1, row2, rowsz);
-        std::memcpy(row2, tmp_row.data(), rowsz);
-    }
+        for (size_t y = first; y < last; ++y)
+        {
+            uint8_t* row1 = &data[y * rowsz];
+            uint8_t* row2 = &data[(height - y - 1) * rowsz];
+
+            std::memcpy(tmp_row.data(), row1, rowsz);
+            std::memcpy(row1, row2, rowsz);
+            std::memcpy(row2, tmp_row.data(), rowsz);
+        }
+    });
 
     return true;
 }
 
 inline bool flip_y(
     const uint8_t* src, size_t src_width, size_t src_height,
-    uint8_t* dst, size_t pixel_size
+    uint8_t* dst, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
 )
 {
     if (!src || !dst)
@@ -123,47 +154,133 @@ inline bool flip_y(
 
     const size_t rowsz = src_width * pixel_size;
 
-    for (size_t y = 0; y < src_height; ++y)
+    policy.for_each_band(src_height, rowsz, [&](size_t first, size_t last)
     {
-        const uint8_t* srcrow = &src[src_width * y * pixel_size];
-        uint8_t* dstrow = &dst[src_width * (src_height - y - 1) * pixel_size];
-        std::memcpy(dstrow, srcrow, rowsz);
-    }
+        for (size_t y = first; y < last; ++y)
+        {
+            const uint8_t* srcrow = &src[src_width * y * pixel_size];
+            uint8_t* dstrow = &dst[src_width * (src_height - y - 1) * pixel_size];
+            std::memcpy(dstrow, srcrow, rowsz);
+        }
+    });
 
     return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// rotate_90_cw
+// rotate_90
 ///////////////////////////////////////////////////////////////////////////////
 
-inline bool rotate_90_cw(
+namespace _priv {
+
+// Side of the square tiles rotate_90 is done in. A tile row is about two
+// cache lines, so the source rows of a tile and the destination rows it is
+// written to stay in the L1 cache together and neither side is walked with
+// a stride wider than a tile.
+inline size_t rotate_tile_size(size_t pixel_size) noexcept
+{
+    const size_t tile = 128 / pixel_size;
+    return (tile < 8) ? 8 : (tile > 64) ? 64 : tile;
+}
+
+// PIXEL_SIZE is 0 when the size is only known at run time
+template <size_t PIXEL_SIZE>
+VX_FORCE_INLINE void copy_pixel(uint8_t* dst, const uint8_t* src, size_t pixel_size) noexcept
+{
+    std::memcpy(dst, src, PIXEL_SIZE ? PIXEL_SIZE : pixel_size);
+}
+
+// Rotates the source rows [first, last) a tile at a time. Inside a tile
+// each destination row is written in one pass while the source column it
+// comes from is read out of the tile rows already in cache.
+template <size_t PIXEL_SIZE, bool CW>
+inline void rotate_90_rows(
     const uint8_t* src, size_t src_width, size_t src_height,
-    uint8_t* dst, size_t pixel_size
-)
+    uint8_t* dst, size_t pixel_size,
+    size_t first, size_t last, size_t tile
+) noexcept
 {
-    if (!src || !dst)
+    const size_t src_stride = src_width * pixel_size;
+    const size_t dst_stride = src_height * pixel_size;
+
+    for (size_t ty = first; ty < last; ty += tile)
     {
-        return false;
+        const size_t tyend = (last - ty > tile) ? ty + tile : last;
+
+        for (size_t tx = 0; tx < src_width; tx += tile)
+        {
+            const size_t txend = (src_width - tx > tile) ? tx + tile : src_width;
+
+            for (size_t x = tx; x < txend; ++x)
+            {
+                // source column x is destination row x clockwise and
+                // width - x - 1 counter clockwise
+                uint8_t* dstrow = &dst[(CW ? x : src_width - x - 1) * dst_stride];
+                const uint8_t* srcpx = &src[ty * src_stride + x * pixel_size];
+
+                for (size_t y = ty; y < tyend; ++y, srcpx += src_stride)
+                {
+                    copy_pixel<PIXEL_SIZE>(&dstrow[(CW ? src_height - y - 1 : y) * pixel_size], srcpx, pixel_size);
+                }
+            }
+        }
     }
+}
 
-    for (size_t y = 0; y < src_height; ++y)
+template <bool CW>
+inline void rotate_90(
+    const uint8_t* src, size_t src_width, size_t src_height,
+    uint8_t* dst, size_t pixel_size,
+    const execution_policy& policy
+)
+{
+    const size_t tile = rotate_tile_size(pixel_size);
+    const size_t tile_rows = (src_height + tile - 1) / tile;
+
+    // bands are whole tile rows so no tile is split between threads
+    policy.for_each_band(tile_rows, tile * src_width * pixel_size, [&](size_t first, size_t last)
     {
-        const uint8_t* srcrow = &src[src_width * y * pixel_size];
-        uint8_t* dstcol = &dst[(src_height - y - 1) * pixel_size];
+        const size_t y0 = first * tile;
+        const size_t y1 = (last * tile < src_height) ? last * tile : src_height;
 
-        for (size_t x = 0; x < src_width; ++x)
+        switch (pixel_size)
         {
-            const uint8_t* srcpx = &srcrow[x * pixel_size];
-            uint8_t* dstpx = &dstcol[x * src_height * pixel_size];
-            std::memcpy(dstpx, srcpx, pixel_size);
+            case 1:  rotate_90_rows<1, CW>(src, src_width, src_height, dst, pixel_size, y0, y1, tile); break;
+            case 2:  rotate_90_rows<2, CW>(src, src_width, src_height, dst, pixel_size, y0, y1, tile); break;
+            case 3:  rotate_90_rows<3, CW>(src, src_width, src_height, dst, pixel_size, y0, y1, tile); break;
+            case 4:  rotate_90_rows<4, CW>(src, src_width, src_height, dst, pixel_size, y0, y1, tile); break;
+            case 8:  rotate_90_rows<8, CW>(src, src_width, src_height, dst, pixel_size, y0, y1, tile); break;
+            case 16: rotate_90_rows<16, CW>(src, src_width, src_height, dst, pixel_size, y0, y1, tile); break;
+            default: rotate_90_rows<0, CW>(src, src_width, src_height, dst, pixel_size, y0, y1, tile); break;
         }
+    });
+}
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+// rotate_90_cw
+///////////////////////////////////////////////////////////////////////////////
+
+inline bool rotate_90_cw(
+    const uint8_t* src, size_t src_width, size_t src_height,
+    uint8_t* dst, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
+)
+{
+    if (!src || !dst)
+    {
+        return false;
     }
 
+    _priv::rotate_90<true>(src, src_width, src_height, dst, pixel_size, policy);
     return true;
 }
 
-inline bool rotate_90_cw(uint8_t* data, size_t width, size_t height, size_t pixel_size)
+inline bool rotate_90_cw(
+    uint8_t* data, size_t width, size_t height, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
+)
 {
     if (!data)
     {
@@ -171,7 +288,7 @@ inline bool rotate_90_cw(uint8_t* data, size_t width, size_t height, size_t pixe
     }
 
     std::vector<uint8_t> dst(width * height * pixel_size);
-    rotate_90_cw(data, width, height, dst.data(), pixel_size);
+    rotate_90_cw(data, width, height, dst.data(), pixel_size, policy);
     std::move(dst.begin(), dst.end(), data);
 
     return true;
@@ -183,7 +300,8 @@ inline bool rotate_90_cw(uint8_t* data, size_t width, size_t height, size_t pixe
 
 inline bool rotate_90_ccw(
     const uint8_t* src, size_t src_width, size_t src_height,
-    uint8_t* dst, size_t pixel_size
+    uint8_t* dst, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
 )
 {
     if (!src || !dst)
@@ -191,23 +309,14 @@ inline bool rotate_90_ccw(
         return false;
     }
 
-    for (size_t y = 0; y < src_height; ++y)
-    {
-        const uint8_t* srcrow = &src[src_width * y * pixel_size];
-        uint8_t* dstcol = &dst[y * pixel_size];
-
-        for (size_t x = 0; x < src_width; ++x)
-        {
-            const uint8_t* srcpx = &srcrow[(src_width - x - 1) * pixel_size];
-            uint8_t* dstpx = &dstcol[x * src_height * pixel_size];
-            std::memcpy(dstpx, srcpx, pixel_size);
-        }
-    }
-
+    _priv::rotate_90<false>(src, src_width, src_height, dst, pixel_size, policy);
     return true;
 }
 
-inline bool rotate_90_ccw(uint8_t* data, size_t width, size_t height, size_t pixel_size)
+inline bool rotate_90_ccw(
+    uint8_t* data, size_t width, size_t height, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
+)
 {
     if (!data)
     {
@@ -215,7 +324,7 @@ inline bool rotate_90_ccw(uint8_t* data, size_t width, size_t height, size_t pix
     }
 
     std::vector<uint8_t> dst(width * height * pixel_size);
-    rotate_90_ccw(data, width, height, dst.data(), pixel_size);
+    rotate_90_ccw(data, width, height, dst.data(), pixel_size, policy);
     std::move(dst.begin(), dst.end(), data);
 
     return true;
@@ -225,31 +334,38 @@ inline bool rotate_90_ccw(uint8_t* data, size_t width, size_t height, size_t pix
 // rotate_180
 ///////////////////////////////////////////////////////////////////////////////
 
-inline bool rotate_180(uint8_t* data, size_t width, size_t height, size_t pixel_size)
+inline bool rotate_180(
+    uint8_t* data, size_t width, size_t height, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
+)
 {
     if (!data)
     {
         return false;
     }
 
-    for (size_t y = 0; y < height / 2; ++y)
+    // each band swaps its rows in the top half with their mirrors
+    policy.for_each_band(height / 2, width * pixel_size * 2, [&](size_t first, size_t last)
     {
-        uint8_t* srcrow = &data[width * y * pixel_size];
-        uint8_t* dstrow = &data[width * (height - y - 1) * pixel_size];
-
-        for (size_t x = 0; x < width; ++x)
+        for (size_t y = first; y < last; ++y)
         {
-            uint8_t* srcpx = &srcrow[x * pixel_size];
-            uint8_t* dstpx = &dstrow[(width - x - 1) * pixel_size];
+            uint8_t* srcrow = &data[width * y * pixel_size];
+            uint8_t* dstrow = &data[width * (height - y - 1) * pixel_size];
 
-            for (size_t z = 0; z < pixel_size; ++z)
+            for (size_t x = 0; x < width; ++x)
             {
-                const uint8_t tmp = srcpx[z];
-                srcpx[z] = dstpx[z];
-                dstpx[z] = tmp;
+                uint8_t* srcpx = &srcrow[x * pixel_size];
+                uint8_t* dstpx = &dstrow[(width - x - 1) * pixel_size];
+
+                for (size_t z = 0; z < pixel_size; ++z)
+                {
+                    const uint8_t tmp = srcpx[z];
+                    srcpx[z] = dstpx[z];
+                    dstpx[z] = tmp;
+                }
             }
         }
-    }
+    });
 
     if (height % 2)
     {
@@ -274,7 +390,8 @@ inline bool rotate_180(uint8_t* data, size_t width, size_t height, size_t pixel_
 
 inline bool rotate_180(
     const uint8_t* src, size_t src_width, size_t src_height,
-    uint8_t* dst, size_t pixel_size
+    uint8_t* dst, size_t pixel_size,
+    const execution_policy& policy = execution_policy()
 )
 {
     if (!src || !dst)
@@ -282,18 +399,21 @@ inline bool rotate_180(
         return false;
     }
 
-    for (size_t y = 0; y < src_height; ++y)
+    policy.for_each_band(src_height, src_width * pixel_size, [&](size_t first, size_t last)
     {
-        const uint8_t* srcrow = &src[src_width * y * pixel_size];
-        uint8_t* dstrow = &dst[src_width * (src_height - y - 1) * pixel_size];
-
-        for (size_t x = 0; x < src_width; ++x)
+        for (size_t y = first; y < last; ++y)
         {
-            const uint8_t* srcpx = &srcrow[x * pixel_size];
-            uint8_t* dstpx = &dstrow[(src_width - x - 1) * pixel_size];
-            std::memcpy(dstpx, srcpx, pixel_size);
+            const uint8_t* srcrow = &src[src_width * y * pixel_size];
+            uint8_t* dstrow = &dst[src_width * (src_height - y - 1) * pixel_size];
+
+            for (size_t x = 0; x < src_width; ++x)
+            {
+                const uint8_t* srcpx = &srcrow[x * pixel_size];
+                uint8_t* dstpx = &dstrow[(src_width - x - 1) * pixel_size];
+                std::memcpy(dstpx, srcpx, pixel_size);
+            }
         }
-    }
+    });
 
     return true;
 }
@@ -306,7 +426,8 @@ template <typename U>
 inline bool crop(
     const uint8_t* src, size_t src_width, size_t src_height,
     uint8_t* dst, size_t pixel_size,
-    U area_x, U area_y, U area_width, U area_height
+    U area_x, U area_y, U area_width, U area_height,
+    const execution_policy& policy = execution_policy()
 )
 {
     if (!src || !dst)
@@ -321,22 +442,21 @@ inline bool crop(
         return false;
     }
 
-    for (size_t y = 0; y < static_cast<size_t>(area_height); ++y)
-    {
-        const uint8_t* srcrow = &src[src_width * (static_cast<size_t>(area_y) + y) * pixel_size];
-        uint8_t* dstrow = &dst[static_cast<size_t>(area_width) * y * pixel_size];
+    // the rows of the area are contiguous in the source
+    const size_t rowsz = static_cast<size_t>(area_width) * pixel_size;
 
-        for (size_t x = 0; x < static_cast<size_t>(area_width); ++x)
+    policy.for_each_band(static_cast<size_t>(area_height), rowsz, [&](size_t first, size_t last)
+    {
+        for (size_t y = first; y < last; ++y)
         {
-            const uint8_t* srcpx = &srcrow[(static_cast<size_t>(area_x) + x) * pixel_size];
-            uint8_t* dstpx = &dstrow[x * pixel_size];
-            std::memcpy(dstpx, srcpx, pixel_size);
+            const uint8_t* srcrow = &src[src_width * (static_cast<size_t>(area_y) + y) * pixel_size];
+            std::memcpy(&dst[rowsz * y], &srcrow[static_cast<size_t>(area_x) * pixel_size], rowsz);
         }
-    }
+    });
 
     return true;
 }
 
-}
-}
-}
\ No newline at end of file
+} // namespace raw
+} // namespace pixel
+} // namespace vx
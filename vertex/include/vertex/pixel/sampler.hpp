@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vertex/pixel/surface.hpp"
+#include "vertex/pixel/filter/filter_resample.hpp"
 #include "vertex/math/procedural/wrap.hpp"
 
 namespace vx {
@@ -43,7 +44,7 @@ public:
     template <pixel_format F>
     math::color sample(const surface<F>& surf, float u, float v) const
     {
-        if (surf.empty() || surf.unknown_format())
+        if (surf.empty())
         {
             return border;
         }
@@ -58,9 +59,9 @@ public:
 
         switch (current_filter)
         {
-            case filter_mode::NEAREST:  return sample_nearest(surf, size, u, v);
-            case filter_mode::LINEAR:   return sample_bilinear(surf, size, u, v);
-            default:                    return border;
+            case filter_mode::nearest:  return sample_nearest(surf, size, u, v);
+            case filter_mode::linear:   return (sample_pixel_area < 1.0f) ? sample_kernel(surf, size, u, v, current_filter) : sample_bilinear(surf, size, u, v);
+            default:                    return sample_kernel(surf, size, u, v, current_filter);
         }
     }
 
@@ -151,6 +152,52 @@ private:
 
         return samp;
     }
+
+    // Weights the pixels around the sample with one of the resampling
+    // kernels. When a sample covers more than a pixel the kernel is stretched
+    // over the covered area, like filter_resample does when downscaling.
+    template <pixel_format F>
+    math::color sample_kernel(const surface<F>& surf, const math::vec2i& size, float u, float v, filter_mode filter) const
+    {
+        const filter::resample_kernel kernel = filter::get_resample_kernel(filter);
+
+        const float xscale = math::max(1.0f / resolution.x, 1.0f);
+        const float yscale = math::max(1.0f / resolution.y, 1.0f);
+
+        const float xsupport = kernel.support * xscale;
+        const float ysupport = kernel.support * yscale;
+
+        const int32_t x0 = static_cast<int32_t>(math::floor(u - xsupport));
+        const int32_t x1 = static_cast<int32_t>(math::ceil(u + xsupport));
+        const int32_t y0 = static_cast<int32_t>(math::floor(v - ysupport));
+        const int32_t y1 = static_cast<int32_t>(math::ceil(v + ysupport));
+
+        math::color samp(0.0f, 0.0f, 0.0f, 0.0f);
+        float total = 0.0f;
+
+        for (int32_t y = y0; y <= y1; ++y)
+        {
+            const float wy = kernel.function((static_cast<float>(y) + 0.5f - v) / yscale);
+            if (wy == 0.0f)
+            {
+                continue;
+            }
+
+            for (int32_t x = x0; x <= x1; ++x)
+            {
+                const float w = wy * kernel.function((static_cast<float>(x) + 0.5f - u) / xscale);
+                if (w == 0.0f)
+                {
+                    continue;
+                }
+
+                samp += get_pixel(surf, size, x, y) * w;
+                total += w;
+            }
+        }
+
+        return (total != 0.0f) ? samp / total : sample_nearest(surf, size, u, v);
+    }
 };
 
 } // namespace pixel
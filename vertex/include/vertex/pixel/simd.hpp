@@ -0,0 +1,24 @@
+#pragma once
+
+#include "vertex/config/simd.hpp"
+
+#if defined(VX_SIMD_X86) && (VX_SIMD_X86 >= VX_SIMD_X86_SSE2_VERSION)
+#   define VX_PIXEL_SIMD_SSE2
+#   include <emmintrin.h>
+#endif
+
+#if defined(VX_SIMD_X86) && (VX_SIMD_X86 >= VX_SIMD_X86_SSSE3_VERSION)
+#   define VX_PIXEL_SIMD_SSSE3
+#   include <tmmintrin.h>
+#endif
+
+#if defined(VX_SIMD_X86) && (VX_SIMD_X86 >= VX_SIMD_X86_AVX2_VERSION)
+#   define VX_PIXEL_SIMD_AVX2
+#   include <immintrin.h>
+#endif
+
+// byte table lookups need the 64 bit instruction set
+#if defined(VX_SIMD_ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#   define VX_PIXEL_SIMD_NEON
+#   include <arm_neon.h>
+#endif
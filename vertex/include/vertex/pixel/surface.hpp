@@ -2,12 +2,13 @@
 
 #include <cstring>
 #include <memory>
-#include <unordered_set>
 
 #include "vertex/pixel/palette.hpp"
+#include "vertex/pixel/raw_convert.hpp"
 #include "vertex/pixel/iterator.hpp"
 #include "vertex/math/rect.hpp"
 #include "vertex/math/color/util/hash.hpp"
+#include "vertex/std/set.hpp"
 
 namespace vx {
 namespace pixel {
@@ -180,20 +181,8 @@ public:
 
         surface<F2> converted(m_width, m_height);
 
-        VX_IF_CONSTEXPR(F == F2)
-        {
-            std::memcpy(converted.m_data.get(), m_data.get(), data_size());
-        }
-        else
-        {
-            for (size_t y = 0; y < m_height; ++y)
-            {
-                for (size_t x = 0; x < m_width; ++x)
-                {
-                    converted.set_pixel(x, y, get_pixel(x, y));
-                }
-            }
-        }
+        // rows are contiguous, so the whole surface is converted as one row
+        raw::convert_row<F, F2>(data(), converted.data(), pixel_count());
 
         return converted;
     }
@@ -204,14 +193,38 @@ public:
 
     palette generate_palette() const
     {
-        std::unordered_set<color_type> colors;
+        const size_t count = pixel_count();
+        hash_set<color_type> colors;
+
+        VX_IF_CONSTEXPR (sizeof(raw_pixel_type) <= sizeof(uint64_t))
+        {
+            // Deduplicate the raw pixel bits first so only unique pixels are
+            // decoded. Different bits can still decode to the same color
+            // (padding bits in x formats), so the colors are deduplicated
+            // again afterwards.
+            hash_set<uint64_t> pixels;
 
-        for (size_t y = 0; y < m_height; ++y)
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint64_t bits = 0;
+                std::memcpy(&bits, &m_data[i], sizeof(raw_pixel_type));
+                pixels.insert(bits);
+            }
+
+            colors.reserve(pixels.size());
+
+            for (const uint64_t bits : pixels)
+            {
+                raw_pixel_type px;
+                std::memcpy(&px, &bits, sizeof(raw_pixel_type));
+                colors.insert(static_cast<color_type>(px));
+            }
+        }
+        else
         {
-            for (size_t x = 0; x < m_width; ++x)
+            for (size_t i = 0; i < count; ++i)
             {
-                const color_type c = get_pixel(x, y);
-                colors.insert(c);
+                colors.insert(static_cast<color_type>(m_data[i]));
             }
         }
 
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "vertex/pixel/surface.hpp"
+#include "vertex/pixel/execution_policy.hpp"
 
 #include "vertex/pixel/raw_transform.hpp"
 #include "vertex/pixel/filter/filter_nearest.hpp"
-#include "vertex/pixel/filter/filter_bilinear.hpp"
+#include "vertex/pixel/filter/filter_resample.hpp"
 
 #include "vertex/math/core/functions/exponential.hpp"
 #include "vertex/math/geometry/2d/functions/collision.hpp"
@@ -13,15 +14,18 @@ namespace vx {
 namespace pixel {
 namespace transform {
 
+// Every operation takes an execution policy, the result is the same with
+// any of them.
+
 ///////////////////////////////////////////////////////////////////////////////
 // copy
 ///////////////////////////////////////////////////////////////////////////////
 
 template <pixel_format F>
-inline surface<F> copy(const surface<F>& surf)
+inline surface<F> copy(const surface<F>& surf, const execution_policy& policy = execution_policy())
 {
-    surface<F> out = surf;
-    copy_raw(out.data(), out.width(), out.height(), out.data(), out.pixel_size());
+    surface<F> out(surf.width(), surf.height());
+    raw::copy(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size(), policy);
     return out;
 }
 
@@ -30,18 +34,18 @@ inline surface<F> copy(const surface<F>& surf)
 ///////////////////////////////////////////////////////////////////////////////
 
 template <pixel_format F>
-inline surface<F> flip_x(const surface<F>& surf)
+inline surface<F> flip_x(const surface<F>& surf, const execution_policy& policy = execution_policy())
 {
-    surface<F> out = surf;
-    flip_x_raw(out.data(), out.width(), out.height(), out.pixel_size());
+    surface<F> out(surf.width(), surf.height());
+    raw::flip_x(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size(), policy);
     return out;
 }
 
 template <pixel_format F>
-inline surface<F> flip_y(const surface<F>& surf)
+inline surface<F> flip_y(const surface<F>& surf, const execution_policy& policy = execution_policy())
 {
-    surface<F> out = surf;
-    flip_y_raw(out.data(), out.width(), out.height(), out.pixel_size());
+    surface<F> out(surf.width(), surf.height());
+    raw::flip_y(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size(), policy);
     return out;
 }
 
@@ -50,26 +54,26 @@ inline surface<F> flip_y(const surface<F>& surf)
 ///////////////////////////////////////////////////////////////////////////////
 
 template <pixel_format F>
-inline surface<F> rotate_90_cw(const surface<F>& surf)
+inline surface<F> rotate_90_cw(const surface<F>& surf, const execution_policy& policy = execution_policy())
 {
     surface<F> out(surf.height(), surf.width());
-    rotate_90_cw_raw(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size());
+    raw::rotate_90_cw(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size(), policy);
     return out;
 }
 
 template <pixel_format F>
-inline surface<F> rotate_90_ccw(const surface<F>& surf)
+inline surface<F> rotate_90_ccw(const surface<F>& surf, const execution_policy& policy = execution_policy())
 {
     surface<F> out(surf.height(), surf.width());
-    rotate_90_ccw_raw(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size());
+    raw::rotate_90_ccw(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size(), policy);
     return out;
 }
 
 template <pixel_format F>
-inline surface<F> rotate_180(const surface<F>& surf)
+inline surface<F> rotate_180(const surface<F>& surf, const execution_policy& policy = execution_policy())
 {
-    surface<F> out = surf;
-    rotate_180_raw(out.data(), out.width(), out.height(), out.pixel_size());
+    surface<F> out(surf.width(), surf.height());
+    raw::rotate_180(surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size(), policy);
     return out;
 }
 
@@ -78,14 +82,15 @@ inline surface<F> rotate_180(const surface<F>& surf)
 ///////////////////////////////////////////////////////////////////////////////
 
 template <pixel_format F>
-inline surface<F> crop(const surface<F>& surf, const math::recti& area)
+inline surface<F> crop(const surface<F>& surf, const math::recti& area, const execution_policy& policy = execution_policy())
 {
     const math::recti cropped = math::g2::crop(surf.get_rect(), area);
     surface<F> out(cropped.size.x, cropped.size.y);
 
-    crop_raw(
+    raw::crop(
         surf.data(), surf.width(), surf.height(), out.data(), surf.pixel_size(),
-        cropped.position.x, cropped.position.y, cropped.size.x, cropped.size.y
+        cropped.position.x, cropped.position.y, cropped.size.x, cropped.size.y,
+        policy
     );
 
     return out;
@@ -96,49 +101,28 @@ inline surface<F> crop(const surface<F>& surf, const math::recti& area)
 ///////////////////////////////////////////////////////////////////////////////
 
 template <pixel_format F>
-inline surface<F> resize(const surface<F>& surf, const math::vec2i& size, filter_mode filter)
+inline surface<F> resize(const surface<F>& surf, const math::vec2i& size, filter_mode filter, const execution_policy& policy = execution_policy())
 {
     surface<F> out(size.x, size.y);
 
     switch (filter)
     {
-        case filter_mode::NEAREST:
+        case filter_mode::nearest:
         {
             filter::filter_nearest(
                 surf.data(), surf.width(), surf.height(),
                 out.data(), out.width(), out.height(),
-                surf.pixel_size()
+                surf.pixel_size(), policy
             );
             break;
         }
-        case filter_mode::LINEAR:
-        {
-            VX_IF_CONSTEXPR(is_packed_format(F))
-            {
-                constexpr const auto masks = build_mask_array(F);
-                constexpr const auto shifts = build_shift_array(F);
-
-                using pixel_type = typename surface<F>::pixel_type;
-                filter::filter_bilinear<pixel_type>(
-                    surf.data(), surf.width(), surf.height(),
-                    out.data(), out.width(), out.height(),
-                    surf.channels(), masks, shifts
-                );
-            }
-            else
-            {
-                using channel_type = typename surface<F>::channel_type;
-                filter::filter_bilinear<channel_type>(
-                    surf.data(), surf.width(), surf.height(),
-                    out.data(), out.width(), out.height(),
-                    surf.channels()
-                );
-            }
-
-            break;
-        }
         default:
         {
+            filter::filter_resample<F>(
+                surf.data(), surf.width(), surf.height(),
+                out.data(), out.width(), out.height(),
+                filter, policy
+            );
             break;
         }
     }
@@ -147,44 +131,63 @@ inline surface<F> resize(const surface<F>& surf, const math::vec2i& size, filter
 }
 
 template <pixel_format F>
-inline surface<F> resize(const surface<F>& surf, const math::vec2i& size)
+inline surface<F> resize(const surface<F>& surf, const math::vec2i& size, const execution_policy& policy = execution_policy())
 {
     const float pixel_area = (
         (static_cast<float>(size.x) / static_cast<float>(surf.width())) *
         (static_cast<float>(size.y) / static_cast<float>(surf.height()))
     );
 
-    const filter_mode filter = (pixel_area < 1.0f) ? filter_mode::NEAREST : filter_mode::LINEAR;
-    return resize(surf, size, filter);
+    // averaging the covered area keeps downscales from aliasing
+    const filter_mode filter = (pixel_area < 1.0f) ? filter_mode::box : filter_mode::linear;
+    return resize(surf, size, filter, policy);
 }
 
 template <pixel_format F>
-inline surface<F> resize_canvas(const surface<F>& surf, const math::vec2i& size, const math::vec2i& offset, const math::color& fill = math::color(0))
+inline surface<F> resize_canvas(
+    const surface<F>& surf, const math::vec2i& size, const math::vec2i& offset,
+    const math::color& fill = math::color(0), const execution_policy& policy = execution_policy()
+)
 {
+    using raw_pixel_type = typename surface<F>::raw_pixel_type;
+
     surface<F> out(size.x, size.y);
 
-    const math::recti src_area = math::g2::move(surf.get_rect(), offset.x, offset.y);
+    // the part of the canvas covered by the surface
+    const math::recti area = math::g2::crop(out.get_rect(), math::g2::move(surf.get_rect(), offset.x, offset.y));
+    const raw_pixel_type fill_pixel(fill);
 
-    for (size_t y = 0; y < out.height(); ++y)
+    const size_t x0 = static_cast<size_t>(area.position.x);
+    const size_t x1 = x0 + static_cast<size_t>(area.size.x);
+    const size_t y0 = static_cast<size_t>(area.position.y);
+    const size_t y1 = y0 + static_cast<size_t>(area.size.y);
+
+    policy.for_each_band(out.height(), out.width() * out.pixel_size(), [&](size_t first, size_t last)
     {
-        for (size_t x = 0; x < out.width(); ++x)
+        for (size_t y = first; y < last; ++y)
         {
-            if (math::g2::contains(src_area, math::vec2i(x, y)))
-            {
-                out.set_pixel(x, y, surf.get_pixel(x - offset.x, y - offset.y));
-            }
-            else
+            raw_pixel_type* row = &out.at(0, y);
+
+            if (y < y0 || y >= y1 || x0 == x1)
             {
-                out.set_pixel(x, y, fill);
+                std::fill(row, row + out.width(), fill_pixel);
+                continue;
             }
+
+            std::fill(row, row + x0, fill_pixel);
+            std::memcpy(row + x0, &surf.at(x0 - offset.x, y - offset.y), (x1 - x0) * surf.pixel_size());
+            std::fill(row + x1, row + out.width(), fill_pixel);
         }
-    }
+    });
 
     return out;
 }
 
 template <pixel_format F>
-inline surface<F> resize_pow2(const surface<F>& surf, bool square = false, filter_mode filter = filter_mode::LINEAR)
+inline surface<F> resize_pow2(
+    const surface<F>& surf, bool square = false,
+    filter_mode filter = filter_mode::linear, const execution_policy& policy = execution_policy()
+)
 {
     size_t w = math::next_pow2(surf.width());
     size_t h = math::next_pow2(surf.height());
@@ -194,7 +197,7 @@ inline surface<F> resize_pow2(const surface<F>& surf, bool square = false, filte
         w = h = math::max(w, h);
     }
 
-    return resize(surf, math::vec2i(w, h), filter);
+    return resize(surf, math::vec2i(w, h), filter, policy);
 }
 
 } // namespace transform
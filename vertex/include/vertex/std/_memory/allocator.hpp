@@ -131,6 +131,18 @@ using aligned_allocator = default_allocator<T, ideal_align, alignment_policy::ex
 template <size_t Alignment = alignof(unsigned char), alignment_policy Policy = alignment_policy::at_least>
 using byte_allocator = default_allocator<unsigned char, Alignment, Policy>;
 
+//=========================================================================
+// allocator stats
+//=========================================================================
+
+// usage reported by the stateful allocators (arena, fixed_pool)
+struct allocator_stats
+{
+    size_t bytes_in_use = 0;    // bytes currently handed out
+    size_t high_water_mark = 0; // peak of bytes_in_use
+    size_t bytes_reserved = 0;  // bytes held from the system
+};
+
 //=========================================================================
 // allocator rebinding
 //=========================================================================
@@ -141,5 +153,42 @@ struct rebind_allocator
     using type = typename Allocator::template rebind<U>::other;
 };
 
+//=========================================================================
+// sized reallocate
+//=========================================================================
+
+namespace _priv {
+
+template <typename Allocator, typename = void>
+struct has_sized_reallocate : std::false_type
+{};
+
+template <typename Allocator>
+struct has_sized_reallocate<Allocator, type_traits::void_t<decltype(std::declval<Allocator&>().reallocate(
+    std::declval<typename Allocator::pointer_type>(), size_t(), size_t()))>> : std::true_type
+{};
+
+template <typename Allocator>
+typename Allocator::pointer_type allocator_reallocate(Allocator& alloc, typename Allocator::pointer_type ptr, size_t old_count, size_t count, std::true_type) noexcept
+{
+    return alloc.reallocate(ptr, old_count, count);
+}
+
+template <typename Allocator>
+typename Allocator::pointer_type allocator_reallocate(Allocator& alloc, typename Allocator::pointer_type ptr, size_t, size_t count, std::false_type) noexcept
+{
+    return alloc.reallocate(ptr, count);
+}
+
+} // namespace _priv
+
+// Allocators that need the old count to move or free a block (pool_allocator)
+// provide reallocate(ptr, old_count, count), the others only take the new count.
+template <typename Allocator>
+VX_NO_DISCARD typename Allocator::pointer_type allocator_reallocate(Allocator& alloc, typename Allocator::pointer_type ptr, size_t old_count, size_t count) noexcept
+{
+    return _priv::allocator_reallocate(alloc, ptr, old_count, count, _priv::has_sized_reallocate<Allocator>{});
+}
+
 } // namespace mem
 } // namespace vx
@@ -0,0 +1,492 @@
+#pragma once
+
+#include "vertex/std/_memory/allocator.hpp"
+
+namespace vx {
+namespace mem {
+
+//=========================================================================
+// arena
+//=========================================================================
+
+// Bump pointer allocator over a chain of blocks. Freeing the most recent
+// allocation gives its memory back, everything else is reclaimed at once by
+// reset() or rewind(), which keep the blocks around for reuse.
+//
+// Each allocation is prefixed by its size so that reallocate can copy
+// without help from the caller. Not thread safe.
+class arena
+{
+public:
+
+    static constexpr size_t default_block_size = 64 * 1024;
+
+    // position to rewind to, see mark()
+    struct marker
+    {
+        void* blk;
+        unsigned char* cursor;
+        size_t bytes_in_use;
+    };
+
+    explicit arena(const size_t block_size = default_block_size) noexcept
+        : m_block_size(block_size)
+    {}
+
+    ~arena()
+    {
+        release();
+    }
+
+    // allocators refer to the arena by address, so it must stay put
+    arena(const arena&) = delete;
+    arena(arena&&) = delete;
+    arena& operator=(const arena&) = delete;
+    arena& operator=(arena&&) = delete;
+
+public:
+
+    //=========================================================================
+    // allocation
+    //=========================================================================
+
+    VX_ALLOCATOR VX_NO_DISCARD void* allocate(const size_t bytes, size_t alignment = max_align) noexcept
+    {
+        VX_ASSERT(_mem_priv::is_pow_2(alignment));
+
+        VX_UNLIKELY_COLD_PATH(bytes == 0,
+            {
+                return nullptr;
+            });
+
+        alignment = (std::max)(alignment, alignof(size_header));
+
+        unsigned char* ptr = bump(bytes, alignment);
+        if (!ptr)
+        {
+            ptr = allocate_slow(bytes, alignment);
+
+            VX_UNLIKELY_COLD_PATH(!ptr,
+                {
+                    return nullptr;
+                });
+        }
+
+        write_size(ptr, bytes);
+        add_in_use(bytes);
+        return ptr;
+    }
+
+    VX_NO_DISCARD void* reallocate(void* ptr, const size_t bytes, const size_t alignment = max_align) noexcept
+    {
+        if (!ptr)
+        {
+            return allocate(bytes, alignment);
+        }
+
+        if (bytes == 0)
+        {
+            deallocate(ptr, 0);
+            return nullptr;
+        }
+
+        unsigned char* const p = static_cast<unsigned char*>(ptr);
+        const size_t size = read_size(p);
+
+        // the most recent allocation can grow or shrink in place
+        if (p + size == m_cursor && bytes <= static_cast<size_t>(m_end - p))
+        {
+            m_cursor = p + bytes;
+            write_size(p, bytes);
+
+            m_stats.bytes_in_use -= size;
+            add_in_use(bytes);
+            return p;
+        }
+
+        void* new_ptr = allocate(bytes, alignment);
+
+        VX_UNLIKELY_COLD_PATH(!new_ptr,
+            {
+                return nullptr;
+            });
+
+        mem::copy(new_ptr, ptr, (std::min)(size, bytes));
+        deallocate(ptr, size);
+        return new_ptr;
+    }
+
+    void deallocate(void* ptr, VX_MAYBE_UNUSED const size_t bytes) noexcept
+    {
+        if (!ptr)
+        {
+            return;
+        }
+
+        unsigned char* const p = static_cast<unsigned char*>(ptr);
+        const size_t size = read_size(p);
+        m_stats.bytes_in_use -= size;
+
+        if (p + size == m_cursor)
+        {
+            m_cursor = p - sizeof(size_header);
+        }
+    }
+
+    //=========================================================================
+    // reset
+    //=========================================================================
+
+    // reclaims every allocation in O(1), blocks are kept for reuse
+    void reset() noexcept
+    {
+        use_block(m_head);
+        m_stats.bytes_in_use = 0;
+    }
+
+    marker mark() const noexcept
+    {
+        return marker{ m_current, m_cursor, m_stats.bytes_in_use };
+    }
+
+    // reclaims every allocation made since m was taken
+    void rewind(const marker& m) noexcept
+    {
+        if (!m.blk)
+        {
+            reset();
+            return;
+        }
+
+        use_block(static_cast<block*>(m.blk));
+        m_cursor = m.cursor;
+        m_stats.bytes_in_use = m.bytes_in_use;
+    }
+
+    // returns all blocks to the system
+    void release() noexcept
+    {
+        block* blk = m_head;
+        while (blk)
+        {
+            block* const next = blk->next;
+            mem::deallocate(blk, block_header_size + blk->size);
+            blk = next;
+        }
+
+        m_head = nullptr;
+        use_block(nullptr);
+
+        m_stats.bytes_in_use = 0;
+        m_stats.bytes_reserved = 0;
+    }
+
+    //=========================================================================
+    // stats
+    //=========================================================================
+
+    const allocator_stats& stats() const noexcept
+    {
+        return m_stats;
+    }
+
+    size_t block_size() const noexcept
+    {
+        return m_block_size;
+    }
+
+private:
+
+    struct block
+    {
+        block* next;
+        size_t size; // usable bytes following the header
+    };
+
+    using size_header = size_t;
+
+    // keeps block data aligned to max_align
+    static constexpr size_t block_header_size = _mem_priv::align_up(sizeof(block), max_align);
+
+    static unsigned char* block_begin(block* blk) noexcept
+    {
+        return reinterpret_cast<unsigned char*>(blk) + block_header_size;
+    }
+
+    static size_t read_size(const unsigned char* ptr) noexcept
+    {
+        size_header size;
+        mem::copy(&size, ptr - sizeof(size_header), sizeof(size_header));
+        return size;
+    }
+
+    static void write_size(unsigned char* ptr, size_t size) noexcept
+    {
+        mem::copy(ptr - sizeof(size_header), &size, sizeof(size_header));
+    }
+
+    void add_in_use(const size_t bytes) noexcept
+    {
+        m_stats.bytes_in_use += bytes;
+        m_stats.high_water_mark = (std::max)(m_stats.high_water_mark, m_stats.bytes_in_use);
+    }
+
+    void use_block(block* blk) noexcept
+    {
+        m_current = blk;
+        m_cursor = blk ? block_begin(blk) : nullptr;
+        m_end = blk ? block_begin(blk) + blk->size : nullptr;
+    }
+
+    unsigned char* bump(const size_t bytes, const size_t alignment) noexcept
+    {
+        if (!m_cursor)
+        {
+            return nullptr;
+        }
+
+        const uintptr_t start = reinterpret_cast<uintptr_t>(m_cursor) + sizeof(size_header);
+        const uintptr_t aligned = _mem_priv::align_up(start, alignment);
+        const uintptr_t end = reinterpret_cast<uintptr_t>(m_end);
+
+        if (aligned > end || bytes > end - aligned)
+        {
+            return nullptr;
+        }
+
+        unsigned char* const ptr = m_cursor + (aligned - reinterpret_cast<uintptr_t>(m_cursor));
+        m_cursor = ptr + bytes;
+        return ptr;
+    }
+
+    unsigned char* allocate_slow(const size_t bytes, const size_t alignment) noexcept
+    {
+        // worst case padding when starting from a fresh block
+        const size_t overhead = block_header_size + sizeof(size_header) + alignment;
+
+        VX_UNLIKELY_COLD_PATH(bytes > std::numeric_limits<size_t>::max() - overhead,
+            {
+                return nullptr;
+            });
+
+        const size_t required = bytes + sizeof(size_header) + alignment;
+
+        // blocks kept from before the last reset come first
+        if (m_current && m_current->next && m_current->next->size >= required)
+        {
+            use_block(m_current->next);
+            return bump(bytes, alignment);
+        }
+
+        const size_t size = (std::max)(m_block_size, required);
+        block* const blk = static_cast<block*>(mem::allocate(block_header_size + size));
+
+        VX_UNLIKELY_COLD_PATH(!blk,
+            {
+                return nullptr;
+            });
+
+        blk->size = size;
+
+        if (m_current)
+        {
+            blk->next = m_current->next;
+            m_current->next = blk;
+        }
+        else
+        {
+            blk->next = m_head;
+            m_head = blk;
+        }
+
+        m_stats.bytes_reserved += block_header_size + size;
+
+        use_block(blk);
+        return bump(bytes, alignment);
+    }
+
+private:
+
+    block* m_head = nullptr;
+    block* m_current = nullptr;
+    unsigned char* m_cursor = nullptr;
+    unsigned char* m_end = nullptr;
+    size_t m_block_size;
+    allocator_stats m_stats;
+};
+
+//=========================================================================
+// arena_allocator
+//=========================================================================
+
+// Container allocator that draws from an arena. Copies and rebinds share the
+// arena, which must outlive every container using it.
+template <typename T>
+class arena_allocator
+{
+public:
+
+    using value_type = T;
+    using pointer_type = value_type*;
+
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = arena_allocator<U>;
+    };
+
+    explicit arena_allocator(arena& a) noexcept
+        : m_arena(&a)
+    {}
+
+    arena_allocator(const arena_allocator&) noexcept = default;
+    arena_allocator(arena_allocator&&) noexcept = default;
+    arena_allocator& operator=(const arena_allocator&) noexcept = default;
+    arena_allocator& operator=(arena_allocator&&) noexcept = default;
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) noexcept
+        : m_arena(other.resource())
+    {}
+
+    friend bool operator==(const arena_allocator& lhs, const arena_allocator& rhs) noexcept
+    {
+        return lhs.m_arena == rhs.m_arena;
+    }
+
+    friend bool operator!=(const arena_allocator& lhs, const arena_allocator& rhs) noexcept
+    {
+        return lhs.m_arena != rhs.m_arena;
+    }
+
+    arena* resource() const noexcept
+    {
+        return m_arena;
+    }
+
+    static constexpr size_type max_size() noexcept
+    {
+        return max_array_size<T>();
+    }
+
+    VX_ALLOCATOR VX_NO_DISCARD pointer_type allocate(const size_t count) noexcept
+    {
+        return static_cast<pointer_type>(m_arena->allocate(count * sizeof(value_type), alignof(value_type)));
+    }
+
+    VX_NO_DISCARD pointer_type reallocate(pointer_type ptr, const size_t count) noexcept
+    {
+        return static_cast<pointer_type>(m_arena->reallocate(ptr, count * sizeof(value_type), alignof(value_type)));
+    }
+
+    void deallocate(pointer_type ptr, const size_t count) noexcept
+    {
+        m_arena->deallocate(ptr, count * sizeof(value_type));
+    }
+
+private:
+
+    arena* m_arena;
+};
+
+//=========================================================================
+// scratch arena
+//=========================================================================
+
+// Per thread arena for short lived temporaries. Memory is handed back by a
+// scratch_scope, or all at once with scratch_arena().reset().
+inline arena& scratch_arena() noexcept
+{
+    static thread_local arena s_scratch_arena;
+    return s_scratch_arena;
+}
+
+// rewinds the scratch arena to where it was when the scope was entered
+class scratch_scope
+{
+public:
+
+    scratch_scope() noexcept
+        : m_marker(scratch_arena().mark())
+    {}
+
+    ~scratch_scope()
+    {
+        scratch_arena().rewind(m_marker);
+    }
+
+    scratch_scope(const scratch_scope&) = delete;
+    scratch_scope& operator=(const scratch_scope&) = delete;
+
+private:
+
+    arena::marker m_marker;
+};
+
+// Stateless allocator for the calling thread's scratch arena, so containers
+// can use it without passing an allocator around. Containers must not
+// outlive the enclosing scratch_scope or move to another thread.
+template <typename T>
+class scratch_allocator
+{
+public:
+
+    using value_type = T;
+    using pointer_type = value_type*;
+
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = scratch_allocator<U>;
+    };
+
+    scratch_allocator() noexcept = default;
+
+    scratch_allocator(const scratch_allocator&) noexcept = default;
+    scratch_allocator(scratch_allocator&&) noexcept = default;
+    scratch_allocator& operator=(const scratch_allocator&) noexcept = default;
+    scratch_allocator& operator=(scratch_allocator&&) noexcept = default;
+
+    template <typename U>
+    scratch_allocator(const scratch_allocator<U>&) noexcept
+    {}
+
+    friend bool operator==(const scratch_allocator&, const scratch_allocator&) noexcept
+    {
+        return true;
+    }
+
+    friend bool operator!=(const scratch_allocator&, const scratch_allocator&) noexcept
+    {
+        return false;
+    }
+
+    static constexpr size_type max_size() noexcept
+    {
+        return max_array_size<T>();
+    }
+
+    VX_ALLOCATOR static VX_NO_DISCARD pointer_type allocate(const size_t count) noexcept
+    {
+        return static_cast<pointer_type>(scratch_arena().allocate(count * sizeof(value_type), alignof(value_type)));
+    }
+
+    static VX_NO_DISCARD pointer_type reallocate(pointer_type ptr, const size_t count) noexcept
+    {
+        return static_cast<pointer_type>(scratch_arena().reallocate(ptr, count * sizeof(value_type), alignof(value_type)));
+    }
+
+    static void deallocate(pointer_type ptr, const size_t count) noexcept
+    {
+        scratch_arena().deallocate(ptr, count * sizeof(value_type));
+    }
+};
+
+} // namespace mem
+} // namespace vx
@@ -35,6 +35,12 @@ constexpr bool is_pow_2(const size_t x) noexcept
     return x != 0 && (x & (x - 1)) == 0;
 }
 
+// alignment must be a power of 2
+constexpr size_t align_up(const size_t x, const size_t alignment) noexcept
+{
+    return (x + alignment - 1) & ~(alignment - 1);
+}
+
 enum : size_t
 {
 #if defined(__MINGW32__) && !defined(__MINGW64__)
@@ -474,7 +480,7 @@ bool is_all_bits_zero(const T& x) noexcept
     else
     {
         constexpr T zero{};
-        return compare(&x, &zero, sizeof(T)) == 0;
+        return mem::compare(&x, &zero, sizeof(T)) == 0;
     }
 }
 
@@ -513,7 +519,7 @@ T* construct_range_maybe_trivial(T* ptr, size_t count)
 template <typename T>
 T* destroy_range(T* ptr, size_t count) noexcept
 {
-    VX_IF_CONSTEXPR (!std::is_trivially_destructible<T>::value)
+    VX_IF_CONSTEXPR (std::is_trivially_destructible<T>::value)
     {
         return ptr + count;
     }
@@ -551,7 +557,7 @@ constexpr T* fill_range(T* ptr, size_t count, const U& value)
     VX_IF_CONSTEXPR ((type_traits::is_fill_memset_safe<T*, U>::value))
     {
         // can optimize with memset
-        set(ptr, static_cast<int>(value), bytes);
+        mem::set(ptr, static_cast<int>(value), bytes);
         return ptr + count;
     }
     else
@@ -560,7 +566,7 @@ constexpr T* fill_range(T* ptr, size_t count, const U& value)
         {
             if (_mem_priv::is_all_bits_zero(value))
             {
-                set(ptr, 0, bytes);
+                mem::set(ptr, 0, bytes);
                 return ptr + count;
             }
         }
@@ -583,7 +589,7 @@ T* fill_uninitialized_range(T* ptr, size_t count, const U& value)
     VX_IF_CONSTEXPR ((type_traits::is_fill_memset_safe<T*, U>::value))
     {
         // can optimize with memset
-        set(ptr, static_cast<int>(value), bytes);
+        mem::set(ptr, static_cast<int>(value), bytes);
         return ptr + count;
     }
     else
@@ -592,7 +598,7 @@ T* fill_uninitialized_range(T* ptr, size_t count, const U& value)
         {
             if (_mem_priv::is_all_bits_zero(value))
             {
-                set(ptr, 0, bytes);
+                mem::set(ptr, 0, bytes);
                 return ptr + count;
             }
         }
@@ -618,7 +624,7 @@ IT fill_range(IT first, IT last, const U& value)
     VX_IF_CONSTEXPR ((type_traits::is_fill_memset_safe<IT, U>::value))
     {
         // can optimize with memset
-        set(first, value, bytes);
+        mem::set(first, value, bytes);
         return last;
     }
     else
@@ -627,7 +633,7 @@ IT fill_range(IT first, IT last, const U& value)
         {
             if (_mem_priv::is_all_bits_zero(value))
             {
-                set(first, 0, bytes);
+                mem::set(first, 0, bytes);
                 return last;
             }
         }
@@ -649,7 +655,7 @@ constexpr T* copy_range(T* dst, const T* src, size_t count)
     if (!VX_IS_CONSTANT_EVALUATED() && type_traits::memmove_is_safe<T*>::value)
     {
         const size_t bytes = count * sizeof(T);
-        copy(dst, src, bytes);
+        mem::copy(dst, src, bytes);
         return dst + count;
     }
     else
@@ -671,7 +677,7 @@ T* copy_uninitialized_range(T* dst, const T* src, size_t count)
     VX_IF_CONSTEXPR (type_traits::memmove_is_safe<T*>::value)
     {
         const size_t bytes = count * sizeof(T);
-        copy(dst, src, bytes);
+        mem::copy(dst, src, bytes);
         return dst + count;
     }
     else
@@ -697,7 +703,7 @@ IT1 copy_range(IT1 dst, IT2 first, IT2 last)
     {
         const size_t count = static_cast<size_t>(std::distance(first, last));
         const size_t bytes = count * sizeof(T);
-        copy(dst, first, bytes);
+        mem::copy(dst, first, bytes);
         return dst + count;
     }
     else
@@ -724,7 +730,7 @@ IT1 copy_uninitialized_range(IT1 dst, IT2 first, IT2 last)
     {
         const size_t count = static_cast<size_t>(std::distance(first, last));
         const size_t bytes = count * sizeof(T);
-        copy(dst, first, bytes);
+        mem::copy(dst, first, bytes);
         return dst + count;
     }
     else
@@ -749,7 +755,7 @@ constexpr T* move_range(T* dst, T* src, size_t count) noexcept
     if (!VX_IS_CONSTANT_EVALUATED() && type_traits::memmove_is_safe<T*>::value)
     {
         const size_t bytes = count * sizeof(T);
-        move(dst, src, bytes);
+        mem::move(dst, src, bytes);
         return dst + count;
     }
     else
@@ -770,8 +776,13 @@ T* move_uninitialized_range(T* dst, T* src, size_t count) noexcept
 {
     VX_IF_CONSTEXPR (type_traits::memmove_is_safe<T*>::value)
     {
-        const size_t bytes = count * sizeof(T);
-        move(dst, src, bytes);
+        // src may be null when count is 0 (an empty container growing), and
+        // passing null to memmove lets the compiler drop later null checks
+        if (count)
+        {
+            mem::move(dst, src, count * sizeof(T));
+        }
+
         return dst + count;
     }
     else
@@ -796,7 +807,7 @@ IT1 move_range(IT1 dst, IT2 first, IT2 last)
     {
         const size_t count = static_cast<size_t>(std::distance(first, last));
         const size_t bytes = count * sizeof(T);
-        move(dst, first, bytes);
+        mem::move(dst, first, bytes);
         return dst + count;
     }
     else
@@ -820,7 +831,7 @@ IT1 move_uninitialized_range(IT1 dst, IT2 first, IT2 last)
     {
         const size_t count = static_cast<size_t>(last - first);
         const size_t bytes = count * sizeof(T);
-        move(dst, first, bytes);
+        mem::move(dst, first, bytes);
         return dst + count;
     }
     else
@@ -843,7 +854,7 @@ constexpr T* copy_move_range(T* dst, const T* src, size_t count)
     if (!VX_IS_CONSTANT_EVALUATED() && type_traits::memmove_is_safe<T*>::value)
     {
         const size_t bytes = count * sizeof(T);
-        move(dst, src, bytes);
+        mem::move(dst, src, bytes);
         return dst + count;
     }
     else
@@ -865,7 +876,7 @@ T* copy_move_uninitialized_range(T* dst, const T* src, size_t count)
     VX_IF_CONSTEXPR (type_traits::memmove_is_safe<T*>::value)
     {
         const size_t bytes = count * sizeof(T);
-        move(dst, src, bytes);
+        mem::move(dst, src, bytes);
         return dst + count;
     }
     else
@@ -891,7 +902,7 @@ IT1 copy_move_range(IT1 dst, IT2 first, IT2 last)
     {
         const size_t count = static_cast<size_t>(std::distance(first, last));
         const size_t bytes = count * sizeof(T);
-        move(dst, first, bytes);
+        mem::move(dst, first, bytes);
         return dst + count;
     }
     else
@@ -918,7 +929,7 @@ IT1 copy_move_uninitialized_range(IT1 dst, IT2 first, IT2 last)
     {
         const size_t count = static_cast<size_t>(std::distance(first, last));
         const size_t bytes = count * sizeof(T);
-        copy(dst, first, bytes);
+        mem::copy(dst, first, bytes);
         return dst + count;
     }
     else
@@ -945,7 +956,7 @@ T* shift_forward_range(T* first, T* last, const size_t count) noexcept
     VX_IF_CONSTEXPR (type_traits::memmove_is_safe<T*>::value)
     {
         const size_t bytes = num_elements * sizeof(T);
-        move(first + count, first, bytes);
+        mem::move(first + count, first, bytes);
         return first + count;
     }
     else
@@ -970,7 +981,7 @@ T* shift_backward_range(T* first, T* last, const size_t count) noexcept
     VX_IF_CONSTEXPR (type_traits::memmove_is_safe<T*>::value)
     {
         const size_t bytes = num_elements * sizeof(T);
-        move(first - count, first, bytes);
+        mem::move(first - count, first, bytes);
         return last - count;
     }
     else
@@ -1006,9 +1017,9 @@ T* swap_range(T* a, T* b, size_t count) noexcept
             const size_t current_chunk = std::min(count, elements_per_block);
             const size_t current_bytes = current_chunk * sizeof(T);
 
-            move(temp_buffer, a, current_bytes);
-            move(a, b, current_bytes);
-            move(b, temp_buffer, current_bytes);
+            mem::move(temp_buffer, a, current_bytes);
+            mem::move(a, b, current_bytes);
+            mem::move(b, temp_buffer, current_bytes);
 
             a += current_chunk;
             b += current_chunk;
@@ -1054,7 +1065,7 @@ IT1 swap_range(IT1 first1, IT1 last1, IT2 first2)
 template <typename T>
 int compare_range(const T* a, const T* b, size_t count)
 {
-    return compare(a, b, count * sizeof(T));
+    return mem::compare(a, b, count * sizeof(T));
 }
 
 template <typename T>
@@ -41,22 +41,22 @@ constexpr VX_NO_DISCARD T&& forward(
 
 template <typename T>
 constexpr void swap(T& a, T& b) noexcept(
-    noexcept(T(move(a))) &&
-    noexcept(a = move(b)) &&
-    noexcept(b = move(a)))
+    noexcept(T(mem::move(a))) &&
+    noexcept(a = mem::move(b)) &&
+    noexcept(b = mem::move(a)))
 {
-    T tmp = move(a);
-    a = move(b);
-    b = move(tmp);
+    T tmp = mem::move(a);
+    a = mem::move(b);
+    b = mem::move(tmp);
 }
 
 template <typename T, typename U = T>
 constexpr VX_NO_DISCARD T exchange(T& obj, U&& new_value) noexcept(
-    noexcept(T(move(obj))) &&
-    noexcept(obj = forward<U>(new_value)))
+    noexcept(T(mem::move(obj))) &&
+    noexcept(obj = mem::forward<U>(new_value)))
 {
-    T old_value = move(obj);
-    obj = forward<U>(new_value);
+    T old_value = mem::move(obj);
+    obj = mem::forward<U>(new_value);
     return old_value;
 }
 
@@ -0,0 +1,355 @@
+#pragma once
+
+#include "vertex/std/_memory/allocator.hpp"
+
+namespace vx {
+namespace mem {
+
+//=========================================================================
+// fixed_pool
+//=========================================================================
+
+// Fixed size block allocator. Blocks are carved out of slabs and recycled
+// through an intrusive free list, so allocation and deallocation are O(1).
+//
+// If no block size is given, the first single object request decides it.
+// That way a pool_allocator rebound to a container's node type pools exactly
+// those nodes. Not thread safe.
+class fixed_pool
+{
+public:
+
+    static constexpr size_t default_blocks_per_slab = 64;
+
+    explicit fixed_pool(const size_t block_size = 0, const size_t blocks_per_slab = default_blocks_per_slab) noexcept
+        : m_blocks_per_slab(blocks_per_slab ? blocks_per_slab : 1)
+    {
+        if (block_size)
+        {
+            set_block_layout(block_size, alignof(free_node));
+        }
+    }
+
+    ~fixed_pool()
+    {
+        release();
+    }
+
+    // allocators refer to the pool by address, so it must stay put
+    fixed_pool(const fixed_pool&) = delete;
+    fixed_pool(fixed_pool&&) = delete;
+    fixed_pool& operator=(const fixed_pool&) = delete;
+    fixed_pool& operator=(fixed_pool&&) = delete;
+
+public:
+
+    //=========================================================================
+    // allocation
+    //=========================================================================
+
+    // true if requests of this size and alignment are served by the pool,
+    // sets the block size if it has not been decided yet
+    bool accepts(const size_t bytes, const size_t alignment) noexcept
+    {
+        if (m_block_size == 0)
+        {
+            if (alignment > max_align)
+            {
+                return false;
+            }
+
+            set_block_layout(bytes, alignment);
+        }
+
+        return bytes <= m_block_size && alignment <= m_block_align;
+    }
+
+    VX_ALLOCATOR VX_NO_DISCARD void* allocate() noexcept
+    {
+        VX_ASSERT(m_block_size != 0);
+
+        if (!m_free)
+        {
+            VX_UNLIKELY_COLD_PATH(!allocate_slab(),
+                {
+                    return nullptr;
+                });
+        }
+
+        free_node* const node = m_free;
+        m_free = node->next;
+
+        m_stats.bytes_in_use += m_block_size;
+        m_stats.high_water_mark = (std::max)(m_stats.high_water_mark, m_stats.bytes_in_use);
+        return node;
+    }
+
+    void deallocate(void* ptr) noexcept
+    {
+        if (!ptr)
+        {
+            return;
+        }
+
+        VX_ASSERT(owns(ptr));
+
+        free_node* const node = static_cast<free_node*>(ptr);
+        node->next = m_free;
+        m_free = node;
+
+        m_stats.bytes_in_use -= m_block_size;
+    }
+
+    // linear in the number of slabs
+    bool owns(const void* ptr) const noexcept
+    {
+        const unsigned char* const p = static_cast<const unsigned char*>(ptr);
+
+        for (const slab* s = m_slabs; s; s = s->next)
+        {
+            const unsigned char* const first = slab_begin(s);
+            if (p >= first && p < first + slab_data_size())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // returns all slabs to the system, every block must have been freed
+    void release() noexcept
+    {
+        VX_ASSERT(m_stats.bytes_in_use == 0);
+
+        slab* s = m_slabs;
+        while (s)
+        {
+            slab* const next = s->next;
+            mem::deallocate(s, slab_header_size + slab_data_size());
+            s = next;
+        }
+
+        m_slabs = nullptr;
+        m_free = nullptr;
+        m_stats.bytes_reserved = 0;
+    }
+
+    //=========================================================================
+    // stats
+    //=========================================================================
+
+    const allocator_stats& stats() const noexcept
+    {
+        return m_stats;
+    }
+
+    size_t block_size() const noexcept
+    {
+        return m_block_size;
+    }
+
+private:
+
+    struct free_node
+    {
+        free_node* next;
+    };
+
+    struct slab
+    {
+        slab* next;
+    };
+
+    // keeps the first block of each slab aligned to max_align
+    static constexpr size_t slab_header_size = _mem_priv::align_up(sizeof(slab), max_align);
+
+    static unsigned char* slab_begin(slab* s) noexcept
+    {
+        return reinterpret_cast<unsigned char*>(s) + slab_header_size;
+    }
+
+    static const unsigned char* slab_begin(const slab* s) noexcept
+    {
+        return reinterpret_cast<const unsigned char*>(s) + slab_header_size;
+    }
+
+    size_t slab_data_size() const noexcept
+    {
+        return m_block_size * m_blocks_per_slab;
+    }
+
+    void set_block_layout(const size_t bytes, const size_t alignment) noexcept
+    {
+        // blocks must be able to hold a free list link while unused
+        m_block_align = (std::max)(alignment, alignof(free_node));
+        m_block_size = _mem_priv::align_up((std::max)(bytes, sizeof(free_node)), m_block_align);
+    }
+
+    bool allocate_slab() noexcept
+    {
+        const size_t data_size = slab_data_size();
+        slab* const s = static_cast<slab*>(mem::allocate(slab_header_size + data_size));
+
+        VX_UNLIKELY_COLD_PATH(!s,
+            {
+                return false;
+            });
+
+        s->next = m_slabs;
+        m_slabs = s;
+        m_stats.bytes_reserved += slab_header_size + data_size;
+
+        // thread the new blocks onto the free list in address order
+        unsigned char* const first = slab_begin(s);
+        for (size_t i = m_blocks_per_slab; i > 0; --i)
+        {
+            free_node* const node = reinterpret_cast<free_node*>(first + (i - 1) * m_block_size);
+            node->next = m_free;
+            m_free = node;
+        }
+
+        return true;
+    }
+
+private:
+
+    slab* m_slabs = nullptr;
+    free_node* m_free = nullptr;
+    size_t m_block_size = 0;
+    size_t m_block_align = 0;
+    size_t m_blocks_per_slab;
+    allocator_stats m_stats;
+};
+
+//=========================================================================
+// pool_allocator
+//=========================================================================
+
+// Container allocator that serves single object requests (list and tree
+// nodes) from a fixed_pool. Array requests, or objects that do not fit the
+// pool's block size, fall through to the default allocator. Copies and
+// rebinds share the pool, which must outlive every container using it.
+template <typename T>
+class pool_allocator
+{
+public:
+
+    using value_type = T;
+    using pointer_type = value_type*;
+
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = pool_allocator<U>;
+    };
+
+    explicit pool_allocator(fixed_pool& pool) noexcept
+        : m_pool(&pool)
+    {}
+
+    pool_allocator(const pool_allocator&) noexcept = default;
+    pool_allocator(pool_allocator&&) noexcept = default;
+    pool_allocator& operator=(const pool_allocator&) noexcept = default;
+    pool_allocator& operator=(pool_allocator&&) noexcept = default;
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept
+        : m_pool(other.resource())
+    {}
+
+    friend bool operator==(const pool_allocator& lhs, const pool_allocator& rhs) noexcept
+    {
+        return lhs.m_pool == rhs.m_pool;
+    }
+
+    friend bool operator!=(const pool_allocator& lhs, const pool_allocator& rhs) noexcept
+    {
+        return lhs.m_pool != rhs.m_pool;
+    }
+
+    fixed_pool* resource() const noexcept
+    {
+        return m_pool;
+    }
+
+    static constexpr size_type max_size() noexcept
+    {
+        return max_array_size<T>();
+    }
+
+    VX_ALLOCATOR VX_NO_DISCARD pointer_type allocate(const size_t count) noexcept
+    {
+        if (is_pooled(count))
+        {
+            return static_cast<pointer_type>(m_pool->allocate());
+        }
+
+        return fallback_type::allocate(count);
+    }
+
+    // the old count tells whether ptr came from the pool and how to free it,
+    // containers pass it through mem::allocator_reallocate
+    VX_NO_DISCARD pointer_type reallocate(pointer_type ptr, const size_t old_count, const size_t count) noexcept
+    {
+        const bool was_pooled = ptr && is_pooled(old_count);
+        const bool pooled = is_pooled(count);
+
+        if (!was_pooled && !pooled)
+        {
+            return fallback_type::reallocate(ptr, count);
+        }
+
+        if (was_pooled && pooled)
+        {
+            return ptr;
+        }
+
+        // moving between the pool and the fallback, one of the counts is 1
+        pointer_type new_ptr = allocate(count);
+
+        VX_UNLIKELY_COLD_PATH(!new_ptr,
+            {
+                return nullptr;
+            });
+
+        if (ptr)
+        {
+            mem::copy(static_cast<void*>(new_ptr), static_cast<const void*>(ptr), sizeof(value_type));
+            deallocate(ptr, old_count);
+        }
+
+        return new_ptr;
+    }
+
+    void deallocate(pointer_type ptr, const size_t count) noexcept
+    {
+        if (is_pooled(count))
+        {
+            m_pool->deallocate(ptr);
+        }
+        else
+        {
+            fallback_type::deallocate(ptr, count);
+        }
+    }
+
+private:
+
+    using fallback_type = default_allocator<T>;
+
+    bool is_pooled(const size_t count) const noexcept
+    {
+        return count == 1 && m_pool->accepts(sizeof(value_type), alignof(value_type));
+    }
+
+private:
+
+    fixed_pool* m_pool;
+};
+
+} // namespace mem
+} // namespace vx
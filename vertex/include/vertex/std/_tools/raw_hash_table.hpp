@@ -0,0 +1,1321 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "vertex/config/language_config.hpp"
+#include "vertex/config/simd.hpp"
+#include "vertex/std/_memory/allocator.hpp"
+#include "vertex/std/_tools/compressed_pair.hpp"
+#include "vertex/std/expected.hpp"
+#include "vertex/std/hash.hpp"
+#include "vertex/util/bit/bit.hpp"
+#include "vertex/util/bit/endian.hpp"
+
+// Vector group probing is available on x86 with at least SSE2 and on little
+// endian arm with NEON, everything else uses the portable 8 byte group
+#if defined(VX_SIMD_X86) && (VX_SIMD_X86 >= VX_SIMD_X86_SSE2_VERSION)
+    #define VX_HASH_TABLE_USE_SSE2 1
+    #define VX_HASH_TABLE_USE_NEON 0
+    #include <emmintrin.h>
+#elif defined(VX_SIMD_ARM_NEON) && (VX_ORDER_NATIVE_ENDIAN == VX_ORDER_LITTLE_ENDIAN)
+    #define VX_HASH_TABLE_USE_SSE2 0
+    #define VX_HASH_TABLE_USE_NEON 1
+    #include <arm_neon.h>
+#else
+    #define VX_HASH_TABLE_USE_SSE2 0
+    #define VX_HASH_TABLE_USE_NEON 0
+#endif
+
+// Open addressing hash table in the style of the swiss tables described here:
+// https://abseil.io/about/design/swisstables
+//
+// The table is a single allocation holding one control byte per slot followed
+// by the slots themselves. A control byte is either one of the special values
+// below or, for a full slot, the low 7 bits of the hash (h2). Lookups compare a
+// whole group of control bytes against h2 at once, so most misses are resolved
+// without touching the slots and most hits touch exactly one slot.
+
+namespace vx {
+namespace _hash_table_priv {
+
+//=========================================================================
+// control bytes
+//=========================================================================
+
+using ctrl_type = int8_t;
+
+enum : ctrl_type
+{
+    ctrl_empty = -128,   // 0b10000000
+    ctrl_deleted = -2,   // 0b11111110
+    ctrl_sentinel = -1,  // 0b11111111
+};
+
+inline bool is_full(const ctrl_type c) noexcept
+{
+    return c >= 0;
+}
+
+inline bool is_empty(const ctrl_type c) noexcept
+{
+    return c == ctrl_empty;
+}
+
+inline bool is_deleted(const ctrl_type c) noexcept
+{
+    return c == ctrl_deleted;
+}
+
+inline bool is_empty_or_deleted(const ctrl_type c) noexcept
+{
+    return c < ctrl_sentinel;
+}
+
+// the high bits select the starting group, the low 7 bits are stored in the
+// control byte to filter candidates
+inline size_t h1(const size_t hash) noexcept
+{
+    return hash >> 7;
+}
+
+inline ctrl_type h2(const size_t hash) noexcept
+{
+    return static_cast<ctrl_type>(hash & 0x7F);
+}
+
+//=========================================================================
+// bitmask
+//=========================================================================
+
+// Mask of matching positions within a group. Each position occupies
+// (1 << Shift) bits, only the highest of which may be set.
+template <typename T, int Width, int Shift>
+class bitmask
+{
+public:
+
+    explicit bitmask(const T mask) noexcept
+        : m_mask(mask)
+    {}
+
+    explicit operator bool() const noexcept
+    {
+        return m_mask != 0;
+    }
+
+    void clear_lowest() noexcept
+    {
+        m_mask &= (m_mask - 1);
+    }
+
+    size_t lowest_bit_set() const noexcept
+    {
+        return static_cast<size_t>(bit::countr_zero(m_mask)) >> Shift;
+    }
+
+    size_t trailing_zeros() const noexcept
+    {
+        return static_cast<size_t>(bit::countr_zero(m_mask)) >> Shift;
+    }
+
+    size_t leading_zeros() const noexcept
+    {
+        constexpr int extra_bits = static_cast<int>(sizeof(T) * 8) - (Width << Shift);
+        return static_cast<size_t>(bit::countl_zero(static_cast<T>(m_mask << extra_bits))) >> Shift;
+    }
+
+private:
+
+    T m_mask;
+};
+
+//=========================================================================
+// groups
+//=========================================================================
+
+#if VX_HASH_TABLE_USE_SSE2
+
+struct group_sse2
+{
+    static constexpr size_t width = 16;
+    using mask_type = bitmask<uint32_t, 16, 0>;
+
+    explicit group_sse2(const ctrl_type* pos) noexcept
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+    {}
+
+    mask_type match(const ctrl_type hash) const noexcept
+    {
+        const __m128i m = _mm_set1_epi8(static_cast<char>(hash));
+        return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(m, ctrl))));
+    }
+
+    mask_type match_empty() const noexcept
+    {
+        const __m128i m = _mm_set1_epi8(static_cast<char>(ctrl_empty));
+        return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(m, ctrl))));
+    }
+
+    mask_type match_empty_or_deleted() const noexcept
+    {
+        const __m128i s = _mm_set1_epi8(static_cast<char>(ctrl_sentinel));
+        return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(s, ctrl))));
+    }
+
+    size_t count_leading_empty_or_deleted() const noexcept
+    {
+        const __m128i s = _mm_set1_epi8(static_cast<char>(ctrl_sentinel));
+        const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(s, ctrl)));
+        // bits above the group width are always zero so this tops out at 16
+        return static_cast<size_t>(bit::countr_one(mask));
+    }
+
+    __m128i ctrl;
+};
+
+using group = group_sse2;
+
+#elif VX_HASH_TABLE_USE_NEON
+
+struct group_neon
+{
+    static constexpr size_t width = 8;
+    using mask_type = bitmask<uint64_t, 8, 3>;
+
+    static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+    explicit group_neon(const ctrl_type* pos) noexcept
+        : ctrl(vld1_u8(reinterpret_cast<const uint8_t*>(pos)))
+    {}
+
+    mask_type match(const ctrl_type hash) const noexcept
+    {
+        const uint8x8_t m = vceq_u8(ctrl, vdup_n_u8(static_cast<uint8_t>(hash)));
+        return mask_type(vget_lane_u64(vreinterpret_u64_u8(m), 0) & msbs);
+    }
+
+    mask_type match_empty() const noexcept
+    {
+        const uint8x8_t m = vceq_s8(vdup_n_s8(ctrl_empty), vreinterpret_s8_u8(ctrl));
+        return mask_type(vget_lane_u64(vreinterpret_u64_u8(m), 0) & msbs);
+    }
+
+    mask_type match_empty_or_deleted() const noexcept
+    {
+        const uint8x8_t m = vcgt_s8(vdup_n_s8(ctrl_sentinel), vreinterpret_s8_u8(ctrl));
+        return mask_type(vget_lane_u64(vreinterpret_u64_u8(m), 0) & msbs);
+    }
+
+    size_t count_leading_empty_or_deleted() const noexcept
+    {
+        const uint8x8_t m = vcgt_s8(vdup_n_s8(ctrl_sentinel), vreinterpret_s8_u8(ctrl));
+        const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(m), 0);
+        return static_cast<size_t>(bit::countr_one(mask)) >> 3;
+    }
+
+    uint8x8_t ctrl;
+};
+
+using group = group_neon;
+
+#else
+
+// https://github.com/abseil/abseil-cpp/blob/master/absl/container/internal/raw_hash_set.h
+struct group_portable
+{
+    static constexpr size_t width = 8;
+    using mask_type = bitmask<uint64_t, 8, 3>;
+
+    static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+    static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+    explicit group_portable(const ctrl_type* pos) noexcept
+    {
+        std::memcpy(&ctrl, pos, sizeof(ctrl));
+
+#if VX_ORDER_NATIVE_ENDIAN == VX_ORDER_BIG_ENDIAN
+        ctrl = bit::byteswap(ctrl);
+#endif
+    }
+
+    mask_type match(const ctrl_type hash) const noexcept
+    {
+        // may report false positives for bytes following a true match, the
+        // caller always confirms candidates with a key comparison
+        const uint64_t x = ctrl ^ (lsbs * static_cast<uint8_t>(hash));
+        return mask_type((x - lsbs) & ~x & msbs);
+    }
+
+    mask_type match_empty() const noexcept
+    {
+        return mask_type((ctrl & ~(ctrl << 6)) & msbs);
+    }
+
+    mask_type match_empty_or_deleted() const noexcept
+    {
+        return mask_type((ctrl & ~(ctrl << 7)) & msbs);
+    }
+
+    size_t count_leading_empty_or_deleted() const noexcept
+    {
+        constexpr uint64_t gaps = 0x00FEFEFEFEFEFEFEULL;
+        return static_cast<size_t>((bit::countr_zero(((~ctrl & (ctrl >> 7)) | gaps) + 1) + 7) >> 3);
+    }
+
+    uint64_t ctrl;
+};
+
+using group = group_portable;
+
+#endif
+
+//=========================================================================
+// capacity helpers
+//=========================================================================
+
+// capacity is always of the form 2^n - 1 so it can be used as the probe mask
+inline constexpr bool is_valid_capacity(const size_t n) noexcept
+{
+    return ((n + 1) & n) == 0 && n > 0;
+}
+
+inline constexpr size_t num_cloned_bytes() noexcept
+{
+    return group::width - 1;
+}
+
+inline size_t normalize_capacity(const size_t n) noexcept
+{
+    return n ? (~size_t{} >> bit::countl_zero(n)) : 1;
+}
+
+// max load factor is 7/8, small tables (smaller than a group) may be filled
+// completely because the cloned control bytes always provide an empty slot
+inline constexpr size_t capacity_to_growth(const size_t capacity) noexcept
+{
+    return (group::width == 8 && capacity == 7) ? 6 : capacity - capacity / 8;
+}
+
+inline constexpr size_t growth_to_lower_bound_capacity(const size_t growth) noexcept
+{
+    return (group::width == 8 && growth == 7) ? 8 : growth + static_cast<size_t>((static_cast<int64_t>(growth) - 1) / 7);
+}
+
+// shared all-empty group used by tables that have not allocated yet, so
+// lookups on an empty table need no special case
+inline ctrl_type* empty_group() noexcept
+{
+    alignas(16) static constexpr ctrl_type group_bytes[16] = {
+        ctrl_sentinel, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+        ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty
+    };
+    return const_cast<ctrl_type*>(group_bytes);
+}
+
+//=========================================================================
+// probing
+//=========================================================================
+
+// triangular probing over groups, visits every group exactly once when the
+// number of slots is a power of two
+class probe_seq
+{
+public:
+
+    probe_seq(const size_t hash, const size_t mask) noexcept
+        : m_mask(mask), m_offset(hash & mask), m_index(0)
+    {}
+
+    size_t offset() const noexcept
+    {
+        return m_offset;
+    }
+
+    size_t offset(const size_t i) const noexcept
+    {
+        return (m_offset + i) & m_mask;
+    }
+
+    size_t index() const noexcept
+    {
+        return m_index;
+    }
+
+    void next() noexcept
+    {
+        m_index += group::width;
+        m_offset += m_index;
+        m_offset &= m_mask;
+    }
+
+private:
+
+    size_t m_mask;
+    size_t m_offset;
+    size_t m_index;
+};
+
+//=========================================================================
+// iterator
+//=========================================================================
+
+template <typename Table, typename T>
+class hash_table_iterator
+{
+    template <typename, typename, typename, typename>
+    friend class raw_hash_table;
+
+    template <typename, typename>
+    friend class hash_table_iterator;
+
+public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename std::remove_const<T>::type;
+    using difference_type = ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    hash_table_iterator() noexcept
+        : m_ctrl(nullptr), m_slot(nullptr)
+    {}
+
+    // iterator -> const_iterator
+    template <typename U, VX_REQUIRES((std::is_same<const U, T>::value && !std::is_same<U, T>::value))>
+    hash_table_iterator(const hash_table_iterator<Table, U>& other) noexcept
+        : m_ctrl(other.m_ctrl), m_slot(other.m_slot)
+    {}
+
+    reference operator*() const noexcept
+    {
+        VX_ASSERT(m_ctrl && is_full(*m_ctrl));
+        return *m_slot;
+    }
+
+    pointer operator->() const noexcept
+    {
+        VX_ASSERT(m_ctrl && is_full(*m_ctrl));
+        return m_slot;
+    }
+
+    hash_table_iterator& operator++() noexcept
+    {
+        ++m_ctrl;
+        ++m_slot;
+        skip_empty_or_deleted();
+        return *this;
+    }
+
+    hash_table_iterator operator++(int) noexcept
+    {
+        hash_table_iterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+
+    friend bool operator==(const hash_table_iterator& lhs, const hash_table_iterator& rhs) noexcept
+    {
+        return lhs.m_ctrl == rhs.m_ctrl;
+    }
+
+    friend bool operator!=(const hash_table_iterator& lhs, const hash_table_iterator& rhs) noexcept
+    {
+        return lhs.m_ctrl != rhs.m_ctrl;
+    }
+
+private:
+
+    hash_table_iterator(ctrl_type* ctrl, T* slot) noexcept
+        : m_ctrl(ctrl), m_slot(slot)
+    {}
+
+    // the sentinel terminates the scan, so end() needs no bounds check
+    void skip_empty_or_deleted() noexcept
+    {
+        while (is_empty_or_deleted(*m_ctrl))
+        {
+            const size_t shift = group(m_ctrl).count_leading_empty_or_deleted();
+            m_ctrl += shift;
+            m_slot += shift;
+        }
+    }
+
+    ctrl_type* m_ctrl;
+    T* m_slot;
+};
+
+//=========================================================================
+// raw hash table
+//=========================================================================
+
+// Policy describes how values are stored and keyed:
+//
+//   key_type, value_type
+//   constant_iterators                                     // std::true_type if values are keys
+//   static const key_type& key(const value_type&)
+//   static void transfer(value_type* dst, value_type* src) // move + destroy src
+
+template <typename Policy, typename Hash, typename KeyEqual, typename Allocator>
+class raw_hash_table
+{
+public:
+
+    using policy_type = Policy;
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+    // values of a set are their own keys and must never be modified in place
+    using iterator = hash_table_iterator<raw_hash_table, typename std::conditional<
+        Policy::constant_iterators::value, const value_type, value_type>::type>;
+    using const_iterator = hash_table_iterator<raw_hash_table, const value_type>;
+
+    VX_STATIC_ASSERT_MSG(
+        (std::is_same<value_type, typename Allocator::value_type>::value),
+        "Allocator value type must match value_type");
+
+    VX_STATIC_ASSERT_MSG(alignof(value_type) <= mem::max_align, "over aligned values are not supported");
+
+protected:
+
+    // heterogeneous lookup is enabled when both the hasher and the key
+    // comparison accept other key-like types
+    template <typename K>
+    using key_arg = typename _priv::key_arg_impl<
+        is_transparent<Hash>::value && is_transparent<KeyEqual>::value
+    >::template type<K, key_type>;
+
+private:
+
+    // when iterator and const_iterator are the same type the iterator
+    // overloads collapse into one, the placeholder keeps the signatures apart
+    struct no_mutable_iterator {};
+
+    using mutable_iterator_arg = typename std::conditional<
+        std::is_same<iterator, const_iterator>::value,
+        no_mutable_iterator, iterator>::type;
+
+    // ctrl and slots share a single allocation
+    using byte_allocator_type = typename mem::rebind_allocator<Allocator, unsigned char>::type;
+
+    struct table_data
+    {
+        ctrl_type* ctrl = empty_group();
+        pointer slots = nullptr;
+        size_type capacity = 0;
+        size_type size = 0;
+        size_type growth_left = 0;
+
+        table_data release() noexcept
+        {
+            table_data old = *this;
+            *this = table_data{};
+            return old;
+        }
+    };
+
+    using storage_type = _priv::compressed_pair<
+        hasher, _priv::compressed_pair<
+        key_equal, _priv::compressed_pair<
+        byte_allocator_type, table_data>>>;
+
+    storage_type m_storage;
+
+    table_data& m_data() noexcept { return m_storage.second.second.second; }
+    const table_data& m_data() const noexcept { return m_storage.second.second.second; }
+
+    byte_allocator_type& m_allocator() noexcept { return m_storage.second.second.first(); }
+    const byte_allocator_type& m_allocator() const noexcept { return m_storage.second.second.first(); }
+
+    hasher& m_hash() noexcept { return m_storage.first(); }
+    const hasher& m_hash() const noexcept { return m_storage.first(); }
+
+    key_equal& m_eq() noexcept { return m_storage.second.first(); }
+    const key_equal& m_eq() const noexcept { return m_storage.second.first(); }
+
+public:
+
+    //=========================================================================
+    // constructors
+    //=========================================================================
+
+    raw_hash_table() noexcept
+        : raw_hash_table(0)
+    {}
+
+    explicit raw_hash_table(
+        size_type bucket_count,
+        const hasher& hash = hasher(),
+        const key_equal& eq = key_equal(),
+        const allocator_type& alloc = allocator_type())
+        : m_storage(
+            _priv::one_then_variadic_args_tag{}, hash,
+            _priv::one_then_variadic_args_tag{}, eq,
+            _priv::one_then_variadic_args_tag{}, byte_allocator_type(alloc))
+    {
+        if (bucket_count && !resize(normalize_capacity(bucket_count)))
+        {
+            err::fast_fail();
+        }
+    }
+
+    explicit raw_hash_table(const allocator_type& alloc)
+        : raw_hash_table(0, hasher(), key_equal(), alloc)
+    {}
+
+    template <typename IT, VX_REQUIRES(type_traits::is_iterator<IT>::value)>
+    raw_hash_table(
+        IT first, IT last,
+        size_type bucket_count = 0,
+        const hasher& hash = hasher(),
+        const key_equal& eq = key_equal(),
+        const allocator_type& alloc = allocator_type())
+        : raw_hash_table(bucket_count, hash, eq, alloc)
+    {
+        if (!insert(first, last))
+        {
+            err::fast_fail();
+        }
+    }
+
+    raw_hash_table(
+        std::initializer_list<value_type> init,
+        size_type bucket_count = 0,
+        const hasher& hash = hasher(),
+        const key_equal& eq = key_equal(),
+        const allocator_type& alloc = allocator_type())
+        : raw_hash_table(init.begin(), init.end(), bucket_count, hash, eq, alloc)
+    {}
+
+    raw_hash_table(const raw_hash_table& other)
+        : raw_hash_table(other, other.get_allocator())
+    {}
+
+    raw_hash_table(const raw_hash_table& other, const allocator_type& alloc)
+        : raw_hash_table(0, other.m_hash(), other.m_eq(), alloc)
+    {
+        if (!copy_from(other))
+        {
+            err::fast_fail();
+        }
+    }
+
+    raw_hash_table(raw_hash_table&& other) noexcept
+        : m_storage(std::move(other.m_storage))
+    {
+        other.m_data().release();
+    }
+
+    ~raw_hash_table()
+    {
+        destroy_and_deallocate();
+    }
+
+    //=========================================================================
+    // assignment
+    //=========================================================================
+
+    raw_hash_table& operator=(const raw_hash_table& other)
+    {
+        if (this != &other)
+        {
+            raw_hash_table tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    raw_hash_table& operator=(raw_hash_table&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy_and_deallocate();
+            m_storage = std::move(other.m_storage);
+            other.m_data().release();
+        }
+        return *this;
+    }
+
+    raw_hash_table& operator=(std::initializer_list<value_type> init)
+    {
+        clear();
+        if (!insert(init.begin(), init.end()))
+        {
+            err::fast_fail();
+        }
+        return *this;
+    }
+
+    //=========================================================================
+    // observers
+    //=========================================================================
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type(m_allocator());
+    }
+
+    hasher hash_function() const
+    {
+        return m_hash();
+    }
+
+    key_equal key_eq() const
+    {
+        return m_eq();
+    }
+
+    //=========================================================================
+    // iterators
+    //=========================================================================
+
+    iterator begin() noexcept
+    {
+        if (empty())
+        {
+            return end();
+        }
+
+        iterator it(m_data().ctrl, m_data().slots);
+        it.skip_empty_or_deleted();
+        return it;
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_cast<raw_hash_table*>(this)->begin();
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(m_data().ctrl + m_data().capacity, m_data().slots + m_data().capacity);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_cast<raw_hash_table*>(this)->end();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    //=========================================================================
+    // size and capacity
+    //=========================================================================
+
+    bool empty() const noexcept
+    {
+        return m_data().size == 0;
+    }
+
+    size_type size() const noexcept
+    {
+        return m_data().size;
+    }
+
+    size_type capacity() const noexcept
+    {
+        return m_data().capacity;
+    }
+
+    constexpr size_type max_size() const noexcept
+    {
+        return mem::max_array_size<value_type>() / 2;
+    }
+
+    size_type bucket_count() const noexcept
+    {
+        return m_data().capacity;
+    }
+
+    float load_factor() const noexcept
+    {
+        return m_data().capacity ? static_cast<float>(m_data().size) / static_cast<float>(m_data().capacity) : 0.0f;
+    }
+
+    static constexpr float max_load_factor() noexcept
+    {
+        return 7.0f / 8.0f;
+    }
+
+    //=========================================================================
+    // memory
+    //=========================================================================
+
+    // destroys all elements but keeps the allocation
+    void clear() noexcept
+    {
+        auto& data = m_data();
+        if (data.capacity == 0)
+        {
+            return;
+        }
+
+        destroy_slots();
+        reset_ctrl(data.ctrl, data.capacity);
+        data.size = 0;
+        data.growth_left = capacity_to_growth(data.capacity);
+    }
+
+    void clear_and_deallocate() noexcept
+    {
+        destroy_and_deallocate();
+    }
+
+    // ensures count elements can be held without triggering a rehash
+    success reserve(size_type count)
+    {
+        if (count > m_data().size + m_data().growth_left)
+        {
+            VX_UNLIKELY_COLD_PATH(count > max_size(),
+                {
+                    return make_error(err::size_error);
+                });
+
+            return resize(normalize_capacity(growth_to_lower_bound_capacity(count)));
+        }
+
+        return make_error(err::none);
+    }
+
+    // rebuilds the table with room for at least count slots (and at least
+    // enough for the current size), which also drops all tombstones. rehash(0)
+    // on an empty table releases the allocation.
+    success rehash(size_type count)
+    {
+        auto& data = m_data();
+
+        if (count == 0 && data.size == 0)
+        {
+            destroy_and_deallocate();
+            return make_error(err::none);
+        }
+
+        VX_UNLIKELY_COLD_PATH(count > max_size(),
+            {
+                return make_error(err::size_error);
+            });
+
+        const size_type min_capacity = growth_to_lower_bound_capacity(data.size);
+        const size_type new_capacity = normalize_capacity(count > min_capacity ? count : min_capacity);
+        return resize(new_capacity);
+    }
+
+    void swap(raw_hash_table& other) noexcept
+    {
+        mem::swap(m_storage, other.m_storage);
+    }
+
+    //=========================================================================
+    // lookup
+    //=========================================================================
+
+    template <typename K = key_type>
+    iterator find(const key_arg<K>& key) noexcept
+    {
+        const size_type i = find_index(key, hash_of(key));
+        return i == npos ? end() : iterator_at(i);
+    }
+
+    template <typename K = key_type>
+    const_iterator find(const key_arg<K>& key) const noexcept
+    {
+        return const_cast<raw_hash_table*>(this)->find(key);
+    }
+
+    template <typename K = key_type>
+    bool contains(const key_arg<K>& key) const noexcept
+    {
+        return find_index(key, hash_of(key)) != npos;
+    }
+
+    template <typename K = key_type>
+    size_type count(const key_arg<K>& key) const noexcept
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    //=========================================================================
+    // insert
+    //=========================================================================
+
+    expected<std::pair<iterator, bool>, error> insert(const value_type& value)
+    {
+        return insert_value(value);
+    }
+
+    expected<std::pair<iterator, bool>, error> insert(value_type&& value)
+    {
+        return insert_value(std::move(value));
+    }
+
+    template <typename IT, VX_REQUIRES(type_traits::is_iterator<IT>::value)>
+    success insert(IT first, IT last)
+    {
+        VX_IF_CONSTEXPR ((std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<IT>::iterator_category>::value))
+        {
+            const size_type count = static_cast<size_type>(std::distance(first, last));
+            if (!reserve(m_data().size + count))
+            {
+                return make_error(err::out_of_memory);
+            }
+        }
+
+        for (; first != last; ++first)
+        {
+            const auto res = insert_value(*first);
+            if (!res)
+            {
+                return res.error();
+            }
+        }
+
+        return make_error(err::none);
+    }
+
+    success insert(std::initializer_list<value_type> init)
+    {
+        return insert(init.begin(), init.end());
+    }
+
+    // constructs the value first so the key can be extracted from it, prefer
+    // try_emplace or insert when the key is already available
+    template <typename... Args>
+    expected<std::pair<iterator, bool>, error> emplace(Args&&... args)
+    {
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+        pointer tmp = reinterpret_cast<pointer>(&storage);
+        mem::construct_in_place(tmp, std::forward<Args>(args)...);
+
+        const auto res = find_or_prepare_insert(Policy::key(*tmp));
+        if (!res)
+        {
+            mem::destroy_in_place(tmp);
+            return make_unexpected(res.error());
+        }
+
+        const size_type i = res.value().first;
+        if (res.value().second)
+        {
+            Policy::transfer(m_data().slots + i, tmp);
+        }
+        else
+        {
+            mem::destroy_in_place(tmp);
+        }
+
+        return std::pair<iterator, bool>(iterator_at(i), res.value().second);
+    }
+
+    //=========================================================================
+    // erase
+    //=========================================================================
+
+    iterator erase(const_iterator pos) noexcept
+    {
+        VX_ASSERT(pos != cend());
+
+        iterator it(pos.m_ctrl, const_cast<pointer>(pos.m_slot));
+        erase_at(static_cast<size_type>(it.m_ctrl - m_data().ctrl));
+        ++it;
+        return it;
+    }
+
+    iterator erase(mutable_iterator_arg pos) noexcept
+    {
+        return erase(const_iterator(pos));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        while (first != last)
+        {
+            first = erase(first);
+        }
+        return iterator(last.m_ctrl, const_cast<pointer>(last.m_slot));
+    }
+
+    template <typename K = key_type>
+    size_type erase(const key_arg<K>& key) noexcept
+    {
+        const size_type i = find_index(key, hash_of(key));
+        if (i == npos)
+        {
+            return 0;
+        }
+
+        erase_at(i);
+        return 1;
+    }
+
+    // erases every element for which pred returns true, returns the number erased
+    template <typename Pred>
+    size_type erase_if(Pred pred)
+    {
+        const size_type old_size = size();
+
+        for (auto it = begin(); it != end();)
+        {
+            if (pred(*it))
+            {
+                it = erase(const_iterator(it));
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        return old_size - size();
+    }
+
+protected:
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    //=========================================================================
+    // hashing
+    //=========================================================================
+
+    template <typename K>
+    size_t hash_of(const K& key) const noexcept
+    {
+        return hash_mix(m_hash()(key));
+    }
+
+    //=========================================================================
+    // slot access
+    //=========================================================================
+
+    iterator iterator_at(const size_type i) noexcept
+    {
+        return iterator(m_data().ctrl + i, m_data().slots + i);
+    }
+
+    pointer slot_at(const size_type i) noexcept
+    {
+        return m_data().slots + i;
+    }
+
+    //=========================================================================
+    // find
+    //=========================================================================
+
+    template <typename K>
+    size_type find_index(const K& key, const size_t hash) const noexcept
+    {
+        const auto& data = m_data();
+        probe_seq seq(h1(hash), data.capacity);
+
+        while (true)
+        {
+            const group g(data.ctrl + seq.offset());
+
+            for (auto m = g.match(h2(hash)); m; m.clear_lowest())
+            {
+                const size_type i = seq.offset(m.lowest_bit_set());
+                if (VX_LIKELY(m_eq()(Policy::key(data.slots[i]), key)))
+                {
+                    return i;
+                }
+            }
+
+            if (VX_LIKELY(g.match_empty()))
+            {
+                return npos;
+            }
+
+            seq.next();
+            VX_ASSERT(seq.index() <= data.capacity && "full table");
+        }
+    }
+
+    // returns the slot index for key and whether the slot still needs to be
+    // constructed. the control byte of a new slot is already marked full.
+    template <typename K>
+    expected<std::pair<size_type, bool>, error> find_or_prepare_insert(const K& key)
+    {
+        const size_t hash = hash_of(key);
+        const size_type i = find_index(key, hash);
+
+        if (i != npos)
+        {
+            return std::pair<size_type, bool>(i, false);
+        }
+
+        const auto target = prepare_insert(hash);
+        if (!target)
+        {
+            return make_unexpected(target.error());
+        }
+
+        return std::pair<size_type, bool>(target.value(), true);
+    }
+
+    template <typename V>
+    expected<std::pair<iterator, bool>, error> insert_value(V&& value)
+    {
+        const auto res = find_or_prepare_insert(Policy::key(value));
+        if (!res)
+        {
+            return make_unexpected(res.error());
+        }
+
+        const size_type i = res.value().first;
+        if (res.value().second)
+        {
+            mem::construct_in_place(slot_at(i), std::forward<V>(value));
+        }
+
+        return std::pair<iterator, bool>(iterator_at(i), res.value().second);
+    }
+
+private:
+
+    //=========================================================================
+    // control helpers
+    //=========================================================================
+
+    // sets the control byte and its clone past the sentinel so that group loads
+    // starting near the end of the table see the wrapped around bytes
+    static void set_ctrl(ctrl_type* ctrl, const size_type capacity, const size_type i, const ctrl_type h) noexcept
+    {
+        ctrl[i] = h;
+        ctrl[((i - num_cloned_bytes()) & capacity) + (num_cloned_bytes() & capacity)] = h;
+    }
+
+    static void reset_ctrl(ctrl_type* ctrl, const size_type capacity) noexcept
+    {
+        std::memset(ctrl, ctrl_empty, capacity + 1 + num_cloned_bytes());
+        ctrl[capacity] = ctrl_sentinel;
+    }
+
+    static size_type find_first_non_full(const ctrl_type* ctrl, const size_type capacity, const size_t hash) noexcept
+    {
+        probe_seq seq(h1(hash), capacity);
+
+        while (true)
+        {
+            const auto m = group(ctrl + seq.offset()).match_empty_or_deleted();
+            if (m)
+            {
+                return seq.offset(m.lowest_bit_set());
+            }
+
+            seq.next();
+            VX_ASSERT(seq.index() <= capacity && "full table");
+        }
+    }
+
+    //=========================================================================
+    // allocation
+    //=========================================================================
+
+    static constexpr size_type slot_offset(const size_type capacity) noexcept
+    {
+        return (capacity + 1 + num_cloned_bytes() + alignof(value_type) - 1) & ~(alignof(value_type) - 1);
+    }
+
+    static constexpr size_type allocation_size(const size_type capacity) noexcept
+    {
+        return slot_offset(capacity) + capacity * sizeof(value_type);
+    }
+
+    void destroy_slots() noexcept
+    {
+        VX_IF_CONSTEXPR (!std::is_trivially_destructible<value_type>::value)
+        {
+            auto& data = m_data();
+            for (size_type i = 0; i != data.capacity; ++i)
+            {
+                if (is_full(data.ctrl[i]))
+                {
+                    mem::destroy_in_place(data.slots + i);
+                }
+            }
+        }
+    }
+
+    void destroy_and_deallocate() noexcept
+    {
+        auto& data = m_data();
+        if (data.capacity == 0)
+        {
+            return;
+        }
+
+        destroy_slots();
+        m_allocator().deallocate(reinterpret_cast<unsigned char*>(data.ctrl), allocation_size(data.capacity));
+        data.release();
+    }
+
+    // moves every element into a freshly allocated table of new_capacity slots
+    success resize(const size_type new_capacity)
+    {
+        VX_ASSERT(is_valid_capacity(new_capacity));
+
+        auto& data = m_data();
+
+        unsigned char* mem_ptr = m_allocator().allocate(allocation_size(new_capacity));
+
+#if !defined(VX_ALLOCATE_FAIL_FAST)
+
+        VX_UNLIKELY_COLD_PATH(!mem_ptr,
+            {
+                return make_error(err::out_of_memory);
+            });
+
+#endif // !defined(VX_ALLOCATE_FAIL_FAST)
+
+        ctrl_type* new_ctrl = reinterpret_cast<ctrl_type*>(mem_ptr);
+        pointer new_slots = reinterpret_cast<pointer>(mem_ptr + slot_offset(new_capacity));
+        reset_ctrl(new_ctrl, new_capacity);
+
+        if (data.capacity)
+        {
+            for (size_type i = 0; i != data.capacity; ++i)
+            {
+                if (is_full(data.ctrl[i]))
+                {
+                    const size_t hash = hash_of(Policy::key(data.slots[i]));
+                    const size_type target = find_first_non_full(new_ctrl, new_capacity, hash);
+                    set_ctrl(new_ctrl, new_capacity, target, h2(hash));
+                    Policy::transfer(new_slots + target, data.slots + i);
+                }
+            }
+
+            m_allocator().deallocate(reinterpret_cast<unsigned char*>(data.ctrl), allocation_size(data.capacity));
+        }
+
+        data.ctrl = new_ctrl;
+        data.slots = new_slots;
+        data.capacity = new_capacity;
+        data.growth_left = capacity_to_growth(new_capacity) - data.size;
+
+        return make_error(err::none);
+    }
+
+    // called when growth_left runs out. if a large part of the table is
+    // tombstones the table is rebuilt at the same size, otherwise it doubles.
+    success rehash_and_grow_if_necessary()
+    {
+        const auto& data = m_data();
+
+        if (data.capacity > group::width && data.size * 32 <= data.capacity * 25)
+        {
+            return resize(data.capacity);
+        }
+
+        VX_UNLIKELY_COLD_PATH(data.capacity > max_size() / 2,
+            {
+                return make_error(err::size_error);
+            });
+
+        return resize(data.capacity * 2 + 1);
+    }
+
+    expected<size_type, error> prepare_insert(const size_t hash)
+    {
+        auto& data = m_data();
+        size_type target = find_first_non_full(data.ctrl, data.capacity, hash);
+
+        // reusing a tombstone does not consume growth
+        if (VX_UNLIKELY(data.growth_left == 0 && !is_deleted(data.ctrl[target])))
+        {
+            const success s = rehash_and_grow_if_necessary();
+            if (!s)
+            {
+                return make_unexpected(error(s));
+            }
+
+            target = find_first_non_full(data.ctrl, data.capacity, hash);
+        }
+
+        ++data.size;
+        data.growth_left -= is_empty(data.ctrl[target]) ? 1 : 0;
+        set_ctrl(data.ctrl, data.capacity, target, h2(hash));
+
+        return target;
+    }
+
+    // A slot can be marked empty again (instead of deleted) if no probe could
+    // ever have passed over it, which is the case when the run of non-empty
+    // slots around it is shorter than a group.
+    bool was_never_full(const size_type i) const noexcept
+    {
+        const auto& data = m_data();
+
+        const size_type index_before = (i - group::width) & data.capacity;
+        const auto empty_after = group(data.ctrl + i).match_empty();
+        const auto empty_before = group(data.ctrl + index_before).match_empty();
+
+        return empty_before && empty_after &&
+            (empty_after.trailing_zeros() + empty_before.leading_zeros()) < group::width;
+    }
+
+    void erase_at(const size_type i) noexcept
+    {
+        auto& data = m_data();
+        VX_ASSERT(is_full(data.ctrl[i]));
+
+        mem::destroy_in_place(data.slots + i);
+        --data.size;
+
+        if (was_never_full(i))
+        {
+            set_ctrl(data.ctrl, data.capacity, i, ctrl_empty);
+            ++data.growth_left;
+        }
+        else
+        {
+            set_ctrl(data.ctrl, data.capacity, i, ctrl_deleted);
+        }
+    }
+
+    success copy_from(const raw_hash_table& other)
+    {
+        if (!reserve(other.size()))
+        {
+            return make_error(err::out_of_memory);
+        }
+
+        auto& data = m_data();
+
+        // the keys are known to be unique, so skip the lookup entirely
+        for (auto it = other.begin(); it != other.end(); ++it)
+        {
+            const size_t hash = hash_of(Policy::key(*it));
+            const size_type target = find_first_non_full(data.ctrl, data.capacity, hash);
+            set_ctrl(data.ctrl, data.capacity, target, h2(hash));
+            mem::construct_in_place(data.slots + target, *it);
+            ++data.size;
+            --data.growth_left;
+        }
+
+        return make_error(err::none);
+    }
+};
+
+} // namespace _hash_table_priv
+} // namespace vx
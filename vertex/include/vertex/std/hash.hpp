@@ -0,0 +1,110 @@
+#pragma once
+
+#include <functional>
+
+#include "vertex/config/architecture.hpp"
+#include "vertex/config/type_traits.hpp"
+
+namespace vx {
+
+//=========================================================================
+// hash
+//=========================================================================
+
+// Primary hash template. Defaults to std::hash so any type already usable in
+// the standard unordered containers can be used as a key in the vx containers.
+// Specializations that also accept other key-like types (for heterogeneous
+// lookup) should define is_transparent.
+template <typename T>
+struct hash : std::hash<T>
+{};
+
+//=========================================================================
+// equal_to
+//=========================================================================
+
+template <typename T>
+struct equal_to : std::equal_to<T>
+{};
+
+// transparent comparison, forwards to operator==
+template <>
+struct equal_to<void>
+{
+    using is_transparent = void;
+
+    template <typename T, typename U>
+    constexpr bool operator()(const T& lhs, const U& rhs) const noexcept(noexcept(lhs == rhs))
+    {
+        return lhs == rhs;
+    }
+};
+
+//=========================================================================
+// transparency
+//=========================================================================
+
+template <typename T, typename = void>
+struct is_transparent : std::false_type
+{};
+
+template <typename T>
+struct is_transparent<T, type_traits::void_t<typename T::is_transparent>> : std::true_type
+{};
+
+namespace _priv {
+
+// Selects the argument type of lookup functions in associative containers.
+// Alias templates of a non-dependent class are transparent to template
+// argument deduction, so K is only deduced when lookup is heterogeneous.
+template <bool Transparent>
+struct key_arg_impl
+{
+    template <typename K, typename Key>
+    using type = Key;
+};
+
+template <>
+struct key_arg_impl<true>
+{
+    template <typename K, typename Key>
+    using type = K;
+};
+
+} // namespace _priv
+
+//=========================================================================
+// mixing
+//=========================================================================
+
+// Many std::hash implementations (integers, pointers) are the identity
+// function. Open addressing tables index with both the low and high bits of
+// the hash, so the result is run through a finalizer to spread entropy across
+// the whole word.
+//
+// https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp
+
+constexpr size_t hash_mix(size_t h) noexcept
+{
+#if defined(VX_ARCH_WORD_BITS_64)
+
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+
+#else
+
+    h ^= h >> 16;
+    h *= 0x85EBCA6BU;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35U;
+    h ^= h >> 16;
+
+#endif // defined(VX_ARCH_WORD_BITS_64)
+
+    return h;
+}
+
+} // namespace vx
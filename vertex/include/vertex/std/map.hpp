@@ -0,0 +1,219 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+
+#include "vertex/std/_tools/raw_hash_table.hpp"
+
+namespace vx {
+
+namespace _hash_table_priv {
+
+template <typename Key, typename T>
+struct map_policy
+{
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using constant_iterators = std::false_type;
+
+    static const key_type& key(const value_type& value) noexcept
+    {
+        return value.first;
+    }
+
+    // the const key of a slot that is about to be destroyed is safe to move from
+    static void transfer(value_type* dst, value_type* src) noexcept
+    {
+        VX_IF_CONSTEXPR (std::is_trivially_copyable<value_type>::value)
+        {
+            mem::copy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+        }
+        else
+        {
+            mem::construct_in_place(dst, std::move(const_cast<key_type&>(src->first)), std::move(src->second));
+            mem::destroy_in_place(src);
+        }
+    }
+};
+
+} // namespace _hash_table_priv
+
+//=========================================================================
+// hash_map
+//=========================================================================
+
+// Flat open addressing hash map. Values are stored inline in a single
+// allocation, so unlike std::unordered_map, pointers and iterators are
+// invalidated whenever the table grows.
+template <
+    typename Key,
+    typename T,
+    typename Hash = vx::hash<Key>,
+    typename KeyEqual = vx::equal_to<Key>,
+    typename Allocator = mem::default_allocator<std::pair<const Key, T>>>
+class hash_map : public _hash_table_priv::raw_hash_table<_hash_table_priv::map_policy<Key, T>, Hash, KeyEqual, Allocator>
+{
+    using base = _hash_table_priv::raw_hash_table<_hash_table_priv::map_policy<Key, T>, Hash, KeyEqual, Allocator>;
+
+    template <typename K>
+    using key_arg = typename base::template key_arg<K>;
+
+public:
+
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = typename base::value_type;
+    using size_type = typename base::size_type;
+    using iterator = typename base::iterator;
+    using const_iterator = typename base::const_iterator;
+
+    using base::base;
+
+    hash_map() noexcept = default;
+
+    //=========================================================================
+    // element access
+    //=========================================================================
+
+    template <typename K = key_type>
+    expected<T&, error> at(const key_arg<K>& key) noexcept
+    {
+        const auto it = base::find(key);
+        if (it == base::end())
+        {
+            return make_unexpected(make_error(err::out_of_range));
+        }
+        return it->second;
+    }
+
+    template <typename K = key_type>
+    expected<const T&, error> at(const key_arg<K>& key) const noexcept
+    {
+        const auto it = base::find(key);
+        if (it == base::end())
+        {
+            return make_unexpected(make_error(err::out_of_range));
+        }
+        return it->second;
+    }
+
+    T& operator[](const key_type& key)
+    {
+        return subscript(key);
+    }
+
+    T& operator[](key_type&& key)
+    {
+        return subscript(std::move(key));
+    }
+
+    //=========================================================================
+    // insert
+    //=========================================================================
+
+    using base::insert;
+
+    // constructs the mapped value only if key is not already present
+    template <typename K, typename... Args>
+    expected<std::pair<iterator, bool>, error> try_emplace(K&& key, Args&&... args)
+    {
+        VX_STATIC_ASSERT_MSG((std::is_constructible<key_type, K&&>::value), "key must be constructible from K");
+
+        const auto res = base::find_or_prepare_insert(key);
+        if (!res)
+        {
+            return make_unexpected(res.error());
+        }
+
+        const size_type i = res.value().first;
+        if (res.value().second)
+        {
+            mem::construct_in_place(
+                base::slot_at(i),
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<K>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+
+        return std::pair<iterator, bool>(base::iterator_at(i), res.value().second);
+    }
+
+    template <typename K, typename M>
+    expected<std::pair<iterator, bool>, error> insert_or_assign(K&& key, M&& value)
+    {
+        const auto res = base::find_or_prepare_insert(key);
+        if (!res)
+        {
+            return make_unexpected(res.error());
+        }
+
+        const size_type i = res.value().first;
+        if (res.value().second)
+        {
+            mem::construct_in_place(base::slot_at(i), std::forward<K>(key), std::forward<M>(value));
+        }
+        else
+        {
+            base::slot_at(i)->second = std::forward<M>(value);
+        }
+
+        return std::pair<iterator, bool>(base::iterator_at(i), res.value().second);
+    }
+
+private:
+
+    template <typename K>
+    T& subscript(K&& key)
+    {
+        const auto res = try_emplace(std::forward<K>(key));
+        if (!res)
+        {
+            err::fast_fail();
+        }
+        return res.value().first->second;
+    }
+};
+
+//=========================================================================
+// comparison
+//=========================================================================
+
+template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+bool operator==(const hash_map<Key, T, Hash, KeyEqual, Allocator>& lhs, const hash_map<Key, T, Hash, KeyEqual, Allocator>& rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    for (const auto& value : lhs)
+    {
+        const auto it = rhs.find(value.first);
+        if (it == rhs.end() || !(it->second == value.second))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+bool operator!=(const hash_map<Key, T, Hash, KeyEqual, Allocator>& lhs, const hash_map<Key, T, Hash, KeyEqual, Allocator>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+//=========================================================================
+// swap
+//=========================================================================
+
+// see vector swap
+template <typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+void swap(hash_map<Key, T, Hash, KeyEqual, Allocator>& lhs, hash_map<Key, T, Hash, KeyEqual, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace vx
@@ -4,3 +4,5 @@
 #include "vertex/std/_memory/memory_core.hpp"
 #include "vertex/std/_memory/memory_util.hpp"
 #include "vertex/std/_memory/allocator.hpp"
+#include "vertex/std/_memory/arena_allocator.hpp"
+#include "vertex/std/_memory/pool_allocator.hpp"
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "vertex/std/_tools/compressed_pair.hpp"
 #include "vertex/std/math/checked_arithmetic.hpp"
 #include "vertex/std/memory.hpp"
 #include "vertex/std/string_utils.hpp"
@@ -31,22 +32,28 @@ private:
         size_t count = 0;
     };
 
-    // allocator_storage gives EBO when allocator_type is stateless (the common case),
+    // compressed_pair gives EBO when allocator_type is stateless (the common case),
     // and falls back to a real member when it isn't.
-    mem::_mem_priv::allocator_storage<allocator_type, buffer_type> m_storage;
+    _priv::compressed_pair<allocator_type, buffer_type> m_storage;
 
     allocator_type& allocator() noexcept
     {
-        return m_storage.allocator();
+        return m_storage.first();
     }
     const allocator_type& allocator() const noexcept
     {
-        return m_storage.allocator();
+        return m_storage.first();
     }
 
 public:
 
-    packed_string_array() noexcept = default;
+    packed_string_array() noexcept(noexcept(allocator_type()))
+        : m_storage(_priv::zero_then_variadic_args_tag{})
+    {}
+
+    explicit packed_string_array(const allocator_type& alloc) noexcept
+        : m_storage(_priv::one_then_variadic_args_tag{}, alloc)
+    {}
 
     ~packed_string_array()
     {
@@ -59,8 +66,8 @@ public:
     packed_string_array(packed_string_array&& other) noexcept
         : m_storage(std::move(other.m_storage))
     {
-        other.m_storage.value.data = nullptr;
-        other.m_storage.value.count = 0;
+        other.m_storage.second.data = nullptr;
+        other.m_storage.second.count = 0;
     }
 
     packed_string_array& operator=(packed_string_array&& other) noexcept
@@ -71,8 +78,8 @@ public:
 
             m_storage = std::move(other.m_storage);
 
-            other.m_storage.value.data = nullptr;
-            other.m_storage.value.count = 0;
+            other.m_storage.second.data = nullptr;
+            other.m_storage.second.count = 0;
         }
 
         return *this;
@@ -86,7 +93,7 @@ public:
         VX_ASSERT(src);
         VX_ASSERT(count);
 
-        packed_string_array result;
+        packed_string_array result(alloc);
 
         size_t pointer_count;
         size_t pointer_bytes;
@@ -154,8 +161,8 @@ public:
 
         auto** table = reinterpret_cast<array_type>(memory);
 
-        result.m_storage.value.data = table;
-        result.m_storage.value.count = count;
+        result.m_storage.second.data = table;
+        result.m_storage.second.count = count;
 
         auto* string_data = result.storage();
 
@@ -173,7 +180,7 @@ public:
 
     void reset() noexcept
     {
-        if (m_storage.value.data)
+        if (m_storage.second.data)
         {
             // Recompute the block size at destruction time rather than caching
             // it separately. Relies on the string data still being intact and
@@ -182,37 +189,37 @@ public:
 
             allocator().deallocate(
                 reinterpret_cast<typename allocator_type::value_type*>(
-                    const_cast<C**>(m_storage.value.data)),
+                    const_cast<C**>(m_storage.second.data)),
                 bytes);
 
-            m_storage.value.data = nullptr;
-            m_storage.value.count = 0;
+            m_storage.second.data = nullptr;
+            m_storage.second.count = 0;
         }
     }
 
     array_type data() const noexcept
     {
-        return m_storage.value.data;
+        return m_storage.second.data;
     }
 
     size_t size() const noexcept
     {
-        return m_storage.value.count;
+        return m_storage.second.count;
     }
 
     bool empty() const noexcept
     {
-        return m_storage.value.count == 0;
+        return m_storage.second.count == 0;
     }
 
     string_type operator[](size_t index) const noexcept
     {
-        return m_storage.value.data[index];
+        return m_storage.second.data[index];
     }
 
     explicit operator bool() const noexcept
     {
-        return m_storage.value.data != nullptr;
+        return m_storage.second.data != nullptr;
     }
 
     const allocator_type& get_allocator() const noexcept
@@ -225,29 +232,29 @@ private:
     C* storage() noexcept
     {
         return reinterpret_cast<C*>(
-            reinterpret_cast<unsigned char*>(const_cast<C**>(m_storage.value.data)) +
+            reinterpret_cast<unsigned char*>(const_cast<C**>(m_storage.second.data)) +
             pointer_table_bytes());
     }
 
     const C* storage() const noexcept
     {
         return reinterpret_cast<const C*>(
-            reinterpret_cast<const unsigned char*>(m_storage.value.data) +
+            reinterpret_cast<const unsigned char*>(m_storage.second.data) +
             pointer_table_bytes());
     }
 
     size_t pointer_table_bytes() const noexcept
     {
-        return (m_storage.value.count + 1) * sizeof(const C*);
+        return (m_storage.second.count + 1) * sizeof(const C*);
     }
 
     size_t calculate_total_bytes() const noexcept
     {
         size_t bytes = pointer_table_bytes();
 
-        for (size_t i = 0; i < m_storage.value.count; ++i)
+        for (size_t i = 0; i < m_storage.second.count; ++i)
         {
-            const size_t length = str::length(m_storage.value.data[i]) + 1;
+            const size_t length = str::length(m_storage.second.data[i]) + 1;
             bytes += length * sizeof(C);
         }
 
@@ -0,0 +1,537 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+
+#include "vertex/std/_tools/raw_hash_table.hpp"
+#include "vertex/std/vector.hpp"
+
+namespace vx {
+
+namespace _hash_table_priv {
+
+template <typename Key>
+struct set_policy
+{
+    using key_type = Key;
+    using value_type = Key;
+    using constant_iterators = std::true_type;
+
+    static const key_type& key(const value_type& value) noexcept
+    {
+        return value;
+    }
+
+    static void transfer(value_type* dst, value_type* src) noexcept
+    {
+        VX_IF_CONSTEXPR (std::is_trivially_copyable<value_type>::value)
+        {
+            mem::copy(static_cast<void*>(dst), static_cast<const void*>(src), sizeof(value_type));
+        }
+        else
+        {
+            mem::construct_in_place(dst, std::move(*src));
+            mem::destroy_in_place(src);
+        }
+    }
+};
+
+} // namespace _hash_table_priv
+
+//=========================================================================
+// hash_set
+//=========================================================================
+
+// Flat open addressing hash set, see hash_map. Iterators are invalidated
+// whenever the table grows.
+template <
+    typename Key,
+    typename Hash = vx::hash<Key>,
+    typename KeyEqual = vx::equal_to<Key>,
+    typename Allocator = mem::default_allocator<Key>>
+class hash_set : public _hash_table_priv::raw_hash_table<_hash_table_priv::set_policy<Key>, Hash, KeyEqual, Allocator>
+{
+    using base = _hash_table_priv::raw_hash_table<_hash_table_priv::set_policy<Key>, Hash, KeyEqual, Allocator>;
+
+public:
+
+    using key_type = Key;
+    using value_type = typename base::value_type;
+    using size_type = typename base::size_type;
+    using iterator = typename base::iterator;
+    using const_iterator = typename base::const_iterator;
+
+    using base::base;
+
+    hash_set() noexcept = default;
+};
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool operator==(const hash_set<Key, Hash, KeyEqual, Allocator>& lhs, const hash_set<Key, Hash, KeyEqual, Allocator>& rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+
+    for (const auto& value : lhs)
+    {
+        if (!rhs.contains(value))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+bool operator!=(const hash_set<Key, Hash, KeyEqual, Allocator>& lhs, const hash_set<Key, Hash, KeyEqual, Allocator>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename Key, typename Hash, typename KeyEqual, typename Allocator>
+void swap(hash_set<Key, Hash, KeyEqual, Allocator>& lhs, hash_set<Key, Hash, KeyEqual, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+//=========================================================================
+// flat_set
+//=========================================================================
+
+// Sorted set backed by a single contiguous vector. Lookup is a binary search
+// and iteration is a linear scan, which makes it a good fit for sets that are
+// built once and queried often. Single inserts and erases are O(n), so prefer
+// the range insert when adding many values at once: new values are appended,
+// sorted and merged in a single pass.
+template <
+    typename Key,
+    typename Compare = std::less<Key>,
+    typename Allocator = mem::default_allocator<Key>>
+class flat_set
+{
+public:
+
+    using container_type = vector<Key, Allocator>;
+
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference = const value_type&;
+    using const_reference = const value_type&;
+    using pointer = const value_type*;
+    using const_pointer = const value_type*;
+
+    // values are their own keys and must never be modified in place
+    using iterator = _priv::pointer_iterator<flat_set, const value_type>;
+    using const_iterator = iterator;
+    using reverse_iterator = _priv::reverse_pointer_iterator<iterator>;
+    using const_reverse_iterator = reverse_iterator;
+
+private:
+
+    template <typename K>
+    using key_arg = typename _priv::key_arg_impl<is_transparent<Compare>::value>::template type<K, key_type>;
+
+    _priv::compressed_pair<key_compare, container_type> m_storage;
+
+    key_compare& m_compare() noexcept { return m_storage.first(); }
+    const key_compare& m_compare() const noexcept { return m_storage.first(); }
+
+    container_type& m_data() noexcept { return m_storage.second; }
+    const container_type& m_data() const noexcept { return m_storage.second; }
+
+public:
+
+    //=========================================================================
+    // constructors
+    //=========================================================================
+
+    flat_set() noexcept(noexcept(key_compare()) && noexcept(allocator_type()))
+        : m_storage(_priv::zero_then_variadic_args_tag{})
+    {}
+
+    explicit flat_set(const key_compare& comp, const allocator_type& alloc = allocator_type())
+        : m_storage(_priv::one_then_variadic_args_tag{}, comp, alloc)
+    {}
+
+    explicit flat_set(const allocator_type& alloc)
+        : m_storage(_priv::zero_then_variadic_args_tag{}, alloc)
+    {}
+
+    template <typename IT, VX_REQUIRES(type_traits::is_iterator<IT>::value)>
+    flat_set(IT first, IT last, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+        : flat_set(comp, alloc)
+    {
+        if (!insert(first, last))
+        {
+            err::fast_fail();
+        }
+    }
+
+    flat_set(std::initializer_list<value_type> init, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+        : flat_set(init.begin(), init.end(), comp, alloc)
+    {}
+
+    // takes ownership of an unsorted container, sorting it and removing
+    // duplicates in place
+    explicit flat_set(container_type&& values, const key_compare& comp = key_compare())
+        : m_storage(_priv::one_then_variadic_args_tag{}, comp, std::move(values))
+    {
+        sort_and_unique(0);
+    }
+
+    flat_set(const flat_set&) = default;
+    flat_set(flat_set&&) noexcept = default;
+
+    ~flat_set() = default;
+
+    //=========================================================================
+    // assignment
+    //=========================================================================
+
+    flat_set& operator=(const flat_set&) = default;
+    flat_set& operator=(flat_set&&) noexcept = default;
+
+    flat_set& operator=(std::initializer_list<value_type> init)
+    {
+        clear();
+        if (!insert(init.begin(), init.end()))
+        {
+            err::fast_fail();
+        }
+        return *this;
+    }
+
+    //=========================================================================
+    // observers
+    //=========================================================================
+
+    allocator_type get_allocator() const noexcept
+    {
+        return m_data().get_allocator();
+    }
+
+    key_compare key_comp() const
+    {
+        return m_compare();
+    }
+
+    value_compare value_comp() const
+    {
+        return m_compare();
+    }
+
+    // the underlying storage is always sorted and free of duplicates
+    const container_type& values() const noexcept
+    {
+        return m_data();
+    }
+
+    // releases the underlying storage, leaving the set empty
+    container_type extract() noexcept
+    {
+        container_type values(std::move(m_data()));
+        m_data().clear();
+        return values;
+    }
+
+    //=========================================================================
+    // iterators
+    //=========================================================================
+
+    const_pointer data() const noexcept { return m_data().data(); }
+
+    const_iterator begin() const noexcept { return const_iterator(data()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    const_iterator end() const noexcept { return const_iterator(data() + size()); }
+    const_iterator cend() const noexcept { return end(); }
+
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    //=========================================================================
+    // capacity
+    //=========================================================================
+
+    bool empty() const noexcept { return m_data().empty(); }
+    size_type size() const noexcept { return m_data().size(); }
+    size_type capacity() const noexcept { return m_data().capacity(); }
+    size_type max_size() const noexcept { return m_data().max_size(); }
+
+    success reserve(size_type count)
+    {
+        return m_data().reserve(count);
+    }
+
+    success shrink_to_fit()
+    {
+        return m_data().shrink_to_fit();
+    }
+
+    //=========================================================================
+    // memory
+    //=========================================================================
+
+    void clear()
+    {
+        m_data().clear();
+    }
+
+    void clear_and_deallocate()
+    {
+        m_data().clear_and_deallocate();
+    }
+
+    void swap(flat_set& other) noexcept
+    {
+        mem::swap(m_storage, other.m_storage);
+    }
+
+    //=========================================================================
+    // lookup
+    //=========================================================================
+
+    template <typename K = key_type>
+    const_iterator lower_bound(const key_arg<K>& key) const
+    {
+        return const_iterator(std::lower_bound(data(), data() + size(), key, m_compare()));
+    }
+
+    template <typename K = key_type>
+    const_iterator upper_bound(const key_arg<K>& key) const
+    {
+        return const_iterator(std::upper_bound(data(), data() + size(), key, m_compare()));
+    }
+
+    template <typename K = key_type>
+    std::pair<const_iterator, const_iterator> equal_range(const key_arg<K>& key) const
+    {
+        const auto range = std::equal_range(data(), data() + size(), key, m_compare());
+        return { const_iterator(range.first), const_iterator(range.second) };
+    }
+
+    template <typename K = key_type>
+    const_iterator find(const key_arg<K>& key) const
+    {
+        const const_iterator it = lower_bound(key);
+        return (it != end() && !m_compare()(key, *it)) ? it : end();
+    }
+
+    template <typename K = key_type>
+    bool contains(const key_arg<K>& key) const
+    {
+        return find(key) != end();
+    }
+
+    template <typename K = key_type>
+    size_type count(const key_arg<K>& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    //=========================================================================
+    // insert
+    //=========================================================================
+
+    expected<std::pair<iterator, bool>, error> insert(const value_type& value)
+    {
+        return insert_value(value);
+    }
+
+    expected<std::pair<iterator, bool>, error> insert(value_type&& value)
+    {
+        return insert_value(std::move(value));
+    }
+
+    template <typename... Args>
+    expected<std::pair<iterator, bool>, error> emplace(Args&&... args)
+    {
+        return insert_value(value_type(std::forward<Args>(args)...));
+    }
+
+    // appends the whole range, then sorts the new values and merges them
+    // with the existing ones, which is O((n + m) log m) instead of O(n * m)
+    // for m individual inserts. If an append fails the set is left as it was.
+    template <typename IT, VX_REQUIRES(type_traits::is_iterator<IT>::value)>
+    success insert(IT first, IT last)
+    {
+        const size_type old_size = size();
+
+        for (; first != last; ++first)
+        {
+            VX_UNLIKELY_COLD_PATH(!m_data().emplace_back(*first),
+                {
+                    m_data().erase(m_data().begin() + old_size, m_data().end());
+                    return make_error(err::out_of_memory);
+                });
+        }
+
+        sort_and_unique(old_size);
+        return make_error(err::none);
+    }
+
+    success insert(std::initializer_list<value_type> init)
+    {
+        return insert(init.begin(), init.end());
+    }
+
+    //=========================================================================
+    // erase
+    //=========================================================================
+
+    iterator erase(const_iterator pos)
+    {
+        const auto it = m_data().erase(to_container_iterator(pos));
+        return iterator(it.ptr());
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        const auto it = m_data().erase(to_container_iterator(first), to_container_iterator(last));
+        return iterator(it.ptr());
+    }
+
+    template <typename K = key_type>
+    size_type erase(const key_arg<K>& key)
+    {
+        const const_iterator it = find(key);
+        if (it == end())
+        {
+            return 0;
+        }
+
+        erase(it);
+        return 1;
+    }
+
+    // erases every element for which pred returns true, returns the number erased
+    template <typename Pred>
+    size_type erase_if(Pred pred)
+    {
+        const size_type old_size = size();
+
+        auto& data = m_data();
+        const auto new_end = std::remove_if(data.begin(), data.end(), pred);
+        data.erase(new_end, data.end());
+
+        return old_size - size();
+    }
+
+private:
+
+    typename container_type::const_iterator to_container_iterator(const_iterator it) const noexcept
+    {
+        return m_data().cbegin() + (it - begin());
+    }
+
+    template <typename V>
+    expected<std::pair<iterator, bool>, error> insert_value(V&& value)
+    {
+        const const_iterator pos = lower_bound(value);
+        if (pos != end() && !m_compare()(value, *pos))
+        {
+            return std::pair<iterator, bool>(pos, false);
+        }
+
+        const auto off = static_cast<size_type>(pos - begin());
+        const auto res = m_data().emplace(off, std::forward<V>(value));
+        if (!res)
+        {
+            return make_unexpected(res.error());
+        }
+
+        return std::pair<iterator, bool>(iterator(res.value().ptr()), true);
+    }
+
+    // values before sorted_count are already sorted and unique
+    void sort_and_unique(const size_type sorted_count)
+    {
+        auto& data = m_data();
+        value_type* first = data.data();
+        value_type* mid = first + sorted_count;
+        value_type* last = first + data.size();
+
+        if (mid == last)
+        {
+            return;
+        }
+
+        const key_compare& comp = m_compare();
+        std::sort(mid, last, comp);
+
+        // skip the merge when the new values all sort after the old ones,
+        // which is common when building from mostly ordered input
+        if (first != mid && comp(*mid, *(mid - 1)))
+        {
+            std::inplace_merge(first, mid, last, comp);
+        }
+
+        // in a sorted range, neighbors are equivalent when the first does
+        // not compare less than the second
+        const auto new_last = std::unique(first, last, [&comp](const value_type& lhs, const value_type& rhs) {
+            return !comp(lhs, rhs);
+        });
+
+        data.erase(data.cbegin() + (new_last - first), data.cend());
+    }
+};
+
+//=========================================================================
+// comparison
+//=========================================================================
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator==(const flat_set<Key, Compare, Allocator>& lhs, const flat_set<Key, Compare, Allocator>& rhs)
+{
+    return lhs.values() == rhs.values();
+}
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator!=(const flat_set<Key, Compare, Allocator>& lhs, const flat_set<Key, Compare, Allocator>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator<(const flat_set<Key, Compare, Allocator>& lhs, const flat_set<Key, Compare, Allocator>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator>(const flat_set<Key, Compare, Allocator>& lhs, const flat_set<Key, Compare, Allocator>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator<=(const flat_set<Key, Compare, Allocator>& lhs, const flat_set<Key, Compare, Allocator>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <typename Key, typename Compare, typename Allocator>
+bool operator>=(const flat_set<Key, Compare, Allocator>& lhs, const flat_set<Key, Compare, Allocator>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+template <typename Key, typename Compare, typename Allocator>
+void swap(flat_set<Key, Compare, Allocator>& lhs, flat_set<Key, Compare, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+} // namespace vx
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <climits>
 #include <ratio>
 #include <sstream>
 
@@ -8,10 +9,185 @@
 #include "vertex/std/char_traits.hpp"
 #include "vertex/std/cstring_view.hpp"
 #include "vertex/std/string_view.hpp"
+#include "vertex/util/bit/endian.hpp"
 
 namespace vx {
 namespace str {
 
+namespace _string_priv {
+
+//=========================================================================
+// string_data
+//=========================================================================
+
+// Storage for basic_string with an inline small string buffer. Short strings
+// live directly inside the 3 word footprint of the long representation
+// (22 chars for char on 64 bit targets).
+//
+// The last byte of the representation is used as a tag. In short mode it
+// holds the size (always < 0x80). In long mode the high bit is set, which is
+// folded into the encoded capacity so that the long layout stays ptr/size/capacity.
+template <typename T>
+struct string_data
+{
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+private:
+
+    struct long_type
+    {
+        pointer ptr;
+        size_type size;
+        size_type capacity;
+    };
+
+    static constexpr size_type short_slots = sizeof(long_type) / sizeof(T);
+
+    union rep
+    {
+        long_type l;
+        T s[short_slots];
+    };
+
+    static constexpr unsigned char long_flag = 0x80;
+
+#if VX_ORDER_NATIVE_ENDIAN == VX_ORDER_LITTLE_ENDIAN
+    static constexpr size_type long_capacity_flag = static_cast<size_type>(long_flag) << ((sizeof(size_type) - 1) * CHAR_BIT);
+#endif
+
+    rep m_rep;
+
+public:
+
+    // the last slot holds the tag and another is reserved for the null terminator
+    static constexpr size_type short_capacity = short_slots - 2;
+    // the top byte of the long capacity is shared with the tag
+    static constexpr size_type max_capacity = ~size_type(0) >> CHAR_BIT;
+
+    VX_STATIC_ASSERT_MSG(short_slots >= 3, "character type too large for inline storage");
+    VX_STATIC_ASSERT_MSG(short_capacity < long_flag, "short size must fit in the tag");
+
+    // all zero bytes is an empty short string with a null terminator
+    string_data() noexcept
+        : m_rep{}
+    {}
+
+    bool is_long() const noexcept
+    {
+        return (tag() & long_flag) != 0;
+    }
+
+    pointer ptr() noexcept
+    {
+        return is_long() ? m_rep.l.ptr : m_rep.s;
+    }
+
+    const_pointer ptr() const noexcept
+    {
+        return is_long() ? m_rep.l.ptr : m_rep.s;
+    }
+
+    size_type size() const noexcept
+    {
+        return is_long() ? m_rep.l.size : static_cast<size_type>(tag());
+    }
+
+    size_type capacity() const noexcept
+    {
+        return is_long() ? decode_capacity(m_rep.l.capacity) : short_capacity;
+    }
+
+    void set_size(size_type size) noexcept
+    {
+        if (is_long())
+        {
+            m_rep.l.size = size;
+        }
+        else
+        {
+            VX_ASSERT(size <= short_capacity);
+            set_tag(static_cast<unsigned char>(size));
+        }
+    }
+
+    void set_long(pointer ptr, size_type size, size_type capacity) noexcept
+    {
+        VX_ASSERT(capacity <= max_capacity);
+
+        m_rep.l.ptr = ptr;
+        m_rep.l.size = size;
+        m_rep.l.capacity = encode_capacity(capacity);
+    }
+
+    // switches to short mode, the caller is responsible for the characters
+    pointer set_short(size_type size) noexcept
+    {
+        VX_ASSERT(size <= short_capacity);
+
+        set_tag(static_cast<unsigned char>(size));
+        return m_rep.s;
+    }
+
+    void reset() noexcept
+    {
+        m_rep = rep{};
+    }
+
+    void acquire(string_data& other) noexcept
+    {
+        m_rep = other.m_rep;
+        other.reset();
+    }
+
+private:
+
+    unsigned char tag() const noexcept
+    {
+        return reinterpret_cast<const unsigned char*>(&m_rep)[sizeof(rep) - 1];
+    }
+
+    void set_tag(unsigned char t) noexcept
+    {
+        reinterpret_cast<unsigned char*>(&m_rep)[sizeof(rep) - 1] = t;
+    }
+
+#if VX_ORDER_NATIVE_ENDIAN == VX_ORDER_LITTLE_ENDIAN
+
+    // the tag is the most significant byte of the capacity
+    static size_type encode_capacity(size_type capacity) noexcept
+    {
+        return capacity | long_capacity_flag;
+    }
+
+    static size_type decode_capacity(size_type capacity) noexcept
+    {
+        return capacity & max_capacity;
+    }
+
+#else
+
+    // the tag is the least significant byte of the capacity
+    static size_type encode_capacity(size_type capacity) noexcept
+    {
+        return (capacity << CHAR_BIT) | long_flag;
+    }
+
+    static size_type decode_capacity(size_type capacity) noexcept
+    {
+        return capacity >> CHAR_BIT;
+    }
+
+#endif // VX_ORDER_NATIVE_ENDIAN == VX_ORDER_LITTLE_ENDIAN
+};
+
+} // namespace _string_priv
+
 template <typename T, typename Allocator = mem::default_allocator<T>>
 class basic_string
 {
@@ -30,7 +206,7 @@ private:
     struct is_compatible_string : is_string_of<S, T>
     {};
 
-    using data_type = _dynamic_array_base_priv::dynamic_array_data<T>;
+    using data_type = _string_priv::string_data<T>;
 
 public:
 
@@ -87,39 +263,43 @@ private:
     // allocation helpers
     //=========================================================================
 
-    static void destroy_size(T* ptr, size_type size)
-    {
-        mem::destroy_range(ptr, size + 1);
-    }
-
     // no longer static: freeing memory requires the instance's allocator
     void deallocate_capacity(T* ptr, size_type capacity)
     {
         m_allocator().deallocate(ptr, capacity + 1);
     }
 
-    // no longer static, since it calls deallocate_capacity
-    void destroy_and_deallocate(T* ptr, size_type size, size_type capacity)
+    // frees the heap buffer if there is one, the inline buffer needs no cleanup
+    void deallocate_long()
     {
-        destroy_size(ptr, size);
-        deallocate_capacity(ptr, capacity);
+        if (m_data().is_long())
+        {
+            deallocate_capacity(m_data().ptr(), m_data().capacity());
+        }
     }
 
-    void destroy_range()
+    // allocates room for capacity characters plus the null terminator
+    pointer allocate_long(size_type capacity)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
+        pointer new_ptr = m_allocator().allocate(capacity + 1);
 
-        if (ptr)
-        {
-            mem::destroy_range(ptr, size);
-            m_allocator().deallocate(ptr, capacity);
-        }
+#if !defined(VX_ALLOCATE_FAIL_FAST)
 
-        ptr = nullptr;
-        size = 0;
-        capacity = 0;
+        VX_UNLIKELY_COLD_PATH(!new_ptr,
+            {
+                return nullptr;
+            });
+
+#endif // !defined(VX_ALLOCATE_FAIL_FAST)
+
+        mem::construct_range_maybe_trivial(new_ptr, capacity + 1);
+        return new_ptr;
+    }
+
+    void destroy_range()
+    {
+        deallocate_long();
+        m_data().reset();
     }
 
     //=========================================================================
@@ -135,63 +315,48 @@ private:
         from_iterator_range
     };
 
-    bool construct_empty()
+    // empty strings use the inline buffer, so this never allocates
+    void construct_empty() noexcept
     {
-        auto new_ptr = m_allocator().allocate(1);
-
-#if !defined(VX_ALLOCATE_FAIL_FAST)
-
-        VX_UNLIKELY_COLD_PATH(!new_ptr,
-            {
-                return false;
-            });
-
-#endif // !defined(VX_ALLOCATE_FAIL_FAST)
-
-        m_data().ptr = new_ptr;
-        m_data().size = 0;
-        m_data().capacity = 0;
-
-        mem::construct_in_place(m_data().ptr);
-        traits_type::assign(*m_data().ptr, T());
-
-        return true;
+        traits_type::assign(*m_data().set_short(0), T());
     }
 
     template <construct_method M, typename... Args>
     void construct_n(size_type count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
+        const size_type alloc_count = count + 1;
+        pointer ptr;
+
+        if (count <= data_type::short_capacity)
+        {
+            ptr = m_data().set_short(count);
+        }
+        else
+        {
 
 #if !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
-        VX_UNLIKELY_COLD_PATH(count > max_size(),
-            {
-                err::set(err::size_error);
-                return;
-            });
+            VX_UNLIKELY_COLD_PATH(count > max_size(),
+                {
+                    err::set(err::size_error);
+                    return;
+                });
 
 #endif // !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
-        const size_type alloc_count = count + 1;
-        auto new_ptr = m_allocator().allocate(alloc_count);
+            ptr = allocate_long(count);
 
 #if !defined(VX_ALLOCATE_FAIL_FAST)
 
-        VX_UNLIKELY_COLD_PATH(!new_ptr,
-            {
-                return;
-            });
+            VX_UNLIKELY_COLD_PATH(!ptr,
+                {
+                    return;
+                });
 
 #endif // !defined(VX_ALLOCATE_FAIL_FAST)
 
-        ptr = new_ptr;
-        size = count;
-        capacity = count;
-
-        mem::construct_range_maybe_trivial(ptr, alloc_count);
+            m_data().set_long(ptr, count, count);
+        }
 
         VX_IF_CONSTEXPR (M == construct_method::from_char_count)
         {
@@ -369,9 +534,10 @@ public:
 
     //=========================================================================
 
+    // strings always have a buffer to point at, either inline or on the heap
     bool is_valid() const noexcept
     {
-        return m_data().ptr != nullptr;
+        return m_data().ptr() != nullptr;
     }
 
 public:
@@ -433,10 +599,6 @@ private:
     template <construct_method M, typename... Args>
     bool assign_from(const size_type count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
-
 #if !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
         VX_UNLIKELY_COLD_PATH(count > max_size(),
@@ -447,9 +609,11 @@ private:
 
 #endif // !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
-        if (count > capacity)
+        pointer ptr = m_data().ptr();
+
+        if (count > m_data().capacity())
         {
-            pointer new_ptr = m_allocator().allocate(count + 1);
+            pointer new_ptr = allocate_long(count);
 
 #if !defined(VX_ALLOCATE_FAIL_FAST)
 
@@ -460,19 +624,9 @@ private:
 
 #endif // !defined(VX_ALLOCATE_FAIL_FAST)
 
-            mem::construct_range_maybe_trivial(new_ptr, count + 1);
-            destroy_and_deallocate(ptr, size, capacity);
-
+            deallocate_long();
+            m_data().set_long(new_ptr, count, count);
             ptr = new_ptr;
-            capacity = count;
-        }
-        else if (count > size)
-        {
-            mem::construct_range_maybe_trivial(ptr + size + 1, count - size);
-        }
-        else if (count < size)
-        {
-            mem::destroy_range(ptr + count + 1, size - count);
         }
 
         VX_IF_CONSTEXPR (M == construct_method::from_char)
@@ -502,7 +656,7 @@ private:
             traits_type::assign(ptr[count], T());
         }
 
-        size = count;
+        m_data().set_size(count);
         return true;
     }
 
@@ -673,53 +827,53 @@ public:
 
     T& front() noexcept
     {
-        VX_ASSERT(m_data().size > 0);
-        return m_data().ptr[0];
+        VX_ASSERT(m_data().size() > 0);
+        return m_data().ptr()[0];
     }
 
     const T& front() const noexcept
     {
-        VX_ASSERT(m_data().size > 0);
-        return m_data().ptr[0];
+        VX_ASSERT(m_data().size() > 0);
+        return m_data().ptr()[0];
     }
 
     T& back() noexcept
     {
-        VX_ASSERT(m_data().size > 0);
-        return m_data().ptr[m_data().size - 1];
+        VX_ASSERT(m_data().size() > 0);
+        return m_data().ptr()[m_data().size() - 1];
     }
 
     const T& back() const noexcept
     {
-        VX_ASSERT(m_data().size > 0);
-        return m_data().ptr[m_data().size - 1];
+        VX_ASSERT(m_data().size() > 0);
+        return m_data().ptr()[m_data().size() - 1];
     }
 
     T* data() noexcept
     {
-        return m_data().ptr;
+        return m_data().ptr();
     }
 
     const T* data() const noexcept
     {
-        return m_data().ptr;
+        return m_data().ptr();
     }
 
     T& operator[](size_type i) noexcept
     {
-        VX_ASSERT(i < m_data().size);
-        return m_data().ptr[i];
+        VX_ASSERT(i < m_data().size());
+        return m_data().ptr()[i];
     }
 
     const T& operator[](size_type i) const noexcept
     {
-        VX_ASSERT(i < m_data().size);
-        return m_data().ptr[i];
+        VX_ASSERT(i < m_data().size());
+        return m_data().ptr()[i];
     }
 
     const T* c_str() const noexcept
     {
-        return m_data().ptr;
+        return m_data().ptr();
     }
 
     //=========================================================================
@@ -728,12 +882,12 @@ public:
 
     iterator begin() noexcept
     {
-        return iterator(m_data().ptr);
+        return iterator(m_data().ptr());
     }
 
     const_iterator begin() const noexcept
     {
-        return const_iterator(m_data().ptr);
+        return const_iterator(m_data().ptr());
     }
 
     const_iterator cbegin() const noexcept
@@ -743,12 +897,12 @@ public:
 
     iterator end() noexcept
     {
-        return iterator(m_data().ptr + m_data().size);
+        return iterator(m_data().ptr() + m_data().size());
     }
 
     const_iterator end() const noexcept
     {
-        return const_iterator(m_data().ptr + m_data().size);
+        return const_iterator(m_data().ptr() + m_data().size());
     }
 
     const_iterator cend() const noexcept
@@ -795,13 +949,10 @@ private:
     template <construct_method M, typename... Args>
     bool append_capacity(size_type count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
+        const pointer ptr = m_data().ptr();
+        const size_type size = m_data().size() + count;
 
-        T* const dst = ptr + size;
-
-        // we increase the size early so we can easily assign the null terminator at the end
-        size += count;
+        T* const dst = ptr + size - count;
         mem::construct_range_maybe_trivial(dst + 1, count);
 
         VX_IF_CONSTEXPR (M == construct_method::from_char)
@@ -823,6 +974,7 @@ private:
         }
 
         traits_type::assign(ptr[size], T());
+        m_data().set_size(size);
 
         return true;
     }
@@ -830,9 +982,9 @@ private:
     template <typename growth_rate, construct_method M, typename... Args>
     bool append_reallocate(size_type count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
+        const pointer ptr = m_data().ptr();
+        const size_type size = m_data().size();
+        const size_type capacity = m_data().capacity();
 
 #if !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
@@ -884,12 +1036,9 @@ private:
 
         traits_type::assign(new_ptr[new_size], T());
 
-        // destroy original range
-        destroy_and_deallocate(ptr, size, capacity);
-
-        ptr = new_ptr;
-        size = new_size;
-        capacity = new_capacity;
+        // release original range
+        deallocate_long();
+        m_data().set_long(new_ptr, new_size, new_capacity);
 
         return true;
     }
@@ -900,7 +1049,7 @@ private:
         VX_STATIC_ASSERT_MSG(growth_rate::num >= 0 && growth_rate::den > 0, "Growth rate must be positive");
         VX_STATIC_ASSERT_MSG(growth_rate::num >= growth_rate::den, "Growth rate must be greater or equal to 1");
 
-        const size_type available = m_data().capacity - m_data().size;
+        const size_type available = m_data().capacity() - m_data().size();
 
         if (count <= available)
         {
@@ -1057,8 +1206,8 @@ private:
     template <construct_method M, typename... Args>
     T* insert_capacity(T* pos, size_type count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
+        const pointer ptr = m_data().ptr();
+        const size_type size = m_data().size();
 
         // initialize the new elements that will be moved into uninitialized memory
         const pointer back = ptr + size;
@@ -1086,16 +1235,16 @@ private:
             traits_type::copy_range(pos, std::forward<Args>(args)...);
         }
 
-        size += count;
+        m_data().set_size(size + count);
         return pos;
     }
 
     template <typename growth_rate, construct_method M, typename... Args>
     T* insert_reallocate(T* pos, size_type count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
+        const pointer ptr = m_data().ptr();
+        const size_type size = m_data().size();
+        const size_type capacity = m_data().capacity();
 
 #if !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
@@ -1151,12 +1300,9 @@ private:
         // copy second range (includes null terminator)
         traits_type::copy(dst + count, pos, (size - off) + 1);
 
-        // destroy original range
-        destroy_and_deallocate(ptr, size, capacity);
-
-        ptr = new_ptr;
-        size = new_size;
-        capacity = new_capacity;
+        // release original range
+        deallocate_long();
+        m_data().set_long(new_ptr, new_size, new_capacity);
 
         return dst;
     }
@@ -1168,7 +1314,7 @@ private:
         VX_STATIC_ASSERT_MSG(growth_rate::num >= growth_rate::den, "Growth rate must be greater or equal to 1");
 
         auto ptr = const_cast<T*>(pos);
-        const size_type available = m_data().capacity - m_data().size;
+        const size_type available = m_data().capacity() - m_data().size();
 
         if (count <= available)
         {
@@ -1208,14 +1354,14 @@ public:
     template <typename growth_rate = default_growth_rate>
     basic_string& insert(size_type off, const T c)
     {
-        insert_n<growth_rate, construct_method::from_char>(m_data().ptr + off, 1, c);
+        insert_n<growth_rate, construct_method::from_char>(m_data().ptr() + off, 1, c);
         return *this;
     }
 
     template <typename growth_rate = default_growth_rate>
     basic_string& insert(size_type off, size_type count, const T c)
     {
-        insert_n<growth_rate, construct_method::from_char_count>(m_data().ptr + off, count, c);
+        insert_n<growth_rate, construct_method::from_char_count>(m_data().ptr() + off, count, c);
         return *this;
     }
 
@@ -1225,14 +1371,14 @@ public:
     basic_string& insert(size_type off, const T* const s)
     {
         const size_type count = static_cast<size_type>(traits_type::length(s));
-        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count, s);
+        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count, s);
         return *this;
     }
 
     template <typename growth_rate = default_growth_rate>
     basic_string& insert(size_type off, const T* const s, size_type count)
     {
-        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count, s);
+        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count, s);
         return *this;
     }
 
@@ -1242,7 +1388,7 @@ public:
     basic_string& insert(size_type off, std::initializer_list<T> init)
     {
         const size_type count = static_cast<size_type>(init.size());
-        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count, init.begin());
+        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count, init.begin());
         return *this;
     }
 
@@ -1254,11 +1400,11 @@ public:
         const size_type count = static_cast<size_type>(std::distance(first, last));
         VX_IF_CONSTEXPR (vx::_priv::is_forward_pointer_iterator<IT>::value)
         {
-            insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count, first.ptr());
+            insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count, first.ptr());
         }
         else
         {
-            insert_n<growth_rate, construct_method::from_iterator_range>(m_data().ptr + off, count, first, last);
+            insert_n<growth_rate, construct_method::from_iterator_range>(m_data().ptr() + off, count, first, last);
         }
         return *this;
     }
@@ -1269,7 +1415,7 @@ public:
     basic_string& insert(size_type off, const S& t)
     {
         const size_type count = static_cast<size_type>(t.size());
-        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count, t.data());
+        insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count, t.data());
         return *this;
     }
 
@@ -1279,7 +1425,7 @@ public:
         if (_char_traits_priv::check_offset(t.size(), t_off))
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(t.size(), t_off, count));
-            insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count, t.data() + t_off);
+            insert_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count, t.data() + t_off);
         }
         return *this;
     }
@@ -1397,30 +1543,36 @@ public:
 
     void clear()
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-
-        mem::destroy_range(ptr, size);
-        size = 0;
-
-        traits_type::assign(*m_data().ptr, T());
+        traits_type::assign(*m_data().ptr(), T());
+        m_data().set_size(0);
     }
 
     void clear_and_deallocate()
     {
-        destroy_and_deallocate(m_data().ptr, m_data().size, m_data().capacity);
+        destroy_range();
         construct_empty();
     }
 
     bool shrink_to_fit()
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
+        if (!m_data().is_long())
+        {
+            return true;
+        }
+
+        const pointer ptr = m_data().ptr();
+        const size_type size = m_data().size();
+        const size_type capacity = m_data().capacity();
 
-        if (capacity > size)
+        if (size <= data_type::short_capacity)
         {
-            pointer new_ptr = m_allocator().allocate(size);
+            // move back into the inline buffer, which overlaps the long representation
+            traits_type::copy(m_data().set_short(size), ptr, size + 1);
+            deallocate_capacity(ptr, capacity);
+        }
+        else if (capacity > size)
+        {
+            pointer new_ptr = allocate_long(size);
 
 #if !defined(VX_ALLOCATE_FAIL_FAST)
 
@@ -1431,21 +1583,40 @@ public:
 
 #endif // !defined(VX_ALLOCATE_FAIL_FAST)
 
-            VX_ASSERT(size > 0);
-            mem::construct_range_maybe_trivial(new_ptr, size);
-            traits_type::copy(new_ptr, ptr, size);
-            destroy_and_deallocate(ptr, size, capacity);
-
-            ptr = new_ptr;
-            capacity = size;
+            traits_type::copy(new_ptr, ptr, size + 1);
+            deallocate_capacity(ptr, capacity);
+            m_data().set_long(new_ptr, size, size);
         }
 
         return true;
     }
 
-    T* release() noexcept
+    // the returned buffer is always heap allocated, so short strings are
+    // copied out of the inline buffer first
+    T* release()
     {
-        return m_data().release().ptr;
+        pointer ptr = m_data().ptr();
+
+        if (!m_data().is_long())
+        {
+            const size_type size = m_data().size();
+            pointer new_ptr = allocate_long(size);
+
+#if !defined(VX_ALLOCATE_FAIL_FAST)
+
+            if (!new_ptr)
+            {
+                return nullptr;
+            }
+
+#endif // !defined(VX_ALLOCATE_FAIL_FAST)
+
+            traits_type::copy(new_ptr, ptr, size + 1);
+            ptr = new_ptr;
+        }
+
+        m_data().reset();
+        return ptr;
     }
 
     bool acquire(T* ptr)
@@ -1463,15 +1634,13 @@ public:
 #endif // !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
         destroy_range();
-
-        m_data().ptr = ptr;
-        m_data().size = count;
-        m_data().capacity = count;
+        m_data().set_long(ptr, count, count);
         return true;
     }
 
     // swap keeps allocator and buffer_type glued together, same reasoning as move:
-    // each buffer_type must stay paired with the allocator that produced it
+    // each buffer_type must stay paired with the allocator that produced it.
+    // inline buffers are position independent so they can be swapped bytewise
     void swap(basic_string& other) noexcept
     {
         mem::swap(m_storage, other.m_storage);
@@ -1483,17 +1652,17 @@ public:
 
     bool empty() const noexcept
     {
-        return m_data().size == 0;
+        return m_data().size() == 0;
     }
 
     bool full() const noexcept
     {
-        return m_data().size == max_size();
+        return m_data().size() == max_size();
     }
 
     size_type size() const noexcept
     {
-        return m_data().size;
+        return m_data().size();
     }
 
     size_type length() const noexcept
@@ -1511,14 +1680,17 @@ public:
         const size_type alloc_max = static_cast<size_type>(
             std::allocator_traits<allocator_type>::max_size(m_allocator()));
 
-        return (std::min)(static_cast<size_type>(std::numeric_limits<difference_type>::max()),
+        const size_type limit = (std::min)(static_cast<size_type>(std::numeric_limits<difference_type>::max()),
             static_cast<size_type>(alloc_max - 1) // -1 for null terminator
         );
+
+        // the long capacity shares its top byte with the inline tag
+        return (std::min)(limit, data_type::max_capacity);
     }
 
     size_type capacity() const noexcept
     {
-        return m_data().capacity;
+        return m_data().capacity();
     }
 
     //=========================================================================
@@ -1527,11 +1699,7 @@ public:
 
     bool reserve(size_type new_capacity)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
-
-        if (new_capacity <= capacity)
+        if (new_capacity <= m_data().capacity())
         {
             return true;
         }
@@ -1546,8 +1714,7 @@ public:
 
 #endif // !defined(VX_STRING_DISABLE_MAX_SIZE_CHECK)
 
-        const size_type alloc_capacity = new_capacity + 1;
-        pointer new_ptr = m_allocator().allocate(alloc_capacity);
+        pointer new_ptr = allocate_long(new_capacity);
 
 #if !defined(VX_ALLOCATE_FAIL_FAST)
 
@@ -1558,12 +1725,11 @@ public:
 
 #endif // !defined(VX_ALLOCATE_FAIL_FAST)
 
-        mem::construct_range_maybe_trivial(new_ptr, alloc_capacity);
-        traits_type::copy(new_ptr, ptr, size + 1);
-        destroy_and_deallocate(ptr, size, capacity);
+        const size_type size = m_data().size();
+        traits_type::copy(new_ptr, m_data().ptr(), size + 1);
 
-        ptr = new_ptr;
-        capacity = new_capacity;
+        deallocate_long();
+        m_data().set_long(new_ptr, size, new_capacity);
 
         return true;
     }
@@ -1574,16 +1740,12 @@ public:
 
     bool resize(size_type new_size, const T c = T())
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
+        const size_type size = m_data().size();
 
         if (new_size <= size)
         {
-            const size_type shrink_count = size - new_size;
-            pointer end_ptr = ptr + new_size;
-            mem::destroy_range(end_ptr + 1, shrink_count);
-            traits_type::assign(*end_ptr, T());
-            m_data().size = new_size;
+            traits_type::assign(m_data().ptr()[new_size], T());
+            m_data().set_size(new_size);
             return true;
         }
 
@@ -1601,17 +1763,14 @@ public:
         VX_STATIC_ASSERT_MSG(growth_rate::num >= 0 && growth_rate::den > 0, "Growth rate must be positive");
         VX_STATIC_ASSERT_MSG(growth_rate::num >= growth_rate::den, "Growth rate must be greater or equal to 1");
 
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
+        const size_type size = m_data().size();
 
-        if (size < capacity)
+        if (size < m_data().capacity())
         {
-            T* const dst = ptr + size;
-            mem::construct_in_place(dst);
+            T* const dst = m_data().ptr() + size;
             traits_type::assign(dst[0], c);
             traits_type::assign(dst[1], T());
-            ++size;
+            m_data().set_size(size + 1);
             return true;
         }
 
@@ -1626,8 +1785,8 @@ private:
 
     T* erase_n(T* pos, size_type count)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
+        const pointer ptr = m_data().ptr();
+        const size_type size = m_data().size();
 
         const size_type off = static_cast<size_type>(pos - ptr);
         const size_type new_size = size - count;
@@ -1638,10 +1797,7 @@ private:
         // new end:  ptr[new_size] must become '\0'
         _char_traits_priv::move_batch(ptr + off, ptr + off + count, tail_count + 1);
 
-        // Destroy removed objects
-        mem::destroy_range(ptr + new_size, count);
-
-        size = new_size;
+        m_data().set_size(new_size);
         return pos;
     }
 
@@ -1652,7 +1808,7 @@ public:
         if (_char_traits_priv::check_offset(size(), off))
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
-            erase_n(m_data().ptr + off, count);
+            erase_n(m_data().ptr() + off, count);
         }
 
         return *this;
@@ -1677,14 +1833,12 @@ public:
 
     void pop_back()
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
+        const size_type size = m_data().size();
 
         if (size > 0)
         {
-            mem::destroy_in_place(ptr + size);
-            --size;
-            traits_type::assign(ptr[size], T());
+            traits_type::assign(m_data().ptr()[size - 1], T());
+            m_data().set_size(size - 1);
         }
     }
 
@@ -1699,7 +1853,7 @@ public:
             return 0;
         }
         count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
-        traits_type::copy(dst, m_data().ptr + off, count);
+        traits_type::copy(dst, m_data().ptr() + off, count);
         return count;
     }
 
@@ -1710,7 +1864,7 @@ public:
             return basic_string(m_allocator());
         }
         count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
-        return basic_string(m_data().ptr + off, count, m_allocator());
+        return basic_string(m_data().ptr() + off, count, m_allocator());
     }
 
     basic_string_view<T> view(size_type off = 0, size_type count = npos) const noexcept
@@ -1720,7 +1874,7 @@ public:
             return basic_string_view<T>();
         }
         count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
-        return basic_string_view<T>(m_data().ptr + off, count);
+        return basic_string_view<T>(m_data().ptr() + off, count);
     }
 
     //=========================================================================
@@ -1732,8 +1886,8 @@ private:
     template <construct_method M, typename... Args>
     bool replace_capacity(pointer pos, size_type in_count, size_type out_count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
+        const pointer ptr = m_data().ptr();
+        size_type size = m_data().size();
 
         if (in_count > out_count)
         {
@@ -1754,8 +1908,6 @@ private:
             const size_type tail_count = static_cast<size_type>(back - (pos + out_count));
             _char_traits_priv::move_batch(pos + in_count, pos + out_count, tail_count);
 
-            mem::destroy_range(back - diff, diff);
-
             size -= diff;
         }
 
@@ -1773,15 +1925,16 @@ private:
             traits_type::copy_range(pos, std::forward<Args>(args)...);
         }
 
+        m_data().set_size(size);
         return true;
     }
 
     template <typename growth_rate, construct_method M, typename... Args>
     bool replace_reallocate(T* pos, size_type in_count, size_type out_count, Args&&... args)
     {
-        auto& ptr = m_data().ptr;
-        auto& size = m_data().size;
-        auto& capacity = m_data().capacity;
+        const pointer ptr = m_data().ptr();
+        const size_type size = m_data().size();
+        const size_type capacity = m_data().capacity();
 
         const size_type new_size = size - out_count + in_count;
         const size_type new_capacity = _dynamic_array_base_priv::grow_capacity<growth_rate>(new_size, capacity, max_size());
@@ -1822,12 +1975,9 @@ private:
         // copy second range
         traits_type::copy(dst + in_count, pos + out_count, (size - off - out_count) + 1);
 
-        // destroy original range
-        destroy_and_deallocate(ptr, size, capacity);
-
-        ptr = new_ptr;
-        size = new_size;
-        capacity = new_capacity;
+        // release original range
+        deallocate_long();
+        m_data().set_long(new_ptr, new_size, new_capacity);
 
         return true;
     }
@@ -1839,15 +1989,12 @@ private:
         VX_STATIC_ASSERT_MSG(growth_rate::num >= growth_rate::den, "Growth rate must be greater or equal to 1");
 
         auto ptr = const_cast<T*>(pos);
-        const size_type available = m_data().capacity - m_data().size;
+        const size_type available = m_data().capacity() - m_data().size();
 
-        if (in_count > out_count)
+        // shrinking or same size replacements always fit in the current buffer
+        if (in_count <= out_count || in_count - out_count <= available)
         {
-            const size_type diff = in_count - out_count;
-            if (diff <= available)
-            {
-                return replace_capacity<M>(ptr, in_count, out_count, std::forward<Args>(args)...);
-            }
+            return replace_capacity<M>(ptr, in_count, out_count, std::forward<Args>(args)...);
         }
         return replace_reallocate<growth_rate, M>(ptr, in_count, out_count, std::forward<Args>(args)...);
     }
@@ -1860,7 +2007,7 @@ public:
         if (_char_traits_priv::check_offset(size(), off))
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
-            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, other.size(), count, other.data());
+            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, other.size(), count, other.data());
         }
         return *this;
     }
@@ -1872,7 +2019,7 @@ public:
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
             count2 = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(other.size(), other_off, count2));
-            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count2, count, other.data() + other_off);
+            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count2, count, other.data() + other_off);
         }
         return *this;
     }
@@ -1885,7 +2032,7 @@ public:
         if (_char_traits_priv::check_offset(size(), off))
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
-            replace_n<growth_rate, construct_method::from_char_count>(m_data().ptr + off, count2, count, c);
+            replace_n<growth_rate, construct_method::from_char_count>(m_data().ptr() + off, count2, count, c);
         }
         return *this;
     }
@@ -1899,7 +2046,7 @@ public:
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
             const size_type count2 = static_cast<size_type>(traits_type::length(s));
-            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count2, count, s);
+            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count2, count, s);
         }
         return *this;
     }
@@ -1910,7 +2057,7 @@ public:
         if (_char_traits_priv::check_offset(size(), off))
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
-            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count2, count, s);
+            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count2, count, s);
         }
         return *this;
     }
@@ -1924,7 +2071,7 @@ public:
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
             const size_type count2 = static_cast<size_type>(init.size());
-            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count2, count, init.begin());
+            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count2, count, init.begin());
         }
         return *this;
     }
@@ -1940,11 +2087,11 @@ public:
             const size_type count2 = static_cast<size_type>(std::distance(first, last));
             VX_IF_CONSTEXPR (vx::_priv::is_forward_pointer_iterator<IT>::value)
             {
-                replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count2, count, first.ptr());
+                replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count2, count, first.ptr());
             }
             else
             {
-                replace_n<growth_rate, construct_method::from_iterator_range>(m_data().ptr + off, count2, count, first, last);
+                replace_n<growth_rate, construct_method::from_iterator_range>(m_data().ptr() + off, count2, count, first, last);
             }
         }
         return *this;
@@ -1959,7 +2106,7 @@ public:
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
             const size_type count2 = static_cast<size_type>(t.size());
-            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count2, count, t.data());
+            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count2, count, t.data());
         }
         return *this;
     }
@@ -1971,7 +2118,7 @@ public:
         {
             count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
             count2 = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(t.size(), t_off, count2));
-            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr + off, count2, count, t.data() + t_off);
+            replace_n<growth_rate, construct_method::from_pointer>(m_data().ptr() + off, count2, count, t.data() + t_off);
         }
         return *this;
     }
@@ -2111,33 +2258,33 @@ public:
     size_type find(const basic_string& other, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find<traits_type>(
-            m_data().ptr, m_data().size, off, other.data(), other.size()));
+            m_data().ptr(), m_data().size(), off, other.data(), other.size()));
     }
 
     size_type find(const T c, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_ch<traits_type>(
-            m_data().ptr, m_data().size, off, c));
+            m_data().ptr(), m_data().size(), off, c));
     }
 
     size_type find(const T* const s, size_type off = 0) const noexcept
     {
         const size_type s_len = static_cast<size_type>(traits_type::length(s));
         return static_cast<size_type>(_char_traits_priv::traits_find<traits_type>(
-            m_data().ptr, m_data().size, off, s, s_len));
+            m_data().ptr(), m_data().size(), off, s, s_len));
     }
 
     size_type find(const T* const s, size_type off, size_type count) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find<traits_type>(
-            m_data().ptr, m_data().size, off, s, count));
+            m_data().ptr(), m_data().size(), off, s, count));
     }
 
     template <typename S, VX_REQUIRES(is_compatible_string<S>::value)>
     size_type find(const S& t, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find<traits_type>(
-            m_data().ptr, m_data().size, off, t.data(), t.size()));
+            m_data().ptr(), m_data().size(), off, t.data(), t.size()));
     }
 
     //=========================================================================
@@ -2145,33 +2292,33 @@ public:
     size_type rfind(const basic_string& other, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_rfind<traits_type>(
-            m_data().ptr, m_data().size, off, other.data(), other.size()));
+            m_data().ptr(), m_data().size(), off, other.data(), other.size()));
     }
 
     size_type rfind(const T c, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_rfind_ch<traits_type>(
-            m_data().ptr, m_data().size, off, c));
+            m_data().ptr(), m_data().size(), off, c));
     }
 
     size_type rfind(const T* const s, size_type off = npos) const noexcept
     {
         const size_type s_len = static_cast<size_type>(traits_type::length(s));
         return static_cast<size_type>(_char_traits_priv::traits_rfind<traits_type>(
-            m_data().ptr, m_data().size, off, s, s_len));
+            m_data().ptr(), m_data().size(), off, s, s_len));
     }
 
     size_type rfind(const T* const s, size_type off, size_type count) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_rfind<traits_type>(
-            m_data().ptr, m_data().size, off, s, count));
+            m_data().ptr(), m_data().size(), off, s, count));
     }
 
     template <typename S, VX_REQUIRES(is_compatible_string<S>::value)>
     size_type rfind(const S& t, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_rfind<traits_type>(
-            m_data().ptr, m_data().size, off, t.data(), t.size()));
+            m_data().ptr(), m_data().size(), off, t.data(), t.size()));
     }
 
     //=========================================================================
@@ -2179,33 +2326,33 @@ public:
     size_type find_first_of(const basic_string& other, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_first_of<traits_type>(
-            m_data().ptr, m_data().size, off, other.data(), other.size()));
+            m_data().ptr(), m_data().size(), off, other.data(), other.size()));
     }
 
     size_type find_first_of(const T c, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_ch<traits_type>(
-            m_data().ptr, m_data().size, off, c));
+            m_data().ptr(), m_data().size(), off, c));
     }
 
     size_type find_first_of(const T* const s, size_type off = 0) const noexcept
     {
         const size_type s_len = static_cast<size_type>(traits_type::length(s));
         return static_cast<size_type>(_char_traits_priv::traits_find_first_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, s_len));
+            m_data().ptr(), m_data().size(), off, s, s_len));
     }
 
     size_type find_first_of(const T* const s, size_type off, size_type count) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_first_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, count));
+            m_data().ptr(), m_data().size(), off, s, count));
     }
 
     template <typename S, VX_REQUIRES(is_compatible_string<S>::value)>
     size_type find_first_of(const S& t, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_first_of<traits_type>(
-            m_data().ptr, m_data().size, off, t.data(), t.size()));
+            m_data().ptr(), m_data().size(), off, t.data(), t.size()));
     }
 
     //=========================================================================
@@ -2213,33 +2360,33 @@ public:
     size_type find_last_of(const basic_string& other, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_last_of<traits_type>(
-            m_data().ptr, m_data().size, off, other.data(), other.size()));
+            m_data().ptr(), m_data().size(), off, other.data(), other.size()));
     }
 
     size_type find_last_of(const T c, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_rfind_ch<traits_type>(
-            m_data().ptr, m_data().size, off, c));
+            m_data().ptr(), m_data().size(), off, c));
     }
 
     size_type find_last_of(const T* const s, size_type off = npos) const noexcept
     {
         const size_type s_len = static_cast<size_type>(traits_type::length(s));
         return static_cast<size_type>(_char_traits_priv::traits_find_last_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, s_len));
+            m_data().ptr(), m_data().size(), off, s, s_len));
     }
 
     size_type find_last_of(const T* const s, size_type off, size_type count) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_last_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, count));
+            m_data().ptr(), m_data().size(), off, s, count));
     }
 
     template <typename S, VX_REQUIRES(is_compatible_string<S>::value)>
     size_type find_last_of(const S& t, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_last_of<traits_type>(
-            m_data().ptr, m_data().size, off, t.data(), t.size()));
+            m_data().ptr(), m_data().size(), off, t.data(), t.size()));
     }
 
     //=========================================================================
@@ -2247,33 +2394,33 @@ public:
     size_type find_first_not_of(const basic_string& other, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_first_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, other.data(), other.size()));
+            m_data().ptr(), m_data().size(), off, other.data(), other.size()));
     }
 
     size_type find_first_not_of(const T c, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_not_ch<traits_type>(
-            m_data().ptr, m_data().size, off, c));
+            m_data().ptr(), m_data().size(), off, c));
     }
 
     size_type find_first_not_of(const T* const s, size_type off = 0) const noexcept
     {
         const size_type s_len = static_cast<size_type>(traits_type::length(s));
         return static_cast<size_type>(_char_traits_priv::traits_find_first_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, s_len));
+            m_data().ptr(), m_data().size(), off, s, s_len));
     }
 
     size_type find_first_not_of(const T* const s, size_type off, size_type count) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_first_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, count));
+            m_data().ptr(), m_data().size(), off, s, count));
     }
 
     template <typename S, VX_REQUIRES(is_compatible_string<S>::value)>
     size_type find_first_not_of(const S& t, size_type off = 0) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_first_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, t.data(), t.size()));
+            m_data().ptr(), m_data().size(), off, t.data(), t.size()));
     }
 
     //=========================================================================
@@ -2281,33 +2428,33 @@ public:
     size_type find_last_not_of(const basic_string& other, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_last_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, other.data(), other.size()));
+            m_data().ptr(), m_data().size(), off, other.data(), other.size()));
     }
 
     size_type find_last_not_of(const T c, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_rfind_not_ch<traits_type>(
-            m_data().ptr, m_data().size, off, c));
+            m_data().ptr(), m_data().size(), off, c));
     }
 
     size_type find_last_not_of(const T* const s, size_type off = npos) const noexcept
     {
         const size_type s_len = static_cast<size_type>(traits_type::length(s));
         return static_cast<size_type>(_char_traits_priv::traits_find_last_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, s_len));
+            m_data().ptr(), m_data().size(), off, s, s_len));
     }
 
     size_type find_last_not_of(const T* const s, size_type off, size_type count) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_last_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, s, count));
+            m_data().ptr(), m_data().size(), off, s, count));
     }
 
     template <typename S, VX_REQUIRES(is_compatible_string<S>::value)>
     size_type find_last_not_of(const S& t, size_type off = npos) const noexcept
     {
         return static_cast<size_type>(_char_traits_priv::traits_find_last_not_of<traits_type>(
-            m_data().ptr, m_data().size, off, t.data(), t.size()));
+            m_data().ptr(), m_data().size(), off, t.data(), t.size()));
     }
 
     //=========================================================================
@@ -2317,7 +2464,7 @@ public:
     int compare(const basic_string& other) const noexcept
     {
         return _char_traits_priv::traits_compare<traits_type>(
-            m_data().ptr, m_data().size,
+            m_data().ptr(), m_data().size(),
             other.data(), other.size());
     }
 
@@ -2329,7 +2476,7 @@ public:
         }
         count = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count));
         return _char_traits_priv::traits_compare<traits_type>(
-            m_data().ptr + off, count,
+            m_data().ptr() + off, count,
             other.data(), other.size());
     }
 
@@ -2342,7 +2489,7 @@ public:
         count1 = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off1, count1));
         count2 = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(other.size(), off2, count2));
         return _char_traits_priv::traits_compare<traits_type>(
-            m_data().ptr + off1, count1,
+            m_data().ptr() + off1, count1,
             other.data() + off2, count2);
     }
 
@@ -2352,7 +2499,7 @@ public:
     {
         const size_type s_len = static_cast<size_type>(traits_type::length(s));
         return _char_traits_priv::traits_compare<traits_type>(
-            m_data().ptr, m_data().size,
+            m_data().ptr(), m_data().size(),
             s, s_len);
     }
 
@@ -2375,7 +2522,7 @@ public:
         }
         count1 = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off, count1));
         return _char_traits_priv::traits_compare<traits_type>(
-            m_data().ptr + off, count1,
+            m_data().ptr() + off, count1,
             s, count2);
     }
 
@@ -2386,7 +2533,7 @@ public:
     {
         const size_type t_len = static_cast<size_type>(t.size());
         return _char_traits_priv::traits_compare<traits_type>(
-            m_data().ptr, m_data().size,
+            m_data().ptr(), m_data().size(),
             t.data(), t_len);
     }
 
@@ -2400,7 +2547,7 @@ public:
         count1 = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(size(), off1, count1));
         count2 = static_cast<size_type>(_char_traits_priv::clamp_suffix_size(t.size(), off2, count2));
         return _char_traits_priv::traits_compare<traits_type>(
-            m_data().ptr + off1, count1,
+            m_data().ptr() + off1, count1,
             t.data() + off2, count2);
     }
 };
@@ -2609,6 +2756,17 @@ bool operator>=(const T* const lhs, const basic_string<T, Allocator>& rhs) noexc
     return rhs.compare(lhs) <= 0;
 }
 
+//=========================================================================
+// swap
+//=========================================================================
+
+// see vector swap
+template <typename T, typename Allocator>
+void swap(basic_string<T, Allocator>& lhs, basic_string<T, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
 //=========================================================================
 // stream operators
 //=========================================================================
@@ -2654,19 +2812,32 @@ using u32string = str::basic_string<char32_t>;
 
 namespace vx {
 
-template <typename T>
-struct hash;
-
+// transparent so string keyed containers can be searched with a string_view
+// (or a c string) without constructing a temporary string. Both functors take
+// only views, a c string would convert equally well to a string overload.
 template <typename T, typename Allocator>
 struct hash<str::basic_string<T, Allocator>>
 {
-    size_t operator()(const vx::str::basic_string<T, Allocator>& s) const noexcept
+    using is_transparent = void;
+
+    size_t operator()(const vx::str::basic_string_view<T> s) const noexcept
     {
         using traits = typename vx::str::basic_string<T, Allocator>::traits_type;
         return traits::hash(s.data(), s.size());
     }
 };
 
+template <typename T, typename Allocator>
+struct equal_to<str::basic_string<T, Allocator>>
+{
+    using is_transparent = void;
+
+    bool operator()(const vx::str::basic_string_view<T> lhs, const vx::str::basic_string_view<T> rhs) const noexcept
+    {
+        return lhs == rhs;
+    }
+};
+
 } // namespace vx
 
 namespace std {
@@ -4,6 +4,7 @@
 
 #include "vertex/std/_tools/pointer_iterator.hpp"
 #include "vertex/std/char_traits.hpp"
+#include "vertex/std/hash.hpp"
 #include "vertex/std/string_traits.hpp"
 
 namespace vx {
@@ -687,9 +688,6 @@ using u32string_view = str::basic_string_view<char32_t>;
 
 namespace vx {
 
-template <typename T>
-struct hash;
-
 template <typename T>
 struct hash<str::basic_string_view<T>>
 {
@@ -914,7 +914,7 @@ private:
 
         VX_IF_CONSTEXPR (try_reallocate && std::is_trivially_destructible<T>::value && std::is_trivially_copyable<T>::value)
         {
-            new_ptr = m_allocator().reallocate(ptr, new_capacity);
+            new_ptr = mem::allocator_reallocate(m_allocator(), ptr, capacity, new_capacity);
 
 #if !defined(VX_ALLOCATE_FAIL_FAST)
 
@@ -1591,4 +1591,17 @@ bool operator>=(const vector<T, Allocator>& lhs, const vector<T, Allocator>& rhs
     return !(lhs < rhs);
 }
 
+//=========================================================================
+// swap
+//=========================================================================
+
+// More specialized than both std::swap and mem::swap, which are otherwise
+// ambiguous inside std algorithms because mem is an associated namespace
+// of the default allocator.
+template <typename T, typename Allocator>
+void swap(vector<T, Allocator>& lhs, vector<T, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
 } // namespace vx
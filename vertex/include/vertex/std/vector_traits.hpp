@@ -15,6 +15,9 @@ class vector;
 template <size_t N, typename T>
 class static_vector;
 
+template <typename T, size_t N, typename Allocator>
+class small_vector;
+
 //=========================================================================
 
 template <typename T>
@@ -29,6 +32,10 @@ template <size_t N, typename T>
 struct is_vector_like<static_vector<N, T>> : std::true_type
 {};
 
+template <typename T, size_t N, typename Allocator>
+struct is_vector_like<small_vector<T, N, Allocator>> : std::true_type
+{};
+
 template <typename T, typename Alloc>
 struct is_vector_like<std::vector<T, Alloc>> : std::true_type
 {};
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <sstream>
+#include <ostream>
+#include <streambuf>
+#include <string>
 
 #include "vertex/config/compiler.hpp"
 #include "vertex/system/assert.hpp"
@@ -46,13 +48,34 @@ VX_API level get_level();
  */
 VX_API void set_level(level l);
 
+/**
+ * @brief Checks whether a message at the given level would be logged.
+ *
+ * This is cheap enough to call before formatting a message, the logging macros
+ * use it to skip formatting entirely for levels below the active one.
+ *
+ * @param l The severity level to check.
+ * @return true if messages at this level are written, false otherwise.
+ */
+VX_API bool should_log(level l);
+
 /**
  * @brief Initializes the logging system and opens the given output file.
  *
+ * In synchronous mode every message is written and flushed to the file before
+ * `write` returns, under a lock shared by all threads.
+ *
+ * In asynchronous mode `write` only copies the message into a lock free queue.
+ * A background thread writes messages to the file in batches and flushes it
+ * when enough data has been written, when messages have been waiting for a
+ * short while, or right away for messages at `level::error` and above. Use
+ * `flush` to wait for all queued messages to reach the file.
+ *
  * @param output_file Path to the log file.
+ * @param async If true, messages are written by a background thread.
  * @return true if logging was successfully started, false otherwise.
  */
-VX_API bool start(const char* output_file);
+VX_API bool start(const char* output_file, bool async = false);
 
 /**
  * @brief Stops the logging system and flushes all output.
@@ -74,34 +97,101 @@ VX_API bool is_enabled();
  */
 VX_API void write(level l, const std::string& msg);
 
+/**
+ * @brief Blocks until every message written so far has reached the log file.
+ *
+ * In asynchronous mode this waits for the background thread to drain the
+ * queue and flush the file. In synchronous mode it only flushes the file.
+ */
+VX_API void flush();
+
 namespace _priv {
 
+// stream buffer that appends to a string, so formatted messages can be
+// handed to write without copying them out of a stringstream
+class string_streambuf : public std::streambuf
+{
+public:
+
+    std::string& str() noexcept { return m_string; }
+
+protected:
+
+    int_type overflow(int_type c) override
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            m_string.push_back(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        m_string.append(s, static_cast<size_t>(n));
+        return n;
+    }
+
+private:
+
+    std::string m_string;
+};
+
+struct thread_stream
+{
+    thread_stream() : stream(&buffer) {}
+
+    string_streambuf buffer;
+    std::ostream stream;
+    bool in_use = false;
+};
+
+// returns the formatting stream of the calling thread, cleared and with
+// default formatting. A nested message formatted while the thread's stream
+// is in use gets a temporary one.
+VX_API thread_stream* acquire_thread_stream();
+VX_API void release_thread_stream(thread_stream* s);
+
 class log_stream
 {
 public:
 
-    log_stream(level log_level) : m_level(log_level) { prefix(); }
-    ~log_stream() { flush(); }
+    log_stream(level log_level)
+        : m_level(log_level)
+        , m_stream(acquire_thread_stream())
+    {
+        prefix();
+    }
 
     log_stream(level log_level, int line, const char* file)
         : m_level(log_level)
+        , m_stream(acquire_thread_stream())
     {
         prefix();
-        m_stream << "line " << line << " file " << file << ": ";
+        m_stream->stream << "line " << line << " file " << file << ": ";
     }
 
+    ~log_stream()
+    {
+        flush();
+        release_thread_stream(m_stream);
+    }
+
+    log_stream(const log_stream&) = delete;
+    log_stream& operator=(const log_stream&) = delete;
+
 private:
 
     void prefix()
     {
         switch (m_level)
         {
-            case level::trace:    m_stream << "[TRACE] ";    break;
-            case level::debug:    m_stream << "[DEBUG] ";    break;
-            case level::info:     m_stream << "[INFO] ";     break;
-            case level::warning:  m_stream << "[WARNING] ";  break;
-            case level::error:    m_stream << "[ERROR] ";    break;
-            case level::critical: m_stream << "[CRITICAL] "; break;
+            case level::trace:    m_stream->stream << "[TRACE] ";    break;
+            case level::debug:    m_stream->stream << "[DEBUG] ";    break;
+            case level::info:     m_stream->stream << "[INFO] ";     break;
+            case level::warning:  m_stream->stream << "[WARNING] ";  break;
+            case level::error:    m_stream->stream << "[ERROR] ";    break;
+            case level::critical: m_stream->stream << "[CRITICAL] "; break;
         }
     }
 
@@ -110,22 +200,21 @@ public:
     template <typename... Args>
     void stream(Args&&... args)
     {
-        (m_stream << ... << args);
+        (m_stream->stream << ... << args);
     }
 
 private:
 
     void flush()
     {
-        m_stream << VX_LINE_END;
-        const std::string msg(m_stream.str());
-        write(m_level, m_stream.str());
+        m_stream->stream << VX_LINE_END;
+        write(m_level, m_stream->buffer.str());
     }
 
 private:
 
     level m_level;
-    std::ostringstream m_stream;
+    thread_stream* m_stream;
 };
 
 } // namespace _priv
@@ -140,7 +229,9 @@ private:
  * @brief Stream-based macros for logging messages at specific severity levels.
  *
  * These macros are active only if VX_ENABLE_LOGGING is enabled. They use
- * `log_stream` to accumulate a message which is logged automatically.
+ * `log_stream` to accumulate a message which is logged automatically. The
+ * arguments are not evaluated or formatted when the level is below the
+ * active one.
  *
  * Example:
  * @code
@@ -150,19 +241,19 @@ private:
 
 #if VX_ENABLE_LOGGING
 
-#   define VX_LOG_TRACE(...)                ::vx::log::_priv::log_stream(::vx::log::level::trace                     ).stream(__VA_ARGS__)
-#   define VX_LOG_DEBUG(...)                ::vx::log::_priv::log_stream(::vx::log::level::debug                     ).stream(__VA_ARGS__)
-#   define VX_LOG_INFO(...)                 ::vx::log::_priv::log_stream(::vx::log::level::info                      ).stream(__VA_ARGS__)
-#   define VX_LOG_WARNING(...)              ::vx::log::_priv::log_stream(::vx::log::level::warning                   ).stream(__VA_ARGS__)
-#   define VX_LOG_ERROR(...)                ::vx::log::_priv::log_stream(::vx::log::level::error                     ).stream(__VA_ARGS__)
-#   define VX_LOG_CRITICAL(...)             ::vx::log::_priv::log_stream(::vx::log::level::critical                  ).stream(__VA_ARGS__)
-
-#   define VX_LOG_TRACE_FULL(...)           ::vx::log::_priv::log_stream(::vx::log::level::trace,    VX_LINE, VX_FILE).stream(__VA_ARGS__)
-#   define VX_LOG_DEBUG_FULL(...)           ::vx::log::_priv::log_stream(::vx::log::level::debug,    VX_LINE, VX_FILE).stream(__VA_ARGS__)
-#   define VX_LOG_INFO_FULL(...)            ::vx::log::_priv::log_stream(::vx::log::level::info,     VX_LINE, VX_FILE).stream(__VA_ARGS__)
-#   define VX_LOG_WARNING_FULL(...)         ::vx::log::_priv::log_stream(::vx::log::level::warning,  VX_LINE, VX_FILE).stream(__VA_ARGS__)
-#   define VX_LOG_ERROR_FULL(...)           ::vx::log::_priv::log_stream(::vx::log::level::error,    VX_LINE, VX_FILE).stream(__VA_ARGS__)
-#   define VX_LOG_CRITICAL_FULL(...)        ::vx::log::_priv::log_stream(::vx::log::level::critical, VX_LINE, VX_FILE).stream(__VA_ARGS__)
+#   define VX_LOG_TRACE(...)                 if (!::vx::log::should_log(::vx::log::level::trace)) {} else ::vx::log::_priv::log_stream(::vx::log::level::trace).stream(__VA_ARGS__)
+#   define VX_LOG_DEBUG(...)                 if (!::vx::log::should_log(::vx::log::level::debug)) {} else ::vx::log::_priv::log_stream(::vx::log::level::debug).stream(__VA_ARGS__)
+#   define VX_LOG_INFO(...)                  if (!::vx::log::should_log(::vx::log::level::info)) {} else ::vx::log::_priv::log_stream(::vx::log::level::info).stream(__VA_ARGS__)
+#   define VX_LOG_WARNING(...)               if (!::vx::log::should_log(::vx::log::level::warning)) {} else ::vx::log::_priv::log_stream(::vx::log::level::warning).stream(__VA_ARGS__)
+#   define VX_LOG_ERROR(...)                 if (!::vx::log::should_log(::vx::log::level::error)) {} else ::vx::log::_priv::log_stream(::vx::log::level::error).stream(__VA_ARGS__)
+#   define VX_LOG_CRITICAL(...)              if (!::vx::log::should_log(::vx::log::level::critical)) {} else ::vx::log::_priv::log_stream(::vx::log::level::critical).stream(__VA_ARGS__)
+
+#   define VX_LOG_TRACE_FULL(...)            if (!::vx::log::should_log(::vx::log::level::trace)) {} else ::vx::log::_priv::log_stream(::vx::log::level::trace, VX_LINE, VX_FILE).stream(__VA_ARGS__)
+#   define VX_LOG_DEBUG_FULL(...)            if (!::vx::log::should_log(::vx::log::level::debug)) {} else ::vx::log::_priv::log_stream(::vx::log::level::debug, VX_LINE, VX_FILE).stream(__VA_ARGS__)
+#   define VX_LOG_INFO_FULL(...)             if (!::vx::log::should_log(::vx::log::level::info)) {} else ::vx::log::_priv::log_stream(::vx::log::level::info, VX_LINE, VX_FILE).stream(__VA_ARGS__)
+#   define VX_LOG_WARNING_FULL(...)          if (!::vx::log::should_log(::vx::log::level::warning)) {} else ::vx::log::_priv::log_stream(::vx::log::level::warning, VX_LINE, VX_FILE).stream(__VA_ARGS__)
+#   define VX_LOG_ERROR_FULL(...)            if (!::vx::log::should_log(::vx::log::level::error)) {} else ::vx::log::_priv::log_stream(::vx::log::level::error, VX_LINE, VX_FILE).stream(__VA_ARGS__)
+#   define VX_LOG_CRITICAL_FULL(...)         if (!::vx::log::should_log(::vx::log::level::critical)) {} else ::vx::log::_priv::log_stream(::vx::log::level::critical, VX_LINE, VX_FILE).stream(__VA_ARGS__)
 
 #else
 
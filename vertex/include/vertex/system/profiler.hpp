@@ -1,16 +1,28 @@
 #pragma once
 
+#include <string>
+
+#include "vertex/config/util.hpp"
+#include "vertex/os/thread_id.hpp"
 #include "vertex/util/time/timer.hpp"
 
 namespace vx {
 namespace profile {
 
 /**
- * @brief Starts the profiling system and opens the output file for results.
+ * @brief Starts the profiling system and opens the output files for results.
+ *
+ * Results are written as csv to `output_file`. A Chrome trace of the same results is
+ * written next to it, with the extension replaced by `.trace.json`, which can be opened
+ * in `chrome://tracing` or Perfetto to view nested scopes as a flame chart.
+ *
+ * Scopes are recorded into per thread buffers and written by a background thread, so
+ * results may reach the files some time after the scope ends. All pending results are
+ * written by `stop`.
  *
  * @param output_file The path to the file where profiling data will be written.
- * @param clear_file If true, clears the file and writes a new csv header, otherwise
- * appends data to the existing file.
+ * @param clear_file If true, clears the files and writes new headers, otherwise
+ * appends data to the existing files.
  * @return true if the profiler started successfully; false otherwise.
  */
 VX_API bool start(const char* output_file, bool clear_file = true);
@@ -43,7 +55,8 @@ struct result
 /**
  * @brief Records a profiling result.
  *
- * Typically called internally by RAII timers like `profile_timer`.
+ * The start time is expected to come from `os::get_ticks`. Prefer the scope macros,
+ * which avoid copying the name for every result.
  *
  * @param r The profiling result to be recorded.
  */
@@ -51,34 +64,59 @@ VX_API void record(const result& r);
 
 namespace _priv {
 
+// fixed size record of a single scope, start and end are performance counter values
+struct event
+{
+    const char* name;
+    os::thread_id thread;
+    int64_t start;
+    int64_t end;
+};
+
+// name must stay valid until the profiler is stopped, string literals and
+// names returned by intern_name are always fine
+VX_API void record_event(const char* name, int64_t start, int64_t end) noexcept;
+
+// returns a copy of name that lives as long as the process, names the calling
+// thread has seen before are found without taking a lock
+VX_API const char* intern_name(const std::string& name);
+
 class profile_timer
 {
 public:
 
-    profile_timer(const std::string& name)
+    // name must have static storage duration
+    explicit profile_timer(const char* name) noexcept
         : m_name(name)
-    {
-        m_timer.start();
-    }
+        , m_start(os::get_performance_counter())
+    {}
+
+    explicit profile_timer(const std::string& name)
+        : m_name(is_enabled() ? intern_name(name) : nullptr)
+        , m_start(os::get_performance_counter())
+    {}
 
     ~profile_timer()
     {
         stop();
     }
 
-    void stop()
+    profile_timer(const profile_timer&) = delete;
+    profile_timer& operator=(const profile_timer&) = delete;
+
+    void stop() noexcept
     {
-        if (m_timer.running())
+        if (m_name)
         {
-            m_timer.stop();
-            record({ m_name, m_timer.start_time(), m_timer.elapsed_time() });
+            record_event(m_name, m_start, os::get_performance_counter());
+            m_name = nullptr;
         }
     }
 
 private:
 
-    std::string m_name;
-    time::timer m_timer;
+    const char* m_name;
+    int64_t m_start;
 };
 
 } // namespace _priv
@@ -89,8 +127,8 @@ private:
     #define VX_PROFILE_START_APPEND(file) ::vx::profile::start(file, false)
     #define VX_PROFILE_STOP()             ::vx::profile::stop()
 
-    #define VX_PROFILE_SCOPE(name) ::vx::profile::_priv::profile_timer timer##VX_LINE(name)
-    #define VX_PROFILE_FUNCTION()  ::vx::profile::_priv::profile_timer timer##VX_FUNCTION(VX_FUNCTION)
+    #define VX_PROFILE_SCOPE(name) ::vx::profile::_priv::profile_timer VX_CONCAT(timer, VX_LINE)(name)
+    #define VX_PROFILE_FUNCTION()  ::vx::profile::_priv::profile_timer VX_CONCAT(timer, VX_LINE)(VX_FUNCTION)
 
 #else
 
@@ -4,6 +4,7 @@
 #include "vertex_impl/app/event/event_internal.hpp"
 #include "vertex_impl/app/event/temporary_memory_pool.hpp"
 #include "vertex_impl/app/hints/hints_internal.hpp"
+#include "vertex_impl/os/futex.hpp"
 
 #if defined(VX_APP_VIDEO_ENABLED)
 #   include "vertex_impl/app/input/keyboard_internal.hpp"
@@ -206,6 +207,64 @@ void event_queue::stop()
     clear();
 }
 
+bool event_queue::push(const event_queue_entry& entry)
+{
+    // take a place before publishing so that pending, the ring and the
+    // overflow list never hold more than max_events between them
+    if (queued.fetch_add(1, std::memory_order_acq_rel) + 1 >= max_events)
+    {
+        queued.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (!overflowing.load(std::memory_order_acquire) && ring.try_push(entry))
+    {
+        notify_push();
+        return true;
+    }
+
+    {
+        os::lock_guard lock(overflow_mutex);
+        overflow.push_back(entry);
+
+        // set under the lock so this thread's next event cannot overtake it
+        // through the ring
+        overflowing.store(true, std::memory_order_release);
+    }
+
+    notify_push();
+    return true;
+}
+
+void event_queue::notify_push()
+{
+    // either a parked thread sees the new count or we see the thread
+    pushes.fetch_add(1, std::memory_order_seq_cst);
+
+    if (sleepers.load(std::memory_order_seq_cst) != 0)
+    {
+        os::futex_impl::wake_all(pushes);
+    }
+}
+
+// Parks until an event is pushed after pushes read seen, the timeout expires
+// or a signal interrupts the wait, so the caller pumps again and picks up
+// signal events. A negative timeout waits until one of the others.
+void event_queue::wait_for_push(uint32_t seen, time::time_point timeout)
+{
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+
+    if (pushes.load(std::memory_order_seq_cst) == seen)
+    {
+        const int64_t ns = timeout.as_nanoseconds();
+        os::futex_impl::wait(pushes, seen, (ns < 0) ? -1 : ns);
+    }
+
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+//=============================================================================
+
 size_t event_queue::add(const event* events, size_t count)
 {
     size_t added = 0;
@@ -215,29 +274,38 @@ size_t event_queue::add(const event* events, size_t count)
         return added;
     }
 
-    os::lock_guard lock(mutex);
-
     for (size_t i = 0; i < count; ++i)
     {
-        if (queue.size() + 1 >= max_events)
-        {
-            err::set(err::size_error, "event queue full");
-            break;
-        }
-
         const event& e = events[i];
 
 #if VX_APP_LOG_EVENTS
         log_event(e);
 #endif // VX_APP_LOG_EVENTS
 
-        if (e.type == internal_event_poll_sentinel)
+        const bool is_sentinel = (e.type == internal_event_poll_sentinel);
+
+        // counted before publishing so a consumer never sees the event
+        // without its sentinel count
+        if (is_sentinel)
         {
             ++sentinel_pending;
         }
 
-        queue.push_back(event_queue_entry{ e, nullptr });
-        claim_event_temporary_memory(queue.back());
+        event_queue_entry entry{ e, nullptr };
+        claim_event_temporary_memory(entry);
+
+        if (!push(entry))
+        {
+            return_event_temporary_memory(entry);
+
+            if (is_sentinel)
+            {
+                --sentinel_pending;
+            }
+
+            err::set(err::size_error, "event queue full");
+            break;
+        }
 
         ++added;
     }
@@ -247,6 +315,44 @@ size_t event_queue::add(const event* events, size_t count)
 
 //=============================================================================
 
+// Must be called with the mutex held. The ring is drained again under the
+// overflow lock so that anything a producer published before switching to
+// the overflow list lands in pending ahead of it.
+void event_queue::drain()
+{
+    event_queue_entry entry;
+
+    while (ring.try_pop(entry))
+    {
+        pending.push_back(entry);
+    }
+
+    if (overflowing.load(std::memory_order_acquire))
+    {
+        os::lock_guard lock(overflow_mutex);
+
+        while (ring.try_pop(entry))
+        {
+            pending.push_back(entry);
+        }
+
+        pending.insert(pending.end(), overflow.begin(), overflow.end());
+        overflow.clear();
+        overflowing.store(false, std::memory_order_release);
+    }
+
+    pending_count.store(pending.size(), std::memory_order_relaxed);
+}
+
+bool event_queue::empty() const
+{
+    return pending_count.load(std::memory_order_relaxed) == 0
+        && ring.empty()
+        && !overflowing.load(std::memory_order_acquire);
+}
+
+//=============================================================================
+
 // If include_sentinel is true, we should loop and collect events until we find
 // the last sentinel, which should be the last matched event. Any sentinels that
 // are not the last one will be overwritten by non-sentinel events and not
@@ -259,9 +365,17 @@ size_t event_queue::match(event_filter matcher, void* user_data, event* events,
     const bool copy = (events && count > 0);
     size_t matched = 0;
 
+    // nothing published, avoid contending with other consumers
+    if (empty())
+    {
+        return matched;
+    }
+
     os::lock_guard lock(mutex);
 
-    if (queue.empty())
+    drain();
+
+    if (pending.empty())
     {
         return matched;
     }
@@ -269,13 +383,14 @@ size_t event_queue::match(event_filter matcher, void* user_data, event* events,
     // if count is 0, we should check all events
     if (count == 0)
     {
-        count = queue.size();
+        count = pending.size();
     }
 
     size_t sentinel_count = 0;
+    size_t removed = 0;
 
-    auto it = queue.begin();
-    while (it != queue.end() && (matched < count))
+    auto it = pending.begin();
+    while (it != pending.end() && (matched < count))
     {
         const bool matched_event = (!matcher || matcher(it->e, user_data));
         if (!matched_event)
@@ -294,7 +409,8 @@ size_t event_queue::match(event_filter matcher, void* user_data, event* events,
         if (remove)
         {
             return_event_temporary_memory(*it);
-            it = queue.erase(it);
+            it = pending.erase(it);
+            ++removed;
         }
         else
         {
@@ -326,6 +442,8 @@ size_t event_queue::match(event_filter matcher, void* user_data, event* events,
         ++matched;
     }
 
+    pending_count.store(pending.size(), std::memory_order_relaxed);
+    queued.fetch_sub(removed, std::memory_order_release);
     return matched;
 }
 
@@ -334,7 +452,7 @@ size_t event_queue::match(event_filter matcher, void* user_data, event* events,
 void event_queue::clear()
 {
     match(nullptr, nullptr, nullptr, 0, true, false);
-    VX_ASSERT(queue.empty());
+    VX_ASSERT(pending.empty());
     VX_ASSERT(sentinel_pending == 0);
 }
 
@@ -764,6 +882,9 @@ bool event_manager::wait_event_timeout(event* e, time::time_point t)
     {
         pump_events_internal(true);
 
+        // read before matching, anything pushed after this ends the wait below
+        const uint32_t pushes = data.queue.pushes.load(std::memory_order_seq_cst);
+
         // don't include sentinel here, we want real events only
         if (data.queue.match(nullptr, nullptr, e, 1, remove_event, false))
         {
@@ -771,7 +892,18 @@ bool event_manager::wait_event_timeout(event* e, time::time_point t)
             return true;
         }
 
-        time::time_point delay = time::milliseconds(default_poll_interval_ms);
+        // with nothing to pump, sleep until another thread pushes an event
+        time::time_point delay(-1);
+
+#if defined(VX_APP_VIDEO_ENABLED)
+
+        // window events only arrive by pumping
+        if (app->is_video_init())
+        {
+            delay = time::milliseconds(default_poll_interval_ms);
+        }
+
+#endif // VX_APP_VIDEO_ENABLED
 
         if (t.is_positive())
         {
@@ -782,10 +914,11 @@ bool event_manager::wait_event_timeout(event* e, time::time_point t)
                 return false;
             }
 
-            delay = std::min((expiration - now), delay);
+            const time::time_point left = expiration - now;
+            delay = delay.is_negative() ? left : std::min(left, delay);
         }
 
-        os::sleep(delay);
+        data.queue.wait_for_push(pushes, delay);
     }
 
     return false;
@@ -871,15 +1004,15 @@ void event_manager::get_event_filter(event_filter& filter, void*& user_data, eve
 
 //=============================================================================
 
-void add_event_watch(event_filter callback, void* user_data)
+bool add_event_watch(event_filter callback, void* user_data)
 {
-    VX_CHECK_EVENTS_SUBSYSTEM_INIT_VOID();
-    s_events_ptr->add_event_watch(callback, user_data, event_watch_priority_normal);
+    VX_CHECK_EVENTS_SUBSYSTEM_INIT(false);
+    return s_events_ptr->add_event_watch(callback, user_data, event_watch_priority_normal);
 }
 
-void event_manager::add_event_watch(event_filter callback, void* user_data, event_watch_priority priority)
+bool event_manager::add_event_watch(event_filter callback, void* user_data, event_watch_priority priority)
 {
-    data.watch.add_watch(callback, user_data, priority);
+    return data.watch.add_watch(callback, user_data, priority);
 }
 
 //=============================================================================
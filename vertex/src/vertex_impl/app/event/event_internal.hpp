@@ -1,7 +1,9 @@
 #pragma once
 
-#include <list>
+#include <deque>
+#include <vector>
 
+#include "vertex/os/mpsc_queue.hpp"
 #include "vertex_impl/app/video/_platform/platform_features.hpp"
 #include "vertex_impl/app/event/event_watch.hpp"
 
@@ -33,7 +35,9 @@ namespace event {
 
 enum
 {
+    event_ring_capacity = 1024,
     max_events = 65535,
+    // how often a wait pumps the video subsystem when it cannot wait itself
     default_poll_interval_ms = 1,
     disabled_events_size = 256
 };
@@ -79,12 +83,37 @@ struct event_queue_entry
     struct temp_memory_entry* memory;
 };
 
+// Producers publish into a lock free ring and never take the queue mutex.
+// Consumers (match) hold the mutex, move everything published so far into
+// pending, and filter or remove from there.
+//
+// When the ring is full, events go to an overflow list under its own lock.
+// Once something is in the overflow list every producer keeps using it until
+// a consumer drains it, so each thread's events stay in order.
+//
+// queued counts every event in pending, the ring and the overflow list, and
+// push refuses new events once it reaches max_events.
+//
+// pushes counts every event published. Waiting threads park on it until it
+// changes, push only makes a system call to wake them if sleepers is set.
 struct event_queue
 {
     bool active = false;
-    std::list<event_queue_entry> queue;
     os::recursive_mutex mutex;
 
+    os::mpsc_queue<event_queue_entry> ring{ event_ring_capacity };
+    std::deque<event_queue_entry> pending;   // guarded by mutex
+    os::atomic<size_t> pending_count = 0;    // lets empty polls skip the mutex
+
+    std::vector<event_queue_entry> overflow; // guarded by overflow_mutex
+    os::mutex overflow_mutex;
+    os::atomic<bool> overflowing = false;
+
+    os::atomic<size_t> queued = 0;           // reserved by push, released by match
+
+    os::atomic<uint32_t> pushes = 0;
+    os::atomic<uint32_t> sleepers = 0;
+
     bool start();
     void stop();
 
@@ -92,6 +121,12 @@ struct event_queue
     size_t match(event_filter matcher, void* user_data, event* events, size_t count, bool remove, bool include_sentinel);
     void clear();
 
+    bool push(const event_queue_entry& entry);
+    void notify_push();
+    void wait_for_push(uint32_t seen, time::time_point timeout);
+    void drain();
+    bool empty() const;
+
     os::atomic<size_t> sentinel_pending = 0; // incremented every time an event poll ends
     void add_sentinel();
 };
@@ -209,7 +244,7 @@ public:
     void set_event_filter(event_filter filter, void* user_data, event_watch_priority priority);
     void get_event_filter(event_filter& filter, void*& user_data, event_watch_priority priority);
 
-    void add_event_watch(event_filter callback, void* user_data, event_watch_priority priority);
+    bool add_event_watch(event_filter callback, void* user_data, event_watch_priority priority);
     void remove_event_watch(event_filter callback, void* user_data, event_watch_priority priority);
     bool dispatch_event_watch(event& e);
 
@@ -1,4 +1,5 @@
 #include "vertex_impl/app/event/event_watch.hpp"
+#include "vertex/std/error.hpp"
 
 namespace vx {
 namespace app {
@@ -50,10 +51,17 @@ void event_watch_list::get_filter(event_filter& f, void*& user_data, event_watch
 
 ////////////////////////////////////////
 
-void event_watch_list::add_watch(event_filter callback, void* user_data, event_watch_priority priority)
+bool event_watch_list::add_watch(event_filter callback, void* user_data, event_watch_priority priority)
 {
     os::lock_guard lock(mutex);
-    watch_list[priority].watchers.push_back(event_watcher{ callback, user_data, false });
+
+    if (!watch_list[priority].watchers.push_back(event_watcher{ callback, user_data, false }))
+    {
+        err::set(err::out_of_memory, "failed to add event watch");
+        return false;
+    }
+
+    return true;
 }
 
 ////////////////////////////////////////
@@ -2,6 +2,7 @@
 
 #include "vertex/app/event/event.hpp"
 #include "vertex/os/mutex.hpp"
+#include "vertex/std/small_vector.hpp"
 
 namespace vx {
 namespace app {
@@ -24,7 +25,8 @@ struct event_watcher
 struct watch_pair
 {
     event_watcher filter;
-    std::vector<event_watcher> watchers;
+    // most lists only ever hold a handful of watchers
+    small_vector<event_watcher, 4> watchers;
     void clear();
 };
 
@@ -40,7 +42,7 @@ struct event_watch_list
     void set_filter(event_filter f, void* user_data, event_watch_priority priority);
     void get_filter(event_filter& f, void*& user_data, event_watch_priority priority) const;
 
-    void add_watch(event_filter callback, void* user_data, event_watch_priority priority);
+    bool add_watch(event_filter callback, void* user_data, event_watch_priority priority);
     void remove_watch(event_filter callback, void* user_data, event_watch_priority priority);
 
     void prune_removed_watchers(event_watch_priority priority);
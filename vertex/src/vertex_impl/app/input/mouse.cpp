@@ -522,10 +522,13 @@ click_state* input_source::get_click_state(uint8_t button)
 {
     if (button >= data.click_states.size())
     {
-        data.click_states.resize(button);
+        if (!data.click_states.resize(static_cast<size_t>(button) + 1))
+        {
+            return nullptr;
+        }
     }
 
-    return &data.click_states.at(button);
+    return &data.click_states[button];
 }
 
 //=============================================================================
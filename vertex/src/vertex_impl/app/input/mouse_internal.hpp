@@ -2,6 +2,7 @@
 
 #include "vertex/app/input/mouse.hpp"
 #include "vertex/app/video/video.hpp"
+#include "vertex/std/small_vector.hpp"
 #include "vertex/util/time.hpp"
 #include "vertex_impl/app/app_internal.hpp"
 
@@ -79,8 +80,8 @@ struct input_source_data
     mouse_id id = invalid_id;
     // Current aggregate button state for this device
     button button_state = button::none;
-    // Per-button tracked click_state entries
-    std::vector<click_state> click_states;
+    // Per-button tracked click_state entries, inline for the standard buttons
+    small_vector<click_state, button_count> click_states;
 };
 
 struct input_source
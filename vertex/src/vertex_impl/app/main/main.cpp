@@ -65,7 +65,11 @@ app_result app_runner_base::init(
             return app_result::terminate_failure;
         }
 
-        event::add_event_watch(main_callback_event_watcher, nullptr);
+        if (!event::add_event_watch(main_callback_event_watcher, nullptr))
+        {
+            data.result = app_result::terminate_failure;
+            return app_result::terminate_failure;
+        }
     }
 
     return data.result.load();
@@ -0,0 +1,1115 @@
+#include <algorithm>
+#include <cstring>
+
+#include "vertex_impl/image/deflate.hpp"
+
+namespace vx {
+namespace img {
+
+namespace _priv {
+
+///////////////////////////////////////////////////////////////////////////////
+// tables
+///////////////////////////////////////////////////////////////////////////////
+
+enum : size_t
+{
+    min_match = 3,
+    max_match = 258,
+
+    window_mask = deflate_window_size - 1,
+    hash_bits = 15,
+    hash_size = size_t(1) << hash_bits,
+
+    // symbols buffered before a block is written
+    block_symbols = 1 << 15,
+    max_stored_block = 65535,
+
+    litlen_codes = 286,
+    dist_codes = 30,
+    codelen_codes = 19,
+
+    // length 3 matches further back than this are not worth their bits
+    too_far = 4096,
+
+    max_code_bits = 15,
+    max_codelen_bits = 7,
+    end_of_block = 256
+};
+
+static const uint16_t length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const uint8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static const uint8_t codelen_order[codelen_codes] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+struct code_tables
+{
+    // length code index (0 based from 257) for match lengths 0 to 258
+    uint8_t length_code[max_match + 1];
+
+    // distance codes for distances 1 to 256 and for (distance - 1) >> 7
+    uint8_t dist_code_lo[256];
+    uint8_t dist_code_hi[256];
+
+    // the fixed huffman codes
+    uint8_t fixed_litlen_lengths[288];
+    uint16_t fixed_litlen_codes[288];
+    uint8_t fixed_dist_lengths[dist_codes];
+    uint16_t fixed_dist_codes[dist_codes];
+
+    // crc32 slicing tables
+    uint32_t crc[8][256];
+
+    code_tables() noexcept;
+
+    uint8_t dist_code(size_t dist) const noexcept
+    {
+        return (dist <= 256) ? dist_code_lo[dist - 1] : dist_code_hi[(dist - 1) >> 7];
+    }
+};
+
+static void build_codes(const uint8_t* lengths, size_t count, uint16_t* codes) noexcept;
+
+code_tables::code_tables() noexcept
+{
+    for (size_t code = 0; code < 29; ++code)
+    {
+        const size_t last = (code == 28) ? max_match : length_base[code] + (size_t(1) << length_extra[code]) - 1;
+        for (size_t len = length_base[code]; len <= last; ++len)
+        {
+            length_code[len] = static_cast<uint8_t>(code);
+        }
+    }
+
+    // 284 covers 258 as well but 285 is the code for it
+    length_code[0] = length_code[1] = length_code[2] = 0;
+    length_code[max_match] = 28;
+
+    for (size_t code = 0; code < dist_codes; ++code)
+    {
+        const size_t first = dist_base[code];
+        const size_t last = first + (size_t(1) << dist_extra[code]) - 1;
+
+        for (size_t dist = first; dist <= last; ++dist)
+        {
+            if (dist <= 256)
+            {
+                dist_code_lo[dist - 1] = static_cast<uint8_t>(code);
+            }
+            else
+            {
+                dist_code_hi[(dist - 1) >> 7] = static_cast<uint8_t>(code);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < 288; ++i)
+    {
+        fixed_litlen_lengths[i] = (i < 144) ? 8 : (i < 256) ? 9 : (i < 280) ? 7 : 8;
+    }
+
+    std::fill_n(fixed_dist_lengths, dist_codes, static_cast<uint8_t>(5));
+    build_codes(fixed_litlen_lengths, 288, fixed_litlen_codes);
+    build_codes(fixed_dist_lengths, dist_codes, fixed_dist_codes);
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+        {
+            c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        }
+        crc[0][i] = c;
+    }
+
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        for (size_t k = 1; k < 8; ++k)
+        {
+            crc[k][i] = (crc[k - 1][i] >> 8) ^ crc[0][crc[k - 1][i] & 0xFF];
+        }
+    }
+}
+
+static const code_tables& get_tables() noexcept
+{
+    static const code_tables tables;
+    return tables;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// huffman codes
+///////////////////////////////////////////////////////////////////////////////
+
+struct symbol_frequency
+{
+    uint32_t key;
+    uint16_t symbol;
+};
+
+// Turns keys sorted by increasing frequency into optimal code lengths in
+// place (Moffat and Katajainen).
+static void minimum_redundancy(symbol_frequency* a, size_t count) noexcept
+{
+    const int n = static_cast<int>(count);
+    int root = 0, leaf = 2, next;
+
+    a[0].key += a[1].key;
+
+    for (next = 1; next < n - 1; ++next)
+    {
+        if (leaf >= n || a[root].key < a[leaf].key)
+        {
+            a[next].key = a[root].key;
+            a[root++].key = static_cast<uint32_t>(next);
+        }
+        else
+        {
+            a[next].key = a[leaf++].key;
+        }
+
+        if (leaf >= n || (root < next && a[root].key < a[leaf].key))
+        {
+            a[next].key += a[root].key;
+            a[root++].key = static_cast<uint32_t>(next);
+        }
+        else
+        {
+            a[next].key += a[leaf++].key;
+        }
+    }
+
+    a[n - 2].key = 0;
+    for (next = n - 3; next >= 0; --next)
+    {
+        a[next].key = a[a[next].key].key + 1;
+    }
+
+    int available = 1, used = 0;
+    uint32_t depth = 0;
+    root = n - 2;
+    next = n - 1;
+
+    while (available > 0)
+    {
+        while (root >= 0 && a[root].key == depth)
+        {
+            ++used;
+            --root;
+        }
+
+        while (available > used)
+        {
+            a[next--].key = depth;
+            --available;
+        }
+
+        available = 2 * used;
+        ++depth;
+        used = 0;
+    }
+}
+
+// Builds code lengths of at most max_bits for the symbols with a nonzero
+// frequency. At least two symbols must be used.
+static void build_lengths(const uint32_t* freq, size_t count, size_t max_bits, uint8_t* lengths) noexcept
+{
+    symbol_frequency syms[288] = {};
+    size_t n = 0;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        lengths[i] = 0;
+        if (freq[i])
+        {
+            syms[n++] = symbol_frequency{ freq[i], static_cast<uint16_t>(i) };
+        }
+    }
+
+    std::sort(syms, syms + n, [](const symbol_frequency& a, const symbol_frequency& b)
+    {
+        return (a.key != b.key) ? (a.key < b.key) : (a.symbol < b.symbol);
+    });
+
+    minimum_redundancy(syms, n);
+
+    uint32_t length_count[max_code_bits + 1] = {};
+    for (size_t i = 0; i < n; ++i)
+    {
+        ++length_count[std::min<size_t>(syms[i].key, max_bits)];
+    }
+
+    // Clamping made the code oversubscribed. Each step drops one code from
+    // the longest length and splits a shorter one in two, which removes one
+    // unit of the excess.
+    uint32_t total = 0;
+    for (size_t i = max_bits; i > 0; --i)
+    {
+        total += length_count[i] << (max_bits - i);
+    }
+
+    while (total != (uint32_t(1) << max_bits))
+    {
+        --length_count[max_bits];
+
+        for (size_t i = max_bits - 1; i > 0; --i)
+        {
+            if (length_count[i])
+            {
+                --length_count[i];
+                length_count[i + 1] += 2;
+                break;
+            }
+        }
+
+        --total;
+    }
+
+    // the most frequent symbols are at the end
+    size_t j = n;
+    for (size_t bits = 1; bits <= max_bits; ++bits)
+    {
+        for (uint32_t k = length_count[bits]; k > 0; --k)
+        {
+            lengths[syms[--j].symbol] = static_cast<uint8_t>(bits);
+        }
+    }
+}
+
+// Builds the canonical codes, bit reversed since deflate writes them from
+// the most significant bit into an lsb first stream.
+static void build_codes(const uint8_t* lengths, size_t count, uint16_t* codes) noexcept
+{
+    uint32_t length_count[max_code_bits + 1] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        ++length_count[lengths[i]];
+    }
+    length_count[0] = 0;
+
+    uint32_t next_code[max_code_bits + 1] = {};
+    uint32_t code = 0;
+    for (size_t bits = 1; bits <= max_code_bits; ++bits)
+    {
+        code = (code + length_count[bits - 1]) << 1;
+        next_code[bits] = code;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t len = lengths[i];
+        if (len == 0)
+        {
+            codes[i] = 0;
+            continue;
+        }
+
+        uint32_t c = next_code[len]++;
+        uint32_t reversed = 0;
+        for (size_t b = 0; b < len; ++b)
+        {
+            reversed = (reversed << 1) | (c & 1);
+            c >>= 1;
+        }
+
+        codes[i] = static_cast<uint16_t>(reversed);
+    }
+}
+
+// Deflate decoders expect at least two codes in a tree.
+static void ensure_two_codes(uint32_t* freq, size_t count) noexcept
+{
+    size_t used = 0;
+    for (size_t i = 0; i < count && used < 2; ++i)
+    {
+        used += (freq[i] != 0);
+    }
+
+    for (size_t i = 0; i < count && used < 2; ++i)
+    {
+        if (freq[i] == 0)
+        {
+            freq[i] = 1;
+            ++used;
+        }
+    }
+}
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+// checksums
+///////////////////////////////////////////////////////////////////////////////
+
+uint32_t crc32(uint32_t crc, const byte_type* data, size_t size) noexcept
+{
+    const auto& t = _priv::get_tables().crc;
+    crc = ~crc;
+
+    while (size >= 8)
+    {
+        const uint32_t lo = crc ^ (uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24));
+        const uint32_t hi = uint32_t(data[4]) | (uint32_t(data[5]) << 8) | (uint32_t(data[6]) << 16) | (uint32_t(data[7]) << 24);
+
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+            ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+
+        data += 8;
+        size -= 8;
+    }
+
+    while (size--)
+    {
+        crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    }
+
+    return ~crc;
+}
+
+enum : uint32_t
+{
+    adler_base = 65521,
+
+    // the most bytes summed before b can overflow 32 bits
+    adler_max_run = 5552
+};
+
+uint32_t adler32(uint32_t adler, const byte_type* data, size_t size) noexcept
+{
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+
+    while (size > 0)
+    {
+        size_t n = std::min<size_t>(size, adler_max_run);
+        size -= n;
+
+        for (; n >= 8; n -= 8, data += 8)
+        {
+            a += data[0]; b += a;
+            a += data[1]; b += a;
+            a += data[2]; b += a;
+            a += data[3]; b += a;
+            a += data[4]; b += a;
+            a += data[5]; b += a;
+            a += data[6]; b += a;
+            a += data[7]; b += a;
+        }
+
+        for (; n > 0; --n)
+        {
+            a += *data++;
+            b += a;
+        }
+
+        a %= adler_base;
+        b %= adler_base;
+    }
+
+    return (b << 16) | a;
+}
+
+uint32_t adler32_combine(uint32_t a, uint32_t b, size_t b_size) noexcept
+{
+    const uint32_t rem = static_cast<uint32_t>(b_size % adler_base);
+
+    uint32_t sum1 = a & 0xFFFF;
+    uint32_t sum2 = static_cast<uint32_t>((uint64_t(rem) * sum1) % adler_base);
+
+    sum1 += (b & 0xFFFF) + adler_base - 1;
+    sum2 += (a >> 16) + (b >> 16) + adler_base - rem;
+
+    if (sum1 >= adler_base) sum1 -= adler_base;
+    if (sum1 >= adler_base) sum1 -= adler_base;
+    if (sum2 >= (adler_base << 1)) sum2 -= (adler_base << 1);
+    if (sum2 >= adler_base) sum2 -= adler_base;
+
+    return (sum2 << 16) | sum1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// bit writer
+///////////////////////////////////////////////////////////////////////////////
+
+// Writes lsb first into a byte vector. Space must be reserved before writing.
+class deflater::bit_writer
+{
+public:
+
+    explicit bit_writer(std::vector<byte_type>& out) noexcept
+        : m_out(out), m_size(out.size()) {}
+
+    void reserve(size_t bytes)
+    {
+        const size_t needed = m_size + bytes + 8;
+        if (m_out.size() < needed)
+        {
+            m_out.resize(std::max(needed, m_out.size() * 2));
+        }
+    }
+
+    // count must be at most 32
+    void put(uint32_t bits, size_t count) noexcept
+    {
+        m_bits |= static_cast<uint64_t>(bits) << m_count;
+        m_count += count;
+
+        if (m_count >= 32)
+        {
+            byte_type* p = &m_out[m_size];
+            p[0] = static_cast<byte_type>(m_bits);
+            p[1] = static_cast<byte_type>(m_bits >> 8);
+            p[2] = static_cast<byte_type>(m_bits >> 16);
+            p[3] = static_cast<byte_type>(m_bits >> 24);
+
+            m_size += 4;
+            m_bits >>= 32;
+            m_count -= 32;
+        }
+    }
+
+    // pads to the next byte boundary
+    void align() noexcept
+    {
+        while (m_count > 0)
+        {
+            m_out[m_size++] = static_cast<byte_type>(m_bits);
+            m_bits >>= 8;
+            m_count = (m_count > 8) ? m_count - 8 : 0;
+        }
+
+        m_bits = 0;
+    }
+
+    // must be aligned
+    void put_bytes(const byte_type* data, size_t size) noexcept
+    {
+        std::memcpy(&m_out[m_size], data, size);
+        m_size += size;
+    }
+
+    size_t pending_bits() const noexcept { return m_count; }
+
+    void finish()
+    {
+        align();
+        m_out.resize(m_size);
+    }
+
+private:
+
+    std::vector<byte_type>& m_out;
+    size_t m_size;
+    uint64_t m_bits = 0;
+    size_t m_count = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// deflater
+///////////////////////////////////////////////////////////////////////////////
+
+deflater::deflater(deflate_effort effort, bool filtered)
+    : m_effort(effort)
+    , m_min_length(filtered ? 6 : static_cast<size_t>(_priv::min_match))
+{
+    switch (effort)
+    {
+        case deflate_effort::normal:
+        {
+            m_max_chain = 16;
+            m_good_length = 8;
+            m_nice_length = 128;
+            m_lazy_limit = 16;
+            break;
+        }
+        case deflate_effort::max:
+        {
+            m_max_chain = 4096;
+            m_good_length = 32;
+            m_nice_length = _priv::max_match;
+            m_lazy_limit = _priv::max_match;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    if (effort == deflate_effort::normal || effort == deflate_effort::max)
+    {
+        m_head.resize(_priv::hash_size);
+        m_prev.resize(deflate_window_size);
+    }
+
+    if (effort != deflate_effort::store)
+    {
+        m_symbols.reserve(_priv::block_symbols);
+    }
+}
+
+void deflater::compress(const byte_type* data, size_t begin, size_t end, std::vector<byte_type>& out)
+{
+    bit_writer w(out);
+
+    switch (m_effort)
+    {
+        case deflate_effort::store:     compress_stored(data, begin, end, w);   break;
+        case deflate_effort::rle:       compress_rle(data, begin, end, w);      break;
+        default:                        compress_lz(data, begin, end, w);       break;
+    }
+
+    // sync flush, an empty stored block ending on a byte boundary
+    w.reserve(8);
+    w.put(0, 3);
+    w.align();
+    w.put(0x0000, 16);
+    w.put(0xFFFF, 16);
+    w.finish();
+}
+
+void deflater::compress_stored(const byte_type* data, size_t begin, size_t end, bit_writer& w)
+{
+    while (begin < end)
+    {
+        const size_t size = std::min<size_t>(end - begin, _priv::max_stored_block);
+
+        w.reserve(size + 8);
+        w.put(0, 3);
+        w.align();
+        w.put(static_cast<uint32_t>(size), 16);
+        w.put(static_cast<uint32_t>(~size & 0xFFFF), 16);
+        w.put_bytes(data + begin, size);
+
+        begin += size;
+    }
+}
+
+void deflater::compress_rle(const byte_type* data, size_t begin, size_t end, bit_writer& w)
+{
+    size_t block_start = begin;
+    size_t pos = begin;
+
+    while (pos < end)
+    {
+        size_t len = 0;
+
+        // a run of the previous byte, which may be in the previous piece
+        if (pos > 0)
+        {
+            const size_t max_len = std::min<size_t>(end - pos, _priv::max_match);
+            const byte_type value = data[pos - 1];
+
+            while (len < max_len && data[pos + len] == value)
+            {
+                ++len;
+            }
+        }
+
+        if (len >= _priv::min_match)
+        {
+            m_symbols.push_back(symbol{ static_cast<uint16_t>(len), 1 });
+            pos += len;
+        }
+        else
+        {
+            m_symbols.push_back(symbol{ data[pos], 0 });
+            ++pos;
+        }
+
+        if (m_symbols.size() == _priv::block_symbols)
+        {
+            flush_block(data + block_start, pos - block_start, w);
+            block_start = pos;
+        }
+    }
+
+    if (!m_symbols.empty())
+    {
+        flush_block(data + block_start, pos - block_start, w);
+    }
+}
+
+void deflater::insert(const byte_type* data, size_t pos, size_t end) noexcept
+{
+    if (pos + _priv::min_match > end)
+    {
+        return;
+    }
+
+    const uint32_t v = uint32_t(data[pos]) | (uint32_t(data[pos + 1]) << 8) | (uint32_t(data[pos + 2]) << 16);
+    const uint32_t h = (v * 2654435761u) >> (32 - _priv::hash_bits);
+
+    m_prev[pos & _priv::window_mask] = m_head[h];
+    m_head[h] = static_cast<int32_t>(pos);
+}
+
+size_t deflater::find_match(const byte_type* data, size_t pos, size_t end, size_t max_chain, size_t& dist) const noexcept
+{
+    if (pos + _priv::min_match > end)
+    {
+        return 0;
+    }
+
+    const size_t max_len = std::min<size_t>(end - pos, _priv::max_match);
+    const size_t nice = std::min(m_nice_length, max_len);
+    const size_t limit = (pos > deflate_window_size) ? pos - deflate_window_size : 0;
+
+    const uint32_t v = uint32_t(data[pos]) | (uint32_t(data[pos + 1]) << 8) | (uint32_t(data[pos + 2]) << 16);
+    const uint32_t h = (v * 2654435761u) >> (32 - _priv::hash_bits);
+
+    const byte_type* cur = data + pos;
+    size_t best = _priv::min_match - 1;
+    int32_t candidate = m_head[h];
+
+    for (size_t chain = max_chain; chain > 0 && candidate >= 0 && static_cast<size_t>(candidate) >= limit; --chain)
+    {
+        const byte_type* match = data + candidate;
+
+        // the byte that would make this match longer than the best decides first
+        if (match[best] == cur[best] && match[0] == cur[0] && match[1] == cur[1])
+        {
+            size_t len = 0;
+
+            while (len + 8 <= max_len)
+            {
+                uint64_t a, b;
+                std::memcpy(&a, match + len, 8);
+                std::memcpy(&b, cur + len, 8);
+
+                if (a != b)
+                {
+                    break;
+                }
+
+                len += 8;
+            }
+
+            while (len < max_len && match[len] == cur[len])
+            {
+                ++len;
+            }
+
+            if (len > best)
+            {
+                best = len;
+                dist = pos - static_cast<size_t>(candidate);
+
+                if (len >= nice)
+                {
+                    break;
+                }
+            }
+        }
+
+        const int32_t next = m_prev[static_cast<size_t>(candidate) & _priv::window_mask];
+        if (next >= candidate)
+        {
+            break;
+        }
+
+        candidate = next;
+    }
+
+    return (best >= _priv::min_match) ? best : 0;
+}
+
+// Short matches far back cost more bits than the literals they replace, as
+// do most short matches in filtered data, where literals are small numbers
+// with short codes.
+bool deflater::worth_matching(size_t len, size_t dist) const noexcept
+{
+    return len >= m_min_length && !(len == _priv::min_match && dist > _priv::too_far);
+}
+
+void deflater::compress_lz(const byte_type* data, size_t begin, size_t end, bit_writer& w)
+{
+    std::fill(m_head.begin(), m_head.end(), -1);
+
+    // the window before the piece
+    const size_t history = (begin > deflate_window_size) ? begin - deflate_window_size : 0;
+    for (size_t pos = history; pos < begin; ++pos)
+    {
+        insert(data, pos, end);
+    }
+
+    size_t block_start = begin;
+    size_t pos = begin;
+
+    // a match found one byte ahead by the lazy check, carried to the next step
+    size_t pending_len = 0;
+    size_t pending_dist = 0;
+
+    while (pos < end)
+    {
+        size_t dist = 0;
+        size_t len = 0;
+
+        if (pending_len)
+        {
+            len = pending_len;
+            dist = pending_dist;
+            pending_len = 0;
+        }
+        else
+        {
+            len = find_match(data, pos, end, m_max_chain, dist);
+            len = worth_matching(len, dist) ? len : 0;
+        }
+
+        if (len == 0)
+        {
+            m_symbols.push_back(symbol{ data[pos], 0 });
+            insert(data, pos, end);
+            ++pos;
+        }
+        else if (len < m_lazy_limit && pos + 1 < end)
+        {
+            insert(data, pos, end);
+
+            // a good match already, look less hard for a better one
+            const size_t chain = (len >= m_good_length) ? m_max_chain / 4 : m_max_chain;
+
+            size_t next_dist = 0;
+            size_t next_len = find_match(data, pos + 1, end, chain, next_dist);
+            next_len = worth_matching(next_len, next_dist) ? next_len : 0;
+
+            if (next_len > len)
+            {
+                m_symbols.push_back(symbol{ data[pos], 0 });
+                pending_len = next_len;
+                pending_dist = next_dist;
+                ++pos;
+            }
+            else
+            {
+                m_symbols.push_back(symbol{ static_cast<uint16_t>(len), static_cast<uint16_t>(dist) });
+                for (size_t i = 1; i < len; ++i)
+                {
+                    insert(data, pos + i, end);
+                }
+                pos += len;
+            }
+        }
+        else
+        {
+            m_symbols.push_back(symbol{ static_cast<uint16_t>(len), static_cast<uint16_t>(dist) });
+            for (size_t i = 0; i < len; ++i)
+            {
+                insert(data, pos + i, end);
+            }
+            pos += len;
+        }
+
+        // a pending match belongs to the next block, which starts at pos
+        if (m_symbols.size() >= _priv::block_symbols)
+        {
+            flush_block(data + block_start, pos - block_start, w);
+            block_start = pos;
+        }
+    }
+
+    if (!m_symbols.empty())
+    {
+        flush_block(data + block_start, pos - block_start, w);
+    }
+}
+
+void deflater::flush_block(const byte_type* raw, size_t raw_size, bit_writer& w)
+{
+    using namespace _priv;
+    const code_tables& tables = get_tables();
+
+    uint32_t litlen_freq[litlen_codes] = {};
+    uint32_t dist_freq[dist_codes] = {};
+    size_t extra_bits = 0;
+
+    for (const symbol& s : m_symbols)
+    {
+        if (s.dist == 0)
+        {
+            ++litlen_freq[s.value];
+        }
+        else
+        {
+            const size_t lc = tables.length_code[s.value];
+            const size_t dc = tables.dist_code(s.dist);
+
+            ++litlen_freq[257 + lc];
+            ++dist_freq[dc];
+            extra_bits += length_extra[lc] + dist_extra[dc];
+        }
+    }
+
+    litlen_freq[end_of_block] = 1;
+
+    // dynamic codes
+    uint8_t litlen_lengths[litlen_codes];
+    uint8_t dist_lengths[dist_codes];
+    {
+        uint32_t ll[litlen_codes];
+        uint32_t d[dist_codes];
+        std::copy_n(litlen_freq, litlen_codes, ll);
+        std::copy_n(dist_freq, dist_codes, d);
+        ensure_two_codes(ll, litlen_codes);
+        ensure_two_codes(d, dist_codes);
+
+        build_lengths(ll, litlen_codes, max_code_bits, litlen_lengths);
+        build_lengths(d, dist_codes, max_code_bits, dist_lengths);
+    }
+
+    size_t hlit = litlen_codes;
+    while (hlit > 257 && litlen_lengths[hlit - 1] == 0) --hlit;
+    size_t hdist = dist_codes;
+    while (hdist > 1 && dist_lengths[hdist - 1] == 0) --hdist;
+
+    // run length encode the code lengths
+    uint8_t lengths[litlen_codes + dist_codes];
+    std::copy_n(litlen_lengths, hlit, lengths);
+    std::copy_n(dist_lengths, hdist, lengths + hlit);
+    const size_t length_count = hlit + hdist;
+
+    struct codelen_symbol
+    {
+        uint8_t symbol;
+        uint8_t extra;
+    };
+
+    codelen_symbol codelens[litlen_codes + dist_codes];
+    size_t codelen_count = 0;
+    uint32_t codelen_freq[codelen_codes] = {};
+
+    for (size_t i = 0; i < length_count;)
+    {
+        const uint8_t value = lengths[i];
+        size_t run = 1;
+        while (i + run < length_count && lengths[i + run] == value)
+        {
+            ++run;
+        }
+        i += run;
+
+        if (value == 0)
+        {
+            while (run >= 11)
+            {
+                const size_t n = std::min<size_t>(run, 138);
+                codelens[codelen_count++] = codelen_symbol{ 18, static_cast<uint8_t>(n - 11) };
+                run -= n;
+            }
+
+            if (run >= 3)
+            {
+                codelens[codelen_count++] = codelen_symbol{ 17, static_cast<uint8_t>(run - 3) };
+                run = 0;
+            }
+        }
+        else
+        {
+            codelens[codelen_count++] = codelen_symbol{ value, 0 };
+            --run;
+
+            while (run >= 3)
+            {
+                const size_t n = std::min<size_t>(run, 6);
+                codelens[codelen_count++] = codelen_symbol{ 16, static_cast<uint8_t>(n - 3) };
+                run -= n;
+            }
+        }
+
+        while (run > 0)
+        {
+            codelens[codelen_count++] = codelen_symbol{ value, 0 };
+            --run;
+        }
+    }
+
+    for (size_t i = 0; i < codelen_count; ++i)
+    {
+        ++codelen_freq[codelens[i].symbol];
+    }
+
+    uint8_t codelen_lengths[codelen_codes];
+    {
+        uint32_t cl[codelen_codes];
+        std::copy_n(codelen_freq, codelen_codes, cl);
+        ensure_two_codes(cl, codelen_codes);
+        build_lengths(cl, codelen_codes, max_codelen_bits, codelen_lengths);
+    }
+
+    size_t hclen = codelen_codes;
+    while (hclen > 4 && codelen_lengths[codelen_order[hclen - 1]] == 0) --hclen;
+
+    // the size of each kind of block
+    size_t dynamic_bits = 3 + 14 + 3 * hclen + extra_bits;
+    size_t fixed_bits = 3 + extra_bits;
+
+    for (size_t i = 0; i < codelen_codes; ++i)
+    {
+        const size_t extra = (i == 16) ? 2 : (i == 17) ? 3 : (i == 18) ? 7 : 0;
+        dynamic_bits += codelen_freq[i] * (codelen_lengths[i] + extra);
+    }
+
+    for (size_t i = 0; i < litlen_codes; ++i)
+    {
+        dynamic_bits += litlen_freq[i] * litlen_lengths[i];
+        fixed_bits += litlen_freq[i] * tables.fixed_litlen_lengths[i];
+    }
+
+    for (size_t i = 0; i < dist_codes; ++i)
+    {
+        dynamic_bits += dist_freq[i] * dist_lengths[i];
+        fixed_bits += dist_freq[i] * 5;
+    }
+
+    const size_t stored_blocks = (raw_size + max_stored_block - 1) / max_stored_block;
+    const size_t stored_bits = stored_blocks * (3 + 7 + 32) + raw_size * 8;
+
+    if (stored_bits <= dynamic_bits && stored_bits <= fixed_bits)
+    {
+        m_symbols.clear();
+        compress_stored(raw, 0, raw_size, w);
+        return;
+    }
+
+    const bool dynamic = dynamic_bits < fixed_bits;
+    w.reserve((dynamic ? dynamic_bits : fixed_bits) / 8 + 8);
+
+    uint16_t litlen_codes_buf[litlen_codes];
+    uint16_t dist_codes_buf[dist_codes];
+    const uint8_t* ll_len;
+    const uint16_t* ll_code;
+    const uint8_t* d_len;
+    const uint16_t* d_code;
+
+    if (dynamic)
+    {
+        uint16_t codelen_codes_buf[codelen_codes];
+        build_codes(codelen_lengths, codelen_codes, codelen_codes_buf);
+        build_codes(litlen_lengths, litlen_codes, litlen_codes_buf);
+        build_codes(dist_lengths, dist_codes, dist_codes_buf);
+
+        w.put(2 << 1, 3);
+        w.put(static_cast<uint32_t>(hlit - 257), 5);
+        w.put(static_cast<uint32_t>(hdist - 1), 5);
+        w.put(static_cast<uint32_t>(hclen - 4), 4);
+
+        for (size_t i = 0; i < hclen; ++i)
+        {
+            w.put(codelen_lengths[codelen_order[i]], 3);
+        }
+
+        for (size_t i = 0; i < codelen_count; ++i)
+        {
+            const codelen_symbol& s = codelens[i];
+            w.put(codelen_codes_buf[s.symbol], codelen_lengths[s.symbol]);
+
+            switch (s.symbol)
+            {
+                case 16:    w.put(s.extra, 2); break;
+                case 17:    w.put(s.extra, 3); break;
+                case 18:    w.put(s.extra, 7); break;
+                default:    break;
+            }
+        }
+
+        ll_len = litlen_lengths;
+        ll_code = litlen_codes_buf;
+        d_len = dist_lengths;
+        d_code = dist_codes_buf;
+    }
+    else
+    {
+        w.put(1 << 1, 3);
+
+        ll_len = tables.fixed_litlen_lengths;
+        ll_code = tables.fixed_litlen_codes;
+        d_len = tables.fixed_dist_lengths;
+        d_code = tables.fixed_dist_codes;
+    }
+
+    for (const symbol& s : m_symbols)
+    {
+        if (s.dist == 0)
+        {
+            w.put(ll_code[s.value], ll_len[s.value]);
+        }
+        else
+        {
+            const size_t lc = tables.length_code[s.value];
+            const size_t dc = tables.dist_code(s.dist);
+
+            w.put(ll_code[257 + lc], ll_len[257 + lc]);
+            w.put(s.value - length_base[lc], length_extra[lc]);
+            w.put(d_code[dc], d_len[dc]);
+            w.put(s.dist - dist_base[dc], dist_extra[dc]);
+        }
+    }
+
+    w.put(ll_code[end_of_block], ll_len[end_of_block]);
+    m_symbols.clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// zlib
+///////////////////////////////////////////////////////////////////////////////
+
+void write_zlib_header(deflate_effort effort, std::vector<byte_type>& out)
+{
+    // deflate with a 32K window, the level is informative only
+    byte_type flags;
+    switch (effort)
+    {
+        case deflate_effort::store:
+        case deflate_effort::rle:       flags = 0x01; break;
+        case deflate_effort::normal:    flags = 0x9C; break;
+        default:                        flags = 0xDA; break;
+    }
+
+    out.push_back(0x78);
+    out.push_back(flags);
+}
+
+void write_zlib_trailer(uint32_t adler, std::vector<byte_type>& out)
+{
+    // an empty final block with fixed codes: 1, 01 and the 7 bit end of block
+    out.push_back(0x03);
+    out.push_back(0x00);
+
+    out.push_back(static_cast<byte_type>(adler >> 24));
+    out.push_back(static_cast<byte_type>(adler >> 16));
+    out.push_back(static_cast<byte_type>(adler >> 8));
+    out.push_back(static_cast<byte_type>(adler));
+}
+
+void zlib_compress(const byte_type* data, size_t size, deflate_effort effort, std::vector<byte_type>& out)
+{
+    write_zlib_header(effort, out);
+
+    deflater d(effort, false);
+    d.compress(data, 0, size, out);
+
+    write_zlib_trailer(adler32(1, data, size), out);
+}
+
+} // namespace img
+} // namespace vx
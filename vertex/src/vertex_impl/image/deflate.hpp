@@ -0,0 +1,110 @@
+#pragma once
+
+#include <vector>
+
+#include "vertex/image/defs.hpp"
+
+namespace vx {
+namespace img {
+
+///////////////////////////////////////////////////////////////////////////////
+// checksums
+///////////////////////////////////////////////////////////////////////////////
+
+// Updates a crc32, start with 0.
+uint32_t crc32(uint32_t crc, const byte_type* data, size_t size) noexcept;
+
+// Updates an adler32, start with 1.
+uint32_t adler32(uint32_t adler, const byte_type* data, size_t size) noexcept;
+
+// Combines the adler32 of two consecutive buffers, b_size is the size of the
+// second one.
+uint32_t adler32_combine(uint32_t a, uint32_t b, size_t b_size) noexcept;
+
+///////////////////////////////////////////////////////////////////////////////
+// deflate
+///////////////////////////////////////////////////////////////////////////////
+
+enum class deflate_effort
+{
+    store,      // stored blocks only
+    rle,        // matches at distance 1 only
+    normal,     // hash chain matches with lazy evaluation
+    max         // long hash chains
+};
+
+enum : size_t
+{
+    deflate_window_size = 32768
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// @brief Compresses part of a buffer into raw deflate blocks.
+///
+/// Compresses `data[begin, end)` and appends the blocks to out. None of the
+/// blocks is final and the output ends with a sync flush, so it ends on a
+/// byte boundary. Matches may reach up to deflate_window_size bytes before
+/// begin, which lets consecutive pieces of a buffer be compressed on their
+/// own and concatenated into one stream with little loss.
+///
+/// The tables are kept between calls, so one deflater can compress several
+/// pieces without reallocating.
+///////////////////////////////////////////////////////////////////////////////
+class deflater
+{
+public:
+
+    // filtered tells the deflater that the data holds small differences, such
+    // as png rows after filtering, which favors literals over short matches
+    deflater(deflate_effort effort, bool filtered);
+
+    void compress(const byte_type* data, size_t begin, size_t end, std::vector<byte_type>& out);
+
+private:
+
+    struct symbol
+    {
+        uint16_t value;     // literal byte or match length
+        uint16_t dist;      // 0 for literals
+    };
+
+    class bit_writer;
+
+    void compress_stored(const byte_type* data, size_t begin, size_t end, bit_writer& w);
+    void compress_rle(const byte_type* data, size_t begin, size_t end, bit_writer& w);
+    void compress_lz(const byte_type* data, size_t begin, size_t end, bit_writer& w);
+
+    bool worth_matching(size_t len, size_t dist) const noexcept;
+    size_t find_match(const byte_type* data, size_t pos, size_t end, size_t max_chain, size_t& dist) const noexcept;
+    void insert(const byte_type* data, size_t pos, size_t end) noexcept;
+
+    void flush_block(const byte_type* raw, size_t raw_size, bit_writer& w);
+
+    deflate_effort m_effort;
+    size_t m_max_chain = 0;
+    size_t m_good_length = 0;
+    size_t m_nice_length = 0;
+    size_t m_lazy_limit = 0;
+    size_t m_min_length;
+
+    std::vector<int32_t> m_head;
+    std::vector<int32_t> m_prev;
+    std::vector<symbol> m_symbols;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// zlib
+///////////////////////////////////////////////////////////////////////////////
+
+// Appends the two byte zlib header.
+void write_zlib_header(deflate_effort effort, std::vector<byte_type>& out);
+
+// Ends a stream of pieces from deflater: appends an empty final block and
+// the adler32 of the uncompressed data.
+void write_zlib_trailer(uint32_t adler, std::vector<byte_type>& out);
+
+// Compresses a whole buffer into a zlib stream on the calling thread.
+void zlib_compress(const byte_type* data, size_t size, deflate_effort effort, std::vector<byte_type>& out);
+
+} // namespace img
+} // namespace vx
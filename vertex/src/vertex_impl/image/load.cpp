@@ -1,8 +1,11 @@
-#include <vector>
+#include <cstring>
+#include <limits>
 #include <sstream>
 
 #include "vertex/system/error.hpp"
 #include "vertex/image/load.hpp"
+#include "vertex/os/mapped_file.hpp"
+#include "vertex/std/defer.hpp"
 #include "vertex_impl/image/util.hpp"
 
 #define VX_IMG_LOAD_IMPLEMENTATION
@@ -52,6 +55,91 @@
 #   define STBI_NO_LINEAR
 #   define STBI_ASSERT assert
 
+namespace vx {
+namespace img {
+namespace _priv {
+
+///////////////////////////////////////////////////////////////////////////////
+// decode target
+///////////////////////////////////////////////////////////////////////////////
+
+// stb_image allocates the decoded pixels with STBI_MALLOC. While a target is
+// set, an allocation of exactly the decoded image size is given the target
+// instead of heap memory, so the decoder usually writes the final pixels
+// straight into the storage of the caller. Every other allocation goes to the
+// heap. An intermediate buffer of the same size may still take the target,
+// so decode checks which buffer came back and copies if it was not the target.
+struct decode_target
+{
+    byte_type* data;
+    size_t size;
+    bool in_use;
+};
+
+static thread_local decode_target stl_decode_target = {};
+
+static bool is_decode_target(const void* ptr) noexcept
+{
+    return ptr != nullptr && ptr == stl_decode_target.data;
+}
+
+static void* decode_malloc(size_t size) noexcept
+{
+    decode_target& target = stl_decode_target;
+
+    if (target.data && !target.in_use && size == target.size)
+    {
+        target.in_use = true;
+        return target.data;
+    }
+
+    return std::malloc(size);
+}
+
+static void* decode_realloc(void* ptr, size_t size) noexcept
+{
+    if (!is_decode_target(ptr))
+    {
+        return std::realloc(ptr, size);
+    }
+
+    decode_target& target = stl_decode_target;
+
+    if (size == target.size)
+    {
+        return ptr;
+    }
+
+    // no longer the size of the image, move to the heap and release it
+    void* moved = std::malloc(size);
+    if (moved)
+    {
+        std::memcpy(moved, ptr, (size < target.size) ? size : target.size);
+        target.in_use = false;
+    }
+
+    return moved;
+}
+
+static void decode_free(void* ptr) noexcept
+{
+    if (is_decode_target(ptr))
+    {
+        stl_decode_target.in_use = false;
+        return;
+    }
+
+    std::free(ptr);
+}
+
+} // namespace _priv
+} // namespace img
+} // namespace vx
+
+#   define STBI_MALLOC(size)        vx::img::_priv::decode_malloc(size)
+#   define STBI_REALLOC(ptr, size)  vx::img::_priv::decode_realloc(ptr, size)
+#   define STBI_FREE(ptr)           vx::img::_priv::decode_free(ptr)
+
 VX_DISABLE_WARNING_PUSH()
 VX_DISABLE_WARNING("-Wconversion", 4244)
 VX_DISABLE_WARNING("-Wsign-conversion", 0)
@@ -71,23 +159,40 @@ namespace img {
 // error handling
 ///////////////////////////////////////////////////////////////////////////////
 
+// filename is null when loading from memory
 static void load_error(const char* filename)
 {
     std::ostringstream oss;
-    oss << "failed to load image file \"" << filename << '"';
+
+    if (filename)
+    {
+        oss << "failed to load image file \"" << filename << '"';
+    }
+    else
+    {
+        oss << "failed to load image from memory";
+    }
 
     if (stbi_failure_reason())
     {
         oss << ": " << stbi_failure_reason();
     }
 
-    err::set(err::file_open_failed, oss.str().c_str());
+    err::set(filename ? err::file_open_failed : err::failed, oss.str().c_str());
 }
 
 static void load_process_error(const char* filename, error_code code)
 {
     std::ostringstream oss;
-    oss << "failed to load image file \"" << filename << "\": " << error_code_to_string(code);
+
+    if (filename)
+    {
+        oss << "failed to load image file \"" << filename << "\": " << error_code_to_string(code);
+    }
+    else
+    {
+        oss << "failed to load image from memory: " << error_code_to_string(code);
+    }
 
     err::set(err::failed, oss.str().c_str());
 }
@@ -96,13 +201,33 @@ static void load_process_error(const char* filename, error_code code)
 // load
 ///////////////////////////////////////////////////////////////////////////////
 
-static bool get_file_info(const char* filename, image_info& info)
+static bool map_file(const char* filename, os::mapped_file& file)
+{
+    if (!file.map(filename, os::mapped_file::access::read_only) || file.empty())
+    {
+        std::ostringstream oss;
+        oss << "failed to load image file \"" << filename << '"';
+        err::set(err::file_open_failed, oss.str().c_str());
+        return false;
+    }
+
+    return true;
+}
+
+static bool get_info(span<const byte_type> data, image_info& info, const char* filename)
 {
     info.width = info.height = 0;
-    info.format = pixel::pixel_format::unknown;
+    info.format = pixel_format::unknown;
+
+    // stb_image takes the length as an int
+    if (data.size() > static_cast<size_t>(std::numeric_limits<int>::max()))
+    {
+        load_process_error(filename, error_code::max_size);
+        return false;
+    }
 
     int width, height, channels;
-    const bool success = stbi_info(filename, &width, &height, &channels);
+    const bool success = stbi_info_from_memory(data.data(), static_cast<int>(data.size()), &width, &height, &channels);
     if (!success)
     {
         load_error(filename);
@@ -113,32 +238,38 @@ static bool get_file_info(const char* filename, image_info& info)
     {
         static_cast<size_t>(width),
         static_cast<size_t>(height),
-        pixel::channel_count_to_8_bit_format(static_cast<size_t>(channels))
+        static_cast<pixel_format>(pixel::channel_count_to_8_bit_format(static_cast<size_t>(channels)))
     };
 
-    return true;
-}
-
-static bool load_internal(const char* filename, image_info& info, std::vector<byte_type>& data)
-{
-    if (!get_file_info(filename, info))
-    {
-        return false;
-    }
-
-    error_code err;
-
     // check for any errors in final image info
-    err = get_image_info_error(info);
+    const error_code err = get_image_info_error(info);
     if (err != error_code::none)
     {
         load_process_error(filename, err);
         return false;
     }
 
+    return true;
+}
+
+// Decodes into pixels, which must hold at least info.data_size() bytes. Bytes
+// past the image are left untouched.
+static bool decode(span<const byte_type> data, const image_info& info, byte_type* pixels, const char* filename)
+{
+    const size_t size = info.data_size();
+
+    _priv::stl_decode_target = _priv::decode_target{ pixels, size, false };
+    VX_DEFER{ _priv::stl_decode_target = _priv::decode_target{}; };
+
+    // ask for the channel count of the file so the decoder never converts
     int width, height, channels;
     stbi_set_flip_vertically_on_load(false);
-    stbi_uc* raw = stbi_load(filename, &width, &height, &channels, 0);
+    stbi_uc* raw = stbi_load_from_memory(
+        data.data(),
+        static_cast<int>(data.size()),
+        &width, &height, &channels,
+        static_cast<int>(info.channels())
+    );
 
     if (raw == nullptr)
     {
@@ -146,32 +277,116 @@ static bool load_internal(const char* filename, image_info& info, std::vector<by
         return false;
     }
 
-    const size_t size = info.width * info.height * pixel::get_pixel_size(static_cast<pixel::pixel_format>(info.format));
-    data.assign(raw, raw + size);
+    // the pixels ended up in a heap buffer, copy once
+    if (raw != pixels)
+    {
+        std::memcpy(pixels, raw, size);
+    }
+
     stbi_image_free(raw);
+    return true;
+}
+
+static bool load_internal(span<const byte_type> data, image& img, const char* filename)
+{
+    image_info info;
+    if (!get_info(data, info, filename))
+    {
+        return false;
+    }
 
+    image out(info.width, info.height, info.format);
+    if (!decode(data, info, out.data(), filename))
+    {
+        return false;
+    }
+
+    img = std::move(out);
     return true;
 }
 
+bool load_info(const std::string& filename, image_info& info)
+{
+    os::mapped_file file;
+    if (!map_file(filename.c_str(), file))
+    {
+        return false;
+    }
+
+    // the header is all that is read, so only its pages are faulted in
+    return get_info(span<const byte_type>(file.data(), file.size()), info, filename.c_str());
+}
+
+bool load_info_from_memory(span<const byte_type> data, image_info& info)
+{
+    return get_info(data, info, nullptr);
+}
+
 bool load(const std::string& filename, image& img)
 {
-    image_info info;
-    std::vector<byte_type> data;
+    os::mapped_file file;
+    if (!map_file(filename.c_str(), file))
+    {
+        return false;
+    }
 
-    const bool status = load_internal(filename.c_str(), info, data);
-    img = image(data.data(), info.width, info.height, static_cast<pixel_format>(info.format));
+    file.advise(os::mapped_file::advice::sequential);
+    return load_internal(span<const byte_type>(file.data(), file.size()), img, filename.c_str());
+}
+
+bool load_from_memory(span<const byte_type> data, image& img)
+{
+    return load_internal(data, img, nullptr);
+}
+
+bool load_from_memory(span<const byte_type> data, span<byte_type> pixels, image_info& info)
+{
+    if (!get_info(data, info, nullptr))
+    {
+        return false;
+    }
+
+    if (pixels.size() < info.data_size())
+    {
+        err::set(err::size_error, "failed to load image from memory: pixel buffer is too small");
+        return false;
+    }
 
-    return status;
+    return decode(data, info, pixels.data(), nullptr);
 }
 
 #else
 
+bool load_info(const std::string&, image_info&)
+{
+    VX_UNSUPPORTED("img::load_info()");
+    return false;
+}
+
+bool load_info_from_memory(span<const byte_type>, image_info&)
+{
+    VX_UNSUPPORTED("img::load_info_from_memory()");
+    return false;
+}
+
 bool load(const std::string&, image&)
 {
     VX_UNSUPPORTED("img::load()");
     return false;
 }
 
+bool load_from_memory(span<const byte_type>, image&)
+{
+    VX_UNSUPPORTED("img::load_from_memory()");
+    return false;
+}
+
+bool load_from_memory(span<const byte_type>, span<byte_type>, image_info&)
+{
+    VX_UNSUPPORTED("img::load_from_memory()");
+    return false;
+}
+
 #endif // VX_IMG_LOAD_IMPLEMENTATION
 
 } // namespace img
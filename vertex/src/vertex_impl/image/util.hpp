@@ -7,12 +7,6 @@
 namespace vx {
 namespace img {
 
-struct image_info
-{
-    size_t width, height;
-    pixel::pixel_format format;
-};
-
 ///////////////////////////////////////////////////////////////////////////////
 // error handling
 ///////////////////////////////////////////////////////////////////////////////
@@ -44,7 +38,7 @@ inline const char* error_code_to_string(error_code code)
 
 inline error_code get_image_info_error(const image_info& info) noexcept
 {
-    if (info.format == pixel::pixel_format::unknown)
+    if (info.format == pixel_format::unknown)
     {
         return error_code::unsupported_pixel_format;
     }
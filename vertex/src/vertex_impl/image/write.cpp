@@ -1,8 +1,12 @@
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
 #include "vertex/system/error.hpp"
 #include "vertex/image/write.hpp"
+#include "vertex/os/file.hpp"
 #include "vertex_impl/image/util.hpp"
+#include "vertex_impl/image/deflate.hpp"
 
 #define VX_IMG_WRITE_IMPLEMENTATION
 
@@ -30,6 +34,34 @@
 
 #   define STB_IMAGE_WRITE_IMPLEMENTATION
 
+namespace vx {
+namespace img {
+namespace _priv {
+
+// stb's own zlib routines go through our deflater too
+static unsigned char* stbiw_zlib_compress(unsigned char* data, int data_len, int* out_len, int quality)
+{
+    const deflate_effort effort = (quality <= 0) ? deflate_effort::store : (quality < 8) ? deflate_effort::normal : deflate_effort::max;
+
+    std::vector<byte_type> out;
+    zlib_compress(data, static_cast<size_t>(data_len), effort, out);
+
+    unsigned char* buffer = static_cast<unsigned char*>(std::malloc(out.size()));
+    if (buffer)
+    {
+        std::memcpy(buffer, out.data(), out.size());
+        *out_len = static_cast<int>(out.size());
+    }
+
+    return buffer;
+}
+
+} // namespace _priv
+} // namespace img
+} // namespace vx
+
+#   define STBIW_ZLIB_COMPRESS vx::img::_priv::stbiw_zlib_compress
+
 VX_DISABLE_WARNING_PUSH()
 VX_DISABLE_WARNING("-Wconversion", 4244)
 VX_DISABLE_WARNING("-Wsign-conversion", 0)
@@ -48,6 +80,13 @@ namespace img {
 // error handling
 ///////////////////////////////////////////////////////////////////////////////
 
+static void write_error(const char* filename)
+{
+    std::ostringstream oss;
+    oss << "failed to save image file \"" << filename << '"';
+    err::set(err::file_write_failed, oss.str().c_str());
+}
+
 static void write_process_error(const char* filename, error_code code)
 {
     std::ostringstream oss;
@@ -70,7 +109,7 @@ static bool get_write_data(const char* filename, const image& img, image_write_d
 {
     data.info.width = img.width();
     data.info.height = img.height();
-    data.info.format = pixel::channel_count_to_8_bit_format(img.channels());
+    data.info.format = img.format();
 
     data.error = get_image_info_error(data.info);
     if (data.error != error_code::none)
@@ -102,7 +141,7 @@ bool write_bmp(const std::string& filename, const image& img)
         filename.c_str(),
         static_cast<int>(data.info.width),
         static_cast<int>(data.info.height),
-        static_cast<int>(pixel::get_pixel_channel_count(data.info.format)),
+        static_cast<int>(data.info.channels()),
         data.data
     );
 
@@ -138,7 +177,7 @@ bool write_jpg(const std::string& filename, const image& img, int quality)
         filename.c_str(),
         static_cast<int>(data.info.width),
         static_cast<int>(data.info.height),
-        static_cast<int>(pixel::get_pixel_channel_count(data.info.format)),
+        static_cast<int>(data.info.channels()),
         data.data,
         quality
     );
@@ -162,7 +201,302 @@ bool write_jpg(const std::string&, const image&, int)
 
 #if !defined(VX_IMG_NO_PNG)
 
-bool write_png(const std::string& filename, const image& img)
+namespace _priv {
+
+enum : size_t
+{
+    // The filtered rows are compressed in pieces of this size, each of which
+    // can run on its own thread. Every piece sees the 32K window before it,
+    // so splitting costs only a few bytes per piece.
+    png_piece_size = 256 * 1024
+};
+
+struct png_piece
+{
+    std::vector<byte_type> data;
+    uint32_t adler;
+    uint32_t crc;
+};
+
+// Picks whichever of a, b and c is closest to a + b - c. Written without
+// branches, since the choice is close to random on noisy images.
+static inline int paeth(int a, int b, int c) noexcept
+{
+    const int pa = std::abs(b - c);
+    const int pb = std::abs(a - c);
+    const int pc = std::abs(a + b - 2 * c);
+
+    const int bc = (pb <= pc) ? b : c;
+    return (pa <= pb && pa <= pc) ? a : bc;
+}
+
+// Filters one row with a png filter type (0 to 4), prev is the row above.
+// Returns the sum of the filtered bytes as signed values, the estimate the
+// adaptive filter minimizes.
+static size_t filter_row(size_t type, const byte_type* row, const byte_type* prev, size_t size, size_t bpp, byte_type* out) noexcept
+{
+    uint32_t cost = 0;
+
+    // the first pixel has no left neighbor
+    const size_t head = std::min(bpp, size);
+    for (size_t i = 0; i < head; ++i)
+    {
+        int v;
+        switch (type)
+        {
+            case 2:
+            case 4:     v = row[i] - prev[i]; break;
+            case 3:     v = row[i] - (prev[i] >> 1); break;
+            default:    v = row[i]; break;
+        }
+
+        out[i] = static_cast<byte_type>(v);
+        cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(out[i])));
+    }
+
+    // kept as separate loops so each one vectorizes
+    switch (type)
+    {
+        case 0:
+        {
+            for (size_t i = bpp; i < size; ++i)
+            {
+                out[i] = row[i];
+                cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(out[i])));
+            }
+            break;
+        }
+        case 1:
+        {
+            for (size_t i = bpp; i < size; ++i)
+            {
+                out[i] = static_cast<byte_type>(row[i] - row[i - bpp]);
+                cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(out[i])));
+            }
+            break;
+        }
+        case 2:
+        {
+            for (size_t i = bpp; i < size; ++i)
+            {
+                out[i] = static_cast<byte_type>(row[i] - prev[i]);
+                cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(out[i])));
+            }
+            break;
+        }
+        case 3:
+        {
+            for (size_t i = bpp; i < size; ++i)
+            {
+                out[i] = static_cast<byte_type>(row[i] - ((row[i - bpp] + prev[i]) >> 1));
+                cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(out[i])));
+            }
+            break;
+        }
+        case 4:
+        {
+            for (size_t i = bpp; i < size; ++i)
+            {
+                out[i] = static_cast<byte_type>(row[i] - paeth(row[i - bpp], prev[i], prev[i - bpp]));
+                cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(out[i])));
+            }
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+
+    return cost;
+}
+
+// Writes rows [first, last), each as its filter type followed by the
+// filtered bytes.
+static void filter_rows(
+    const byte_type* pixels, size_t row_size, size_t bpp,
+    size_t first, size_t last, png_filter filter,
+    const byte_type* zero_row, byte_type* out)
+{
+    std::vector<byte_type> scratch;
+    if (filter == png_filter::adaptive)
+    {
+        scratch.resize(row_size * 2);
+    }
+
+    for (size_t y = first; y < last; ++y)
+    {
+        const byte_type* row = pixels + y * row_size;
+        const byte_type* prev = (y == 0) ? zero_row : row - row_size;
+        byte_type* dst = out + y * (row_size + 1);
+
+        if (filter != png_filter::adaptive)
+        {
+            const size_t type = static_cast<size_t>(filter) - static_cast<size_t>(png_filter::none);
+            dst[0] = static_cast<byte_type>(type);
+            filter_row(type, row, prev, row_size, bpp, dst + 1);
+            continue;
+        }
+
+        // the best row so far is kept in one scratch row, the next candidate
+        // goes in the other
+        byte_type* best = scratch.data();
+        byte_type* candidate = best + row_size;
+
+        size_t best_type = 0;
+        size_t best_cost = filter_row(0, row, prev, row_size, bpp, best);
+
+        for (size_t type = 1; type < 5; ++type)
+        {
+            const size_t cost = filter_row(type, row, prev, row_size, bpp, candidate);
+            if (cost < best_cost)
+            {
+                best_cost = cost;
+                best_type = type;
+                std::swap(best, candidate);
+            }
+        }
+
+        dst[0] = static_cast<byte_type>(best_type);
+        std::memcpy(dst + 1, best, row_size);
+    }
+}
+
+static deflate_effort get_deflate_effort(png_compression compression) noexcept
+{
+    switch (compression)
+    {
+        case png_compression::store:    return deflate_effort::store;
+        case png_compression::fast:     return deflate_effort::rle;
+        case png_compression::max:      return deflate_effort::max;
+        default:                        return deflate_effort::normal;
+    }
+}
+
+static void write_u32(std::vector<byte_type>& out, uint32_t value)
+{
+    out.push_back(static_cast<byte_type>(value >> 24));
+    out.push_back(static_cast<byte_type>(value >> 16));
+    out.push_back(static_cast<byte_type>(value >> 8));
+    out.push_back(static_cast<byte_type>(value));
+}
+
+// crc covers the tag and the data
+static void write_chunk(std::vector<byte_type>& out, const char* tag, const byte_type* data, size_t size, uint32_t crc)
+{
+    write_u32(out, static_cast<uint32_t>(size));
+    out.insert(out.end(), tag, tag + 4);
+    out.insert(out.end(), data, data + size);
+    write_u32(out, crc);
+}
+
+static uint32_t chunk_crc(const char* tag, const byte_type* data, size_t size) noexcept
+{
+    const uint32_t crc = crc32(0, reinterpret_cast<const byte_type*>(tag), 4);
+    return crc32(crc, data, size);
+}
+
+static void encode_png(const image_write_data& data, const png_write_options& options, std::vector<byte_type>& out)
+{
+    const size_t width = data.info.width;
+    const size_t height = data.info.height;
+    const size_t bpp = data.info.pixel_size();
+    const size_t row_size = width * bpp;
+    const pixel::execution_policy& policy = options.policy;
+
+    // filter
+
+    const std::vector<byte_type> zero_row(row_size);
+    std::vector<byte_type> filtered(height * (row_size + 1));
+
+    policy.for_each_band(height, row_size + 1, [&](size_t first, size_t last)
+    {
+        filter_rows(data.data, row_size, bpp, first, last, options.filter, zero_row.data(), filtered.data());
+    });
+
+    // compress
+
+    const deflate_effort effort = get_deflate_effort(options.compression);
+    const size_t piece_count = (filtered.size() + png_piece_size - 1) / png_piece_size;
+    std::vector<png_piece> pieces((piece_count == 0) ? 1 : piece_count);
+
+    policy.for_each_band(pieces.size(), png_piece_size, [&](size_t first, size_t last)
+    {
+        deflater d(effort, options.filter != png_filter::none);
+
+        for (size_t i = first; i < last; ++i)
+        {
+            const size_t begin = i * png_piece_size;
+            const size_t end = std::min(begin + png_piece_size, filtered.size());
+            png_piece& piece = pieces[i];
+
+            if (i == 0)
+            {
+                write_zlib_header(effort, piece.data);
+            }
+
+            d.compress(filtered.data(), begin, end, piece.data);
+            piece.adler = adler32(1, filtered.data() + begin, end - begin);
+        }
+    });
+
+    uint32_t adler = pieces[0].adler;
+    for (size_t i = 1; i < pieces.size(); ++i)
+    {
+        const size_t begin = i * png_piece_size;
+        const size_t end = std::min(begin + png_piece_size, filtered.size());
+        adler = adler32_combine(adler, pieces[i].adler, end - begin);
+    }
+
+    write_zlib_trailer(adler, pieces.back().data);
+
+    // each piece is written as its own IDAT chunk
+    policy.for_each_band(pieces.size(), png_piece_size, [&](size_t first, size_t last)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            pieces[i].crc = chunk_crc("IDAT", pieces[i].data.data(), pieces[i].data.size());
+        }
+    });
+
+    // assemble
+
+    size_t total = 8 + 25 + 12;
+    for (const png_piece& piece : pieces)
+    {
+        total += piece.data.size() + 12;
+    }
+
+    out.clear();
+    out.reserve(total);
+
+    static const byte_type signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    out.insert(out.end(), signature, signature + 8);
+
+    // 8 bit depth, color type by channel count, no interlacing
+    static const byte_type color_types[5] = { 0, 0, 4, 2, 6 };
+    byte_type header[13] = {};
+    for (size_t i = 0; i < 4; ++i)
+    {
+        header[i] = static_cast<byte_type>(width >> (24 - 8 * i));
+        header[4 + i] = static_cast<byte_type>(height >> (24 - 8 * i));
+    }
+    header[8] = 8;
+    header[9] = color_types[data.info.channels()];
+
+    write_chunk(out, "IHDR", header, sizeof(header), chunk_crc("IHDR", header, sizeof(header)));
+
+    for (const png_piece& piece : pieces)
+    {
+        write_chunk(out, "IDAT", piece.data.data(), piece.data.size(), piece.crc);
+    }
+
+    write_chunk(out, "IEND", nullptr, 0, chunk_crc("IEND", nullptr, 0));
+}
+
+} // namespace _priv
+
+bool write_png(const std::string& filename, const image& img, const png_write_options& options)
 {
     image_write_data data;
     if (!get_write_data(filename.c_str(), img, data))
@@ -170,27 +504,44 @@ bool write_png(const std::string& filename, const image& img)
         return false;
     }
 
-    stbi_flip_vertically_on_write(false);
-    const bool success = stbi_write_png(
-        filename.c_str(),
-        static_cast<int>(data.info.width),
-        static_cast<int>(data.info.height),
-        static_cast<int>(pixel::get_pixel_channel_count(data.info.format)),
-        data.data,
-        static_cast<int>(data.info.width * pixel::get_pixel_size(data.info.format))
-    );
+    std::vector<byte_type> png;
+    _priv::encode_png(data, options, png);
 
-    return success;
+    if (!os::file::write_file(filename, png.data(), png.size()))
+    {
+        write_error(filename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool write_png_to_memory(const image& img, std::vector<byte_type>& png, const png_write_options& options)
+{
+    image_write_data data;
+    if (!get_write_data("<memory>", img, data))
+    {
+        return false;
+    }
+
+    _priv::encode_png(data, options, png);
+    return true;
 }
 
 #else // VX_IMG_NO_PNG
 
-bool write_png(const std::string&, const image&)
+bool write_png(const std::string&, const image&, const png_write_options&)
 {
     VX_UNSUPPORTED("img::write_png()");
     return false;
 }
 
+bool write_png_to_memory(const image&, std::vector<byte_type>&, const png_write_options&)
+{
+    VX_UNSUPPORTED("img::write_png_to_memory()");
+    return false;
+}
+
 #endif // VX_IMG_NO_PNG
 
 #else
@@ -207,12 +558,18 @@ bool write_jpg(const std::string&, const image&, int)
     return false;
 }
 
-bool write_png(const std::string&, const image&)
+bool write_png(const std::string&, const image&, const png_write_options&)
 {
     VX_UNSUPPORTED("img::write_png()");
     return false;
 }
 
+bool write_png_to_memory(const image&, std::vector<byte_type>&, const png_write_options&)
+{
+    VX_UNSUPPORTED("img::write_png_to_memory()");
+    return false;
+}
+
 #endif // VX_IMG_WRITE_IMPLEMENTATION
 
 } // namespace img
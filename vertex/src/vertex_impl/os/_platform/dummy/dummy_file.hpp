@@ -42,7 +42,7 @@ struct file_impl
         return false;
     }
 
-    static bool seek(handle&, int, stream_position)
+    static bool seek(handle&, int64_t, stream_position)
     {
         unsupported("seek");
         return false;
@@ -147,7 +147,7 @@ static bool create_hard_link_impl(const path&, const path&)
 
 // https://en.cppreference.com/w/cpp/filesystem/copy_file
 
-static bool copy_file_impl(const path&, const path&, bool)
+static bool copy_file_impl(const path&, const path&, bool, copy_progress_callback, void*)
 {
     unsupported("copy_file");
     return false;
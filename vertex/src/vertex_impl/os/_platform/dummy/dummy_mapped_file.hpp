@@ -0,0 +1,100 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "vertex/os/file.hpp"
+#include "vertex/os/mapped_file.hpp"
+#include "vertex/system/assert.hpp"
+
+namespace vx {
+namespace os {
+namespace _priv {
+
+// Without memory mapping the window is read into a heap buffer. Read-write
+// views keep the file open so the buffer can be written back on flush and
+// when the view is unmapped.
+struct mapped_file_impl
+{
+    struct mapping
+    {
+        file f;
+        size_t offset = 0;
+        std::vector<uint8_t> bytes;
+    };
+
+    static bool map(mapped_file& m, file& f, mapped_file::access mode, size_t offset, size_t length)
+    {
+        VX_ASSERT_MESSAGE(m.m_base == nullptr, "file already mapped");
+
+        std::unique_ptr<mapping> view = std::make_unique<mapping>();
+        view->offset = offset;
+        view->bytes.resize(length);
+
+        if (!seek_to(f, offset) || f.read(view->bytes.data(), length) != length)
+        {
+            err::set(err::file_read_failed, "failed to read mapped window");
+            return false;
+        }
+
+        if (mode == mapped_file::access::read_write)
+        {
+            view->f = std::move(f);
+        }
+
+        m.m_data = view->bytes.data();
+        m.m_mapped_size = length;
+        m.m_base = view.release();
+        return true;
+    }
+
+    static void unmap(mapped_file& m)
+    {
+        if (m.m_base)
+        {
+            write_back(m);
+            delete static_cast<mapping*>(m.m_base);
+        }
+    }
+
+    static bool advise(mapped_file&, mapped_file::advice)
+    {
+        return true;
+    }
+
+    static bool flush(mapped_file& m)
+    {
+        return !m.m_base || (write_back(m) && static_cast<mapping*>(m.m_base)->f.flush());
+    }
+
+private:
+
+    // offsets that seek cannot represent are rejected rather than wrapped
+    static bool seek_to(file& f, size_t offset)
+    {
+        if (offset > static_cast<size_t>(std::numeric_limits<int64_t>::max()))
+        {
+            err::set(err::out_of_range, "mapped window offset too large");
+            return false;
+        }
+
+        return f.seek(static_cast<int64_t>(offset));
+    }
+
+    static bool write_back(mapped_file& m)
+    {
+        mapping* view = static_cast<mapping*>(m.m_base);
+        if (!view->f.is_open())
+        {
+            return true;
+        }
+
+        return seek_to(view->f, view->offset)
+            && (view->f.write(view->bytes.data(), view->bytes.size()) == view->bytes.size());
+    }
+};
+
+} // namespace _priv
+} // namespace os
+} // namespace vx
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "vertex/config/os.hpp"
+
+#if defined(VX_OS_UNIX) && defined(HAVE_MMAP)
+#   include "vertex_impl/os/_platform/unix/unix_mapped_file.hpp"
+#else
+#   include "vertex_impl/os/_platform/dummy/dummy_mapped_file.hpp"
+#endif
@@ -114,10 +114,17 @@ struct file_impl
         return true;
     }
 
-    static bool seek(handle& h, int off, stream_position from)
+    static bool seek(handle& h, int64_t off, stream_position from)
     {
         assert_is_open(h);
 
+        // off_t is 32 bits on some 32 bit targets
+        if (static_cast<int64_t>(static_cast<off_t>(off)) != off)
+        {
+            err::set(err::out_of_range, "seek offset too large");
+            return false;
+        }
+
         int whence = 0;
         switch (from)
         {
@@ -138,7 +145,7 @@ struct file_impl
             }
         }
 
-        if (::lseek(h.get(), off, whence) == static_cast<off_t>(-1))
+        if (::lseek(h.get(), static_cast<off_t>(off), whence) == static_cast<off_t>(-1))
         {
             unix_::error_message("lseek()");
             return false;
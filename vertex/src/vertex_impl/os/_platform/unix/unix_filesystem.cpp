@@ -1,10 +1,19 @@
+#include <algorithm>
+#include <cerrno>
+#include <vector>
+
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <limits.h>  // For PATH_MAX
 #include <unistd.h>  // For readlink()
 #include <sys/statvfs.h> // space
 
+#if defined(HAVE_SENDFILE)
+#   include <sys/sendfile.h>
+#endif
+
 #include "vertex_impl/os/_platform/unix/unix_filesystem.hpp"
+#include "vertex_impl/os/_platform/unix/unix_file.hpp"
 #include "vertex/os/file.hpp"
 #include "vertex/system/error.hpp"
 
@@ -497,7 +506,229 @@ bool create_hard_link_impl(const path& target, const path& link)
 // Copy
 ///////////////////////////////////////////////////////////////////////////////
 
-bool copy_file_impl(const path& from, const path& to, bool overwrite_existing)
+// Files are copied one data segment at a time. Each segment is handed to the
+// fastest mechanism available: copy_file_range copies (or clones) inside the
+// kernel, sendfile at least avoids the copies through user space, and a large
+// buffer is the last resort. Holes between segments are skipped and left as
+// holes in the destination.
+
+enum : size_t
+{
+    copy_buffer_size = 1024 * 1024,
+
+    // with a progress callback, report at least this often
+    copy_progress_chunk_size = 16 * 1024 * 1024
+};
+
+class file_copier
+{
+public:
+
+    file_copier(int in, int out, size_t total, copy_progress_callback progress, void* user_data)
+        : m_in(in), m_out(out), m_total(total), m_progress(progress), m_user_data(user_data)
+    {}
+
+    // copies [offset, offset + count) to the same range in the destination
+    bool copy_segment(size_t offset, size_t count)
+    {
+        while (count != 0)
+        {
+            const size_t chunk = m_progress ? std::min(count, static_cast<size_t>(copy_progress_chunk_size)) : count;
+
+            const size_t copied = copy_chunk(offset, chunk);
+            if (copied == 0)
+            {
+                return false;
+            }
+
+            offset += copied;
+            count -= copied;
+
+            if (!report(offset))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // used when the size is unknown up front, e.g. files under /proc
+    bool copy_to_end()
+    {
+        size_t offset = 0;
+
+        while (true)
+        {
+            const ssize_t n = ::pread(m_in, buffer(), copy_buffer_size, static_cast<off_t>(offset));
+            if (n < 0)
+            {
+                unix_::error_message("pread()");
+                return false;
+            }
+
+            if (n == 0)
+            {
+                return true;
+            }
+
+            if (!write_all(buffer(), static_cast<size_t>(n), offset))
+            {
+                return false;
+            }
+
+            offset += static_cast<size_t>(n);
+        }
+    }
+
+    bool report(size_t copied)
+    {
+        if (m_progress && !m_progress(copied, m_total, m_user_data))
+        {
+            err::set(err::file_operation_failed, "copy_file(): cancelled");
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+
+    static bool is_unsupported(int e)
+    {
+        // the mechanism can't be used for this pair of files, try the next one
+        return e == ENOSYS || e == EXDEV || e == EINVAL || e == EOPNOTSUPP || e == EPERM;
+    }
+
+    // returns the number of bytes copied, 0 on failure
+    size_t copy_chunk(size_t offset, size_t count)
+    {
+#if defined(HAVE_COPY_FILE_RANGE)
+
+        if (m_use_copy_file_range)
+        {
+            off_t in_offset = static_cast<off_t>(offset);
+            off_t out_offset = static_cast<off_t>(offset);
+
+            const ssize_t n = ::copy_file_range(m_in, &in_offset, m_out, &out_offset, count, 0);
+            if (n > 0)
+            {
+                return static_cast<size_t>(n);
+            }
+
+            if (n == 0 || !is_unsupported(errno))
+            {
+                return fail("copy_file_range()", n);
+            }
+
+            m_use_copy_file_range = false;
+        }
+
+#endif // HAVE_COPY_FILE_RANGE
+
+#if defined(HAVE_SENDFILE)
+
+        if (m_use_sendfile)
+        {
+            // sendfile writes at the current position of the destination
+            if (::lseek(m_out, static_cast<off_t>(offset), SEEK_SET) == static_cast<off_t>(-1))
+            {
+                unix_::error_message("lseek()");
+                return 0;
+            }
+
+            off_t in_offset = static_cast<off_t>(offset);
+
+            const ssize_t n = ::sendfile(m_out, m_in, &in_offset, count);
+            if (n > 0)
+            {
+                return static_cast<size_t>(n);
+            }
+
+            if (n == 0 || !is_unsupported(errno))
+            {
+                return fail("sendfile()", n);
+            }
+
+            m_use_sendfile = false;
+        }
+
+#endif // HAVE_SENDFILE
+
+        const ssize_t n = ::pread(m_in, buffer(), std::min(count, static_cast<size_t>(copy_buffer_size)), static_cast<off_t>(offset));
+        if (n <= 0)
+        {
+            return fail("pread()", n);
+        }
+
+        return write_all(buffer(), static_cast<size_t>(n), offset) ? static_cast<size_t>(n) : 0;
+    }
+
+    static size_t fail(const char* api, ssize_t n)
+    {
+        if (n == 0)
+        {
+            // the source got shorter while we were copying it
+            err::set(err::file_read_failed, "copy_file(): unexpected end of file");
+        }
+        else
+        {
+            unix_::error_message(api);
+        }
+
+        return 0;
+    }
+
+    bool write_all(const uint8_t* data, size_t count, size_t offset)
+    {
+        while (count != 0)
+        {
+            const ssize_t n = ::pwrite(m_out, data, count, static_cast<off_t>(offset));
+            if (n <= 0)
+            {
+                unix_::error_message("pwrite()");
+                return false;
+            }
+
+            data += n;
+            count -= static_cast<size_t>(n);
+            offset += static_cast<size_t>(n);
+        }
+
+        return true;
+    }
+
+    uint8_t* buffer()
+    {
+        if (m_buffer.empty())
+        {
+            m_buffer.resize(copy_buffer_size);
+        }
+
+        return m_buffer.data();
+    }
+
+private:
+
+    int m_in;
+    int m_out;
+    size_t m_total;
+
+    copy_progress_callback m_progress;
+    void* m_user_data;
+
+    bool m_use_copy_file_range = true;
+    bool m_use_sendfile = true;
+    std::vector<uint8_t> m_buffer;
+};
+
+bool copy_file_impl(
+    const path& from,
+    const path& to,
+    bool overwrite_existing,
+    copy_progress_callback progress,
+    void* user_data
+)
 {
     // Check if the destination file exists
     if (!overwrite_existing && exists(to))
@@ -518,27 +749,92 @@ bool copy_file_impl(const path& from, const path& to, bool overwrite_existing)
         return false;
     }
 
-    // Copy the file content in chunks
-    constexpr size_t size = 4096;
-    char data[size];
-    size_t bytes_read, bytes_written;
+    const int in = os::_priv::file_impl::get_native_handle(from_file);
+    const int out = os::_priv::file_impl::get_native_handle(to_file);
 
-    for (;;)
+    struct stat st {};
+    if (::fstat(in, &st) != 0)
     {
-        bytes_read = from_file.read(data, size);
-        if (bytes_read == 0)
-        {
-            break;
-        }
+        unix_::error_message("fstat()");
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    file_copier copier(in, out, size, progress, user_data);
+
+    if (size == 0)
+    {
+        return copier.copy_to_end();
+    }
+
+    // fewer allocated blocks than the size needs means the file has holes
+    const bool sparse = (static_cast<size_t>(st.st_blocks) * 512 < size);
+
+#if defined(HAVE_FALLOCATE)
+
+    // reserve the space up front so the destination is laid out in one go,
+    // sparse files would lose their holes so they are only truncated below
+    if (!sparse)
+    {
+        // not every filesystem supports it, it is only an optimization
+        ::fallocate(out, 0, 0, st.st_size);
+    }
+
+#endif // HAVE_FALLOCATE
 
-        bytes_written = to_file.write(data, bytes_read);
-        if (bytes_written != bytes_read)
+    size_t offset = 0;
+
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+
+    if (sparse)
+    {
+        while (offset < size)
         {
-            return false;
+            const off_t data = ::lseek(in, static_cast<off_t>(offset), SEEK_DATA);
+            if (data == static_cast<off_t>(-1))
+            {
+                if (errno == ENXIO)
+                {
+                    // only a hole is left
+                    offset = size;
+                    break;
+                }
+
+                // not supported by the filesystem, copy the rest as data
+                break;
+            }
+
+            off_t hole = ::lseek(in, data, SEEK_HOLE);
+            if (hole == static_cast<off_t>(-1))
+            {
+                hole = static_cast<off_t>(size);
+            }
+
+            const size_t end = std::min(static_cast<size_t>(hole), size);
+            if (!copier.copy_segment(static_cast<size_t>(data), end - static_cast<size_t>(data)))
+            {
+                return false;
+            }
+
+            offset = end;
         }
     }
 
-    return true;
+#endif // SEEK_DATA && SEEK_HOLE
+
+    if (offset < size && !copier.copy_segment(offset, size - offset))
+    {
+        return false;
+    }
+
+    // trailing holes are not written, extend the destination over them
+    if (::ftruncate(out, st.st_size) != 0)
+    {
+        unix_::error_message("ftruncate()");
+        return false;
+    }
+
+    return copier.report(size);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -72,7 +72,13 @@ bool create_hard_link_impl(const path& target, const path& link);
 
 // https://en.cppreference.com/w/cpp/filesystem/copy_file
 
-bool copy_file_impl(const path& from, const path& to, bool overwrite_existing);
+bool copy_file_impl(
+    const path& from,
+    const path& to,
+    bool overwrite_existing,
+    copy_progress_callback progress,
+    void* user_data
+);
 
 ///////////////////////////////////////////////////////////////////////////////
 // Rename
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <ctime>
+
+#include "vertex/config/os.hpp"
+#include "vertex/os/atomic.hpp"
+
+#if defined(VX_OS_LINUX)
+#   include <climits>
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#else
+#   include <pthread.h>
+#endif
+
+namespace vx {
+namespace os {
+
+struct futex_impl
+{
+    static_assert(sizeof(atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32 bit integer");
+
+#if defined(VX_OS_LINUX)
+
+    //=============================================================================
+    // linux
+    //=============================================================================
+
+    // Blocks while word equals expected. May return early without a wake, callers
+    // check their condition again. Returns false if the timeout expired.
+    static bool wait(atomic<uint32_t>& word, uint32_t expected, int64_t timeout_ns) noexcept
+    {
+        timespec ts{};
+        timespec* timeout = nullptr;
+
+        if (timeout_ns >= 0)
+        {
+            ts.tv_sec = static_cast<time_t>(timeout_ns / 1000000000);
+            ts.tv_nsec = static_cast<long>(timeout_ns % 1000000000);
+            timeout = &ts;
+        }
+
+        const long result = ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+        return !(result == -1 && errno == ETIMEDOUT);
+    }
+
+    static void wake_one(atomic<uint32_t>& word) noexcept
+    {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    }
+
+    static void wake_all(atomic<uint32_t>& word) noexcept
+    {
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+#else
+
+    //=============================================================================
+    // pthread
+    //=============================================================================
+
+    // Without futex, waiters sleep on one of a fixed set of condition variables
+    // picked by the address of the word. Words that share a bucket wake each
+    // other spuriously, which callers already tolerate.
+
+    enum : size_t
+    {
+        bucket_count = 64
+    };
+
+    struct bucket
+    {
+        pthread_mutex_t mutex;
+        pthread_cond_t cond;
+    };
+
+    struct bucket_table
+    {
+        bucket buckets[bucket_count];
+
+        bucket_table() noexcept
+        {
+            for (bucket& b : buckets)
+            {
+                pthread_mutex_init(&b.mutex, nullptr);
+                pthread_cond_init(&b.cond, nullptr);
+            }
+        }
+
+        // never destroyed, threads may still be waiting during static destruction
+    };
+
+    static bucket& get_bucket(const void* address) noexcept
+    {
+        static bucket_table* table = new bucket_table;
+
+        uintptr_t h = reinterpret_cast<uintptr_t>(address) >> 2;
+        h ^= h >> 7;
+        return table->buckets[h % bucket_count];
+    }
+
+    static bool wait(atomic<uint32_t>& word, uint32_t expected, int64_t timeout_ns) noexcept
+    {
+        bucket& b = get_bucket(&word);
+        int result = 0;
+
+        pthread_mutex_lock(&b.mutex);
+
+        // checked under the bucket lock, a waker changes the word before taking
+        // the lock so the wake cannot be missed
+        if (word.load(std::memory_order_seq_cst) == expected)
+        {
+            if (timeout_ns < 0)
+            {
+                result = pthread_cond_wait(&b.cond, &b.mutex);
+            }
+            else
+            {
+                timespec ts{};
+                clock_gettime(CLOCK_REALTIME, &ts);
+
+                const int64_t ns = static_cast<int64_t>(ts.tv_nsec) + timeout_ns % 1000000000;
+                ts.tv_sec += static_cast<time_t>(timeout_ns / 1000000000 + ns / 1000000000);
+                ts.tv_nsec = static_cast<long>(ns % 1000000000);
+
+                result = pthread_cond_timedwait(&b.cond, &b.mutex, &ts);
+            }
+        }
+
+        pthread_mutex_unlock(&b.mutex);
+        return result != ETIMEDOUT;
+    }
+
+    static void wake_one(atomic<uint32_t>& word) noexcept
+    {
+        // the bucket is shared, so waking one waiter could pick one that is
+        // waiting on a different word
+        wake_all(word);
+    }
+
+    static void wake_all(atomic<uint32_t>& word) noexcept
+    {
+        bucket& b = get_bucket(&word);
+
+        pthread_mutex_lock(&b.mutex);
+        pthread_cond_broadcast(&b.cond);
+        pthread_mutex_unlock(&b.mutex);
+    }
+
+#endif
+};
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "vertex/os/mapped_file.hpp"
+#include "vertex/system/assert.hpp"
+#include "vertex_impl/os/_platform/unix/unix_file.hpp"
+#include "vertex_impl/os/_platform/unix/unix_tools.hpp"
+
+namespace vx {
+namespace os {
+namespace _priv {
+
+struct mapped_file_impl
+{
+    static size_t page_size()
+    {
+        static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    static bool map(mapped_file& m, const file& f, mapped_file::access mode, size_t offset, size_t length)
+    {
+        VX_ASSERT_MESSAGE(m.m_base == nullptr, "file already mapped");
+
+        // mmap offsets must be page aligned, map from the page containing the
+        // window and point the view into it
+        const size_t aligned_offset = offset - (offset % page_size());
+        const size_t lead = offset - aligned_offset;
+
+        int prot = PROT_READ;
+        int flags = MAP_SHARED;
+
+        switch (mode)
+        {
+            case mapped_file::access::read_write:
+            {
+                prot |= PROT_WRITE;
+                break;
+            }
+            case mapped_file::access::copy_on_write:
+            {
+                prot |= PROT_WRITE;
+                flags = MAP_PRIVATE;
+                break;
+            }
+            default:
+            {
+                break;
+            }
+        }
+
+        void* base = ::mmap(nullptr, lead + length, prot, flags, file_impl::get_native_handle(f), static_cast<off_t>(aligned_offset));
+        if (base == MAP_FAILED)
+        {
+            unix_::error_message("mmap()");
+            return false;
+        }
+
+        m.m_base = base;
+        m.m_mapped_size = lead + length;
+        m.m_data = static_cast<uint8_t*>(base) + lead;
+        return true;
+    }
+
+    static void unmap(mapped_file& m)
+    {
+        if (m.m_base)
+        {
+            ::munmap(m.m_base, m.m_mapped_size);
+        }
+    }
+
+    static bool advise(mapped_file& m, mapped_file::advice hint)
+    {
+        if (!m.m_base)
+        {
+            return true;
+        }
+
+#if defined(HAVE_MADVISE)
+
+        int advice = MADV_NORMAL;
+
+        switch (hint)
+        {
+            case mapped_file::advice::sequential:   advice = MADV_SEQUENTIAL;   break;
+            case mapped_file::advice::random:       advice = MADV_RANDOM;       break;
+            case mapped_file::advice::will_need:    advice = MADV_WILLNEED;     break;
+            default:                                                            break;
+        }
+
+        if (::madvise(m.m_base, m.m_mapped_size, advice) != 0)
+        {
+            unix_::error_message("madvise()");
+            return false;
+        }
+
+#else
+
+        VX_UNUSED(hint);
+
+#endif // HAVE_MADVISE
+
+        return true;
+    }
+
+    static bool flush(mapped_file& m)
+    {
+        if (m.m_base && ::msync(m.m_base, m.m_mapped_size, MS_SYNC) != 0)
+        {
+            unix_::error_message("msync()");
+            return false;
+        }
+
+        return true;
+    }
+};
+
+} // namespace _priv
+} // namespace os
+} // namespace vx
@@ -46,7 +46,7 @@ static bool get_sysctl_string(const char* name, std::string& value)
 static std::string get_os_release_info_value(const char* key)
 {
     os::file f;
-    if (!f.open("/etc/os-release", os::file::mode::read))
+    if (!f.set_buffer_size(os::file::default_buffer_size) || !f.open("/etc/os-release", os::file::mode::read))
     {
         return {};
     }
@@ -174,7 +174,7 @@ std::string get_processor_name_impl()
             do
             {
                 os::file f;
-                if (!f.open("/proc/cpuinfo", os::file::mode::read))
+                if (!f.set_buffer_size(os::file::default_buffer_size) || !f.open("/proc/cpuinfo", os::file::mode::read))
                 {
                     break;
                 }
@@ -98,7 +98,7 @@ struct file_impl
         return static_cast<size_t>(size.QuadPart);
     }
 
-    static bool seek(handle& h, int off, stream_position from)
+    static bool seek(handle& h, int64_t off, stream_position from)
     {
         assert_is_open(h);
 
@@ -138,7 +138,7 @@ struct file_impl
     {
         assert_is_open(h);
 
-        if (!seek(h, static_cast<int>(size), stream_position::begin))
+        if (!seek(h, static_cast<int64_t>(size), stream_position::begin))
         {
             return false;
         }
@@ -969,11 +969,50 @@ bool create_hard_link_impl(const path& target, const path& link)
 
 // https://en.cppreference.com/w/cpp/filesystem/copy_file
 
-bool copy_file_impl(const path& from, const path& to, bool overwrite_existing)
+struct copy_progress_context
 {
-    if (!::CopyFileW(from.c_str(), to.c_str(), !overwrite_existing))
+    copy_progress_callback progress;
+    void* user_data;
+};
+
+static DWORD CALLBACK copy_progress_routine(
+    LARGE_INTEGER total_file_size,
+    LARGE_INTEGER total_bytes_transferred,
+    LARGE_INTEGER, LARGE_INTEGER, DWORD, DWORD, HANDLE, HANDLE,
+    LPVOID data
+)
+{
+    const copy_progress_context* context = static_cast<const copy_progress_context*>(data);
+
+    const bool keep_going = context->progress(
+        static_cast<size_t>(total_bytes_transferred.QuadPart),
+        static_cast<size_t>(total_file_size.QuadPart),
+        context->user_data
+    );
+
+    return keep_going ? PROGRESS_CONTINUE : PROGRESS_CANCEL;
+}
+
+bool copy_file_impl(
+    const path& from,
+    const path& to,
+    bool overwrite_existing,
+    copy_progress_callback progress,
+    void* user_data
+)
+{
+    // CopyFileEx already copies in the kernel and keeps sparse files sparse
+    copy_progress_context context{ progress, user_data };
+
+    if (!::CopyFileExW(
+        from.c_str(),
+        to.c_str(),
+        progress ? copy_progress_routine : NULL,
+        progress ? &context : NULL,
+        NULL,
+        overwrite_existing ? 0 : COPY_FILE_FAIL_IF_EXISTS))
     {
-        err::set_last_os_error("CopyFileW");
+        err::set_last_os_error("CopyFileExW");
         return false;
     }
 
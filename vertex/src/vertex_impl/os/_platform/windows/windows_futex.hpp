@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+#include "vertex/os/atomic.hpp"
+#include "vertex_impl/os/_platform/windows/windows_header.hpp"
+
+namespace vx {
+namespace os {
+
+// WaitOnAddress would need Synchronization.lib, so waiters sleep on one of a
+// fixed set of condition variables picked by the address of the word instead.
+// Words that share a bucket wake each other spuriously, which callers already
+// tolerate.
+struct futex_impl
+{
+    static_assert(sizeof(atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32 bit integer");
+
+    enum : size_t
+    {
+        bucket_count = 64
+    };
+
+    struct bucket
+    {
+        SRWLOCK lock = SRWLOCK_INIT;
+        CONDITION_VARIABLE cond = CONDITION_VARIABLE_INIT;
+    };
+
+    static bucket& get_bucket(const void* address) noexcept
+    {
+        static bucket buckets[bucket_count];
+
+        uintptr_t h = reinterpret_cast<uintptr_t>(address) >> 2;
+        h ^= h >> 7;
+        return buckets[h % bucket_count];
+    }
+
+    // Blocks while word equals expected. May return early without a wake, callers
+    // check their condition again. Returns false if the timeout expired.
+    static bool wait(atomic<uint32_t>& word, uint32_t expected, int64_t timeout_ns) noexcept
+    {
+        bucket& b = get_bucket(&word);
+        bool woken = true;
+
+        ::AcquireSRWLockExclusive(&b.lock);
+
+        // checked under the bucket lock, a waker changes the word before taking
+        // the lock so the wake cannot be missed
+        if (word.load(std::memory_order_seq_cst) == expected)
+        {
+            DWORD ms = INFINITE;
+            if (timeout_ns >= 0)
+            {
+                const int64_t rounded = (timeout_ns + 999999) / 1000000;
+                ms = (rounded < static_cast<int64_t>(INFINITE)) ? static_cast<DWORD>(rounded) : INFINITE - 1;
+            }
+
+            if (!::SleepConditionVariableSRW(&b.cond, &b.lock, ms, 0))
+            {
+                woken = (::GetLastError() != ERROR_TIMEOUT);
+            }
+        }
+
+        ::ReleaseSRWLockExclusive(&b.lock);
+        return woken;
+    }
+
+    static void wake_one(atomic<uint32_t>& word) noexcept
+    {
+        // the bucket is shared, so waking one waiter could pick one that is
+        // waiting on a different word
+        wake_all(word);
+    }
+
+    static void wake_all(atomic<uint32_t>& word) noexcept
+    {
+        bucket& b = get_bucket(&word);
+
+        ::AcquireSRWLockExclusive(&b.lock);
+        ::WakeAllConditionVariable(&b.cond);
+        ::ReleaseSRWLockExclusive(&b.lock);
+    }
+};
+
+} // namespace os
+} // namespace vx
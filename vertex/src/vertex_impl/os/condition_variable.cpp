@@ -0,0 +1,46 @@
+#include "vertex/os/condition_variable.hpp"
+#include "vertex_impl/os/futex.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Condition Variable
+//=============================================================================
+
+bool condition_variable::wait_impl(uint32_t seq, int64_t timeout_ns) noexcept
+{
+    const auto notified = [this, seq]() { return m_seq.load(std::memory_order_acquire) != seq; };
+
+    if (timeout_ns != 0 && spin_policy::spin_until(notified))
+    {
+        return true;
+    }
+
+    const futex_deadline deadline(timeout_ns);
+
+    while (!notified())
+    {
+        if (!futex_wait_until(m_seq, seq, deadline))
+        {
+            return notified();
+        }
+    }
+
+    return true;
+}
+
+void condition_variable::wake_impl(bool all) noexcept
+{
+    if (all)
+    {
+        futex_impl::wake_all(m_seq);
+    }
+    else
+    {
+        futex_impl::wake_one(m_seq);
+    }
+}
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,45 @@
+#include "vertex/os/event.hpp"
+#include "vertex_impl/os/futex.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Event
+//=============================================================================
+
+bool event::wait_impl(int64_t timeout_ns) noexcept
+{
+    if (timeout_ns == 0)
+    {
+        return is_set();
+    }
+
+    if (spin_policy::spin_until([this]() { return is_set(); }))
+    {
+        return true;
+    }
+
+    const futex_deadline deadline(timeout_ns);
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    while (m_state.load(std::memory_order_seq_cst) == 0)
+    {
+        if (!futex_wait_until(m_state, 0, deadline))
+        {
+            break;
+        }
+    }
+
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return is_set();
+}
+
+void event::wake_impl() noexcept
+{
+    futex_impl::wake_all(m_state);
+}
+
+} // namespace os
+} // namespace vx
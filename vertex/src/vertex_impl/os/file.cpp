@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "vertex_impl/os/_platform/platform_file.hpp"
+#include "vertex/std/_simd/simd_algorithms.hpp"
 
 namespace vx {
 namespace os {
@@ -10,8 +13,16 @@ file::~file() { close(); }
 file::file(file&& other) noexcept
     : m_mode(other.m_mode)
     , m_handle(std::move(other.m_handle))
+    , m_buffer_state(other.m_buffer_state)
+    , m_buffer_size(other.m_buffer_size)
+    , m_buffer_pos(other.m_buffer_pos)
+    , m_buffer_end(other.m_buffer_end)
+    , m_buffer(std::move(other.m_buffer))
 {
     other.m_mode = mode::none;
+    other.m_buffer_state = buffer_state::none;
+    other.m_buffer_pos = 0;
+    other.m_buffer_end = 0;
 }
 
 file& file::operator=(file&& other) noexcept
@@ -22,8 +33,16 @@ file& file::operator=(file&& other) noexcept
 
         m_mode = other.m_mode;
         m_handle = std::move(other.m_handle);
+        m_buffer_state = other.m_buffer_state;
+        m_buffer_size = other.m_buffer_size;
+        m_buffer_pos = other.m_buffer_pos;
+        m_buffer_end = other.m_buffer_end;
+        m_buffer = std::move(other.m_buffer);
 
         other.m_mode = mode::none;
+        other.m_buffer_state = buffer_state::none;
+        other.m_buffer_pos = 0;
+        other.m_buffer_end = 0;
     }
 
     return *this;
@@ -33,6 +52,11 @@ void file::swap(file& other) noexcept
 {
     std::swap(m_mode, other.m_mode);
     std::swap(m_handle, other.m_handle);
+    std::swap(m_buffer_state, other.m_buffer_state);
+    std::swap(m_buffer_size, other.m_buffer_size);
+    std::swap(m_buffer_pos, other.m_buffer_pos);
+    std::swap(m_buffer_end, other.m_buffer_end);
+    std::swap(m_buffer, other.m_buffer);
 }
 
 bool file::exists(const path& p)
@@ -76,28 +100,98 @@ bool file::is_open() const
 
 void file::close()
 {
+    if (is_open())
+    {
+        // nowhere to report a failure from here, callers that care flush first
+        flush_buffer();
+    }
+
     m_handle.close();
     m_mode = mode::none;
+
+    m_buffer_state = buffer_state::none;
+    m_buffer_pos = 0;
+    m_buffer_end = 0;
+    std::vector<uint8_t>().swap(m_buffer);
 }
 
 size_t file::size() const
 {
-    return is_open() ? _priv::file_impl::size(m_handle) : 0;
+    if (!is_open())
+    {
+        return 0;
+    }
+
+    const size_t size = _priv::file_impl::size(m_handle);
+
+    if (m_buffer_state == buffer_state::write)
+    {
+        // pending writes may extend the file
+        const size_t end = tell();
+        if (end != invalid_position && end > size)
+        {
+            return end;
+        }
+    }
+
+    return size;
 }
 
 bool file::resize(size_t size)
 {
-    return is_open() ? _priv::file_impl::resize(m_handle, size) : false;
+    return is_open() ? (sync_buffer() && _priv::file_impl::resize(m_handle, size)) : false;
 }
 
-bool file::seek(int off, stream_position from)
+bool file::seek(int64_t off, stream_position from)
 {
-    return is_open() ? _priv::file_impl::seek(m_handle, off, from) : false;
+    if (!is_open())
+    {
+        return false;
+    }
+
+    if (m_buffer_state == buffer_state::read && from != stream_position::current)
+    {
+        // absolute seeks don't need the os position moved back first
+        m_buffer_state = buffer_state::none;
+        m_buffer_pos = 0;
+        m_buffer_end = 0;
+    }
+    else if (!sync_buffer())
+    {
+        return false;
+    }
+
+    return _priv::file_impl::seek(m_handle, off, from);
 }
 
 size_t file::tell() const
 {
-    return is_open() ? _priv::file_impl::tell(m_handle) : invalid_position;
+    if (!is_open())
+    {
+        return invalid_position;
+    }
+
+    switch (m_buffer_state)
+    {
+        case buffer_state::read:
+        {
+            const size_t pos = _priv::file_impl::tell(m_handle);
+            return (pos == invalid_position) ? pos : pos - (m_buffer_end - m_buffer_pos);
+        }
+        case buffer_state::write:
+        {
+            // appended data always lands at the end of the file
+            const size_t pos = (m_mode == mode::append)
+                ? _priv::file_impl::size(m_handle)
+                : _priv::file_impl::tell(m_handle);
+
+            return (pos == invalid_position) ? pos : pos + m_buffer_end;
+        }
+        default:
+        {
+            return _priv::file_impl::tell(m_handle);
+        }
+    }
 }
 
 bool file::eof() const
@@ -107,14 +201,119 @@ bool file::eof() const
         return false;
     }
 
-    return _priv::file_impl::tell(m_handle) >= _priv::file_impl::size(m_handle);
+    if (m_buffer_state == buffer_state::read && m_buffer_pos < m_buffer_end)
+    {
+        return false;
+    }
+
+    return tell() >= size();
 }
 
 bool file::flush()
 {
-    return is_open() ? _priv::file_impl::flush(m_handle) : false;
+    return is_open() ? (flush_buffer() && _priv::file_impl::flush(m_handle)) : false;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// buffering
+///////////////////////////////////////////////////////////////////////////////
+
+bool file::set_buffer_size(size_t size)
+{
+    if (!sync_buffer())
+    {
+        return false;
+    }
+
+    m_buffer_size = size;
+    std::vector<uint8_t>().swap(m_buffer);
+    return true;
+}
+
+static size_t write_all(handle& h, const uint8_t* data, size_t size)
+{
+    size_t written = 0;
+
+    while (written < size)
+    {
+        const size_t count = _priv::file_impl::write(h, data + written, size - written);
+        if (count == 0)
+        {
+            break;
+        }
+
+        written += count;
+    }
+
+    return written;
+}
+
+// Writes out any pending data, afterwards the buffer is empty. If the write
+// fails the pending data is dropped and the error is left set.
+bool file::flush_buffer()
+{
+    if (m_buffer_state != buffer_state::write)
+    {
+        return true;
+    }
+
+    const size_t count = m_buffer_end;
+
+    m_buffer_state = buffer_state::none;
+    m_buffer_pos = 0;
+    m_buffer_end = 0;
+
+    return write_all(m_handle, m_buffer.data(), count) == count;
+}
+
+// Brings the os file position in line with the logical position so the handle
+// can be used directly. Pending writes are flushed and data read ahead is
+// given back by seeking over it.
+bool file::sync_buffer()
+{
+    switch (m_buffer_state)
+    {
+        case buffer_state::read:
+        {
+            const size_t unread = m_buffer_end - m_buffer_pos;
+
+            m_buffer_state = buffer_state::none;
+            m_buffer_pos = 0;
+            m_buffer_end = 0;
+
+            return (unread == 0) || _priv::file_impl::seek(m_handle, -static_cast<int64_t>(unread), stream_position::current);
+        }
+        case buffer_state::write:
+        {
+            return flush_buffer();
+        }
+        default:
+        {
+            return true;
+        }
+    }
+}
+
+// Replaces the buffer contents with the next block of the file, the caller
+// must have consumed or synced whatever was there before.
+size_t file::fill_buffer()
+{
+    if (m_buffer.size() < m_buffer_size)
+    {
+        m_buffer.resize(m_buffer_size);
+    }
+
+    m_buffer_state = buffer_state::read;
+    m_buffer_pos = 0;
+    m_buffer_end = _priv::file_impl::read(m_handle, m_buffer.data(), m_buffer.size());
+
+    return m_buffer_end;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// read and write
+///////////////////////////////////////////////////////////////////////////////
+
 static bool read_check(const bool can_read)
 {
     if (!can_read)
@@ -135,59 +334,277 @@ static bool write_check(const bool can_write)
 
 size_t file::read(uint8_t* data, size_t size)
 {
-    return !read_check(can_read()) ? 0 : _priv::file_impl::read(m_handle, data, size);
+    if (!read_check(can_read()))
+    {
+        return 0;
+    }
+
+    if (!is_buffered())
+    {
+        return _priv::file_impl::read(m_handle, data, size);
+    }
+
+    if (m_buffer_state == buffer_state::write && !flush_buffer())
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+
+    while (true)
+    {
+        if (m_buffer_state == buffer_state::read)
+        {
+            const size_t available = std::min(m_buffer_end - m_buffer_pos, size - count);
+            std::memcpy(data + count, m_buffer.data() + m_buffer_pos, available);
+
+            m_buffer_pos += available;
+            count += available;
+        }
+
+        if (count == size)
+        {
+            break;
+        }
+
+        // the buffer is empty here, large reads skip the copy through it
+        if (size - count >= m_buffer_size)
+        {
+            m_buffer_state = buffer_state::none;
+            count += _priv::file_impl::read(m_handle, data + count, size - count);
+            break;
+        }
+
+        if (fill_buffer() == 0)
+        {
+            break;
+        }
+    }
+
+    return count;
 }
 
 size_t file::write(const uint8_t* data, size_t size)
 {
-    return !write_check(can_write()) ? 0 : _priv::file_impl::write(m_handle, data, size);
+    if (!write_check(can_write()))
+    {
+        return 0;
+    }
+
+    if (!is_buffered())
+    {
+        return _priv::file_impl::write(m_handle, data, size);
+    }
+
+    if (m_buffer_state == buffer_state::read && !sync_buffer())
+    {
+        return 0;
+    }
+
+    if (m_buffer_state == buffer_state::write && m_buffer_end + size > m_buffer_size && !flush_buffer())
+    {
+        return 0;
+    }
+
+    // anything that would fill the buffer on its own goes straight out
+    if (size >= m_buffer_size)
+    {
+        return write_all(m_handle, data, size);
+    }
+
+    if (m_buffer.size() < m_buffer_size)
+    {
+        m_buffer.resize(m_buffer_size);
+    }
+
+    if (m_buffer_state != buffer_state::write)
+    {
+        m_buffer_state = buffer_state::write;
+        m_buffer_pos = 0;
+        m_buffer_end = 0;
+    }
+
+    std::memcpy(m_buffer.data() + m_buffer_end, data, size);
+    m_buffer_end += size;
+
+    return size;
 }
 
-bool file::read_line(std::string& line)
+///////////////////////////////////////////////////////////////////////////////
+// read and write line
+///////////////////////////////////////////////////////////////////////////////
+
+static const uint8_t* find_line_end(const uint8_t* first, const uint8_t* last)
+{
+    if (first == last)
+    {
+        return last;
+    }
+
+#if VX_STD_USE_SIMD_ALGORITHMS
+
+    return static_cast<const uint8_t*>(_simd::find_trivial_1(first, last, static_cast<uint8_t>('\n')));
+
+#else
+
+    const void* p = std::memchr(first, '\n', static_cast<size_t>(last - first));
+    return p ? static_cast<const uint8_t*>(p) : last;
+
+#endif // VX_STD_USE_SIMD_ALGORITHMS
+}
+
+// length of a line without the carriage return of a windows line ending
+static size_t trim_line_end(const char* line, size_t count) noexcept
+{
+#if defined(VX_OS_WINDOWS)
+
+    if (count != 0 && line[count - 1] == '\r')
+    {
+        --count;
+    }
+
+#else
+
+    VX_UNUSED(line);
+
+#endif // VX_OS_WINDOWS
+
+    return count;
+}
+
+bool file::read_line(string_view& line)
 {
     if (!read_check(can_read()))
     {
         return false;
     }
 
-    line.clear();
+    if (!is_buffered())
+    {
+        err::set(err::file_read_failed, "line views require a buffered file");
+        return false;
+    }
 
-    char c = 0;
-    while (_priv::file_impl::read(m_handle, reinterpret_cast<uint8_t*>(&c), 1) == 1)
+    if (m_buffer_state == buffer_state::write && !flush_buffer())
     {
-        if (c == '\n')
+        return false;
+    }
+
+    if (m_buffer_state != buffer_state::read)
+    {
+        m_buffer_state = buffer_state::read;
+        m_buffer_pos = 0;
+        m_buffer_end = 0;
+    }
+
+    // where to resume scanning, everything before it is known not to hold a line end
+    size_t scan = m_buffer_pos;
+
+    while (true)
+    {
+        const uint8_t* first = m_buffer.data() + m_buffer_pos;
+        const uint8_t* last = m_buffer.data() + m_buffer_end;
+        const uint8_t* line_end = find_line_end(m_buffer.data() + scan, last);
+
+        if (line_end != last)
         {
-#if defined(VX_OS_WINDOWS)
+            const size_t count = static_cast<size_t>(line_end - first);
+            m_buffer_pos += count + 1;
+
+            line = string_view(reinterpret_cast<const char*>(first), trim_line_end(reinterpret_cast<const char*>(first), count));
+            return true;
+        }
 
-            // remove carriage return on windows
-            if (!line.empty() && line.back() == '\r')
+        // the line continues past the buffered data, make room behind it
+        if (m_buffer_pos != 0)
+        {
+            const size_t pending = m_buffer_end - m_buffer_pos;
+            std::memmove(m_buffer.data(), first, pending);
+            m_buffer_pos = 0;
+            m_buffer_end = pending;
+        }
+        else if (m_buffer_end == m_buffer.size())
+        {
+            m_buffer.resize(m_buffer.empty() ? m_buffer_size : m_buffer.size() * 2);
+        }
+
+        scan = m_buffer_end;
+
+        const size_t count = _priv::file_impl::read(m_handle, m_buffer.data() + m_buffer_end, m_buffer.size() - m_buffer_end);
+        if (count == 0)
+        {
+            // last line without a line ending
+            if (m_buffer_pos == m_buffer_end)
             {
-                line.pop_back();
+                return false;
             }
 
-#endif // VX_OS_WINDOWS
+            const char* rest = reinterpret_cast<const char*>(m_buffer.data() + m_buffer_pos);
+            line = string_view(rest, trim_line_end(rest, m_buffer_end - m_buffer_pos));
+            m_buffer_pos = m_buffer_end;
+            return true;
+        }
+
+        m_buffer_end += count;
+    }
+}
+
+bool file::read_line(std::string& line)
+{
+    if (!read_check(can_read()))
+    {
+        return false;
+    }
 
+    line.clear();
+
+    if (is_buffered())
+    {
+        string_view view;
+        if (!read_line(view))
+        {
+            return false;
+        }
+
+        line.assign(view.data(), view.size());
+        return true;
+    }
+
+    // unbuffered files read a byte at a time so nothing past the line is consumed
+    char c = 0;
+    while (_priv::file_impl::read(m_handle, reinterpret_cast<uint8_t*>(&c), 1) == 1)
+    {
+        if (c == '\n')
+        {
+            line.resize(trim_line_end(line.data(), line.size()));
             return true;
         }
 
         line.push_back(c);
     }
 
-    return false;
+    // last line without a line ending
+    if (line.empty())
+    {
+        return false;
+    }
+
+    line.resize(trim_line_end(line.data(), line.size()));
+    return true;
 }
 
-static bool write_line_internal(handle& h, const char* first, size_t size)
+static bool write_line_internal(file& f, const char* first, size_t size)
 {
     constexpr size_t line_end_size = sizeof(VX_LINE_END) - 1;
 
     // NOTE: write check should happen before calling this function
-    return (_priv::file_impl::write(h, reinterpret_cast<const uint8_t*>(first), size) == size)
-        && (_priv::file_impl::write(h, reinterpret_cast<const uint8_t*>(VX_LINE_END), line_end_size) == line_end_size);
+    return (f.write(reinterpret_cast<const uint8_t*>(first), size) == size)
+        && (f.write(reinterpret_cast<const uint8_t*>(VX_LINE_END), line_end_size) == line_end_size);
 }
 
 bool file::write_line(const char* line)
 {
-    return write_check(can_write()) && write_line_internal(m_handle, line, std::strlen(line));
+    return write_check(can_write()) && write_line_internal(*this, line, std::strlen(line));
 }
 
 bool file::write_file(const path& p, const char* text)
@@ -200,6 +617,12 @@ bool file::write_file(const path& p, const char* text)
 
 #if defined(VX_OS_WINDOWS)
 
+    // the text is written a line at a time, so collect the lines in a buffer
+    if (!f.set_buffer_size(default_buffer_size))
+    {
+        return false;
+    }
+
     const char* s = text;
     const char* e = text;
 
@@ -208,7 +631,7 @@ bool file::write_file(const path& p, const char* text)
     {
         if (*e == '\n')
         {
-            if (!write_line_internal(f.m_handle, s, static_cast<size_t>(e - s)))
+            if (!write_line_internal(f, s, static_cast<size_t>(e - s)))
             {
                 return false;
             }
@@ -223,15 +646,19 @@ bool file::write_file(const path& p, const char* text)
     if (s != e)
     {
         const size_t last_line_size = static_cast<size_t>(e - s);
-        return (_priv::file_impl::write(f.m_handle, reinterpret_cast<const uint8_t*>(s), last_line_size) == last_line_size);
+        if (f.write(reinterpret_cast<const uint8_t*>(s), last_line_size) != last_line_size)
+        {
+            return false;
+        }
     }
 
-    return true;
+    // the lines above were collected in the buffer
+    return f.flush_buffer();
 
 #else
 
     const size_t file_size = std::strlen(text);
-    return (_priv::file_impl::write(f.m_handle, reinterpret_cast<const uint8_t*>(text), file_size) == file_size);
+    return (write_all(f.m_handle, reinterpret_cast<const uint8_t*>(text), file_size) == file_size);
 
 #endif // VX_OS_WINDOWS
 }
@@ -250,6 +677,7 @@ file file::from_native_handle(typename handle::native_handle h, mode m)
         return f;
     }
 
+    // pipes are read and written as data arrives, so they stay unbuffered
     f.m_handle = h;
     f.m_mode = m;
 
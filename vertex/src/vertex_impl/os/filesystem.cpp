@@ -236,7 +236,7 @@ static void throw_copy_error(copy_error e, const path& from)
 
 // https://en.cppreference.com/w/cpp/filesystem/copy_file
 
-bool copy_file(const path& from, const path& to, bool overwrite_existing)
+bool copy_file(const path& from, const path& to, bool overwrite_existing, copy_progress_callback progress, void* user_data)
 {
     const file_info from_info = get_file_info(from);
 
@@ -277,7 +277,7 @@ bool copy_file(const path& from, const path& to, bool overwrite_existing)
         }
     }
 
-    return copy_file_impl(from, to, overwrite_existing);
+    return copy_file_impl(from, to, overwrite_existing, progress, user_data);
 }
 
 bool copy_symlink(const path& from, const path& to)
@@ -339,7 +339,7 @@ static bool copy_internal(const path& from, const path& to, copy_options options
 
         // If to is a directory, creates a copy of from as a file in the directory to
         const os::path to_path = to_info.is_directory() ? (to / from.filename()) : to;
-        return copy_file_impl(from, to_path, (options & copy_options::overwrite_existing));
+        return copy_file_impl(from, to_path, (options & copy_options::overwrite_existing), nullptr, nullptr);
     }
     else if (from_info.is_directory())
     {
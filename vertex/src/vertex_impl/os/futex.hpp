@@ -0,0 +1,111 @@
+#pragma once
+
+#include "vertex/os/atomic.hpp"
+#include "vertex/os/system_info.hpp"
+#include "vertex/os/time.hpp"
+#include "vertex_impl/os/_platform/platform_futex.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// spin then park
+//=============================================================================
+
+// Most waits on the synchronization primitives end within a few hundred
+// cycles, while parking costs a system call on both the waiting and waking
+// side. Waiters therefore spin with growing pauses before they park. On a
+// single processor the thread that would end the wait cannot run while we
+// spin, so no spinning is done there.
+struct spin_policy
+{
+    enum : uint32_t
+    {
+        spin_rounds = 32,
+        max_pauses_per_round = 8
+    };
+
+    static uint32_t rounds() noexcept
+    {
+        static const uint32_t s_rounds = (get_processor_count() > 1) ? static_cast<uint32_t>(spin_rounds) : 0;
+        return s_rounds;
+    }
+
+    // returns true as soon as ready() does, false if spinning gave up
+    template <typename F>
+    static bool spin_until(F&& ready) noexcept
+    {
+        const uint32_t count = rounds();
+        uint32_t pauses = 1;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (ready())
+            {
+                return true;
+            }
+
+            for (uint32_t p = 0; p < pauses; ++p)
+            {
+                cpu_pause();
+            }
+
+            pauses = (pauses < max_pauses_per_round) ? pauses * 2 : pauses;
+        }
+
+        return ready();
+    }
+};
+
+//=============================================================================
+// deadlines
+//=============================================================================
+
+// Converts a relative timeout to an absolute tick count so waits that wake
+// spuriously can resume with the time that is left. A negative timeout_ns
+// means no timeout.
+struct futex_deadline
+{
+    int64_t end_ns = -1;
+
+    explicit futex_deadline(int64_t timeout_ns) noexcept
+    {
+        if (timeout_ns >= 0)
+        {
+            end_ns = get_ticks().as_nanoseconds() + timeout_ns;
+        }
+    }
+
+    bool is_infinite() const noexcept
+    {
+        return end_ns < 0;
+    }
+
+    // time left in nanoseconds, -1 for no timeout, 0 once expired
+    int64_t remaining() const noexcept
+    {
+        if (is_infinite())
+        {
+            return -1;
+        }
+
+        const int64_t left = end_ns - get_ticks().as_nanoseconds();
+        return (left > 0) ? left : 0;
+    }
+};
+
+// Parks while word equals expected, until woken or the deadline passes.
+// Returns false only if the deadline passed.
+inline bool futex_wait_until(atomic<uint32_t>& word, uint32_t expected, const futex_deadline& deadline) noexcept
+{
+    const int64_t left = deadline.remaining();
+    if (left == 0)
+    {
+        return false;
+    }
+
+    return futex_impl::wait(word, expected, left);
+}
+
+} // namespace os
+} // namespace vx
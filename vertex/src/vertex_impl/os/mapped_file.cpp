@@ -0,0 +1,84 @@
+#include "vertex_impl/os/_platform/platform_file.hpp"
+#include "vertex_impl/os/_platform/platform_mapped_file.hpp"
+#include "vertex/system/error.hpp"
+
+namespace vx {
+namespace os {
+
+bool mapped_file::map(const path& p, access mode, size_t offset, size_t length)
+{
+    if (is_mapped())
+    {
+        err::set(err::file_open_failed, "file already mapped");
+        return false;
+    }
+
+    if (mode == access::none)
+    {
+        err::set(err::file_open_failed, "invalid access mode");
+        return false;
+    }
+
+    // the platform mapping outlives the file, only the fallback keeps it open
+    file f;
+    const file::mode file_mode = (mode == access::read_write) ? file::mode::read_write_exists : file::mode::read;
+    if (!f.open(p, file_mode))
+    {
+        return false;
+    }
+
+    const size_t file_size = f.size();
+    if (file_size == file::invalid_size)
+    {
+        return false;
+    }
+
+    if (offset > file_size || (length != whole_file && length > file_size - offset))
+    {
+        err::set(err::invalid_argument, "mapped window extends past the end of the file");
+        return false;
+    }
+
+    if (length == whole_file)
+    {
+        length = file_size - offset;
+    }
+
+    // an empty window is valid but there is nothing to map
+    if (length != 0 && !_priv::mapped_file_impl::map(*this, f, mode, offset, length))
+    {
+        return false;
+    }
+
+    m_access = mode;
+    m_size = length;
+    m_offset = offset;
+    return true;
+}
+
+void mapped_file::unmap()
+{
+    if (is_mapped())
+    {
+        _priv::mapped_file_impl::unmap(*this);
+        release();
+    }
+}
+
+bool mapped_file::advise(advice hint)
+{
+    return is_mapped() ? _priv::mapped_file_impl::advise(*this, hint) : false;
+}
+
+bool mapped_file::flush()
+{
+    if (!is_mapped())
+    {
+        return false;
+    }
+
+    return (m_access == access::read_write) ? _priv::mapped_file_impl::flush(*this) : true;
+}
+
+} // namespace os
+} // namespace vx
@@ -21,10 +21,16 @@ mutex::~mutex() noexcept
     m_storage.destroy<mutex_impl>();
 }
 
+// Owner tracking turns relocking and unlocking from the wrong thread into
+// errors instead of undefined behavior. It costs a thread id lookup on every
+// operation, so release builds leave it out.
+
 bool mutex::lock() noexcept
 {
     auto& ref = m_storage.get<mutex_impl>();
 
+#if VX_DEBUG
+
     const auto current_thread = thread_impl::get_current_native_id();
     if (ref.data.thread == current_thread)
     {
@@ -39,12 +45,20 @@ bool mutex::lock() noexcept
 
     ref.data.thread = current_thread;
     return true;
+
+#else
+
+    return ref.lock();
+
+#endif
 }
 
 bool mutex::try_lock() noexcept
 {
     auto& ref = m_storage.get<mutex_impl>();
 
+#if VX_DEBUG
+
     const auto current_thread = thread_impl::get_current_native_id();
     if (ref.data.thread == current_thread)
     {
@@ -59,12 +73,20 @@ bool mutex::try_lock() noexcept
 
     ref.data.thread = current_thread;
     return true;
+
+#else
+
+    return ref.try_lock();
+
+#endif
 }
 
 void mutex::unlock() noexcept
 {
     auto& ref = m_storage.get<mutex_impl>();
 
+#if VX_DEBUG
+
     const auto current_thread = thread_impl::get_current_native_id();
     if (ref.data.thread != current_thread)
     {
@@ -77,6 +99,9 @@ void mutex::unlock() noexcept
     // the mutex and set the ownership before we reset it,
     // then release the lock semaphore.
     ref.data.thread = thread_impl::get_invalid_native_id();
+
+#endif
+
     ref.unlock();
 }
 
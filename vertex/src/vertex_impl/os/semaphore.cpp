@@ -0,0 +1,56 @@
+#include "vertex/os/semaphore.hpp"
+#include "vertex_impl/os/futex.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Semaphore
+//=============================================================================
+
+bool semaphore::acquire_impl(int64_t timeout_ns) noexcept
+{
+    if (timeout_ns == 0)
+    {
+        return try_acquire();
+    }
+
+    if (spin_policy::spin_until([this]() { return try_acquire(); }))
+    {
+        return true;
+    }
+
+    const futex_deadline deadline(timeout_ns);
+    bool acquired = true;
+
+    // registered before the count is checked again, so a release that happens
+    // after the check sees the waiter
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    while (!try_acquire())
+    {
+        if (!futex_wait_until(m_count, 0, deadline))
+        {
+            acquired = try_acquire();
+            break;
+        }
+    }
+
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    return acquired;
+}
+
+void semaphore::wake_impl(uint32_t count) noexcept
+{
+    if (count == 1)
+    {
+        futex_impl::wake_one(m_count);
+    }
+    else
+    {
+        futex_impl::wake_all(m_count);
+    }
+}
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,86 @@
+#include "vertex/os/shared_mutex.hpp"
+#include "vertex_impl/os/futex.hpp"
+
+namespace vx {
+namespace os {
+
+//=============================================================================
+// Shared Mutex
+//=============================================================================
+
+void shared_mutex::lock_impl() noexcept
+{
+    if (spin_policy::spin_until([this]() { return try_lock(); }))
+    {
+        return;
+    }
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    while (true)
+    {
+        uint32_t state = m_state.load(std::memory_order_seq_cst);
+
+        if ((state & ~writer_waiting) == 0)
+        {
+            if (m_state.compare_exchange_weak(state, writer, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                break;
+            }
+
+            continue;
+        }
+
+        // keep new readers out while we wait for the current ones to leave
+        if ((state & writer_waiting) == 0)
+        {
+            if (!m_state.compare_exchange_weak(state, state | writer_waiting, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                continue;
+            }
+
+            state |= writer_waiting;
+        }
+
+        futex_impl::wait(m_state, state, -1);
+    }
+
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void shared_mutex::lock_shared_impl() noexcept
+{
+    if (spin_policy::spin_until([this]() { return try_lock_shared(); }))
+    {
+        return;
+    }
+
+    m_waiters.fetch_add(1, std::memory_order_seq_cst);
+
+    while (!try_lock_shared())
+    {
+        const uint32_t state = m_state.load(std::memory_order_seq_cst);
+
+        if (state & (writer | writer_waiting))
+        {
+            futex_impl::wait(m_state, state, -1);
+        }
+        else
+        {
+            // the reader count is saturated
+            cpu_pause();
+        }
+    }
+
+    m_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void shared_mutex::wake_impl() noexcept
+{
+    // readers and writers wait on the same word, wake them all and let them
+    // sort out who gets in
+    futex_impl::wake_all(m_state);
+}
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,660 @@
+#include <deque>
+#include <vector>
+
+#include "vertex/os/thread_pool.hpp"
+#include "vertex/os/mutex.hpp"
+#include "vertex/os/semaphore.hpp"
+#include "vertex/os/system_info.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/time.hpp"
+#include "vertex_impl/os/futex.hpp"
+
+namespace vx {
+namespace os {
+namespace _priv {
+
+//=============================================================================
+// work stealing deque
+//=============================================================================
+
+// Chase-Lev deque as described in "Correct and Efficient Work-Stealing for
+// Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli 2013).
+//
+// The owning worker pushes and takes at the bottom, other threads steal from
+// the top. The buffer grows when full, retired buffers are kept until the
+// deque is destroyed because a thief may still be reading from one.
+class work_stealing_deque
+{
+public:
+
+    work_stealing_deque()
+    {
+        m_buffer.store(new_buffer(initial_capacity), std::memory_order_relaxed);
+    }
+
+    ~work_stealing_deque()
+    {
+        for (buffer* b : m_retired)
+        {
+            delete_buffer(b);
+        }
+
+        delete_buffer(m_buffer.load(std::memory_order_relaxed));
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+public:
+
+    // owner only
+    void push(task* t)
+    {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+        buffer* a = m_buffer.load(std::memory_order_relaxed);
+
+        if (b - top > static_cast<int64_t>(a->mask))
+        {
+            a = grow(a, top, b);
+        }
+
+        // a release store rather than the paper's fence and relaxed store,
+        // equivalent here and visible to thread sanitizers
+        a->put(b, t);
+        m_bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // owner only, takes the most recently pushed task
+    task* take()
+    {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        buffer* a = m_buffer.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // empty
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        task* x = a->get(b);
+
+        if (t == b)
+        {
+            // last task, race thieves for it
+            if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                x = nullptr;
+            }
+
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+
+        return x;
+    }
+
+    // any thread, takes the oldest task
+    task* steal()
+    {
+        int64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = m_bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return nullptr;
+        }
+
+        buffer* a = m_buffer.load(std::memory_order_acquire);
+        task* x = a->get(t);
+
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            // lost the race to another thief or the owner
+            return nullptr;
+        }
+
+        return x;
+    }
+
+    bool empty() const noexcept
+    {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t t = m_top.load(std::memory_order_relaxed);
+        return t >= b;
+    }
+
+private:
+
+    enum : size_t
+    {
+        initial_capacity = 256
+    };
+
+    struct buffer
+    {
+        size_t mask;
+        atomic<task*>* slots;
+
+        task* get(int64_t i) const noexcept
+        {
+            return slots[static_cast<size_t>(i) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, task* t) noexcept
+        {
+            slots[static_cast<size_t>(i) & mask].store(t, std::memory_order_relaxed);
+        }
+    };
+
+    static buffer* new_buffer(size_t capacity)
+    {
+        buffer* b = new buffer;
+        b->mask = capacity - 1;
+        b->slots = new atomic<task*>[capacity];
+        return b;
+    }
+
+    static void delete_buffer(buffer* b)
+    {
+        delete[] b->slots;
+        delete b;
+    }
+
+    buffer* grow(buffer* a, int64_t top, int64_t bottom)
+    {
+        buffer* b = new_buffer((a->mask + 1) * 2);
+
+        for (int64_t i = top; i < bottom; ++i)
+        {
+            b->put(i, a->get(i));
+        }
+
+        m_retired.push_back(a);
+        m_buffer.store(b, std::memory_order_release);
+        return b;
+    }
+
+private:
+
+    alignas(cache_line_size) atomic<int64_t> m_top{ 0 };
+    alignas(cache_line_size) atomic<int64_t> m_bottom{ 0 };
+    atomic<buffer*> m_buffer{ nullptr };
+    std::vector<buffer*> m_retired;
+};
+
+//=============================================================================
+// thread_pool_impl
+//=============================================================================
+
+struct worker
+{
+    work_stealing_deque deque;
+    thread handle;
+};
+
+struct thread_pool_impl
+{
+    std::vector<std::unique_ptr<worker>> workers;
+    size_t started = 0;
+
+    // tasks submitted from threads that are not workers of this pool
+    mutex injector_mutex;
+    std::deque<task*> injector;
+    atomic<size_t> injector_size{ 0 };
+
+    // tasks that only run_pending may run
+    mutex main_mutex;
+    std::vector<task*> main_tasks;
+
+    // idle workers park on the semaphore, submitters wake one per task
+    semaphore wakeups;
+    atomic<uint32_t> sleepers{ 0 };
+
+    // wait groups that threads are parked on in wait()
+    mutex waiters_mutex;
+    std::vector<const wait_group*> waiters;
+    atomic<uint32_t> waiter_count{ 0 };
+
+    atomic<bool> stopping{ false };
+};
+
+// the pool and worker the calling thread belongs to, if any
+struct worker_context
+{
+    thread_pool_impl* pool = nullptr;
+    size_t index = 0;
+    uint32_t rng = 0;
+};
+
+static thread_local worker_context stl_worker;
+
+static task* pop_injector(thread_pool_impl& p)
+{
+    if (p.injector_size.load(std::memory_order_acquire) == 0)
+    {
+        return nullptr;
+    }
+
+    lock_guard lock(p.injector_mutex);
+
+    if (p.injector.empty())
+    {
+        return nullptr;
+    }
+
+    task* t = p.injector.front();
+    p.injector.pop_front();
+    p.injector_size.fetch_sub(1, std::memory_order_release);
+    return t;
+}
+
+// looks for a task in the worker's own deque, then the injector, then tries
+// to steal from other workers
+static task* find_task(thread_pool_impl& p)
+{
+    const bool is_worker = (stl_worker.pool == &p);
+    const size_t count = p.workers.size();
+
+    if (is_worker)
+    {
+        if (task* t = p.workers[stl_worker.index]->deque.take())
+        {
+            return t;
+        }
+    }
+
+    if (task* t = pop_injector(p))
+    {
+        return t;
+    }
+
+    if (count == 0)
+    {
+        return nullptr;
+    }
+
+    // start at a random victim so thieves spread out
+    uint32_t& rng = stl_worker.rng;
+    if (rng == 0)
+    {
+        rng = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&rng)) | 1;
+    }
+
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+
+    const size_t start = rng % count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t victim = (start + i) % count;
+        if (is_worker && victim == stl_worker.index)
+        {
+            continue;
+        }
+
+        if (task* t = p.workers[victim]->deque.steal())
+        {
+            return t;
+        }
+    }
+
+    return nullptr;
+}
+
+// spins briefly while there is no work, then tells the caller to park
+class backoff
+{
+public:
+
+    void reset() noexcept
+    {
+        m_step = 0;
+    }
+
+    // returns false once the caller should block instead
+    bool spin() noexcept
+    {
+        if (m_step < spin_steps)
+        {
+            cpu_pause();
+            ++m_step;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+
+    enum : int64_t
+    {
+        spin_steps = 64
+    };
+
+    int64_t m_step = 0;
+};
+
+// wakes one parked worker, if any, after a task was queued
+static void wake_worker(thread_pool_impl& p)
+{
+    // pairs with the fence in park_worker, either the worker sees the task or
+    // we see the worker
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint32_t sleepers = p.sleepers.load(std::memory_order_relaxed);
+    while (sleepers != 0)
+    {
+        if (p.sleepers.compare_exchange_weak(sleepers, sleepers - 1, std::memory_order_relaxed))
+        {
+            p.wakeups.release();
+            return;
+        }
+    }
+}
+
+// called by a worker that is leaving the sleepers early, if a submitter
+// already claimed it the spare wakeup just causes one extra loop later
+static void cancel_park(thread_pool_impl& p)
+{
+    uint32_t sleepers = p.sleepers.load(std::memory_order_relaxed);
+    while (sleepers != 0 && !p.sleepers.compare_exchange_weak(sleepers, sleepers - 1, std::memory_order_relaxed)) {}
+}
+
+// parks the worker until a task is queued, returns a task if one showed up
+// while registering
+static task* park_worker(thread_pool_impl& p)
+{
+    p.sleepers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // look once more, a task queued before we registered has no one to wake us
+    if (task* t = find_task(p))
+    {
+        cancel_park(p);
+        return t;
+    }
+
+    if (p.stopping.load(std::memory_order_acquire))
+    {
+        cancel_park(p);
+        return nullptr;
+    }
+
+    p.wakeups.acquire();
+    return nullptr;
+}
+
+static void worker_loop(thread_pool_impl* p, size_t index)
+{
+    stl_worker.pool = p;
+    stl_worker.index = index;
+    stl_worker.rng = static_cast<uint32_t>(index * 2654435761u) | 1;
+
+    backoff b;
+
+    while (true)
+    {
+        task* t = find_task(*p);
+
+        if (!t)
+        {
+            if (p->stopping.load(std::memory_order_acquire))
+            {
+                break;
+            }
+
+            if (b.spin())
+            {
+                continue;
+            }
+
+            t = park_worker(*p);
+            b.reset();
+
+            if (!t)
+            {
+                continue;
+            }
+        }
+
+        t->run(t);
+        b.reset();
+    }
+
+    stl_worker.pool = nullptr;
+}
+
+} // namespace _priv
+
+//=============================================================================
+// thread_pool
+//=============================================================================
+
+thread_pool::thread_pool(size_t worker_count)
+    : m_impl(new _priv::thread_pool_impl)
+{
+    if (worker_count == 0)
+    {
+        const size_t processors = static_cast<size_t>(get_processor_count());
+        worker_count = (processors > 1) ? processors - 1 : 1;
+    }
+
+    // the deques must all exist before any worker starts stealing
+    m_impl->workers.reserve(worker_count);
+    for (size_t i = 0; i < worker_count; ++i)
+    {
+        m_impl->workers.emplace_back(new _priv::worker);
+    }
+
+    for (auto& w : m_impl->workers)
+    {
+        if (!w->handle.start(_priv::worker_loop, m_impl.get(), m_impl->started))
+        {
+            // workers that did not start keep an empty deque, nothing is
+            // ever pushed to it since only its own thread could do that
+            break;
+        }
+
+        ++m_impl->started;
+    }
+}
+
+thread_pool::~thread_pool()
+{
+    // workers finish everything that was queued before they exit
+    m_impl->stopping.store(true, std::memory_order_seq_cst);
+    m_impl->wakeups.release(static_cast<uint32_t>(m_impl->started));
+
+    for (auto& w : m_impl->workers)
+    {
+        if (w->handle.is_joinable())
+        {
+            w->handle.join();
+        }
+    }
+
+    // with no workers left anything still queued runs here
+    while (run_one()) {}
+    while (run_pending() != 0) {}
+}
+
+size_t thread_pool::worker_count() const noexcept
+{
+    return m_impl->started;
+}
+
+void thread_pool::push(_priv::task* t)
+{
+    _priv::thread_pool_impl& p = *m_impl;
+
+    if (p.started == 0)
+    {
+        t->run(t);
+        return;
+    }
+
+    if (_priv::stl_worker.pool == &p)
+    {
+        p.workers[_priv::stl_worker.index]->deque.push(t);
+    }
+    else
+    {
+        lock_guard lock(p.injector_mutex);
+        p.injector.push_back(t);
+        p.injector_size.fetch_add(1, std::memory_order_release);
+    }
+
+    _priv::wake_worker(p);
+    wake_waiters();
+}
+
+void thread_pool::push_main(_priv::task* t)
+{
+    lock_guard lock(m_impl->main_mutex);
+    m_impl->main_tasks.push_back(t);
+}
+
+size_t thread_pool::run_pending()
+{
+    std::vector<_priv::task*> tasks;
+
+    {
+        lock_guard lock(m_impl->main_mutex);
+        tasks.swap(m_impl->main_tasks);
+    }
+
+    // tasks submitted while these run wait for the next call
+    for (_priv::task* t : tasks)
+    {
+        t->run(t);
+    }
+
+    return tasks.size();
+}
+
+bool thread_pool::run_one()
+{
+    _priv::task* t = _priv::find_task(*m_impl);
+    if (!t)
+    {
+        return false;
+    }
+
+    t->run(t);
+    return true;
+}
+
+void thread_pool::wait(const wait_group& wg)
+{
+    _priv::backoff b;
+
+    while (!wg.is_done())
+    {
+        if (run_one())
+        {
+            b.reset();
+            continue;
+        }
+
+        if (b.spin())
+        {
+            continue;
+        }
+
+        // blocks until the group is done or a task is queued that this
+        // thread may be needed for
+        if (_priv::task* t = park_waiter(wg))
+        {
+            t->run(t);
+        }
+
+        b.reset();
+    }
+}
+
+// parks a thread waiting on a wait group until the group is done or a task
+// is queued, returns a task if one showed up while registering
+_priv::task* thread_pool::park_waiter(const wait_group& wg)
+{
+    _priv::thread_pool_impl& p = *m_impl;
+
+    {
+        lock_guard lock(p.waiters_mutex);
+        p.waiters.push_back(&wg);
+        p.waiter_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // read after registering, a later poke or done() changes the word so
+    // the wait below returns right away
+    const uint32_t state = wg.m_state.fetch_or(wait_group::waiter_bit, std::memory_order_seq_cst) | wait_group::waiter_bit;
+
+    _priv::task* t = _priv::find_task(p);
+    if (!t && (state >> wait_group::count_shift) != 0)
+    {
+        futex_impl::wait(wg.m_state, state, -1);
+    }
+
+    {
+        lock_guard lock(p.waiters_mutex);
+
+        for (size_t i = 0; i < p.waiters.size(); ++i)
+        {
+            if (p.waiters[i] == &wg)
+            {
+                p.waiters[i] = p.waiters.back();
+                p.waiters.pop_back();
+                break;
+            }
+        }
+
+        p.waiter_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    return t;
+}
+
+// wakes every thread parked in wait() after a task was queued, any of them
+// may be needed to run it
+void thread_pool::wake_waiters()
+{
+    _priv::thread_pool_impl& p = *m_impl;
+
+    // pairs with the fence in park_waiter, either the waiter sees the task
+    // or we see the waiter
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (p.waiter_count.load(std::memory_order_relaxed) == 0)
+    {
+        return;
+    }
+
+    // a registered group stays alive until its waiter removes it, which
+    // takes the same lock
+    lock_guard lock(p.waiters_mutex);
+
+    for (const wait_group* wg : p.waiters)
+    {
+        wg->m_state.fetch_xor(wait_group::poke_bit, std::memory_order_seq_cst);
+        futex_impl::wake_all(wg->m_state);
+    }
+}
+
+//=============================================================================
+// wait_group
+//=============================================================================
+
+void wait_group::wake_impl() const noexcept
+{
+    futex_impl::wake_all(m_state);
+}
+
+} // namespace os
+} // namespace vx
@@ -0,0 +1,74 @@
+#include "vertex/pixel/convert.hpp"
+#include "vertex/pixel/raw_convert.hpp"
+#include "vertex/system/error.hpp"
+
+namespace vx {
+namespace pixel {
+
+#define _PIXEL_FORMATS(X) \
+    X(rgb_332) \
+    X(rgba_4444) X(bgra_4444) X(xrgb_4444) X(xbgr_4444) \
+    X(rgb_565) X(bgr_565) \
+    X(rgba_5551) X(bgra_5551) X(argb_1555) X(xrgb_1555) X(xbgr_1555) \
+    X(r_8) X(rg_8) X(rgb_8) X(bgr_8) \
+    X(rgba_8888) X(bgra_8888) X(argb_8888) X(abgr_8888) \
+    X(rgbx_8888) X(bgrx_8888) X(xrgb_8888) X(xbgr_8888) \
+    X(argb_2101010) X(abgr_2101010) X(xrgb_2101010) X(xbgr_2101010) \
+    X(rgba_8) X(bgra_8) X(abgr_8) \
+    X(r_16f) X(rg_16f) X(rgb_16f) X(rgba_16f) \
+    X(r_32f) X(rg_32f) X(rgb_32f) X(rgba_32f)
+
+using convert_fn = void(*)(const byte_type*, byte_type*, size_t);
+
+template <pixel_format SRC>
+static convert_fn get_convert_fn(pixel_format dst_format) noexcept
+{
+    switch (dst_format)
+    {
+#define _CASE(F) case pixel_format::F: return raw::convert_row<SRC, pixel_format::F>;
+        _PIXEL_FORMATS(_CASE)
+#undef _CASE
+        default: return nullptr;
+    }
+}
+
+static convert_fn get_convert_fn(pixel_format src_format, pixel_format dst_format) noexcept
+{
+    switch (src_format)
+    {
+#define _CASE(F) case pixel_format::F: return get_convert_fn<pixel_format::F>(dst_format);
+        _PIXEL_FORMATS(_CASE)
+#undef _CASE
+        default: return nullptr;
+    }
+}
+
+#undef _PIXEL_FORMATS
+
+bool convert_pixels(
+    pixel_format src_format,
+    pixel_format dst_format,
+    span<const byte_type> src,
+    span<byte_type> dst
+)
+{
+    const convert_fn fn = get_convert_fn(src_format, dst_format);
+    if (!fn)
+    {
+        err::set(err::invalid_argument, "unknown pixel format");
+        return false;
+    }
+
+    const size_t count = src.size() / get_pixel_size(src_format);
+    if (dst.size() < count * get_pixel_size(dst_format))
+    {
+        err::set(err::size_error, "destination is too small");
+        return false;
+    }
+
+    fn(src.data(), dst.data(), count);
+    return true;
+}
+
+} // namespace pixel
+} // namespace vx
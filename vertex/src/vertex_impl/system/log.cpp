@@ -2,8 +2,13 @@
 
 #include "vertex/system/log.hpp"
 #include "vertex/util/io/iostream.hpp"
+#include "vertex/os/atomic.hpp"
+#include "vertex/os/condition_variable.hpp"
 #include "vertex/os/file.hpp"
+#include "vertex/os/mpsc_queue.hpp"
 #include "vertex/os/mutex.hpp"
+#include "vertex/os/thread.hpp"
+#include "vertex/os/time.hpp"
 
 #ifdef ERROR
 #   undef ERROR
@@ -12,6 +17,41 @@
 namespace vx {
 namespace log {
 
+///////////////////////////////////////////////////////////////////////////////
+// async records
+///////////////////////////////////////////////////////////////////////////////
+
+enum : size_t
+{
+    // messages up to this size are copied into the queue slot itself, longer
+    // ones are copied to the heap
+    record_text_size = 232,
+
+    // number of messages that can wait for the writer, allocated the first
+    // time async mode starts
+    queue_capacity = 4096,
+
+    // size of the file buffer in async mode, a full buffer is written at once
+    batch_size = 64 * 1024
+};
+
+// longest time a written message may wait in the file buffer
+static constexpr time::time_point flush_interval = time::milliseconds(100);
+
+struct record
+{
+    level log_level;
+    uint32_t size;
+    char* heap;
+    char text[record_text_size];
+
+    const char* data() const noexcept { return heap ? heap : text; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// logger
+///////////////////////////////////////////////////////////////////////////////
+
 class logger
 {
 public:
@@ -21,39 +61,81 @@ public:
 
 public:
 
-    level get_level() const { return m_level; }
-    void set_level(level log_level) { m_level = log_level; }
+    level get_level() const noexcept
+    {
+        return m_level.load(std::memory_order_relaxed);
+    }
 
-    bool start(const char* filename)
+    void set_level(level log_level) noexcept
     {
-        stop();
+        m_level.store(log_level, std::memory_order_relaxed);
+    }
 
-        m_file.open(filename, os::file::mode::write);
-        if (!m_file.is_open())
+    bool should_log(level log_level) const noexcept
+    {
+        return log_level >= get_level();
+    }
+
+    bool start(const char* filename, bool async)
+    {
+        os::lock_guard lock(m_mutex);
+        stop_internal();
+
+        if (!m_file.open(filename, os::file::mode::write))
         {
-            stop();
+            return false;
         }
 
-        return m_file.is_open();
+        if (!async)
+        {
+            return true;
+        }
+
+        if (!m_queue)
+        {
+            m_queue.reset(new os::mpsc_queue<record>(queue_capacity));
+        }
+
+        m_file.set_buffer_size(batch_size);
+
+        m_writer_running.store(true, std::memory_order_relaxed);
+        if (!m_writer.start([this]() { writer_loop(); }))
+        {
+            m_writer_running.store(false, std::memory_order_relaxed);
+            m_file.close();
+            return false;
+        }
+
+        m_async.store(true, std::memory_order_release);
+        return true;
     }
 
     void stop()
     {
-        m_file.close();
+        os::lock_guard lock(m_mutex);
+        stop_internal();
     }
 
     bool is_enabled() const
     {
+        os::lock_guard lock(m_mutex);
         return m_file.is_open();
     }
 
     void write(level log_level, const std::string& msg)
     {
-        if (log_level < m_level)
+        if (!should_log(log_level))
         {
             return;
         }
 
+        if (m_async.load(std::memory_order_acquire) && push(log_level, msg))
+        {
+            return;
+        }
+
+        os::lock_guard lock(m_mutex);
+
         if (m_file.is_open())
         {
             m_file.write(msg.data(), msg.size());
@@ -65,76 +147,352 @@ public:
         }
     }
 
+    void flush()
+    {
+        if (m_async.load(std::memory_order_acquire))
+        {
+            const uint64_t target = m_enqueued.load(std::memory_order_acquire);
+
+            os::lock_guard lock(m_wake_mutex);
+            m_flush_requested.store(true, std::memory_order_release);
+            m_work_cv.notify_one();
+
+            // the writer publishes m_flushed under m_wake_mutex, and always
+            // does once more when it stops
+            m_flushed_cv.wait(m_wake_mutex, [&]()
+            {
+                return m_flushed.load(std::memory_order_acquire) >= target
+                    || !m_writer_running.load(std::memory_order_acquire);
+            });
+
+            return;
+        }
+
+        os::lock_guard lock(m_mutex);
+        m_file.flush();
+    }
+
 private:
 
-    level m_level = level::trace;
-    os::file m_file;
-};
+    //////////////////////////////////////////////////////////////////////////
+    // producers
+    //////////////////////////////////////////////////////////////////////////
 
-class logger_wrapper
-{
-public:
+    // returns false if the logger stopped being async, the caller then
+    // writes the message itself
+    bool push(level log_level, const std::string& msg)
+    {
+        // stop waits for producers that are between the check and the push
+        m_active_producers.fetch_add(1, std::memory_order_acq_rel);
 
-    logger_wrapper() : m_logger(std::make_unique<logger>()) {}
+        if (!m_async.load(std::memory_order_acquire))
+        {
+            m_active_producers.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
 
-public:
+        record r;
+        r.log_level = log_level;
+        r.size = static_cast<uint32_t>(msg.size());
+        r.heap = nullptr;
+
+        if (msg.size() <= record_text_size)
+        {
+            std::memcpy(r.text, msg.data(), msg.size());
+        }
+        else
+        {
+            r.heap = new char[msg.size()];
+            std::memcpy(r.heap, msg.data(), msg.size());
+        }
+
+        if (!m_queue->try_push(r))
+        {
+            wait_for_room(r);
+        }
 
-    level get_level() const
+        m_enqueued.fetch_add(1, std::memory_order_release);
+        wake_writer();
+
+        m_active_producers.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    // the writer is behind, wait for room rather than lose the message
+    void wait_for_room(const record& r)
     {
-        os::lock_guard lock(m_mutex);
-        return m_logger->get_level();
+        os::lock_guard lock(m_wake_mutex);
+
+        while (true)
+        {
+            // registered before retrying, so a writer that frees a slot after
+            // the retry fails sees the waiter and notifies
+            m_room_waiters.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (m_queue->try_push(r))
+            {
+                m_room_waiters.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+
+            m_room_cv.wait(m_wake_mutex);
+            m_room_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
     }
 
-    void set_level(level log_level)
+    void wake_writer()
     {
-        os::lock_guard lock(m_mutex);
-        m_logger->set_level(log_level);
+        // pairs with the fence in wait_for_work, either the writer sees the
+        // message or we see that it is about to park
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_writer_idle.load(std::memory_order_relaxed))
+        {
+            os::lock_guard lock(m_wake_mutex);
+            m_work_cv.notify_one();
+        }
     }
 
-    bool start(const char* filename)
+    //////////////////////////////////////////////////////////////////////////
+    // writer
+    //////////////////////////////////////////////////////////////////////////
+
+    void writer_loop()
     {
-        os::lock_guard lock(m_mutex);
-        return m_logger->start(filename);
+        // counts carry over between sessions to match m_enqueued
+        uint64_t written = m_flushed.load(std::memory_order_relaxed);
+        uint64_t flushed = written;
+        time::time_point last_flush = os::get_ticks();
+
+        while (m_writer_running.load(std::memory_order_acquire))
+        {
+            // taken before draining, so every message queued before the
+            // request is written by the drain below
+            const bool requested = m_flush_requested.exchange(false, std::memory_order_acq_rel);
+
+            bool urgent = false;
+            const uint64_t count = drain(urgent);
+            written += count;
+
+            if (count != 0)
+            {
+                wake_producers();
+            }
+
+            const time::time_point now = os::get_ticks();
+            const bool stale = (now - last_flush) >= flush_interval;
+
+            if (written != flushed && (urgent || requested || stale))
+            {
+                m_file.flush();
+                flushed = written;
+                last_flush = now;
+            }
+
+            if (flushed != m_flushed.load(std::memory_order_relaxed) || requested)
+            {
+                publish_flushed(flushed);
+            }
+
+            if (count == 0)
+            {
+                // with unflushed data wake in time to flush it, otherwise
+                // sleep until a message or a flush request arrives
+                const time::time_point timeout = (written != flushed)
+                    ? flush_interval - (now - last_flush)
+                    : time::time_point(-1);
+
+                wait_for_work(timeout);
+            }
+        }
+
+        bool urgent = false;
+        written += drain(urgent);
+        m_file.flush();
+        publish_flushed(written);
     }
 
-    void stop()
+    // a negative timeout waits until woken
+    void wait_for_work(const time::time_point& timeout)
     {
-        os::lock_guard lock(m_mutex);
-        m_logger->stop();
+        os::lock_guard lock(m_wake_mutex);
+
+        m_writer_idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_queue->empty()
+            && m_writer_running.load(std::memory_order_acquire)
+            && !m_flush_requested.load(std::memory_order_acquire))
+        {
+            if (timeout < time::time_point(0))
+            {
+                m_work_cv.wait(m_wake_mutex);
+            }
+            else
+            {
+                m_work_cv.wait_for(m_wake_mutex, timeout);
+            }
+        }
+
+        m_writer_idle.store(false, std::memory_order_relaxed);
     }
 
-    bool is_enabled() const
+    void publish_flushed(uint64_t flushed)
     {
-        os::lock_guard lock(m_mutex);
-        return m_logger->is_enabled();
+        os::lock_guard lock(m_wake_mutex);
+        m_flushed.store(flushed, std::memory_order_release);
+        m_flushed_cv.notify_all();
     }
 
-    void write(level log_level, const std::string& msg)
+    void wake_producers()
     {
-        os::lock_guard lock(m_mutex);
-        m_logger->write(log_level, msg);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (m_room_waiters.load(std::memory_order_relaxed) != 0)
+        {
+            os::lock_guard lock(m_wake_mutex);
+            m_room_cv.notify_all();
+        }
+    }
+
+    // writes everything in the queue to the file, urgent is set if any
+    // message should reach the file right away
+    uint64_t drain(bool& urgent)
+    {
+        uint64_t count = 0;
+        record r;
+
+        while (m_queue->try_pop(r))
+        {
+            m_file.write(r.data(), r.size);
+            urgent |= (r.log_level >= level::error);
+
+            delete[] r.heap;
+            ++count;
+        }
+
+        return count;
+    }
+
+    void stop_internal()
+    {
+        if (m_async.exchange(false, std::memory_order_acq_rel))
+        {
+            while (m_active_producers.load(std::memory_order_acquire) != 0)
+            {
+                os::cpu_pause();
+            }
+
+            {
+                os::lock_guard lock(m_wake_mutex);
+                m_writer_running.store(false, std::memory_order_release);
+                m_work_cv.notify_one();
+            }
+
+            m_writer.join();
+        }
+
+        m_file.close();
     }
 
 private:
 
+    os::atomic<level> m_level{ level::trace };
+
+    // guards the file in sync mode, and start and stop
     mutable os::mutex m_mutex;
-    std::unique_ptr<logger> m_logger;
+    os::file m_file;
+
+    // async mode
+    os::atomic<bool> m_async{ false };
+    os::atomic<size_t> m_active_producers{ 0 };
+    std::unique_ptr<os::mpsc_queue<record>> m_queue;
+
+    os::thread m_writer;
+    os::atomic<bool> m_writer_running{ false };
+
+    os::atomic<uint64_t> m_enqueued{ 0 };
+    os::atomic<uint64_t> m_flushed{ 0 };
+    os::atomic<bool> m_flush_requested{ false };
+
+    // the writer parks on m_work_cv when the queue is empty, flush() on
+    // m_flushed_cv and producers on m_room_cv when the queue is full
+    os::mutex m_wake_mutex;
+    os::condition_variable m_work_cv;
+    os::condition_variable m_flushed_cv;
+    os::condition_variable m_room_cv;
+    os::atomic<bool> m_writer_idle{ false };
+    os::atomic<size_t> m_room_waiters{ 0 };
 };
 
-static logger_wrapper s_logger;
+static logger s_logger;
+
+///////////////////////////////////////////////////////////////////////////////
+// thread streams
+///////////////////////////////////////////////////////////////////////////////
+
+namespace _priv {
+
+static thread_local thread_stream stl_stream;
+
+thread_stream* acquire_thread_stream()
+{
+    thread_stream* s = &stl_stream;
+
+    if (s->in_use)
+    {
+        s = new thread_stream;
+    }
+
+    s->in_use = true;
+    s->buffer.str().clear();
+
+    // undo any formatting state left by the previous message
+    s->stream.clear();
+    s->stream.flags(std::ios_base::skipws | std::ios_base::dec);
+    s->stream.precision(6);
+    s->stream.width(0);
+    s->stream.fill(' ');
+
+    return s;
+}
+
+void release_thread_stream(thread_stream* s)
+{
+    if (s == &stl_stream)
+    {
+        s->in_use = false;
+        return;
+    }
+
+    delete s;
+}
+
+} // namespace _priv
+
+///////////////////////////////////////////////////////////////////////////////
+// api
+///////////////////////////////////////////////////////////////////////////////
 
 level get_level()
 {
     return s_logger.get_level();
 }
+
 void set_level(level log_level)
 {
     s_logger.set_level(log_level);
 }
 
-bool start(const char* output_file)
+bool should_log(level log_level)
 {
-    return s_logger.start(output_file);
+    return s_logger.should_log(log_level);
+}
+
+bool start(const char* output_file, bool async)
+{
+    return s_logger.start(output_file, async);
 }
 
 void stop()
@@ -149,8 +507,13 @@ bool is_enabled()
 
 void write(level log_level, const std::string& msg)
 {
-    return s_logger.write(log_level, msg);
+    s_logger.write(log_level, msg);
+}
+
+void flush()
+{
+    s_logger.flush();
 }
 
 } // namespace log
-} // namespace vx
\ No newline at end of file
+} // namespace vx
@@ -1,136 +1,641 @@
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include <cstdio>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "vertex/system/profiler.hpp"
+#include "vertex/os/atomic.hpp"
+#include "vertex/os/condition_variable.hpp"
 #include "vertex/os/file.hpp"
+#include "vertex/os/mpsc_queue.hpp"
 #include "vertex/os/mutex.hpp"
+#include "vertex/os/thread.hpp"
 
 namespace vx {
 namespace profile {
 
+///////////////////////////////////////////////////////////////////////////////
+// thread buffers
+///////////////////////////////////////////////////////////////////////////////
+
+enum : size_t
+{
+    // events each thread can hold before the writer drains them
+    thread_buffer_capacity = 64 * 1024,
+
+    // events a thread records before it wakes the writer, well below the
+    // capacity so the ring has room while the writer catches up
+    wake_threshold = thread_buffer_capacity / 4
+};
+
+// Each thread that records an event gets its own ring, so recording a scope
+// is a single uncontended push. Rings are never freed while the process runs,
+// when a thread exits its ring is handed to the next thread that needs one.
+struct thread_buffer
+{
+    thread_buffer() : events(thread_buffer_capacity) {}
+
+    os::mpsc_queue<_priv::event> events;
+    os::atomic<bool> in_use{ false };
+
+    // events lost because the ring was full
+    os::atomic<size_t> dropped{ 0 };
+};
+
+// releases the ring of the current thread when it exits
+struct thread_buffer_handle
+{
+    ~thread_buffer_handle()
+    {
+        if (buffer)
+        {
+            buffer->in_use.store(false, std::memory_order_release);
+        }
+    }
+
+    thread_buffer* buffer = nullptr;
+    os::thread_id thread = os::invalid_thread_id;
+
+    // events pushed since this thread last woke the writer
+    size_t pending = 0;
+};
+
+static thread_local thread_buffer_handle stl_buffer;
+
+// interned names this thread has already looked up, so a repeated name
+// needs neither the global lock nor a copy
+static thread_local std::unordered_map<std::string, const char*> stl_names;
+
+///////////////////////////////////////////////////////////////////////////////
+// formatting
+///////////////////////////////////////////////////////////////////////////////
+
+static void append_uint(std::string& s, uint64_t value)
+{
+    char buffer[20];
+    char* last = buffer + sizeof(buffer);
+    char* first = last;
+
+    do
+    {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    s.append(first, last);
+}
+
+static void append_int(std::string& s, int64_t value)
+{
+    if (value < 0)
+    {
+        s.push_back('-');
+        append_uint(s, static_cast<uint64_t>(-(value + 1)) + 1);
+        return;
+    }
+
+    append_uint(s, static_cast<uint64_t>(value));
+}
+
+// trace timestamps are in microseconds, keep nanosecond precision
+static void append_microseconds(std::string& s, int64_t ns)
+{
+    if (ns < 0)
+    {
+        s.push_back('-');
+        ns = -ns;
+    }
+
+    append_uint(s, static_cast<uint64_t>(ns / 1000));
+
+    const int64_t fraction = ns % 1000;
+    s.push_back('.');
+    s.push_back(static_cast<char>('0' + fraction / 100));
+    s.push_back(static_cast<char>('0' + fraction / 10 % 10));
+    s.push_back(static_cast<char>('0' + fraction % 10));
+}
+
+static void append_csv_field(std::string& s, const char* text)
+{
+    bool quote = false;
+    for (const char* c = text; *c; ++c)
+    {
+        if (*c == ',' || *c == '"' || *c == '\n' || *c == '\r')
+        {
+            quote = true;
+            break;
+        }
+    }
+
+    if (!quote)
+    {
+        s.append(text);
+        return;
+    }
+
+    s.push_back('"');
+    for (const char* c = text; *c; ++c)
+    {
+        if (*c == '"')
+        {
+            s.push_back('"');
+        }
+        s.push_back(*c);
+    }
+    s.push_back('"');
+}
+
+static void append_json_string(std::string& s, const char* text)
+{
+    s.push_back('"');
+    for (const char* c = text; *c; ++c)
+    {
+        const unsigned char ch = static_cast<unsigned char>(*c);
+
+        if (ch == '"' || ch == '\\')
+        {
+            s.push_back('\\');
+            s.push_back(*c);
+        }
+        else if (ch < 0x20)
+        {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", ch);
+            s.append(buffer);
+        }
+        else
+        {
+            s.push_back(*c);
+        }
+    }
+    s.push_back('"');
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// profiler
+///////////////////////////////////////////////////////////////////////////////
+
 class profiler
 {
 public:
 
-    profiler() {}
+    profiler() = default;
     ~profiler() { stop(); }
 
 public:
 
     bool start(const char* output_file, bool clear_file)
     {
-        stop();
+        os::lock_guard lock(m_control_mutex);
+        stop_internal();
 
-        const bool exists = os::file::exists(output_file);
-        const auto mode = clear_file ? os::file::mode::write : os::file::mode::append;
-        m_file.open(output_file, mode);
+        const os::path csv_path = output_file;
+        os::path trace_path = csv_path;
+        trace_path.remove_extension();
+        trace_path += ".trace.json";
 
-        if (m_file.is_open() && (clear_file || !exists))
+        if (!open_csv(csv_path, clear_file) || !open_trace(trace_path, clear_file))
         {
-            write_header();
+            m_csv.close();
+            m_trace.close();
+            return false;
         }
 
-        os::get_ticks();
-        os::sleep(time::seconds(1));
+        // anything left in the rings was recorded after the last stop
+        discard_pending();
+
+        m_frequency = os::get_performance_frequency();
+        m_origin = os::get_performance_counter();
+
+        m_writer_running.store(true, std::memory_order_relaxed);
+        if (!m_writer.start([this]() { writer_loop(); }))
+        {
+            m_writer_running.store(false, std::memory_order_relaxed);
+            m_csv.close();
+            m_trace.close();
+            return false;
+        }
 
-        return m_file.is_open();
+        m_enabled.store(true, std::memory_order_release);
+        return true;
     }
 
     void stop()
     {
-        m_file.close();
+        os::lock_guard lock(m_control_mutex);
+        stop_internal();
+    }
+
+    bool is_enabled() const noexcept
+    {
+        return m_enabled.load(std::memory_order_acquire);
+    }
+
+    void push(const char* name, int64_t start, int64_t end) noexcept
+    {
+        thread_buffer* buffer = stl_buffer.buffer;
+
+        if (!buffer)
+        {
+            buffer = acquire_buffer();
+            if (!buffer)
+            {
+                return;
+            }
+        }
+
+        const _priv::event e{ name, stl_buffer.thread, start, end };
+        if (!buffer->events.try_push(e))
+        {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            stl_buffer.pending = 0;
+            wake_writer();
+        }
+        else if (++stl_buffer.pending >= wake_threshold)
+        {
+            stl_buffer.pending = 0;
+            wake_writer();
+        }
+    }
+
+    const char* intern(const std::string& name)
+    {
+        const auto it = stl_names.find(name);
+        if (it != stl_names.end())
+        {
+            return it->second;
+        }
+
+        const char* interned;
+        {
+            os::lock_guard lock(m_names_mutex);
+            interned = m_names.insert(name).first->c_str();
+        }
+
+        stl_names.emplace(name, interned);
+        return interned;
+    }
+
+    // converts a span of performance counter ticks to nanoseconds
+    int64_t ticks_to_ns(int64_t ticks) const noexcept
+    {
+        const int64_t whole = ticks / m_frequency;
+        const int64_t part = ticks % m_frequency;
+        return whole * time::nanoseconds_per_second + (part * time::nanoseconds_per_second) / m_frequency;
     }
 
-    bool is_enabled() const
+    int64_t ns_to_ticks(int64_t ns) const noexcept
     {
-        return m_file.is_open();
+        const int64_t whole = ns / time::nanoseconds_per_second;
+        const int64_t part = ns % time::nanoseconds_per_second;
+        return whole * m_frequency + (part * m_frequency) / time::nanoseconds_per_second;
     }
 
 private:
 
-    void write_header()
+    //////////////////////////////////////////////////////////////////////////
+    // files
+    //////////////////////////////////////////////////////////////////////////
+
+    bool open_csv(const os::path& p, bool clear_file)
     {
         // produces a csv where each line is:
         // name,thread_id,start_time,elapsed_time
 
-        if (m_file.is_open())
+        const bool exists = os::file::exists(p);
+        const auto mode = clear_file ? os::file::mode::write : os::file::mode::append;
+
+        // results are written a line at a time by the writer thread
+        if (!m_csv.set_buffer_size(os::file::default_buffer_size) || !m_csv.open(p, mode))
         {
-            std::ostringstream oss;
+            return false;
+        }
 
-            oss << "name" << ','
-                << "start_time" << ','
-                << "elapsed_time" << '\n';
+        if (clear_file || !exists)
+        {
+            m_csv.write("name,thread_id,start_time,elapsed_time\n");
+        }
 
-            const std::string s = oss.str();
-            m_file.write(s.data(), s.size());
-            m_file.flush();
+        return true;
+    }
+
+    bool open_trace(const os::path& p, bool clear_file)
+    {
+        // the trace is a json array of events closed by "\n]\n", when
+        // appending the closing bracket is cut off and new events follow the
+        // ones already in the file
+
+        static constexpr char footer[] = "\n]\n";
+        constexpr size_t footer_size = sizeof(footer) - 1;
+
+        if (!m_trace.set_buffer_size(os::file::default_buffer_size))
+        {
+            return false;
         }
+
+        if (!clear_file && os::file::exists(p))
+        {
+            if (!m_trace.open(p, os::file::mode::read_write_exists))
+            {
+                return false;
+            }
+
+            const size_t size = m_trace.size();
+            if (size == os::file::invalid_size)
+            {
+                return false;
+            }
+
+            // an empty file is started like a new one
+            if (size != 0)
+            {
+                char tail[footer_size] = {};
+
+                // "[" followed by the footer is a trace without events
+                const bool valid = size > footer_size
+                    && m_trace.seek(static_cast<int64_t>(size - footer_size))
+                    && m_trace.read(reinterpret_cast<uint8_t*>(tail), footer_size) == footer_size
+                    && std::equal(tail, tail + footer_size, footer);
+
+                // never truncate a file that is not a trace we can append to
+                if (!valid)
+                {
+                    err::set(err::file_corrupt, "profile trace does not end with a closing bracket");
+                    return false;
+                }
+
+                if (!m_trace.resize(size - footer_size) || !m_trace.seek(0, os::stream_position::end))
+                {
+                    return false;
+                }
+
+                m_trace_has_events = (size > footer_size + 1);
+                return true;
+            }
+        }
+        else if (!m_trace.open(p, os::file::mode::write))
+        {
+            return false;
+        }
+
+        m_trace.write("[");
+        m_trace_has_events = false;
+        return true;
     }
 
-public:
+    void close_files()
+    {
+        if (m_trace.is_open())
+        {
+            m_trace.write("\n]\n");
+        }
+
+        m_csv.close();
+        m_trace.close();
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    // buffers
+    //////////////////////////////////////////////////////////////////////////
 
-    void record(const result& r)
+    thread_buffer* acquire_buffer() noexcept
     {
-        if (m_file.is_open())
+        os::lock_guard lock(m_buffers_mutex);
+
+        thread_buffer* buffer = nullptr;
+
+        for (const auto& b : m_buffers)
         {
-            std::ostringstream oss;
+            bool expected = false;
+            if (b->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+            {
+                buffer = b.get();
+                break;
+            }
+        }
 
-            oss << std::setprecision(3) << std::fixed
-                << r.name << ','
-                << r.start.as_nanoseconds() << ','
-                << r.elapsed_time.as_nanoseconds() << '\n';
+        if (!buffer)
+        {
+            std::unique_ptr<thread_buffer> b(new (std::nothrow) thread_buffer);
+            if (!b || b->events.capacity() == 0)
+            {
+                return nullptr;
+            }
+
+            b->in_use.store(true, std::memory_order_relaxed);
+            buffer = b.get();
+            m_buffers.push_back(std::move(b));
+        }
+
+        stl_buffer.buffer = buffer;
+        stl_buffer.thread = os::this_thread::get_id();
+        return buffer;
+    }
 
-            const std::string s = oss.str();
-            m_file.write(s.data(), s.size());
-            m_file.flush();
+    void discard_pending()
+    {
+        os::lock_guard lock(m_buffers_mutex);
+
+        _priv::event e;
+        for (const auto& b : m_buffers)
+        {
+            while (b->events.try_pop(e)) {}
+            b->dropped.store(0, std::memory_order_relaxed);
         }
     }
 
-private:
+    //////////////////////////////////////////////////////////////////////////
+    // writer
+    //////////////////////////////////////////////////////////////////////////
 
-    os::file m_file;
-};
+    void wake_writer() noexcept
+    {
+        m_wake_requested.store(true, std::memory_order_relaxed);
 
-class profiler_wrapper
-{
-public:
+        // pairs with the fence in wait_for_work, either the writer sees the
+        // request or we see that it is about to park
+        std::atomic_thread_fence(std::memory_order_seq_cst);
 
-    profiler_wrapper() : m_profiler(std::make_unique<profiler>()) {}
+        if (m_writer_idle.load(std::memory_order_relaxed))
+        {
+            os::lock_guard lock(m_wake_mutex);
+            m_work_cv.notify_one();
+        }
+    }
 
-public:
+    void writer_loop()
+    {
+        while (m_writer_running.load(std::memory_order_acquire))
+        {
+            // keep going while there is work so busy threads do not overflow,
+            // then sleep until a thread fills up its ring or the profiler stops
+            if (drain() == 0)
+            {
+                wait_for_work();
+            }
+        }
+    }
 
-    bool start(const char* output_file, bool clear_file)
+    void wait_for_work()
+    {
+        os::lock_guard lock(m_wake_mutex);
+
+        m_writer_idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        while (!m_wake_requested.load(std::memory_order_relaxed)
+            && m_writer_running.load(std::memory_order_acquire))
+        {
+            m_work_cv.wait(m_wake_mutex);
+        }
+
+        m_writer_idle.store(false, std::memory_order_relaxed);
+        m_wake_requested.store(false, std::memory_order_relaxed);
+    }
+
+    // returns the number of events written
+    size_t drain()
     {
-        os::lock_guard lock(m_mutex);
-        return m_profiler->start(output_file, clear_file);
+        os::lock_guard lock(m_buffers_mutex);
+
+        size_t count = 0;
+        _priv::event e;
+
+        for (const auto& b : m_buffers)
+        {
+            while (b->events.try_pop(e))
+            {
+                write_event(e);
+                ++count;
+            }
+        }
+
+        return count;
     }
 
-    void stop()
+    void write_event(const _priv::event& e)
     {
-        os::lock_guard lock(m_mutex);
-        m_profiler->stop();
+        const int64_t start_ns = ticks_to_ns(e.start - m_origin);
+        const int64_t elapsed_ns = ticks_to_ns(e.end - e.start);
+
+        m_line.clear();
+        append_csv_field(m_line, e.name);
+        m_line.push_back(',');
+        append_uint(m_line, e.thread);
+        m_line.push_back(',');
+        append_int(m_line, start_ns);
+        m_line.push_back(',');
+        append_int(m_line, elapsed_ns);
+        m_line.push_back('\n');
+        m_csv.write(m_line);
+
+        // complete events on the same thread nest by time, which is what
+        // draws the flame chart
+        m_line.clear();
+        m_line.append(m_trace_has_events ? ",\n" : "\n");
+        m_line.append("{\"name\":");
+        append_json_string(m_line, e.name);
+        m_line.append(",\"ph\":\"X\",\"pid\":0,\"tid\":");
+        append_uint(m_line, e.thread);
+        m_line.append(",\"ts\":");
+        append_microseconds(m_line, start_ns);
+        m_line.append(",\"dur\":");
+        append_microseconds(m_line, elapsed_ns);
+        m_line.push_back('}');
+        m_trace.write(m_line);
+
+        m_trace_has_events = true;
     }
 
-    bool is_enabled() const
+    void write_dropped()
     {
-        os::lock_guard lock(m_mutex);
-        return m_profiler->is_enabled();
+        size_t dropped = 0;
+        for (const auto& b : m_buffers)
+        {
+            dropped += b->dropped.exchange(0, std::memory_order_relaxed);
+        }
+
+        if (dropped == 0)
+        {
+            return;
+        }
+
+        // an instant event makes the loss visible in the trace viewer
+        m_line.clear();
+        m_line.append(m_trace_has_events ? ",\n" : "\n");
+        m_line.append("{\"name\":\"profiler dropped ");
+        append_uint(m_line, dropped);
+        m_line.append(" events\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":");
+        append_microseconds(m_line, ticks_to_ns(os::get_performance_counter() - m_origin));
+        m_line.push_back('}');
+        m_trace.write(m_line);
+
+        m_trace_has_events = true;
     }
 
-    void record(const result& r)
+    void stop_internal()
     {
-        os::lock_guard lock(m_mutex);
-        m_profiler->record(r);
+        if (!m_enabled.exchange(false, std::memory_order_acq_rel))
+        {
+            return;
+        }
+
+        {
+            os::lock_guard lock(m_wake_mutex);
+            m_writer_running.store(false, std::memory_order_release);
+            m_work_cv.notify_one();
+        }
+
+        m_writer.join();
+
+        drain();
+
+        {
+            os::lock_guard lock(m_buffers_mutex);
+            write_dropped();
+        }
+
+        close_files();
     }
 
 private:
 
-    std::unique_ptr<profiler> m_profiler;
-    mutable os::mutex m_mutex;
+    os::atomic<bool> m_enabled{ false };
+    os::mutex m_control_mutex;
+
+    // rings of every thread that has recorded an event
+    std::vector<std::unique_ptr<thread_buffer>> m_buffers;
+    os::mutex m_buffers_mutex;
+
+    std::unordered_set<std::string> m_names;
+    os::mutex m_names_mutex;
+
+    os::thread m_writer;
+    os::atomic<bool> m_writer_running{ false };
+
+    // the writer parks on m_work_cv until a thread asks it to drain
+    os::mutex m_wake_mutex;
+    os::condition_variable m_work_cv;
+    os::atomic<bool> m_writer_idle{ false };
+    os::atomic<bool> m_wake_requested{ false };
+
+    // only touched by the writer while it runs
+    os::file m_csv;
+    os::file m_trace;
+    bool m_trace_has_events = false;
+    std::string m_line;
+
+    int64_t m_origin = 0;
+    int64_t m_frequency = 1;
 };
 
-static profiler_wrapper s_profiler;
+static profiler s_profiler;
+
+///////////////////////////////////////////////////////////////////////////////
+// api
+///////////////////////////////////////////////////////////////////////////////
 
 bool start(const char* output_file, bool clear_file)
 {
@@ -149,8 +654,37 @@ bool is_enabled()
 
 void record(const result& r)
 {
-    s_profiler.record(r);
+    if (!s_profiler.is_enabled())
+    {
+        return;
+    }
+
+    // results are timed with os::get_ticks, move them onto the counter
+    const int64_t now_counter = os::get_performance_counter();
+    const int64_t now_ns = os::get_ticks().as_nanoseconds();
+
+    const int64_t start = now_counter - s_profiler.ns_to_ticks(now_ns - r.start.as_nanoseconds());
+    const int64_t end = start + s_profiler.ns_to_ticks(r.elapsed_time.as_nanoseconds());
+
+    s_profiler.push(s_profiler.intern(r.name), start, end);
 }
 
+namespace _priv {
+
+void record_event(const char* name, int64_t start, int64_t end) noexcept
+{
+    if (s_profiler.is_enabled())
+    {
+        s_profiler.push(name, start, end);
+    }
 }
+
+const char* intern_name(const std::string& name)
+{
+    return s_profiler.intern(name);
 }
+
+} // namespace _priv
+
+} // namespace profile
+} // namespace vx